@@ -0,0 +1,631 @@
+/*! @file PotentialField.cpp
+    @brief Implementation of the PotentialField class
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PotentialField.h"
+#include "Infrastructure/FieldObjects/FieldObjects.h"
+#include "Infrastructure/NUSensorsData/NUSensorsData.h"
+#include "Tools/Math/General.h"
+
+#include "debug.h"
+#include "debugverbositybehaviour.h"
+
+#include <cmath>
+#include <algorithm>
+using namespace std;
+using namespace mathGeneral;
+
+/*! @brief Creates an empty potential field. The robot is at the origin, there is no ball and there are no obstacles */
+PotentialField::PotentialField()
+{
+    for (int i=0; i<m_key_size; i++)
+        m_key[i] = 0;
+    m_sensors_time = -1;
+
+    m_x = 0;
+    m_y = 0;
+    m_heading = 0;
+
+    m_ball_distance = 0;
+    m_ball_bearing = 0;
+    m_ball_x = 0;
+    m_ball_y = 0;
+    m_ball_velocity_x = 0;
+    m_ball_velocity_y = 0;
+    m_intercept_valid = false;
+
+    m_left_obstacle = 255;
+    m_right_obstacle = 255;
+
+    m_num_elements = 0;
+}
+
+PotentialField::~PotentialField()
+{
+}
+
+/*! @brief Returns the potential field shared by all of the behaviours, updated to the given world model and sensor data
+    @param fieldobjects the current world model
+    @param sensors the current sensor data
+ */
+PotentialField& PotentialField::current(FieldObjects* fieldobjects, NUSensorsData* sensors)
+{
+    static PotentialField field;
+    field.update(fieldobjects, sensors);
+    return field;
+}
+
+/*! @brief Updates the cached pose, ball and obstacle distances. Nothing is recalculated if the world model and sensor data have not changed
+    @param fieldobjects the current world model (this may be NULL)
+    @param sensors the current sensor data (this may be NULL)
+ */
+void PotentialField::update(FieldObjects* fieldobjects, NUSensorsData* sensors)
+{
+    if (fieldobjects != NULL)
+    {   // the world model is compared by value, because localisation changes it after its timestamp has been set
+        Self& self = fieldobjects->self;
+        MobileObject& ball = fieldobjects->mobileFieldObjects[FieldObjects::FO_BALL];
+        float key[m_key_size] = {self.wmX(), self.wmY(), self.Heading(),
+                                 ball.estimatedDistance(), ball.estimatedBearing(), ball.estimatedElevation(),
+                                 ball.X(), ball.Y(), ball.velX(), ball.velY()};
+        bool changed = false;
+        for (int i=0; i<m_key_size; i++)
+        {
+            if (key[i] != m_key[i])
+            {
+                m_key[i] = key[i];
+                changed = true;
+            }
+        }
+
+        if (changed)
+        {
+            m_x = self.wmX();
+            m_y = self.wmY();
+            m_heading = self.Heading();
+
+            m_ball_distance = ball.estimatedDistance()*cos(ball.estimatedElevation());
+            m_ball_bearing = ball.estimatedBearing();
+            m_ball_x = ball.X();
+            m_ball_y = ball.Y();
+            m_ball_velocity_x = ball.velX();
+            m_ball_velocity_y = ball.velY();
+            m_intercept_valid = false;
+
+            for (int i=0; i<m_num_elements; i++)
+                updateElement(m_elements[i]);
+        }
+    }
+
+    if (sensors != NULL and sensors->CurrentTime != m_sensors_time)
+    {
+        m_sensors_time = sensors->CurrentTime;
+        vector<float> temp;
+        m_left_obstacle = 255;
+        m_right_obstacle = 255;
+        if (sensors->get(NUSensorsData::LDistance, temp) and temp.size() > 0)
+            m_left_obstacle = temp[0];
+        if (sensors->get(NUSensorsData::RDistance, temp) and temp.size() > 0)
+            m_right_obstacle = temp[0];
+    }
+}
+
+/*! @brief Sets the robot's pose, and recalculates the relative state of each of the potentials in the batch
+    @param x the field x position in cm
+    @param y the field y position in cm
+    @param heading the field heading in radians
+ */
+void PotentialField::setPose(float x, float y, float heading)
+{
+    if (x == m_x and y == m_y and heading == m_heading)
+        return;
+    m_x = x;
+    m_y = y;
+    m_heading = heading;
+    m_intercept_valid = false;
+    for (int i=0; i<m_num_elements; i++)
+        updateElement(m_elements[i]);
+}
+
+/*! @brief Returns a vector to go to a field state. This is the same as BehaviourPotentials::goToFieldState
+    @param x the target field x position in cm
+    @param y the target field y position in cm
+    @param heading the desired field heading at the target
+    @param stoppeddistance the distance in cm to the target at which the robot will stop walking, ie the accurarcy required.
+    @param stoppingdistance the distance in cm from the target the robot will start to slow
+    @param turningdistance the distance in cm from the target the robot will start to turn to face the desired heading
+ */
+Vector3<float> PotentialField::goToFieldState(float x, float y, float heading, float stoppeddistance, float stoppingdistance, float turningdistance) const
+{
+    Vector3<float> relative;
+    relativeState(x, y, heading, m_x, m_y, m_heading, relative);
+    return goToPoint(relative.x, relative.y, relative.z, stoppeddistance, stoppingdistance, turningdistance);
+}
+
+/*! @brief Returns a vector to go to a point. This is the same as BehaviourPotentials::goToPoint
+    @param distance to the distance to the point
+    @param bearing to the point
+    @param heading the desired heading at the point
+    @param stoppeddistance the distance in cm to the target at which the robot will stop walking, ie the accurarcy required.
+    @param stoppingdistance the distance in cm from the target the robot will start to slow
+    @param turningdistance the distance in cm from the target the robot will start to turn to face the desired heading
+ */
+Vector3<float> PotentialField::goToPoint(float distance, float bearing, float heading, float stoppeddistance, float stoppingdistance, float turningdistance)
+{
+    Vector3<float> result;
+    if (distance < stoppeddistance and fabs(heading) < 0.1)         // if we are close --- enough stop
+        return result;
+
+    // calculate the translational speed
+    if (distance < stoppingdistance)
+        result.x = distance/stoppingdistance;
+    else
+        result.x = 1;
+    // 'calculate' the translational direction
+    result.y = bearing;
+    // calculate the rotational speed
+    if (distance < turningdistance)
+    {
+        if (fabs(heading) > 2.5)
+            heading = fabs(heading);
+        result.z = 0.5*heading;
+    }
+    else
+        result.z = 0.5*bearing;
+    return result;
+}
+
+/*! @brief Returns a vector to avoid a field position. This is the same as BehaviourPotentials::avoidFieldState
+    @param x the field x position of the object in cm
+    @param y the field y position of the object in cm
+    @param objectsize the radius in cm of the object to avoid
+    @param dontcaredistance the distance in cm at which I make no attempt to avoid the object
+ */
+Vector3<float> PotentialField::avoidFieldState(float x, float y, float objectsize, float dontcaredistance) const
+{
+    Element element;
+    element.Kind = Element::Repulsor;
+    element.A = objectsize;
+    element.B = dontcaredistance;
+    Vector3<float> relative;
+    relativeState(x, y, 0, m_x, m_y, m_heading, relative);
+    return evaluateElement(element, relative);
+}
+
+/*! @brief Returns a vector to go to the ball. This is the same as BehaviourPotentials::goToBall
+    @param heading the relative direction the robot should be facing when it reaches the ball
+    @param kickingdistance the distance in cm from the ball the robot should stop at
+    @param stoppingdistance the distance in cm from the ball the robot will start to slow
+ */
+Vector3<float> PotentialField::goToBall(float heading, float kickingdistance, float stoppingdistance) const
+{
+    return goToBall(m_ball_distance, m_ball_bearing, heading, kickingdistance, stoppingdistance);
+}
+
+/*! @brief Returns a vector to go to a ball at the given relative position
+    @param distance the distance to the ball on the ground in cm
+    @param bearing the relative bearing to the ball
+    @param heading the relative direction the robot should be facing when it reaches the ball
+    @param kickingdistance the distance in cm from the ball the robot should stop at
+    @param stoppingdistance the distance in cm from the ball the robot will start to slow
+ */
+Vector3<float> PotentialField::goToBall(float distance, float bearing, float heading, float kickingdistance, float stoppingdistance)
+{
+    float x = distance * cos(bearing);
+    float y = distance * sin(bearing);
+
+    // go to the ball with the foot that is closer to it
+    const float offsetDistance = 5.0f;
+    float left_foot_x = x + offsetDistance * cos(heading - PI/2);
+    float left_foot_y = y + offsetDistance * sin(heading - PI/2);
+    float left_foot_distance = sqrt(left_foot_x*left_foot_x + left_foot_y*left_foot_y);
+
+    float right_foot_x = x + offsetDistance * cos(heading + PI/2);
+    float right_foot_y = y + offsetDistance * sin(heading + PI/2);
+    float right_foot_distance = sqrt(right_foot_x*right_foot_x + right_foot_y*right_foot_y);
+
+    if (left_foot_distance < right_foot_distance)
+    {
+        x = left_foot_x;
+        y = left_foot_y;
+        distance = left_foot_distance;
+    }
+    else
+    {
+        x = right_foot_x;
+        y = right_foot_y;
+        distance = right_foot_distance;
+    }
+    bearing = atan2(y,x);
+
+    // calculate the component to position the ball at the kicking distance
+    float position_speed;
+    float position_direction;
+    float position_rotation = 0.5*bearing;
+    if (distance < kickingdistance)
+    {   // if we are too close to the ball then we need to go backwards
+        position_speed = (kickingdistance - distance)/kickingdistance;
+        position_direction = normaliseAngle(bearing + PI);
+    }
+    else if (distance < stoppingdistance)
+    {   // if we are close enough to slow down
+        position_speed = (distance - kickingdistance)/(stoppingdistance - kickingdistance);
+        position_direction = bearing;
+    }
+    else
+    {   // if it is outside the stopping distance - full speed
+        position_speed = 1;
+        position_direction = bearing;
+    }
+
+    // calculate the component to go around the ball to face the heading
+    float around_speed = 0;
+    float around_direction = 0;
+    float around_rotation = 0;
+    if (distance < 0.75*stoppingdistance)
+    {   // if we are close enough to worry about the heading
+        const float heading_gain = 0.5;
+        const float heading_threshold = PI/2;
+        if (fabs(heading) < heading_threshold)
+            around_speed = (heading_gain/heading_threshold)*fabs(heading);
+        else
+            around_speed = heading_gain;
+        if (fabs(heading) > 2.85)
+            around_direction = normaliseAngle(bearing + PI/2);
+        else
+            around_direction = normaliseAngle(bearing - sign(heading)*PI/2);
+
+        around_rotation = -sign(around_direction)*around_speed*12/distance;        // 12 is rough speed in cm/s
+    }
+
+    Vector3<float> speed;
+    speed.x = max(position_speed, around_speed);
+    float xsum = position_speed*cos(position_direction) + around_speed*cos(around_direction);
+    float ysum = position_speed*sin(position_direction) + around_speed*sin(around_direction);
+    speed.y = atan2(ysum, xsum);
+    speed.z = position_rotation + around_rotation;
+    return speed;
+}
+
+/*! @brief Returns a vector as close to the original as possible without hitting obstacles detected by the sensors. This is the same as BehaviourPotentials::sensorAvoidObjects
+    @param speed the desired speed as [trans_speed, trans_direction, rot_speed]
+    @param objectsize the radius in cm of the obstacle
+    @param dontcaredistance the distance in cm at which I make no attempt to avoid the obstacle
+ */
+Vector3<float> PotentialField::sensorAvoidObjects(const Vector3<float>& speed, float objectsize, float dontcaredistance) const
+{
+    if (fabs(speed.y) > PI/2)
+    {   // if the speed is not in the range of the ultrasonic sensors then don't both dodging
+        return speed;
+    }
+    else if (m_left_obstacle > dontcaredistance and m_right_obstacle > dontcaredistance)
+    {   // if the obstacles are too far away don't dodge
+        return speed;
+    }
+    else
+    {   // an obstacle needs to be dodged
+        Vector3<float> newspeed = speed;
+        float obstacle = min(m_left_obstacle, m_right_obstacle);
+        float dodgeangle;
+        if (obstacle < objectsize)          // if we are 'inside' the object
+            dodgeangle = PI/2 + asin((objectsize - obstacle)/objectsize);
+        else                                // if we are 'outside' the object
+            dodgeangle = asin(objectsize/obstacle);
+
+        if (m_left_obstacle <= m_right_obstacle)
+        {   // the obstacle is on the left
+            if (speed.y > -dodgeangle)
+                newspeed.y = -dodgeangle;
+        }
+        else
+        {   // the obstacle is on the right
+            if (speed.y < dodgeangle)
+                newspeed.y = dodgeangle;
+        }
+        return newspeed;
+    }
+}
+
+/*! @brief Returns the vector sum of the potentials. This is the same as BehaviourPotentials::sumPotentials
+    @param potentials an array of [trans_speed, trans_direction, rot_speed] vectors
+    @param n the number of potentials in the array
+ */
+Vector3<float> PotentialField::sumPotentials(const Vector3<float>* potentials, int n)
+{
+    float xsum = 0;
+    float ysum = 0;
+    float yawsum = 0;
+    float maxspeed = 0;
+    for (int i=0; i<n; i++)
+    {
+        if (potentials[i].x > maxspeed)
+            maxspeed = potentials[i].x;
+        xsum += potentials[i].x*cos(potentials[i].y);
+        ysum += potentials[i].x*sin(potentials[i].y);
+        yawsum += potentials[i].z;
+    }
+    return Vector3<float>(maxspeed, atan2(ysum,xsum), yawsum);
+}
+
+/*! @brief Returns the distance in cm to the obstacle detected by the left ultrasonic sensor, 255 if there is none */
+float PotentialField::getLeftObstacle() const
+{
+    return m_left_obstacle;
+}
+
+/*! @brief Returns the distance in cm to the obstacle detected by the right ultrasonic sensor, 255 if there is none */
+float PotentialField::getRightObstacle() const
+{
+    return m_right_obstacle;
+}
+
+/*! @brief Returns the distance to the ball on the ground in cm */
+float PotentialField::getBallDistance() const
+{
+    return m_ball_distance;
+}
+
+/*! @brief Returns the relative bearing to the ball */
+float PotentialField::getBallBearing() const
+{
+    return m_ball_bearing;
+}
+
+/*! @brief Returns the closest intercept with the ball [time (s), x (cm), y (cm)]. This is the same as Self::CalculateClosestInterceptToMobileObject
+           for the ball, but is only calculated once per frame.
+ */
+const Vector3<float>& PotentialField::getBallIntercept() const
+{
+    if (not m_intercept_valid)
+        updateIntercept();
+    return m_intercept;
+}
+
+/*! @brief Removes all of the potentials from the batch */
+void PotentialField::clear()
+{
+    m_num_elements = 0;
+}
+
+/*! @brief Adds an attractor to go to a field state to the batch. See goToFieldState() for the parameters
+    @return false if the batch is full
+ */
+bool PotentialField::addAttractor(float x, float y, float heading, float stoppeddistance, float stoppingdistance, float turningdistance)
+{
+    if (m_num_elements >= m_max_elements)
+        return false;
+    Element& element = m_elements[m_num_elements++];
+    element.Kind = Element::Attractor;
+    element.X = x;
+    element.Y = y;
+    element.Heading = heading;
+    element.A = stoppeddistance;
+    element.B = stoppingdistance;
+    element.C = turningdistance;
+    updateElement(element);
+    return true;
+}
+
+/*! @brief Adds a repulsor to avoid a field position to the batch. See avoidFieldState() for the parameters
+    @return false if the batch is full
+ */
+bool PotentialField::addRepulsor(float x, float y, float objectsize, float dontcaredistance)
+{
+    if (m_num_elements >= m_max_elements)
+        return false;
+    Element& element = m_elements[m_num_elements++];
+    element.Kind = Element::Repulsor;
+    element.X = x;
+    element.Y = y;
+    element.Heading = 0;
+    element.A = objectsize;
+    element.B = dontcaredistance;
+    element.C = 0;
+    updateElement(element);
+    return true;
+}
+
+/*! @brief Adds an attractor to go to the ball to the batch. See goToBall() for the parameters.
+
+    The heading is relative to the current pose. It is stored as a field direction so that it stays
+    pointing the same way on the field when the batch is sampled from other poses.
+
+    @return false if the batch is full
+ */
+bool PotentialField::addBall(float heading, float kickingdistance, float stoppingdistance)
+{
+    if (m_num_elements >= m_max_elements)
+        return false;
+    Element& element = m_elements[m_num_elements++];
+    element.Kind = Element::Ball;
+    element.X = m_ball_x;
+    element.Y = m_ball_y;
+    element.Heading = heading + m_heading;
+    element.A = kickingdistance;
+    element.B = stoppingdistance;
+    element.C = 0;
+    element.Relative = Vector3<float>(m_ball_distance, m_ball_bearing, heading);
+    return true;
+}
+
+/*! @brief Returns the number of potentials in the batch */
+int PotentialField::size() const
+{
+    return m_num_elements;
+}
+
+/*! @brief Returns the sum of all of the potentials in the batch from the current pose */
+Vector3<float> PotentialField::evaluate() const
+{
+    Vector3<float> potentials[m_max_elements];
+    for (int i=0; i<m_num_elements; i++)
+        potentials[i] = evaluateElement(m_elements[i], m_elements[i].Relative);
+    return sumPotentials(potentials, m_num_elements);
+}
+
+/*! @brief Returns the sum of all of the potentials in the batch as if the robot were at the given pose.
+
+    The ball's position is taken from its field location, rather than from its relative position
+    used by evaluate(), and the cached values are not changed.
+
+    @param x the field x position in cm
+    @param y the field y position in cm
+    @param heading the field heading in radians
+ */
+Vector3<float> PotentialField::evaluateAt(float x, float y, float heading) const
+{
+    Vector3<float> potentials[m_max_elements];
+    Vector3<float> relative;
+    for (int i=0; i<m_num_elements; i++)
+    {
+        const Element& element = m_elements[i];
+        relativeState(element.X, element.Y, element.Heading, x, y, heading, relative);
+        potentials[i] = evaluateElement(element, relative);
+    }
+    return sumPotentials(potentials, m_num_elements);
+}
+
+/*! @brief Samples the batch over a grid of poses that all have the same heading
+    @param xmin the smallest field x position in cm
+    @param xmax the largest field x position in cm
+    @param ymin the smallest field y position in cm
+    @param ymax the largest field y position in cm
+    @param step the grid spacing in cm
+    @param heading the field heading of every pose in radians
+    @param samples will be filled with the sum of the potentials at each pose, in row major order (x changes fastest)
+ */
+void PotentialField::sample(float xmin, float xmax, float ymin, float ymax, float step, float heading, vector<Vector3<float> >& samples) const
+{
+    samples.clear();
+    if (step <= 0)
+        return;
+    for (float y = ymin; y <= ymax; y += step)
+        for (float x = xmin; x <= xmax; x += step)
+            samples.push_back(evaluateAt(x, y, heading));
+}
+
+/*! @brief Samples the batch over a grid of poses and writes it to a stream as a table of 'x y speed direction rotation' rows
+    @param output the stream to write the samples to. The remaining parameters are the same as the other sample()
+ */
+void PotentialField::sample(float xmin, float xmax, float ymin, float ymax, float step, float heading, ostream& output) const
+{
+    if (step <= 0)
+        return;
+    for (float y = ymin; y <= ymax; y += step)
+    {
+        for (float x = xmin; x <= xmax; x += step)
+        {
+            Vector3<float> potential = evaluateAt(x, y, heading);
+            output << x << " " << y << " " << potential.x << " " << potential.y << " " << potential.z << endl;
+        }
+    }
+}
+
+/*! @brief Calculates the relative state of a field state from a pose. This is the same as Self::CalculateDifferenceFromFieldState
+    @param x the field x position of the target
+    @param y the field y position of the target
+    @param heading the field heading of the target
+    @param selfx the field x position of the pose
+    @param selfy the field y position of the pose
+    @param selfheading the field heading of the pose
+    @param relative will be updated to the [distance, bearing, heading difference]
+ */
+void PotentialField::relativeState(float x, float y, float heading, float selfx, float selfy, float selfheading, Vector3<float>& relative) const
+{
+    float diffX = x - selfx;
+    float diffY = y - selfy;
+    if (diffX == 0 and diffY == 0)
+        diffY = 0.0001;
+    float positionHeading = atan2(diffY, diffX);
+
+    relative.x = sqrt(diffX*diffX + diffY*diffY);
+    relative.y = normaliseAngle(positionHeading - selfheading);
+    relative.z = normaliseAngle(heading - selfheading);
+}
+
+/*! @brief Updates the cached relative state of a potential to the current pose */
+void PotentialField::updateElement(Element& element) const
+{
+    if (element.Kind == Element::Ball)
+        element.Relative = Vector3<float>(m_ball_distance, m_ball_bearing, normaliseAngle(element.Heading - m_heading));
+    else
+        relativeState(element.X, element.Y, element.Heading, m_x, m_y, m_heading, element.Relative);
+}
+
+/*! @brief Returns the value of a single potential
+    @param element the potential
+    @param relative the [distance, bearing, heading difference] of the potential
+ */
+Vector3<float> PotentialField::evaluateElement(const Element& element, const Vector3<float>& relative) const
+{
+    if (element.Kind == Element::Attractor)
+        return goToPoint(relative.x, relative.y, relative.z, element.A, element.B, element.C);
+    else if (element.Kind == Element::Ball)
+        return goToBall(relative.x, relative.y, relative.z, element.A, element.B);
+
+    Vector3<float> result;
+    float distance = relative.x;
+    float bearing = relative.y;
+    float objectsize = element.A;
+    float dontcaredistance = element.B;
+    if (distance > dontcaredistance)        // if the object is too far away don't avoid it
+        return result;
+
+    // calculate the translational speed --- max if inside the object and reduces to zero at dontcaredistance
+    if (distance < objectsize)
+        result.x = 1;
+    else
+        result.x = (distance - dontcaredistance)/(objectsize - dontcaredistance);
+    // calculate the translational bearing --- away
+    if (fabs(bearing) < 0.1)
+        result.y = PI/2;
+    else
+        result.y = bearing - sign(bearing)*PI/2;
+    // calculate the rotational speed --- spin facing object if infront, spin away if behind
+    float y = distance*sin(bearing);
+    float x = distance*cos(bearing);
+    if (fabs(y) < objectsize)
+        result.z = atan2(y - sign(y)*objectsize, x);
+    return result;
+}
+
+/*! @brief Calculates the closest intercept with the ball from the current pose */
+void PotentialField::updateIntercept() const
+{
+    // Convert the velocity to a relative one
+    float velocity_mag = sqrt(m_ball_velocity_x*m_ball_velocity_x + m_ball_velocity_y*m_ball_velocity_y);
+    float velocity_heading = atan2(m_ball_velocity_y, m_ball_velocity_x);
+    float v_x = velocity_mag*cos(velocity_heading - m_heading);
+    float v_y = velocity_mag*sin(velocity_heading - m_heading);
+
+    // Get the ball position in relative coords
+    float b_x = m_ball_distance*cos(m_ball_bearing);
+    float b_y = m_ball_distance*sin(m_ball_bearing);
+
+    m_intercept = Vector3<float>(600, 0, 0);
+    if (((v_x > 0 and b_x < 0) or (v_x < 0 and b_x > 0)) or ((v_y > 0 and b_y < 0) or (v_y < 0 and b_y > 0)))
+    {   // if the ball is moving towards us then time can be calculated
+        m_intercept.y = (b_x*v_y*v_y - b_y*v_x*v_y)/(v_x*v_x + v_y*v_y);
+        m_intercept.z = -(v_x/v_y)*m_intercept.y;
+        m_intercept.x = sqrt(pow(b_x - m_intercept.y, 2) + pow(b_y - m_intercept.z, 2))/velocity_mag;
+    }
+    m_intercept_valid = true;
+}
+
@@ -0,0 +1,138 @@
+/*! @file PotentialField.h
+    @brief Declaration of the PotentialField class
+
+    @class PotentialField
+    @brief An allocation free evaluator for the behaviour motor schemas in BehaviourPotentials
+
+    Each potential is a Vector3<float> (trans_speed, trans_direction, rotational_speed), with the same
+    meaning and the same values as the vector<float> returned by the matching BehaviourPotentials function.
+
+    The field caches the things that every potential in a think cycle shares: the robot's pose, the ball's
+    relative position, the closest intercept with the ball and the ultrasonic obstacle distances. These are
+    refreshed by update() only when the world model or the sensor data has changed, so a behaviour can
+    evaluate as many potentials as it likes without repeating the work. Use PotentialField::current() to
+    get the field shared by all of the behaviours.
+
+    A set of attractors and repulsors can also be added to the field and evaluated in one batch with
+    evaluate(). Their relative states are calculated once when they are added (or when the pose changes),
+    and the whole set can be sampled over a grid of hypothetical poses with sample() for offline
+    visualisation.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef POTENTIALFIELD_H
+#define POTENTIALFIELD_H
+
+class FieldObjects;
+class NUSensorsData;
+
+#include "Tools/Math/Vector3.h"
+
+#include <vector>
+#include <iostream>
+
+class PotentialField
+{
+public:
+    PotentialField();
+    ~PotentialField();
+
+    static PotentialField& current(FieldObjects* fieldobjects, NUSensorsData* sensors);
+    void update(FieldObjects* fieldobjects, NUSensorsData* sensors);
+    void setPose(float x, float y, float heading);
+
+    // Single potentials
+    Vector3<float> goToFieldState(float x, float y, float heading, float stoppeddistance = 0, float stoppingdistance = 50, float turningdistance = 70) const;
+    static Vector3<float> goToPoint(float distance, float bearing, float heading, float stoppeddistance = 0, float stoppingdistance = 50, float turningdistance = 70);
+    Vector3<float> avoidFieldState(float x, float y, float objectsize = 25, float dontcaredistance = 100) const;
+    Vector3<float> goToBall(float heading, float kickingdistance = 15.0, float stoppingdistance = 65) const;
+    static Vector3<float> goToBall(float distance, float bearing, float heading, float kickingdistance = 15.0, float stoppingdistance = 65);
+    Vector3<float> sensorAvoidObjects(const Vector3<float>& speed, float objectsize = 20, float dontcaredistance = 50) const;
+    static Vector3<float> sumPotentials(const Vector3<float>* potentials, int n);
+
+    // Shared per frame results
+    float getLeftObstacle() const;
+    float getRightObstacle() const;
+    float getBallDistance() const;
+    float getBallBearing() const;
+    const Vector3<float>& getBallIntercept() const;
+
+    // Batch evaluation
+    void clear();
+    bool addAttractor(float x, float y, float heading, float stoppeddistance = 0, float stoppingdistance = 50, float turningdistance = 70);
+    bool addRepulsor(float x, float y, float objectsize = 25, float dontcaredistance = 100);
+    bool addBall(float heading, float kickingdistance = 15.0, float stoppingdistance = 65);
+    int size() const;
+    Vector3<float> evaluate() const;
+    Vector3<float> evaluateAt(float x, float y, float heading) const;
+    void sample(float xmin, float xmax, float ymin, float ymax, float step, float heading, std::vector<Vector3<float> >& samples) const;
+    void sample(float xmin, float xmax, float ymin, float ymax, float step, float heading, std::ostream& output) const;
+private:
+    /*! @brief An attractor, repulsor or ball added to the field */
+    struct Element
+    {
+        enum Type
+        {
+            Attractor,
+            Repulsor,
+            Ball
+        };
+        Type Kind;                      //!< the type of potential
+        float X;                        //!< the field x position in cm of an attractor or repulsor
+        float Y;                        //!< the field y position in cm of an attractor or repulsor
+        float Heading;                  //!< the desired field heading of an attractor, or the field direction to face the ball
+        float A;                        //!< the stopped distance, the object size or the kicking distance
+        float B;                        //!< the stopping distance, the don't care distance or the stopping distance
+        float C;                        //!< the turning distance of an attractor
+        Vector3<float> Relative;        //!< the cached (distance, bearing, heading difference) from the current pose
+    };
+
+    void relativeState(float x, float y, float heading, float selfx, float selfy, float selfheading, Vector3<float>& relative) const;
+    void updateElement(Element& element) const;
+    Vector3<float> evaluateElement(const Element& element, const Vector3<float>& relative) const;
+    void updateIntercept() const;
+private:
+    static const int m_max_elements = 32;       //!< the maximum number of potentials in a batch
+    static const int m_key_size = 10;           //!< the number of world model values the cached values depend on
+
+    float m_key[m_key_size];                    //!< the world model values the cached values were calculated from
+    double m_sensors_time;                      //!< the time of the sensor data the obstacle distances were read from
+
+    float m_x;                                  //!< the robot's field x position (cm)
+    float m_y;                                  //!< the robot's field y position (cm)
+    float m_heading;                            //!< the robot's field heading (rad)
+
+    float m_ball_distance;                      //!< the ball's distance on the ground (cm)
+    float m_ball_bearing;                       //!< the ball's relative bearing (rad)
+    float m_ball_x;                             //!< the ball's field x position (cm)
+    float m_ball_y;                             //!< the ball's field y position (cm)
+    float m_ball_velocity_x;                    //!< the ball's field x velocity (cm/s)
+    float m_ball_velocity_y;                    //!< the ball's field y velocity (cm/s)
+    mutable bool m_intercept_valid;             //!< true if m_intercept has been calculated for the current frame
+    mutable Vector3<float> m_intercept;         //!< the closest intercept with the ball [time (s), x (cm), y (cm)]
+
+    float m_left_obstacle;                      //!< the distance to the obstacle on the left (cm)
+    float m_right_obstacle;                     //!< the distance to the obstacle on the right (cm)
+
+    Element m_elements[m_max_elements];         //!< the potentials in the batch
+    int m_num_elements;                         //!< the number of potentials in the batch
+};
+
+#endif
+
@@ -25,6 +25,7 @@
 #include "../SoccerState.h"
 #include "BallIsLostState.h"
 #include "Behaviour/BehaviourPotentials.h"
+#include "Behaviour/PotentialField.h"
 
 #include "Infrastructure/Jobs/JobList.h"
 #include "Infrastructure/NUSensorsData/NUSensorsData.h"
@@ -237,9 +238,10 @@ protected:
                 m_position[2] = 0;
             }
         }
-        vector<float> speed = BehaviourPotentials::goToFieldState(m_field_objects->self, m_position, 0, 55, 0);
-        vector<float> result = BehaviourPotentials::sensorAvoidObjects(speed, m_data, 25, 100);
-        m_jobs->addMotionJob(new WalkJob(result[0], result[1], result[2]));
+        PotentialField& field = PotentialField::current(m_field_objects, m_data);
+        Vector3<float> speed = field.goToFieldState(m_position[0], m_position[1], m_position[2], 0, 55, 0);
+        Vector3<float> result = field.sensorAvoidObjects(speed, 25, 100);
+        m_jobs->addMotionJob(new WalkJob(result.x, result.y, result.z));
         
         float pan_width = 1.1;
         if (ball.isObjectVisible())
@@ -26,6 +26,7 @@
 class SoccerFSMState;       // ChaseState is a SoccerFSMState
 
 #include "Behaviour/BehaviourPotentials.h"
+#include "Behaviour/PotentialField.h"
 
 #include "Infrastructure/Jobs/JobList.h"
 #include "Infrastructure/NUSensorsData/NUSensorsData.h"
@@ -66,7 +67,6 @@ protected:
         #if DEBUG_BEHAVIOUR_VERBOSITY > 1
             debug << "GoToBall" << endl;
         #endif
-        Self& self = m_field_objects->self;
         MobileObject& ball = m_field_objects->mobileFieldObjects[FieldObjects::FO_BALL];
         if (ball.isObjectVisible())
             m_jobs->addMotionJob(new HeadTrackJob(ball));
@@ -77,24 +77,19 @@ protected:
         m_data->get(NUSensorsData::MotionKickActive, iskicking);
         if(!iskicking)
         {
-            vector<float> speed = BehaviourPotentials::goToBall(ball, self, BehaviourPotentials::getBearingToOpponentGoal(m_field_objects, m_game_info));
-            vector<float> result;
+            PotentialField& field = PotentialField::current(m_field_objects, m_data);
+            Vector3<float> speed = field.goToBall(BehaviourPotentials::getBearingToOpponentGoal(m_field_objects, m_game_info));
+            Vector3<float> result;
             // decide whether we need to dodge or not
-            float leftobstacle = 255;
-            float rightobstacle = 255;
-            vector<float> temp;
-            if (m_data->get(NUSensorsData::LDistance, temp) and temp.size() > 0)
-                leftobstacle = temp[0];
-            if (m_data->get(NUSensorsData::RDistance, temp) and temp.size() > 0)
-                rightobstacle = temp[0];
+            float obstacle = min(field.getLeftObstacle(), field.getRightObstacle());
             
             // if the ball is too far away to kick and the obstable is closer than the ball we need to dodge!
-            if (ball.estimatedDistance() > 20 and min(leftobstacle, rightobstacle) < ball.estimatedDistance())
-                result = BehaviourPotentials::sensorAvoidObjects(speed, m_data, min(ball.estimatedDistance(), 25.0f), 75);
+            if (ball.estimatedDistance() > 20 and obstacle < ball.estimatedDistance())
+                result = field.sensorAvoidObjects(speed, min(ball.estimatedDistance(), 25.0f), 75);
             else
                 result = speed;
             
-            m_jobs->addMotionJob(new WalkJob(result[0], result[1], result[2]));
+            m_jobs->addMotionJob(new WalkJob(result.x, result.y, result.z));
         }
         
         if( (ball.estimatedDistance() < 25.0f) && BehaviourPotentials::opponentsGoalLinedUp(m_field_objects, m_game_info))
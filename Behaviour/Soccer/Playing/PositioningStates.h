@@ -26,6 +26,7 @@
 class SoccerFSMState;       // PositioningState is a SoccerFSMState
 
 #include "Behaviour/BehaviourPotentials.h"
+#include "Behaviour/PotentialField.h"
 
 #include "Infrastructure/Jobs/JobList.h"
 #include "Infrastructure/FieldObjects/FieldObjects.h"
@@ -73,9 +74,10 @@ protected:
             turningdistance = 200;
         else
             turningdistance = 100;
-        vector<float> speed = BehaviourPotentials::goToPoint(distance, bearing, ball.estimatedBearing(), 10, 50, turningdistance);
-        vector<float> result = BehaviourPotentials::sensorAvoidObjects(speed, m_data, 25, 75);
-        m_jobs->addMotionJob(new WalkJob(result[0], result[1], result[2]));
+        PotentialField& field = PotentialField::current(m_field_objects, m_data);
+        Vector3<float> speed = PotentialField::goToPoint(distance, bearing, ball.estimatedBearing(), 10, 50, turningdistance);
+        Vector3<float> result = field.sensorAvoidObjects(speed, 25, 75);
+        m_jobs->addMotionJob(new WalkJob(result.x, result.y, result.z));
         
         float pan_width = 1.1;
         if (m_team_info->getPlayerNumber() == 1)
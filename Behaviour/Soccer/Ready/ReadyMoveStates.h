@@ -26,6 +26,7 @@
 #include "ReadyMoveState.h"
 
 #include "Behaviour/BehaviourPotentials.h"
+#include "Behaviour/PotentialField.h"
 
 #include "Infrastructure/Jobs/JobList.h"
 #include "Infrastructure/NUSensorsData/NUSensorsData.h"
@@ -104,14 +105,15 @@ protected:
         
         
         vector<float> position = getReadyFieldPositions();
-        vector<float> speed = BehaviourPotentials::goToFieldState(m_field_objects->self, position, 5, 60, 100);
+        PotentialField& field = PotentialField::current(m_field_objects, m_data);
+        Vector3<float> speed = field.goToFieldState(position[0], position[1], position[2], 5, 60, 100);
         
-        vector<float> result;
+        Vector3<float> result;
         if (m_team_info->getPlayerNumber() != 1)
-            result = BehaviourPotentials::sensorAvoidObjects(speed, m_data, 25, 100);
+            result = field.sensorAvoidObjects(speed, 25, 100);
         else
-            result = BehaviourPotentials::sensorAvoidObjects(speed, m_data, 25, 35);
-        m_jobs->addMotionJob(new WalkJob(result[0], result[1], result[2]));
+            result = field.sensorAvoidObjects(speed, 25, 35);
+        m_jobs->addMotionJob(new WalkJob(result.x, result.y, result.z));
     }
 private:
     vector<float> getReadyFieldPositions()
@@ -25,6 +25,7 @@ SET (YOUR_SRCS  BehaviourProvider.cpp BehaviourProvider.h
                 BehaviourState.cpp BehaviourState.h
                 BehaviourFSMState.cpp BehaviourFSMState.h
                 BehaviourPotentials.h
+                PotentialField.cpp PotentialField.h
                 Behaviour.cpp Behaviour.h
 )
 ####################################################################################
@@ -0,0 +1,140 @@
+/*! @file FieldObjectsSnapshots.cpp
+    @brief Implementation of the FieldObjectsSnapshots class
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "FieldObjectsSnapshots.h"
+
+#include "debug.h"
+
+/*! @brief Creates the snapshots. The first snapshot, version 0, is a default FieldObjects.
+    @param numbuffers the number of copies of the FieldObjects to keep; see SnapshotBuffer
+ */
+FieldObjectsSnapshots::FieldObjectsSnapshots(unsigned int numbuffers) : m_buffer(numbuffers)
+{
+    for (int i=0; i<NumParts; i++)
+        m_changes[i] = 0;
+}
+
+FieldObjectsSnapshots::~FieldObjectsSnapshots()
+{
+}
+
+/*! @brief Publishes a copy of the field objects as the latest snapshot. This should only be called by the thread that
+           updates the field objects, once it has finished a frame.
+    @param objects the field objects to copy
+    @return the version of the new snapshot
+ */
+unsigned int FieldObjectsSnapshots::publish(const FieldObjects& objects)
+{
+    Snapshot previous = m_buffer.pin();
+    const FieldObjects& old = *previous;
+
+    bool changed[NumParts];
+    changed[SelfPart] = not sameSelf(objects.self, old.self);
+    changed[BallPart] = not sameMobileObject(objects.mobileFieldObjects[FieldObjects::FO_BALL], old.mobileFieldObjects[FieldObjects::FO_BALL]);
+
+    changed[RobotsPart] = objects.mobileFieldObjects.size() != old.mobileFieldObjects.size();
+    for (size_t i=FieldObjects::FO_BALL + 1; i<objects.mobileFieldObjects.size() and not changed[RobotsPart]; i++)
+        changed[RobotsPart] = not sameMobileObject(objects.mobileFieldObjects[i], old.mobileFieldObjects[i]);
+
+    changed[StationaryPart] = objects.stationaryFieldObjects.size() != old.stationaryFieldObjects.size();
+    for (size_t i=0; i<objects.stationaryFieldObjects.size() and not changed[StationaryPart]; i++)
+        changed[StationaryPart] = not sameObject(objects.stationaryFieldObjects[i], old.stationaryFieldObjects[i]);
+
+    changed[AmbiguousPart] = objects.ambiguousFieldObjects.size() != old.ambiguousFieldObjects.size();
+    for (size_t i=0; i<objects.ambiguousFieldObjects.size() and not changed[AmbiguousPart]; i++)
+        changed[AmbiguousPart] = not sameObject(objects.ambiguousFieldObjects[i], old.ambiguousFieldObjects[i]);
+    previous.release();
+
+    // the changes are recorded before the snapshot is published, so a reader never sees a new snapshot without its changes
+    unsigned int version = m_buffer.getVersion() + 1;
+    for (int i=0; i<NumParts; i++)
+    {
+        if (changed[i] or version == 1)
+            m_changes[i] = version;
+    }
+    __sync_synchronize();
+    return m_buffer.publish(objects);
+}
+
+/*! @brief Pins the latest snapshot. This can be called from any thread, and does not lock.
+    @return the snapshot, which will not change until it is released or destroyed
+ */
+FieldObjectsSnapshots::Snapshot FieldObjectsSnapshots::pin()
+{
+    return m_buffer.pin();
+}
+
+/*! @brief Returns the version of the latest snapshot */
+unsigned int FieldObjectsSnapshots::getVersion() const
+{
+    return m_buffer.getVersion();
+}
+
+/*! @brief Returns the version of the snapshot in which part of the field objects last changed */
+unsigned int FieldObjectsSnapshots::getChangeVersion(Part part) const
+{
+    return m_changes[part];
+}
+
+/*! @brief Returns true if part of the field objects has changed since the given version
+    @param part the part of the field objects
+    @param version the version the caller last looked at, usually from Snapshot::getVersion()
+ */
+bool FieldObjectsSnapshots::changedSince(Part part, unsigned int version) const
+{
+    return static_cast<int>(m_changes[part] - version) > 0;
+}
+
+/*! @brief Returns the number of times publish() had to wait for a reader to release an old snapshot */
+unsigned int FieldObjectsSnapshots::getNumWriterWaits() const
+{
+    return m_buffer.getNumWriterWaits();
+}
+
+/*! @brief Returns the number of times pin() had to try again because a snapshot was published at the same time */
+unsigned int FieldObjectsSnapshots::getNumReaderRetries() const
+{
+    return m_buffer.getNumReaderRetries();
+}
+
+/*! @brief Returns true if the two objects have the same identity, visual measurement and estimated relative location */
+bool FieldObjectsSnapshots::sameObject(const Object& a, const Object& b)
+{
+    return a.getID() == b.getID() and a.isObjectVisible() == b.isObjectVisible() and a.TimeLastSeen() == b.TimeLastSeen()
+       and a.measuredDistance() == b.measuredDistance() and a.measuredBearing() == b.measuredBearing() and a.measuredElevation() == b.measuredElevation()
+       and a.estimatedDistance() == b.estimatedDistance() and a.estimatedBearing() == b.estimatedBearing() and a.estimatedElevation() == b.estimatedElevation();
+}
+
+/*! @brief Returns true if the two mobile objects are the same object, with the same estimate */
+bool FieldObjectsSnapshots::sameMobileObject(const MobileObject& a, const MobileObject& b)
+{
+    return sameObject(a, b) and a.lost() == b.lost()
+       and a.X() == b.X() and a.Y() == b.Y() and a.sdX() == b.sdX() and a.sdY() == b.sdY()
+       and a.velX() == b.velX() and a.velY() == b.velY() and a.sdVelX() == b.sdVelX() and a.sdVelY() == b.sdVelY();
+}
+
+/*! @brief Returns true if the two self localisations are the same */
+bool FieldObjectsSnapshots::sameSelf(const Self& a, const Self& b)
+{
+    return a.lost() == b.lost() and a.wmX() == b.wmX() and a.wmY() == b.wmY() and a.Heading() == b.Heading()
+       and a.sdX() == b.sdX() and a.sdY() == b.sdY() and a.sdHeading() == b.sdHeading();
+}
+
@@ -0,0 +1,75 @@
+/*! @file FieldObjectsSnapshots.h
+    @brief Declaration of the FieldObjectsSnapshots class
+
+    @class FieldObjectsSnapshots
+    @brief Versioned snapshots of the FieldObjects, so that other threads can read a consistent copy of them
+
+    Vision and localisation update the FieldObjects on the blackboard in place. Once a frame has been processed the
+    SeeThinkThread publishes a copy of them here, with a new version number. Threads other than the SeeThinkThread
+    (eg. the TeamTransmissionThread) pin() the latest snapshot, and can read it for as long as they like without
+    a lock, and without it being changed underneath them.
+
+    Each publish also compares the new copy with the previous one, and records the version in which each part of
+    the FieldObjects last changed. This makes "has the ball estimate changed since version N" a single comparison.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FIELDOBJECTSSNAPSHOTS_H
+#define FIELDOBJECTSSNAPSHOTS_H
+
+#include "FieldObjects.h"
+#include "Tools/Threading/SnapshotBuffer.h"
+
+class FieldObjectsSnapshots
+{
+public:
+    enum Part
+    {
+        SelfPart = 0,               //!< the self localisation
+        BallPart = 1,               //!< the ball
+        RobotsPart = 2,             //!< the mobile objects other than the ball
+        StationaryPart = 3,         //!< the stationary objects
+        AmbiguousPart = 4,          //!< the ambiguous objects
+        NumParts = 5
+    };
+    typedef SnapshotBuffer<FieldObjects>::Snapshot Snapshot;
+public:
+    FieldObjectsSnapshots(unsigned int numbuffers = 4);
+    ~FieldObjectsSnapshots();
+
+    unsigned int publish(const FieldObjects& objects);
+    Snapshot pin();
+
+    unsigned int getVersion() const;
+    unsigned int getChangeVersion(Part part) const;
+    bool changedSince(Part part, unsigned int version) const;
+
+    unsigned int getNumWriterWaits() const;
+    unsigned int getNumReaderRetries() const;
+private:
+    static bool sameObject(const Object& a, const Object& b);
+    static bool sameMobileObject(const MobileObject& a, const MobileObject& b);
+    static bool sameSelf(const Self& a, const Self& b);
+private:
+    SnapshotBuffer<FieldObjects> m_buffer;              //!< the published copies
+    volatile unsigned int m_changes[NumParts];          //!< the version in which each part last changed
+};
+
+#endif
+
@@ -17,14 +17,14 @@ class Self {
 		~Self();
 		Self(float x, float y);
         void updateLocationOfSelf(float wmX, float wmY, float heading, float sdX, float sdY, float sdHeading,bool lost);
-		float wmX(){return WorldModelLocation[0];}
-		float wmY(){return WorldModelLocation[1];}
-		float Heading(){return WorldModelLocation[2];}
+		float wmX() const {return WorldModelLocation.x;}
+		float wmY() const {return WorldModelLocation.y;}
+		float Heading() const {return WorldModelLocation.z;}
 		std::vector<float> wmState();
-        float sdX() {return WorldModelLocationError[0];}
-        float sdY() {return WorldModelLocationError[1];}
-        float sdHeading() {return WorldModelLocationError[2];}
-        bool lost();
+        float sdX() const {return WorldModelLocationError.x;}
+        float sdY() const {return WorldModelLocationError.y;}
+        float sdHeading() const {return WorldModelLocationError.z;}
+        bool lost() const;
     
         std::vector<float> CalculateDifferenceFromFieldState(const std::vector<float> desiredState);
         std::vector<float> CalculateDifferenceFromFieldLocation(const std::vector<float> desiredLocation);
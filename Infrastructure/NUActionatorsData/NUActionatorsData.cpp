@@ -377,7 +377,11 @@ float NUActionatorsData::interpolate(const double& time, const float& current, c
  */
 bool NUActionatorsData::isMemberOfGroup(const string& name, const id_t& group)
 {
-    return belongsToGroup(name, group);
+    id_t* id = getId(name);
+    if (id != NULL)
+        return isInGroup(*id, group);
+    else
+        return belongsToGroup(name, group);
 }
 
 /*! @brief Returns the number of actionators in actionatorid. Useful for determining, for example, the number of joints in a leg */
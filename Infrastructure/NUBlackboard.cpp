@@ -25,6 +25,7 @@
 #include "Infrastructure/NUActionatorsData/NUActionatorsData.h"
 #include "Infrastructure/NUImage/NUImage.h"
 #include "Infrastructure/FieldObjects/FieldObjects.h"
+#include "Infrastructure/FieldObjects/FieldObjectsSnapshots.h"
 #include "Infrastructure/Jobs/Jobs.h"
 #include "Infrastructure/GameInformation/GameInformation.h"
 #include "Infrastructure/TeamInformation/TeamInformation.h"
@@ -40,6 +41,7 @@ NUBlackboard::NUBlackboard()
     Actions = 0;
     Image = 0;
     Objects = 0;
+    ObjectSnapshots = 0;
     Jobs = 0;
     GameInfo = 0;
     TeamInfo = 0;
@@ -55,6 +57,8 @@ NUBlackboard::~NUBlackboard()
     Image = 0;
     delete Objects;
     Objects = 0;
+    delete ObjectSnapshots;
+    ObjectSnapshots = 0;
     delete Jobs;
     Jobs = 0;
     delete GameInfo;
@@ -103,6 +107,16 @@ void NUBlackboard::add(FieldObjects* objects)
     delete oldobjects;
 }
 
+/*! @brief Adds a FieldObjectsSnapshots object to the blackboard. Note that ownership of the object is now with the Blackboard. 
+    @param snapshots a pointer to the new field objects snapshots
+ */
+void NUBlackboard::add(FieldObjectsSnapshots* snapshots)
+{
+    FieldObjectsSnapshots* oldsnapshots = ObjectSnapshots;
+    ObjectSnapshots = snapshots;
+    delete oldsnapshots;
+}
+
 /*! @brief Adds a JobList object to the blackboard. Note that ownership of the object is now with the Blackboard. 
     @param joblist a pointer to the new job list
  */
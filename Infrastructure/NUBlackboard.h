@@ -7,6 +7,7 @@
                 - Sensors; which contains all of the sensor data
                 - Actions; which contains all of the actions for the robot's hardware
                 - Objects; which contains all of the information about the location of landmarks in the environment
+                - ObjectSnapshots; which contains consistent copies of the Objects for threads other than the one updating them
                 - Jobs; which contains all of the pending jobs for the robot
                 - GameInfo; which contains all of the information about the state of the 'game'
                 - TeamInfo; which contains all of the information about the team mates' state
@@ -38,6 +39,7 @@ class NUSensorsData;
 class NUActionatorsData;
 class NUImage;
 class FieldObjects;
+class FieldObjectsSnapshots;
 class JobList;
 class GameInformation;
 class TeamInformation;
@@ -53,6 +55,7 @@ public:
     void add(NUActionatorsData* actionsdata);
     void add(NUImage* image);
     void add(FieldObjects* objects);
+    void add(FieldObjectsSnapshots* snapshots);
     void add(JobList* joblist);
     void add(GameInformation* gameinfo);
     void add(TeamInformation* teaminfo);
@@ -62,6 +65,7 @@ public:
     NUActionatorsData* Actions;
     NUImage* Image;
     FieldObjects* Objects;
+    FieldObjectsSnapshots* ObjectSnapshots;
     JobList* Jobs;
     GameInformation* GameInfo;
     TeamInformation* TeamInfo;
@@ -40,16 +40,16 @@ ostream& operator << (ostream& output, const NUData::id_t* id)
     return output;
 }
 
-/*! @brief Streaming operator for id_t* objects. Reads the object to a new object.
+/*! @brief Streaming operator for id_t* objects. The ids are static, so the object is read past rather than into the pointer.
     @param input The input stream containing the data.
-    @param id The pointer where the new object will be written.
+    @param id The pointer, which is left unchanged.
     @return The input stream post read.
  */
 istream& operator >> (istream& input, NUData::id_t* id)
 {
-    id = new NUData::id_t();
-    input >> id->Id;
-    input >> id->Name;
+    NUData::id_t temp;
+    input >> temp.Id;
+    input >> temp.Name;
     return input;
 }
 
@@ -108,8 +108,12 @@ const NUData::id_t NUData::NumJointIds(curr_id++, "NumJointIds", NUData::m_commo
 
 const NUData::id_t NUData::NumCommonIds(curr_id++, "NumCommonIds", NUData::m_common_ids);		//49 Remember that m_num_common_ids needs to be manually set to this value
 
+/*! @brief Adds the devices in hardwarenames, and sets up the map from each id to the indices of the devices under it
+    @param hardwarenames the names of every device on the platform
+ */
 void NUData::addDevices(const vector<string>& hardwarenames)
 {
+    buildLookupTables();
     vector<string> names = standardiseNames(hardwarenames);
     vector<id_t*>& ids = m_ids_copy;
     
@@ -136,7 +140,7 @@ void NUData::addDevices(const vector<string>& hardwarenames)
     {	// fill in the groups
         for (size_t j=0; j<ids.size(); j++)
         {
-            if (not m_id_to_indices[j].empty() and belongsToGroup(*ids[j], *ids[i]))
+            if (not m_id_to_indices[j].empty() and isInGroup(*ids[j], *ids[i]))
             {
                 if (find(m_id_to_indices[i].begin(), m_id_to_indices[i].end(), j) == m_id_to_indices[i].end())
                     m_id_to_indices[i].push_back(j);
@@ -150,6 +154,84 @@ void NUData::addDevices(const vector<string>& hardwarenames)
     #endif
 }
 
+/*! @brief Builds the name to id table, and the dense group membership table.
+ 
+    Both the name matching (substring comparisons) and the group tests are expensive, so we do them all
+    once here, and after that a group test is a single array index, and a name is a single map lookup.
+ */
+void NUData::buildLookupTables()
+{
+    vector<id_t*>& ids = m_ids_copy;
+    size_t numids = ids.size();
+    
+    m_name_to_id.clear();
+    for (size_t i=0; i<numids; i++)
+        m_name_to_id[ids[i]->Name] = ids[i]->Id;
+    
+    m_group_table = vector<bool>(numids*numids, false);
+    for (size_t i=0; i<numids; i++)
+        for (size_t j=0; j<numids; j++)
+            m_group_table[i*numids + j] = belongsToGroup(*ids[j], *ids[i]);
+}
+
+/*! @brief Returns true if member belongs to group. Unlike belongsToGroup this uses the table built in buildLookupTables, 
+           so it is just an array index.
+    @param member the single id
+    @param group the group id
+    @return true if member belongs to group
+ */
+bool NUData::isInGroup(const id_t& member, const id_t& group)
+{
+    if (m_group_table.empty())
+        buildLookupTables();
+    
+    size_t numids = m_ids_copy.size();
+    if (member.Id < 0 or group.Id < 0 or static_cast<size_t>(member.Id) >= numids or static_cast<size_t>(group.Id) >= numids)
+        return false;
+    else
+        return m_group_table[group.Id*numids + member.Id];
+}
+
+/*! @brief Returns the id with the given name. This is intended for config files, scripts and NUview, where ids are given by name.
+ 
+    The name can be either the name of the id, or a hardware name. The first time a hardware name is looked up 
+    it is matched in the same way as addDevices, and the result is remembered so subsequent lookups are cheap.
+ 
+    @param name the name of the sensor/actionator
+    @return a pointer to the id, or NULL if there is no id with that name
+ */
+NUData::id_t* NUData::getId(const string& name)
+{
+    if (m_name_to_id.empty())
+        buildLookupTables();
+    
+    map<string, int>::iterator it = m_name_to_id.find(name);
+    if (it != m_name_to_id.end())
+        return m_ids_copy[it->second];
+    
+    string simplename = getStandardName(name);
+    it = m_name_to_id.find(simplename);
+    if (it == m_name_to_id.end())
+    {   // this is the same matching as used in addDevices
+        for (size_t j=NumCommonGroupIds.Id+1; j<m_ids_copy.size(); j++)
+        {
+            if (*m_ids_copy[j] == simplename)
+            {
+                it = m_name_to_id.insert(make_pair(name, m_ids_copy[j]->Id)).first;
+                break;
+            }
+        }
+    }
+    
+    if (it == m_name_to_id.end())
+        return NULL;
+    else
+    {
+        m_name_to_id[name] = it->second;
+        return m_ids_copy[it->second];
+    }
+}
+
 /*! @brief Returns a vector containing the standardised versions of the vector containing hardware names 
     @param hardwarenames a list of hardwarenames
     @return a vector with the simplified names
@@ -28,6 +28,7 @@
 
 #include <string>
 #include <vector>
+#include <map>
 using namespace std;
 
 class NUData
@@ -156,27 +157,34 @@ public:
     const static id_t NumCommonIds;                 //!< internal use only
     const static int m_num_common_ids = 49;			//!< this *MUST* be manually updated to match NumCommonIds.Id
     
+    virtual ~NUData() {};
+    
     double CurrentTime;    
     double PreviousTime;
     
     vector<id_t*> mapIdToIds(const id_t& id);
+    id_t* getId(const string& name);
 protected:
     static vector<id_t*> m_common_ids;
     vector<id_t*> m_ids_copy;                       //!< this is a non-static copy of the ids. It is non-static so that it is not shared between derived classes (ie sensors and actionators have different ids)
     vector<vector<int> > m_id_to_indices;
     vector<int> m_available_ids;
+    map<string, int> m_name_to_id;                  //!< a table from names (standard and hardware) to the integer id, it is filled on first use, and caches every name that is looked up
+    vector<bool> m_group_table;                     //!< a dense [group][member] table, m_group_table[group*m_ids_copy.size() + member] is true if the member belongs to the group
     
 protected:
     void addDevices(const vector<string>& hardwarenames);
     
     virtual bool belongsToGroup(const id_t& member, const id_t& group);
     virtual bool belongsToGroup(const string& name, const id_t& group);
+    bool isInGroup(const id_t& member, const id_t& group);
     
     vector<int>& mapIdToIndices(const id_t& id);
     
     // debug tools
     void printMap(ostream& output);
 private:
+    void buildLookupTables();
     string getStandardName(const string& hardwarename);
     vector<string> standardiseNames(const vector<string>& hardwarenames);
     template<typename T> bool t_belongsToGroup(const T& member, const id_t& group);
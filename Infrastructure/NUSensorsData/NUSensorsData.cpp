@@ -105,6 +105,7 @@ NUSensorsData::NUSensorsData() : NUData(), TimestampedData()
 
     for (size_t i=0; i<m_ids.size(); i++)
         m_sensors.push_back(Sensor(m_ids[i]->Name));
+    initialiseBlock();
 }
 
 NUSensorsData::~NUSensorsData()
@@ -584,7 +585,7 @@ bool NUSensorsData::get(const id_t& id, bool& data)
     float floatBuffer;
     if (ids.size() == 1)
     {
-        bool successful = m_sensors[ids[0]].get(floatBuffer);
+        bool successful = readSensor(ids[0], floatBuffer);
         data = static_cast<bool>(floatBuffer);
         return successful;
     }
@@ -601,7 +602,7 @@ bool NUSensorsData::get(const id_t& id, float& data)
 {
     vector<int>& ids = mapIdToIndices(id);
     if (ids.size() == 1)
-        return m_sensors[ids[0]].get(data);
+        return readSensor(ids[0], data);
     else
         return false;
 }
@@ -631,7 +632,7 @@ bool NUSensorsData::get(const id_t& id, vector<float>& data)
     if (numids == 0)
         return false;
     else if (numids == 1)
-        return m_sensors[ids[0]].get(data);
+        return readSensor(ids[0], data);
     else
     {
         data.clear();
@@ -640,7 +641,7 @@ bool NUSensorsData::get(const id_t& id, vector<float>& data)
         float floatBuffer;
         for (size_t i=0; i<ids.size(); i++)
         {
-            successful &= m_sensors[ids[i]].get(floatBuffer);
+            successful &= readSensor(ids[i], floatBuffer);
             data.push_back(floatBuffer);
         }
         return successful;
@@ -668,7 +669,7 @@ bool NUSensorsData::get(const id_t& id, vector<vector<float> >& data)
         vector<float> vectorBuffer;
         for (size_t i=0; i<ids.size(); i++)
         {
-            successful &= m_sensors[ids[i]].get(vectorBuffer);
+            successful &= readSensor(ids[i], vectorBuffer);
             data.push_back(vectorBuffer);
         }
         return successful;
@@ -703,14 +704,8 @@ bool NUSensorsData::getJointData(const id_t& id, const JointSensorIndices& in, f
     vector<int>& ids = mapIdToIndices(id);
     if (ids.size() == 1)
     {
-        vector<float> vectorBuffer;
-        if (m_sensors[ids[0]].get(vectorBuffer))
+        if (readSensorElement(ids[0], in, data))
         {
-            if (static_cast<unsigned>(in) < vectorBuffer.size())
-            	data = vectorBuffer[in];
-            else
-                data = numeric_limits<float>::quiet_NaN();
-            
             if (isnan(data))
                 return false;
             else
@@ -743,15 +738,14 @@ bool NUSensorsData::getJointData(const id_t& id, const JointSensorIndices& in, v
         data.clear();
         data.reserve(numids);
         bool successful = true;
-        vector<float> vectorBuffer;
         float floatBuffer;
         for (size_t i=0; i<numids; i++)
         {
-            successful &= m_sensors[ids[i]].get(vectorBuffer);
-            if (static_cast<unsigned>(in) < vectorBuffer.size())
-                floatBuffer = vectorBuffer[in];
-            else
+            if (not readSensorElement(ids[i], in, floatBuffer))
+            {
+                successful = false;
                 floatBuffer = numeric_limits<float>::quiet_NaN();
+            }
             successful &= not isnan(floatBuffer);
             data.push_back(floatBuffer);
         }
@@ -785,13 +779,8 @@ bool NUSensorsData::getEndEffectorData(const id_t& id, const EndEffectorIndices&
     vector<int>& ids = mapIdToIndices(e_id);
     if (ids.size() == 1)
     {
-        vector<float> vectorBuffer;
-        if (m_sensors[ids[0]].get(vectorBuffer))
+        if (readSensorElement(ids[0], in, data))
         {
-            if (static_cast<size_t>(in) < vectorBuffer.size())
-            	data = vectorBuffer[in];
-            else
-                data = numeric_limits<float>::quiet_NaN();
             if (isnan(data))
                 return false;
             else
@@ -818,13 +807,8 @@ bool NUSensorsData::getButtonData(const id_t& id, const ButtonSensorIndices& in,
     vector<int>& ids = mapIdToIndices(id);
     if (ids.size() == 1)
     {
-        vector<float> vectorBuffer;
-        if (m_sensors[ids[0]].get(vectorBuffer))
+        if (readSensorElement(ids[0], in, data))
         {
-            if (static_cast<unsigned>(in) < vectorBuffer.size())
-            	data = vectorBuffer[in];
-            else
-                data = numeric_limits<float>::quiet_NaN();
             if (isnan(data))
                 return false;
             else
@@ -911,7 +895,7 @@ void NUSensorsData::set(const id_t& id, double time, const float& data)
     #endif
     vector<int>& ids = mapIdToIndices(id);
     for (size_t i=0; i<ids.size(); i++)
-        m_sensors[ids[i]].set(time, data);
+        writeSensor(ids[i], time, data);
 }
 
 /*! @brief Sets the current sensor reading for id. If id is a group the each element of data will be given to each member of the group
@@ -930,12 +914,12 @@ void NUSensorsData::set(const id_t& id, double time, const vector<float>& data)
         return;
     else if (numids == 1)
     {   // if id is a single sensor
-        m_sensors[ids[0]].set(time, data);
+        writeSensor(ids[0], time, data);
     }
     else if (numids == data.size())
     {   // if id is a group of sensors
         for (size_t i=0; i<numids; i++)
-            m_sensors[ids[i]].set(time, data[i]);
+            writeSensor(ids[i], time, data[i]);
     }
     else
     {
@@ -960,12 +944,13 @@ void NUSensorsData::set(const id_t& id, double time, const vector<vector<float>
         return;
     else if (numids == 1)
     {   // if id is a single sensor
+        m_block.setAsInvalid(ids[0]);
         m_sensors[ids[0]].set(time, data);
     }
     else if (numids == data.size())
     {   // if id is a group of sensors
         for (size_t i=0; i<numids; i++)
-            m_sensors[ids[i]].set(time, data[i]);
+            writeSensor(ids[i], time, data[i]);
     }
     else
     {
@@ -986,7 +971,10 @@ void NUSensorsData::set(const id_t& id, double time, const string& data)
     #endif
     vector<int>& ids = mapIdToIndices(id);
     for (size_t i=0; i<ids.size(); i++)
+    {
+        m_block.setAsInvalid(ids[i]);
         m_sensors[ids[i]].set(time, data);
+    }
 }
 
 /*! @brief Sets the readings for sensor id to be invalid 
@@ -996,7 +984,7 @@ void NUSensorsData::setAsInvalid(const id_t& id)
 {
     vector<int>& ids = mapIdToIndices(id);
     for (size_t i=0; i<ids.size(); i++)
-        m_sensors[ids[i]].setAsInvalid();
+        invalidateSensor(ids[i]);
 }
 
 /*! @brief Modifies existing sensor data. This is especially for updating 'packed' sensors.
@@ -1012,7 +1000,7 @@ void NUSensorsData::modify(const id_t& id, int start, double time, const float&
     #endif
     vector<int>& ids = mapIdToIndices(id);
     for (size_t i=0; i<ids.size(); i++)
-        m_sensors[ids[i]].modify(time, start, data);
+        modifySensor(ids[i], time, start, data);
 }
 
 /*! @brief Modifies existing sensor data. This is especially for updating 'packed' sensors.
@@ -1032,12 +1020,12 @@ void NUSensorsData::modify(const id_t& id, int start, double time, const vector<
         return;
     else if (numids == 1)
     {   // if id is a single sensor
-        m_sensors[ids[0]].modify(time, start, data);
+        modifySensor(ids[0], time, start, data);
     }
     else if (numids == data.size())
     {   // if id is a group of sensors
         for (size_t i=0; i<numids; i++)
-            m_sensors[ids[i]].modify(time, start, data[i]);
+            modifySensor(ids[i], time, start, data[i]);
     }
     else
     {
@@ -1046,6 +1034,166 @@ void NUSensorsData::modify(const id_t& id, int start, double time, const vector<
     }
 }
 
+/******************************************************************************************************************************************
+                                                                                                                             Storage Access
+ ******************************************************************************************************************************************/
+
+/*! @brief Sets up m_block with a slot for every sensor. 
+ 
+    The capacity of each slot is the size of the vector we expect the sensor to have. The group ids and 
+    the transforms (which are matrices) get no capacity, so their data is always kept in m_sensors.
+ */
+void NUSensorsData::initialiseBlock()
+{
+    vector<unsigned int> capacities(m_sensors.size(), 0);
+    for (size_t i=0; i<capacities.size(); i++)
+    {
+        int id = static_cast<int>(i);
+        if (id <= NumCommonGroupIds.Id or id == NumJointIds.Id or id == NumCommonIds.Id)
+            capacities[i] = 0;
+        else if (id < NumJointIds.Id)
+            capacities[i] = NumJointSensorIndices;
+        else if (id >= LArmEndEffector.Id and id <= RLegEndEffector.Id)
+            capacities[i] = NumEndEffectorIndices;
+        else if (id >= LLegTransform.Id and id <= CameraToGroundTransform.Id)
+            capacities[i] = 0;
+        else if (id >= MainButton.Id and id <= RightButton.Id)
+            capacities[i] = NumButtonIndices;
+        else
+            capacities[i] = 16;             // anything longer than this goes into m_sensors
+    }
+    m_block.setCapacities(capacities);
+}
+
+/*! @brief Reads the float data from the sensor at index
+    @param index the index of the sensor
+    @param data will be updated with the reading
+    @return true if the data is valid, false otherwise
+ */
+bool NUSensorsData::readSensor(int index, float& data) const
+{
+    if (m_block.get(index, data))
+        return true;
+    else
+        return m_sensors[index].get(data);
+}
+
+/*! @brief Reads the vector data from the sensor at index
+    @param index the index of the sensor
+    @param data will be updated with the reading
+    @return true if the data is valid, false otherwise
+ */
+bool NUSensorsData::readSensor(int index, vector<float>& data) const
+{
+    if (m_block.get(index, data))
+        return true;
+    else
+        return m_sensors[index].get(data);
+}
+
+/*! @brief Reads a single element from the vector data of the sensor at index. If the data is in the block it is not copied.
+    @param index the index of the sensor
+    @param element the index into the sensor's vector
+    @param data will be updated with the element, or NaN if the sensor's vector does not have the element
+    @return true if the sensor has a valid vector, false otherwise
+ */
+bool NUSensorsData::readSensorElement(int index, unsigned int element, float& data) const
+{
+    if (m_block.get(index, element, data))
+        return true;
+    else
+    {
+        vector<float> vectorBuffer;
+        if (m_sensors[index].get(vectorBuffer))
+        {
+            if (element < vectorBuffer.size())
+                data = vectorBuffer[element];
+            else
+                data = numeric_limits<float>::quiet_NaN();
+            return true;
+        }
+        else
+            return false;
+    }
+}
+
+/*! @brief Writes float data to the sensor at index */
+void NUSensorsData::writeSensor(int index, double time, const float& data)
+{
+    if (m_block.set(index, time, data))
+        m_sensors[index].setAsInvalid();
+    else
+        m_sensors[index].set(time, data);
+}
+
+/*! @brief Writes vector data to the sensor at index. If the vector does not fit in the block it is put in m_sensors */
+void NUSensorsData::writeSensor(int index, double time, const vector<float>& data)
+{
+    if (m_block.set(index, time, data))
+        m_sensors[index].setAsInvalid();
+    else
+    {
+        m_block.setAsInvalid(index);
+        m_sensors[index].set(time, data);
+    }
+}
+
+/*! @brief Modifies the vector data of the sensor at index, with the same behaviour as Sensor::modify */
+void NUSensorsData::modifySensor(int index, double time, int start, const float& data)
+{
+    if (m_sensors[index].isValid())
+        m_sensors[index].modify(time, start, data);
+    else if (not m_block.modify(index, time, start, data))
+    {
+        spillSensor(index);
+        m_sensors[index].modify(time, start, data);
+    }
+}
+
+/*! @brief Modifies the vector data of the sensor at index, with the same behaviour as Sensor::modify */
+void NUSensorsData::modifySensor(int index, double time, int start, const vector<float>& data)
+{
+    if (m_sensors[index].isValid())
+        m_sensors[index].modify(time, start, data);
+    else if (not m_block.modify(index, time, start, data))
+    {
+        spillSensor(index);
+        m_sensors[index].modify(time, start, data);
+    }
+}
+
+/*! @brief Marks the sensor at index as invalid */
+void NUSensorsData::invalidateSensor(int index)
+{
+    m_block.setAsInvalid(index);
+    m_sensors[index].setAsInvalid();
+}
+
+/*! @brief Moves the data for the sensor at index out of the block and into m_sensors. This is used when the data outgrows its slot. */
+void NUSensorsData::spillSensor(int index)
+{
+    float floatBuffer;
+    vector<float> vectorBuffer;
+    if (m_block.get(index, floatBuffer))
+        m_sensors[index].set(m_block.getTime(index), floatBuffer);
+    else if (m_block.get(index, vectorBuffer))
+        m_sensors[index].set(m_block.getTime(index), vectorBuffer);
+    m_block.setAsInvalid(index);
+}
+
+/*! @brief Returns a Sensor containing all of the data for the sensor at index. This is used for display and serialisation. */
+Sensor NUSensorsData::toSensor(int index) const
+{
+    Sensor sensor(m_sensors[index]);
+    float floatBuffer;
+    vector<float> vectorBuffer;
+    if (m_block.get(index, floatBuffer))
+        sensor.set(m_block.getTime(index), floatBuffer);
+    else if (m_block.get(index, vectorBuffer))
+        sensor.set(m_block.getTime(index), vectorBuffer);
+    return sensor;
+}
+
 /******************************************************************************************************************************************
                                                                                                       Displaying Contents and Serialisation
  ******************************************************************************************************************************************/
@@ -1056,7 +1204,7 @@ void NUSensorsData::modify(const id_t& id, int start, double time, const vector<
 void NUSensorsData::summaryTo(ostream& output) const
 {
     for (unsigned int i=0; i<m_sensors.size(); i++)
-        m_sensors[i].summaryTo(output);
+        toSensor(i).summaryTo(output);
 }
 
 /*! @todo Implement this function
@@ -1082,7 +1230,7 @@ ostream& operator<< (ostream& output, const NUSensorsData& p_data)
     output << p_data.m_available_ids << endl;
     output << p_data.size() << " ";
     for (int i=0; i<p_data.size(); i++)
-        output << p_data.m_sensors[i];
+        output << p_data.toSensor(i);
     return output;
 }
 
@@ -1090,8 +1238,9 @@ ostream& operator<< (ostream& output, const NUSensorsData& p_data)
  */
 istream& operator>> (istream& input, NUSensorsData& p_data)
 {
-    input >> p_data.m_common_ids;
-    input >> p_data.m_ids_copy;
+    vector<NUData::id_t*> ids;          // the ids are static, and are the same as the ones in the stream, so they are only read past
+    input >> ids;
+    input >> ids;
     input >> p_data.m_id_to_indices;
     input >> p_data.m_available_ids;
     p_data.m_sensors.clear();
@@ -1106,6 +1255,18 @@ istream& operator>> (istream& input, NUSensorsData& p_data)
         p_data.m_sensors.push_back(Sensor(tempSensor));
         if(tempSensor.Time > lastUpdateTime) lastUpdateTime = tempSensor.Time;
     }
+    // move the float and vector data into the block
+    p_data.initialiseBlock();
+    for (int i=0; i<numsensors; i++)
+    {
+        Sensor& sensor = p_data.m_sensors[i];
+        float floatBuffer;
+        vector<float> vectorBuffer;
+        if (sensor.get(floatBuffer))
+            p_data.writeSensor(i, sensor.Time, floatBuffer);
+        else if (sensor.get(vectorBuffer))
+            p_data.writeSensor(i, sensor.Time, vectorBuffer);
+    }
     p_data.CurrentTime = lastUpdateTime;
     return input;
 }
@@ -27,6 +27,7 @@
 #define NUSENSORSDATA_H
 
 #include "Sensor.h"
+#include "SensorBlock.h"
 #include "Infrastructure/NUData.h"
 #include "Tools/FileFormats/TimestampedData.h"
 
@@ -222,10 +223,24 @@ private:
     bool getJointData(const id_t& id, const JointSensorIndices& in, vector<float>& data);
     bool getEndEffectorData(const id_t& id, const EndEffectorIndices& in, float& data);
     bool getButtonData(const id_t& id, const ButtonSensorIndices& in, float& data);
+    
+    // Storage access
+    void initialiseBlock();
+    bool readSensor(int index, float& data) const;
+    bool readSensor(int index, vector<float>& data) const;
+    bool readSensorElement(int index, unsigned int element, float& data) const;
+    void writeSensor(int index, double time, const float& data);
+    void writeSensor(int index, double time, const vector<float>& data);
+    void modifySensor(int index, double time, int start, const float& data);
+    void modifySensor(int index, double time, int start, const vector<float>& data);
+    void invalidateSensor(int index);
+    void spillSensor(int index);
+    Sensor toSensor(int index) const;
 
 private:
     static vector<id_t*> m_ids;				 //!< a vector containing all of the actionator ids
-    vector<Sensor> m_sensors;                //!< a vector of all of the sensors
+    vector<Sensor> m_sensors;                //!< a vector of all of the sensors. This only holds the data that does not fit in m_block; matrices, strings and long vectors
+    SensorBlock m_block;                     //!< the contiguous storage for the float and vector data of every sensor
 };  
 
 #endif
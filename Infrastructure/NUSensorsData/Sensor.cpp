@@ -62,7 +62,7 @@ Sensor::Sensor(const Sensor& source)
     @param data will be updated with reading
     @return true if valid sensor reading, false otherwise
  */
-bool Sensor::get(float& data)
+bool Sensor::get(float& data) const
 {
     if (ValidFloat)
     {
@@ -77,7 +77,7 @@ bool Sensor::get(float& data)
     @param data will be updated with reading
     @return true if valid sensor reading, false otherwise
  */
-bool Sensor::get(vector<float>& data)
+bool Sensor::get(vector<float>& data) const
 {
     if (ValidVector)
     {
@@ -92,7 +92,7 @@ bool Sensor::get(vector<float>& data)
     @param data will be updated with reading
     @return true if valid sensor reading, false otherwise
  */
-bool Sensor::get(vector<vector<float> >& data)
+bool Sensor::get(vector<vector<float> >& data) const
 {
     if (ValidMatrix)
     {
@@ -107,7 +107,7 @@ bool Sensor::get(vector<vector<float> >& data)
     @param data will be updated with reading
     @return true if valid sensor reading, false otherwise
  */
-bool Sensor::get(string& data)
+bool Sensor::get(string& data) const
 {
     if (ValidString)
     {
@@ -183,6 +183,12 @@ void Sensor::setAsInvalid()
     ValidString = false;
 }
 
+/*! @brief Returns true if the sensor contains any valid data */
+bool Sensor::isValid() const
+{
+    return ValidFloat or ValidVector or ValidMatrix or ValidString;
+}
+
 /*! @brief Modify existing vector sensor data. This is especially for packed sensors which are share the same Sensor instance.
  	@param time the new sensor data time in ms
  	@param start the position in which the new data will be inserted 
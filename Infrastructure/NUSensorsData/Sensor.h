@@ -39,16 +39,17 @@ public:
     Sensor(string sensorname);
     Sensor(const Sensor& source);
 
-    bool get(float& data);
-    bool get(vector<float>& data);
-    bool get(vector<vector<float> >& data);
-    bool get(string& data);
+    bool get(float& data) const;
+    bool get(vector<float>& data) const;
+    bool get(vector<vector<float> >& data) const;
+    bool get(string& data) const;
     
     void set(double time, const float& data);
     void set(double time, const vector<float>& data);
     void set(double time, const vector<vector<float> >& data);
     void set(double time, const string& data);
     void setAsInvalid();
+    bool isValid() const;
     
     void modify(double time, unsigned int start, const float& data);
     void modify(double time, unsigned int start, const vector<float>& data);
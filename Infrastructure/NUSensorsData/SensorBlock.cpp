@@ -0,0 +1,308 @@
+/*! @file SensorBlock.cpp
+    @brief Implementation of a contiguous storage backend for sensor data
+    @author Jason Kulk
+ 
+  Copyright (c) 2011 Jason Kulk
+ 
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SensorBlock.h"
+
+#include <limits>
+#include <cstring>
+
+/*! @brief Returns bytes rounded up to a multiple of alignment, which must be a power of two */
+static size_t alignBytes(size_t bytes, size_t alignment)
+{
+    return (bytes + alignment - 1) & ~(alignment - 1);
+}
+
+/*! @brief Constructs an empty SensorBlock */
+SensorBlock::SensorBlock()
+{
+    allocate(0, 0);
+}
+
+/*! @brief Constructs a SensorBlock with a slot for each element in capacities
+    @param capacities the maximum number of floats to be stored in each slot
+ */
+SensorBlock::SensorBlock(const vector<unsigned int>& capacities)
+{
+    allocate(0, 0);
+    setCapacities(capacities);
+}
+
+/*! @brief Constructs a copy of other */
+SensorBlock::SensorBlock(const SensorBlock& other)
+{
+    allocate(other.m_num_slots, other.m_num_floats);
+    if (m_bytes > 0)
+        memcpy(m_block, other.m_block, m_bytes);
+}
+
+SensorBlock::~SensorBlock()
+{
+    release();
+}
+
+/*! @brief Copies other into this block. If the blocks have the same number of slots and floats this is a single memcpy */
+SensorBlock& SensorBlock::operator=(const SensorBlock& other)
+{
+    if (this != &other)
+    {
+        if (m_num_slots != other.m_num_slots or m_num_floats != other.m_num_floats)
+        {
+            release();
+            allocate(other.m_num_slots, other.m_num_floats);
+        }
+        if (m_bytes > 0)
+            memcpy(m_block, other.m_block, m_bytes);
+    }
+    return *this;
+}
+
+/*! @brief Sets up the slots in the block, all existing data is lost.
+    @param capacities the maximum number of floats to be stored in each slot
+ */
+void SensorBlock::setCapacities(const vector<unsigned int>& capacities)
+{
+    unsigned int numslots = capacities.size();
+    unsigned int numfloats = 0;
+    for (size_t i=0; i<numslots; i++)
+        numfloats += m_alignment*((capacities[i] + m_alignment - 1)/m_alignment);
+    
+    release();
+    allocate(numslots, numfloats);
+    if (m_bytes > 0)
+        memset(m_block, 0, m_bytes);
+    
+    unsigned int* slotoffsets = reinterpret_cast<unsigned int*>(m_block + m_offsets_start);
+    unsigned int* slotcapacities = reinterpret_cast<unsigned int*>(m_block + m_capacities_start);
+    unsigned int total = 0;
+    for (size_t i=0; i<numslots; i++)
+    {
+        slotoffsets[i] = total;
+        slotcapacities[i] = m_alignment*((capacities[i] + m_alignment - 1)/m_alignment);
+        total += slotcapacities[i];
+    }
+}
+
+/*! @brief Allocates an uninitialised block with the given number of slots and floats, and positions the arrays in it
+    @param numslots the number of slots
+    @param numfloats the total capacity of the slots in floats
+ */
+void SensorBlock::allocate(unsigned int numslots, unsigned int numfloats)
+{
+    m_num_slots = numslots;
+    m_num_floats = numfloats;
+    m_data_start = alignBytes(numslots*sizeof(double), m_block_alignment);
+    m_offsets_start = m_data_start + alignBytes(numfloats*sizeof(float), m_block_alignment);
+    m_capacities_start = m_offsets_start + alignBytes(numslots*sizeof(unsigned int), m_block_alignment);
+    m_lengths_start = m_capacities_start + alignBytes(numslots*sizeof(unsigned int), m_block_alignment);
+    m_flags_start = m_lengths_start + alignBytes(numslots*sizeof(unsigned int), m_block_alignment);
+    m_bytes = m_flags_start + alignBytes(numslots*sizeof(unsigned char), m_block_alignment);
+    
+    if (m_bytes > 0)
+    {   // there is no portable aligned allocation, so allocate enough to align the block by hand
+        m_allocation = new char[m_bytes + m_block_alignment];
+        m_block = reinterpret_cast<char*>(alignBytes(reinterpret_cast<size_t>(m_allocation), m_block_alignment));
+    }
+    else
+    {
+        m_allocation = 0;
+        m_block = 0;
+    }
+}
+
+/*! @brief Frees the block */
+void SensorBlock::release()
+{
+    delete [] m_allocation;
+    m_allocation = 0;
+    m_block = 0;
+    m_bytes = 0;
+}
+
+/*! @brief Gets the float in slot index
+    @param index the slot
+    @param data will be updated with the float
+    @return true if the slot contains a valid float, false otherwise
+ */
+bool SensorBlock::get(unsigned int index, float& data) const
+{
+    if (flags()[index] & m_valid_float)
+    {
+        data = this->data()[offsets()[index]];
+        return true;
+    }
+    else
+        return false;
+}
+
+/*! @brief Gets the vector in slot index
+    @param index the slot
+    @param data will be updated with the vector
+    @return true if the slot contains a valid vector, false otherwise
+ */
+bool SensorBlock::get(unsigned int index, vector<float>& data) const
+{
+    if (flags()[index] & m_valid_vector)
+    {
+        const float* start = this->data() + offsets()[index];
+        data.assign(start, start + lengths()[index]);
+        return true;
+    }
+    else
+        return false;
+}
+
+/*! @brief Gets a single element of the vector in slot index, without copying the rest of the vector
+    @param index the slot
+    @param element the index into the vector
+    @param data will be updated with the element, or NaN if the vector does not have that element
+    @return true if the slot contains a valid vector, false otherwise
+ */
+bool SensorBlock::get(unsigned int index, unsigned int element, float& data) const
+{
+    if (flags()[index] & m_valid_vector)
+    {
+        if (element < lengths()[index])
+            data = this->data()[offsets()[index] + element];
+        else
+            data = numeric_limits<float>::quiet_NaN();
+        return true;
+    }
+    else
+        return false;
+}
+
+/*! @brief Sets the slot to contain a float
+    @param index the slot
+    @param time the timestamp in ms
+    @param data the float
+    @return true if the data was stored, false if the slot has no capacity
+ */
+bool SensorBlock::set(unsigned int index, double time, const float& data)
+{
+    if (capacities()[index] == 0)
+        return false;
+    this->data()[offsets()[index]] = data;
+    lengths()[index] = 1;
+    times()[index] = time;
+    flags()[index] = m_valid_float;
+    return true;
+}
+
+/*! @brief Sets the slot to contain a vector
+    @param index the slot
+    @param time the timestamp in ms
+    @param data the vector
+    @return true if the data was stored, false if the vector does not fit in the slot
+ */
+bool SensorBlock::set(unsigned int index, double time, const vector<float>& data)
+{
+    size_t length = data.size();
+    if (length > capacities()[index])
+        return false;
+    float* slot = this->data() + offsets()[index];
+    for (size_t i=0; i<length; i++)
+        slot[i] = data[i];
+    lengths()[index] = length;
+    times()[index] = time;
+    flags()[index] = m_valid_vector;
+    return true;
+}
+
+/*! @brief Marks the slot as containing no valid data */
+void SensorBlock::setAsInvalid(unsigned int index)
+{
+    flags()[index] = 0;
+}
+
+/*! @brief Modifies existing vector data in a slot. This has exactly the same behaviour as Sensor::modify
+    @param index the slot
+    @param time the timestamp in ms
+    @param start the position in which the new data will be inserted
+    @param data the new data
+    @return true if the modification was handled, false if the result would not fit in the slot (nothing is modified in that case)
+ */
+bool SensorBlock::modify(unsigned int index, double time, unsigned int start, const float& data)
+{
+    float* slot = this->data() + offsets()[index];
+    unsigned int& length = lengths()[index];
+    unsigned char& flag = flags()[index];
+    if (flag & m_valid_vector)
+    {
+        if (start == length and length >= capacities()[index])
+            return false;
+        if (start < length)
+            slot[start] = data;
+        else if (start == length)
+            slot[length++] = data;
+    }
+    else if (flag & m_valid_float)
+    {
+        if (capacities()[index] < 2)
+            return false;
+        slot[1] = data;
+        length = 2;
+        flag = m_valid_vector;
+    }
+    else if (start == 0)
+    {
+        if (capacities()[index] < 1)
+            return false;
+        slot[0] = data;
+        length = 1;
+        flag = m_valid_vector;
+    }
+    times()[index] = time;
+    return true;
+}
+
+/*! @brief Modifies existing vector data in a slot. This has exactly the same behaviour as Sensor::modify
+    @param index the slot
+    @param time the timestamp in ms
+    @param start the first position in which the new data will be inserted
+    @param data the new data
+    @return true if the modification was handled, false if the result would not fit in the slot (nothing is modified in that case)
+ */
+bool SensorBlock::modify(unsigned int index, double time, unsigned int start, const vector<float>& data)
+{
+    if (flags()[index] & m_valid_vector)
+    {
+        unsigned int length = lengths()[index];
+        if (start <= length and start + data.size() > capacities()[index])
+            return false;
+        float* slot = this->data() + offsets()[index];
+        for (size_t i=0; i<data.size(); i++)
+        {
+            if (start+i < length)
+                slot[start+i] = data[i];
+            else if (start+i == length)
+                slot[length++] = data[i];
+        }
+        lengths()[index] = length;
+        times()[index] = time;
+        return true;
+    }
+    else if (start == 0)
+        return set(index, time, data);
+    else
+    {
+        times()[index] = time;
+        return true;
+    }
+}
@@ -0,0 +1,111 @@
+/*! @file SensorBlock.h
+    @brief Declaration of a contiguous storage backend for sensor data
+ 
+    @class SensorBlock
+    @brief A structure-of-arrays store for float and fixed width vector sensor data
+ 
+    Every Sensor owns a float, a vector<float>, a vector<vector<float> > and a string, so the data for
+    a single frame is scattered over hundreds of small heap blocks. A SensorBlock instead keeps the float 
+    and vector data of every sensor in a single contiguous array of floats, where each sensor has a 
+    slot with a fixed capacity. The timestamps, slot offsets, capacities, lengths and validity flags are
+    kept in parallel arrays.
+ 
+    All of the arrays live in one heap allocation, aligned to a cache line, and each array starts on a 
+    cache line in that allocation. The allocation is plain old data, so copying a SensorBlock into one 
+    with the same slots is a single memcpy. Note that copying a NUSensorsData also copies the Sensors 
+    that hold the data the block does not.
+ 
+    Data that does not fit (matrices, strings and vectors longer than the slot's capacity) is not 
+    handled by a SensorBlock; the set and modify functions return false and it is up to the caller
+    to store it elsewhere.
+ 
+    @author Jason Kulk
+ 
+  Copyright (c) 2011 Jason Kulk
+ 
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SENSORBLOCK_H
+#define SENSORBLOCK_H
+
+#include <vector>
+#include <cstddef>
+using namespace std;
+
+class SensorBlock
+{
+public:
+    SensorBlock();
+    SensorBlock(const vector<unsigned int>& capacities);
+    SensorBlock(const SensorBlock& other);
+    ~SensorBlock();
+    SensorBlock& operator=(const SensorBlock& other);
+    
+    void setCapacities(const vector<unsigned int>& capacities);
+    
+    bool get(unsigned int index, float& data) const;
+    bool get(unsigned int index, vector<float>& data) const;
+    bool get(unsigned int index, unsigned int element, float& data) const;
+    
+    bool set(unsigned int index, double time, const float& data);
+    bool set(unsigned int index, double time, const vector<float>& data);
+    void setAsInvalid(unsigned int index);
+    
+    bool modify(unsigned int index, double time, unsigned int start, const float& data);
+    bool modify(unsigned int index, double time, unsigned int start, const vector<float>& data);
+    
+    /*! @brief Returns true if the slot at index holds valid data */
+    bool isValid(unsigned int index) const {return flags()[index] != 0;};
+    /*! @brief Returns the timestamp of the data in the slot at index */
+    double getTime(unsigned int index) const {return times()[index];};
+    /*! @brief Returns the number of slots in the block */
+    unsigned int size() const {return m_num_slots;};
+    /*! @brief Returns the total number of floats in the block */
+    unsigned int floats() const {return m_num_floats;};
+    /*! @brief Returns the size of the block's allocation in bytes */
+    size_t bytes() const {return m_bytes;};
+private:
+    void allocate(unsigned int numslots, unsigned int numfloats);
+    void release();
+    
+    double* times() {return reinterpret_cast<double*>(m_block);};
+    const double* times() const {return reinterpret_cast<const double*>(m_block);};
+    float* data() {return reinterpret_cast<float*>(m_block + m_data_start);};
+    const float* data() const {return reinterpret_cast<const float*>(m_block + m_data_start);};
+    const unsigned int* offsets() const {return reinterpret_cast<const unsigned int*>(m_block + m_offsets_start);};
+    const unsigned int* capacities() const {return reinterpret_cast<const unsigned int*>(m_block + m_capacities_start);};
+    unsigned int* lengths() {return reinterpret_cast<unsigned int*>(m_block + m_lengths_start);};
+    const unsigned int* lengths() const {return reinterpret_cast<const unsigned int*>(m_block + m_lengths_start);};
+    unsigned char* flags() {return reinterpret_cast<unsigned char*>(m_block + m_flags_start);};
+    const unsigned char* flags() const {return reinterpret_cast<const unsigned char*>(m_block + m_flags_start);};
+private:
+    static const unsigned int m_alignment = 4;          //!< the capacity of each slot is rounded up to a multiple of this, so each slot starts on a 16 byte boundary
+    static const size_t m_block_alignment = 64;         //!< the alignment in bytes of the block, and of each array in it
+    static const unsigned char m_valid_float = 1;       //!< the flag for a slot that contains a valid float
+    static const unsigned char m_valid_vector = 2;      //!< the flag for a slot that contains a valid vector
+    
+    char* m_allocation;                 //!< the memory allocated for the block, which is larger than the block so that it can be aligned
+    char* m_block;                      //!< the aligned block; the timestamps, the data, and the offsets, capacities, lengths and flags of the slots
+    size_t m_bytes;                     //!< the size of the block in bytes
+    unsigned int m_num_slots;           //!< the number of slots in the block
+    unsigned int m_num_floats;          //!< the number of floats in the data array
+    size_t m_data_start;                //!< the position of the data array in the block in bytes
+    size_t m_offsets_start;             //!< the position of the array of slot offsets (into the data array) in the block in bytes
+    size_t m_capacities_start;          //!< the position of the array of slot capacities (in floats) in the block in bytes
+    size_t m_lengths_start;             //!< the position of the array of the number of floats in use in each slot in the block in bytes
+    size_t m_flags_start;               //!< the position of the array of slot validity flags in the block in bytes
+};
+
+#endif
@@ -0,0 +1,231 @@
+/*! @file TeamSimulation.cpp
+    @brief A local simulation of a team of robots sharing team packets over loopback UDP
+
+    Each simulated robot has its own TeamPacketCodec and UDP socket on 127.0.0.1. Every period each robot encodes a
+    TeamPacket from a simulated ball and self estimate, and sends it to each of the other robots, dropping it with
+    the given probability to simulate packet loss. Each robot then decodes everything it received.
+
+    The simulation runs on a simulated clock, as fast as it can, and reports:
+        - the bytes per second sent by each robot, compared with the old fixed size TeamPacket at 250 ms
+        - the time taken to decode a packet
+        - the number of packets ignored because their key frame was lost
+        - how old the latest shared estimate from each team mate is, sampled every period
+        - the error introduced by the fixed point encoding
+
+    Usage: teamsimulation [robots] [period ms] [loss probability] [duration s] [key frame interval] [base port]
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Infrastructure/TeamInformation/TeamInformation.h"
+#include "Infrastructure/TeamInformation/TeamPacketCodec.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+struct SimulatedRobot
+{
+    int PlayerNumber;                   //!< the player number; robots are numbered from 1
+    int Socket;                         //!< the robot's UDP socket
+    sockaddr_in Address;                //!< the address of the socket
+    TeamPacketCodec* Codec;             //!< the robot's codec
+    TeamPacket Packet;                  //!< the packet the robot sends
+    vector<double> SentTimes;           //!< the time each packet was sent, indexed by ID
+    vector<TeamPacket> SentPackets;     //!< each packet that was sent, indexed by ID
+    vector<double> LastReceived;        //!< the time the latest packet received from each player was sent, or -1
+};
+
+static double getRealTime()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return 1e9*now.tv_sec + now.tv_nsec;
+}
+
+/*! @brief Fills a robot's packet with a smoothly moving estimate of the ball and of itself */
+static void simulate(SimulatedRobot& robot, unsigned long id, double time)
+{
+    double t = time/1000;
+    int i = robot.PlayerNumber;
+    TeamPacket& packet = robot.Packet;
+    packet.ID = id;
+    packet.SentTime = time;
+    packet.PlayerNumber = i;
+
+    bool seen = sin(0.2*t + i) > -0.5;
+    if (seen)
+        packet.Ball.TimeSinceLastSeen = 0;
+    else
+        packet.Ball.TimeSinceLastSeen += 100;
+    packet.Ball.X = 200*sin(0.3*t) + 5*sin(0.7*t + i);
+    packet.Ball.Y = 150*sin(0.5*t) + 5*cos(0.9*t + i);
+    packet.Ball.SRXX = 10 + 5*sin(0.1*t + i);
+    packet.Ball.SRXY = 2*sin(0.13*t);
+    packet.Ball.SRYY = 10 + 5*cos(0.1*t + i);
+    packet.Self.X = 100*cos(0.1*t + i);
+    packet.Self.Y = 100*sin(0.1*t + i);
+    packet.Self.Heading = fmod(0.1*t + i, 2*M_PI) - M_PI;
+    packet.Self.SDX = 15;
+    packet.Self.SDY = 15;
+    packet.Self.SDHeading = 0.1;
+    packet.TimeToBall = sqrt(pow(packet.Ball.X - packet.Self.X, 2) + pow(packet.Ball.Y - packet.Self.Y, 2))/10;
+}
+
+static double percentile(vector<double>& values, double p)
+{
+    if (values.empty())
+        return 0;
+    size_t index = static_cast<size_t>(p*(values.size() - 1));
+    nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+int main(int argc, char** argv)
+{
+    int numrobots = argc > 1 ? atoi(argv[1]) : 5;
+    double period = argc > 2 ? atof(argv[2]) : 100;
+    double loss = argc > 3 ? atof(argv[3]) : 0.2;
+    double duration = argc > 4 ? atof(argv[4]) : 600;
+    int keyinterval = argc > 5 ? atoi(argv[5]) : 2;
+    int baseport = argc > 6 ? atoi(argv[6]) : 21000;
+    if (numrobots < 2 or numrobots >= TeamPacketCodec::MaxPlayers or period <= 0)
+    {
+        printf("Usage: %s [robots] [period ms] [loss probability] [duration s] [key frame interval] [base port]\n", argv[0]);
+        return 1;
+    }
+    srand(1);
+
+    vector<SimulatedRobot> robots(numrobots);
+    for (int i=0; i<numrobots; i++)
+    {
+        SimulatedRobot& robot = robots[i];
+        robot.PlayerNumber = i + 1;
+        robot.Codec = new TeamPacketCodec(1, keyinterval);
+        memset(&robot.Packet, 0, sizeof(robot.Packet));
+        robot.Packet.TeamNumber = 1;
+        robot.LastReceived = vector<double>(numrobots + 1, -1);
+
+        robot.Socket = socket(AF_INET, SOCK_DGRAM, 0);
+        memset(&robot.Address, 0, sizeof(robot.Address));
+        robot.Address.sin_family = AF_INET;
+        robot.Address.sin_port = htons(baseport + i);
+        robot.Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (robot.Socket < 0 or bind(robot.Socket, (sockaddr*) &robot.Address, sizeof(robot.Address)) < 0)
+        {
+            perror("Unable to bind the simulated robot's socket");
+            return 1;
+        }
+        fcntl(robot.Socket, F_SETFL, O_NONBLOCK);
+    }
+
+    vector<double> decodetimes, ages, errors;
+    unsigned int numsent = 0, numdropped = 0;
+    unsigned long numticks = static_cast<unsigned long>(1000*duration/period);
+    for (unsigned long tick=1; tick<=numticks; tick++)
+    {
+        double time = tick*period;
+        for (int i=0; i<numrobots; i++)
+        {   // every robot sends a packet to its team mates
+            SimulatedRobot& robot = robots[i];
+            simulate(robot, tick, time);
+            robot.SentTimes.push_back(time);
+            robot.SentPackets.push_back(robot.Packet);
+            unsigned char buffer[TeamPacketCodec::MaxPacketSize];
+            int size = robot.Codec->encode(robot.Packet, buffer);
+            for (int j=0; j<numrobots; j++)
+            {
+                if (j == i)
+                    continue;
+                if (rand() < loss*RAND_MAX)
+                    numdropped++;
+                else
+                    sendto(robot.Socket, buffer, size, 0, (sockaddr*) &robots[j].Address, sizeof(robots[j].Address));
+                numsent++;
+            }
+        }
+        for (int i=0; i<numrobots; i++)
+        {   // every robot decodes what it received
+            SimulatedRobot& robot = robots[i];
+            unsigned char buffer[512];
+            int size;
+            while ((size = recv(robot.Socket, buffer, sizeof(buffer), 0)) > 0)
+            {
+                TeamPacket packet;
+                double start = getRealTime();
+                bool decoded = robot.Codec->decode(buffer, size, packet);
+                decodetimes.push_back(getRealTime() - start);
+                if (not decoded or packet.PlayerNumber < 1 or packet.PlayerNumber > numrobots)
+                    continue;
+                SimulatedRobot& sender = robots[packet.PlayerNumber - 1];
+                if (packet.ID < 1 or packet.ID > sender.SentTimes.size())
+                    continue;
+                const TeamPacket& sent = sender.SentPackets[packet.ID - 1];
+                errors.push_back(sqrt(pow(packet.Ball.X - sent.Ball.X, 2) + pow(packet.Ball.Y - sent.Ball.Y, 2)));
+                robot.LastReceived[packet.PlayerNumber] = max(robot.LastReceived[packet.PlayerNumber], sender.SentTimes[packet.ID - 1]);
+            }
+            for (int j=1; j<=numrobots; j++)
+            {   // how old is the latest estimate from each team mate
+                if (j != robot.PlayerNumber and robot.LastReceived[j] >= 0)
+                    ages.push_back(time - robot.LastReceived[j]);
+            }
+        }
+    }
+
+    unsigned int encodedbytes = 0, encoded = 0, keyframes = 0, decoded = 0, invalid = 0, missingkey = 0;
+    for (int i=0; i<numrobots; i++)
+    {
+        encodedbytes += robots[i].Codec->getNumEncodedBytes();
+        encoded += robots[i].Codec->getNumEncoded();
+        keyframes += robots[i].Codec->getNumKeyFrames();
+        decoded += robots[i].Codec->getNumDecoded();
+        invalid += robots[i].Codec->getNumInvalid();
+        missingkey += robots[i].Codec->getNumMissingKeyFrame();
+        close(robots[i].Socket);
+        delete robots[i].Codec;
+    }
+
+    double meandecode = 0, meanage = 0, meanerror = 0;
+    for (size_t i=0; i<decodetimes.size(); i++)
+        meandecode += decodetimes[i]/decodetimes.size();
+    for (size_t i=0; i<ages.size(); i++)
+        meanage += ages[i]/ages.size();
+    for (size_t i=0; i<errors.size(); i++)
+        meanerror += errors[i]/errors.size();
+
+    printf("robots %d, period %.0f ms, loss %.2f, duration %.0f s, key frame interval %d\n", numrobots, period, loss, duration, keyinterval);
+    printf("bytes/s per robot: %.1f (mean packet %.1f bytes, %u key frames of %u)\n", 1000*encodedbytes/(numrobots*numticks*period), static_cast<double>(encodedbytes)/encoded, keyframes, encoded);
+    printf("bytes/s per robot with the old TeamPacket at 250 ms: %.1f (%u bytes)\n", 1000.0*sizeof(TeamPacket)/250, static_cast<unsigned int>(sizeof(TeamPacket)));
+    printf("packets sent %u, dropped %u, decoded %u, invalid %u, missing key frame %u\n", numsent, numdropped, decoded, invalid, missingkey);
+    printf("decode ns: mean %.0f p99 %.0f max %.0f\n", meandecode, percentile(decodetimes, 0.99), percentile(decodetimes, 1.0));
+    printf("estimate age ms: mean %.1f p99 %.1f max %.1f\n", meanage, percentile(ages, 0.99), percentile(ages, 1.0));
+    printf("ball encoding error cm: mean %.3f max %.3f\n", meanerror, percentile(errors, 1.0));
+    return 0;
+}
+
@@ -24,20 +24,23 @@
 #include "Infrastructure/NUSensorsData/NUSensorsData.h"
 #include "Infrastructure/NUActionatorsData/NUActionatorsData.h"
 #include "Infrastructure/FieldObjects/FieldObjects.h"
+#include "Infrastructure/FieldObjects/FieldObjectsSnapshots.h"
 #include "NUPlatform/NUPlatform.h"
 
 #include <memory.h>
+#include <iterator>
 
 #include "debug.h"
 #include "debugverbositynetwork.h"
 
-TeamInformation::TeamInformation(int playernum, int teamnum) : m_TIMEOUT(2000)
+TeamInformation::TeamInformation(int playernum, int teamnum) : m_TIMEOUT(2000), m_codec(teamnum)
 {
     m_player_number = playernum;
     m_team_number = teamnum;
     m_data = Blackboard->Sensors;
     m_actions = Blackboard->Actions;
     m_objects = Blackboard->Objects;
+    m_snapshots = Blackboard->ObjectSnapshots;
     
     initTeamPacket();
     m_received_packets = vector<boost::circular_buffer<TeamPacket> >(13, boost::circular_buffer<TeamPacket>(3));
@@ -99,14 +102,19 @@ void TeamInformation::updateTeamPacket()
 {
     if (m_data == NULL or m_objects == NULL)
         return;
+    
+    FieldObjectsSnapshots::Snapshot snapshot;
+    if (m_snapshots != NULL)
+        snapshot = m_snapshots->pin();
+    const FieldObjects& objects = snapshot.valid() ? *snapshot : *m_objects;
 
     m_packet.ID = m_packet.ID + 1;
     m_packet.SentTime = m_data->CurrentTime;
-    m_packet.TimeToBall = getTimeToBall();
+    m_packet.TimeToBall = getTimeToBall(objects);
     
     // ------------------------------ Update shared localisation information
     // update shared ball
-    MobileObject& ball = m_objects->mobileFieldObjects[FieldObjects::FO_BALL];
+    const MobileObject& ball = objects.mobileFieldObjects[FieldObjects::FO_BALL];
     m_packet.Ball.TimeSinceLastSeen = ball.TimeSinceLastSeen();
     m_packet.Ball.X = ball.X();
     m_packet.Ball.Y = ball.Y();
@@ -115,7 +123,7 @@ void TeamInformation::updateTeamPacket()
     m_packet.Ball.SRYY = ball.srYY();
     
     // update self
-    Self& self = m_objects->self;
+    const Self& self = objects.self;
     m_packet.Self.X = self.wmX();
     m_packet.Self.Y = self.wmY();
     m_packet.Self.Heading = self.Heading();
@@ -124,12 +132,12 @@ void TeamInformation::updateTeamPacket()
     m_packet.Self.SDHeading = self.sdHeading();
 }
 
-float TeamInformation::getTimeToBall()
+float TeamInformation::getTimeToBall(const FieldObjects& objects)
 {
     float time = 600;
     
-    Self& self = m_objects->self;
-    MobileObject& ball = m_objects->mobileFieldObjects[FieldObjects::FO_BALL];
+    const Self& self = objects.self;
+    const MobileObject& ball = objects.mobileFieldObjects[FieldObjects::FO_BALL];
     float balldistance = ball.estimatedDistance();
     float ballbearing = ball.estimatedBearing();
     
@@ -137,7 +145,7 @@ float TeamInformation::getTimeToBall()
         return time;
     else if (m_player_number == 1 and balldistance > 150)            // goal keeper is a special case, don't chase balls too far away
         return time;
-    else if ((not ball.lost() and not self.lost()) or m_objects->mobileFieldObjects[FieldObjects::FO_BALL].TimeSeen() > 0)
+    else if ((not ball.lost() and not self.lost()) or ball.TimeSeen() > 0)
     {   // if neither the ball or self are lost or if we can see the ball then we can chase.
         vector<float> walkspeed, maxspeed;
         m_data->get(NUSensorsData::MotionWalkSpeed, walkspeed);
@@ -185,7 +193,9 @@ istream& operator>> (istream& input, TeamPacket& packet)
 ostream& operator<< (ostream& output, TeamInformation& info)
 {
     info.updateTeamPacket();
-    output << info.m_packet;
+    unsigned char buffer[TeamPacketCodec::MaxPacketSize];
+    int size = info.m_codec.encode(info.m_packet, buffer);
+    output.write(reinterpret_cast<char*>(buffer), size);
     Platform->toggle(NUPlatform::Led3, Blackboard->Actions->CurrentTime, info.m_led_green);
     return output;
 }
@@ -199,8 +209,16 @@ ostream& operator<< (ostream& output, TeamInformation* info)
 
 istream& operator>> (istream& input, TeamInformation& info)
 {
+    string data((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
     TeamPacket temp;
-    input >> temp;
+    if (not info.m_codec.decode(reinterpret_cast<const unsigned char*>(data.data()), data.size(), temp))
+    {   // the packet is malformed, from another team, or a delta from a player whose key frame we missed
+        #if DEBUG_NETWORK_VERBOSITY > 0
+            debug << ">>TeamInformation. Unable to decode team packet of " << data.size() << " bytes" << endl;
+        #endif
+        return input;
+    }
+    
     double timenow;
     if (info.m_data != NULL)
         timenow = info.m_data->CurrentTime;
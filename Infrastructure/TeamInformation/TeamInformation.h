@@ -28,7 +28,9 @@
 class NUSensorsData;
 class NUActionatorsData;
 class FieldObjects;
+class FieldObjectsSnapshots;
 
+#include "TeamPacketCodec.h"
 #include <boost/circular_buffer.hpp>
 #include <vector>
 #include <iostream>
@@ -91,7 +93,7 @@ public:
 private:
     void initTeamPacket();
     void updateTeamPacket();
-    float getTimeToBall();
+    float getTimeToBall(const FieldObjects& objects);
 private:
     const float m_TIMEOUT;
     int m_player_number;
@@ -100,8 +102,10 @@ private:
     NUSensorsData* m_data;
     NUActionatorsData* m_actions;
     FieldObjects* m_objects;
+    FieldObjectsSnapshots* m_snapshots;                                 //!< the field objects are read through the snapshots when they are available, because they are updated by another thread
     
     TeamPacket m_packet;                                                //!< team packet to send
+    TeamPacketCodec m_codec;                                            //!< the compact wire format the team packets are sent and received in
     vector<boost::circular_buffer<TeamPacket> > m_received_packets;     //!< team packets received from other robots
     
     vector<float> m_led_green;
@@ -0,0 +1,331 @@
+/*! @file TeamPacketCodec.cpp
+    @brief Implementation of the TeamPacketCodec class
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "TeamPacketCodec.h"
+#include "TeamInformation.h"
+
+#include <cstring>
+#include <cmath>
+using namespace std;
+
+//! the number of fixed point units per unit of each field
+static const float FieldScales[TeamPacketCodec::NumFields] = {
+    50,             // TimeToBall in 0.02 s
+    0.1,            // Ball.TimeSinceLastSeen in 10 ms
+    2, 2,           // Ball.X and Ball.Y in 0.5 cm
+    2, 2, 2,        // Ball.SRXX, Ball.SRXY and Ball.SRYY in 0.5 cm
+    2, 2,           // Self.X and Self.Y in 0.5 cm
+    10000,          // Self.Heading in 0.1 mrad
+    2, 2,           // Self.SDX and Self.SDY in 0.5 cm
+    10000           // Self.SDHeading in 0.1 mrad
+};
+
+/*! @brief Creates a codec
+    @param teamnumber the team number; packets from other teams are not decoded
+    @param keyframeinterval the number of packets between key frames. An interval of 1 sends every field in every packet.
+ */
+TeamPacketCodec::TeamPacketCodec(int teamnumber, int keyframeinterval)
+{
+    m_team_number = teamnumber;
+    setKeyFrameInterval(keyframeinterval);
+
+    m_has_key_frame = false;
+    m_force_key_frame = false;
+    m_key_id = 0;
+    m_packets_since_key_frame = 0;
+    memset(m_key_values, 0, sizeof(m_key_values));
+    memset(m_players, 0, sizeof(m_players));
+
+    m_num_encoded = 0;
+    m_num_encoded_bytes = 0;
+    m_num_key_frames = 0;
+    m_num_decoded = 0;
+    m_num_invalid = 0;
+    m_num_missing_key_frame = 0;
+}
+
+TeamPacketCodec::~TeamPacketCodec()
+{
+}
+
+/*! @brief Sets the number of packets between key frames. A short interval costs bandwidth, a long one makes a lost
+           key frame cost more packets. With 20% packet loss, a key frame every second packet at 100 ms keeps the shared
+           estimates fresher than the old full TeamPacket every 250 ms, in less bandwidth.
+ */
+void TeamPacketCodec::setKeyFrameInterval(int interval)
+{
+    if (interval < 1)
+        interval = 1;
+    else if (interval > MaxKeyFrameInterval)
+        interval = MaxKeyFrameInterval;
+    m_key_frame_interval = interval;
+}
+
+/*! @brief Returns the number of packets between key frames */
+int TeamPacketCodec::getKeyFrameInterval() const
+{
+    return m_key_frame_interval;
+}
+
+/*! @brief Makes the next packet encoded a key frame */
+void TeamPacketCodec::forceKeyFrame()
+{
+    m_force_key_frame = true;
+}
+
+/*! @brief Encodes a packet
+    @param packet the packet to encode. Its ID must increase by one for each packet.
+    @param buffer the buffer to write the packet to; it must be at least MaxPacketSize bytes
+    @return the number of bytes written
+ */
+int TeamPacketCodec::encode(const TeamPacket& packet, unsigned char* buffer)
+{
+    short values[NumFields];
+    toValues(packet, values);
+
+    unsigned short id = static_cast<unsigned short>(packet.ID);
+    unsigned short keyage = static_cast<unsigned short>(id - m_key_id);
+    bool keyframe = not m_has_key_frame or m_force_key_frame or m_packets_since_key_frame + 1 >= m_key_frame_interval or keyage > MaxKeyFrameInterval;
+    if (keyframe)
+    {
+        memcpy(m_key_values, values, sizeof(m_key_values));
+        m_key_id = id;
+        keyage = 0;
+        m_has_key_frame = true;
+        m_force_key_frame = false;
+        m_packets_since_key_frame = 0;
+        m_num_key_frames++;
+    }
+    else
+        m_packets_since_key_frame++;
+
+    memcpy(buffer, TEAM_PACKET_COMPACT_HEADER, 4);
+    buffer[4] = static_cast<unsigned char>(packet.PlayerNumber);
+    buffer[5] = static_cast<unsigned char>(m_team_number);
+    buffer[6] = id & 0xFF;
+    buffer[7] = id >> 8;
+    buffer[8] = static_cast<unsigned char>(keyage);
+
+    unsigned int encodings = 0;
+    int size = HeaderSize;
+    for (int i=0; i<NumFields; i++)
+    {
+        int difference = values[i] - m_key_values[i];
+        if (keyframe)
+            encodings |= Absolute << 2*i;
+        else if (difference == 0)
+            continue;
+        else if (difference >= -128 and difference <= 127)
+        {
+            encodings |= Delta << 2*i;
+            buffer[size++] = static_cast<unsigned char>(static_cast<signed char>(difference));
+            continue;
+        }
+        else
+            encodings |= Absolute << 2*i;
+        unsigned short value = static_cast<unsigned short>(values[i]);
+        buffer[size++] = value & 0xFF;
+        buffer[size++] = value >> 8;
+    }
+    for (int i=0; i<4; i++)
+        buffer[9 + i] = (encodings >> 8*i) & 0xFF;
+
+    m_num_encoded++;
+    m_num_encoded_bytes += size;
+    return size;
+}
+
+/*! @brief Decodes a packet. The decoded packet has the full ID, the player and team numbers and every shared field.
+           The times it was sent and received are not part of the packet, and are set to 0.
+    @param data the received bytes
+    @param length the number of received bytes
+    @param packet the packet to decode into. It is only changed if the packet was decoded.
+    @return true if the packet was decoded. False if it was malformed, from another team, or a delta against a key frame
+            that was not received.
+ */
+bool TeamPacketCodec::decode(const unsigned char* data, int length, TeamPacket& packet)
+{
+    if (not isTeamPacket(data, length) or data[5] != m_team_number or data[4] >= MaxPlayers)
+    {
+        m_num_invalid++;
+        return false;
+    }
+
+    unsigned int encodings = data[9] | (data[10] << 8) | (data[11] << 16) | (static_cast<unsigned int>(data[12]) << 24);
+    int expected = HeaderSize;
+    for (int i=0; i<NumFields; i++)
+    {
+        int encoding = (encodings >> 2*i) & 0x3;
+        if (encoding == Delta)
+            expected += 1;
+        else if (encoding == Absolute)
+            expected += 2;
+        else if (encoding != Unchanged)
+            expected = -1;
+    }
+    unsigned char keyage = data[8];
+    if (expected != length or (keyage == 0 and encodings != 0x2AAAAAA) or (encodings >> 2*NumFields) != 0)
+    {   // the fields do not match the length, or a key frame is missing some of its fields
+        m_num_invalid++;
+        return false;
+    }
+
+    PlayerState& player = m_players[data[4]];
+    unsigned short id = data[6] | (data[7] << 8);
+    unsigned short keyid = static_cast<unsigned short>(id - keyage);
+    if (keyage != 0 and (not player.HasKeyFrame or player.KeyID != keyid))
+    {
+        m_num_missing_key_frame++;
+        return false;
+    }
+
+    short values[NumFields];
+    const unsigned char* field = data + HeaderSize;
+    for (int i=0; i<NumFields; i++)
+    {
+        int encoding = (encodings >> 2*i) & 0x3;
+        if (encoding == Unchanged)
+            values[i] = player.KeyValues[i];
+        else if (encoding == Delta)
+            values[i] = static_cast<short>(player.KeyValues[i] + static_cast<signed char>(*field++));
+        else
+        {
+            values[i] = static_cast<short>(field[0] | (field[1] << 8));
+            field += 2;
+        }
+    }
+    if (keyage == 0)
+    {
+        memcpy(player.KeyValues, values, sizeof(player.KeyValues));
+        player.KeyID = id;
+        player.HasKeyFrame = true;
+    }
+
+    if (player.HasID)       // unwrap the 16 bit ID using the last ID from the same player
+        player.LastID += static_cast<short>(id - static_cast<unsigned short>(player.LastID));
+    else
+        player.LastID = id;
+    player.HasID = true;
+
+    memcpy(packet.Header, TEAM_PACKET_STRUCT_HEADER, sizeof(packet.Header));
+    packet.ID = player.LastID;
+    packet.SentTime = 0;
+    packet.ReceivedTime = 0;
+    packet.PlayerNumber = static_cast<char>(data[4]);
+    packet.TeamNumber = static_cast<char>(data[5]);
+    fromValues(values, packet);
+
+    m_num_decoded++;
+    return true;
+}
+
+/*! @brief Returns true if the data has the header and minimum size of a compact team packet */
+bool TeamPacketCodec::isTeamPacket(const unsigned char* data, int length)
+{
+    return length >= HeaderSize and length <= MaxPacketSize and memcmp(data, TEAM_PACKET_COMPACT_HEADER, 4) == 0;
+}
+
+/*! @brief Returns the number of packets encoded */
+unsigned int TeamPacketCodec::getNumEncoded() const
+{
+    return m_num_encoded;
+}
+
+/*! @brief Returns the total number of bytes encoded */
+unsigned int TeamPacketCodec::getNumEncodedBytes() const
+{
+    return m_num_encoded_bytes;
+}
+
+/*! @brief Returns the number of key frames encoded */
+unsigned int TeamPacketCodec::getNumKeyFrames() const
+{
+    return m_num_key_frames;
+}
+
+/*! @brief Returns the number of packets decoded */
+unsigned int TeamPacketCodec::getNumDecoded() const
+{
+    return m_num_decoded;
+}
+
+/*! @brief Returns the number of packets that could not be decoded because they were malformed or from another team */
+unsigned int TeamPacketCodec::getNumInvalid() const
+{
+    return m_num_invalid;
+}
+
+/*! @brief Returns the number of delta packets that could not be decoded because their key frame was not received */
+unsigned int TeamPacketCodec::getNumMissingKeyFrame() const
+{
+    return m_num_missing_key_frame;
+}
+
+/*! @brief Quantises the shared fields of a packet */
+void TeamPacketCodec::toValues(const TeamPacket& packet, short* values)
+{
+    values[TimeToBall] = quantise(packet.TimeToBall, FieldScales[TimeToBall]);
+    values[BallTimeSinceLastSeen] = quantise(packet.Ball.TimeSinceLastSeen, FieldScales[BallTimeSinceLastSeen]);
+    values[BallX] = quantise(packet.Ball.X, FieldScales[BallX]);
+    values[BallY] = quantise(packet.Ball.Y, FieldScales[BallY]);
+    values[BallSRXX] = quantise(packet.Ball.SRXX, FieldScales[BallSRXX]);
+    values[BallSRXY] = quantise(packet.Ball.SRXY, FieldScales[BallSRXY]);
+    values[BallSRYY] = quantise(packet.Ball.SRYY, FieldScales[BallSRYY]);
+    values[SelfX] = quantise(packet.Self.X, FieldScales[SelfX]);
+    values[SelfY] = quantise(packet.Self.Y, FieldScales[SelfY]);
+    values[SelfHeading] = quantise(packet.Self.Heading, FieldScales[SelfHeading]);
+    values[SelfSDX] = quantise(packet.Self.SDX, FieldScales[SelfSDX]);
+    values[SelfSDY] = quantise(packet.Self.SDY, FieldScales[SelfSDY]);
+    values[SelfSDHeading] = quantise(packet.Self.SDHeading, FieldScales[SelfSDHeading]);
+}
+
+/*! @brief Fills the shared fields of a packet from their quantised values */
+void TeamPacketCodec::fromValues(const short* values, TeamPacket& packet)
+{
+    packet.TimeToBall = values[TimeToBall]/FieldScales[TimeToBall];
+    packet.Ball.TimeSinceLastSeen = values[BallTimeSinceLastSeen]/FieldScales[BallTimeSinceLastSeen];
+    packet.Ball.X = values[BallX]/FieldScales[BallX];
+    packet.Ball.Y = values[BallY]/FieldScales[BallY];
+    packet.Ball.SRXX = values[BallSRXX]/FieldScales[BallSRXX];
+    packet.Ball.SRXY = values[BallSRXY]/FieldScales[BallSRXY];
+    packet.Ball.SRYY = values[BallSRYY]/FieldScales[BallSRYY];
+    packet.Self.X = values[SelfX]/FieldScales[SelfX];
+    packet.Self.Y = values[SelfY]/FieldScales[SelfY];
+    packet.Self.Heading = values[SelfHeading]/FieldScales[SelfHeading];
+    packet.Self.SDX = values[SelfSDX]/FieldScales[SelfSDX];
+    packet.Self.SDY = values[SelfSDY]/FieldScales[SelfSDY];
+    packet.Self.SDHeading = values[SelfSDHeading]/FieldScales[SelfSDHeading];
+}
+
+/*! @brief Converts a value to fixed point, saturating values that are out of range. Invalid values are sent as 0. */
+short TeamPacketCodec::quantise(float value, float scale)
+{
+    float scaled = value*scale;
+    if (scaled != scaled)
+        return 0;
+    else if (scaled >= 32767)
+        return 32767;
+    else if (scaled <= -32767)
+        return -32767;
+    else
+        return static_cast<short>(floor(scaled + 0.5));
+}
+
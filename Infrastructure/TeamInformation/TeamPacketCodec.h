@@ -0,0 +1,132 @@
+/*! @file TeamPacketCodec.h
+    @brief Declaration of the TeamPacketCodec class
+
+    @class TeamPacketCodec
+    @brief Encodes TeamPackets into a compact, fixed point wire format, and decodes them again
+
+    The TeamPacket struct is written as a fixed point packet with explicit byte order, so the wire format does not
+    depend on the padding or word size of the robot. Every so often a key frame containing all of the fields is sent.
+    The packets in between are delta encoded against the last key frame: a field that has not changed is not sent
+    at all, a small change is sent as an 8 bit difference, and anything else is sent in full. Because the deltas are
+    against the key frame, rather than the previous packet, losing a delta packet does not affect the ones after it.
+    A receiver that missed a key frame ignores the deltas until the next one arrives.
+
+    The layout of a packet is:
+        - the header (TEAM_PACKET_COMPACT_HEADER)
+        - the player number and team number (1 byte each)
+        - the low 16 bits of the packet ID
+        - the number of packets since the key frame; 0 for a key frame
+        - the encoding of each field (2 bits each, in a 32 bit word)
+        - the fields that were sent (1 or 2 bytes each)
+
+    The encoder is used by the thread sending packets and the decoder by the thread receiving them. They share no
+    state, so one codec can be used by both at once.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEAMPACKETCODEC_H
+#define TEAMPACKETCODEC_H
+
+class TeamPacket;
+
+#define TEAM_PACKET_COMPACT_HEADER "NUtc"
+
+class TeamPacketCodec
+{
+public:
+    enum Field
+    {
+        TimeToBall = 0,
+        BallTimeSinceLastSeen = 1,
+        BallX = 2,
+        BallY = 3,
+        BallSRXX = 4,
+        BallSRXY = 5,
+        BallSRYY = 6,
+        SelfX = 7,
+        SelfY = 8,
+        SelfHeading = 9,
+        SelfSDX = 10,
+        SelfSDY = 11,
+        SelfSDHeading = 12,
+        NumFields = 13
+    };
+    static const int HeaderSize = 13;                                    //!< the size of a packet without any fields
+    static const int MaxPacketSize = HeaderSize + 2*NumFields;           //!< the size of a key frame
+    static const int MaxPlayers = 16;                                    //!< the number of player numbers a decoder keeps key frames for
+    static const int MaxKeyFrameInterval = 255;                          //!< the number of packets since the key frame has to fit in a byte
+public:
+    TeamPacketCodec(int teamnumber, int keyframeinterval = 2);
+    ~TeamPacketCodec();
+
+    void setKeyFrameInterval(int interval);
+    int getKeyFrameInterval() const;
+    void forceKeyFrame();
+
+    int encode(const TeamPacket& packet, unsigned char* buffer);
+    bool decode(const unsigned char* data, int length, TeamPacket& packet);
+    static bool isTeamPacket(const unsigned char* data, int length);
+
+    unsigned int getNumEncoded() const;
+    unsigned int getNumEncodedBytes() const;
+    unsigned int getNumKeyFrames() const;
+    unsigned int getNumDecoded() const;
+    unsigned int getNumInvalid() const;
+    unsigned int getNumMissingKeyFrame() const;
+private:
+    enum Encoding
+    {
+        Unchanged = 0,              //!< the field is the same as in the key frame, and is not sent
+        Delta = 1,                  //!< the field is sent as a signed 8 bit difference from the key frame
+        Absolute = 2                //!< the field is sent as a signed 16 bit value
+    };
+    struct PlayerState
+    {
+        bool HasKeyFrame;           //!< true if a key frame has been received from the player
+        unsigned short KeyID;       //!< the wire ID of the key frame
+        short KeyValues[NumFields]; //!< the fields of the key frame
+        bool HasID;                 //!< true if a packet has been received from the player
+        unsigned long LastID;       //!< the full ID of the last packet, used to unwrap the 16 bit wire ID
+    };
+
+    static void toValues(const TeamPacket& packet, short* values);
+    static void fromValues(const short* values, TeamPacket& packet);
+    static short quantise(float value, float scale);
+private:
+    int m_team_number;                          //!< the team number packets are encoded with, and that decoded packets must have
+    int m_key_frame_interval;                   //!< the number of packets between key frames
+
+    bool m_has_key_frame;                       //!< true if a key frame has been encoded
+    bool m_force_key_frame;                     //!< true if the next packet must be a key frame
+    unsigned short m_key_id;                    //!< the wire ID of the last key frame sent
+    int m_packets_since_key_frame;              //!< the number of packets sent since the last key frame
+    short m_key_values[NumFields];              //!< the fields of the last key frame sent
+
+    PlayerState m_players[MaxPlayers];          //!< the key frames received from each player
+
+    unsigned int m_num_encoded;                 //!< the number of packets encoded
+    unsigned int m_num_encoded_bytes;           //!< the total size of the packets encoded
+    unsigned int m_num_key_frames;              //!< the number of key frames encoded
+    unsigned int m_num_decoded;                 //!< the number of packets decoded
+    unsigned int m_num_invalid;                 //!< the number of packets that were malformed, or from another team
+    unsigned int m_num_missing_key_frame;       //!< the number of delta packets ignored because their key frame was not received
+};
+
+#endif
+
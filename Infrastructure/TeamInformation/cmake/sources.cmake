@@ -21,6 +21,7 @@ ENDIF()
 
 ########## List your source files here! ############################################
 SET (YOUR_SRCS  TeamInformation.cpp TeamInformation.h
+                TeamPacketCodec.cpp TeamPacketCodec.h
 )
 ####################################################################################
 ########## List your subdirectories here! ##########################################
@@ -0,0 +1,150 @@
+/*! @file LocalisationFrameConverter.cpp
+    @brief Converts existing localisation logs into the binary LocalisationFrame format
+
+    Two kinds of log are converted:
+        - locwm; a stream of Localisation, as read by NUview from locwm.strm. These have no measurements or odometry.
+        - locwmframe; a stream of LocWmFrame, which is a Localisation followed by the NUSensorsData in text and
+          the FieldObjects. The odometry is taken from the sensors and the measurements from the field objects.
+          LocWmFrame can not read these logs itself, because the text sensors are followed by white space it does not skip.
+
+    Conversion stops at the first frame that can not be read, so a truncated log is converted up to its last
+    complete frame. The converted log is named locfrm.strm so that NUview opens it with the other streams.
+
+    Usage: locfrmconverter <input> <output> [locwm|locwmframe]
+    If the kind of log is not given, it is locwmframe when the input file name contains "frame", and locwm otherwise.
+
+    The converter is built with the benchmarks (see Tools/Benchmark/CMakeLists.txt), because it needs the same parts
+    of the nubot and no robot:
+        mkdir build; cd build; cmake ../Tools/Benchmark; make locfrmconverter
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Localisation/Localisation.h"
+#include "Localisation/LocalisationFrame.h"
+#include "Infrastructure/NUBlackboard.h"
+#include "Infrastructure/NUSensorsData/NUSensorsData.h"
+#include "Infrastructure/FieldObjects/FieldObjects.h"
+
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <algorithm>
+using namespace std;
+
+ofstream debug;
+ofstream errorlog;
+
+/*! @brief Skips the white space that ends the text sensors in a LocWmFrame, but is not read back by NUSensorsData.
+           Each sensor ends with endl, and an empty NUSensorsData ends with a space after the number of sensors.
+ */
+static void skipSensorsSeparator(istream& input, const NUSensorsData& sensors)
+{
+    if (sensors.size() == 0)
+    {
+        if (input.peek() == ' ')
+            input.get();
+        return;
+    }
+    while (input.peek() == ' ' or input.peek() == '\t')
+        input.get();
+    if (input.peek() == '\n')
+        input.get();
+}
+
+/*! @brief Reads the next frame of the input log into the localisation, sensors and objects
+    @return false if there is no complete frame left
+ */
+static bool readFrame(istream& input, bool withsensorsandobjects, Localisation& localisation, NUSensorsData& sensors, FieldObjects& objects)
+{
+    try
+    {
+        input >> localisation;
+        if (withsensorsandobjects)
+        {
+            input >> sensors;
+            skipSensorsSeparator(input, sensors);
+            input >> objects;
+        }
+    }
+    catch (...)
+    {
+        return false;
+    }
+    return not input.fail();
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("Usage: %s <input> <output> [locwm|locwmframe]\n", argv[0]);
+        return 1;
+    }
+    string inputname(argv[1]);
+    string basename = inputname.substr(inputname.find_last_of('/') + 1);
+    transform(basename.begin(), basename.end(), basename.begin(), ::tolower);
+    bool withsensorsandobjects = basename.find("frame") != string::npos;
+    if (argc > 3)
+        withsensorsandobjects = strcmp(argv[3], "locwmframe") == 0;
+
+    ifstream input(inputname.c_str(), ios_base::in | ios_base::binary);
+    ofstream output(argv[2], ios_base::out | ios_base::binary);
+    if (not input.is_open() or not output.is_open())
+    {
+        perror("Unable to open the logs");
+        return 1;
+    }
+
+    NUBlackboard* blackboard = new NUBlackboard();         // Localisation takes its inputs from the blackboard when it is constructed, and they are not needed here
+    Localisation* localisation = new Localisation();
+    NUSensorsData* sensors = new NUSensorsData();
+    FieldObjects* objects = new FieldObjects();
+    LocalisationFrame frame;
+    unsigned int numframes = 0;
+    long long stopped = 0;                  // the start of the frame being read
+    while (input.peek() != EOF and readFrame(input, withsensorsandobjects, *localisation, *sensors, *objects))
+    {
+        vector<float> odometry;
+        if (withsensorsandobjects and sensors->getOdometry(odometry) and odometry.size() >= 3)
+        {
+            localisation->m_odomForward = odometry[0];
+            localisation->m_odomLeft = odometry[1];
+            localisation->m_odomTurn = odometry[2];
+        }
+        frame.set(*localisation, *objects);
+        output << frame;
+        numframes++;
+        stopped = input.tellg();
+    }
+    input.clear();
+    input.seekg(0, ios_base::end);
+    long long inputsize = input.tellg();
+    long long outputsize = output.tellp();
+
+    printf("Converted %u frames from %s (%lld bytes) to %s (%lld bytes)\n", numframes, inputname.c_str(), inputsize, argv[2], outputsize);
+    if (stopped < inputsize)
+        printf("Stopped at byte %lld; the rest of the log could not be read\n", stopped);
+
+    delete localisation;
+    delete sensors;
+    delete objects;
+    delete blackboard;
+    return 0;
+}
@@ -0,0 +1,382 @@
+/*! @file LocalisationFrame.cpp
+    @brief Implementation of LocalisationFrame class
+
+    @author Jason Kulk
+
+ Copyright (c) 2011 Jason Kulk
+
+ This file is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This file is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LocalisationFrame.h"
+#include "Localisation.h"
+#include "Infrastructure/FieldObjects/FieldObjects.h"
+
+#include <cstring>
+#include <algorithm>
+using namespace std;
+
+static const char LocalisationFrameMagic[4] = {'N', 'U', 'L', 'F'};
+
+#if defined(__BIG_ENDIAN__) or (defined(__BYTE_ORDER__) and __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    #define LOCALISATIONFRAME_BIG_ENDIAN
+#endif
+
+/*! @brief Copies n values into the buffer as little endian, and advances the buffer */
+template<typename T> static void put(char*& buffer, const T* values, size_t n)
+{
+    memcpy(buffer, values, n*sizeof(T));
+    #ifdef LOCALISATIONFRAME_BIG_ENDIAN
+        for (size_t i=0; i<n; i++)
+            reverse(buffer + i*sizeof(T), buffer + (i+1)*sizeof(T));
+    #endif
+    buffer += n*sizeof(T);
+}
+
+/*! @brief Copies n little endian values out of the buffer, and advances the buffer */
+template<typename T> static void get(const char*& buffer, T* values, size_t n)
+{
+    memcpy(values, buffer, n*sizeof(T));
+    #ifdef LOCALISATIONFRAME_BIG_ENDIAN
+        char* bytes = reinterpret_cast<char*>(values);
+        for (size_t i=0; i<n; i++)
+            reverse(bytes + i*sizeof(T), bytes + (i+1)*sizeof(T));
+    #endif
+    buffer += n*sizeof(T);
+}
+
+/*! @brief Returns the size of the payload for the given header */
+static unsigned int payloadSize(const LocalisationFrame::Header& header)
+{
+    unsigned int n = header.NumMeasurements;
+    unsigned int m = header.NumModels;
+    unsigned int s = header.NumStates;
+    return 3*sizeof(float) + n*(sizeof(short) + sizeof(unsigned short) + 3*sizeof(float)) + m*(sizeof(unsigned short) + sizeof(double) + s*sizeof(double) + s*s*sizeof(double));
+}
+
+LocalisationFrame::LocalisationFrame()
+{
+    memset(&m_header, 0, sizeof(m_header));
+    m_header.Version = Version;
+    m_header.Size = HeaderSize;
+    m_header.PayloadSize = payloadSize(m_header);
+    m_odometry[0] = 0;
+    m_odometry[1] = 0;
+    m_odometry[2] = 0;
+}
+
+LocalisationFrame::~LocalisationFrame()
+{
+}
+
+/*! @brief Sets the frame to the current state of the localisation, and increments the frame number
+    @param localisation the localisation after it has processed the frame
+    @param objects the field objects the localisation processed
+ */
+void LocalisationFrame::set(const Localisation& localisation, const FieldObjects& objects)
+{
+    m_header.Version = Version;
+    m_header.Size = HeaderSize;
+    m_header.FrameNumber++;
+    m_header.Timestamp = localisation.GetTimestamp();
+
+    m_odometry[0] = localisation.m_odomForward;
+    m_odometry[1] = localisation.m_odomLeft;
+    m_odometry[2] = localisation.m_odomTurn;
+
+    m_measurement_ids.clear();
+    m_measurement_types.clear();
+    m_measurements.clear();
+    for (size_t i=0; i<objects.stationaryFieldObjects.size(); i++)
+    {
+        const StationaryObject& object = objects.stationaryFieldObjects[i];
+        if (object.isObjectVisible())
+            addMeasurement(object.getID(), StationaryMeasurement, object.measuredDistance(), object.measuredBearing(), object.measuredElevation());
+    }
+    for (size_t i=0; i<objects.mobileFieldObjects.size(); i++)
+    {
+        const MobileObject& object = objects.mobileFieldObjects[i];
+        if (object.isObjectVisible())
+            addMeasurement(object.getID(), MobileMeasurement, object.measuredDistance(), object.measuredBearing(), object.measuredElevation());
+    }
+    for (size_t i=0; i<objects.ambiguousFieldObjects.size(); i++)
+    {
+        const AmbiguousObject& object = objects.ambiguousFieldObjects[i];
+        if (object.isObjectVisible())
+            addMeasurement(object.getID(), AmbiguousMeasurement, object.measuredDistance(), object.measuredBearing(), object.measuredElevation());
+    }
+    m_header.NumMeasurements = m_measurement_ids.size();
+
+    m_model_indices.clear();
+    m_alphas.clear();
+    m_means.clear();
+    m_sqrt_covariances.clear();
+    unsigned int s = localisation.m_models[0].stateEstimates.getm();
+    for (int i=0; i<Localisation::c_MAX_MODELS; i++)
+    {
+        const KF& model = localisation.m_models[i];
+        if (not model.isActive)
+            continue;
+        m_model_indices.push_back(i);
+        m_alphas.push_back(model.alpha);
+        for (unsigned int r=0; r<s; r++)
+            m_means.push_back(model.stateEstimates[r][0]);
+        for (unsigned int r=0; r<s; r++)
+            for (unsigned int c=0; c<s; c++)
+                m_sqrt_covariances.push_back(model.stateStandardDeviations[r][c]);
+    }
+    m_header.NumModels = m_model_indices.size();
+    m_header.NumStates = s;
+    m_header.PayloadSize = payloadSize(m_header);
+}
+
+/*! @brief Adds a measurement to the frame */
+void LocalisationFrame::addMeasurement(int id, MeasurementType type, float distance, float bearing, float elevation)
+{
+    m_measurement_ids.push_back(id);
+    m_measurement_types.push_back(type);
+    m_measurements.push_back(distance);
+    m_measurements.push_back(bearing);
+    m_measurements.push_back(elevation);
+}
+
+/*! @brief Copies the model bank into a Localisation, so that it can be displayed like a Localisation read from a log.
+           The models that are not in the frame are made inactive.
+ */
+void LocalisationFrame::copyTo(Localisation& localisation) const
+{
+    localisation.m_timestamp = m_header.Timestamp;
+    localisation.m_odomForward = m_odometry[0];
+    localisation.m_odomLeft = m_odometry[1];
+    localisation.m_odomTurn = m_odometry[2];
+    for (int i=0; i<Localisation::c_MAX_MODELS; i++)
+        localisation.m_models[i].isActive = false;
+
+    unsigned int s = m_header.NumStates;
+    for (unsigned int i=0; i<m_model_indices.size(); i++)
+    {
+        if (m_model_indices[i] >= Localisation::c_MAX_MODELS)
+            continue;
+        KF& model = localisation.m_models[m_model_indices[i]];
+        model.isActive = true;
+        model.alpha = m_alphas[i];
+        model.stateEstimates = Matrix(s, 1, false);
+        model.stateStandardDeviations = Matrix(s, s, false);
+        for (unsigned int r=0; r<s; r++)
+        {
+            model.stateEstimates[r][0] = m_means[i*s + r];
+            for (unsigned int c=0; c<s; c++)
+                model.stateStandardDeviations[r][c] = m_sqrt_covariances[(i*s + r)*s + c];
+        }
+    }
+}
+
+double LocalisationFrame::GetTimestamp() const
+{
+    return m_header.Timestamp;
+}
+
+unsigned int LocalisationFrame::getFrameNumber() const
+{
+    return m_header.FrameNumber;
+}
+
+unsigned int LocalisationFrame::getNumMeasurements() const
+{
+    return m_header.NumMeasurements;
+}
+
+unsigned int LocalisationFrame::getNumModels() const
+{
+    return m_header.NumModels;
+}
+
+unsigned int LocalisationFrame::getNumStates() const
+{
+    return m_header.NumStates;
+}
+
+/*! @brief Returns the size of the payload in bytes; the frame occupies HeaderSize + getPayloadSize() bytes in a file */
+unsigned int LocalisationFrame::getPayloadSize() const
+{
+    return m_header.PayloadSize;
+}
+
+const float* LocalisationFrame::getOdometry() const
+{
+    return m_odometry;
+}
+
+const vector<short>& LocalisationFrame::getMeasurementIds() const
+{
+    return m_measurement_ids;
+}
+
+const vector<unsigned short>& LocalisationFrame::getMeasurementTypes() const
+{
+    return m_measurement_types;
+}
+
+const vector<float>& LocalisationFrame::getMeasurements() const
+{
+    return m_measurements;
+}
+
+const vector<unsigned short>& LocalisationFrame::getModelIndices() const
+{
+    return m_model_indices;
+}
+
+const vector<double>& LocalisationFrame::getAlphas() const
+{
+    return m_alphas;
+}
+
+const vector<double>& LocalisationFrame::getMeans() const
+{
+    return m_means;
+}
+
+const vector<double>& LocalisationFrame::getSqrtCovariances() const
+{
+    return m_sqrt_covariances;
+}
+
+/*! @brief Reads and checks a frame header. The stream is left at the start of the payload.
+    @param input the stream positioned at the start of a frame
+    @param header the header to fill
+    @return false if the stream does not contain a valid header
+ */
+bool LocalisationFrame::readHeader(istream& input, Header& header)
+{
+    char buffer[HeaderSize];
+    input.read(buffer, HeaderSize);
+    if (input.gcount() != HeaderSize or memcmp(buffer, LocalisationFrameMagic, sizeof(LocalisationFrameMagic)) != 0)
+        return false;
+
+    const char* p = buffer + sizeof(LocalisationFrameMagic);
+    unsigned short reserved;
+    get(p, &header.Version, 1);
+    get(p, &header.Size, 1);
+    get(p, &header.PayloadSize, 1);
+    get(p, &header.FrameNumber, 1);
+    get(p, &header.Timestamp, 1);
+    get(p, &header.NumMeasurements, 1);
+    get(p, &header.NumModels, 1);
+    get(p, &header.NumStates, 1);
+    get(p, &reserved, 1);
+    if (header.Size < HeaderSize or header.PayloadSize > MaxPayloadSize)
+        return false;
+    if (header.Size > HeaderSize)
+        input.ignore(header.Size - HeaderSize);
+    return input.good();
+}
+
+std::ostream& operator<< (std::ostream& output, const LocalisationFrame& p_frame)
+{
+    const LocalisationFrame::Header& header = p_frame.m_header;
+    unsigned int n = header.NumMeasurements;
+    unsigned int m = header.NumModels;
+    unsigned int s = header.NumStates;
+    unsigned short reserved = 0;
+
+    vector<char>& buffer = p_frame.m_buffer;
+    buffer.resize(LocalisationFrame::HeaderSize + header.PayloadSize);
+    char* p = &buffer[0];
+    put(p, LocalisationFrameMagic, sizeof(LocalisationFrameMagic));
+    put(p, &header.Version, 1);
+    put(p, &header.Size, 1);
+    put(p, &header.PayloadSize, 1);
+    put(p, &header.FrameNumber, 1);
+    put(p, &header.Timestamp, 1);
+    put(p, &header.NumMeasurements, 1);
+    put(p, &header.NumModels, 1);
+    put(p, &header.NumStates, 1);
+    put(p, &reserved, 1);
+
+    put(p, p_frame.m_odometry, 3);
+    if (n > 0)
+    {
+        put(p, &p_frame.m_measurement_ids[0], n);
+        put(p, &p_frame.m_measurement_types[0], n);
+        put(p, &p_frame.m_measurements[0], 3*n);
+    }
+    if (m > 0)
+    {
+        put(p, &p_frame.m_model_indices[0], m);
+        put(p, &p_frame.m_alphas[0], m);
+        if (s > 0)
+        {
+            put(p, &p_frame.m_means[0], m*s);
+            put(p, &p_frame.m_sqrt_covariances[0], m*s*s);
+        }
+    }
+    output.write(&buffer[0], buffer.size());
+    return output;
+}
+
+/*! @brief Reads a frame. Frames written by a later version are read if they only extend the header.
+           If the frame is not valid the failbit is set on the stream.
+ */
+std::istream& operator>> (std::istream& input, LocalisationFrame& p_frame)
+{
+    LocalisationFrame::Header header;
+    if (not LocalisationFrame::readHeader(input, header) or header.PayloadSize != payloadSize(header))
+    {
+        input.setstate(ios_base::failbit);
+        return input;
+    }
+
+    vector<char>& buffer = p_frame.m_buffer;
+    buffer.resize(header.PayloadSize);
+    input.read(&buffer[0], header.PayloadSize);
+    if (input.gcount() != static_cast<streamsize>(header.PayloadSize))
+    {
+        input.setstate(ios_base::failbit);
+        return input;
+    }
+
+    unsigned int n = header.NumMeasurements;
+    unsigned int m = header.NumModels;
+    unsigned int s = header.NumStates;
+    p_frame.m_header = header;
+    p_frame.m_measurement_ids.resize(n);
+    p_frame.m_measurement_types.resize(n);
+    p_frame.m_measurements.resize(3*n);
+    p_frame.m_model_indices.resize(m);
+    p_frame.m_alphas.resize(m);
+    p_frame.m_means.resize(m*s);
+    p_frame.m_sqrt_covariances.resize(m*s*s);
+
+    const char* p = &buffer[0];
+    get(p, p_frame.m_odometry, 3);
+    if (n > 0)
+    {
+        get(p, &p_frame.m_measurement_ids[0], n);
+        get(p, &p_frame.m_measurement_types[0], n);
+        get(p, &p_frame.m_measurements[0], 3*n);
+    }
+    if (m > 0)
+    {
+        get(p, &p_frame.m_model_indices[0], m);
+        get(p, &p_frame.m_alphas[0], m);
+        if (s > 0)
+        {
+            get(p, &p_frame.m_means[0], m*s);
+            get(p, &p_frame.m_sqrt_covariances[0], m*s*s);
+        }
+    }
+    return input;
+}
+
@@ -0,0 +1,129 @@
+/*! @file LocalisationFrame.h
+    @brief Declaration of the LocalisationFrame class
+
+    @class LocalisationFrame
+    @brief A versioned binary record of one frame of localisation; the measurements it used, the odometry and the model bank.
+
+    Each frame starts with a fixed layout header of HeaderSize bytes:
+        - char[4]  'N' 'U' 'L' 'F'
+        - uint16   the format version
+        - uint16   the size of the header, so later versions can extend it
+        - uint32   the size of the payload that follows the header
+        - uint32   the frame number; the first frame set() is 1
+        - float64  the timestamp in ms
+        - uint16   the number of measurements (n)
+        - uint16   the number of models (m)
+        - uint16   the number of states in each model (s)
+        - uint16   reserved
+
+    The payload is a sequence of raw little endian arrays:
+        - float32[3]    odometry; forward, left and turn
+        - int16[n]      the measured object's field object id
+        - uint16[n]     the measured object's kind; one of the MeasurementType
+        - float32[3n]   distance, bearing and elevation of each measurement
+        - uint16[m]     the index of each model in the model bank; only the active models are stored
+        - float64[m]    the alpha of each model
+        - float64[ms]   the state estimate of each model
+        - float64[mss]  the square root of the covariance of each model, row major
+
+    Because the payload size is in the header a reader can index a file without parsing the payloads, and the arrays
+    can be read with a single copy each.
+
+    @author Jason Kulk
+
+ Copyright (c) 2011 Jason Kulk
+
+ This file is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This file is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOCALISATIONFRAME_H
+#define LOCALISATIONFRAME_H
+
+#include "Tools/FileFormats/TimestampedData.h"
+
+#include <iostream>
+#include <vector>
+class Localisation;
+class FieldObjects;
+
+class LocalisationFrame : public TimestampedData
+{
+public:
+    static const unsigned short Version = 1;            //!< the version of the format written
+    static const unsigned short HeaderSize = 32;        //!< the size of the version 1 header in bytes
+    static const unsigned int MaxPayloadSize = 1 << 20; //!< frames claiming a larger payload are rejected as corrupt
+
+    enum MeasurementType
+    {
+        StationaryMeasurement = 0,
+        MobileMeasurement = 1,
+        AmbiguousMeasurement = 2
+    };
+
+    /*! @brief The fixed layout header of a frame */
+    struct Header
+    {
+        unsigned short Version;         //!< the format version
+        unsigned short Size;            //!< the size of the header in bytes
+        unsigned int PayloadSize;       //!< the size of the payload in bytes
+        unsigned int FrameNumber;       //!< the frame number
+        double Timestamp;               //!< the timestamp in ms
+        unsigned short NumMeasurements; //!< the number of measurements
+        unsigned short NumModels;       //!< the number of models
+        unsigned short NumStates;       //!< the number of states in each model
+    };
+
+    LocalisationFrame();
+    ~LocalisationFrame();
+
+    void set(const Localisation& localisation, const FieldObjects& objects);
+    void copyTo(Localisation& localisation) const;
+
+    double GetTimestamp() const;
+    unsigned int getFrameNumber() const;
+    unsigned int getNumMeasurements() const;
+    unsigned int getNumModels() const;
+    unsigned int getNumStates() const;
+    unsigned int getPayloadSize() const;
+
+    const float* getOdometry() const;
+    const std::vector<short>& getMeasurementIds() const;
+    const std::vector<unsigned short>& getMeasurementTypes() const;
+    const std::vector<float>& getMeasurements() const;
+    const std::vector<unsigned short>& getModelIndices() const;
+    const std::vector<double>& getAlphas() const;
+    const std::vector<double>& getMeans() const;
+    const std::vector<double>& getSqrtCovariances() const;
+
+    static bool readHeader(std::istream& input, Header& header);
+
+    friend std::ostream& operator<< (std::ostream& output, const LocalisationFrame& p_frame);
+    friend std::istream& operator>> (std::istream& input, LocalisationFrame& p_frame);
+private:
+    void addMeasurement(int id, MeasurementType type, float distance, float bearing, float elevation);
+private:
+    Header m_header;                                //!< the header, kept up to date by set()
+    float m_odometry[3];                            //!< the odometry used in the time update; forward, left and turn
+    std::vector<short> m_measurement_ids;           //!< the field object id of each measurement
+    std::vector<unsigned short> m_measurement_types;//!< the MeasurementType of each measurement
+    std::vector<float> m_measurements;              //!< distance, bearing and elevation of each measurement
+    std::vector<unsigned short> m_model_indices;    //!< the index in the model bank of each active model
+    std::vector<double> m_alphas;                   //!< the alpha of each active model
+    std::vector<double> m_means;                    //!< the state estimates of the active models, s per model
+    std::vector<double> m_sqrt_covariances;         //!< the square root covariances of the active models, s*s per model, row major
+    mutable std::vector<char> m_buffer;             //!< the frame is encoded into this buffer, so it is written with a single call
+};
+
+#endif
+
@@ -0,0 +1,193 @@
+/*! @file LocalisationLoggerThread.cpp
+    @brief Implementation of a low priority thread for logging localisation frames to disk.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+     This program is free software: you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation, either version 3 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LocalisationLoggerThread.h"
+#include "Localisation/LocalisationFrame.h"
+
+#include "debug.h"
+#include "debugverbositylocalisation.h"
+
+using namespace std;
+
+/*! @brief Constructs and starts the localisation logger thread. The file is not opened until the first frame is written
+    @param filename the path to the localisation stream
+    @param maxqueuesize the maximum number of frames waiting to be written
+ */
+LocalisationLoggerThread::LocalisationLoggerThread(const string& filename, unsigned int maxqueuesize) : Thread(string("LocalisationLoggerThread"), 0)
+{
+    #if DEBUG_LOCALISATION_VERBOSITY > 0
+        debug << "LocalisationLoggerThread::LocalisationLoggerThread(" << filename << ", " << maxqueuesize << ") with priority " << static_cast<int>(m_priority) << endl;
+    #endif
+    m_filename = filename;
+    m_file_buffer = new char[m_file_buffer_size];
+
+    m_max_queue_size = maxqueuesize > 0 ? maxqueuesize : 1;
+    m_flush_requested = false;
+    m_stopping = false;
+    m_finished = false;
+    m_frames_logged = 0;
+    m_frames_dropped = 0;
+    pthread_mutex_init(&m_queue_mutex, NULL);
+    pthread_cond_init(&m_queue_condition, NULL);
+    m_started = start() == 0;
+}
+
+/*! @brief Writes the frames that are still queued, and waits for the thread to finish.
+
+    The thread is asked to finish rather than being joined or cancelled, so that it is never woken after its
+    condition and queue have been destroyed.
+ */
+LocalisationLoggerThread::~LocalisationLoggerThread()
+{
+    #if DEBUG_LOCALISATION_VERBOSITY > 0
+        debug << "LocalisationLoggerThread::~LocalisationLoggerThread(). Logged: " << m_frames_logged << " Dropped: " << m_frames_dropped << endl;
+    #endif
+    pthread_mutex_lock(&m_queue_mutex);
+    m_stopping = true;
+    pthread_cond_broadcast(&m_queue_condition);
+    while (m_started and not m_finished)
+        pthread_cond_wait(&m_queue_condition, &m_queue_mutex);
+    pthread_mutex_unlock(&m_queue_mutex);
+
+    for (size_t i = 0; i < m_queue.size(); i++)
+        delete m_queue[i];
+    for (size_t i = 0; i < m_free.size(); i++)
+        delete m_free[i];
+    m_file.close();
+    delete [] m_file_buffer;
+    pthread_cond_destroy(&m_queue_condition);
+    pthread_mutex_destroy(&m_queue_mutex);
+}
+
+/*! @brief Queues a copy of a frame to be written. The disk is not touched by this function.
+    @param frame the frame to log, which is encoded by the logger thread
+    @return true if the frame was queued without dropping an older frame
+ */
+bool LocalisationLoggerThread::log(const LocalisationFrame& frame)
+{
+    // take a written frame to copy into, or the oldest queued frame if the queue is full
+    LocalisationFrame* copy = NULL;
+    bool dropped = false;
+    pthread_mutex_lock(&m_queue_mutex);
+    if (m_queue.size() >= m_max_queue_size)
+    {
+        copy = m_queue.front();
+        m_queue.pop_front();
+        m_frames_dropped++;
+        dropped = true;
+    }
+    else if (not m_free.empty())
+    {
+        copy = m_free.back();
+        m_free.pop_back();
+    }
+    pthread_mutex_unlock(&m_queue_mutex);
+
+    if (copy)
+        *copy = frame;
+    else
+        copy = new LocalisationFrame(frame);
+
+    pthread_mutex_lock(&m_queue_mutex);
+    m_queue.push_back(copy);
+    pthread_cond_broadcast(&m_queue_condition);
+    pthread_mutex_unlock(&m_queue_mutex);
+    return not dropped;
+}
+
+/*! @brief Requests that the file is flushed once every queued frame has been written */
+void LocalisationLoggerThread::flush()
+{
+    pthread_mutex_lock(&m_queue_mutex);
+    m_flush_requested = true;
+    pthread_cond_broadcast(&m_queue_condition);
+    pthread_mutex_unlock(&m_queue_mutex);
+}
+
+/*! @brief Returns the number of frames that have been written */
+unsigned int LocalisationLoggerThread::getFramesLogged()
+{
+    pthread_mutex_lock(&m_queue_mutex);
+    unsigned int value = m_frames_logged;
+    pthread_mutex_unlock(&m_queue_mutex);
+    return value;
+}
+
+/*! @brief Returns the number of frames that were discarded because the queue was full */
+unsigned int LocalisationLoggerThread::getFramesDropped()
+{
+    pthread_mutex_lock(&m_queue_mutex);
+    unsigned int value = m_frames_dropped;
+    pthread_mutex_unlock(&m_queue_mutex);
+    return value;
+}
+
+/*! @brief The localisation logger's main loop. Writes queued frames until the logger is destroyed, and then writes what is left in the queue
+ */
+void LocalisationLoggerThread::run()
+{
+    #if DEBUG_LOCALISATION_VERBOSITY > 0
+        debug << "LocalisationLoggerThread::run()" << endl;
+    #endif
+
+    while (true)
+    {
+        pthread_mutex_lock(&m_queue_mutex);
+        while (m_queue.empty() and not m_flush_requested and not m_stopping)
+            pthread_cond_wait(&m_queue_condition, &m_queue_mutex);
+
+        if (m_queue.empty())
+        {   // there is nothing left to write, so do the requested flush, and finish if we have been asked to
+            bool stopping = m_stopping;
+            m_flush_requested = false;
+            pthread_mutex_unlock(&m_queue_mutex);
+            m_file.flush();
+            if (stopping)
+                break;
+            else
+                continue;
+        }
+
+        LocalisationFrame* frame = m_queue.front();
+        m_queue.pop_front();
+        pthread_mutex_unlock(&m_queue_mutex);
+        // -----------------------------------------------------------------------------------------------------------------------------------------------------------------
+        if (not m_file.is_open())
+        {
+            m_file.rdbuf()->pubsetbuf(m_file_buffer, m_file_buffer_size);
+            m_file.open(m_filename.c_str(), ios_base::out | ios_base::binary);
+        }
+        m_file << (*frame);
+        if (m_file.fail())
+            errorlog << "LocalisationLoggerThread::run(). Failed to write frame " << frame->getFrameNumber() << " to " << m_filename << endl;
+        // -----------------------------------------------------------------------------------------------------------------------------------------------------------------
+        pthread_mutex_lock(&m_queue_mutex);
+        m_free.push_back(frame);
+        m_frames_logged++;
+        pthread_mutex_unlock(&m_queue_mutex);
+    }
+
+    pthread_mutex_lock(&m_queue_mutex);
+    m_finished = true;
+    pthread_cond_broadcast(&m_queue_condition);
+    pthread_mutex_unlock(&m_queue_mutex);
+}
+
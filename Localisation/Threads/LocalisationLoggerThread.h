@@ -0,0 +1,83 @@
+/*! @file LocalisationLoggerThread.h
+    @brief Declaration of a low priority thread for logging localisation frames to disk.
+
+    @class LocalisationLoggerThread
+    @brief A background thread that writes queued LocalisationFrames to the localisation stream.
+
+    Frames are added to a bounded queue with log(), which copies the frame and never touches the disk. The
+    frame is encoded and written by the logger thread. The queued frames are recycled once they have been
+    written, so after the first few frames logging does not allocate.
+
+    When the queue is full the oldest queued frame is dropped, so a slow disk costs frames rather than
+    see->think latency. The file is written through a large buffer, and counters for frames logged and
+    frames dropped are kept so that it is obvious when the storage can not keep up.
+
+    Destroying the logger writes the frames that are still queued, and waits for the thread to finish.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+     This program is free software: you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation, either version 3 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOCALISATIONLOGGER_THREAD_H
+#define LOCALISATIONLOGGER_THREAD_H
+
+#include "Tools/Threading/Thread.h"
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <fstream>
+#include <pthread.h>
+
+class LocalisationFrame;
+
+class LocalisationLoggerThread : public Thread
+{
+public:
+    LocalisationLoggerThread(const std::string& filename, unsigned int maxqueuesize = 8);
+    ~LocalisationLoggerThread();
+
+    bool log(const LocalisationFrame& frame);
+    void flush();
+
+    unsigned int getFramesLogged();
+    unsigned int getFramesDropped();
+protected:
+    void run();
+private:
+    static const unsigned int m_file_buffer_size = 1 << 18;  //!< the size of the file's buffer, so that the disk sees large sequential writes
+
+    std::string m_filename;                     //!< the path to the localisation stream
+    std::ofstream m_file;                       //!< the localisation stream
+    char* m_file_buffer;                        //!< the buffer for the localisation stream
+
+    unsigned int m_max_queue_size;              //!< the maximum number of frames waiting to be written
+    std::deque<LocalisationFrame*> m_queue;     //!< the frames waiting to be written
+    std::vector<LocalisationFrame*> m_free;     //!< frames that have been written, and can be reused by log()
+    bool m_flush_requested;                     //!< true if the file should be flushed once the queue is empty
+    bool m_stopping;                            //!< true when the thread has been asked to write what is queued and exit
+    bool m_started;                             //!< true if the thread was started, so there is a thread to wait for
+    bool m_finished;                            //!< true once the thread has written what was queued and returned from run()
+    pthread_mutex_t m_queue_mutex;              //!< lock for the queue, free frames, flags and counters
+    pthread_cond_t m_queue_condition;           //!< signalled when a frame is added, a flush is requested, or the thread finishes
+
+    unsigned int m_frames_logged;               //!< the number of frames that have been written
+    unsigned int m_frames_dropped;              //!< the number of frames that were discarded because the queue was full
+};
+
+#endif
+
@@ -26,10 +26,12 @@ SET (YOUR_SRCS  pose2d.h
                KF.cpp KF.h
                Localisation.cpp Localisation.h
 		LocWmFrame
+               LocalisationFrame.cpp LocalisationFrame.h
 )
 ####################################################################################
 ########## List your subdirectories here! ##########################################
 SET (YOUR_DIRS
+Threads
 )
 ####################################################################################
 
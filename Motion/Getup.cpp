@@ -63,6 +63,15 @@ Getup::~Getup()
     delete m_on_right;
 }
 
+/*! @brief Loads the getup scripts, so that the first getup is not delayed by loading its script */
+void Getup::preloadScripts()
+{
+    m_on_back->preload();
+    m_on_front->preload();
+    m_on_left->preload();
+    m_on_right->preload();
+}
+
 /*! @brief Enable the getup */
 void Getup::enable()
 {
@@ -46,6 +46,7 @@ public:
     void stopArms();
     void stopLegs();
     void kill();
+    void preloadScripts();
     
     bool isActive();
     bool isUsingHead();
@@ -240,6 +240,19 @@ void NUMotion::kill()
     m_actions->add(NUActionatorsData::RArm, Platform->getTime() + 2000, rarmpositions, 0);
 }
 
+/*! @brief Loads the motion scripts of every provider that plays them.
+
+    The scripts are otherwise loaded the first time they are played, which delays the first getup or save.
+    This must be called before the SenseMove thread starts, because loading a script is not thread-safe.
+ */
+void NUMotion::preloadScripts()
+{
+    m_getup->preloadScripts();
+    #if defined(USE_BLOCK) or defined(USE_SAVE)
+        m_save->preloadScripts();
+    #endif
+}
+
 /*! @brief Calls kill on each of the active motion providers */
 void NUMotion::killActiveProviders()
 {
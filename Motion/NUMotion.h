@@ -63,6 +63,8 @@ public:
     
     void stop();
     void kill();
+    
+    void preloadScripts();
 private:
     void process(MotionKillJob* job);
     void process(MotionFreezeJob* job);
@@ -63,6 +63,16 @@ NUSave::~NUSave()
     kill();
 }
 
+/*! @brief Loads the block and dive scripts, so that the first save is not delayed by loading its script */
+void NUSave::preloadScripts()
+{
+    m_block_left.preload();
+    m_block_right.preload();
+    m_block_centre.preload();
+    m_dive_left.preload();
+    m_dive_right.preload();
+}
+
 /*! @brief Stops the save module */
 void NUSave::stop()
 {
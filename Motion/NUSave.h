@@ -44,6 +44,7 @@ public:
     void stopArms();
     void stopLegs();
     void kill();
+    void preloadScripts();
     
     bool isActive();
     bool isUsingHead();
@@ -20,6 +20,7 @@
  */
 
 #include "MotionScript.h"
+#include "MotionScriptFile.h"
 #include "MotionFileTools.h"
 #include "Tools/Math/StlVector.h"
 #include "MotionCurves.h"
@@ -38,14 +39,20 @@ using namespace std;
 
 MotionScript::MotionScript()
 {
+    m_is_loaded = true;
     m_is_valid = false;
 }
 
+/*! @brief Constructs a motion script. The script is not loaded until it is first used, so that creating the
+           scripts does not slow down the startup of the robot.
+    @param filename the name of the script, without the path or extension
+ */
 MotionScript::MotionScript(string filename)
 {
     m_name = filename;
-    m_is_valid = load();
-	setUses();
+    m_is_loaded = false;
+    m_is_valid = false;
+    m_playspeed = 1.0;
     m_play_start_time = 0;
 }
 
@@ -59,21 +66,44 @@ MotionScript::~MotionScript()
     
 }
 
+/*! @brief Loads the script, if it has not already been loaded */
+void MotionScript::loadOnFirstUse()
+{
+    if (not m_is_loaded)
+    {
+        m_is_loaded = true;
+        m_is_valid = load();
+        setUses();
+    }
+}
+
+/*! @brief Loads the script now, rather than the first time it is used.
+
+    Loading on first use is not thread-safe, so a script must be preloaded before the thread that plays it starts.
+ */
+void MotionScript::preload()
+{
+    loadOnFirstUse();
+}
+
 /*! @brief Returns the time when the script will be completed */
 double MotionScript::timeFinished()
 {
+    loadOnFirstUse();
     return m_uses_last;
 }
 
 /*! @brief Returns true if the script uses the head */
 bool MotionScript::usesHead()
 {
+    loadOnFirstUse();
     return m_uses_head;
 }
 
 /*! @brief Returns the time when the script finishes with the head */
 double MotionScript::timeFinishedWithHead()
 {
+    loadOnFirstUse();
     if (not m_uses_head)
         return 0;
     else
@@ -83,12 +113,14 @@ double MotionScript::timeFinishedWithHead()
 /*! @brief Returns true if the script uses the left arm */
 bool MotionScript::usesLArm()
 {
+    loadOnFirstUse();
     return m_uses_larm;
 }
 
 /*! @brief Returns the time when the script finishes with the left arm */
 double MotionScript::timeFinishedWithLArm()
 {
+    loadOnFirstUse();
     if (not m_uses_larm)
         return 0;
     else
@@ -98,12 +130,14 @@ double MotionScript::timeFinishedWithLArm()
 /*! @brief Returns true if the script uses the right arm */
 bool MotionScript::usesRArm()
 {
+    loadOnFirstUse();
     return m_uses_rarm;
 }
 
 /*! @brief Returns the time when the script finishes with the right arm */
 double MotionScript::timeFinishedWithRArm()
 {
+    loadOnFirstUse();
     if (not m_uses_rarm)
         return 0;
     else
@@ -113,12 +147,14 @@ double MotionScript::timeFinishedWithRArm()
 /*! @brief Returns true if the script ueses the left leg */
 bool MotionScript::usesLLeg()
 {
+    loadOnFirstUse();
     return m_uses_lleg;
 }
 
 /*! @brief Returns the time the script finishes with the left leg */
 double MotionScript::timeFinishedWithLLeg()
 {
+    loadOnFirstUse();
     if (not m_uses_lleg)
         return 0;
     else
@@ -128,12 +164,14 @@ double MotionScript::timeFinishedWithLLeg()
 /*! @brief Returns true if script uses the right leg */
 bool MotionScript::usesRLeg()
 {
+    loadOnFirstUse();
     return m_uses_rleg;
 }
 
 /*! @brief Returns the time the script finishes with the right leg */
 double MotionScript::timeFinishedWithRLeg()
 {
+    loadOnFirstUse();
     if (not m_uses_rleg)
         return 0;
     else
@@ -154,6 +192,7 @@ void MotionScript::setPlaySpeed(float speed)
 
 void MotionScript::play(NUSensorsData* data, NUActionatorsData* actions)
 {
+    loadOnFirstUse();
     if (not m_is_valid)
         return;
     
@@ -196,80 +235,46 @@ void MotionScript::play(NUSensorsData* data, NUActionatorsData* actions)
     #endif
 }
 
+/*! @brief Loads the script from the precompiled .nums file, or from the text .num file if the .nums file is
+           missing, invalid or older than the text file.
+    @return true if the script was loaded without error
+ */
 bool MotionScript::load()
 {
-    ifstream file((CONFIG_DIR + "Motion/Scripts/" + m_name + ".num").c_str());
-    if (!file.is_open())
+    string path = CONFIG_DIR + "Motion/Scripts/" + m_name;
+    MotionScriptFile file;
+    if (not MotionScriptFile::isUpToDate(path + ".num", path + ".nums") or not file.load(path + ".nums"))
     {
-        errorlog << "MotionScript::load(). Unable to open " << m_name << endl;
-        return false;
-    }
-    else
-    {
-        m_smoothness = MotionFileTools::toFloat(file);
-        m_return_to_start = MotionFileTools::toBool(file);
-        m_labels = MotionFileTools::toStringVector(file);
-        if (m_labels.empty())
+        #if DEBUG_NUMOTION_VERBOSITY > 0
+            debug << "MotionScript::load(). Parsing " << m_name << ".num because there is no up to date " << m_name << ".nums" << endl;
+        #endif
+        if (not file.loadText(path + ".num") or not file.validate())
         {
-            errorlog << "MotionScript::load(). Unable to load " << m_name << " the file labels are invalid " << endl;
+            errorlog << "MotionScript::load(). Unable to load " << m_name << ": " << file.getError() << endl;
             return false;
         }
-        m_playspeed = 1.0;
-        
-        size_t numjoints = m_labels.size() - 1;
-        m_times = vector<vector<double> >(numjoints, vector<double>());
-        m_positions = vector<vector<float> >(numjoints, vector<float>());
-        m_gains = vector<vector<float> >(numjoints, vector<float>());
-        
-        float time;
-        vector<vector<float> > row;
-        
-        while (!file.eof())
+    }
+
+    m_smoothness = file.Smoothness;
+    m_return_to_start = file.ReturnToStart;
+    m_labels.swap(file.Labels);
+    m_times.swap(file.Times);
+    m_positions.swap(file.Positions);
+    m_gains.swap(file.Gains);
+
+    if (m_return_to_start)
+    {   // Now a bit of hackery. When we want to return to start we need to add the placeholders for the return move
+        for (size_t i=0; i<m_times.size(); i++)
         {
-            MotionFileTools::toFloatWithMatrix(file, time, row);
-            if (row.size() >= numjoints)
-            {   // discard rows that don't have enough joints
-                for (size_t i=0; i<numjoints; i++)
-                {
-                    if (row[i].size() > 0)
-                    {   // if there is an entry then the first must be a position
-                        m_times[i].push_back(1000*time);
-                        m_positions[i].push_back(row[i][0]);
-                        
-                        // because the way the joint actionators are designed we must also specify a gain
-                        if (row[i].size() > 1)
-                        {   // if there is a second entry then it is the gain
-                            m_gains[i].push_back(row[i][1]);
-                        }
-                        else
-                        {   // however if there is no second entry we reuse the previous entry or use 100% if this is the first one
-                            if (m_gains[i].empty())
-                                m_gains[i].push_back(100.0);
-                            else
-                                m_gains[i].push_back(m_gains[i].back());
-                        }
-                        
-                    }
-                }
-            }
-            row.clear();
-        }
-        file.close();
-        
-        if (m_return_to_start)
-        {   // Now a bit of hackery. When we want to return to start we need to add the placeholders for the return move
-            for (size_t i=0; i<m_times.size(); i++)
-            {
-                if (not m_times[i].empty())
-                {   // only add the placeholders if the joint is non empty
-                    m_times[i].push_back(m_times[i].back());
-                    m_positions[i].push_back(m_positions[i].back());
-                    m_gains[i].push_back(m_gains[i].back());
-                }
+            if (not m_times[i].empty())
+            {   // only add the placeholders if the joint is non empty
+                m_times[i].push_back(m_times[i].back());
+                m_positions[i].push_back(m_positions[i].back());
+                m_gains[i].push_back(m_gains[i].back());
             }
         }
-        return true;
     }
+    return true;
 }
 
 /*! @brief Sets all of the variables to keep track of when a script requires each limb.
@@ -11,6 +11,8 @@
            interpolation of the hardware layer is used.
         3. Joints that have no entries in the .num file can be used by other modules/scripts
         4. The play speed can be specified online with setPlaySpeed
+        5. The script is loaded when it is first used, from the precompiled .nums file if there
+           is an up to date one (see MotionScriptFile)
  
     TODO:
         1. 'Conditions'. In particular premature exit of the script
@@ -52,6 +54,7 @@ public:
     
     void play(NUSensorsData* data, NUActionatorsData* actions);
     void setPlaySpeed(float speed);
+    void preload();
     
     string& getName();
     
@@ -72,6 +75,7 @@ public:
     friend istream& operator>> (istream& input, MotionScript& p_script);
     friend istream& operator>> (istream& input, MotionScript* p_script);
 protected:
+    void loadOnFirstUse();
     bool load();
     void setUses();
     bool checkIfUses(const vector<int>& ids);
@@ -82,6 +86,7 @@ protected:
     void appendReturnLimbToStart(const vector<int>& ids, vector<vector<double> >& times, vector<vector<float> >& positions, const vector<float>& sensorpositions);
 protected:
     string m_name;                      		//!< the name of the script
+    bool m_is_loaded;                   		//!< true if the script has been loaded, or there is nothing to load
     bool m_is_valid;                    		//!< true if the motion script file was loaded without error
     
     // a bunch of variables to keep track of when a script uses each limb
@@ -0,0 +1,332 @@
+/*! @file MotionScriptFile.cpp
+    @brief Implementation of the text and precompiled binary motion script files
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "MotionScriptFile.h"
+#include "MotionFileTools.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+using namespace std;
+
+static const char MOTION_SCRIPT_MAGIC[4] = {'N','U','M','S'};      //!< the first four bytes of a .nums file
+static const unsigned int MOTION_SCRIPT_HEADER_SIZE = 16;           //!< magic, version, flags, smoothness and number of labels
+static const unsigned short MOTION_SCRIPT_RETURN_TO_START = 1;      //!< the flag set when the script returns to the start
+
+/*! @brief Reads the values of a .nums file in order, and checks that they are all inside the file */
+class MotionScriptReader
+{
+public:
+    MotionScriptReader(const unsigned char* data, unsigned int length) : m_data(data), m_length(length), m_offset(0) {}
+    /*! @brief Reads count values into destination, returns false if there are not that many left */
+    template<typename T> bool read(T* destination, unsigned int count)
+    {
+        if (count > (m_length - m_offset)/sizeof(T))
+            return false;
+        memcpy(destination, m_data + m_offset, count*sizeof(T));
+        m_offset += count*sizeof(T);
+        return true;
+    }
+    /*! @brief Reads length characters into destination, returns false if there are not that many left */
+    bool read(string& destination, unsigned int length)
+    {
+        if (length > m_length - m_offset)
+            return false;
+        destination.assign(reinterpret_cast<const char*>(m_data + m_offset), length);
+        m_offset += length;
+        return true;
+    }
+    /*! @brief Returns true if the whole file has been read */
+    bool finished() const {return m_offset == m_length;}
+private:
+    const unsigned char* m_data;
+    unsigned int m_length;
+    unsigned int m_offset;
+};
+
+MotionScriptFile::MotionScriptFile()
+{
+    Smoothness = 0;
+    ReturnToStart = false;
+}
+
+/*! @brief Loads the script from a text .num file. The file is not validated; use validate() for that.
+    @param filename the full path to the .num file
+    @return true if the file was read
+ */
+bool MotionScriptFile::loadText(const string& filename)
+{
+    ifstream file(filename.c_str());
+    if (not file.is_open())
+        return fail("unable to open " + filename);
+
+    Smoothness = MotionFileTools::toFloat(file);
+    ReturnToStart = MotionFileTools::toBool(file);
+    Labels = MotionFileTools::toStringVector(file);
+    if (Labels.empty())
+        return fail("the labels of " + filename + " are invalid");
+
+    size_t numjoints = Labels.size() - 1;
+    Times = vector<vector<double> >(numjoints, vector<double>());
+    Positions = vector<vector<float> >(numjoints, vector<float>());
+    Gains = vector<vector<float> >(numjoints, vector<float>());
+
+    float time;
+    vector<vector<float> > row;
+    while (!file.eof())
+    {
+        MotionFileTools::toFloatWithMatrix(file, time, row);
+        if (row.size() >= numjoints)
+        {   // discard rows that don't have enough joints
+            for (size_t i=0; i<numjoints; i++)
+            {
+                if (row[i].size() > 0)
+                {   // if there is an entry then the first must be a position
+                    Times[i].push_back(1000*time);
+                    Positions[i].push_back(row[i][0]);
+
+                    // because the way the joint actionators are designed we must also specify a gain
+                    if (row[i].size() > 1)
+                    {   // if there is a second entry then it is the gain
+                        Gains[i].push_back(row[i][1]);
+                    }
+                    else
+                    {   // however if there is no second entry we reuse the previous entry or use 100% if this is the first one
+                        if (Gains[i].empty())
+                            Gains[i].push_back(100.0);
+                        else
+                            Gains[i].push_back(Gains[i].back());
+                    }
+                }
+            }
+        }
+        row.clear();
+    }
+    return true;
+}
+
+/*! @brief Loads the script from a precompiled .nums file. Where possible the file is memory mapped rather than read.
+    @param filename the full path to the .nums file
+    @return true if the file was a valid .nums file
+ */
+bool MotionScriptFile::load(const string& filename)
+{
+    #ifndef _WIN32
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            return fail("unable to open " + filename);
+        struct stat info;
+        if (fstat(fd, &info) != 0 or info.st_size < static_cast<off_t>(MOTION_SCRIPT_HEADER_SIZE))
+        {
+            close(fd);
+            return fail(filename + " is too short");
+        }
+        void* mapping = mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED)
+            return fail("unable to map " + filename);
+        bool ok = parse(static_cast<const unsigned char*>(mapping), info.st_size);
+        munmap(mapping, info.st_size);
+    #else
+        ifstream file(filename.c_str(), ios::in | ios::binary);
+        if (not file.is_open())
+            return fail("unable to open " + filename);
+        file.seekg(0, ios::end);
+        unsigned int length = file.tellg();
+        file.seekg(0, ios::beg);
+        if (length < MOTION_SCRIPT_HEADER_SIZE)
+            return fail(filename + " is too short");
+        vector<unsigned char> buffer(length);
+        file.read(reinterpret_cast<char*>(&buffer[0]), length);
+        bool ok = file.good() and parse(&buffer[0], length);
+    #endif
+    if (not ok)
+        return fail(filename + " is not a valid motion script: " + m_error);
+    return true;
+}
+
+/*! @brief Reads the script out of the contents of a .nums file
+    @param data the contents of the file
+    @param length the length of the file in bytes
+    @return true if the contents were a complete, valid script
+ */
+bool MotionScriptFile::parse(const unsigned char* data, unsigned int length)
+{
+    MotionScriptReader reader(data, length);
+    char magic[sizeof(MOTION_SCRIPT_MAGIC)];
+    unsigned short version, flags;
+    unsigned int numlabels;
+    if (not (reader.read(magic, sizeof(magic)) and reader.read(&version, 1) and reader.read(&flags, 1) and reader.read(&Smoothness, 1) and reader.read(&numlabels, 1)))
+        return fail("the header is truncated");
+    if (memcmp(magic, MOTION_SCRIPT_MAGIC, sizeof(MOTION_SCRIPT_MAGIC)) != 0)
+        return fail("the header is invalid");
+    if (version != Version)
+        return fail("the version is not supported");
+    ReturnToStart = flags & MOTION_SCRIPT_RETURN_TO_START;
+
+    // each label is at least two bytes long, which bounds numlabels before anything is allocated
+    if (numlabels == 0 or numlabels > (length - MOTION_SCRIPT_HEADER_SIZE)/sizeof(unsigned short))
+        return fail("the number of labels is invalid");
+    Labels = vector<string>(numlabels);
+    for (unsigned int i=0; i<numlabels; i++)
+    {
+        unsigned short labellength;
+        if (not reader.read(&labellength, 1) or not reader.read(Labels[i], labellength))
+            return fail("the labels are truncated");
+    }
+
+    size_t numjoints = numlabels - 1;
+    Times = vector<vector<double> >(numjoints, vector<double>());
+    Positions = vector<vector<float> >(numjoints, vector<float>());
+    Gains = vector<vector<float> >(numjoints, vector<float>());
+    for (size_t i=0; i<numjoints; i++)
+    {
+        unsigned int numpoints;
+        if (not reader.read(&numpoints, 1) or numpoints > length/(3*sizeof(float)))
+            return fail("the joints are truncated");
+        m_buffer.resize(numpoints);
+        Positions[i].resize(numpoints);
+        Gains[i].resize(numpoints);
+        if (numpoints > 0 and not (reader.read(&m_buffer[0], numpoints) and reader.read(&Positions[i][0], numpoints) and reader.read(&Gains[i][0], numpoints)))
+            return fail("the joints are truncated");
+        Times[i].assign(m_buffer.begin(), m_buffer.end());
+    }
+    if (not reader.finished())
+        return fail("there is data after the last joint");
+    return validate();
+}
+
+/*! @brief Saves the script to a .nums file
+    @param filename the full path to the .nums file
+    @return true if the file was written
+ */
+bool MotionScriptFile::save(const string& filename) const
+{
+    ofstream file(filename.c_str(), ios::out | ios::binary);
+    if (not file.is_open())
+        return fail("unable to open " + filename);
+
+    unsigned short version = Version;
+    unsigned short flags = ReturnToStart ? MOTION_SCRIPT_RETURN_TO_START : 0;
+    unsigned int numlabels = Labels.size();
+    file.write(MOTION_SCRIPT_MAGIC, sizeof(MOTION_SCRIPT_MAGIC));
+    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    file.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
+    file.write(reinterpret_cast<const char*>(&Smoothness), sizeof(Smoothness));
+    file.write(reinterpret_cast<const char*>(&numlabels), sizeof(numlabels));
+    for (size_t i=0; i<Labels.size(); i++)
+    {
+        unsigned short labellength = Labels[i].size();
+        file.write(reinterpret_cast<const char*>(&labellength), sizeof(labellength));
+        file.write(Labels[i].data(), labellength);
+    }
+    for (size_t i=0; i<Times.size(); i++)
+    {
+        unsigned int numpoints = Times[i].size();
+        file.write(reinterpret_cast<const char*>(&numpoints), sizeof(numpoints));
+        if (numpoints > 0)
+        {
+            m_buffer.assign(Times[i].begin(), Times[i].end());
+            file.write(reinterpret_cast<const char*>(&m_buffer[0]), numpoints*sizeof(float));
+            file.write(reinterpret_cast<const char*>(&Positions[i][0]), numpoints*sizeof(float));
+            file.write(reinterpret_cast<const char*>(&Gains[i][0]), numpoints*sizeof(float));
+        }
+    }
+    if (not file.good())
+        return fail("unable to write " + filename);
+    return true;
+}
+
+/*! @brief Checks that the script can be played: every joint has a time, position and gain for each point,
+           the times of each joint do not go backwards, and every value is a number.
+    @return true if the script is valid
+ */
+bool MotionScriptFile::validate()
+{
+    if (Labels.empty() or Labels.size() > 0xFFFF)
+        return fail("the number of labels is invalid");
+    if (isnan(Smoothness) or isinf(Smoothness))
+        return fail("the smoothness is not a number");
+
+    size_t numjoints = Labels.size() - 1;
+    if (Times.size() != numjoints or Positions.size() != numjoints or Gains.size() != numjoints)
+        return fail("the number of joints does not match the labels");
+    for (size_t i=0; i<numjoints; i++)
+    {
+        if (Labels[i+1].size() > 0xFFFF)
+            return fail("the label of " + Labels[i+1] + " is too long");
+        if (Positions[i].size() != Times[i].size() or Gains[i].size() != Times[i].size())
+            return fail(Labels[i+1] + " does not have a time, position and gain for every point");
+        for (size_t j=0; j<Times[i].size(); j++)
+        {
+            if (isnan(Times[i][j]) or isinf(Times[i][j]) or isnan(Positions[i][j]) or isinf(Positions[i][j]) or isnan(Gains[i][j]) or isinf(Gains[i][j]))
+                return fail(Labels[i+1] + " has a value that is not a number");
+            if (j > 0 and Times[i][j] < Times[i][j-1])
+                return fail(Labels[i+1] + " has times that go backwards");
+        }
+    }
+    return true;
+}
+
+/*! @brief Compiles a text .num file into a .nums file
+    @param textfilename the full path to the .num file
+    @param binaryfilename the full path to the .nums file to write
+    @return true if the text file was valid and the .nums file was written
+ */
+bool MotionScriptFile::compile(const string& textfilename, const string& binaryfilename)
+{
+    return loadText(textfilename) and validate() and save(binaryfilename);
+}
+
+/*! @brief Returns true if the .nums file exists and is at least as new as the .num file it was compiled from.
+           The text file is allowed to be missing, so that only the .nums files need to be sent to a robot.
+    @param textfilename the full path to the .num file
+    @param binaryfilename the full path to the .nums file
+ */
+bool MotionScriptFile::isUpToDate(const string& textfilename, const string& binaryfilename)
+{
+    #ifndef _WIN32
+        struct stat binaryinfo, textinfo;
+        if (stat(binaryfilename.c_str(), &binaryinfo) != 0)
+            return false;
+        return stat(textfilename.c_str(), &textinfo) != 0 or binaryinfo.st_mtime >= textinfo.st_mtime;
+    #else
+        return ifstream(binaryfilename.c_str()).is_open();
+    #endif
+}
+
+/*! @brief Records the reason an operation failed
+    @param error the reason
+    @return false, so that failures can be returned directly
+ */
+bool MotionScriptFile::fail(const string& error) const
+{
+    m_error = error;
+    return false;
+}
+
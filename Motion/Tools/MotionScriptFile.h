@@ -0,0 +1,77 @@
+/*! @file MotionScriptFile.h
+    @brief Declaration of the text and precompiled binary motion script files
+
+    @class MotionScriptFile
+    @brief The contents of a motion script file, loaded from either the text .num file or the precompiled .nums file
+
+    The text .num file is the authoring format. Parsing it on the robot is slow, so the text files are compiled
+    offline (see Tools/MotionScriptCompiler) into .nums files. A .nums file holds exactly what the text parser
+    produces, after it has been validated, so loading one is only a few copies out of the mapped file.
+
+    The .nums file is the 16 byte header:
+        - "NUMS" (4 bytes), the version (2 bytes), the flags (2 bytes, bit 0 is return to start),
+        - the smoothness (float), the number of labels (unsigned int)
+    followed by each label as its length (unsigned short) and its characters, and then each joint as
+    its number of points (unsigned int), the times (float), the positions (float) and the gains (float). The
+    text parser reads the times as floats, so storing them as floats loses nothing.
+    Everything is in the byte order of the machine that compiled it, which is the same as the robots.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MOTIONSCRIPTFILE_H
+#define MOTIONSCRIPTFILE_H
+
+#include <string>
+#include <vector>
+using namespace std;
+
+class MotionScriptFile
+{
+public:
+    static const unsigned short Version = 1;                //!< the version of the .nums format written by save
+
+    MotionScriptFile();
+
+    bool loadText(const string& filename);
+    bool load(const string& filename);
+    bool save(const string& filename) const;
+    bool validate();
+
+    bool compile(const string& textfilename, const string& binaryfilename);
+    static bool isUpToDate(const string& textfilename, const string& binaryfilename);
+
+    /*! @brief Returns the error from the last load, save or validation that failed */
+    const string& getError() const {return m_error;}
+public:
+    float Smoothness;                                       //!< the smoothness of the motion curves
+    bool ReturnToStart;                                     //!< true if the script returns to the position it started from
+    vector<string> Labels;                                  //!< the labels for each column, the first is the time
+    vector<vector<double> > Times;                          //!< the times in ms of each point of each joint
+    vector<vector<float> > Positions;                       //!< the positions of each point of each joint
+    vector<vector<float> > Gains;                           //!< the gains of each point of each joint
+private:
+    bool parse(const unsigned char* data, unsigned int length);
+    bool fail(const string& error) const;
+private:
+    mutable string m_error;                                 //!< the reason the last operation failed
+    mutable vector<float> m_buffer;                         //!< the times of a joint, as they are stored in the file
+};
+
+#endif
+
@@ -0,0 +1,84 @@
+/*! @file FixedObserver.cpp
+    @brief Implementation of a statically dimensioned version of the Northern Bites' preview controller
+
+    @author Jason Kulk
+ 
+ Copyright (c) 2011 Jason Kulk
+ 
+ This file is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This file is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FixedObserver.h"
+using namespace std;
+
+/*! @brief Constructs a FixedObserver, copying the Observer's gains into contiguous member arrays */
+FixedObserver::FixedObserver() : WalkController()
+{
+    for (unsigned int i=0; i<3; i++)
+    {
+        m_state[i] = 0;
+        for (unsigned int j=0; j<3; j++)
+            m_A[i][j] = Observer::A_values[3*i + j];
+        m_b[i] = Observer::b_values[i];
+        m_c[i] = Observer::c_values[i];
+        m_L[i] = Observer::L_values[i];
+    }
+    for (unsigned int i=0; i<NUM_PREVIEW_FRAMES; i++)
+        m_weights[i] = Observer::weights[i];
+    m_Gi = Observer::Gi;
+    m_tracking_error = 0;
+}
+
+/*! @brief Calculates the next state of the controller given the previewable zmp reference
+    @param zmp_ref the queue of future zmp references. It must contain at least NUM_PREVIEW_FRAMES values
+    @param cur_zmp_ref the current zmp reference
+    @param sensor_zmp the measured zmp
+    @return the new CoM position
+ */
+float FixedObserver::tick(const list<float>* zmp_ref, const float cur_zmp_ref, const float sensor_zmp)
+{
+    float preview_control = 0;
+    list<float>::const_iterator it = zmp_ref->begin();
+    for (unsigned int i=0; i<NUM_PREVIEW_FRAMES; ++i, ++it)
+        preview_control += m_weights[i]*(*it);
+    
+    const float output = m_c[0]*m_state[0] + m_c[1]*m_state[1] + m_c[2]*m_state[2];
+    m_tracking_error += output - cur_zmp_ref;
+    
+    const float control = -m_Gi*m_tracking_error - preview_control;
+    const float innovation = sensor_zmp - output;
+    
+    float next[3];
+    for (unsigned int i=0; i<3; i++)
+        next[i] = m_A[i][0]*m_state[0] + m_A[i][1]*m_state[1] + m_A[i][2]*m_state[2] - m_L[i]*innovation + m_b[i]*control;
+    
+    m_state[0] = next[0];
+    m_state[1] = next[1];
+    m_state[2] = next[2];
+    return getPosition();
+}
+
+/*! @brief Initialises the state of the controller. The tracking error is reset to zero.
+    @param x the CoM position
+    @param v the CoM velocity
+    @param p the zmp
+ */
+void FixedObserver::initState(float x, float v, float p)
+{
+    m_state[0] = x;
+    m_state[1] = v;
+    m_state[2] = p;
+    m_tracking_error = 0;
+}
+
@@ -0,0 +1,66 @@
+/*! @file FixedObserver.h
+    @brief Declaration of a statically dimensioned version of the Northern Bites' preview controller
+ 
+    @class FixedObserver
+    @brief A drop in replacement for Observer that does not use boost::ublas.
+ 
+    The Observer implements the 1D preview controller of Kajita and Czarnetzki using dynamically
+    sized ublas expressions; every motion tick that builds and destroys temporaries and goes through
+    ublas' generic loops. This class runs exactly the same controller, with the same octave generated
+    gains, but the state, system matrix and gains are stored in plain fixed size arrays which are
+    filled once in the constructor, and the update is written out by hand.
+ 
+    Like the Observer you need one instance for the x and one for the y direction.
+ 
+    @author Jason Kulk
+ 
+  Copyright (c) 2011 Jason Kulk
+ 
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FIXEDOBSERVER_H
+#define FIXEDOBSERVER_H
+
+#include "WalkController.h"
+#include "Observer.h"
+
+#include <list>
+
+class FixedObserver : public WalkController
+{
+public:
+    FixedObserver();
+    virtual ~FixedObserver() {};
+    virtual float tick(const std::list<float>* zmp_ref, const float cur_zmp_ref, const float sensor_zmp);
+    virtual float getPosition() const {return m_state[0];};
+    virtual float getZMP() const {return m_state[2];};
+    
+    virtual void initState(float x, float v, float p);
+public:
+    static const unsigned int NUM_PREVIEW_FRAMES = Observer::NUM_PREVIEW_FRAMES;
+private:
+    float m_state[3];                           //!< the state vector [position, velocity, zmp]
+    float m_tracking_error;                     //!< the integrated zmp tracking error
+    
+    float m_weights[NUM_PREVIEW_FRAMES];        //!< the preview gains, in the order they are applied to the zmp_ref queue
+    float m_A[3][3];                            //!< the time invariant system matrix
+    float m_b[3];                               //!< the control input vector
+    float m_c[3];                               //!< the output row vector
+    float m_L[3];                               //!< the observer gain
+    float m_Gi;                                 //!< the integral gain
+};
+
+#endif
+
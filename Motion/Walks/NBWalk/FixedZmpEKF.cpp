@@ -0,0 +1,80 @@
+/*! @file FixedZmpEKF.cpp
+    @brief Implementation of a statically dimensioned version of the Northern Bites' sensor zmp filter
+
+    @author Jason Kulk
+ 
+ Copyright (c) 2011 Jason Kulk
+ 
+ This file is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This file is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FixedZmpEKF.h"
+#include "NBInclude/BasicWorldConstants.h"
+#include "NBInclude/Kinematics.h"
+
+#include <cmath>
+
+// these are the same constants as used in ZmpEKF
+const float FixedZmpEKF::m_beta = 0.1f;
+const float FixedZmpEKF::m_gamma = 0.5f;
+const float FixedZmpEKF::m_com_height = 310;
+
+/*! @brief Constructs a FixedZmpEKF in the same state as a freshly constructed ZmpEKF */
+FixedZmpEKF::FixedZmpEKF()
+{
+    reset();
+}
+
+/*! @brief Resets the filter to its initial state */
+void FixedZmpEKF::reset()
+{
+    m_x[0] = 0;
+    m_x[1] = 0;
+    m_P[0] = Kinematics::HIP_OFFSET_Y;
+    m_P[1] = Kinematics::HIP_OFFSET_Y;
+}
+
+/*! @brief Advances the filter to the next state
+    @param tUp the a priori zmp from the controller
+    @param zMeasure the com and acceleration measurement
+ */
+void FixedZmpEKF::update(const ZmpTimeUpdate& tUp, const ZmpMeasurement& zMeasure)
+{
+    const float zheight_div_G = m_com_height/GRAVITY_mss;
+    updateDimension(0, tUp.cur_zmp_x, zMeasure.comX + zheight_div_G*zMeasure.accX);
+    updateDimension(1, tUp.cur_zmp_y, zMeasure.comY + zheight_div_G*zMeasure.accY);
+}
+
+/*! @brief Runs the time update and correction for a single direction.
+ 
+    Note that, exactly as in ZmpEKF, the divergence of the measurement is computed against the
+    a posteriori estimate from the previous tick, rather than the a priori estimate.
+ 
+    @param i the index of the direction (0 for x, 1 for y)
+    @param prediction the a priori estimate of the zmp
+    @param measurement the measured zmp
+ */
+void FixedZmpEKF::updateDimension(unsigned int i, float prediction, float measurement)
+{
+    const float delta = prediction - m_x[i];
+    const float P_bar = m_P[i] + m_beta + m_gamma*delta*delta;
+    
+    const float divergence = measurement - m_x[i];
+    const float R = 0.5f + 1.5f*std::fabs(divergence);
+    const float K = P_bar/(P_bar + R);
+    
+    m_x[i] = prediction + K*divergence;
+    m_P[i] = (1 - K)*P_bar;
+}
+
@@ -0,0 +1,62 @@
+/*! @file FixedZmpEKF.h
+    @brief Declaration of a statically dimensioned version of the Northern Bites' sensor zmp filter
+ 
+    @class FixedZmpEKF
+    @brief A drop in replacement for ZmpEKF that does not use boost::ublas.
+ 
+    The ZmpEKF runs through the generic EKF template, which builds ublas matrices, inverts a 2x2 and
+    forms several matrix products every motion tick. However, for the zmp filter the update model
+    and the observation jacobian are both the identity, and the process and measurement noise are
+    diagonal, so starting from a diagonal covariance the x and y directions never couple. This class
+    exploits that, and runs the filter as two independent scalar kalman filters. The estimates are
+    the same as the ZmpEKF's up to floating point rounding.
+ 
+    @author Jason Kulk
+ 
+  Copyright (c) 2011 Jason Kulk
+ 
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FIXEDZMPEKF_H
+#define FIXEDZMPEKF_H
+
+#include "NBInclude/EKFStructs.h"
+
+class FixedZmpEKF
+{
+public:
+    FixedZmpEKF();
+    ~FixedZmpEKF() {};
+    
+    void reset();
+    void update(const ZmpTimeUpdate& tUp, const ZmpMeasurement& zMeasure);
+    
+    float get_zmp_x() const {return m_x[0];};
+    float get_zmp_y() const {return m_x[1];};
+    float get_zmp_unc_x() const {return m_P[0];};
+    float get_zmp_unc_y() const {return m_P[1];};
+private:
+    void updateDimension(unsigned int i, float prediction, float measurement);
+private:
+    float m_x[2];                       //!< the zmp estimate [x, y]
+    float m_P[2];                       //!< the diagonal of the estimate's covariance
+    
+    static const float m_beta;          //!< the constant uncertainty growth
+    static const float m_gamma;         //!< the scaled uncertainty growth
+    static const float m_com_height;    //!< the height of the CoM used to convert accelerations into zmp
+};
+
+#endif
+
@@ -124,7 +124,7 @@ Observer::Observer()
  * Tick calculates the next state vector for the robot, given the zmp_ref
  *
  */
-const float Observer::tick(const list<float> *zmp_ref,
+float Observer::tick(const list<float> *zmp_ref,
                            const float cur_zmp_ref,
                            const float sensor_zmp) {
     float preview_control = 0.0f;
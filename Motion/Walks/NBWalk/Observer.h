@@ -51,11 +51,11 @@ class Observer : public WalkController {
 public:
     Observer();
     virtual ~Observer(){};
-    virtual const float tick(const std::list<float> *zmp_ref,
+    virtual float tick(const std::list<float> *zmp_ref,
                              const float cur_zmp_ref,
                              const float sensor_zmp);
-    virtual const float getPosition() const { return stateVector(0); }
-    virtual const float getZMP() const {return stateVector(2);}
+    virtual float getPosition() const { return stateVector(0); }
+    virtual float getZMP() const {return stateVector(2);}
 
     virtual void initState(float x, float v, float p);
 private:
@@ -73,6 +73,7 @@ public: //Constants
     #endif
     
 private:
+    friend class FixedObserver;             // shares the octave generated gains below
     static const float weights[NUM_AVAIL_PREVIEW_FRAMES];
     static const float A_values[9];
     static const float b_values[3];
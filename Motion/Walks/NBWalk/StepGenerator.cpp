@@ -28,6 +28,7 @@ using boost::shared_ptr;
 #include "StepGenerator.h"
 #include "NBInclude/NBMath.h"
 #include "Observer.h"
+#include "FixedObserver.h"
 #include "NBInclude/BasicWorldConstants.h"
 #include "NBInclude/COMKinematics.h"
 using namespace boost::numeric;
@@ -62,8 +63,13 @@ StepGenerator::StepGenerator(shared_ptr<Sensors> s, const MetaGait * _gait)
     rightLeg(s,gait,&sensorAngles,RLEG_CHAIN),
     leftArm(gait,LARM_CHAIN), rightArm(gait,RARM_CHAIN),
     supportFoot(LEFT_SUPPORT),
+#ifdef USE_FIXED_ZMP_CONTROLLER
+    controller_x(new FixedObserver()),
+    controller_y(new FixedObserver()),
+#else
     controller_x(new Observer()),
     controller_y(new Observer()),
+#endif
     zmp_filter(),
     acc_filter(),
     accInWorldFrame(CoordFrame4D::vector4D(0.0f,0.0f,0.0f))
@@ -80,7 +86,8 @@ StepGenerator::StepGenerator(shared_ptr<Sensors> s, const MetaGait * _gait)
 #endif
 #ifdef DEBUG_SENSOR_ZMP
     zmp_log = fopen("/var/volatile/zmp_log.csv","w");
-    fprintf(zmp_log,"time\tpre_x\tpre_y\tcom_x\tcom_y\tcom_px\tcom_py"
+    if (zmp_log)            // /var/volatile only exists on the robot
+        fprintf(zmp_log,"time\tpre_x\tpre_y\tcom_x\tcom_y\tcom_px\tcom_py"
             "\taccX\taccY\taccZ\t"
             "ekf_zmp_x\tekf_zmp_y\t"
             "angleX\tangleY\n");
@@ -97,10 +104,12 @@ StepGenerator::~StepGenerator()
     fclose(com_log);
 #endif
 #ifdef DEBUG_SENSOR_ZMP
-    fclose(zmp_log);
+    if (zmp_log)
+        fclose(zmp_log);
 #endif
 #ifdef DEBUG_ZMP_REF
-    fclose(zmp_ref_log);
+    if (zmp_ref_log)
+        fclose(zmp_ref_log);
 #endif
     delete controller_x; delete controller_y;
 }
@@ -728,7 +737,11 @@ void StepGenerator::resetSteps(const bool startLeft){
     controller_y->initState(0.0f,0.0f,0.0f);
 
     //Each time we restart, we need to reset the estimated sensor ZMP:
+#ifdef USE_FIXED_ZMP_CONTROLLER
+    zmp_filter.reset();
+#else
     zmp_filter = ZmpEKF();
+#endif
 
     sensorAngles.reset();
 
@@ -1205,7 +1218,8 @@ void StepGenerator::debugLogging(){
     const float accZ = accInWorldFrame(2);
     static float stime = 0;
 
-    fprintf(zmp_log,"%f\t%f\t%f\t%f\t%f\t%f\t%f\t%f\t%f\t%f\t%f\t%f\t%f\t%f\n",
+    if (zmp_log)
+        fprintf(zmp_log,"%f\t%f\t%f\t%f\t%f\t%f\t%f\t%f\t%f\t%f\t%f\t%f\t%f\t%f\n",
             stime,preX,preY,comX,comY,comPX,comPY,accX,accY,accZ,
 			zmp_filter.get_zmp_x(),zmp_filter.get_zmp_y(),
             acc.angleX,acc.angleY);
@@ -93,6 +93,7 @@
 #include "NBInclude/Sensors.h"
 #include "NBInclude/NBMatrixMath.h"
 #include "ZmpEKF.h"
+#include "FixedZmpEKF.h"
 #include "ZmpAccExp.h"
 
 //Debugging flags:
@@ -104,6 +105,9 @@
 // ZMP Preview Queue Debugging
 #define DEBUG_ZMP_REF
 
+// Use the fixed size controller and sensor zmp filter instead of the ublas based Observer and ZmpEKF
+#define USE_FIXED_ZMP_CONTROLLER
+
 typedef boost::tuple<const std::list<float>*,
                      const std::list<float>*> zmp_xy_tuple;
 typedef boost::tuple<LegJointStiffTuple,
@@ -232,7 +236,11 @@ private:
 
     WalkController *controller_x, *controller_y;
 
+#ifdef USE_FIXED_ZMP_CONTROLLER
+    FixedZmpEKF zmp_filter;
+#else
     ZmpEKF zmp_filter;
+#endif
 	ZmpAccExp acc_filter;
 
     NBMath::ufvector4 accInWorldFrame;
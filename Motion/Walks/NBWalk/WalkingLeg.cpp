@@ -414,7 +414,7 @@ WalkingLeg::getHipHack(const float footAngleZ){
         hack_chain = getOtherLegChainID();
     }else{
         // This step is double support, returning 0 hip hack
-        return 0.0f;
+        return boost::tuple<const float, const float>(0.0f, 0.0f);
     }
     const float support_sign = (state !=SWINGING? 1.0f : -1.0f);
     const float absFootAngle = std::abs(footAngleZ);
@@ -22,6 +22,9 @@
  * abstract EKF class.
  */
 
+#ifndef _ZmpEKF_h_DEFINED
+#define _ZmpEKF_h_DEFINED
+
 #include "NBInclude/EKF.h"
 #include "NBInclude/EKFStructs.h"
 
@@ -54,3 +57,5 @@ private: // Constants
     static const float beta;
     static const float gamma;
 };
+
+#endif
@@ -34,10 +34,12 @@ SET (YOUR_SRCS  NBWalk.cpp NBWalk.h
         WalkingLeg.cpp WalkingLeg.h
 	    WalkingArm.cpp WalkingArm.h
 		Observer.cpp Observer.h
+		FixedObserver.cpp FixedObserver.h
 		SensorAngles.cpp SensorAngles.h
 		SpringSensor.cpp SpringSensor.h
 		ZmpEKF.cpp ZmpEKF.h
         ZmpExp.cpp ZmpExp.h
+		FixedZmpEKF.cpp FixedZmpEKF.h
 		ZmpAccEKF.cpp ZmpAccEKF.h
 		ZmpAccExp.cpp ZmpAccExp.h
 )
@@ -33,7 +33,7 @@ using namespace std;
 /*! @brief Constructs the sound thread
  */
 
-NUSoundThread::NUSoundThread() : QueueThread<std::string>(string("NUSoundThread"), 0)
+NUSoundThread::NUSoundThread() : BoundedQueueThread<std::string>(string("NUSoundThread"), 0, 16)
 {
     #if DEBUG_NUACTIONATORS_VERBOSITY > 0
         debug << "NUSoundThread::NUSoundThread() with priority " << static_cast<int>(m_priority) << endl;
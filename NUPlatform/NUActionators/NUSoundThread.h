@@ -26,10 +26,10 @@
 #ifndef NUSOUND_THREAD_H
 #define NUSOUND_THREAD_H
 
-#include "Tools/Threading/QueueThread.h"
+#include "Tools/Threading/BoundedQueueThread.h"
 #include <string>
 
-class NUSoundThread : public QueueThread<std::string>
+class NUSoundThread : public BoundedQueueThread<std::string>
 {
 public:
     NUSoundThread();
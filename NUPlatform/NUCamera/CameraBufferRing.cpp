@@ -0,0 +1,252 @@
+/*! @file CameraBufferRing.cpp
+    @brief Implementation of a ring of camera driver buffers, and the reference counted CameraFrame handles into it
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CameraBufferRing.h"
+#include "Infrastructure/NUImage/NUImage.h"
+
+#include "debug.h"
+#include "debugverbositynucamera.h"
+
+using namespace std;
+
+vector<CameraBufferRing*> CameraBufferRing::m_rings;
+pthread_mutex_t CameraBufferRing::m_rings_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*! @brief Creates an empty handle */
+CameraFrame::CameraFrame() : m_ring(0), m_index(-1)
+{
+}
+
+/*! @brief Creates a handle to a buffer. The reference for this handle must already have been counted by the ring
+    @param ring the ring that owns the buffer
+    @param index the index of the buffer in the ring
+ */
+CameraFrame::CameraFrame(CameraBufferRing* ring, int index) : m_ring(ring), m_index(index)
+{
+}
+
+/*! @brief Creates another handle to the same buffer as other */
+CameraFrame::CameraFrame(const CameraFrame& other) : m_ring(other.m_ring), m_index(other.m_index)
+{
+    if (m_ring)
+        m_ring->addReference(m_index);
+}
+
+/*! @brief Releases the handle's reference to its buffer */
+CameraFrame::~CameraFrame()
+{
+    release();
+}
+
+/*! @brief Makes this handle refer to the same buffer as other, releasing the buffer it previously referred to */
+CameraFrame& CameraFrame::operator=(const CameraFrame& other)
+{
+    if (other.m_ring)
+        other.m_ring->addReference(other.m_index);
+    release();
+    m_ring = other.m_ring;
+    m_index = other.m_index;
+    return *this;
+}
+
+/*! @brief Returns true if the handle refers to a buffer */
+bool CameraFrame::isValid() const
+{
+    return m_ring != 0;
+}
+
+/*! @brief Returns the image mapped onto the buffer, or NULL if the handle is empty */
+NUImage* CameraFrame::image() const
+{
+    if (m_ring)
+        return m_ring->m_images[m_index];
+    else
+        return 0;
+}
+
+/*! @brief Returns the index of the buffer in its ring, or -1 if the handle is empty */
+int CameraFrame::index() const
+{
+    return m_index;
+}
+
+/*! @brief Releases the handle's reference to its buffer, leaving the handle empty */
+void CameraFrame::release()
+{
+    if (m_ring)
+        m_ring->removeReference(m_index);
+    m_ring = 0;
+    m_index = -1;
+}
+
+/*! @brief Creates an empty ring. The derived class needs to add its buffers with addBuffer()
+    @param width the width of each buffer in the form expected by NUImage::MapYUV422BufferToImage
+    @param height the height of each buffer in the form expected by NUImage::MapYUV422BufferToImage
+ */
+CameraBufferRing::CameraBufferRing(int width, int height) : m_width(width), m_height(height)
+{
+    #if DEBUG_NUCAMERA_VERBOSITY > 0
+        debug << "CameraBufferRing::CameraBufferRing(" << width << ", " << height << ")" << endl;
+    #endif
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_mutex_lock(&m_rings_mutex);
+    m_rings.push_back(this);
+    pthread_mutex_unlock(&m_rings_mutex);
+}
+
+/*! @brief Destroys the ring. There should be no CameraFrames left referring to it */
+CameraBufferRing::~CameraBufferRing()
+{
+    pthread_mutex_lock(&m_rings_mutex);
+    for (size_t i = 0; i < m_rings.size(); i++)
+    {
+        if (m_rings[i] == this)
+        {
+            m_rings.erase(m_rings.begin() + i);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&m_rings_mutex);
+
+    for (size_t i = 0; i < m_images.size(); i++)
+    {
+        if (m_references[i] > 0)
+            errorlog << "CameraBufferRing::~CameraBufferRing(). Buffer " << i << " is still referenced by " << m_references[i] << " frames." << endl;
+        delete m_images[i];
+    }
+    pthread_mutex_destroy(&m_mutex);
+}
+
+/*! @brief Takes the next filled buffer from the device
+    @return a handle to the buffer. The handle is empty if the device did not have a filled buffer
+ */
+CameraFrame CameraBufferRing::acquire()
+{
+    int index = dequeueBuffer();
+    if (index < 0 or index >= static_cast<int>(m_images.size()))
+        return CameraFrame();
+
+    pthread_mutex_lock(&m_mutex);
+    m_references[index] = 1;
+    pthread_mutex_unlock(&m_mutex);
+    return CameraFrame(this, index);
+}
+
+/*! @brief Returns another handle to the frame whose image is the given image.
+
+    This lets code that was only given an NUImage* keep the underlying buffer out of the driver's hands
+    for as long as it needs it.
+
+    @param image the image
+    @return a handle to the frame, or an empty handle if the image is not currently held in any ring
+ */
+CameraFrame CameraBufferRing::hold(const NUImage* image)
+{
+    CameraFrame frame;
+    if (image == 0)
+        return frame;
+
+    pthread_mutex_lock(&m_rings_mutex);
+    for (size_t i = 0; i < m_rings.size() and not frame.isValid(); i++)
+        frame = m_rings[i]->find(image);
+    pthread_mutex_unlock(&m_rings_mutex);
+    return frame;
+}
+
+/*! @brief Returns the number of buffers in the ring */
+int CameraBufferRing::size() const
+{
+    return m_images.size();
+}
+
+/*! @brief Returns the number of buffers that are not currently referenced by any CameraFrame */
+int CameraBufferRing::available()
+{
+    int count = 0;
+    pthread_mutex_lock(&m_mutex);
+    for (size_t i = 0; i < m_references.size(); i++)
+    {
+        if (m_references[i] == 0)
+            count++;
+    }
+    pthread_mutex_unlock(&m_mutex);
+    return count;
+}
+
+/*! @brief Adds a buffer to the ring, and maps an image onto it
+    @param data the buffer, which must remain valid for the lifetime of the ring
+    @return the index of the buffer in the ring
+ */
+int CameraBufferRing::addBuffer(unsigned char* data)
+{
+    NUImage* image = new NUImage();
+    image->MapYUV422BufferToImage(data, m_width, m_height);
+    m_buffers.push_back(data);
+    m_images.push_back(image);
+    m_references.push_back(0);
+    return m_images.size() - 1;
+}
+
+/*! @brief Returns the memory of the buffer with the given index */
+unsigned char* CameraBufferRing::getBuffer(int index) const
+{
+    return m_buffers[index];
+}
+
+/*! @brief Adds a reference to the buffer with the given index */
+void CameraBufferRing::addReference(int index)
+{
+    pthread_mutex_lock(&m_mutex);
+    m_references[index]++;
+    pthread_mutex_unlock(&m_mutex);
+}
+
+/*! @brief Removes a reference to the buffer with the given index. The buffer is returned to the device when the last reference is removed */
+void CameraBufferRing::removeReference(int index)
+{
+    pthread_mutex_lock(&m_mutex);
+    bool released = --m_references[index] == 0;
+    pthread_mutex_unlock(&m_mutex);
+    if (released)
+        enqueueBuffer(index);
+}
+
+/*! @brief Returns a new handle to the held buffer whose image is the given image, or an empty handle if there is no such buffer */
+CameraFrame CameraBufferRing::find(const NUImage* image)
+{
+    int index = -1;
+    pthread_mutex_lock(&m_mutex);
+    for (size_t i = 0; i < m_images.size(); i++)
+    {
+        if (m_images[i] == image and m_references[i] > 0)
+        {
+            m_references[i]++;
+            index = i;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&m_mutex);
+    if (index < 0)
+        return CameraFrame();
+    else
+        return CameraFrame(this, index);
+}
+
@@ -0,0 +1,107 @@
+/*! @file CameraBufferRing.h
+    @brief Declaration of a ring of camera driver buffers, and the reference counted CameraFrame handles into it
+
+    @class CameraBufferRing
+    @brief A ring of driver owned image buffers that are given out as reference counted CameraFrames.
+
+    Each buffer in the ring is mapped into its own NUImage once at startup, so handing a frame to another
+    part of the code base never copies the pixels. A buffer is only returned to the driver when the last
+    CameraFrame referencing it is released, so vision, image saving and streaming can all hold the same
+    frame for as long as they need it.
+
+    A derived class provides the actual device by implementing dequeueBuffer() and enqueueBuffer(), and by
+    registering each of its buffers with addBuffer().
+
+    @class CameraFrame
+    @brief A reference counted handle to a single buffer in a CameraBufferRing
+
+    Copying a CameraFrame adds a reference to the underlying buffer, destroying one removes it. The NUImage
+    returned by image() is valid for as long as the handle is.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CAMERABUFFERRING_H
+#define CAMERABUFFERRING_H
+
+class NUImage;
+class CameraBufferRing;
+
+#include <vector>
+#include <pthread.h>
+
+class CameraFrame
+{
+public:
+    CameraFrame();
+    CameraFrame(const CameraFrame& other);
+    ~CameraFrame();
+    CameraFrame& operator=(const CameraFrame& other);
+
+    bool isValid() const;
+    NUImage* image() const;
+    int index() const;
+    void release();
+private:
+    friend class CameraBufferRing;
+    CameraFrame(CameraBufferRing* ring, int index);
+private:
+    CameraBufferRing* m_ring;               //!< the ring that owns the buffer, or NULL if the handle is empty
+    int m_index;                            //!< the index of the buffer in the ring
+};
+
+class CameraBufferRing
+{
+public:
+    CameraBufferRing(int width, int height);
+    virtual ~CameraBufferRing();
+
+    CameraFrame acquire();
+    static CameraFrame hold(const NUImage* image);
+
+    int size() const;
+    int available();
+protected:
+    int addBuffer(unsigned char* data);
+    unsigned char* getBuffer(int index) const;
+
+    /*! @brief Takes a filled buffer from the device. This may block until one is available.
+        @return the index of the filled buffer, or -1 if no buffer could be taken */
+    virtual int dequeueBuffer() = 0;
+    /*! @brief Returns a buffer to the device so that it can be filled again
+        @param index the index of the buffer */
+    virtual void enqueueBuffer(int index) = 0;
+private:
+    friend class CameraFrame;
+    void addReference(int index);
+    void removeReference(int index);
+    CameraFrame find(const NUImage* image);
+private:
+    int m_width;                            //!< the width of each buffer passed to NUImage::MapYUV422BufferToImage
+    int m_height;                           //!< the height of each buffer passed to NUImage::MapYUV422BufferToImage
+    std::vector<unsigned char*> m_buffers;  //!< the driver buffers
+    std::vector<NUImage*> m_images;         //!< an image mapped onto each of the driver buffers
+    std::vector<int> m_references;          //!< the number of CameraFrames referencing each buffer
+    pthread_mutex_t m_mutex;                //!< lock for the reference counts
+
+    static std::vector<CameraBufferRing*> m_rings;     //!< all of the rings, used by hold()
+    static pthread_mutex_t m_rings_mutex;              //!< lock for m_rings
+};
+
+#endif
+
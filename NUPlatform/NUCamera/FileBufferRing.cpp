@@ -0,0 +1,114 @@
+/*! @file FileBufferRing.cpp
+    @brief Implementation of a camera buffer ring that is filled from a file of raw frames
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "FileBufferRing.h"
+
+#include "debug.h"
+#include "debugverbositynucamera.h"
+
+using namespace std;
+
+/*! @brief Creates a ring of buffers filled from the given file
+    @param filename the file of raw YUV422 frames
+    @param width the width of each frame in pixels
+    @param height the height of each frame in pixels
+    @param numbuffers the number of buffers in the ring
+ */
+FileBufferRing::FileBufferRing(const string& filename, int width, int height, int numbuffers) : CameraBufferRing(width, height)
+{
+    #if DEBUG_NUCAMERA_VERBOSITY > 0
+        debug << "FileBufferRing::FileBufferRing(" << filename << ", " << width << ", " << height << ", " << numbuffers << ")" << endl;
+    #endif
+    pthread_mutex_init(&m_queue_mutex, NULL);
+    m_file.open(filename.c_str(), ios_base::in | ios_base::binary);
+    if (not m_file.is_open())
+        errorlog << "FileBufferRing::FileBufferRing(). Unable to open " << filename << endl;
+
+    m_frame_size = width*height*2;
+    for (int i = 0; i < numbuffers; i++)
+    {
+        unsigned char* memory = new unsigned char[m_frame_size];
+        m_memory.push_back(memory);
+        m_queue.push_back(addBuffer(memory));
+    }
+}
+
+FileBufferRing::~FileBufferRing()
+{
+    for (size_t i = 0; i < m_memory.size(); i++)
+        delete [] m_memory[i];
+    pthread_mutex_destroy(&m_queue_mutex);
+}
+
+/*! @brief Returns true if the file of frames was opened successfully */
+bool FileBufferRing::isOpen() const
+{
+    return m_file.is_open();
+}
+
+/*! @brief Fills the oldest returned buffer with the next frame from the file
+    @return the index of the filled buffer, or -1 if every buffer is still held or there are no frames in the file
+ */
+int FileBufferRing::dequeueBuffer()
+{
+    pthread_mutex_lock(&m_queue_mutex);
+    int index = -1;
+    if (not m_queue.empty())
+    {
+        index = m_queue.front();
+        m_queue.pop_front();
+    }
+    pthread_mutex_unlock(&m_queue_mutex);
+
+    if (index >= 0 and not readFrame(getBuffer(index)))
+    {
+        enqueueBuffer(index);
+        index = -1;
+    }
+    return index;
+}
+
+/*! @brief Returns a buffer to the queue of buffers waiting to be filled */
+void FileBufferRing::enqueueBuffer(int index)
+{
+    pthread_mutex_lock(&m_queue_mutex);
+    m_queue.push_back(index);
+    pthread_mutex_unlock(&m_queue_mutex);
+}
+
+/*! @brief Reads the next frame from the file into the buffer, going back to the start of the file when the end is reached
+    @return true if a whole frame was read
+ */
+bool FileBufferRing::readFrame(unsigned char* buffer)
+{
+    if (not m_file.is_open())
+        return false;
+
+    m_file.read(reinterpret_cast<char*>(buffer), m_frame_size);
+    if (m_file.gcount() != m_frame_size)
+    {
+        m_file.clear();
+        m_file.seekg(0, ios_base::beg);
+        m_file.read(reinterpret_cast<char*>(buffer), m_frame_size);
+    }
+    return m_file.gcount() == m_frame_size;
+}
+
@@ -0,0 +1,61 @@
+/*! @file FileBufferRing.h
+    @brief Declaration of a camera buffer ring that is filled from a file of raw frames
+
+    @class FileBufferRing
+    @brief A fake camera device that fills a CameraBufferRing with raw YUV422 frames read from a file.
+
+    The file is a sequence of raw frames with no header, each one width*height*2 bytes, exactly as they
+    come out of the NAO's V4L2 driver. When the end of the file is reached the frames are repeated
+    from the start. Like a real driver, the ring only refills buffers that have been released by
+    every CameraFrame referencing them, so the reference counting can be exercised on a desktop.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FILEBUFFERRING_H
+#define FILEBUFFERRING_H
+
+#include "CameraBufferRing.h"
+
+#include <deque>
+#include <fstream>
+#include <string>
+#include <pthread.h>
+
+class FileBufferRing : public CameraBufferRing
+{
+public:
+    FileBufferRing(const std::string& filename, int width, int height, int numbuffers);
+    ~FileBufferRing();
+
+    bool isOpen() const;
+protected:
+    int dequeueBuffer();
+    void enqueueBuffer(int index);
+private:
+    bool readFrame(unsigned char* buffer);
+private:
+    std::ifstream m_file;               //!< the file of raw frames
+    int m_frame_size;                   //!< the size of each frame in bytes
+    std::vector<unsigned char*> m_memory;   //!< the memory for each of the buffers
+    std::deque<int> m_queue;            //!< the buffers waiting to be filled, in the order they were returned
+    pthread_mutex_t m_queue_mutex;      //!< lock for m_queue, which is added to by whichever thread releases the last frame
+};
+
+#endif
+
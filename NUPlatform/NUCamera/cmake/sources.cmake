@@ -22,6 +22,8 @@ ENDIF(DEBUG)
 ########## List your source files here! ############################################
 SET (YOUR_SRCS  
 CameraSettings.cpp
+CameraBufferRing.cpp CameraBufferRing.h
+FileBufferRing.cpp FileBufferRing.h
 )
 ####################################################################################
 ########## List your subdirectories here! ##########################################
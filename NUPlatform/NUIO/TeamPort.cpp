@@ -35,7 +35,7 @@
 TeamPort::TeamPort(TeamInformation* nubotteaminformation, int portnumber, bool ignoreself): UdpPort(std::string("TeamPort"), portnumber, ignoreself)
 {
     m_team_information = nubotteaminformation;
-    m_team_transmission_thread = new TeamTransmissionThread(this, 250);
+    m_team_transmission_thread = new TeamTransmissionThread(this, 100);
     
     m_team_transmission_thread->start();
 }
@@ -57,11 +57,11 @@ void TeamPort::handleNewData(std::stringstream& buffer)
         debug << "TeamPort::handleNewData()." << endl;
     #endif
     string s_buffer = buffer.str();
-    if (s_buffer.size() == sizeof(TeamPacket))
-    {   // discard team packets that are the wrong size
+    if (TeamPacketCodec::isTeamPacket(reinterpret_cast<const unsigned char*>(s_buffer.data()), s_buffer.size()))
+    {   // discard packets that are not team packets
         buffer >> m_team_information;
     }
     else
-        debug << "TeamPort::handleNewData(). The received packet does not have the correct length: " << s_buffer.size() << " instead of " << sizeof(TeamPacket) << endl;
+        debug << "TeamPort::handleNewData(). The received packet is not a team packet: " << s_buffer.size() << " bytes" << endl;
 }
 
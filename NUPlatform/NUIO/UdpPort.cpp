@@ -29,6 +29,7 @@
     #include <sys/ioctl.h>
     #include <netdb.h>
     #include <net/if.h>
+    #include <unistd.h>
 #endif
 #include <errno.h>
 #include <cstring>
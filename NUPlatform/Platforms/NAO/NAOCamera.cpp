@@ -20,6 +20,7 @@
  */
 
 #include "NAOCamera.h"
+#include "V4L2BufferRing.h"
 #include "NUPlatform/NUPlatform.h"
 #include "GTAssert.h"
 
@@ -145,7 +146,7 @@ std::string controlName(unsigned int id)
 }
 
 NAOCamera::NAOCamera() :
-currentBuf(0),
+m_ring(0),
 timeStamp(0),
 storedTimeStamp(Platform->getTime())
 {
@@ -183,6 +184,9 @@ storedTimeStamp(Platform->getTime())
 
     loadCameraOffset();
 
+    // map the driver's buffers
+    m_ring = new V4L2BufferRing(fd, frameBufferCount, WIDTH, HEIGHT);
+
     // enable streaming
     setStreaming(true);
 }
@@ -192,16 +196,15 @@ NAOCamera::~NAOCamera()
 #if DEBUG_NUCAMERA_VERBOSITY > 4
     debug << "NAOCamera::~NAOCamera()" << endl;
 #endif
-  // disable streaming
+  // return our frame and disable streaming
+  m_current_frame.release();
   setStreaming(false);
 
   // unmap buffers
-  for(int i = 0; i < frameBufferCount; ++i)
-    munmap(mem[i], memLength[i]);
+  delete m_ring;
   
   // close the device
   close(fd);
-  free(buf);
 }
 
 void NAOCamera::openCameraDevice(std::string device_name)
@@ -286,64 +289,6 @@ void NAOCamera::initialiseCamera()
     fps.parm.capture.timeperframe.numerator = 1;
     fps.parm.capture.timeperframe.denominator = 30;
     VERIFY(ioctl(fd, VIDIOC_S_PARM, &fps) != -1);
-
-    // request buffers
-    struct v4l2_requestbuffers rb;
-    memset(&rb, 0, sizeof(struct v4l2_requestbuffers));
-    rb.count = frameBufferCount;
-    rb.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    rb.memory = V4L2_MEMORY_MMAP;
-    VERIFY(ioctl(fd, VIDIOC_REQBUFS, &rb) != -1);
-
-    // map the buffers
-    buf = static_cast<struct v4l2_buffer*>(calloc(1, sizeof(struct v4l2_buffer)));
-    for(int i = 0; i < frameBufferCount; ++i)
-    {
-        buf->index = i;
-        buf->type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-        buf->memory = V4L2_MEMORY_MMAP;
-        VERIFY(ioctl(fd, VIDIOC_QUERYBUF, buf) != -1);
-        memLength[i] = buf->length;
-        mem[i] = mmap(0, buf->length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, buf->m.offset);
-        ASSERT(mem[i] != MAP_FAILED);
-    }
-
-    // queue the buffers
-    for(int i = 0; i < frameBufferCount; ++i)
-    {
-        buf->index = i;
-        buf->type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-        buf->memory = V4L2_MEMORY_MMAP;
-        VERIFY(ioctl(fd, VIDIOC_QBUF, buf) != -1);
-    }
-}
-
-bool NAOCamera::capturedNew()
-{
-  // requeue the buffer of the last captured image which is obselete now
-  if(currentBuf) 
-    VERIFY(ioctl(fd, VIDIOC_QBUF, currentBuf) != -1);
-  
-  // dequeue a frame buffer (this call blocks when there is no new image available) */
-  VERIFY(ioctl(fd, VIDIOC_DQBUF, buf) != -1);
-
-  ASSERT(buf->bytesused == SIZE);
-  currentBuf = buf;
-  timeStamp = storedTimeStamp + 33.0;
-  storedTimeStamp = Platform->getTime();
-  return true;
-}
-
-const unsigned char* NAOCamera::getImage() const
-{
-  ASSERT(currentBuf);
-  return static_cast<unsigned char*>(mem[currentBuf->index]);
-}
-
-double NAOCamera::getTimeStamp() const
-{
-  ASSERT(currentBuf);
-  return timeStamp;
 }
 
 CameraSettings::Camera NAOCamera::getCurrentCamera()
@@ -351,13 +296,36 @@ CameraSettings::Camera NAOCamera::getCurrentCamera()
     return m_settings.activeCamera;
 }
 
+/*! @brief Gets the next frame from the camera. 
+ 
+    The returned image is mapped directly onto the driver's buffer. The buffer is given back to the driver
+    on the next call to grabNewImage(), unless someone else has taken a CameraFrame to it with CameraBufferRing::hold().
+ 
+    If the driver has no new frame (the dequeue failed, or every buffer is held elsewhere) we wait a little and 
+    try again, rather than spin on the driver. If there is still no new frame after about a frame period the 
+    previous image is returned again.
+ */
 NUImage* NAOCamera::grabNewImage()
 {
-    while(!capturedNew());
-    currentBufferedImage.MapYUV422BufferToImage(getImage(), WIDTH, HEIGHT);
-    currentBufferedImage.m_timestamp = getTimeStamp();
-    currentBufferedImage.setCameraSettings(m_settings);
-    return &currentBufferedImage;
+    // this call blocks when there is no new image available
+    CameraFrame frame = m_ring->acquire();
+    for (int attempt = 1; not frame.isValid(); attempt++)
+    {
+        if (attempt >= grabAttempts and m_current_frame.isValid())
+            return m_current_frame.image();
+        Platform->msleep(grabRetryPeriod);
+        frame = m_ring->acquire();
+    }
+    // the previous frame is released by the assignment, after the new one has been dequeued
+    m_current_frame = frame;
+    
+    timeStamp = storedTimeStamp + 33.0;
+    storedTimeStamp = Platform->getTime();
+    
+    NUImage* image = m_current_frame.image();
+    image->m_timestamp = timeStamp;
+    image->setCameraSettings(m_settings);
+    return image;
 }
 
 void NAOCamera::readCameraSettings()
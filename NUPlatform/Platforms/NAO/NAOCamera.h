@@ -29,7 +29,9 @@
 
 #include "NUPlatform/NUCamera.h"
 #include "NUPlatform/NUCamera/CameraSettings.h"
+#include "NUPlatform/NUCamera/CameraBufferRing.h"
 #include "Infrastructure/NUImage/NUImage.h"
+class V4L2BufferRing;
 
 class NAOCamera : public NUCamera
 {
@@ -51,6 +53,8 @@ private:
   enum 
     {
         frameBufferCount = 20, //!< Number of available frame buffers.
+        grabRetryPeriod = 5, //!< The time in ms to wait before trying again to get a frame from the driver.
+        grabAttempts = 7, //!< The number of attempts to get a new frame, about one frame period, before the previous frame is given out again.
         WIDTH = 640,
         HEIGHT = 480,
         SIZE = WIDTH * HEIGHT * 2
@@ -65,18 +69,12 @@ private:
     void setStreaming(bool streaming_on);
 
     int fd; //!< The file descriptor for the video device.
-    void* mem[frameBufferCount]; //!< Frame buffer addresses.
-    int memLength[frameBufferCount]; //!< The length of each frame buffer.
-    struct v4l2_buffer* buf; //!< Reusable parameter struct for some ioctl calls.
-    struct v4l2_buffer* currentBuf; //!< The last dequeued frame buffer.
+    V4L2BufferRing* m_ring; //!< The driver's frame buffers.
+    CameraFrame m_current_frame; //!< The frame most recently given out by grabNewImage().
     double timeStamp, //!< Timestamp of the last captured image.
            storedTimeStamp; //!< Timestamp when the next image recording starts.
-    bool capturedNew();
-    const unsigned char* getImage() const;
-    double getTimeStamp() const;
     CameraSettings::Camera getCurrentCamera();
 
-    NUImage currentBufferedImage;
     CameraSettings m_cameraSettings[CameraSettings::NUM_CAMERAS];
 };
 
@@ -0,0 +1,124 @@
+/*! @file V4L2BufferRing.cpp
+    @brief Implementation of a camera buffer ring backed by the mmap'ed buffers of a V4L2 device
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "V4L2BufferRing.h"
+#include "GTAssert.h"
+
+#include "debug.h"
+#include "debugverbositynucamera.h"
+
+#include <cstring>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <errno.h>
+
+#undef __STRICT_ANSI__
+#include <linux/videodev.h>
+#define __STRICT_ANSI__
+
+using namespace std;
+
+/*! @brief Requests, maps and queues numbuffers capture buffers on the device
+    @param fd the file descriptor of the video device
+    @param numbuffers the number of buffers to request
+    @param width the width of each frame in pixels
+    @param height the height of each frame in pixels
+ */
+V4L2BufferRing::V4L2BufferRing(int fd, int numbuffers, int width, int height) : CameraBufferRing(width, height)
+{
+    m_fd = fd;
+    m_frame_size = width*height*2;
+    m_num_failed_dequeues = 0;
+
+    struct v4l2_requestbuffers rb;
+    memset(&rb, 0, sizeof(struct v4l2_requestbuffers));
+    rb.count = numbuffers;
+    rb.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    rb.memory = V4L2_MEMORY_MMAP;
+    VERIFY(ioctl(m_fd, VIDIOC_REQBUFS, &rb) != -1);
+
+    struct v4l2_buffer buf;
+    for (unsigned int i = 0; i < rb.count; i++)
+    {
+        memset(&buf, 0, sizeof(struct v4l2_buffer));
+        buf.index = i;
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        VERIFY(ioctl(m_fd, VIDIOC_QUERYBUF, &buf) != -1);
+        void* memory = mmap(0, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, buf.m.offset);
+        ASSERT(memory != MAP_FAILED);
+        m_memory.push_back(memory);
+        m_lengths.push_back(buf.length);
+        addBuffer(static_cast<unsigned char*>(memory));
+    }
+
+    for (int i = 0; i < size(); i++)
+        enqueueBuffer(i);
+
+    #if DEBUG_NUCAMERA_VERBOSITY > 0
+        debug << "V4L2BufferRing::V4L2BufferRing(). Mapped " << size() << " buffers." << endl;
+    #endif
+}
+
+/*! @brief Unmaps the buffers. Streaming must have been turned off before the ring is destroyed */
+V4L2BufferRing::~V4L2BufferRing()
+{
+    for (size_t i = 0; i < m_memory.size(); i++)
+        munmap(m_memory[i], m_lengths[i]);
+}
+
+/*! @brief Dequeues a filled buffer from the driver. This blocks until a new frame is available
+ 
+    Only the first of a run of failures is logged, because the caller retries every few milliseconds.
+    @return the index of the buffer, or -1 if the dequeue failed
+ */
+int V4L2BufferRing::dequeueBuffer()
+{
+    struct v4l2_buffer buf;
+    memset(&buf, 0, sizeof(struct v4l2_buffer));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    if (ioctl(m_fd, VIDIOC_DQBUF, &buf) == -1)
+    {
+        if (m_num_failed_dequeues++ == 0)
+            errorlog << "V4L2BufferRing::dequeueBuffer(). Failed to dequeue a buffer: " << strerror(errno) << endl;
+        return -1;
+    }
+    if (m_num_failed_dequeues > 0)
+    {
+        errorlog << "V4L2BufferRing::dequeueBuffer(). Dequeued a buffer after " << m_num_failed_dequeues << " failures" << endl;
+        m_num_failed_dequeues = 0;
+    }
+    ASSERT(buf.bytesused == static_cast<unsigned int>(m_frame_size));
+    return buf.index;
+}
+
+/*! @brief Queues a buffer back to the driver so that it can be filled again */
+void V4L2BufferRing::enqueueBuffer(int index)
+{
+    struct v4l2_buffer buf;
+    memset(&buf, 0, sizeof(struct v4l2_buffer));
+    buf.index = index;
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    VERIFY(ioctl(m_fd, VIDIOC_QBUF, &buf) != -1);
+}
+
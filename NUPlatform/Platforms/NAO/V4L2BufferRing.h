@@ -0,0 +1,51 @@
+/*! @file V4L2BufferRing.h
+    @brief Declaration of a camera buffer ring backed by the mmap'ed buffers of a V4L2 device
+
+    @class V4L2BufferRing
+    @brief A CameraBufferRing whose buffers are the V4L2 driver's own memory mapped capture buffers.
+
+    A buffer is dequeued from the driver by acquire(), and only queued back to the driver once every
+    CameraFrame referencing it has been released. The device must already have its format set, and
+    streaming should be turned on after the ring has been created.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef V4L2BUFFERRING_H
+#define V4L2BUFFERRING_H
+
+#include "NUPlatform/NUCamera/CameraBufferRing.h"
+
+class V4L2BufferRing : public CameraBufferRing
+{
+public:
+    V4L2BufferRing(int fd, int numbuffers, int width, int height);
+    ~V4L2BufferRing();
+protected:
+    int dequeueBuffer();
+    void enqueueBuffer(int index);
+private:
+    int m_fd;                               //!< the file descriptor for the video device
+    int m_frame_size;                       //!< the expected size of each frame in bytes
+    std::vector<void*> m_memory;            //!< the mapped address of each buffer
+    std::vector<int> m_lengths;             //!< the mapped length of each buffer
+    int m_num_failed_dequeues;              //!< the number of dequeues that have failed in a row, so that only the first failure is logged
+};
+
+#endif
+
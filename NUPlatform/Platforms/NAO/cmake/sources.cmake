@@ -20,6 +20,7 @@
 SET (YOUR_SRCS  NUNAO.cpp
 		        NAOPlatform.cpp NAOPlatform.h
                 NAOCamera.cpp NAOCamera.h
+                V4L2BufferRing.cpp V4L2BufferRing.h
                 NAOSensors.cpp NAOSensors.h
                 NAOActionators.cpp NAOActionators.h
                 NAOIO.cpp )
@@ -0,0 +1,199 @@
+/*!  @file DXBusThread.cpp
+     @brief Implementation of DXBusThread class.
+
+     @author Jason Kulk
+
+ Copyright (c) 2011 Jason Kulk
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DXBusThread.h"
+#include "DXTransport.h"
+
+#include "debug.h"
+#include "debugverbositynuplatform.h"
+
+#include <time.h>
+#include <errno.h>
+using namespace std;
+
+/*! @brief Creates and starts the worker for a bus
+    @param name the name of the thread
+    @param transport the bus the thread writes to
+    @param priority the real-time priority of the thread
+ */
+DXBusThread::DXBusThread(string name, DXTransport* transport, unsigned char priority) : BoundedQueueThread<DXBusJob>(name, priority, 16, LockFreeQueue<DXBusJob>::Block), m_transport(transport)
+{
+    #if DEBUG_NUPLATFORM_VERBOSITY > 0
+        debug << "DXBusThread::DXBusThread(" << m_name << ", " << static_cast<int>(m_priority) << ")" << endl;
+    #endif
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_INHERIT);     // a submitter holding the lock runs at the priority of the callers it holds up
+    pthread_mutex_init(&m_ticket_mutex, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+    pthread_cond_init(&m_ticket_condition, NULL);
+    m_submitted = 0;
+    m_completed = 0;
+    m_num_failures = 0;
+    m_max_write_time = 0;
+    m_finished = false;
+    m_started = start() == 0;
+}
+
+/*! @brief Stops the worker, once it has done the writes already submitted.
+
+    The worker is told to finish with an empty job, rather than being cancelled, so that it is never woken after
+    its condition and queue have been destroyed.
+ */
+DXBusThread::~DXBusThread()
+{
+    #if DEBUG_NUPLATFORM_VERBOSITY > 0
+        debug << "DXBusThread::~DXBusThread() " << m_name << " writes: " << m_completed << " failures: " << m_num_failures << " max write time: " << m_max_write_time << "ms" << endl;
+    #endif
+    if (m_started)
+    {
+        submit(NULL, 0);
+        pthread_mutex_lock(&m_ticket_mutex);
+        while (not m_finished)
+            pthread_cond_wait(&m_ticket_condition, &m_ticket_mutex);
+        pthread_mutex_unlock(&m_ticket_mutex);
+    }
+    stop();
+    pthread_cond_destroy(&m_ticket_condition);
+    pthread_mutex_destroy(&m_ticket_mutex);
+}
+
+/*! @brief Hands a write to the worker. This can be called from any thread.
+
+    If the worker already has a full queue of writes, the caller sleeps until one of them has been completed, so
+    that the push itself never has to wait. The worker may run at a lower priority than the caller, and a caller
+    yielding in a loop for room in the queue would never let it run.
+
+    @param buffer the bytes to write. The buffer must not be changed until the write has completed
+    @param length the number of bytes to write
+    @param pause the time in microseconds the worker waits after the write before starting the next one
+    @return the ticket of the write, which can be passed to wait() or isComplete()
+ */
+unsigned int DXBusThread::submit(const unsigned char* buffer, unsigned short length, unsigned int pause)
+{
+    DXBusJob job;
+    job.Buffer = buffer;
+    job.Length = length;
+    job.Pause = pause;
+    pthread_mutex_lock(&m_ticket_mutex);
+    while (m_submitted - m_completed >= m_queue.capacity())
+        pthread_cond_wait(&m_ticket_condition, &m_ticket_mutex);
+    unsigned int ticket = ++m_submitted;
+    pushBack(job);
+    pthread_mutex_unlock(&m_ticket_mutex);
+    return ticket;
+}
+
+/*! @brief Returns true if the write with the given ticket has been completed */
+bool DXBusThread::isComplete(unsigned int ticket) const
+{
+    return static_cast<int>(m_completed - ticket) >= 0;
+}
+
+/*! @brief Blocks the calling thread until the write with the given ticket has been completed. The caller sleeps, so the worker can run whatever their priorities */
+void DXBusThread::wait(unsigned int ticket)
+{
+    pthread_mutex_lock(&m_ticket_mutex);
+    while (not isComplete(ticket))
+        pthread_cond_wait(&m_ticket_condition, &m_ticket_mutex);
+    pthread_mutex_unlock(&m_ticket_mutex);
+}
+
+/*! @brief Blocks the calling thread until every submitted write has been completed */
+void DXBusThread::waitForIdle()
+{
+    pthread_mutex_lock(&m_ticket_mutex);
+    unsigned int ticket = m_submitted;
+    pthread_mutex_unlock(&m_ticket_mutex);
+    wait(ticket);
+}
+
+/*! @brief Returns the bus the thread writes to */
+DXTransport* DXBusThread::getTransport() const
+{
+    return m_transport;
+}
+
+/*! @brief Returns the number of writes that have been completed */
+unsigned int DXBusThread::getNumWrites() const
+{
+    return m_completed;
+}
+
+/*! @brief Returns the number of writes that did not write all of their bytes */
+unsigned int DXBusThread::getNumFailures() const
+{
+    return m_num_failures;
+}
+
+/*! @brief Returns the longest write in ms */
+double DXBusThread::getMaxWriteTime() const
+{
+    return m_max_write_time;
+}
+
+/*! @brief The worker's main loop. Each write is done, followed by its pause, and then its ticket is marked as completed.
+           The loop ends at the empty job submitted by the destructor.
+ */
+void DXBusThread::run()
+{
+    #if DEBUG_NUPLATFORM_VERBOSITY > 0
+        debug << "DXBusThread::run() " << m_name << endl;
+    #endif
+    while (true)
+    {
+        waitForCondition();
+        DXBusJob job = m_queue.front();
+        m_queue.pop_front();
+        if (job.Buffer == NULL)
+        {
+            pthread_mutex_lock(&m_ticket_mutex);
+            m_finished = true;
+            pthread_cond_broadcast(&m_ticket_condition);
+            pthread_mutex_unlock(&m_ticket_mutex);
+            return;
+        }
+
+        timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        int written = m_transport->write(job.Buffer, job.Length);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        if (written != job.Length)
+            m_num_failures++;
+        double writetime = 1e3*(end.tv_sec - start.tv_sec) + 1e-6*(end.tv_nsec - start.tv_nsec);
+        if (writetime > m_max_write_time)
+            m_max_write_time = writetime;
+
+        if (job.Pause > 0)
+        {
+            timespec pause;
+            pause.tv_sec = job.Pause/1000000;
+            pause.tv_nsec = 1000L*(job.Pause%1000000);
+            while (clock_nanosleep(CLOCK_MONOTONIC, 0, &pause, &pause) == EINTR);
+        }
+
+        pthread_mutex_lock(&m_ticket_mutex);
+        m_completed++;
+        pthread_cond_broadcast(&m_ticket_condition);
+        pthread_mutex_unlock(&m_ticket_mutex);
+    }
+}
+
@@ -0,0 +1,80 @@
+/*! @file DXBusThread.h
+    @brief Declaration of the DXBusThread class.
+
+    @class DXBusThread
+    @brief A long-lived worker thread that writes to a single bus of Dynamixel motors.
+
+    Each bus has its own DXBusThread, so the buses are written to in parallel without creating a thread for every
+    write. Writes are handed to the worker through a lock free queue with submit(), which returns a ticket
+    immediately. The caller can then carry on, and only wait() for the ticket when it needs the write to have
+    finished, for example before it reuses the buffer. A write can be followed by a pause, which is used to space
+    out the request blocks so that the motors' replies do not collide.
+
+    The buffers passed to submit() are not copied, and must remain unchanged until the write's ticket has completed.
+
+    @author Jason Kulk
+
+ Copyright (c) 2011 Jason Kulk
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DXBUSTHREAD_H_DEFINED
+#define DXBUSTHREAD_H_DEFINED
+
+#include "Tools/Threading/BoundedQueueThread.h"
+class DXTransport;
+
+#include <string>
+#include <pthread.h>
+
+/*! @brief A single write to be done by a DXBusThread */
+struct DXBusJob
+{
+    const unsigned char* Buffer;            //!< the bytes to write, or NULL to tell the worker to finish
+    unsigned short Length;                  //!< the number of bytes to write
+    unsigned int Pause;                     //!< the time in microseconds to wait after the write before starting the next one
+};
+
+class DXBusThread : public BoundedQueueThread<DXBusJob>
+{
+public:
+    DXBusThread(std::string name, DXTransport* transport, unsigned char priority);
+    ~DXBusThread();
+
+    unsigned int submit(const unsigned char* buffer, unsigned short length, unsigned int pause = 0);
+    bool isComplete(unsigned int ticket) const;
+    void wait(unsigned int ticket);
+    void waitForIdle();
+
+    DXTransport* getTransport() const;
+    unsigned int getNumWrites() const;
+    unsigned int getNumFailures() const;
+    double getMaxWriteTime() const;
+protected:
+    void run();
+private:
+    DXTransport* m_transport;               //!< the bus
+    pthread_mutex_t m_ticket_mutex;         //!< lock for the tickets, held while a write is queued so that the tickets are in the same order as the writes
+    pthread_cond_t m_ticket_condition;      //!< signalled each time a write is completed
+    volatile unsigned int m_submitted;      //!< the ticket of the last submitted write
+    volatile unsigned int m_completed;      //!< the ticket of the last completed write
+    bool m_started;                         //!< true if the worker was started
+    bool m_finished;                        //!< true once the worker has done its last write and returned
+    unsigned int m_num_failures;            //!< the number of writes that did not write all of their bytes
+    double m_max_write_time;                //!< the longest write in ms (not including its pause)
+};
+
+#endif
+
@@ -0,0 +1,323 @@
+/*! @file DXEmulator.cpp
+    @brief Implementation of the DXEmulator class
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DXEmulator.h"
+#include "dx117.h"
+
+#include "debug.h"
+#include "debugverbositynuplatform.h"
+
+#include <cstring>
+using namespace std;
+
+/*! @brief Creates an empty bus
+    @param baudrate the baud rate used to estimate the time the bus is busy
+ */
+DXEmulator::DXEmulator(int baudrate) : m_baudrate(baudrate)
+{
+    pthread_mutex_init(&m_mutex, NULL);
+    memset(m_present, 0, sizeof(m_present));
+    memset(m_tables, 0, sizeof(m_tables));
+    resetStatistics();
+}
+
+DXEmulator::~DXEmulator()
+{
+    pthread_mutex_destroy(&m_mutex);
+}
+
+/*! @brief Adds a motor to the bus. Its control table is set to the factory defaults, except for the baud rate
+    @param id the id of the motor
+    @param position the motor's present and goal position
+ */
+void DXEmulator::addMotor(unsigned char id, unsigned short position)
+{
+    pthread_mutex_lock(&m_mutex);
+    m_present[id] = true;
+    unsigned char* table = m_tables[id];
+    memset(table, 0, m_table_size);
+    table[P_ID] = id;
+    table[P_BAUD_RATE] = DX117_BAUD_1M;
+    table[P_RETURN_DELAY_TIME] = 250;
+    table[P_CCW_ANGLE_LIMIT_L] = DX117_MAX_POSITION & 0xFF;
+    table[P_CCW_ANGLE_LIMIT_H] = DX117_MAX_POSITION >> 8;
+    table[P_RETURN_LEVEL] = DX117_RETURN_ALL;
+    table[P_GOAL_POSITION_L] = table[P_PRESENT_POSITION_L] = position & 0xFF;
+    table[P_GOAL_POSITION_H] = table[P_PRESENT_POSITION_H] = (position >> 8) & 0xFF;
+    pthread_mutex_unlock(&m_mutex);
+}
+
+/*! @brief Returns true if there is a motor with the given id on the bus */
+bool DXEmulator::hasMotor(unsigned char id) const
+{
+    return m_present[id];
+}
+
+/*! @brief Returns a byte from a motor's control table */
+unsigned char DXEmulator::getByte(unsigned char id, unsigned char address)
+{
+    pthread_mutex_lock(&m_mutex);
+    unsigned char value = address < m_table_size ? m_tables[id][address] : 0;
+    pthread_mutex_unlock(&m_mutex);
+    return value;
+}
+
+/*! @brief Returns a two byte value (low byte first) from a motor's control table */
+unsigned short DXEmulator::getWord(unsigned char id, unsigned char address)
+{
+    return getByte(id, address) + (getByte(id, address + 1) << 8);
+}
+
+/*! @brief Sets a two byte value (low byte first) in a motor's control table, for example to emulate a load */
+void DXEmulator::setWord(unsigned char id, unsigned char address, unsigned short value)
+{
+    pthread_mutex_lock(&m_mutex);
+    if (address + 1 < m_table_size)
+    {
+        m_tables[id][address] = value & 0xFF;
+        m_tables[id][address + 1] = (value >> 8) & 0xFF;
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
+
+/*! @brief Writes bytes to the bus. Each complete instruction packet is executed by the motors */
+int DXEmulator::write(const unsigned char* data, int length)
+{
+    pthread_mutex_lock(&m_mutex);
+    m_num_writes++;
+    m_num_bytes_written += length;
+    m_bus_time += 1e3*10*length/m_baudrate;
+    m_input.insert(m_input.end(), data, data + length);
+    parse();
+    pthread_mutex_unlock(&m_mutex);
+    return length;
+}
+
+/*! @brief Reads status packets from the bus */
+int DXEmulator::read(unsigned char* data, int length)
+{
+    pthread_mutex_lock(&m_mutex);
+    int n = 0;
+    while (n < length and not m_output.empty())
+    {
+        data[n++] = m_output.front();
+        m_output.pop_front();
+    }
+    pthread_mutex_unlock(&m_mutex);
+    return n;
+}
+
+int DXEmulator::available()
+{
+    pthread_mutex_lock(&m_mutex);
+    int n = m_output.size();
+    pthread_mutex_unlock(&m_mutex);
+    return n;
+}
+
+bool DXEmulator::isOpen() const
+{
+    return true;
+}
+
+/*! @brief Clears all of the traffic statistics */
+void DXEmulator::resetStatistics()
+{
+    m_num_writes = 0;
+    m_num_bytes_written = 0;
+    m_num_bytes_replied = 0;
+    m_num_checksum_errors = 0;
+    memset(m_num_packets, 0, sizeof(m_num_packets));
+    m_bus_time = 0;
+}
+
+/*! @brief Returns the number of calls to write() */
+unsigned int DXEmulator::getNumWrites()
+{
+    return m_num_writes;
+}
+
+/*! @brief Returns the number of bytes written to the bus */
+unsigned int DXEmulator::getNumBytesWritten()
+{
+    return m_num_bytes_written;
+}
+
+/*! @brief Returns the number of bytes the motors have replied with */
+unsigned int DXEmulator::getNumBytesReplied()
+{
+    return m_num_bytes_replied;
+}
+
+/*! @brief Returns the number of instruction packets written to the bus */
+unsigned int DXEmulator::getNumPackets()
+{
+    unsigned int total = 0;
+    for (int i=0; i<256; i++)
+        total += m_num_packets[i];
+    return total;
+}
+
+/*! @brief Returns the number of instruction packets of the given type written to the bus */
+unsigned int DXEmulator::getNumPackets(unsigned char instruction)
+{
+    return m_num_packets[instruction];
+}
+
+/*! @brief Returns the number of instruction packets with a bad checksum */
+unsigned int DXEmulator::getNumChecksumErrors()
+{
+    return m_num_checksum_errors;
+}
+
+/*! @brief Returns the estimated time in ms the bus has been busy */
+double DXEmulator::getBusTime()
+{
+    return m_bus_time;
+}
+
+/*! @brief Executes each complete instruction packet in m_input, and discards anything that is not a packet */
+void DXEmulator::parse()
+{
+    size_t index = 0;
+    while (index + 4 <= m_input.size())
+    {
+        if (m_input[index] != DX117_START_BYTE or m_input[index+1] != DX117_START_BYTE)
+        {
+            index++;
+            continue;
+        }
+        unsigned char length = m_input[index+3];
+        if (length < 2)
+        {
+            index += 2;
+            continue;
+        }
+        if (index + 4 + length > m_input.size())
+            break;                                  // wait for the rest of the packet
+
+        const unsigned char* packet = &m_input[index];
+        unsigned char checksum = 0;
+        for (int i=2; i<length + 3; i++)
+            checksum += packet[i];
+        checksum = ~checksum;
+        if (checksum != packet[length + 3])
+        {
+            m_num_checksum_errors++;
+            index += 2;
+            continue;
+        }
+        m_num_packets[packet[4]]++;
+        execute(packet[2], packet[4], packet + 5, length - 2);
+        index += 4 + length;
+    }
+    m_input.erase(m_input.begin(), m_input.begin() + index);
+}
+
+/*! @brief Executes an instruction on the motor(s) it is addressed to */
+void DXEmulator::execute(unsigned char id, unsigned char instruction, const unsigned char* parameters, unsigned char numparameters)
+{
+    if (instruction == DX117_SYNC_WRITE)
+    {
+        if (id != DX117_BROADCASTING_ID or numparameters < 2)
+            return;
+        unsigned char address = parameters[0];
+        unsigned char length = parameters[1];
+        for (int i=2; i + 1 + length <= numparameters; i += length + 1)
+        {
+            if (m_present[parameters[i]])
+                writeTable(parameters[i], address, parameters + i + 1, length);
+        }
+        return;
+    }
+
+    if (id == DX117_BROADCASTING_ID)
+    {   // broadcast instructions are executed by every motor, but none of them reply
+        if (instruction == DX117_WRITE and numparameters >= 1)
+        {
+            for (int i=0; i<256; i++)
+                if (m_present[i])
+                    writeTable(i, parameters[0], parameters + 1, numparameters - 1);
+        }
+        return;
+    }
+    if (not m_present[id])
+        return;
+
+    unsigned char* table = m_tables[id];
+    if (instruction == DX117_PING)
+        reply(id, 0, NULL, 0);
+    else if (instruction == DX117_READ and numparameters == 2)
+    {
+        unsigned char address = parameters[0];
+        unsigned char length = parameters[1];
+        if (address + length > m_table_size)
+        {
+            if (table[P_RETURN_LEVEL] != DX117_RETURN_NONE)
+                reply(id, DX117_ALARM_RANGE, NULL, 0);
+        }
+        else if (table[P_RETURN_LEVEL] != DX117_RETURN_NONE)
+            reply(id, 0, table + address, length);
+    }
+    else if (instruction == DX117_WRITE and numparameters >= 1)
+    {
+        writeTable(id, parameters[0], parameters + 1, numparameters - 1);
+        if (table[P_RETURN_LEVEL] == DX117_RETURN_ALL)
+            reply(id, 0, NULL, 0);
+    }
+    else if (table[P_RETURN_LEVEL] == DX117_RETURN_ALL)
+        reply(id, DX117_ALARM_INSTRUCTION, NULL, 0);
+}
+
+/*! @brief Writes to a motor's control table. The emulated motor moves to its goal position immediately */
+void DXEmulator::writeTable(unsigned char id, unsigned char address, const unsigned char* data, unsigned char length)
+{
+    unsigned char* table = m_tables[id];
+    for (unsigned char i=0; i<length and address + i < m_table_size; i++)
+        table[address + i] = data[i];
+    if (address <= P_GOAL_POSITION_H and address + length > P_GOAL_POSITION_L)
+    {
+        table[P_PRESENT_POSITION_L] = table[P_GOAL_POSITION_L];
+        table[P_PRESENT_POSITION_H] = table[P_GOAL_POSITION_H];
+    }
+}
+
+/*! @brief Queues a status packet from a motor to be read, and adds its time to the bus */
+void DXEmulator::reply(unsigned char id, unsigned char error, const unsigned char* parameters, unsigned char numparameters)
+{
+    unsigned char checksum = id + numparameters + 2 + error;
+    m_output.push_back(DX117_START_BYTE);
+    m_output.push_back(DX117_START_BYTE);
+    m_output.push_back(id);
+    m_output.push_back(numparameters + 2);
+    m_output.push_back(error);
+    for (unsigned char i=0; i<numparameters; i++)
+    {
+        m_output.push_back(parameters[i]);
+        checksum += parameters[i];
+    }
+    m_output.push_back(~checksum);
+
+    int length = numparameters + 6;
+    m_num_bytes_replied += length;
+    m_bus_time += 1e3*10*length/m_baudrate + 2e-3*m_tables[id][P_RETURN_DELAY_TIME];
+}
+
@@ -0,0 +1,92 @@
+/*! @file DXEmulator.h
+    @brief Declaration of the DXEmulator class
+
+    @class DXEmulator
+    @brief An in-memory bus of emulated Dynamixel motors, used in place of a real transport for testing
+
+    Every motor added to the emulator has its own control table. Instruction packets written to the bus are
+    parsed and executed as a motor would: PING, READ, WRITE and SYNC_WRITE are supported, and status packets
+    are queued to be read back according to each motor's return level. An ideal motor is emulated, so the
+    present position follows the goal position immediately.
+
+    The emulator also keeps statistics about the traffic, including an estimate of the time the bus is busy
+    at the configured baud rate (10 bits per byte in both directions, plus each motor's return delay), so the
+    cost of different packet layouts can be compared without hardware.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DXEMULATOR_H
+#define DXEMULATOR_H
+
+#include "DXTransport.h"
+
+#include <vector>
+#include <deque>
+#include <pthread.h>
+
+class DXEmulator : public DXTransport
+{
+public:
+    DXEmulator(int baudrate = 1000000);
+    ~DXEmulator();
+
+    void addMotor(unsigned char id, unsigned short position = 512);
+    bool hasMotor(unsigned char id) const;
+    unsigned char getByte(unsigned char id, unsigned char address);
+    unsigned short getWord(unsigned char id, unsigned char address);
+    void setWord(unsigned char id, unsigned char address, unsigned short value);
+
+    int write(const unsigned char* data, int length);
+    int read(unsigned char* data, int length);
+    int available();
+    bool isOpen() const;
+
+    void resetStatistics();
+    unsigned int getNumWrites();
+    unsigned int getNumBytesWritten();
+    unsigned int getNumBytesReplied();
+    unsigned int getNumPackets();
+    unsigned int getNumPackets(unsigned char instruction);
+    unsigned int getNumChecksumErrors();
+    double getBusTime();
+private:
+    void parse();
+    void execute(unsigned char id, unsigned char instruction, const unsigned char* parameters, unsigned char numparameters);
+    void writeTable(unsigned char id, unsigned char address, const unsigned char* data, unsigned char length);
+    void reply(unsigned char id, unsigned char error, const unsigned char* parameters, unsigned char numparameters);
+private:
+    static const int m_table_size = 64;                 //!< the number of bytes in each motor's control table
+    int m_baudrate;                                     //!< the baud rate of the bus
+    pthread_mutex_t m_mutex;                            //!< lock for everything, so the bus can be written and read from different threads
+
+    bool m_present[256];                                //!< true for each motor id on the bus
+    unsigned char m_tables[256][m_table_size];          //!< the control table of each motor
+    std::vector<unsigned char> m_input;                 //!< the bytes written to the bus that have not been parsed yet
+    std::deque<unsigned char> m_output;                 //!< the status packets waiting to be read
+
+    unsigned int m_num_writes;                          //!< the number of calls to write()
+    unsigned int m_num_bytes_written;                   //!< the number of bytes written to the bus
+    unsigned int m_num_bytes_replied;                   //!< the number of bytes in status packets
+    unsigned int m_num_checksum_errors;                 //!< the number of instruction packets with a bad checksum
+    unsigned int m_num_packets[256];                    //!< the number of instruction packets of each type
+    double m_bus_time;                                  //!< the time the bus has been busy in ms
+};
+
+#endif
+
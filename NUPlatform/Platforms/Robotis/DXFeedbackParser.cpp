@@ -0,0 +1,231 @@
+/*! @file DXFeedbackParser.cpp
+    @brief Implementation of the DXFeedbackParser class
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DXFeedbackParser.h"
+#include "dx117.h"
+
+#include "debug.h"
+#include "debugverbositynuplatform.h"
+
+#include <cstring>
+using namespace std;
+
+/*! @brief Creates a parser with no feedback */
+DXFeedbackParser::DXFeedbackParser()
+{
+    reset();
+}
+
+/*! @brief Clears the feedback table, the statistics and any partial packet */
+void DXFeedbackParser::reset()
+{
+    m_state = WaitFirstStart;
+    m_packet_size = 0;
+    m_cursor = 0;
+    m_checksum = 0;
+
+    memset(m_feedback, 0, sizeof(m_feedback));
+    memset(m_outstanding, 0, sizeof(m_outstanding));
+    memset(m_request_times, 0, sizeof(m_request_times));
+
+    m_num_packets = 0;
+    m_num_feedback_packets = 0;
+    m_num_checksum_errors = 0;
+    m_num_discarded_bytes = 0;
+}
+
+/*! @brief Records that feedback has been requested from a motor. If the motor has not replied to its previous request,
+           that request is counted as lost.
+    @param id the id of the motor
+    @param time the time the request was sent
+ */
+void DXFeedbackParser::markRequested(unsigned char id, double time)
+{
+    DXMotorFeedback& feedback = m_feedback[id];
+    if (m_outstanding[id])
+        feedback.NumLost++;
+    feedback.NumRequests++;
+    m_outstanding[id] = true;
+    m_request_times[id] = time;
+}
+
+/*! @brief Parses bytes read from the bus. A packet that is not complete is kept until the rest of it is pushed.
+    @param data the bytes
+    @param length the number of bytes
+    @param time the time the bytes were read
+    @return the number of feedback packets that were decoded
+ */
+int DXFeedbackParser::push(const unsigned char* data, int length, double time)
+{
+    unsigned int previous = m_num_feedback_packets;
+    for (int i=0; i<length; i++)
+    {
+        m_packet[m_packet_size++] = data[i];
+        while (m_cursor < m_packet_size)
+        {
+            Result result = consume(m_packet[m_cursor++], time);
+            if (result == Complete)
+            {   // the packet, or the byte that was not part of one, is finished with
+                memmove(m_packet, m_packet + m_cursor, m_packet_size - m_cursor);
+                m_packet_size -= m_cursor;
+                m_cursor = 0;
+            }
+            else if (result == Invalid)
+            {   // the header was not the start of a packet, so drop its first byte and parse the rest again
+                m_num_discarded_bytes++;
+                memmove(m_packet, m_packet + 1, m_packet_size - 1);
+                m_packet_size--;
+                m_cursor = 0;
+                m_state = WaitFirstStart;
+            }
+        }
+    }
+    return m_num_feedback_packets - previous;
+}
+
+/*! @brief Returns the latest feedback from a motor */
+const DXMotorFeedback& DXFeedbackParser::getFeedback(unsigned char id) const
+{
+    return m_feedback[id];
+}
+
+/*! @brief Returns true if there has been no feedback from a motor in the last maxage */
+bool DXFeedbackParser::isStale(unsigned char id, double time, double maxage) const
+{
+    const DXMotorFeedback& feedback = m_feedback[id];
+    return feedback.Sequence == 0 or time - feedback.Timestamp > maxage;
+}
+
+/*! @brief Returns the number of valid packets, including those that were not feedback */
+unsigned int DXFeedbackParser::getNumPackets() const
+{
+    return m_num_packets;
+}
+
+/*! @brief Returns the number of feedback packets that were decoded */
+unsigned int DXFeedbackParser::getNumFeedbackPackets() const
+{
+    return m_num_feedback_packets;
+}
+
+/*! @brief Returns the number of packets with a bad checksum */
+unsigned int DXFeedbackParser::getNumChecksumErrors() const
+{
+    return m_num_checksum_errors;
+}
+
+/*! @brief Returns the number of bytes that were not part of a valid packet */
+unsigned int DXFeedbackParser::getNumDiscardedBytes() const
+{
+    return m_num_discarded_bytes;
+}
+
+/*! @brief Returns the number of bytes of a partial packet waiting for the rest of it */
+int DXFeedbackParser::getNumPendingBytes() const
+{
+    return m_packet_size;
+}
+
+/*! @brief Advances the state machine by a single byte. The byte has already been added to m_packet.
+    @return Complete if a packet was finished, or the byte was discarded. Invalid if the bytes in m_packet can not be a packet.
+ */
+DXFeedbackParser::Result DXFeedbackParser::consume(unsigned char byte, double time)
+{
+    switch (m_state)
+    {
+        case WaitFirstStart:
+            if (byte == DX117_START_BYTE)
+            {
+                m_state = WaitSecondStart;
+                return Incomplete;
+            }
+            m_num_discarded_bytes++;
+            return Complete;
+        case WaitSecondStart:
+            if (byte != DX117_START_BYTE)
+                return Invalid;
+            m_state = WaitId;
+            return Incomplete;
+        case WaitId:
+            if (byte == DX117_START_BYTE)               // a third start byte means the first one was not part of the header
+                return Invalid;
+            m_checksum = byte;
+            m_state = WaitLength;
+            return Incomplete;
+        case WaitLength:
+            if (byte < 2 or byte > MaxParameters + 2)  // a status packet can not be longer than the control table
+                return Invalid;
+            m_checksum += byte;
+            m_state = WaitBody;
+            return Incomplete;
+        case WaitBody:
+            m_checksum += byte;
+            if (m_cursor == m_packet[3] + 3)            // the header, the error byte and all of the parameters
+                m_state = WaitChecksum;
+            return Incomplete;
+        case WaitChecksum:
+            if (static_cast<unsigned char>(~m_checksum) != byte)
+            {
+                m_num_checksum_errors++;
+                return Invalid;
+            }
+            m_num_packets++;
+            decode(time);
+            m_state = WaitFirstStart;
+            return Complete;
+    }
+    return Invalid;
+}
+
+/*! @brief Decodes the complete packet in m_packet. Only replies with the present position, speed and load, and optionally
+           the present voltage and temperature, are decoded as feedback.
+ */
+void DXFeedbackParser::decode(double time)
+{
+    unsigned char id = m_packet[2];
+    int numparameters = m_packet[3] - 2;
+    if (numparameters != NUM_FEEDBACK_MOTOR and numparameters != NUM_FEEDBACK_MOTOR + 2)
+        return;
+
+    const unsigned char* parameters = m_packet + 5;
+    DXMotorFeedback& feedback = m_feedback[id];
+    feedback.Error = m_packet[4];
+    feedback.Position = ((parameters[1] & 0x3) << 8) + parameters[0];
+    feedback.Speed = ((parameters[3] & 0x3) << 8) + parameters[2];
+    feedback.Load = ((parameters[5] & 0x3) << 8) + parameters[4];
+    feedback.HasTemperature = numparameters == NUM_FEEDBACK_MOTOR + 2;
+    if (feedback.HasTemperature)
+    {
+        feedback.Voltage = parameters[6];
+        feedback.Temperature = parameters[7];
+    }
+    feedback.Sequence++;
+    feedback.Timestamp = time;
+    if (m_outstanding[id])
+    {
+        feedback.Latency = time - m_request_times[id];
+        if (feedback.Latency > feedback.MaxLatency)
+            feedback.MaxLatency = feedback.Latency;
+        m_outstanding[id] = false;
+    }
+    m_num_feedback_packets++;
+}
+
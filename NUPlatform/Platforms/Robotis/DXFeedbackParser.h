@@ -0,0 +1,111 @@
+/*! @file DXFeedbackParser.h
+    @brief Declaration of the DXFeedbackParser class
+
+    @class DXFeedbackParser
+    @brief An incremental parser for the status packets coming back from a bus of Dynamixel motors
+
+    The bytes read from the bus are pushed into the parser as they arrive. Each byte advances a small state machine,
+    and the checksum is accumulated as it goes, so a status packet split across two reads is not lost, and the cost
+    of parsing only depends on the number of new bytes. When a packet fails its checksum the parser resynchronises
+    on the bytes after the bad header, so a corrupt length can not swallow the packets behind it.
+
+    Each valid feedback packet (a reply to a READ of the present position, speed and load, and optionally the present
+    voltage and temperature) is decoded straight into a fixed table with an entry for every motor id. Each entry has
+    a sequence number and the time it was last updated, so the user can tell which motors have fresh data. If
+    markRequested() is called for each motor when its feedback is requested, the parser also keeps the number of
+    requests that were never answered and the latency of the replies for each motor.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DXFEEDBACKPARSER_H
+#define DXFEEDBACKPARSER_H
+
+/*! @brief The latest feedback from a single motor, and the statistics about its replies */
+struct DXMotorFeedback
+{
+    unsigned short Position;            //!< the present position in motor units
+    unsigned short Speed;               //!< the present speed in motor units
+    unsigned short Load;                //!< the present load in motor units
+    unsigned char Voltage;              //!< the present voltage in 0.1V, only valid if HasTemperature
+    unsigned char Temperature;          //!< the present temperature in degrees C, only valid if HasTemperature
+    bool HasTemperature;                //!< true if the last packet included the voltage and temperature
+    unsigned char Error;                //!< the error byte of the last packet
+    unsigned int Sequence;              //!< the number of feedback packets received from the motor
+    double Timestamp;                   //!< the time the last feedback packet was received
+    unsigned int NumRequests;           //!< the number of times feedback was requested from the motor
+    unsigned int NumLost;               //!< the number of requests that were not answered before the next request
+    double Latency;                     //!< the time between the last request and its reply
+    double MaxLatency;                  //!< the longest time between a request and its reply
+};
+
+class DXFeedbackParser
+{
+public:
+    DXFeedbackParser();
+
+    void reset();
+    void markRequested(unsigned char id, double time);
+    int push(const unsigned char* data, int length, double time);
+
+    const DXMotorFeedback& getFeedback(unsigned char id) const;
+    bool isStale(unsigned char id, double time, double maxage) const;
+
+    unsigned int getNumPackets() const;
+    unsigned int getNumFeedbackPackets() const;
+    unsigned int getNumChecksumErrors() const;
+    unsigned int getNumDiscardedBytes() const;
+    int getNumPendingBytes() const;
+private:
+    static const int MaxParameters = 64;    //!< the longest status packet that is accepted; a corrupt length longer than this is rejected immediately
+    enum Result
+    {
+        Incomplete,
+        Complete,
+        Invalid
+    };
+    Result consume(unsigned char byte, double time);
+    void decode(double time);
+private:
+    enum State
+    {
+        WaitFirstStart,
+        WaitSecondStart,
+        WaitId,
+        WaitLength,
+        WaitBody,
+        WaitChecksum
+    };
+    State m_state;                          //!< the part of the packet the next byte belongs to
+    unsigned char m_packet[260];            //!< the bytes from the start of the packet being parsed, kept so the parser can resynchronise
+    int m_packet_size;                      //!< the number of bytes in m_packet
+    int m_cursor;                           //!< the number of bytes in m_packet that have been consumed
+    unsigned char m_checksum;               //!< the checksum of the packet being parsed so far
+
+    DXMotorFeedback m_feedback[256];        //!< the feedback from each motor id
+    bool m_outstanding[256];                //!< true for each motor that has been sent a request it has not replied to
+    double m_request_times[256];            //!< the time of the last request to each motor
+
+    unsigned int m_num_packets;             //!< the number of valid packets
+    unsigned int m_num_feedback_packets;    //!< the number of valid packets that were decoded as feedback
+    unsigned int m_num_checksum_errors;     //!< the number of packets with a bad checksum
+    unsigned int m_num_discarded_bytes;     //!< the number of bytes that were not part of a valid packet
+};
+
+#endif
+
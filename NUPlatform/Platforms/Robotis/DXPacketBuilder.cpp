@@ -0,0 +1,181 @@
+/*! @file DXPacketBuilder.cpp
+    @brief Implementation of the DXPacketBuilder class
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DXPacketBuilder.h"
+#include "dx117.h"
+
+#include "debug.h"
+#include "debugverbositynuplatform.h"
+using namespace std;
+
+/*! @brief Creates an empty buffer */
+DXPacketBuilder::DXPacketBuilder()
+{
+    clear();
+}
+
+/*! @brief Removes all of the packets from the buffer */
+void DXPacketBuilder::clear()
+{
+    m_size = 0;
+    m_num_packets = 0;
+    m_in_sync_write = false;
+    m_sync_start = -1;
+    m_sync_count = 0;
+}
+
+/*! @brief Appends an instruction packet to the buffer
+    @param id the id of the motor
+    @param instruction the instruction
+    @param parameters the instruction's parameters
+    @param numparameters the number of parameters
+    @return false if there was no room for the packet
+ */
+bool DXPacketBuilder::addPacket(unsigned char id, unsigned char instruction, const unsigned char* parameters, unsigned char numparameters)
+{
+    if (m_size + numparameters + 6 > Capacity)
+    {
+        errorlog << "DXPacketBuilder::addPacket(). The buffer is full." << endl;
+        return false;
+    }
+    unsigned char* packet = m_buffer + m_size;
+    packet[0] = DX117_START_BYTE;
+    packet[1] = DX117_START_BYTE;
+    packet[2] = id;
+    packet[3] = numparameters + 2;
+    packet[4] = instruction;
+    unsigned char checksum = id + packet[3] + instruction;
+    for (unsigned char i=0; i<numparameters; i++)
+    {
+        packet[5+i] = parameters[i];
+        checksum += parameters[i];          // it is OK if the checksum overflows, because it needs to be clipped to a single byte anyway
+    }
+    packet[5+numparameters] = ~checksum;
+    m_size += numparameters + 6;
+    m_num_packets++;
+    return true;
+}
+
+/*! @brief Starts a sync write. Every motor added with addSyncWrite() before the matching endSyncWrite()
+           will have the same registers written.
+    @param address the address of the first register to write
+    @param length the number of bytes to write to each motor
+ */
+void DXPacketBuilder::beginSyncWrite(unsigned char address, unsigned char length)
+{
+    if (m_in_sync_write)
+        endSyncWrite();
+    m_in_sync_write = true;
+    m_sync_address = address;
+    m_sync_length = length;
+    m_sync_start = -1;
+    m_sync_count = 0;
+}
+
+/*! @brief Adds a motor to the current sync write
+    @param id the id of the motor
+    @param data the m_sync_length bytes to write to the motor
+    @return false if there was no room for the motor
+ */
+bool DXPacketBuilder::addSyncWrite(unsigned char id, const unsigned char* data)
+{
+    if (not m_in_sync_write)
+        return false;
+
+    int entrylength = m_sync_length + 1;
+    if (m_sync_start >= 0 and (m_size - m_sync_start) + entrylength + 1 > MaxPacketLength)
+        closeSyncWrite();                   // the packet would be too long for the motors, so start another
+    if (m_sync_start < 0)
+    {
+        if (m_size + 7 + entrylength + 1 > Capacity)
+        {
+            errorlog << "DXPacketBuilder::addSyncWrite(). The buffer is full." << endl;
+            return false;
+        }
+        openSyncWrite();
+    }
+    else if (m_size + entrylength + 1 > Capacity)
+    {
+        errorlog << "DXPacketBuilder::addSyncWrite(). The buffer is full." << endl;
+        return false;
+    }
+
+    m_buffer[m_size++] = id;
+    for (unsigned char i=0; i<m_sync_length; i++)
+        m_buffer[m_size++] = data[i];
+    m_sync_count++;
+    return true;
+}
+
+/*! @brief Finishes the current sync write. Nothing is added to the buffer if no motors were added to it */
+void DXPacketBuilder::endSyncWrite()
+{
+    if (m_sync_start >= 0)
+        closeSyncWrite();
+    m_in_sync_write = false;
+}
+
+/*! @brief Returns the packets */
+const unsigned char* DXPacketBuilder::data() const
+{
+    return m_buffer;
+}
+
+/*! @brief Returns the number of bytes in the buffer */
+int DXPacketBuilder::size() const
+{
+    return m_size;
+}
+
+/*! @brief Returns the number of packets in the buffer */
+int DXPacketBuilder::getNumPackets() const
+{
+    return m_num_packets;
+}
+
+/*! @brief Writes the header of a new sync write packet */
+void DXPacketBuilder::openSyncWrite()
+{
+    m_sync_start = m_size;
+    m_sync_count = 0;
+    m_buffer[m_size++] = DX117_START_BYTE;
+    m_buffer[m_size++] = DX117_START_BYTE;
+    m_buffer[m_size++] = DX117_BROADCASTING_ID;
+    m_buffer[m_size++] = 0;                             // the length is filled in by closeSyncWrite()
+    m_buffer[m_size++] = DX117_SYNC_WRITE;
+    m_buffer[m_size++] = m_sync_address;
+    m_buffer[m_size++] = m_sync_length;
+}
+
+/*! @brief Fills in the length and appends the checksum of the open sync write packet */
+void DXPacketBuilder::closeSyncWrite()
+{
+    unsigned char* packet = m_buffer + m_sync_start;
+    packet[3] = m_sync_count*(m_sync_length + 1) + 4;
+    unsigned char checksum = 0;
+    for (int i=2; i<m_size - m_sync_start; i++)
+        checksum += packet[i];
+    m_buffer[m_size++] = ~checksum;
+    m_num_packets++;
+    m_sync_start = -1;
+    m_sync_count = 0;
+}
+
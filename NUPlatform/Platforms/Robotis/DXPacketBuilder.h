@@ -0,0 +1,68 @@
+/*! @file DXPacketBuilder.h
+    @brief Declaration of the DXPacketBuilder class
+
+    @class DXPacketBuilder
+    @brief Builds a buffer of Dynamixel instruction packets to be sent to a bus with a single write.
+
+    Individual packets are appended with addPacket(). Writes of the same registers to many motors are merged
+    into DX117_SYNC_WRITE packets with beginSyncWrite(), addSyncWrite() and endSyncWrite(). A sync write is
+    split into several packets if it would be longer than the motors' receive buffer.
+
+    Instruction packet format: 0xFF, 0xFF, ID, length, instruction, param1, ..., paramN, checksum
+    Sync write parameters: address, L, ID1, data1[L], ID2, data2[L], ...
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DXPACKETBUILDER_H
+#define DXPACKETBUILDER_H
+
+class DXPacketBuilder
+{
+public:
+    DXPacketBuilder();
+
+    void clear();
+    bool addPacket(unsigned char id, unsigned char instruction, const unsigned char* parameters, unsigned char numparameters);
+    void beginSyncWrite(unsigned char address, unsigned char length);
+    bool addSyncWrite(unsigned char id, const unsigned char* data);
+    void endSyncWrite();
+
+    const unsigned char* data() const;
+    int size() const;
+    int getNumPackets() const;
+public:
+    static const int MaxPacketLength = 143;         //!< the longest packet the motors can receive
+    static const int Capacity = 2048;               //!< the size of the buffer
+private:
+    void openSyncWrite();
+    void closeSyncWrite();
+private:
+    unsigned char m_buffer[Capacity];               //!< the packets
+    int m_size;                                     //!< the number of bytes in m_buffer
+    int m_num_packets;                              //!< the number of packets in m_buffer
+
+    bool m_in_sync_write;                           //!< true between beginSyncWrite() and endSyncWrite()
+    unsigned char m_sync_address;                   //!< the start address of the current sync write
+    unsigned char m_sync_length;                    //!< the number of bytes written to each motor in the current sync write
+    int m_sync_start;                               //!< the index of the header of the open sync write packet, or -1 if there is none
+    int m_sync_count;                               //!< the number of motors in the open sync write packet
+};
+
+#endif
+
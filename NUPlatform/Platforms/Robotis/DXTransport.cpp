@@ -0,0 +1,211 @@
+/*! @file DXTransport.cpp
+    @brief Implementation of the byte transports used to talk to a bus of Dynamixel motors
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DXTransport.h"
+
+#include "debug.h"
+#include "debugverbositynuplatform.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include <errno.h>
+using namespace std;
+
+/*! @brief Opens and configures a channel of the FTDI converter. The data is 8 bits, no parity and 1 stop bit,
+           the read and write timeouts are 1ms and the latency timer is 2ms.
+    @param device the index of the channel (0 for the lower body, 1 for the upper body)
+    @param baudrate the baud rate of the bus
+ */
+FTDITransport::FTDITransport(int device, int baudrate) : m_device(device), m_handle(0), m_open(false)
+{
+    #if DEBUG_NUPLATFORM_VERBOSITY > 0
+        debug << "FTDITransport::FTDITransport(" << device << ", " << baudrate << ")" << endl;
+    #endif
+    FT_STATUS status = FT_Open(device, &m_handle);
+    if (status != FT_OK)
+    {
+        errorlog << "FTDITransport::FTDITransport(). Unable to open channel " << device << endl;
+        return;
+    }
+    m_open = true;
+
+    if (FT_SetBaudRate(m_handle, baudrate) != FT_OK)
+        errorlog << "FTDITransport::FTDITransport(). Unable to set the baud rate of channel " << device << endl;
+    if (FT_SetDataCharacteristics(m_handle, FT_BITS_8, FT_STOP_BITS_1, FT_PARITY_NONE) != FT_OK)
+        errorlog << "FTDITransport::FTDITransport(). Unable to set the data characteristics of channel " << device << endl;
+    if (FT_SetTimeouts(m_handle, 1, 1) != FT_OK)
+        errorlog << "FTDITransport::FTDITransport(). Unable to set the timeouts of channel " << device << endl;
+    if (FT_SetLatencyTimer(m_handle, 2) != FT_OK)
+        errorlog << "FTDITransport::FTDITransport(). Unable to set the latency timer of channel " << device << endl;
+}
+
+/*! @brief Closes the channel */
+FTDITransport::~FTDITransport()
+{
+    if (m_open and FT_Close(m_handle) != FT_OK)
+        errorlog << "FTDITransport::~FTDITransport(). Failed to close channel " << m_device << endl;
+}
+
+int FTDITransport::write(const unsigned char* data, int length)
+{
+    DWORD bytessent = 0;
+    FT_STATUS status = FT_Write(m_handle, const_cast<unsigned char*>(data), length, &bytessent);
+    if (status != FT_OK)
+    {
+        debug << "FTDITransport::write(). FT_Write on channel " << m_device << " returned error code " << status << endl;
+        return -1;
+    }
+    return bytessent;
+}
+
+int FTDITransport::read(unsigned char* data, int length)
+{
+    if (length <= 0)
+        return 0;
+    DWORD bytesread = 0;
+    FT_STATUS status = FT_Read(m_handle, data, length, &bytesread);
+    if (status != FT_OK)
+    {
+        debug << "FTDITransport::read(). FT_Read on channel " << m_device << " returned error code " << status << endl;
+        return -1;
+    }
+    return bytesread;
+}
+
+int FTDITransport::available()
+{
+    DWORD numbytes = 0;
+    FT_STATUS status = FT_GetQueueStatus(m_handle, &numbytes);
+    if (status != FT_OK)
+    {
+        debug << "FTDITransport::available(). FT_GetQueueStatus on channel " << m_device << " returned error code " << status << endl;
+        return 0;
+    }
+    return numbytes;
+}
+
+bool FTDITransport::isOpen() const
+{
+    return m_open;
+}
+
+/*! @brief Returns the termios speed for a baud rate, or B0 if there isn't one */
+static speed_t baudRateToSpeed(int baudrate)
+{
+    switch (baudrate)
+    {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        #ifdef B1000000
+        case 1000000: return B1000000;
+        #endif
+        default: return B0;
+    }
+}
+
+/*! @brief Opens a serial device in raw, non-blocking mode. The data is 8 bits, no parity and 1 stop bit.
+    @param path the path to the device
+    @param baudrate the baud rate of the bus. This is ignored by a pseudo-terminal.
+ */
+PosixSerialTransport::PosixSerialTransport(const string& path, int baudrate) : m_path(path)
+{
+    #if DEBUG_NUPLATFORM_VERBOSITY > 0
+        debug << "PosixSerialTransport::PosixSerialTransport(" << path << ", " << baudrate << ")" << endl;
+    #endif
+    m_fd = open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (m_fd < 0)
+    {
+        errorlog << "PosixSerialTransport::PosixSerialTransport(). Unable to open " << path << " errno: " << errno << endl;
+        return;
+    }
+
+    termios options;
+    if (tcgetattr(m_fd, &options) == 0)
+    {
+        cfmakeraw(&options);
+        options.c_cflag |= CLOCAL | CREAD;
+        options.c_cflag &= ~(CSTOPB | PARENB);
+        speed_t speed = baudRateToSpeed(baudrate);
+        if (speed != B0)
+        {
+            cfsetispeed(&options, speed);
+            cfsetospeed(&options, speed);
+        }
+        options.c_cc[VMIN] = 0;
+        options.c_cc[VTIME] = 0;
+        if (tcsetattr(m_fd, TCSANOW, &options) != 0)
+            errorlog << "PosixSerialTransport::PosixSerialTransport(). Unable to configure " << path << endl;
+    }
+}
+
+/*! @brief Closes the serial device */
+PosixSerialTransport::~PosixSerialTransport()
+{
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+int PosixSerialTransport::write(const unsigned char* data, int length)
+{
+    int written = 0;
+    while (written < length)
+    {
+        int n = ::write(m_fd, data + written, length - written);
+        if (n < 0)
+        {
+            if (errno == EAGAIN or errno == EINTR)
+                continue;
+            debug << "PosixSerialTransport::write(). Write to " << m_path << " failed errno: " << errno << endl;
+            return -1;
+        }
+        written += n;
+    }
+    return written;
+}
+
+int PosixSerialTransport::read(unsigned char* data, int length)
+{
+    if (length <= 0)
+        return 0;
+    int n = ::read(m_fd, data, length);
+    if (n < 0)
+        return (errno == EAGAIN or errno == EINTR) ? 0 : -1;
+    return n;
+}
+
+int PosixSerialTransport::available()
+{
+    int numbytes = 0;
+    if (ioctl(m_fd, FIONREAD, &numbytes) != 0)
+        return 0;
+    return numbytes;
+}
+
+bool PosixSerialTransport::isOpen() const
+{
+    return m_fd >= 0;
+}
+
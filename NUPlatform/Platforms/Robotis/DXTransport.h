@@ -0,0 +1,94 @@
+/*! @file DXTransport.h
+    @brief Declaration of the byte transports used to talk to a bus of Dynamixel motors
+
+    @class DXTransport
+    @brief An abstract byte pipe to a single RS-485 bus of Dynamixel motors.
+
+    Motors and DXBusThread only ever talk to a bus through this interface, so the same protocol code can be run
+    against the real FTDI channels, a serial device (including one end of a pseudo-terminal), or the in-memory
+    DXEmulator.
+
+    @class FTDITransport
+    @brief A DXTransport over one channel of the FTDI USB to RS-485 converter, using libftd2xx
+
+    @class PosixSerialTransport
+    @brief A DXTransport over a POSIX serial device, such as /dev/ttyUSB0 or the slave end of a pseudo-terminal
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DXTRANSPORT_H
+#define DXTRANSPORT_H
+
+#include "ftd2xx.h"
+#include <string>
+
+class DXTransport
+{
+public:
+    virtual ~DXTransport() {};
+
+    /*! @brief Writes data to the bus
+        @param data the bytes to write
+        @param length the number of bytes to write
+        @return the number of bytes written, or -1 if the write failed */
+    virtual int write(const unsigned char* data, int length) = 0;
+    /*! @brief Reads up to length bytes that have already arrived from the bus. This does not block.
+        @param data the array to put the bytes in
+        @param length the maximum number of bytes to read
+        @return the number of bytes read, or -1 if the read failed */
+    virtual int read(unsigned char* data, int length) = 0;
+    /*! @brief Returns the number of bytes waiting to be read */
+    virtual int available() = 0;
+    /*! @brief Returns true if the transport was opened successfully */
+    virtual bool isOpen() const = 0;
+};
+
+class FTDITransport : public DXTransport
+{
+public:
+    FTDITransport(int device, int baudrate);
+    ~FTDITransport();
+
+    int write(const unsigned char* data, int length);
+    int read(unsigned char* data, int length);
+    int available();
+    bool isOpen() const;
+private:
+    int m_device;                   //!< the index of the FTDI channel
+    FT_HANDLE m_handle;             //!< the d2xx handle of the channel
+    bool m_open;                    //!< true if the channel was opened
+};
+
+class PosixSerialTransport : public DXTransport
+{
+public:
+    PosixSerialTransport(const std::string& path, int baudrate);
+    ~PosixSerialTransport();
+
+    int write(const unsigned char* data, int length);
+    int read(unsigned char* data, int length);
+    int available();
+    bool isOpen() const;
+private:
+    std::string m_path;             //!< the path to the serial device
+    int m_fd;                       //!< the file descriptor of the serial device, or -1 if it is not open
+};
+
+#endif
+
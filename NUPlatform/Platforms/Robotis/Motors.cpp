@@ -23,11 +23,14 @@
 #include "dx117.h"
 #include "Motors.h"
 #include "DXSerialThread.h"
+#include "DXBusThread.h"
 #include "NUPlatform/NUPlatform.h"
 
 #include "debug.h"
 #include "debugverbositynuplatform.h"
 
+#include <unistd.h>
+
 unsigned char* Motors::MotorIDToLowerBody = MotorConstants::e_MotorIDToLowerBody;
 unsigned char* Motors::IndexToMotorID = MotorConstants::e_IndexToMotorID;
 unsigned char* Motors::MotorIDToIndex = MotorConstants::e_MotorIDToIndex;
@@ -43,6 +46,9 @@ unsigned char* Motors::DefaultSlopes = MotorConstants::e_DefaultSlopes;
 unsigned char* Motors::DefaultMargins = MotorConstants::e_DefaultMargins;
 unsigned short* Motors::DefaultPunches = MotorConstants::e_DefaultPunches;
 
+DXTransport* Motors::LowerTransport = NULL;
+DXTransport* Motors::UpperTransport = NULL;
+
 // externally available feedback arrays
 long double JointTime = 0.0;
 long double PreviousJointTime = 0.0;
@@ -52,7 +58,7 @@ unsigned short JointLoads[MOTORS_NUM_MOTORS] =                 {000,  000,  000,
 
 /*! Create a serial link with the motors
  */
-Motors::Motors()
+Motors::Motors() : m_lower_bus(NULL), m_upper_bus(NULL)
 {  
     initSelf();
     initRequestMessages();
@@ -61,6 +67,9 @@ Motors::Motors()
     initControlTables();  //<-- I don't need to change this, however, occasionally the motor does resort back to 57k baud rate
     initSlopes();
     initMargins();
+    
+    m_lower_bus = new DXBusThread("DXLowerBusThread", m_lower_transport, 40);
+    m_upper_bus = new DXBusThread("DXUpperBusThread", m_upper_transport, 39);
 
     request();
     Platform->msleep(40);
@@ -78,7 +87,16 @@ Motors::Motors()
  */
 Motors::~Motors()
 {
+   #if DEBUG_NUPLATFORM_VERBOSITY > 0
+      for (unsigned char i=0; i<MOTORS_NUM_MOTORS; i++)
+      {
+         const DXMotorFeedback& feedback = getFeedback(Motors::IndexToMotorID[i]);
+         debug << "MOTORS: Motor " << (int)Motors::IndexToMotorID[i] << " requests: " << feedback.NumRequests << " lost: " << feedback.NumLost << " max latency: " << feedback.MaxLatency << "ms" << endl;
+      }
+   #endif
    delete m_thread;
+   delete m_lower_bus;
+   delete m_upper_bus;
    closeSerial();
 }
 
@@ -91,6 +109,39 @@ Motors* Motors::getInstance()
     return &instance;
 }
 
+/*! @brief Replaces the channels to the motors. This must be called before the first call to getInstance()
+    @param lower the channel to the lower body motors
+    @param upper the channel to the upper body motors
+ */
+void Motors::useTransports(DXTransport* lower, DXTransport* upper)
+{
+    LowerTransport = lower;
+    UpperTransport = upper;
+}
+
+/*! @brief Returns the latest feedback, and the reply statistics, of a motor
+    @param motorid the id of the motor
+ */
+const DXMotorFeedback& Motors::getFeedback(unsigned char motorid) const
+{
+    if (Motors::MotorIDToLowerBody[motorid])
+        return m_lower_feedback.getFeedback(motorid);
+    else
+        return m_upper_feedback.getFeedback(motorid);
+}
+
+/*! @brief Returns true if there has been no feedback from a motor in the last maxage ms
+    @param motorid the id of the motor
+    @param maxage the age in ms after which feedback is considered stale
+ */
+bool Motors::isFeedbackStale(unsigned char motorid, double maxage) const
+{
+    if (Motors::MotorIDToLowerBody[motorid])
+        return m_lower_feedback.isStale(motorid, getFeedbackTime(), maxage);
+    else
+        return m_upper_feedback.isStale(motorid, getFeedbackTime(), maxage);
+}
+
 /*! @brief Sets the external motion/sensor thread, so that its startLoop function is called everytime there is new sensor data
     @param thread a pointer to the sensemovethread
  */
@@ -117,6 +168,10 @@ void Motors::initSelf()
    // Initialise motor torques to off
    for (unsigned char i=0; i<MOTORS_NUM_MOTORS; i++)
       MotorTorqueOn[i] = false;
+   for (unsigned char i=0; i<MOTORS_NUM_MOTORS; i++)
+      m_feedback_sequence[i] = 0;
+   m_lower_control_ticket = 0;
+   m_upper_control_ticket = 0;
    return;
 }
 
@@ -129,14 +184,14 @@ void Motors::initSelf()
  
  The request messages are organised as follows:
     The lower and upper body motors are on separate channels, so the messages for each are separate
-    Each channel has the motors separated into blocks of 6 or less, each block of motors is sent requests with the same call to FT_Write, and the reply delays are staggered such that they reply at different times
+    Each channel has the motors separated into blocks of 6 or less, each block of motors is sent requests with the same write, and the reply delays are staggered such that they reply at different times
  
  Essentially, to use the messages
-   FT_Write(lowerbodymessage[0])
-   FT_Write(upperbodymessage[0])
+   write(lowerbodymessage[0])
+   write(upperbodymessage[0])
    wait for reply
-   FT_Write(lowerbodymessage[1])
-   FT_Write(upperbodymessage[1])
+   write(lowerbodymessage[1])
+   write(upperbodymessage[1])
    wait for reply
    etc...
  */
@@ -198,49 +253,23 @@ void Motors::initSerial()
       debug << "MOTORS: Initialising RS-485 dual channel comms to DX-117s." << endl;
    #endif
    
-   // Open
-   FT_STATUS status;
-   status = FT_Open(0, &lowerHandle);
-   if (status != FT_OK)
+   if (LowerTransport != NULL and UpperTransport != NULL)
+   {
+      m_lower_transport = LowerTransport;
+      m_upper_transport = UpperTransport;
+      m_owns_transports = false;
+   }
+   else
+   {
+      m_lower_transport = new FTDITransport(0, MOTORS_BAUD_RATE);
+      m_upper_transport = new FTDITransport(1, MOTORS_BAUD_RATE);
+      m_owns_transports = true;
+   }
+   
+   if (not m_lower_transport->isOpen())
       debug << "MOTORS: Unable to open lower body serial connection" << endl;
-
-   status = FT_Open(1, &upperHandle);
-   if (status != FT_OK)
+   if (not m_upper_transport->isOpen())
       debug << "MOTORS: Unable to open upper body serial connection" << endl;
-   
-   // Set Baud Rate
-   status = FT_SetBaudRate(lowerHandle, MOTORS_BAUD_RATE);
-   if (status != FT_OK)
-      debug << "MOTORS: Unable to set lower body serial baud rate" << endl;
-   
-   status = FT_SetBaudRate(upperHandle, MOTORS_BAUD_RATE);
-   if (status != FT_OK)
-      debug << "MOTORS: Unable to set upper body serial baud rate" << endl;
-   
-   // Set Data characteristics (8 bit bytes, no parity, 1 stop bit)
-   status = FT_SetDataCharacteristics(lowerHandle, FT_BITS_8, FT_STOP_BITS_1, FT_PARITY_NONE);
-   if (status != FT_OK)
-      debug << "MOTORS: Unable to set lower body serial data characteristics" << endl;
-   
-   status = FT_SetDataCharacteristics(upperHandle, FT_BITS_8, FT_STOP_BITS_1, FT_PARITY_NONE);
-   if (status != FT_OK)
-      debug << "MOTORS: Unable to set upper body serial data characteristics" << endl;
-   
-   // Set timeouts
-   status = FT_SetTimeouts(lowerHandle, 1, 1);
-   if (status != FT_OK)
-      debug << "MOTORS: Unable to set lower body serial timeouts" << endl;
-   
-   status = FT_SetTimeouts(upperHandle, 1, 1);
-   if (status != FT_OK)
-      debug << "MOTORS: Unable to set upper body serial timeouts" << endl;
-   
-   status = FT_SetLatencyTimer(lowerHandle, 2);
-   if (status != FT_OK)
-      debug << "MOTORS: Unable to set lower latency timer" << endl;
-   status = FT_SetLatencyTimer(upperHandle, 2);
-   if (status != FT_OK)
-      debug << "MOTORS: Unable to set upper latency timer" << endl;
 }
 
 /* Initialise the motor return delays (ie. the delay between receiving a request for data, and the motor replying)
@@ -284,7 +313,7 @@ void Motors::initControlTables()
    unsigned char readdata[4096];
    unsigned short numbytes = 0;
    sleep(1);
-   readQueue(lowerHandle, readdata, 4096);
+   readQueue(m_lower_transport, readdata, 4096);
    
    // for each motor read the control table
    unsigned char data[] = {P_ID, 16};           // read 16 bytes starting from P_ID
@@ -294,7 +323,7 @@ void Motors::initControlTables()
    }
    // now I need to wait and then read the buffer
    sleep(1);
-   numbytes = readQueue(lowerHandle, readdata, 4096);
+   numbytes = readQueue(m_lower_transport, readdata, 4096);
    
    /* DX117 Reply Packet Format:
     0xFF, 0xFF, ID, length, error, para1, para2, ..., para(length-2), checksum
@@ -441,14 +470,13 @@ void Motors::initPunches()
  */
 void Motors::closeSerial()
 {
-   FT_STATUS status;
-   status = FT_Close(lowerHandle);
-   if (status != FT_OK)
-      debug << "MOTORS: Failed to close lower body serial connection" << endl;
-   
-   status = FT_Close(upperHandle);
-   if (status != FT_OK)
-      debug << "MOTORS: Failed to close lower body serial connection" << endl;
+   if (m_owns_transports)
+   {
+      delete m_lower_transport;
+      delete m_upper_transport;
+   }
+   m_lower_transport = NULL;
+   m_upper_transport = NULL;
 }
 
 /*! @brief Gets the current motor targets in motor units (to be consistent with the rest of the interface)
@@ -652,25 +680,11 @@ bool Motors::write(unsigned char motorid[], unsigned char nummotors, unsigned ch
    
    appendPacketsToBuffer(motorid, nummotors, command, data, datalength, lowermessagebuffer, uppermessagebuffer, &lowerindex, &upperindex);
    
-   FT_STATUS status;
-   DWORD bytessentlower, bytessentupper;
-
-   status = FT_Write(lowerHandle, lowermessagebuffer, lowerindex, &bytessentlower);
-   status += FT_Write(upperHandle, uppermessagebuffer, upperindex, &bytessentupper);
-   
-   // error checking
-   if (status != FT_OK)
-   {
-      debug << "MOTORS: write(motorid[]) failed with FT_Write returning sum of error codes " << status << endl;
-      return false;
-   }
-   if (bytessentlower+bytessentupper != lowerindex+upperindex) 
-   {
-      debug << "MOTORS: write(motorid[]) failed to write all the data; only " << bytessentlower+bytessentupper << " bytes were written, instead of " << lowerindex+upperindex;
-      return false;
-   }
-   
-   return true;
+   bool success = writeToBus(m_lower_transport, lowermessagebuffer, lowerindex);
+   success &= writeToBus(m_upper_transport, uppermessagebuffer, upperindex);
+   if (not success)
+      debug << "MOTORS: write(motorid[]) failed to write all the data" << endl;
+   return success;
 }
 
 /* Writes an instruction packet to the motors
@@ -700,31 +714,20 @@ bool Motors::write(unsigned char motorid, unsigned char command, unsigned char d
    
    appendPacketToBuffer(motorid, command, data, datalength, messagebuffer, &messagelength);
    
-   FT_STATUS status;
-   DWORD bytessent;
-   FT_HANDLE fthandle;
+   bool success;
    if (motorid == DX117_BROADCASTING_ID)
    {
-      status = FT_Write(lowerHandle, messagebuffer, messagelength, &bytessent);
-      status += FT_Write(upperHandle, messagebuffer, messagelength, &bytessent);
+      success = writeToBus(m_lower_transport, messagebuffer, messagelength);
+      success &= writeToBus(m_upper_transport, messagebuffer, messagelength);
    }
+   else if (Motors::MotorIDToLowerBody[motorid])
+      success = writeToBus(m_lower_transport, messagebuffer, messagelength);
    else
-   {
-      if (Motors::MotorIDToLowerBody[motorid])
-         fthandle = lowerHandle;
-      else
-         fthandle = upperHandle;
-      status = FT_Write(fthandle, messagebuffer, messagelength, &bytessent);
-   }
+      success = writeToBus(m_upper_transport, messagebuffer, messagelength);
    
-   if (status != FT_OK)
-   {
-      debug << "MOTORS: write failed with FT_Write returning error code " << status << endl;
-      return false;
-   }
-   if (bytessent != messagelength) 
+   if (not success)
    {
-      debug << "MOTORS: write failed to write all the data; only " << bytessent << " bytes were written, instead of " << messagelength;
+      debug << "MOTORS: write failed to write all the data" << endl;
       return false;
    }
    
@@ -758,25 +761,11 @@ bool Motors::write(unsigned char command, unsigned char data[MOTORS_NUM_MOTORS][
    
    appendPacketsToBuffer(command, data, lowermessagebuffer, uppermessagebuffer, &lowerindex, &upperindex);
    
-   FT_STATUS status;
-   DWORD bytessentlower, bytessentupper;
-   
-   status = FT_Write(lowerHandle, lowermessagebuffer, lowerindex, &bytessentlower);
-   status += FT_Write(upperHandle, uppermessagebuffer, upperindex, &bytessentupper);
-   
-   // error checking
-   if (status != FT_OK)
-   {
-      debug << "MOTORS: write(motorid[]) failed with FT_Write returning sum of error codes " << status << endl;
-      return false;
-   }
-   if (bytessentlower+bytessentupper != lowerindex+upperindex) 
-   {
-      debug << "MOTORS: write(motorid[]) failed to write all the data; only " << bytessentlower+bytessentupper << " bytes were written, instead of " << lowerindex+upperindex;
-      return false;
-   }
-   
-   return true;
+   bool success = writeToBus(m_lower_transport, lowermessagebuffer, lowerindex);
+   success &= writeToBus(m_upper_transport, uppermessagebuffer, upperindex);
+   if (not success)
+      debug << "MOTORS: write(command) failed to write all the data" << endl;
+   return success;
 }
 
 /* Append the control packets (MotorControls) to the lower and upper message buffers
@@ -977,20 +966,11 @@ bool Motors::broadcast(unsigned char command, unsigned char data[], unsigned sho
       checksum += messagebuffer[i];          // it is OK if the checksum overflows, because it needs to be clipped to a single byte anyway
    messagebuffer[messagelength-1] = ~checksum;
    
-   FT_STATUS status;
-   DWORD bytessent;
-   
-   status = FT_Write(lowerHandle, messagebuffer, messagelength, &bytessent);
-   status = FT_Write(upperHandle, messagebuffer, messagelength, &bytessent);
-   
-   if (status != FT_OK)
-   {
-      debug << "MOTORS: broadcast failed with FT_Write returning error code " << status << endl;
-      return false;
-   }
-   if (bytessent != messagelength) 
+   bool success = writeToBus(m_lower_transport, messagebuffer, messagelength);
+   success &= writeToBus(m_upper_transport, messagebuffer, messagelength);
+   if (not success)
    {
-      debug << "MOTORS: broadcast failed to write all the data; only " << bytessent << " bytes were written, instead of " << messagelength;
+      debug << "MOTORS: broadcast failed to write all the data" << endl;
       return false;
    }
    
@@ -1005,120 +985,131 @@ bool Motors::broadcast(unsigned char command, unsigned char data[], unsigned sho
    return true;
 }
 
+/* Writes a buffer to a channel. If the channel's DXBusThread has been started the write is done by it, and this
+ function waits for it to complete, otherwise the write is done directly.
+ @param transport: the channel to write to
+ @param data: the bytes to write
+ @param length: the number of bytes to write
+ 
+ @return true if all of the bytes were written
+ */
+bool Motors::writeToBus(DXTransport* transport, const unsigned char* data, unsigned short length)
+{
+   if (length == 0)
+      return true;
+   
+   DXBusThread* bus = NULL;
+   if (m_lower_bus != NULL and transport == m_lower_bus->getTransport())
+      bus = m_lower_bus;
+   else if (m_upper_bus != NULL and transport == m_upper_bus->getTransport())
+      bus = m_upper_bus;
+   
+   if (bus == NULL)
+      return transport->write(data, length) == length;
+   
+   unsigned int numfailures = bus->getNumFailures();
+   bus->wait(bus->submit(data, length));
+   return bus->getNumFailures() == numfailures;
+}
+
 /*! Sends MotorControls[][] to the motors (ie. control to motors, every motor that has MotorTorqueOn[i] == true, will get the controls in MotorControls[i][])
  To control the motors:
    updateControls(newpositions, newspeeds)
    write()        <--- this function
+ 
+ The controls are sent as three SYNC_WRITE packets to each channel; one for the positions and speeds, one for the punches,
+ and one to turn off the torque of the motors that are off. The positions and punches can not be put in the same
+ SYNC_WRITE because they are not next to each other in the control table. The packets are handed to the bus threads, and
+ this function does not wait for them to be written.
  */
 bool Motors::write()
 {
-   unsigned char lowermessagebuffer[MOTORS_NUM_MOTORS*MAX_MESSAGE_LENGTH];
-   unsigned short lowerindex = 0;
-   unsigned char uppermessagebuffer[MOTORS_NUM_MOTORS*MAX_MESSAGE_LENGTH];
-   unsigned short upperindex = 0;
-   
-   appendControlPacketsToBuffer(lowermessagebuffer, uppermessagebuffer, &lowerindex, &upperindex);
-      
-   FT_STATUS status;
-   DWORD bytessentlower, bytessentupper;
-   
-   // I want this function to be as fast as fast can be, so it is 'hard-coded' and threaded
-   pthread_t lowerthread, upperthread;
+   // the previous controls need to have been sent before the buffers can be reused
+   m_lower_bus->wait(m_lower_control_ticket);
+   m_upper_bus->wait(m_upper_control_ticket);
+   m_lower_controls.clear();
+   m_upper_controls.clear();
    
-   // ----------------------------- status = FT_Write(lowerHandle, lowermessagebuffer, lowerindex, &bytessentlower);
-   ThreadLowerWrite.Handle = lowerHandle;
-   ThreadLowerWrite.Buffer = lowermessagebuffer;
-   ThreadLowerWrite.BufferLength = lowerindex;
-   
-   // create the lower thread, and set its priority
-   int err = pthread_create(&lowerthread, NULL, runThreadedWrite, (void*) &ThreadLowerWrite);
-   sched_param param;
-   param.sched_priority = 40;
-   pthread_setschedparam(lowerthread, SCHED_FIFO, &param);
-   
-   // ----------------------------- status += FT_Write(upperHandle, uppermessagebuffer, upperindex, &bytessentupper);
-   ThreadUpperWrite.Handle = upperHandle;
-   ThreadUpperWrite.Buffer = uppermessagebuffer;
-   ThreadUpperWrite.BufferLength = upperindex;
-   
-   // create the lower thread, and set its priority
-   err = pthread_create(&upperthread, NULL, runThreadedWrite, (void*) &ThreadUpperWrite);
-   param.sched_priority = 39;
-   pthread_setschedparam(upperthread, SCHED_FIFO, &param);
-   
-   pthread_join(lowerthread, NULL);
-   pthread_join(upperthread, NULL);
+   m_lower_controls.beginSyncWrite(P_GOAL_POSITION_L, MOTORS_NUM_CONTROLS - 1);
+   m_upper_controls.beginSyncWrite(P_GOAL_POSITION_L, MOTORS_NUM_CONTROLS - 1);
+   for (unsigned char i=0; i<MOTORS_NUM_MOTORS; i++)
+   {
+      if (MotorTorqueOn[i])
+      {
+         unsigned char id = Motors::IndexToMotorID[i];
+         DXPacketBuilder& controls = Motors::MotorIDToLowerBody[id] ? m_lower_controls : m_upper_controls;
+         controls.addSyncWrite(id, &MotorControls[i][1]);
+      }
+   }
+   m_lower_controls.beginSyncWrite(P_PUNCH_L, MOTORS_NUM_PUNCHES - 1);
+   m_upper_controls.beginSyncWrite(P_PUNCH_L, MOTORS_NUM_PUNCHES - 1);
+   for (unsigned char i=0; i<MOTORS_NUM_MOTORS; i++)
+   {
+      if (MotorTorqueOn[i])
+      {
+         unsigned char id = Motors::IndexToMotorID[i];
+         DXPacketBuilder& controls = Motors::MotorIDToLowerBody[id] ? m_lower_controls : m_upper_controls;
+         controls.addSyncWrite(id, &MotorPunches[i][1]);
+      }
+   }
+   static const unsigned char torqueoff = DX117_TORQUE_OFF;
+   m_lower_controls.beginSyncWrite(P_TORQUE_ENABLE, 1);
+   m_upper_controls.beginSyncWrite(P_TORQUE_ENABLE, 1);
+   for (unsigned char i=0; i<MOTORS_NUM_MOTORS; i++)
+   {
+      if (not MotorTorqueOn[i])
+      {
+         unsigned char id = Motors::IndexToMotorID[i];
+         DXPacketBuilder& controls = Motors::MotorIDToLowerBody[id] ? m_lower_controls : m_upper_controls;
+         controls.addSyncWrite(id, &torqueoff);
+      }
+   }
+   m_lower_controls.endSyncWrite();
+   m_upper_controls.endSyncWrite();
    
+   if (m_lower_controls.size() > 0)
+      m_lower_control_ticket = m_lower_bus->submit(m_lower_controls.data(), m_lower_controls.size());
+   if (m_upper_controls.size() > 0)
+      m_upper_control_ticket = m_upper_bus->submit(m_upper_controls.data(), m_upper_controls.size());
    return true;
 }
 
 /*! Request new feedback from the data;  A request packet is sent to each motor all nicely timed so that the replies will appear in the read buffer some time later ;)
  
- Note. This function can take sometime to return (4ms or so)
+ The request blocks are handed to the bus threads, which wait 2ms after each block, so this function returns immediately.
+ The replies can be read once the bus threads are idle, which read() waits for.
  */
 bool Motors::request()
 {
-    FT_STATUS status;
-    DWORD bytessentlower, bytessentupper;
+    double time = getFeedbackTime();
+    for (unsigned char i=0; i<MOTORS_NUM_LOWER_MOTORS; i++)
+        m_lower_feedback.markRequested(Motors::LowerBodyIndexToMotorID[i], time);
+    for (unsigned char i=0; i<MOTORS_NUM_UPPER_MOTORS; i++)
+        m_upper_feedback.markRequested(Motors::UpperBodyIndexToMotorID[i], time);
     
-    pthread_t lowerthread, upperthread;
-    sched_param lowerparam, upperparam;
-    lowerparam.sched_priority = 40;
-    upperparam.sched_priority = 39;
-    
-    unsigned char numblocks = max(MOTORS_NUM_LOWER_REQUEST_BLOCKS, MOTORS_NUM_UPPER_REQUEST_BLOCKS);
-    ThreadLowerWrite.Handle = lowerHandle;
-    ThreadUpperWrite.Handle = upperHandle;
-    for (unsigned char i=0; i<numblocks; i++)
-    {
-        // lower motors
-        ThreadLowerWrite.Buffer = MotorRequestsLower[i];
-        ThreadLowerWrite.BufferLength = MotorRequestsLowerLength[i];
-        pthread_create(&lowerthread, NULL, runThreadedWrite, (void*) &ThreadLowerWrite);
-        pthread_setschedparam(lowerthread, SCHED_FIFO, &lowerparam);
-        // upper motors
-        ThreadUpperWrite.Buffer = MotorRequestsUpper[i];
-        ThreadUpperWrite.BufferLength = MotorRequestsUpperLength[i];
-        pthread_create(&upperthread, NULL, runThreadedWrite, (void*) &ThreadUpperWrite);
-        pthread_setschedparam(upperthread, SCHED_FIFO, &upperparam);
-        
-        // wait for the threads to complete
-        pthread_join(lowerthread, NULL);
-        pthread_join(upperthread, NULL);
-        
-        // sleep for a little while
-        struct timespec nextRunTime;                    // The absolute time for the main thread to be executed
-        clock_gettime(CLOCK_REALTIME, &nextRunTime);    // Initialise the next run time to be now
-        // calculation of next run time
-        nextRunTime.tv_nsec += 1e9*2e-3;
-        if (nextRunTime.tv_nsec > 1e9)              // we need to be careful with the nanosecond clock overflowing...
-        {
-            nextRunTime.tv_sec += 1;
-            nextRunTime.tv_nsec -= 1e9;
-        }
-        clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &nextRunTime, NULL);
-    }
+    for (unsigned char i=0; i<MOTORS_NUM_LOWER_REQUEST_BLOCKS; i++)
+        m_lower_bus->submit(MotorRequestsLower[i], MotorRequestsLowerLength[i], 2000);
+    for (unsigned char i=0; i<MOTORS_NUM_UPPER_REQUEST_BLOCKS; i++)
+        m_upper_bus->submit(MotorRequestsUpper[i], MotorRequestsUpperLength[i], 2000);
     return true;
 }
 
-/* Read numbytes of data on ftHandle and put it into data[]
- @param fthandle: the handle of the d2xx channel
+/* Read numbytes of data on transport and put it into data[]
+ @param transport: the channel
  @param data[]: the array that is going to get the read data (make sure it is big enough)
  @param numbytestoread: the number of bytes to read
  
  @return returns true if the correct number of bytes have been read, returns false if it was less
  */
-bool Motors::read(FT_HANDLE fthandle, unsigned char data[], unsigned short numbytestoread)
+bool Motors::read(DXTransport* transport, unsigned char data[], unsigned short numbytestoread)
 {
    #if DEBUG_NUPLATFORM_VERBOSITY > 0
       debug << "MOTORS: Reading buffer:" << endl;
    #endif
-   FT_STATUS status;
-   DWORD numbytesread;
-   status = FT_Read(fthandle, data, numbytestoread, &numbytesread);
-   if (status != FT_OK)
+   int numbytesread = transport->read(data, numbytestoread);
+   if (numbytesread < 0)
    {
-      debug << "MOTORS: read failed with FT_READ error code: " << status << endl;
+      debug << "MOTORS: read failed" << endl;
       return false;
    }
    
@@ -1137,105 +1128,84 @@ bool Motors::read(FT_HANDLE fthandle, unsigned char data[], unsigned short numby
    return true;
 }
 
-/* Return the number of bytes waiting in the d2xx buffer
+/* Return the number of bytes waiting in the channel's buffer
  */
-unsigned short Motors::getNumBytesInQueue(FT_HANDLE fthandle)
+unsigned short Motors::getNumBytesInQueue(DXTransport* transport)
 {
-   DWORD numbytes;
-   FT_STATUS status = FT_GetQueueStatus(fthandle, &numbytes);
-   if (status != FT_OK)
+   int numbytes = transport->available();
+   if (numbytes < 0)
    {
-      debug << "MOTORS: getNumBytesInQueue failed to get the number of bytes in the queue; error code " << status;
+      debug << "MOTORS: getNumBytesInQueue failed to get the number of bytes in the queue" << endl;
       return 0;
    }
    return numbytes;
 }
 
-/* Read upto maxdatalength bytes on fthandle into data
- @param fthandle: the handle to the d2xx channel
+/* Read upto maxdatalength bytes on transport into data
+ @param transport: the channel
  @param data[]: the array to get the data (make sure it is at least maxdatalength long)
  @param maxdatalength: the maximum number of bytes to read
  
  @return the number of bytes in the queue that were read
  */
-unsigned short Motors::readQueue(FT_HANDLE fthandle, unsigned char data[], unsigned short maxdatalength)
+unsigned short Motors::readQueue(DXTransport* transport, unsigned char data[], unsigned short maxdatalength)
 {
    //debug << "MOTORS: readQueue" << endl;
-   unsigned short numbytesinqueue = getNumBytesInQueue(fthandle);
+   unsigned short numbytesinqueue = getNumBytesInQueue(transport);
    if (numbytesinqueue > maxdatalength)
       numbytesinqueue = maxdatalength;
-   read(fthandle, data, numbytesinqueue);
+   read(transport, data, numbytesinqueue);
    return numbytesinqueue;
 }
 
-/* Unpack the contents of readdata and copy the results into the global feedback arrays
+/* Pass the contents of readdata to a channel's parser, and copy the channel's motors with new feedback into the global feedback arrays
  
- This function scans through readdata looking for valid packets (need to have a valid header and checksum, if not the packet is discarded).
- When a valid packet is found the id is used to update jointPositions[id], jointSpeeds[id], jointLoads[id]
+ The parser keeps any partial packet at the end of readdata until the rest of it arrives in the next read. Only the motors
+ on the channel are looked at, because the parser of the other channel has no feedback for them.
+ @param parser: the parser for the channel readdata was read from
+ @param motorids[]: the ids of the motors on the channel
+ @param nummotors: the length of motorids[]
  @param readdata[]: the data to be used to update the feedback arrays
  @param numbytes: the length of readdata[]
+ @param time: the time the data was read
  
  @return the number of successfully updated motors
  */
-unsigned char Motors::updateFeedbackData(unsigned char readdata[], unsigned short numbytes)
+unsigned char Motors::updateFeedbackData(DXFeedbackParser& parser, const unsigned char motorids[], unsigned char nummotors, unsigned char readdata[], unsigned short numbytes, double time)
 {
-   // debug << "MOTORS: UpdateFeedbackData" << numbytes << endl;
+   if (parser.push(readdata, numbytes, time) == 0)
+      return 0;
    
-   /* DX117 Reply Packet Format:
-    0xFF, 0xFF, ID, length, error, para1, para2, ..., para(length-2), checksum
-    */
-   unsigned short index = 0;
-   unsigned char id, length, error, checksum, calculatedchecksum;
-   unsigned char packetdata[MAX_MESSAGE_LENGTH];                          // [parm0, parm1, ... , parmN];
-   unsigned short numupdates = 0;
-   // scan through and find the first header
-   while (index < numbytes)
+   unsigned char numupdates = 0;
+   for (unsigned char j=0; j<nummotors; j++)
    {
-      if(findHeader(readdata, numbytes, &index))
+      unsigned char id = motorids[j];
+      unsigned char i = Motors::MotorIDToIndex[id];
+      const DXMotorFeedback& feedback = parser.getFeedback(id);
+      if (feedback.Sequence != m_feedback_sequence[i])
       {
-         // debug << "MOTORS: scanData: header end at index: " << index << endl;
-         if (index + 2 < numbytes)
-         {
-            index++;
-            id = readdata[index];
-            index++;
-            length = readdata[index];
-         }
-         // debug << "MOTORS: scanData: id: " << (int)id << " length: " << (int)length << endl;
-         if (length < MAX_MESSAGE_LENGTH)
-         {
-            if (index + length < numbytes)
-            {
-               index++;
-               error = readdata[index];
-               index++;
-               calculatedchecksum = id + length + error;
-               for (unsigned char i=0; i<length-2; i++)
-               {
-                  packetdata[i] = readdata[index + i];
-                  calculatedchecksum += packetdata[i];
-               }
-               index += length - 2;
-               checksum = readdata[index];
-               calculatedchecksum = ~calculatedchecksum;
-            
-               if ((calculatedchecksum == checksum) && ((length - 2) == NUM_FEEDBACK_MOTOR) && id < MOTORS_MAX_ID && id > MOTORS_MIN_ID)
-               {
-                  if (error > 0)
-                     debug << "MOTORS: Motor " << (int)id << " has error " << (int)error << ", you should look into it ;)" << endl;
-                  int index = MotorIDToIndex[id];
-                  JointPositions[index] = ((packetdata[1] & 0x3) << 8) + packetdata[0];
-                  JointSpeeds[index] = ((packetdata[3] & 0x3) << 8) + packetdata[2];
-                  JointLoads[index] = ((packetdata[5] & 0x3) << 8) + packetdata[4];
-                  numupdates++;
-               }
-            }
-         }
+         if (feedback.Error > 0)
+            debug << "MOTORS: Motor " << (int)id << " has error " << (int)feedback.Error << ", you should look into it ;)" << endl;
+         JointPositions[i] = feedback.Position;
+         JointSpeeds[i] = feedback.Speed;
+         JointLoads[i] = feedback.Load;
+         m_feedback_sequence[i] = feedback.Sequence;
+         numupdates++;
       }
    }
    return numupdates;
 }
 
+/* Returns the time in ms used to timestamp the feedback. The monotonic clock is used so that the latencies are not
+ affected by changes to the system time.
+ */
+double Motors::getFeedbackTime()
+{
+   struct timespec time;
+   clock_gettime(CLOCK_MONOTONIC, &time);
+   return time.tv_nsec/1e6 + time.tv_sec*1e3;
+}
+
 /* Scans through readdata looking for a header. If one is found true is return and index is left at the second start byte.
  So accessing the motorid of the packet can be done with readdata[index+1] etc
  @param readdata[]: the data read from the serial port
@@ -1266,31 +1236,19 @@ bool Motors::read()
    unsigned char data[4096];
    unsigned short bytesread;
    
+   // the replies to the last request() are only complete once the request blocks have been written
+   m_lower_bus->waitForIdle();
+   m_upper_bus->waitForIdle();
+   
    struct timespec time;
    clock_gettime(CLOCK_REALTIME, &time);
    JointTime = (time.tv_nsec/1e6 + time.tv_sec*1e3) - StartTime;
    
-   bytesread = readQueue(lowerHandle, data, 4096);
-   updateFeedbackData(data, bytesread);
-   bytesread = readQueue(upperHandle, data, 4096);
-   updateFeedbackData(data, bytesread);
+   double feedbacktime = getFeedbackTime();
+   bytesread = readQueue(m_lower_transport, data, 4096);
+   updateFeedbackData(m_lower_feedback, Motors::LowerBodyIndexToMotorID, MOTORS_NUM_LOWER_MOTORS, data, bytesread, feedbacktime);
+   bytesread = readQueue(m_upper_transport, data, 4096);
+   updateFeedbackData(m_upper_feedback, Motors::UpperBodyIndexToMotorID, MOTORS_NUM_UPPER_MOTORS, data, bytesread, feedbacktime);
    return true;
 }
 
-/* Threaded write to a motor serial channel. The structure passed as an arguement contains all of the data necessary to perform the write
- This is not a class function because it is too hard to create a thread using a class member.
- 
- @param arg threaddata_t where arg->Handle, arg->Buffer and arg->BufferLength contain the relavent data
- */
-void* runThreadedWrite(void *arg)
-{
-   threaddata_t* data = (threaddata_t*) arg; 
-   
-   DWORD bytessent;
-   FT_STATUS status = FT_Write(data->Handle, data->Buffer, data->BufferLength, &bytessent);
-   pthread_exit(NULL);
-}
-
-
-
-
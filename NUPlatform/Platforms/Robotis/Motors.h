@@ -5,16 +5,23 @@
     @brief A serial communication class with the servo motors in the bear
  
     The serial communication for channel 0 and 1 is done in parallel, and much of the serial
-    packet contents are cached. 
+    packet contents are cached. Each channel has a DXTransport, and a long-lived DXBusThread which does the
+    writes to it, so no threads are created while the robot is running.
  
     Serial writes are straight forward all of the data is added to two binary buffers and then written to each channel.
     Only a single function call is required 'write()' which copies everything stored in MotorControls and MotorPunches 
-    to the servo motors.
+    to the servo motors. The controls are sent as SYNC_WRITE packets, one for the positions and speeds, one for the
+    punches and one to turn off the motors that are not being controlled, instead of a packet for each motor.
  
     Serial reads require two steps. The first step is to request the new sensor data with 'request()', the second step
     is to copy it from the usb buffer to the global sensor arrays with 'read()'. The request() is a little tricky
     because it relys on staggering the return delays of blocks of motors so that multiple motors can reply at once.
-    Thus, call request() then sometime later data will be available to read()
+    Thus, call request() then sometime later data will be available to read(). The replies are framed by a
+    DXFeedbackParser on each channel, so a reply split between two reads is kept, and the latest feedback,
+    along with the packet loss and latency of each motor, is available from getFeedback().
+ 
+    The channels can be replaced with useTransports() before the first call to getInstance(), for example with a
+    DXEmulator or a PosixSerialTransport connected to a pseudo terminal, so this class can be run without the robot.
  
     MOTORS_NUM_MOTORS specifies the number of degrees of freedom of the robot.
     MOTORS_NUM_LOWER_MOTORS specifies the number of degrees of freedom on channel 0
@@ -22,9 +29,8 @@
  
     This class is very old, and not very flexible. The following areas could be improved:
         - It should be updated to use stl vectors so that the number of motors doesn't need to be hard coded. 
-        - It should also be updated to use the new libftdi (instead of libftd2xx). 
+        - It should also be updated to use the new libftdi (instead of libftd2xx); that only needs another DXTransport.
         - It should be updated to not use global variables to store the sensor data.
-        - The threading does need to have quite so much copypasta
 
     @author Jason Kulk
  
@@ -48,6 +54,7 @@
 #define MOTORS_H
 
 class DXSerialThread;
+class DXBusThread;
 class ConditionalThread;
 
 #include "targetconfig.h"
@@ -57,7 +64,9 @@ class ConditionalThread;
     #include "../Cycloid/MotorConstants.h"
 #endif
 
-#include "ftd2xx.h"
+#include "DXTransport.h"
+#include "DXPacketBuilder.h"
+#include "DXFeedbackParser.h"
 #include <vector>
 #include <iostream>
 #include <fstream>
@@ -77,18 +86,11 @@ extern unsigned short JointPositions[MOTORS_NUM_MOTORS];
 extern unsigned short JointSpeeds[MOTORS_NUM_MOTORS];
 extern unsigned short JointLoads[MOTORS_NUM_MOTORS];
 
-// This structure's sole purpose is to store data required for a threaded write
-struct threaddata_t
-{
-   FT_HANDLE Handle;                // the handle to buffer will be written to
-   unsigned char* Buffer;           // pointer to the buffer containing the data
-   unsigned short BufferLength;     // the number of bytes in the buffer
-};
-
 class Motors
 {
    public:
       static Motors* getInstance();
+      static void useTransports(DXTransport* lower, DXTransport* upper);
       void setSensorThread(ConditionalThread* thread);
       void updateControl(unsigned char motorid, unsigned short position, unsigned short speed, unsigned short punch);
       void updateControls(unsigned char motorid[], unsigned char nummotors, unsigned short positions[], unsigned short speeds[], unsigned short punches[]);
@@ -97,6 +99,8 @@ class Motors
       bool request();                                                                     // request for feedback data
       bool read();                                                                        // read feedback data and put it into global feedback arrays
     
+      const DXMotorFeedback& getFeedback(unsigned char motorid) const;
+      bool isFeedbackStale(unsigned char motorid, double maxage) const;
       void getTargets(vector<float>& targets);
       void getStiffnesses(vector<float>& stiffnesses);
     
@@ -132,6 +136,7 @@ class Motors
       bool write(unsigned char motorid[], unsigned char nummotors, unsigned char command, unsigned char* data[], unsigned char datalength);
       bool write(unsigned char command, unsigned char data[MOTORS_NUM_MOTORS][MOTORS_NUM_CONTROLS]);
       bool broadcast(unsigned char command, unsigned char data[], unsigned short datalength);
+      bool writeToBus(DXTransport* transport, const unsigned char* data, unsigned short length);
    
       void appendPacketToBuffer(unsigned char motorid, unsigned char command, unsigned char data[], unsigned char datalength, unsigned char messagebuffer[], unsigned short* currentbufferindex);
       void appendPacketsToBuffer(unsigned char motorid[], unsigned char nummotors, unsigned char command, unsigned char* data[], unsigned char datalength, unsigned char lowermessagebuffer[], unsigned char uppermessagebuffer[], unsigned short* lowerindex, unsigned short* upperindex);
@@ -140,10 +145,11 @@ class Motors
       void appendControlPacketsToBuffer(unsigned char lowermessagebuffer[], unsigned char uppermessagebuffer[], unsigned short* lowerindex, unsigned short* upperindex);
    
       // Serial Reading
-      unsigned short getNumBytesInQueue(FT_HANDLE fthandle);
-      bool read(FT_HANDLE fthandle, unsigned char data[], unsigned short numbytestoread);
-      unsigned short readQueue(FT_HANDLE fthandle, unsigned char data[], unsigned short maxdatalength);
-      unsigned char updateFeedbackData(unsigned char readdata[], unsigned short numbytes);
+      unsigned short getNumBytesInQueue(DXTransport* transport);
+      bool read(DXTransport* transport, unsigned char data[], unsigned short numbytestoread);
+      unsigned short readQueue(DXTransport* transport, unsigned char data[], unsigned short maxdatalength);
+      unsigned char updateFeedbackData(DXFeedbackParser& parser, const unsigned char motorids[], unsigned char nummotors, unsigned char readdata[], unsigned short numbytes, double time);
+      static double getFeedbackTime();
       bool findHeader(unsigned char readdata[], unsigned short numbytes, unsigned short* index);
    
    public:
@@ -162,8 +168,14 @@ class Motors
       static unsigned short* DefaultPunches;
    
    private:
-      FT_HANDLE upperHandle;              // handle of the d2xx channel for the upper body (device 1)
-      FT_HANDLE lowerHandle;              // handle of the d2xx channel for the lower body (device 0)
+      static DXTransport* LowerTransport;       // the channel set with useTransports() for the lower body, or NULL to open d2xx device 0
+      static DXTransport* UpperTransport;       // the channel set with useTransports() for the upper body, or NULL to open d2xx device 1
+   
+      DXTransport* m_lower_transport;           // the channel for the lower body
+      DXTransport* m_upper_transport;           // the channel for the upper body
+      bool m_owns_transports;                   // true if the channels were opened by this class, and need to be closed by it
+      DXBusThread* m_lower_bus;                 // the thread that writes to the lower body channel
+      DXBusThread* m_upper_bus;                 // the thread that writes to the upper body channel
    
       // Control packet data
       unsigned char MotorControls[MOTORS_NUM_MOTORS][MOTORS_NUM_CONTROLS];
@@ -175,8 +187,13 @@ class Motors
       unsigned char MotorRequestsUpper[MOTORS_NUM_UPPER_REQUEST_BLOCKS][MOTORS_NUM_UPPER_MOTORS*MAX_MESSAGE_LENGTH];
       unsigned short MotorRequestsUpperLength[MOTORS_NUM_UPPER_REQUEST_BLOCKS];
    
-      // Threaded write data
-      threaddata_t ThreadLowerWrite, ThreadUpperWrite;
+      // Sync write packets for each channel; they can not be changed until their write has completed
+      DXPacketBuilder m_lower_controls, m_upper_controls;
+      unsigned int m_lower_control_ticket, m_upper_control_ticket;
+   
+      // Feedback framing for each channel, and the sequence number of the feedback last copied into the global arrays
+      DXFeedbackParser m_lower_feedback, m_upper_feedback;
+      unsigned int m_feedback_sequence[MOTORS_NUM_MOTORS];
    
       // Software motor on/off control
       bool MotorTorqueOn[MOTORS_NUM_MOTORS];
@@ -186,6 +203,4 @@ class Motors
       DXSerialThread* m_thread;
 };
 
-void* runThreadedWrite(void *arg);
-
 #endif
@@ -22,6 +22,11 @@ SET (YOUR_SRCS  dx117.h
                 WinTypes.h
                 Motors.cpp Motors.h
                 DXSerialThread.cpp DXSerialThread.h
+                DXTransport.cpp DXTransport.h
+                DXPacketBuilder.cpp DXPacketBuilder.h
+                DXBusThread.cpp DXBusThread.h
+                DXFeedbackParser.cpp DXFeedbackParser.h
+                DXEmulator.cpp DXEmulator.h
 )
 ####################################################################################
 ########## List your subdirectories here! ##########################################
@@ -29,6 +29,7 @@
 #include "Infrastructure/NUActionatorsData/NUActionatorsData.h"
 #include "NUPlatform/NUActionators/NUSounds.h"
 #include "Infrastructure/FieldObjects/FieldObjects.h"
+#include "Infrastructure/FieldObjects/FieldObjectsSnapshots.h"
 #include "Infrastructure/Jobs/Jobs.h"
 #include "Infrastructure/GameInformation/GameInformation.h"
 #include "Infrastructure/TeamInformation/TeamInformation.h"
@@ -60,6 +61,10 @@
 #endif
 #include "NUbot/SenseMoveThread.h"
 #include "NUbot/WatchDogThread.h"
+#include "Tools/Threading/ThreadPlacement.h"
+#include "Tools/Threading/StartupScheduler.h"
+#include "Tools/Profiling/StartupProfiler.h"
+#include "nubotdataconfig.h"
 
 // --------------------------------------------------------------- NUPlatform header files
 #if defined(TARGET_IS_NAOWEBOTS)
@@ -109,12 +114,13 @@ NUbot::NUbot(int argc, const char *argv[])
         debug << "NUbot::NUbot()." << endl;
     #endif
     NUbot::m_this = this;
+    m_argc = argc;
+    m_argv = argv;
     
     createErrorHandling();
-    createPlatform(argc, argv);
-    createBlackboard();
-    createNetwork();
-    createModules();
+    ThreadPlacement::load(CONFIG_DIR + std::string("Threads.cfg"));      // this needs to be loaded before any threads are started
+    createSubsystems();
+    ThreadPlacement::lockMemory();
     createThreads();
     
     #if DEBUG_NUBOT_VERBOSITY > 0
@@ -164,15 +170,53 @@ void NUbot::createErrorHandling()
     #endif
 }
 
+/*! @brief Creates the platform, the blackboard, the network and the modules
+ 
+    The subsystems that do not depend on each other are created at the same time, on the number of threads given by
+    StartupThreads in Threads.cfg. The LUT is loaded while the platform starts, and the motion scripts are loaded
+    while the other modules are created. The time each subsystem took, and the critical path, are written to debug.
+ */
+void NUbot::createSubsystems()
+{
+    #if DEBUG_NUBOT_VERBOSITY > 0
+        debug << "NUbot::createSubsystems()." << endl;
+    #endif
+    
+    StartupProfiler profiler;
+    StartupScheduler scheduler(&profiler);
+    scheduler.add("Platform", this, &NUbot::createPlatform);
+    #ifdef USE_VISION
+        scheduler.add("Vision", this, &NUbot::createVision);
+    #endif
+    scheduler.add("Blackboard", this, &NUbot::createBlackboard, "Platform");
+    #ifdef USE_MOTION
+        scheduler.add("Motion", this, &NUbot::createMotion, "Blackboard");
+    #endif
+    scheduler.add("Network", this, &NUbot::createNetwork, "Blackboard");
+    #ifdef USE_LOCALISATION
+        scheduler.add("Localisation", this, &NUbot::createLocalisation, "Blackboard");
+    #endif
+    #ifdef USE_BEHAVIOUR
+        scheduler.add("Behaviour", this, &NUbot::createBehaviour, "Blackboard");
+    #endif
+    #ifdef USE_MOTION
+        scheduler.add("MotionScripts", this, &NUbot::preloadMotionScripts, "Motion");
+    #endif
+    
+    if (not scheduler.run(ThreadPlacement::getStartupThreads()))
+        errorlog << "NUbot::createSubsystems(). Unable to create the subsystems." << endl;
+    debug << profiler;
+}
+
 /*! @brief Creates the Platform (Robot hardware interface) */
-void NUbot::createPlatform(int argc, const char *argv[])
+void NUbot::createPlatform()
 {
     #if DEBUG_NUBOT_VERBOSITY > 0
         debug << "NUbot::createPlatform()." << endl;
     #endif
     
     #if defined(TARGET_IS_NAOWEBOTS)
-        m_platform = new NAOWebotsPlatform(argc, argv);
+        m_platform = new NAOWebotsPlatform(m_argc, m_argv);
     #elif defined(TARGET_IS_NAO)
         m_platform = new NAOPlatform();
     #elif defined(TARGET_IS_CYCLOID)
@@ -209,6 +253,7 @@ void NUbot::createBlackboard()
     m_blackboard->add(m_platform->getNUSensorsData());
     m_blackboard->add(m_platform->getNUActionatorsData());
     m_blackboard->add(new FieldObjects());
+    m_blackboard->add(new FieldObjectsSnapshots());
     m_blackboard->add(new JobList());
     m_blackboard->add(new GameInformation(m_platform->getRobotNumber(), m_platform->getTeamNumber()));
     m_blackboard->add(new TeamInformation(m_platform->getRobotNumber(), m_platform->getTeamNumber()));
@@ -256,33 +301,62 @@ void NUbot::destroyNetwork()
     m_io = 0;
 }
 
-/*! @brief Creates the Modules, this includes Vision, Localisation, Behaviour and Motion */
-void NUbot::createModules()
+#ifdef USE_VISION
+/*! @brief Creates the Vision module, which loads the LUT */
+void NUbot::createVision()
 {
     #if DEBUG_NUBOT_VERBOSITY > 0
-        debug << "NUbot::createModules()." << endl;
+        debug << "NUbot::createVision()." << endl;
     #endif
-    
-    #ifdef USE_VISION
-        m_vision = new Vision();
+    m_vision = new Vision();
+}
+#endif
+
+#ifdef USE_LOCALISATION
+/*! @brief Creates the Localisation module */
+void NUbot::createLocalisation()
+{
+    #if DEBUG_NUBOT_VERBOSITY > 0
+        debug << "NUbot::createLocalisation()." << endl;
     #endif
-        
-    #ifdef USE_LOCALISATION
-        #if defined(TARGET_IS_NAOWEBOTS)
-            m_localisation = new Localisation(Platform->getRobotNumber());
-        #else
-            m_localisation = new Localisation();
-        #endif // defined(TARGET_IS_NAOWEBOTS)
+    #if defined(TARGET_IS_NAOWEBOTS)
+        m_localisation = new Localisation(Platform->getRobotNumber());
+    #else
+        m_localisation = new Localisation();
+    #endif // defined(TARGET_IS_NAOWEBOTS)
+}
+#endif
+
+#ifdef USE_BEHAVIOUR
+/*! @brief Creates the Behaviour module */
+void NUbot::createBehaviour()
+{
+    #if DEBUG_NUBOT_VERBOSITY > 0
+        debug << "NUbot::createBehaviour()." << endl;
     #endif
-        
-    #ifdef USE_BEHAVIOUR
-        m_behaviour = new Behaviour();
+    m_behaviour = new Behaviour();
+}
+#endif
+
+#ifdef USE_MOTION
+/*! @brief Creates the Motion module, which creates the walk engine and each of the motion providers */
+void NUbot::createMotion()
+{
+    #if DEBUG_NUBOT_VERBOSITY > 0
+        debug << "NUbot::createMotion()." << endl;
     #endif
-        
-    #ifdef USE_MOTION
-        m_motion = new NUMotion(m_blackboard->Sensors, m_blackboard->Actions);
+    m_motion = new NUMotion(m_blackboard->Sensors, m_blackboard->Actions);
+}
+
+/*! @brief Loads the motion scripts, so that they are not loaded in the SenseMove thread the first time they are played */
+void NUbot::preloadMotionScripts()
+{
+    #if DEBUG_NUBOT_VERBOSITY > 0
+        debug << "NUbot::preloadMotionScripts()." << endl;
     #endif
+    m_motion->preloadScripts();
 }
+#endif
 
 /*! @brief Destroys all of the modules, aka delete m_vision, m_localisation, m_behaviour, m_motion */
 void NUbot::destroyModules()
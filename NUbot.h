@@ -71,13 +71,26 @@ public:
     
 private:
     void createErrorHandling();
-    void createPlatform(int argc, const char *argv[]);
+    void createSubsystems();
+    void createPlatform();
     void destroyPlatform();
     void createBlackboard();
     void destroyBlackboard();
     void createNetwork();
     void destroyNetwork();
-    void createModules();
+    #ifdef USE_VISION
+        void createVision();
+    #endif
+    #ifdef USE_LOCALISATION
+        void createLocalisation();
+    #endif
+    #ifdef USE_BEHAVIOUR
+        void createBehaviour();
+    #endif
+    #ifdef USE_MOTION
+        void createMotion();
+        void preloadMotionScripts();
+    #endif
     void destroyModules();
     void createThreads();
     void destroyThreads();
@@ -87,6 +100,8 @@ private:
     void unhandledExceptionHandler(std::exception& e);
 private:
     static NUbot* m_this;                 //!< a pointer to the last instance of a NUbot
+    int m_argc;                           //!< the number of command line arguements, kept for createPlatform
+    const char** m_argv;                  //!< the command line arguements, kept for createPlatform
     NUPlatform* m_platform;               //!< interface to robot platform
     NUBlackboard* m_blackboard;           //!< a pointer to the public store
     #ifdef USE_VISION
@@ -29,9 +29,11 @@
 #include "NUPlatform/NUIO.h"
 #include "NUbot.h"
 #include "SeeThinkThread.h"
-#include "Localisation/LocWmFrame.h"
 #include "nubotdataconfig.h"
 
+#if defined(USE_VISION) or defined(USE_LOCALISATION)
+    #include "Infrastructure/FieldObjects/FieldObjectsSnapshots.h"
+#endif
 
 #ifdef USE_VISION
     #include "Infrastructure/FieldObjects/FieldObjects.h"
@@ -46,6 +48,7 @@
 
 #ifdef USE_LOCALISATION
     #include "Localisation/Localisation.h"
+    #include "Localisation/Threads/LocalisationLoggerThread.h"
 #endif
 
 #ifdef USE_MOTION
@@ -61,6 +64,7 @@
 #endif
 
 #include <errno.h>
+#include <fstream>
 
 #if DEBUG_NUBOT_VERBOSITY > DEBUG_THREADING_VERBOSITY
     #define DEBUG_VERBOSITY DEBUG_NUBOT_VERBOSITY
@@ -71,19 +75,14 @@
 /*! @brief Constructs the sense->move thread
  */
 
-SeeThinkThread::SeeThinkThread(NUbot* nubot) : ConditionalThread(string("SeeThinkThread"), THREAD_SEETHINK_PRIORITY)
+SeeThinkThread::SeeThinkThread(NUbot* nubot) : ConditionalThread(string("SeeThinkThread"), THREAD_SEETHINK_PRIORITY), m_latency_monitor(string("SeeThinkThread"), THREAD_SEETHINK_PERIOD)
 {
     #if DEBUG_VERBOSITY > 0
         debug << "SeeThinkThread::SeeThinkThread(" << nubot << ") with priority " << static_cast<int>(m_priority) << endl;
     #endif
     m_nubot = nubot;
-
-
-    m_locwmfile.open((string(DATA_DIR) + string("locfrm.strm")).c_str());
-    debug << "Opening file: " << (string(DATA_DIR) + string("locfrm.strm")).c_str() << " ... ";
-    if(m_locwmfile.is_open()) debug << "Success.";
-    else debug << "Failed.";
-    debug << std::endl;
+    m_locwmlogger = NULL;
+    loadLocalisationLogging();
 }
 
 SeeThinkThread::~SeeThinkThread()
@@ -92,7 +91,32 @@ SeeThinkThread::~SeeThinkThread()
         debug << "SeeThinkThread::~SeeThinkThread()" << endl;
     #endif
     stop();
-    m_locwmfile.close();
+    #ifdef USE_LOCALISATION
+        delete m_locwmlogger;
+    #endif
+}
+
+/*! @brief Starts the localisation logger if LocalisationLogging.cfg turns it on. The frames are not logged when there is no such file.
+
+    The frames are written to locfrm.strm by the logger's own low priority thread, so logging costs this thread a copy of the frame.
+ */
+void SeeThinkThread::loadLocalisationLogging()
+{
+    #ifdef USE_LOCALISATION
+        int logframes = 0;
+        ifstream file((CONFIG_DIR + string("LocalisationLogging.cfg")).c_str());
+        if (file.is_open())
+        {
+            string label;
+            getline(file, label, ':');
+            file >> logframes;
+        }
+        #if DEBUG_VERBOSITY > 0
+            debug << "SeeThinkThread::loadLocalisationLogging(). Log frames: " << logframes << endl;
+        #endif
+        if (logframes)
+            m_locwmlogger = new LocalisationLoggerThread(DATA_DIR + string("locfrm.strm"));
+    #endif
 }
 
 /*! @brief The sense->move main loop
@@ -118,12 +142,16 @@ void SeeThinkThread::run()
     {
         try
         {
+            m_latency_monitor.markWait();
             #if defined(TARGET_IS_NAOWEBOTS) or (not defined(USE_VISION))
                 wait();
             #endif
             #ifdef USE_VISION
                 m_nubot->m_platform->updateImage();
+                m_latency_monitor.markStart(Blackboard->Image ? Platform->getTime() - Blackboard->Image->m_timestamp : 0);
                 *(m_nubot->m_io) << m_nubot;  //<! Raw IMAGE STREAMING (TCP)
+            #else
+                m_latency_monitor.markStart();
             #endif
             
             #ifdef THREAD_SEETHINK_PROFILE
@@ -142,6 +170,21 @@ void SeeThinkThread::run()
                 #ifdef THREAD_SEETHINK_PROFILE
                     prof.split("localisation");
                 #endif
+                if (m_locwmlogger)
+                {
+                    m_locwmframe.set(*m_nubot->m_localisation, *Blackboard->Objects);
+                    m_locwmlogger->log(m_locwmframe);
+                    #ifdef THREAD_SEETHINK_PROFILE
+                        prof.split("localisation_log");
+                    #endif
+                }
+            #endif
+            
+            #if defined(USE_VISION) or defined(USE_LOCALISATION)
+                Blackboard->ObjectSnapshots->publish(*Blackboard->Objects);          // other threads read the field objects through the snapshots
+                #ifdef THREAD_SEETHINK_PROFILE
+                    prof.split("snapshot");
+                #endif
             #endif
             
             #if defined(USE_BEHAVIOUR)
@@ -171,6 +214,7 @@ void SeeThinkThread::run()
                 #endif
             #endif
             // -----------------------------------------------------------------------------------------------------------------------------------------------------------------
+            m_latency_monitor.markEnd();
 
             #ifdef THREAD_SEETHINK_PROFILE
                 debug << prof;
@@ -26,11 +26,13 @@
 #define SEETHINK_THREAD_H
 
 #include "Tools/Threading/ConditionalThread.h"
+#include "Tools/Profiling/LatencyMonitor.h"
+#include "Localisation/LocalisationFrame.h"
 #include <vector>
-#include <fstream>
 
 
 class NUbot;
+class LocalisationLoggerThread;
 
 /*! @brief The top-level class
  */
@@ -39,11 +41,17 @@ class SeeThinkThread : public ConditionalThread
 public:
     SeeThinkThread(NUbot* nubot);
     ~SeeThinkThread();
+
+    LatencyMonitor& getLatencyMonitor() {return m_latency_monitor;}
 protected:
     void run();  
+private:
+    void loadLocalisationLogging();
 private:
     NUbot* m_nubot;
-    std::ofstream m_locwmfile;
+    LatencyMonitor m_latency_monitor;           //!< records the timing of every cycle so that the watchdog can check the deadlines
+    LocalisationLoggerThread* m_locwmlogger;    //!< writes the localisation frames to locfrm.strm, or NULL if they are not logged
+    LocalisationFrame m_locwmframe;             //!< the localisation frame given to the logger each cycle, reused to avoid allocations
 };
 
 #endif
@@ -58,7 +58,7 @@ using namespace std;
 /*! @brief Constructs the sense->move thread
  */
 
-SenseMoveThread::SenseMoveThread(NUbot* nubot) : ConditionalThread(string("SenseMoveThread"), THREAD_SENSEMOVE_PRIORITY)
+SenseMoveThread::SenseMoveThread(NUbot* nubot) : ConditionalThread(string("SenseMoveThread"), THREAD_SENSEMOVE_PRIORITY), m_latency_monitor(string("SenseMoveThread"), THREAD_SENSEMOVE_PERIOD)
 {
     #if DEBUG_VERBOSITY > 0
         debug << "SenseMoveThread::SenseMoveThread(" << nubot << ") with priority " << static_cast<int>(m_priority) << endl;
@@ -103,7 +103,9 @@ void SenseMoveThread::run()
             #ifdef THREAD_SENSEMOVE_PROFILE
                 waitprof.start();
             #endif
+            m_latency_monitor.markWait();
             wait();
+            m_latency_monitor.markStart();
             #ifdef THREAD_SENSEMOVE_PROFILE
                 waitprof.split("wait");
                 debug << waitprof;
@@ -136,6 +138,7 @@ void SenseMoveThread::run()
                 #endif
             #endif
             m_nubot->m_platform->processActions();
+            m_latency_monitor.markEnd();
             #ifdef THREAD_SENSEMOVE_PROFILE
                 prof.split("actionators");
                 debug << prof;
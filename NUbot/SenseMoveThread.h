@@ -26,6 +26,7 @@
 #define SENSEMOVE_THREAD_H
 
 #include "Tools/Threading/ConditionalThread.h"
+#include "Tools/Profiling/LatencyMonitor.h"
 
 class NUbot;
 
@@ -36,11 +37,14 @@ class SenseMoveThread : public ConditionalThread
 public:
     SenseMoveThread(NUbot* nubot);
     ~SenseMoveThread();
+
+    LatencyMonitor& getLatencyMonitor() {return m_latency_monitor;}
 protected:
     void run();
     
 private:
     NUbot* m_nubot;
+    LatencyMonitor m_latency_monitor;           //!< records the timing of every cycle so that the watchdog can check the deadlines
 };
 
 #endif
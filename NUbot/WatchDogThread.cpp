@@ -26,6 +26,12 @@
 #include "Infrastructure/NUSensorsData/NUSensorsData.h"
 #include "Infrastructure/NUActionatorsData/NUActionatorsData.h"
 #include "NUPlatform/NUPlatform.h"
+#include "SenseMoveThread.h"
+#include "Tools/Profiling/LatencyMonitor.h"
+
+#if defined(USE_VISION) or defined(USE_LOCALISATION)
+    #include "SeeThinkThread.h"
+#endif
 
 #ifdef USE_VISION
     #include "Vision/Vision.h"
@@ -53,6 +59,8 @@ WatchDogThread::WatchDogThread(NUbot* nubot) : PeriodicThread(string("WatchDogTh
         debug << "WatchDogThread::WatchDogThread(" << nubot << ") with priority " << static_cast<int>(m_priority) << endl;
     #endif
     m_nubot = nubot;
+    m_sensemove_late_count = 0;
+    m_seethink_late_count = 0;
 }
 
 WatchDogThread::~WatchDogThread()
@@ -71,4 +79,43 @@ void WatchDogThread::periodicFunction()
     #ifdef USE_VISION
         Platform->verifyVision(1000.0*m_nubot->m_vision->getNumFramesDropped()/m_period, 1000.0*m_nubot->m_vision->getNumFramesProcessed()/m_period);
     #endif
+
+    checkLatency(m_nubot->m_sensemove_thread->getLatencyMonitor(), m_sensemove_late_count);
+    #if defined(USE_VISION) or defined(USE_LOCALISATION)
+        checkLatency(m_nubot->m_seethink_thread->getLatencyMonitor(), m_seethink_late_count);
+    #endif
+}
+
+/*! @brief Checks whether a thread has kept up with its deadlines since the last check
+    @param monitor the latency monitor of the thread
+    @param count the number of consecutive checks the thread has been late. This is updated here
+ */
+void WatchDogThread::checkLatency(LatencyMonitor& monitor, int& count)
+{
+    LatencyReport report = monitor.collect();
+    #if DEBUG_VERBOSITY > 0
+        debug << "WatchDogThread::checkLatency. " << report << endl;
+    #endif
+
+    bool overrunning = 100*report.MissRatio > THREAD_DEADLINE_MISS_LIMIT;
+    bool stalled = report.CurrentStall > m_period;
+    if (not overrunning and not stalled)
+    {
+        count = 0;
+        return;
+    }
+
+    count++;
+    if (stalled)
+        errorlog << "WatchDogThread. " << report.Name << " has not finished a cycle in " << report.CurrentStall << "ms. " << report << endl;
+    else
+        errorlog << "WatchDogThread. " << report.Name << " missed " << report.NumMisses << " of " << report.NumCycles << " deadlines. " << report << endl;
+
+    #ifdef THREAD_DEADLINE_ACTION
+        if (count >= 3)
+        {
+            Blackboard->Actions->add(NUActionatorsData::Sound, Blackboard->Actions->CurrentTime, "error_unknown.wav");
+            count = 0;
+        }
+    #endif
 }
@@ -3,6 +3,11 @@
 
     @class WatchDogThread
     @brief The watchdog thread handles low priority 'system' behaviour
+
+    Each period the watchdog also collects the cycle timing of the see-think and sense-move threads. A warning
+    is written to the errorlog when a thread misses more than THREAD_DEADLINE_MISS_LIMIT percent of its deadlines,
+    or when it has not finished a cycle for an entire watchdog period. If THREAD_DEADLINE_ACTION is defined the
+    robot also tells us when this keeps happening.
  
     @author Jason Kulk
  
@@ -28,6 +33,7 @@
 #include "Tools/Threading/PeriodicThread.h"
 
 class NUbot;
+class LatencyMonitor;
 
 /*! @brief The top-level class
  */
@@ -38,9 +44,12 @@ public:
     ~WatchDogThread();
 private:
     void periodicFunction();
+    void checkLatency(LatencyMonitor& monitor, int& count);
     
 private:
     NUbot* m_nubot;
+    int m_sensemove_late_count;             //!< the number of consecutive periods in which the sense-move thread has been late
+    int m_seethink_late_count;              //!< the number of consecutive periods in which the see-think thread has been late
 };
 
 #endif
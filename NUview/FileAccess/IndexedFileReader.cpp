@@ -32,6 +32,7 @@ bool IndexedFileReader::OpenFile(const std::string& filename)
     m_file.open(filename.c_str(),std::ios_base::in | std::ios_base::binary);
     if(m_file.good())
     {
+        m_fileName = filename;
         m_file.seekg(0,std::ios_base::end);
         m_fileEndLocation = m_file.tellg();
         IndexFile();
@@ -45,6 +46,7 @@ bool IndexedFileReader::OpenFile(const std::string& filename)
 void IndexedFileReader::CloseFile()
 {
     m_file.close();
+    m_fileName.clear();
     m_fileEndLocation = 0;
     ClearIndex();
 }
@@ -92,6 +94,24 @@ unsigned int IndexedFileReader::TotalFrames()
     }
 }
 
+/**
+  *     Gives the name of the currently opened file.
+  *     @return The file path and name. Empty if no file is open.
+  */
+const std::string& IndexedFileReader::FileName()
+{
+    return m_fileName;
+}
+
+/**
+  *     Gives the length of the currently opened file.
+  *     @return The length in bytes.
+  */
+long long IndexedFileReader::FileLength()
+{
+    return m_fileEndLocation;
+}
+
 /**
   *     Finds the closest indexed time for the data to be valid at the given point of time. Meaning that if the exact
   *     time is not available, the time of the most recent data before this point of time is given.
@@ -145,6 +165,25 @@ double IndexedFileReader::TimeAtSequenceNumber(unsigned int sequenceNumber)
     }
 }
 
+/**
+  *     Gives the position within the file of the data given by the requested sequence number (N).
+  *     This allows the data to be read by something other than this reader, using its own file handle.
+  *     @return The offset in bytes of the Nth data entry. -1 if there is no Nth entry.
+  */
+long long IndexedFileReader::OffsetAtSequenceNumber(unsigned int sequenceNumber)
+{
+    double time = TimeAtSequenceNumber(sequenceNumber);
+    if(time >= 0.0)
+    {
+        IndexIterator entry = m_index.find(time);
+        if(ValidEntry(entry))
+        {
+            return (*entry).second.position;
+        }
+    }
+    return -1;
+}
+
 /**
   *     Determine if the file contains a value at the exact time given.
   *     @param The time in milliseconds.
@@ -34,7 +34,8 @@
 #include <vector>
 class IndexedFileReader
 {
-    // Declare types and structures used in class.
+protected:
+    // Declare types and structures used in class and by the derived readers.
     typedef std::fstream::pos_type Position;
     struct FrameEntry
     {
@@ -62,9 +63,12 @@ public:
     bool HasTime(double time);
     double FindClosestTime(double time);
     double TimeAtSequenceNumber(unsigned int sequenceNumber);
+    long long OffsetAtSequenceNumber(unsigned int sequenceNumber);
 
     unsigned int CurrentFrameSequenceNumber();
     unsigned int TotalFrames();
+    const std::string& FileName();
+    long long FileLength();
 
     // Unimplemented virtual functions.
     virtual void IndexFile() = 0;
@@ -80,6 +84,7 @@ protected:
     FileIndex m_index;                  //!< Index mapping timestamp to Frame entries.
     TimeIndex m_timeIndex;              //!< Index mapping sequence number to timestamp.
     std::fstream m_file;                //!< The file.
+    std::string m_fileName;             //!< The name of the file.
     Position m_fileEndLocation;         //!< The end position of the file.
     IndexIterator m_selectedFrame;      //!< Reference to the currently selected frame in the FileIndex.
 };
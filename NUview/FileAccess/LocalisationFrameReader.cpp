@@ -0,0 +1,59 @@
+#include "LocalisationFrameReader.h"
+#include <QDebug>
+#include <cmath>
+
+/**
+  *     Default constructor. Initialises the LocalisationFrameReader.
+  */
+LocalisationFrameReader::LocalisationFrameReader(): StreamFileReader<LocalisationFrame>()
+{
+}
+
+/**
+  *     Destructor.
+  */
+LocalisationFrameReader::~LocalisationFrameReader()
+{
+}
+
+/**
+  *     Scan the file and index the location and timestamp of each frame within the file, using only the frame headers.
+  */
+void LocalisationFrameReader::IndexFile()
+{
+    if (!m_file.is_open())
+        return;
+
+    FrameEntry temp;
+    temp.frameSequenceNumber = 0;
+    Position origPos = m_file.tellg();
+    m_file.seekg(0,std::ios_base::beg);
+    m_index.clear();
+    m_timeIndex.clear();
+
+    LocalisationFrame::Header header;
+    while (m_file.good() && ((m_fileEndLocation - m_file.tellg()) >= LocalisationFrame::HeaderSize))
+    {
+        temp.position = m_file.tellg();
+        if(!LocalisationFrame::readHeader(m_file, header))
+        {
+            qDebug("Bad localisation frame found at %lld", static_cast<long long>(temp.position));
+            break;
+        }
+        Position end = temp.position + static_cast<std::streamoff>(header.Size + header.PayloadSize);
+        if(end > m_fileEndLocation)
+        {
+            qDebug("Localisation frame %d is truncated", temp.frameSequenceNumber + 1);
+            break;
+        }
+        m_file.seekg(end, std::ios_base::beg);
+
+        double timestamp = floor(header.Timestamp);
+        if(HasTime(timestamp)) continue;
+        temp.frameSequenceNumber++;
+        m_index.insert(IndexEntry(timestamp,temp));
+        m_timeIndex.push_back(timestamp);
+    }
+    m_file.clear();
+    m_file.seekg(origPos,std::ios_base::beg);
+}
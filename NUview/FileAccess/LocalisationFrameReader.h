@@ -0,0 +1,42 @@
+/*! @file LocalisationFrameReader.h
+    @brief Declaration of the LocalisationFrameReader class
+
+    @class LocalisationFrameReader
+    @brief A StreamFileReader for a log of binary LocalisationFrames that indexes the file by reading only the headers.
+
+    Each LocalisationFrame header contains the size of its payload, so indexing the file seeks from one header to
+    the next rather than decoding every frame. A damaged or truncated frame ends the index at the last good frame.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOCALISATIONFRAMEREADER_H
+#define LOCALISATIONFRAMEREADER_H
+#include "StreamFileReader.h"
+#include "Localisation/LocalisationFrame.h"
+
+class LocalisationFrameReader: public StreamFileReader<LocalisationFrame>
+{
+public:
+    LocalisationFrameReader();
+    ~LocalisationFrameReader();
+
+    void IndexFile();
+};
+
+#endif // LOCALISATIONFRAMEREADER_H
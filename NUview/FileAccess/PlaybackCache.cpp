@@ -0,0 +1,484 @@
+#include "PlaybackCache.h"
+#include "IndexedFileReader.h"
+#include <algorithm>
+
+/**
+  *     Constructor. Starts the decoder threads; they wait until a file is opened and frames are requested.
+  *     @param maxBytes The maximum total size of the cached frames, measured by their size in the file.
+  *     @param numDecoders The number of decoder threads.
+  *     @param framesAhead The number of frames to prefetch in the direction of travel.
+  *     @param framesBehind The number of frames to prefetch behind the requested frame.
+  */
+PlaybackCache::PlaybackCache(long long maxBytes, int numDecoders, int framesAhead, int framesBehind):
+        m_stopping(false), m_generation(0), m_fileLength(0), m_bytes(0), m_maxBytes(maxBytes), m_cursor(0), m_direction(1),
+        m_framesAhead(0), m_framesBehind(0), m_maxFramesAhead(framesAhead), m_maxFramesBehind(framesBehind),
+        m_numHits(0), m_numMisses(0), m_numWaits(0), m_numPrefetched(0), m_numEvicted(0)
+{
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_cond_init(&m_workAvailable, NULL);
+    pthread_cond_init(&m_frameDecoded, NULL);
+    for(int i = 0; i < numDecoders; i++)
+    {
+        pthread_t decoder;
+        if(pthread_create(&decoder, NULL, RunDecoder, this) == 0)
+            m_decoders.push_back(decoder);
+    }
+}
+
+/**
+  *     Destructor. Stops the decoder threads and frees the cached frames.
+  */
+PlaybackCache::~PlaybackCache()
+{
+    StopDecoders();
+    Clear();
+    pthread_cond_destroy(&m_frameDecoded);
+    pthread_cond_destroy(&m_workAvailable);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+/**
+  *     Stops the decoder threads, and waits for them to finish. Derived classes must call this in their destructor.
+  */
+void PlaybackCache::StopDecoders()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_stopping = true;
+    pthread_cond_broadcast(&m_workAvailable);
+    pthread_mutex_unlock(&m_mutex);
+    for(size_t i = 0; i < m_decoders.size(); i++)
+        pthread_join(m_decoders[i], NULL);
+    m_decoders.clear();
+}
+
+/**
+  *     Discards the cached frames, and caches frames from the file opened by the reader instead.
+  *     The reader's index is copied, so the reader is not used again by the cache.
+  *     @param reader A reader that has opened and indexed a file.
+  */
+void PlaybackCache::Open(IndexedFileReader& reader)
+{
+    pthread_mutex_lock(&m_mutex);
+    Clear();
+    if(!reader.IsValid())
+    {
+        pthread_mutex_unlock(&m_mutex);
+        return;
+    }
+
+    m_fileName = reader.FileName();
+    m_fileLength = reader.FileLength();
+    m_offsets.reserve(reader.TotalFrames());
+    for(unsigned int sequenceNumber = 1; sequenceNumber <= reader.TotalFrames(); sequenceNumber++)
+        m_offsets.push_back(reader.OffsetAtSequenceNumber(sequenceNumber));
+    m_file.open(m_fileName.c_str(), std::ios_base::in | std::ios_base::binary);
+
+    // Limit the prefetching to the number of frames that fit in memory, so prefetched frames are not evicted before they are used
+    long long averageBytes = std::max(1LL, m_fileLength/std::max(1LL, static_cast<long long>(m_offsets.size())));
+    int budget = static_cast<int>(std::min(m_maxBytes/averageBytes - 1, 100000LL));
+    m_framesAhead = std::max(0, std::min(m_maxFramesAhead, 2*budget/3));
+    m_framesBehind = std::max(0, std::min(m_maxFramesBehind, budget - m_framesAhead));
+    pthread_mutex_unlock(&m_mutex);
+}
+
+/**
+  *     Discards the cached frames and stops reading the file.
+  */
+void PlaybackCache::Close()
+{
+    pthread_mutex_lock(&m_mutex);
+    Clear();
+    pthread_mutex_unlock(&m_mutex);
+}
+
+/**
+  *     Return the total number of frames that can be read through the cache.
+  */
+unsigned int PlaybackCache::TotalFrames()
+{
+    pthread_mutex_lock(&m_mutex);
+    unsigned int totalFrames = m_offsets.size();
+    pthread_mutex_unlock(&m_mutex);
+    return totalFrames;
+}
+
+/**
+  *     Get a decoded frame, and queue the frames around it for the decoders. If a decoder is working on the frame it is
+  *     waited for, and if the frame has not been prefetched it is decoded on the calling thread. This should always be
+  *     called from the same thread.
+  *     @param sequenceNumber The sequence number of the frame; the first frame in the file is 1.
+  *     @return The frame, which stays valid until the next call. NULL if the frame could not be read.
+  */
+PlaybackCache::CachedFrame* PlaybackCache::GetFrame(unsigned int sequenceNumber)
+{
+    pthread_mutex_lock(&m_mutex);
+    if((sequenceNumber < 1) || (sequenceNumber > m_offsets.size()))
+    {
+        pthread_mutex_unlock(&m_mutex);
+        return NULL;
+    }
+
+    Prefetch(sequenceNumber);
+    bool waited = false;
+    CachedFrame* frame = NULL;
+    while(true)
+    {
+        std::map<unsigned int, Entry>::iterator it = m_entries.find(sequenceNumber);
+        if((it == m_entries.end()) || (it->second.state == Queued))
+        {   // No decoder has started on the frame, so decode it here
+            m_numMisses++;
+            if(it != m_entries.end())
+                m_queue.erase(std::find(m_queue.begin(), m_queue.end(), sequenceNumber));
+            Start(sequenceNumber, Decoding);
+            long long offset = m_offsets[sequenceNumber - 1];
+            CachedFrame* spare = TakeSpare();
+            pthread_mutex_unlock(&m_mutex);
+            frame = DecodeAt(m_file, offset, spare);
+            pthread_mutex_lock(&m_mutex);
+            Insert(sequenceNumber, frame);
+            break;
+        }
+        else if(it->second.state == Decoded)
+        {
+            if(waited)
+                m_numWaits++;
+            else
+                m_numHits++;
+            Touch(it->second, sequenceNumber);
+            frame = it->second.frame;
+            break;
+        }
+        else
+        {   // A decoder is working on the frame
+            waited = true;
+            pthread_cond_wait(&m_frameDecoded, &m_mutex);
+        }
+    }
+    pthread_mutex_unlock(&m_mutex);
+    return frame;
+}
+
+/**
+  *     Orders queued frames by their priority; the frames ahead in the direction of travel, nearest first, and then those behind.
+  */
+struct PlaybackCachePriorityOrder
+{
+    long long cursor;
+    int direction;
+    int framesAhead;
+    int key(unsigned int sequenceNumber) const
+    {
+        long long ahead = (static_cast<long long>(sequenceNumber) - cursor)*direction;
+        return (ahead > 0) ? ahead : framesAhead - ahead;
+    }
+    bool operator()(unsigned int a, unsigned int b) const
+    {
+        return key(a) < key(b);
+    }
+};
+
+/**
+  *     Queue the frames around the requested frame that are not already queued or decoded. Queued frames that are no longer
+  *     around the requested frame are dropped from the queue, and the rest are kept, in order of priority.
+  *     @param sequenceNumber The requested frame.
+  */
+void PlaybackCache::Prefetch(unsigned int sequenceNumber)
+{
+    int direction = m_direction;
+    if(sequenceNumber > m_cursor)
+        m_direction = 1;
+    else if(sequenceNumber < m_cursor)
+        m_direction = -1;
+    m_cursor = sequenceNumber;
+
+    size_t kept = 0;
+    for(size_t i = 0; i < m_queue.size(); i++)
+    {
+        if(Priority(m_queue[i]) >= 0)
+            m_queue[kept++] = m_queue[i];
+        else
+            m_entries.erase(m_queue[i]);
+    }
+    m_queue.resize(kept);
+    if((direction != m_direction) && (kept > 1))
+    {   // the frames that were ahead are now behind
+        PlaybackCachePriorityOrder order = {m_cursor, m_direction, m_framesAhead};
+        std::stable_sort(m_queue.begin(), m_queue.end(), order);
+    }
+
+    int added = 0;
+    for(int i = 1; i <= m_framesAhead + m_framesBehind; i++)
+    {
+        long long frame = (i <= m_framesAhead) ? sequenceNumber + m_direction*i : sequenceNumber - m_direction*(i - m_framesAhead);
+        if((frame >= 1) && (frame <= static_cast<long long>(m_offsets.size())) && (m_entries.find(frame) == m_entries.end()))
+        {
+            Start(frame, Queued);
+            m_queue.push_back(frame);
+            added++;
+        }
+    }
+    if(added == 1)
+        pthread_cond_signal(&m_workAvailable);
+    else if(added > 1)
+        pthread_cond_broadcast(&m_workAvailable);
+}
+
+/**
+  *     The position of a frame in the prefetch order around the cursor; 0 for the cursor, then the frames ahead nearest
+  *     first, and then the frames behind. Frames outside of the prefetched frames are -1.
+  */
+int PlaybackCache::Priority(unsigned int sequenceNumber) const
+{
+    long long ahead = (static_cast<long long>(sequenceNumber) - m_cursor)*m_direction;
+    if((ahead > m_framesAhead) || (-ahead > m_framesBehind))
+        return -1;
+    else if(ahead >= 0)
+        return ahead;
+    else
+        return m_framesAhead - ahead;
+}
+
+/**
+  *     Add an entry for a frame that is not cached yet.
+  *     @param state Queued or Decoding.
+  */
+PlaybackCache::Entry& PlaybackCache::Start(unsigned int sequenceNumber, State state)
+{
+    Entry& entry = m_entries[sequenceNumber];
+    entry.state = state;
+    entry.frame = NULL;
+    entry.bytes = FrameBytes(sequenceNumber);
+    return entry;
+}
+
+/**
+  *     Take an evicted frame to decode into, or NULL if there are none.
+  */
+PlaybackCache::CachedFrame* PlaybackCache::TakeSpare()
+{
+    if(m_spares.empty())
+        return NULL;
+    CachedFrame* spare = m_spares.back();
+    m_spares.pop_back();
+    return spare;
+}
+
+/**
+  *     The entry point of the decoder threads.
+  */
+void* PlaybackCache::RunDecoder(void* cache)
+{
+    static_cast<PlaybackCache*>(cache)->DecodeLoop();
+    return NULL;
+}
+
+/**
+  *     The decoder threads' loop. Takes the next queued frame, decodes it with the thread's own file handle, and inserts it.
+  */
+void PlaybackCache::DecodeLoop()
+{
+    std::ifstream file;
+    unsigned int generation = 0;
+    pthread_mutex_lock(&m_mutex);
+    while(!m_stopping)
+    {
+        if(m_queue.empty())
+        {
+            pthread_cond_wait(&m_workAvailable, &m_mutex);
+            continue;
+        }
+        unsigned int sequenceNumber = m_queue.front();
+        m_queue.pop_front();
+        std::map<unsigned int, Entry>::iterator it = m_entries.find(sequenceNumber);
+        if((it == m_entries.end()) || (it->second.state != Queued))
+            continue;
+
+        if((generation != m_generation) || !file.is_open())
+        {
+            file.close();
+            file.clear();
+            file.open(m_fileName.c_str(), std::ios_base::in | std::ios_base::binary);
+            generation = m_generation;
+        }
+        it->second.state = Decoding;
+        long long offset = m_offsets[sequenceNumber - 1];
+        CachedFrame* spare = TakeSpare();
+
+        pthread_mutex_unlock(&m_mutex);
+        CachedFrame* frame = DecodeAt(file, offset, spare);
+        pthread_mutex_lock(&m_mutex);
+
+        if(generation != m_generation)
+        {   // The file was closed while the frame was being decoded; its entry has already gone
+            delete frame;
+            continue;
+        }
+        m_numPrefetched++;
+        Insert(sequenceNumber, frame);
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
+
+/**
+  *     Decode a frame using the given file handle. This is called without the lock, so each thread uses its own file handle.
+  *     @param spare A frame to decode into, or NULL. It is deleted if the frame can not be decoded.
+  */
+PlaybackCache::CachedFrame* PlaybackCache::DecodeAt(std::ifstream& file, long long offset, CachedFrame* spare)
+{
+    if((offset < 0) || !file.is_open())
+    {
+        delete spare;
+        return NULL;
+    }
+    file.clear();
+    file.seekg(offset, std::ios_base::beg);
+    return Decode(file, spare);
+}
+
+/**
+  *     Insert a decoded frame in place of its in progress entry, and evict frames until the cache is within its bound.
+  *     @param frame The decoded frame. If it is NULL the entry is removed, so the frame can be tried again.
+  */
+void PlaybackCache::Insert(unsigned int sequenceNumber, CachedFrame* frame)
+{
+    std::map<unsigned int, Entry>::iterator it = m_entries.find(sequenceNumber);
+    if(frame == NULL)
+    {
+        m_entries.erase(it);
+    }
+    else
+    {
+        it->second.state = Decoded;
+        it->second.frame = frame;
+        it->second.use = m_leastRecentlyUsed.insert(m_leastRecentlyUsed.begin(), sequenceNumber);
+        m_bytes += it->second.bytes;
+        Evict();
+    }
+    pthread_cond_broadcast(&m_frameDecoded);
+}
+
+/**
+  *     Mark a decoded frame as the most recently used.
+  */
+void PlaybackCache::Touch(Entry& entry, unsigned int sequenceNumber)
+{
+    m_leastRecentlyUsed.erase(entry.use);
+    entry.use = m_leastRecentlyUsed.insert(m_leastRecentlyUsed.begin(), sequenceNumber);
+}
+
+/**
+  *     Evict frames until the cache is within its bound. The frames outside of the prefetched frames are evicted first, most
+  *     recently used first, and then the least recently used of the rest. The frame at the cursor is kept.
+  *
+  *     Playing through a log longer than the cache leaves each frame behind the prefetched frames as it goes, so evicting
+  *     the most recently used of those keeps the start of the log for the next time through, where evicting the least
+  *     recently used would keep nothing that is used again. An evicted frame is kept to be decoded into again if there are
+  *     no more spares than decoder threads, so the memory for the next frame has been used recently.
+  */
+void PlaybackCache::Evict()
+{
+    while((m_bytes > m_maxBytes) && (m_leastRecentlyUsed.size() > 1))
+    {
+        std::list<unsigned int>::iterator victim = m_leastRecentlyUsed.begin();
+        while((victim != m_leastRecentlyUsed.end()) && (Priority(*victim) >= 0))
+            ++victim;
+        if(victim == m_leastRecentlyUsed.end())
+        {   // every frame is around the cursor
+            victim = --m_leastRecentlyUsed.end();
+            if(*victim == m_cursor)
+                --victim;
+        }
+        std::map<unsigned int, Entry>::iterator it = m_entries.find(*victim);
+        m_leastRecentlyUsed.erase(victim);
+        m_bytes -= it->second.bytes;
+        if(m_spares.size() <= m_decoders.size())
+            m_spares.push_back(it->second.frame);
+        else
+            delete it->second.frame;
+        m_entries.erase(it);
+        m_numEvicted++;
+    }
+}
+
+/**
+  *     Remove every cached frame and forget the file. Frames still being decoded are discarded by their decoder.
+  */
+void PlaybackCache::Clear()
+{
+    for(std::map<unsigned int, Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+        delete it->second.frame;
+    m_entries.clear();
+    m_leastRecentlyUsed.clear();
+    m_queue.clear();
+    for(size_t i = 0; i < m_spares.size(); i++)
+        delete m_spares[i];
+    m_spares.clear();
+    m_bytes = 0;
+    m_cursor = 0;
+    m_direction = 1;
+
+    m_generation++;
+    m_fileName.clear();
+    m_fileLength = 0;
+    m_offsets.clear();
+    m_file.close();
+    m_file.clear();
+}
+
+/**
+  *     The size of a frame in the file, which is used as the measure of its size in memory.
+  */
+long long PlaybackCache::FrameBytes(unsigned int sequenceNumber)
+{
+    long long offset = m_offsets[sequenceNumber - 1];
+    long long next = (sequenceNumber < m_offsets.size()) ? m_offsets[sequenceNumber] : m_fileLength;
+    return std::max(1LL, next - offset);
+}
+
+unsigned int PlaybackCache::NumHits()
+{
+    pthread_mutex_lock(&m_mutex);
+    unsigned int value = m_numHits;
+    pthread_mutex_unlock(&m_mutex);
+    return value;
+}
+
+unsigned int PlaybackCache::NumMisses()
+{
+    pthread_mutex_lock(&m_mutex);
+    unsigned int value = m_numMisses;
+    pthread_mutex_unlock(&m_mutex);
+    return value;
+}
+
+unsigned int PlaybackCache::NumWaits()
+{
+    pthread_mutex_lock(&m_mutex);
+    unsigned int value = m_numWaits;
+    pthread_mutex_unlock(&m_mutex);
+    return value;
+}
+
+unsigned int PlaybackCache::NumPrefetched()
+{
+    pthread_mutex_lock(&m_mutex);
+    unsigned int value = m_numPrefetched;
+    pthread_mutex_unlock(&m_mutex);
+    return value;
+}
+
+unsigned int PlaybackCache::NumEvicted()
+{
+    pthread_mutex_lock(&m_mutex);
+    unsigned int value = m_numEvicted;
+    pthread_mutex_unlock(&m_mutex);
+    return value;
+}
+
+long long PlaybackCache::NumBytes()
+{
+    pthread_mutex_lock(&m_mutex);
+    long long value = m_bytes;
+    pthread_mutex_unlock(&m_mutex);
+    return value;
+}
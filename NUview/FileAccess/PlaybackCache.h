@@ -0,0 +1,156 @@
+/*! @file PlaybackCache.h
+    @brief Declaration of the PlaybackCache class
+
+    @class PlaybackCache
+    @brief A cache of decoded frames from an indexed file, filled in the background by a pool of decoder threads.
+
+    The cache copies the frame offsets from an IndexedFileReader, and then reads the file itself, so that frames
+    can be decoded by any thread. Each time a frame is requested, the frames ahead of it in the direction of travel,
+    and a few behind it, that are not already queued or decoded are queued for the decoder threads. Stepping through
+    a log then finds the next frame already decoded, and scrubbing backwards does not have to parse the file again.
+    A requested frame that a decoder is working on is waited for, and one that is only queued is taken out of the
+    queue and decoded by the caller, so no frame is decoded twice.
+
+    Decoded frames are kept in a recently used list, bounded by the total size of the frames in the file. The frames
+    outside of the prefetched frames are evicted first, most recently used first, so playing through a log longer
+    than the cache keeps the start of it for the next time through (see Evict()). The most recently requested frame is never evicted, so a pointer to it is valid until the next frame is requested;
+    the same lifetime as the buffer in StreamFileReader. A few evicted frames are kept to be decoded into again, so
+    playing through a log does not allocate a new frame each time.
+
+    Derived classes implement Decode() for the type of data in the file, and must call StopDecoders() in their
+    destructor, because the decoder threads use Decode().
+
+    The cache uses pthreads rather than Qt's threads, so that it can be built and benchmarked without Qt.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PLAYBACKCACHE_H
+#define PLAYBACKCACHE_H
+
+#include <pthread.h>
+
+#include <string>
+#include <fstream>
+#include <vector>
+#include <deque>
+#include <list>
+#include <map>
+
+class IndexedFileReader;
+
+class PlaybackCache
+{
+public:
+    PlaybackCache(long long maxBytes, int numDecoders = 1, int framesAhead = 8, int framesBehind = 4);
+    virtual ~PlaybackCache();
+
+    void Open(IndexedFileReader& reader);
+    void Close();
+    unsigned int TotalFrames();
+
+    // Statistics
+    unsigned int NumHits();
+    unsigned int NumMisses();
+    unsigned int NumWaits();
+    unsigned int NumPrefetched();
+    unsigned int NumEvicted();
+    long long NumBytes();
+
+protected:
+    /*! @brief A decoded frame. Derived classes add the data */
+    class CachedFrame
+    {
+    public:
+        virtual ~CachedFrame() {};
+    };
+
+    CachedFrame* GetFrame(unsigned int sequenceNumber);
+    void StopDecoders();
+
+    /*! @brief Decodes a frame from the stream, which has been positioned at the start of it.
+        @param stream the stream
+        @param spare an evicted frame to decode into, or NULL if there is none. It belongs to Decode().
+        @return the decoded frame, or NULL if it could not be decoded. This is called from the decoder threads.
+     */
+    virtual CachedFrame* Decode(std::istream& stream, CachedFrame* spare) = 0;
+
+private:
+    enum State
+    {
+        Queued,                                 //!< The frame is waiting for a decoder.
+        Decoding,                               //!< The frame is being decoded.
+        Decoded                                 //!< The frame is in the cache.
+    };
+
+    struct Entry
+    {
+        State state;                            //!< Whether the frame is queued, being decoded, or decoded.
+        CachedFrame* frame;                     //!< The decoded frame, or NULL until it is decoded.
+        long long bytes;                        //!< The size of the frame in the file.
+        std::list<unsigned int>::iterator use;  //!< The frame's position in m_leastRecentlyUsed, once it is decoded.
+    };
+
+    static void* RunDecoder(void* cache);
+    void DecodeLoop();
+    CachedFrame* DecodeAt(std::ifstream& file, long long offset, CachedFrame* spare);
+    long long FrameBytes(unsigned int sequenceNumber);
+    void Prefetch(unsigned int sequenceNumber);
+    int Priority(unsigned int sequenceNumber) const;
+    Entry& Start(unsigned int sequenceNumber, State state);
+    CachedFrame* TakeSpare();
+    void Insert(unsigned int sequenceNumber, CachedFrame* frame);
+    void Touch(Entry& entry, unsigned int sequenceNumber);
+    void Evict();
+    void Clear();
+
+    // Member variables
+    pthread_mutex_t m_mutex;                        //!< Lock on everything below.
+    pthread_cond_t m_workAvailable;                 //!< Signalled when frames are queued for the decoders.
+    pthread_cond_t m_frameDecoded;                  //!< Signalled when a decoder finishes a frame.
+    std::vector<pthread_t> m_decoders;              //!< The decoder threads.
+    bool m_stopping;                                //!< True when the decoder threads have been asked to stop.
+
+    std::string m_fileName;                         //!< The file the frames are read from.
+    unsigned int m_generation;                      //!< Incremented each time a file is opened or closed, so decoders can discard frames from the old one.
+    std::vector<long long> m_offsets;               //!< The offset of each frame in the file, indexed by sequence number - 1.
+    long long m_fileLength;                         //!< The length of the file in bytes.
+    std::ifstream m_file;                           //!< The file handle used to decode frames that have not been prefetched.
+
+    std::map<unsigned int, Entry> m_entries;        //!< The cached frames, and those being decoded, by sequence number.
+    std::list<unsigned int> m_leastRecentlyUsed;    //!< The decoded frames, most recently used first.
+    std::deque<unsigned int> m_queue;               //!< The frames to prefetch, highest priority first.
+    std::vector<CachedFrame*> m_spares;             //!< Evicted frames that can be decoded into again.
+    long long m_bytes;                              //!< The total size of the cached frames.
+    long long m_maxBytes;                           //!< The maximum total size of the cached frames.
+
+    unsigned int m_cursor;                          //!< The most recently requested frame. It is never evicted.
+    int m_direction;                                //!< The direction of travel; 1 forwards, -1 backwards.
+    int m_framesAhead;                              //!< The number of frames to prefetch in the direction of travel.
+    int m_framesBehind;                             //!< The number of frames to prefetch behind the cursor.
+    int m_maxFramesAhead;                           //!< The requested number of frames to prefetch ahead, before limiting it to the memory available.
+    int m_maxFramesBehind;                          //!< The requested number of frames to prefetch behind, before limiting it to the memory available.
+
+    unsigned int m_numHits;                         //!< The number of requests for frames that were already decoded.
+    unsigned int m_numMisses;                       //!< The number of requests decoded on the requesting thread.
+    unsigned int m_numWaits;                        //!< The number of requests that waited for a decoder to finish the frame.
+    unsigned int m_numPrefetched;                   //!< The number of frames decoded by the decoder threads.
+    unsigned int m_numEvicted;                      //!< The number of frames evicted to stay within the memory bound.
+};
+
+#endif // PLAYBACKCACHE_H
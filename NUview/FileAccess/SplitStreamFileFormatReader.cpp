@@ -1,15 +1,27 @@
 #include "SplitStreamFileFormatReader.h"
 #include <QDebug>
 
-SplitStreamFileFormatReader::SplitStreamFileFormatReader(QObject *parent): LogFileFormatReader(parent)
+// The memory used by the decoded frames. Images are by far the largest, and the slowest to read, so they get most of it.
+static const long long ImageCacheBytes = 256*1024*1024;
+static const long long SensorCacheBytes = 32*1024*1024;
+static const long long LocwmCacheBytes = 32*1024*1024;
+static const long long LocfrmCacheBytes = 32*1024*1024;
+
+SplitStreamFileFormatReader::SplitStreamFileFormatReader(QObject *parent): LogFileFormatReader(parent),
+    imageCache(ImageCacheBytes, 2), sensorCache(SensorCacheBytes), locwmCache(LocwmCacheBytes),
+    locfrmCache(LocfrmCacheBytes)
 {
     setKnownDataTypes();
     m_fileGood = false;
+    m_selectedFrameIndex = 0;
 }
 
-SplitStreamFileFormatReader::SplitStreamFileFormatReader(const QString& filename, QObject *parent): LogFileFormatReader(parent)
+SplitStreamFileFormatReader::SplitStreamFileFormatReader(const QString& filename, QObject *parent): LogFileFormatReader(parent),
+    imageCache(ImageCacheBytes, 2), sensorCache(SensorCacheBytes), locwmCache(LocwmCacheBytes),
+    locfrmCache(LocfrmCacheBytes)
 {
     m_fileGood = false;
+    m_selectedFrameIndex = 0;
     setKnownDataTypes();
     openFile(filename);
 }
@@ -20,17 +32,33 @@ SplitStreamFileFormatReader::~SplitStreamFileFormatReader()
 }
 const NUImage* SplitStreamFileFormatReader::GetImageData()
 {
-    return imageReader.ReadFrameNumber(m_currentFrameIndex);
+    return imageCache.ReadFrameNumber(m_currentFrameIndex);
 }
 
 const NUSensorsData* SplitStreamFileFormatReader::GetSensorData()
 {
-    return sensorReader.ReadFrameNumber(m_currentFrameIndex);
+    return sensorCache.ReadFrameNumber(m_currentFrameIndex);
 }
 
 const Localisation* SplitStreamFileFormatReader::GetLocalisationData()
 {
-    return locwmReader.ReadFrameNumber(m_currentFrameIndex);
+    if(locwmReader.IsValid())
+        return locwmCache.ReadFrameNumber(m_currentFrameIndex);
+    else
+        return ReadLocalisationFrame(m_currentFrameIndex);
+}
+
+/**
+  *     Read a frame from the binary localisation log, and copy its model bank into m_locfrmLocalisation.
+  *     @return The localisation, or NULL if the frame could not be read.
+  */
+const Localisation* SplitStreamFileFormatReader::ReadLocalisationFrame(int frameNumber)
+{
+    LocalisationFrame* frame = locfrmCache.ReadFrameNumber(frameNumber);
+    if(!frame)
+        return NULL;
+    frame->copyTo(m_locfrmLocalisation);
+    return &m_locfrmLocalisation;
 }
 
 const FieldObjects* SplitStreamFileFormatReader::GetObjectData()
@@ -42,7 +70,7 @@ void SplitStreamFileFormatReader::setKnownDataTypes()
 {
     m_dataIsSynced = true;
     m_extension = ".strm";
-    m_knownDataTypes << "image" << "sensor" << "locwm" << "object" << "locWmFrame";
+    m_knownDataTypes << "image" << "sensor" << "locwm" << "object" << "locWmFrame" << "locfrm";
 
     // Add the file readers.
     m_fileReaders.push_back(&imageReader);
@@ -50,6 +78,7 @@ void SplitStreamFileFormatReader::setKnownDataTypes()
     m_fileReaders.push_back(&locwmReader);
     m_fileReaders.push_back(&objectReader);
     m_fileReaders.push_back(&locmframeReader);
+    m_fileReaders.push_back(&locfrmReader);
 }
 
 std::vector<QFileInfo> SplitStreamFileFormatReader::FindValidFiles(const QDir& directory)
@@ -136,6 +165,12 @@ int SplitStreamFileFormatReader::openFile(const QString& filename)
         }
         m_totalFrames = totalFrames;
         m_directory = openDir;
+
+        // The frames are read through the caches, using the indexes built by the readers
+        imageCache.Open(imageReader);
+        sensorCache.Open(sensorReader);
+        locwmCache.Open(locwmReader);
+        locfrmCache.Open(locfrmReader);
     }
     if(m_totalFrames > 0)
     {
@@ -153,6 +188,11 @@ int SplitStreamFileFormatReader::openFile(const QString& filename)
 
 bool SplitStreamFileFormatReader::closeFile()
 {
+    imageCache.Close();
+    sensorCache.Close();
+    locwmCache.Close();
+    locfrmCache.Close();
+    m_selectedFrameIndex = 0;
     m_totalFrames = 0;
     m_currentFrameIndex = 0;
     return true;
@@ -209,18 +249,31 @@ int SplitStreamFileFormatReader::setFrame(int frameNumber)
     {
         if(imageReader.IsValid())
         {
-            emit rawImageChanged(imageReader.ReadFrameNumber(frameNumber));
-            m_currentFrameIndex = imageReader.CurrentFrameSequenceNumber();
+            NUImage* image = imageCache.ReadFrameNumber(frameNumber);
+            emit rawImageChanged(image);
+            if(image) m_selectedFrameIndex = frameNumber;
+            m_currentFrameIndex = m_selectedFrameIndex;
         }
         if(sensorReader.IsValid())
         {
-            emit sensorDataChanged(sensorReader.ReadFrameNumber(frameNumber));
-            m_currentFrameIndex = sensorReader.CurrentFrameSequenceNumber();
+            NUSensorsData* sensors = sensorCache.ReadFrameNumber(frameNumber);
+            emit sensorDataChanged(sensors);
+            if(sensors) m_selectedFrameIndex = frameNumber;
+            m_currentFrameIndex = m_selectedFrameIndex;
         }
         if(locwmReader.IsValid())
         {
-            emit LocalisationDataChanged(locwmReader.ReadFrameNumber(frameNumber));
-            m_currentFrameIndex = locwmReader.CurrentFrameSequenceNumber();
+            Localisation* localisation = locwmCache.ReadFrameNumber(frameNumber);
+            emit LocalisationDataChanged(localisation);
+            if(localisation) m_selectedFrameIndex = frameNumber;
+            m_currentFrameIndex = m_selectedFrameIndex;
+        }
+        else if(locfrmReader.IsValid())
+        {
+            const Localisation* localisation = ReadLocalisationFrame(frameNumber);
+            emit LocalisationDataChanged(localisation);
+            if(localisation) m_selectedFrameIndex = frameNumber;
+            m_currentFrameIndex = m_selectedFrameIndex;
         }
         //qDebug() << "Set Frame " << frameNumber << "at" << m_currentFrameIndex;
         //m_currentFrameIndex = imageReader.CurrentFrameSequenceNumber();
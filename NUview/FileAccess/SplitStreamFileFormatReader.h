@@ -2,6 +2,8 @@
 #define SPLITSTREAMFILEFORMATREADER_H
 #include "LogFileFormatReader.h"
 #include "StreamFileReader.h"
+#include "StreamPlaybackCache.h"
+#include "LocalisationFrameReader.h"
 #include "Infrastructure/NUImage/NUImage.h"
 #include "Localisation/Localisation.h"
 #include "Infrastructure/NUSensorsData/NUSensorsData.h"
@@ -46,11 +48,19 @@ protected:
     std::vector<QFileInfo> FindValidFiles(const QDir& directory);
     std::vector<IndexedFileReader*> m_fileReaders;
     void setKnownDataTypes();
+    const Localisation* ReadLocalisationFrame(int frameNumber);
     StreamFileReader<NUImage> imageReader;
     StreamFileReader<NUSensorsData> sensorReader;
     StreamFileReader<Localisation> locwmReader;
     StreamFileReader<FieldObjects> objectReader;
     StreamFileReader<LocWmFrame> locmframeReader;
+    LocalisationFrameReader locfrmReader;
+    StreamPlaybackCache<NUImage> imageCache;
+    StreamPlaybackCache<NUSensorsData> sensorCache;
+    StreamPlaybackCache<Localisation> locwmCache;
+    StreamPlaybackCache<LocalisationFrame> locfrmCache;
+    Localisation m_locfrmLocalisation;  //!< The model bank of the current frame from the binary localisation log.
+    int m_selectedFrameIndex;       //!< The last frame that was read successfully.
     QDir m_directory;
     QStringList m_knownDataTypes;
     QString m_extension;
@@ -0,0 +1,93 @@
+/*! @file StreamPlaybackCache.h
+    @brief Declaration and definition of the StreamPlaybackCache template class
+
+    @class StreamPlaybackCache
+    @brief A PlaybackCache for the timestamped data in a stream file indexed by a StreamFileReader.
+
+    The cache reads frames with the same stream operator as StreamFileReader, so it can be used in place of
+    StreamFileReader::ReadFrameNumber() once the reader has opened and indexed the file.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef STREAMPLAYBACKCACHE_H
+#define STREAMPLAYBACKCACHE_H
+#include "PlaybackCache.h"
+
+template<class C>
+class StreamPlaybackCache: public PlaybackCache
+{
+public:
+    /**
+      *     Constructor. See PlaybackCache for the parameters.
+      */
+    StreamPlaybackCache(long long maxBytes, int numDecoders = 1, int framesAhead = 8, int framesBehind = 4):
+            PlaybackCache(maxBytes, numDecoders, framesAhead, framesBehind)
+    {
+    }
+
+    /**
+      *     Destructor. The decoders are stopped here, because they use Decode().
+      */
+    ~StreamPlaybackCache()
+    {
+        StopDecoders();
+    }
+
+    /**
+      *     Read the element in the stream with the sequence number given, from the cache if it has already been decoded.
+      *     @param frameSequenceNumber The sequence number of the desired data. The first element is at sequence number 1.
+      *     @return A pointer to the object, which is valid until the next call. NULL is returned if an error occurs.
+      */
+    C* ReadFrameNumber(int frameSequenceNumber)
+    {
+        if(frameSequenceNumber < 1)
+            return NULL;
+        Frame* frame = static_cast<Frame*>(GetFrame(frameSequenceNumber));
+        if(frame)
+            return &frame->data;
+        else
+            return NULL;
+    }
+
+private:
+    /*! @brief A decoded object */
+    class Frame: public CachedFrame
+    {
+    public:
+        C data;
+    };
+
+    /**
+      *     Read an object from the stream, into the spare frame if there is one.
+      *     @return The decoded frame. NULL if the object could not be read.
+      */
+    CachedFrame* Decode(std::istream& stream, CachedFrame* spare)
+    {
+        Frame* frame = spare ? static_cast<Frame*>(spare) : new Frame();
+        try{
+            stream >> frame->data;
+            if(!stream.fail())
+                return frame;
+        }   catch(...){}
+        delete frame;
+        return NULL;
+    }
+};
+
+#endif // STREAMPLAYBACKCACHE_H
@@ -43,6 +43,7 @@ HEADERS += ui_mainwindow.h \
     ../Tools/FileFormats/NUbotImage.h \
     ../Vision/Vision.h \
     ../Tools/FileFormats/LUTTools.h \
+    ../Tools/FileFormats/CompactLUT.h \
     virtualnubot.h \
     ../Infrastructure/NUImage/BresenhamLine.h \
     ../Tools/Math/Vector2.h \
@@ -60,6 +61,10 @@ HEADERS += ui_mainwindow.h \
     locWmGlDisplay.h \
     ../Vision/LineDetection.h \
     ../Tools/Math/LSFittedLine.h \
+    ../Tools/Math/LineMoments.h \
+    ../Tools/Math/LineFitter.h \
+    ../Tools/Memory/FrameArena.h \
+    ../Tools/Memory/ArenaAllocator.h \
     ../Tools/Math/Vector3.h \
     ../Infrastructure/FieldObjects/StationaryObject.h \
     ../Infrastructure/FieldObjects/Self.h \
@@ -67,7 +72,8 @@ HEADERS += ui_mainwindow.h \
     ../Infrastructure/FieldObjects/MobileObject.h \
     ../Infrastructure/FieldObjects/AmbiguousObject.h \
     ../Infrastructure/FieldObjects/FieldObjects.h \
-    ../Vision/Threads/SaveImagesThread.h \
+    ../Infrastructure/FieldObjects/FieldObjectsSnapshots.h \
+    ../Vision/Threads/ImageLoggerThread.h \
     ../Vision/ObjectCandidate.h \
     ../Localisation/WMPoint.h \
     ../Localisation/WMLine.h \
@@ -77,6 +83,8 @@ HEADERS += ui_mainwindow.h \
     ../Tools/Math/matrix.h \
     localisationwidget.h \
     ../Vision/Ball.h \
+    ../Vision/ROITracker.h \
+    ../Vision/CameraRayTable.h \
     ../Vision/CircleFitting.h \
     FileAccess/LogFileFormatReader.h \
     FileAccess/nifVersion1FormatReader.h \
@@ -85,6 +93,7 @@ HEADERS += ui_mainwindow.h \
     visionstreamwidget.h \
     camerasettingswidget.h \
     ../NUPlatform/NUCamera/CameraSettings.h \
+    ../NUPlatform/NUCamera/CameraBufferRing.h \
     ../Tools/FileFormats/Parse.h \
     ../Localisation/KF.h \
     ../Localisation/Localisation.h \
@@ -93,6 +102,8 @@ HEADERS += ui_mainwindow.h \
     ../Tools/Threading/Thread.h \
     ../Tools/Threading/ConditionalThread.h \
     ../Tools/Threading/PeriodicThread.h \
+    ../Tools/Threading/ThreadPlacement.h \
+    ../Tools/Threading/SnapshotBuffer.h \
     NUviewIO/NUviewIO.h \
     ../Kinematics/Kinematics.h \
     ../Tools/Math/TransformMatrices.h \
@@ -113,8 +124,10 @@ HEADERS += ui_mainwindow.h \
     ../Tools/FileFormats/TimestampedData.h \
     FileAccess/ImageStreamFileReader.h \
     ../Motion/Tools/MotionScript.h \
+    ../Motion/Tools/MotionScriptFile.h \
     ../Motion/Tools/MotionCurves.h \
     ../Vision/EllipseFit.h \
+    ../Vision/DirectFitting.h \
     ../Vision/EllipseFitting/tnt_version.h \
     ../Vision/EllipseFitting/tnt_vec.h \
     ../Vision/EllipseFitting/tnt_subscript.h \
@@ -151,7 +164,11 @@ HEADERS += ui_mainwindow.h \
     ../NUPlatform/NUCamera.h \
     ../Vision/fitellipsethroughcircle.h \
     ../Localisation/LocWmFrame.h \
+    ../Localisation/LocalisationFrame.h \
     FileAccess/IndexedFileReader.h \
+    FileAccess/PlaybackCache.h \
+    FileAccess/StreamPlaybackCache.h \
+    FileAccess/LocalisationFrameReader.h \
     LUTGlDisplay.h \
     ../Vision/SplitAndMerge/SAM.h \
     ../NUPlatform/NUSensors/EndEffectorTouch.h \
@@ -177,6 +194,7 @@ SOURCES += mainwindow.cpp \
     ../Tools/FileFormats/NUbotImage.cpp \
     ../Vision/Vision.cpp \
     ../Tools/FileFormats/LUTTools.cpp \
+    ../Tools/FileFormats/CompactLUT.cpp \
     virtualnubot.cpp \
     ../Infrastructure/NUImage/BresenhamLine.cpp \
     ../Tools/Math/Line.cpp \
@@ -203,6 +221,7 @@ SOURCES += mainwindow.cpp \
     $$files(../NUPlatform/NUActionators/*.cpp) \
     $$files(../Infrastructure/NUActionatorsData/*.cpp) \
     ../Infrastructure/TeamInformation/TeamInformation.cpp \
+    ../Infrastructure/TeamInformation/TeamPacketCodec.cpp \
     $$files(../Infrastructure/Jobs/*.cpp) \
     $$files(../Infrastructure/Jobs/CameraJobs/*.cpp) \
     $$files(../Infrastructure/Jobs/VisionJobs/*.cpp) \
@@ -211,13 +230,17 @@ SOURCES += mainwindow.cpp \
     ../Vision/ObjectCandidate.cpp \
     ../Vision/LineDetection.cpp \
     ../Tools/Math/LSFittedLine.cpp \
+    ../Tools/Math/LineMoments.cpp \
+    ../Tools/Math/LineFitter.cpp \
+    ../Tools/Memory/FrameArena.cpp \
     ../Infrastructure/FieldObjects/StationaryObject.cpp \
     ../Infrastructure/FieldObjects/Self.cpp \
     ../Infrastructure/FieldObjects/Object.cpp \
     ../Infrastructure/FieldObjects/MobileObject.cpp \
     ../Infrastructure/FieldObjects/AmbiguousObject.cpp \
     ../Infrastructure/FieldObjects/FieldObjects.cpp \
-    ../Vision/Threads/SaveImagesThread.cpp \
+    ../Infrastructure/FieldObjects/FieldObjectsSnapshots.cpp \
+    ../Vision/Threads/ImageLoggerThread.cpp \
     ../Localisation/WMPoint.cpp \
     ../Localisation/WMLine.cpp \
     ../Localisation/sphere.cpp \
@@ -226,6 +249,8 @@ SOURCES += mainwindow.cpp \
     ../Tools/Math/matrix.cpp \
     localisationwidget.cpp \
     ../Vision/Ball.cpp \
+    ../Vision/ROITracker.cpp \
+    ../Vision/CameraRayTable.cpp \
     ../Vision/CircleFitting.cpp \
     FileAccess/LogFileFormatReader.cpp \
     FileAccess/nifVersion1FormatReader.cpp \
@@ -234,6 +259,7 @@ SOURCES += mainwindow.cpp \
     visionstreamwidget.cpp \
     camerasettingswidget.cpp \
     ../NUPlatform/NUCamera/CameraSettings.cpp \
+    ../NUPlatform/NUCamera/CameraBufferRing.cpp \
     ../Tools/FileFormats/Parse.cpp \
     ../Localisation/KF.cpp \
     ../Localisation/Localisation.cpp \
@@ -242,6 +268,7 @@ SOURCES += mainwindow.cpp \
     ../Tools/Threading/Thread.cpp \
     ../Tools/Threading/ConditionalThread.cpp \
     ../Tools/Threading/PeriodicThread.cpp \
+    ../Tools/Threading/ThreadPlacement.cpp \
     ../Kinematics/Kinematics.cpp \
     ../Tools/Math/TransformMatrices.cpp \
     frameInformationWidget.cpp \
@@ -251,8 +278,10 @@ SOURCES += mainwindow.cpp \
     ../Kinematics/EndEffector.cpp \
     ../Kinematics/OrientationUKF.cpp \
     ../Motion/Tools/MotionScript.cpp \
+    ../Motion/Tools/MotionScriptFile.cpp \
     ../Motion/Tools/MotionCurves.cpp \
     ../Vision/EllipseFit.cpp \
+    ../Vision/DirectFitting.cpp \
     ../Localisation/odometryMotionModel.cpp \
     ../Localisation/probabilityUtils.cpp \
     FileAccess/SplitStreamFileFormatReader.cpp \
@@ -263,7 +292,10 @@ SOURCES += mainwindow.cpp \
     ../NUPlatform/NUCamera.cpp \
     ../Vision/fitellipsethroughcircle.cpp \
     ../Localisation/LocWmFrame.cpp \
+    ../Localisation/LocalisationFrame.cpp \
     FileAccess/IndexedFileReader.cpp \
+    FileAccess/PlaybackCache.cpp \
+    FileAccess/LocalisationFrameReader.cpp \
     LUTGlDisplay.cpp \
     ../Vision/SplitAndMerge/SAM.cpp \
     ../NUPlatform/NUSensors/EndEffectorTouch.cpp \
@@ -231,7 +231,7 @@ void virtualNUbot::processVisionFrame(const NUImage* image)
     //qDebug() << "Generate Classified Image: finnished";
 
     //! Find the green edges
-    std::vector< Vector2<int> > greenPoints = vision.findGreenBorderPoints(spacings,&horizonLine);
+    std::vector< Vector2<int> > greenPoints = vision.findGreenBorderPoints(vision.getGreenBorderSpacing(spacings),&horizonLine);
     emit pointsDisplayChanged(points,GLDisplay::greenHorizonScanPoints);
     //qDebug() << "Find Edges: finnished";
     //! Find the Field border
@@ -0,0 +1,115 @@
+/*! @file AllocationCounter.cpp
+    @brief Implementation of the AllocationCounter, and the replacement global operator new and delete
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+static volatile unsigned long long NumAllocations = 0;      //!< the number of calls to operator new
+static volatile unsigned long long NumBytes = 0;            //!< the total number of bytes requested from operator new
+
+/*! @brief Returns the number of calls to the global operator new since the start of the program */
+unsigned long long AllocationCounter::getNumAllocations()
+{
+    return __sync_fetch_and_add(&NumAllocations, 0);
+}
+
+/*! @brief Returns the number of bytes requested from the global operator new since the start of the program */
+unsigned long long AllocationCounter::getNumBytes()
+{
+    return __sync_fetch_and_add(&NumBytes, 0);
+}
+
+/*! @brief Counts an allocation, and allocates the memory with malloc */
+static void* countedAllocate(std::size_t size)
+{
+    __sync_fetch_and_add(&NumAllocations, 1);
+    __sync_fetch_and_add(&NumBytes, size);
+    if (size == 0)
+        size = 1;
+    void* p = std::malloc(size);
+    while (p == 0)
+    {
+        std::new_handler handler = std::set_new_handler(0);
+        std::set_new_handler(handler);
+        if (handler == 0)
+            throw std::bad_alloc();
+        handler();
+        p = std::malloc(size);
+    }
+    return p;
+}
+
+void* operator new(std::size_t size) throw(std::bad_alloc)
+{
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size) throw(std::bad_alloc)
+{
+    return countedAllocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) throw()
+{
+    try
+    {
+        return countedAllocate(size);
+    }
+    catch (...)
+    {
+        return 0;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) throw()
+{
+    try
+    {
+        return countedAllocate(size);
+    }
+    catch (...)
+    {
+        return 0;
+    }
+}
+
+void operator delete(void* p) throw()
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) throw()
+{
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) throw()
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) throw()
+{
+    std::free(p);
+}
+
@@ -0,0 +1,45 @@
+/*! @file AllocationCounter.h
+    @brief Declaration of the AllocationCounter class
+
+    @class AllocationCounter
+    @brief Counts the calls to the global operator new made by the benchmark executable.
+
+    AllocationCounter.cpp replaces the global operator new and delete of the benchmark executable with versions
+    that count the number of allocations and the number of bytes requested, and otherwise behave like the
+    standard ones. The counts are updated atomically, so allocations made by the threads a benchmark starts
+    are counted too.
+
+    Memory taken from a FrameArena, or any other class specific operator new, is not counted.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+class AllocationCounter
+{
+public:
+    static unsigned long long getNumAllocations();
+    static unsigned long long getNumBytes();
+private:
+    AllocationCounter();
+};
+
+#endif
+
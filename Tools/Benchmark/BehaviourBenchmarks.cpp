@@ -0,0 +1,156 @@
+/*! @file BehaviourBenchmarks.cpp
+    @brief Benchmarks of the potentials a soccer behaviour evaluates each think cycle
+
+    Each run is a new frame: the robot and the ball move, and the behaviour goes to the ball while it avoids
+    two robots, sums the potentials and dodges the obstacles seen by the ultrasonics. This is done with the
+    BehaviourPotentials functions, and with the PotentialField that the chase, positioning and ready states use.
+    The PotentialField's set up checks that both give the same potentials over a few laps of the robot and ball.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.h"
+
+#include "Behaviour/BehaviourPotentials.h"
+#include "Behaviour/PotentialField.h"
+#include "Infrastructure/NUBlackboard.h"
+#include "Infrastructure/FieldObjects/FieldObjects.h"
+#include "Infrastructure/NUSensorsData/NUSensorsData.h"
+
+#include <cmath>
+#include <vector>
+using namespace std;
+
+static const float Heading = 0.3;               //!< the bearing to the opponent's goal
+
+/*! @brief Moves the robot and the ball to where they are in the given frame */
+static void moveObjects(FieldObjects& objects, unsigned int frame)
+{
+    float t = 0.01*frame;
+    Self& self = objects.self;
+    MobileObject& ball = objects.mobileFieldObjects[FieldObjects::FO_BALL];
+    self.updateLocationOfSelf(-150 + 50*cos(t), 100*sin(t), 0.5*sin(t), 15, 15, 0.1, false);
+    ball.updateObjectLocation(50*sin(3*t), 30*sin(2*t), 10, 10);
+    float dx = ball.X() - self.wmX();
+    float dy = ball.Y() - self.wmY();
+    ball.updateEstimatedRelativeVariables(sqrt(dx*dx + dy*dy), mathGeneral::normaliseAngle(atan2(dy, dx) - self.Heading()), 0);
+}
+
+/*! @brief The potentials of one chase frame, with either the BehaviourPotentials or the PotentialField */
+class ChasePotentialsBenchmark : public Benchmark
+{
+public:
+    ChasePotentialsBenchmark(const string& group, const string& name, bool field) : Benchmark(group, name), m_use_field(field) {}
+    void setUp()
+    {
+        m_objects = new FieldObjects();
+        m_field = new PotentialField();
+        m_frame = 0;
+        m_robot_a = vector<float>(3, 0);
+        m_robot_a[0] = -80;
+        m_robot_a[1] = 20;
+        m_robot_b = vector<float>(3, 0);
+        m_robot_b[0] = 10;
+        m_robot_b[1] = -60;
+        if (m_use_field)
+            checkSamePotentials();
+    }
+    void run()
+    {
+        moveObjects(*m_objects, m_frame++);
+        Vector3<float> potentials[4];
+        if (m_use_field)
+            fieldPotentials(potentials);
+        else
+            behaviourPotentials(potentials);
+        m_speed = potentials[3].x;
+        benchmarkUse(m_speed);
+    }
+    void tearDown()
+    {
+        m_frame = 0;                        // the first frame is evaluated again so that both report the same frame
+        run();
+        addMetric("forward speed", m_speed, "");
+        delete m_field;
+        delete m_objects;
+    }
+private:
+    /*! @brief Evaluates the frame's potentials with the PotentialField
+        @param potentials set to the ball, robot a and robot b potentials, and the summed potential after the obstacles are dodged
+     */
+    void fieldPotentials(Vector3<float>* potentials)
+    {
+        m_field->update(m_objects, Blackboard->Sensors);
+        potentials[0] = m_field->goToBall(Heading);
+        potentials[1] = m_field->avoidFieldState(m_robot_a[0], m_robot_a[1]);
+        potentials[2] = m_field->avoidFieldState(m_robot_b[0], m_robot_b[1]);
+        potentials[3] = m_field->sensorAvoidObjects(PotentialField::sumPotentials(potentials, 3));
+    }
+    /*! @brief Evaluates the frame's potentials with the BehaviourPotentials, returning them as fieldPotentials() does */
+    void behaviourPotentials(Vector3<float>* potentials)
+    {
+        Self& self = m_objects->self;
+        MobileObject& ball = m_objects->mobileFieldObjects[FieldObjects::FO_BALL];
+        vector<vector<float> > results;
+        results.push_back(BehaviourPotentials::goToBall(ball, self, Heading));
+        results.push_back(BehaviourPotentials::avoidFieldState(self, m_robot_a));
+        results.push_back(BehaviourPotentials::avoidFieldState(self, m_robot_b));
+        results.push_back(BehaviourPotentials::sensorAvoidObjects(BehaviourPotentials::sumPotentials(results), Blackboard->Sensors));
+        for (size_t i=0; i<results.size(); i++)
+            potentials[i] = Vector3<float>(results[i][0], results[i][1], results[i][2]);
+    }
+    /*! @brief Returns the largest difference between two potentials' velocities, comparing the translation as x and y so that the direction of a small speed does not matter */
+    static float difference(const Vector3<float>& a, const Vector3<float>& b)
+    {
+        float dx = a.x*cos(a.y) - b.x*cos(b.y);
+        float dy = a.x*sin(a.y) - b.x*sin(b.y);
+        return max(sqrt(dx*dx + dy*dy), fabs(a.z - b.z));
+    }
+    /*! @brief Checks that the PotentialField gives the same potentials as the BehaviourPotentials over a few laps of the robot and ball */
+    void checkSamePotentials()
+    {
+        float maxdifference = 0;
+        float maxspeed = 0;
+        for (unsigned int frame=0; frame<NumCheckFrames; frame++)
+        {
+            moveObjects(*m_objects, frame);
+            Vector3<float> field[4], behaviour[4];
+            fieldPotentials(field);
+            behaviourPotentials(behaviour);
+            for (int i=0; i<4; i++)
+            {
+                maxdifference = max(maxdifference, difference(field[i], behaviour[i]));
+                maxspeed = max(maxspeed, fabs(behaviour[i].x));
+            }
+        }
+        addMetric("max potential difference", maxdifference, "");
+        check(maxspeed > 0, "the potentials move the robot");
+        check(maxdifference < 1e-3, "the PotentialField gives the same potentials as the BehaviourPotentials");
+    }
+private:
+    static const unsigned int NumCheckFrames = 2000;        //!< the number of frames compared, which is a few laps of the robot and the ball
+    bool m_use_field;
+    FieldObjects* m_objects;
+    PotentialField* m_field;
+    vector<float> m_robot_a, m_robot_b;
+    float m_speed;
+    unsigned int m_frame;
+};
+static ChasePotentialsBenchmark chasebehaviourpotentials("Behaviour", "ChaseBehaviourPotentials", false);
+static ChasePotentialsBenchmark chasepotentialfield("Behaviour", "ChasePotentialField", true);
+
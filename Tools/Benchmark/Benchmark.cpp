@@ -0,0 +1,114 @@
+/*! @file Benchmark.cpp
+    @brief Implementation of the Benchmark base class
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.h"
+
+#include <algorithm>
+
+using namespace std;
+
+/*! @brief Constructs and registers a benchmark
+    @param group the group the benchmark belongs to, usually the module being measured
+    @param name the name of the benchmark, which must be unique within its group
+ */
+Benchmark::Benchmark(const string& group, const string& name) : m_group(group), m_name(name)
+{
+    registry().push_back(this);
+}
+
+Benchmark::~Benchmark()
+{
+    vector<Benchmark*>& benchmarks = registry();
+    for (size_t i=0; i<benchmarks.size(); i++)
+    {
+        if (benchmarks[i] == this)
+        {
+            benchmarks.erase(benchmarks.begin() + i);
+            break;
+        }
+    }
+}
+
+/*! @brief Prepares the inputs for the benchmark. This is called once before the benchmark is timed. */
+void Benchmark::setUp()
+{
+}
+
+/*! @brief Releases anything acquired in setUp(). This is called once after the benchmark has been timed. */
+void Benchmark::tearDown()
+{
+}
+
+/*! @brief Returns the group and name of the benchmark, as group/name */
+string Benchmark::getFullName() const
+{
+    return m_group + "/" + m_name;
+}
+
+/*! @brief Removes the metrics and failed checks of the last run */
+void Benchmark::clearMetrics()
+{
+    m_metrics.clear();
+    m_failures.clear();
+}
+
+/*! @brief Adds a result other than the timing to the benchmark's results
+    @param name the name of the metric, which must be unique within the benchmark
+    @param value the value of the metric
+    @param unit the unit of the value
+ */
+void Benchmark::addMetric(const string& name, double value, const string& unit)
+{
+    Metric metric;
+    metric.Name = name;
+    metric.Value = value;
+    metric.Unit = unit;
+    m_metrics.push_back(metric);
+}
+
+/*! @brief Checks a result of the benchmark. A check that fails is reported with the benchmark's results, once no matter
+           how many times it fails, and makes the benchmark executable exit with 1.
+    @param condition true if the result is correct
+    @param description what was checked, for example "the CoM trajectories agree to within 0.1mm"
+    @return condition
+ */
+bool Benchmark::check(bool condition, const string& description)
+{
+    if (not condition and find(m_failures.begin(), m_failures.end(), description) == m_failures.end())
+        m_failures.push_back(description);
+    return condition;
+}
+
+/*! @brief Returns every registered benchmark, in the order they were constructed */
+const vector<Benchmark*>& Benchmark::getBenchmarks()
+{
+    return registry();
+}
+
+/*! @brief Returns the list of registered benchmarks. The list is a function static so that it is constructed before
+           the benchmarks, which are static instances spread over several translation units.
+ */
+vector<Benchmark*>& Benchmark::registry()
+{
+    static vector<Benchmark*> benchmarks;
+    return benchmarks;
+}
+
@@ -0,0 +1,94 @@
+/*! @file Benchmark.h
+    @brief Declaration of the Benchmark base class
+
+    @class Benchmark
+    @brief A microbenchmark of a single hot path, run and timed by the BenchmarkRunner.
+
+    A benchmark derives from Benchmark, and implements run() to execute one call of the code being measured.
+    The expensive preparation (loading models, recording inputs, filling buffers) goes in setUp(), which is called
+    once before the benchmark is timed, and anything that needs to be undone goes in tearDown().
+
+    Each benchmark is registered when it is constructed, so a benchmark is added to the suite by defining a
+    static instance of it in one of the *Benchmarks.cpp files:
+    @code
+    static MatrixMultiplyBenchmark matrixmultiply4("Math", "MatrixMultiply4x4", 4);
+    @endcode
+
+    Results that are not timings (the size of a frame, the agreement between two implementations, etc) are
+    reported with addMetric() from setUp() or tearDown(), and are written along with the timings.
+
+    A benchmark that compares two implementations, or replays recorded data, checks its results with check().
+    A failed check is reported with the benchmark's results, and the benchmark executable exits with 1, so the
+    suite doubles as a test of the code it measures (ctest runs it with a few samples).
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <vector>
+
+class Benchmark
+{
+public:
+    /*! @brief A result of a benchmark other than its timing */
+    struct Metric
+    {
+        std::string Name;           //!< the name of the metric
+        double Value;               //!< the value of the metric
+        std::string Unit;           //!< the unit of the value
+    };
+public:
+    Benchmark(const std::string& group, const std::string& name);
+    virtual ~Benchmark();
+
+    virtual void setUp();
+    /*! @brief Executes one call of the code being measured */
+    virtual void run() = 0;
+    virtual void tearDown();
+
+    const std::string& getGroup() const {return m_group;}
+    const std::string& getName() const {return m_name;}
+    std::string getFullName() const;
+    const std::vector<Metric>& getMetrics() const {return m_metrics;}
+    const std::vector<std::string>& getFailures() const {return m_failures;}
+    void clearMetrics();
+
+    static const std::vector<Benchmark*>& getBenchmarks();
+protected:
+    void addMetric(const std::string& name, double value, const std::string& unit);
+    bool check(bool condition, const std::string& description);
+private:
+    static std::vector<Benchmark*>& registry();
+private:
+    std::string m_group;                    //!< the group the benchmark belongs to, usually the module being measured
+    std::string m_name;                     //!< the name of the benchmark, which must be unique within its group
+    std::vector<Metric> m_metrics;          //!< the metrics added by the last run of the benchmark
+    std::vector<std::string> m_failures;    //!< the descriptions of the checks that failed in the last run of the benchmark
+};
+
+/*! @brief Prevents the compiler from optimising away a value computed by a benchmark */
+template <typename T> inline void benchmarkUse(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+#endif
+
@@ -0,0 +1,54 @@
+/*! @file BenchmarkActionators.cpp
+    @brief Implementation of the BenchmarkActionators class
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "BenchmarkActionators.h"
+#include "BenchmarkPlatform.h"
+#include "Infrastructure/NUActionatorsData/NUActionatorsData.h"
+
+using namespace std;
+
+// the LEDs and other actionators of the NAO, in the order used by NAOWebotsActionators
+static string temp_other_names[] = {string("Ears/Led/Left"), string("Ears/Led/Right"), string("Face/Led/Left"), string("Face/Led/Right"), \
+                                    string("ChestBoard/Led"), \
+                                    string("LFoot/Led"), string("RFoot/Led"), \
+                                    string("Sound")};
+
+BenchmarkActionators::BenchmarkActionators(BenchmarkPlatform* platform)
+{
+    m_platform = platform;
+    m_current_time = 0;
+
+    vector<string> names(BenchmarkPlatform::getServoNames());
+    names.insert(names.end(), temp_other_names, temp_other_names + sizeof(temp_other_names)/sizeof(*temp_other_names));
+    m_data->addActionators(names);
+}
+
+BenchmarkActionators::~BenchmarkActionators()
+{
+}
+
+/*! @brief Sends the next servo targets and gains to the simulated servos */
+void BenchmarkActionators::copyToHardwareCommunications()
+{
+    m_data->getNextServos(m_positions, m_gains);
+    m_platform->setServoTargets(m_positions, m_gains);
+}
+
@@ -0,0 +1,50 @@
+/*! @file BenchmarkActionators.h
+    @brief Declaration of the BenchmarkActionators class
+
+    @class BenchmarkActionators
+    @brief The actionators of the BenchmarkPlatform, which send the servo targets to the simulated servos.
+
+    The LEDs are added so that the modules that use them find them, but like the sound they go nowhere.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BENCHMARKACTIONATORS_H
+#define BENCHMARKACTIONATORS_H
+
+#include "NUPlatform/NUActionators.h"
+class BenchmarkPlatform;
+
+#include <vector>
+using namespace std;
+
+class BenchmarkActionators : public NUActionators
+{
+public:
+    BenchmarkActionators(BenchmarkPlatform* platform);
+    ~BenchmarkActionators();
+protected:
+    void copyToHardwareCommunications();
+private:
+    BenchmarkPlatform* m_platform;              //!< the platform the actionators belong to
+    vector<float> m_positions;                  //!< the servo positions sent to the platform in the last update
+    vector<float> m_gains;                      //!< the servo gains sent to the platform in the last update
+};
+
+#endif
+
@@ -0,0 +1,143 @@
+/*! @file BenchmarkMain.cpp
+    @brief The benchmark executable; runs the benchmarks, writes their results and compares them with a baseline.
+
+    Usage:
+    @verbatim
+    benchmark [--list] [--filter <text>] [--samples <n>] [--max-time <s>] [--recording <sensor.strm>]
+              [--output <results.csv>] [--baseline <baseline.csv>] [--tolerance <percent>]
+    @endverbatim
+    The results are written to benchmark.csv unless another file is given. The program exits with 1 if any
+    benchmark fails one of its checks, or, when a baseline is given, if any benchmark has regressed, so it can be
+    used in a script.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "BenchmarkRunner.h"
+#include "BenchmarkPlatform.h"
+#include "SensorRecording.h"
+
+#include "debug.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <iostream>
+using namespace std;
+
+ofstream debug;
+ofstream errorlog;
+
+static void printUsage(const char* name)
+{
+    cout << "Usage: " << name << " [options]" << endl;
+    cout << "  --list                   list the benchmarks and exit" << endl;
+    cout << "  --filter <text>          only run the benchmarks whose name contains text" << endl;
+    cout << "  --samples <n>            the number of samples to take of each benchmark (default 1000)" << endl;
+    cout << "  --max-time <s>           the longest time to spend on each benchmark (default 2)" << endl;
+    cout << "  --recording <file>       replay the sensor data in file (a NUSensorsData stream) instead of generating it" << endl;
+    cout << "  --output <file>          write the results to file (default benchmark.csv)" << endl;
+    cout << "  --baseline <file>        compare the results with those in file, and exit with 1 if any have regressed" << endl;
+    cout << "  --tolerance <percent>    the increase in the median time that is a regression (default 10)" << endl;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkRunner runner;
+    bool listonly = false;
+    string recording;
+    string output = "benchmark.csv";
+    string baseline;
+    double tolerance = 10;
+
+    for (int i=1; i<argc; i++)
+    {
+        string option(argv[i]);
+        bool hasvalue = i + 1 < argc;
+        if (option == "--list")
+            listonly = true;
+        else if (option == "--filter" and hasvalue)
+            runner.setFilter(argv[++i]);
+        else if (option == "--samples" and hasvalue)
+            runner.setNumSamples(atoi(argv[++i]));
+        else if (option == "--max-time" and hasvalue)
+            runner.setMaxTime(atof(argv[++i]));
+        else if (option == "--recording" and hasvalue)
+            recording = argv[++i];
+        else if (option == "--output" and hasvalue)
+            output = argv[++i];
+        else if (option == "--baseline" and hasvalue)
+            baseline = argv[++i];
+        else if (option == "--tolerance" and hasvalue)
+            tolerance = atof(argv[++i]);
+        else
+        {
+            printUsage(argv[0]);
+            return option == "--help" ? 0 : 2;
+        }
+    }
+
+    if (listonly)
+    {
+        runner.list(cout);
+        return 0;
+    }
+
+    debug.open("/dev/null");
+    errorlog.open("benchmarkerrorlog.log");
+
+    BenchmarkPlatform* platform = new BenchmarkPlatform();
+    if (not recording.empty())
+    {
+        if (not SensorRecording::loadDefault(recording))
+        {
+            cerr << "Unable to load the recording " << recording << endl;
+            return 2;
+        }
+        cout << "Replaying " << SensorRecording::getDefault().size() << " frames from " << recording << endl;
+    }
+
+    runner.run(cout);
+    int result = 0;
+    if (runner.getNumFailed() > 0)
+    {
+        cout << runner.getNumFailed() << " benchmark(s) failed their checks" << endl;
+        result = 1;
+    }
+    if (not runner.write(output))
+    {
+        cerr << "Unable to write the results to " << output << endl;
+        result = 2;
+    }
+    if (not baseline.empty())
+    {
+        cout << endl;
+        int numregressions = runner.compare(baseline, tolerance/100, cout);
+        if (numregressions < 0)
+        {
+            cerr << "Unable to read the baseline " << baseline << endl;
+            result = 2;
+        }
+        else if (numregressions > 0)
+            result = 1;
+    }
+
+    delete platform;
+    return result;
+}
+
@@ -0,0 +1,147 @@
+/*! @file BenchmarkPlatform.cpp
+    @brief Implementation of the BenchmarkPlatform class
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "BenchmarkPlatform.h"
+#include "BenchmarkSensors.h"
+#include "BenchmarkActionators.h"
+
+#include "Infrastructure/NUBlackboard.h"
+
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+const double BenchmarkPlatform::Period = 10;
+
+// the servos of the NAO, in the order used by NAOWebotsSensors and NAOWebotsActionators
+static string temp_servo_names[] = {string("HeadPitch"), string("HeadYaw"), \
+                                    string("LShoulderRoll"), string("LShoulderPitch"), string("LElbowRoll"), string("LElbowYaw"), \
+                                    string("RShoulderRoll"), string("RShoulderPitch"), string("RElbowRoll"), string("RElbowYaw"), \
+                                    string("LHipRoll"),  string("LHipPitch"), string("LHipYawPitch"), string("LKneePitch"), string("LAnkleRoll"), string("LAnklePitch"), \
+                                    string("RHipRoll"),  string("RHipPitch"), string("RHipYawPitch"), string("RKneePitch"), string("RAnkleRoll"), string("RAnklePitch")};
+static vector<string> servo_names(temp_servo_names, temp_servo_names + sizeof(temp_servo_names)/sizeof(*temp_servo_names));
+
+BenchmarkPlatform::BenchmarkPlatform()
+{
+    m_time = 0;
+    m_tick_count = 0;
+    m_replay = 0;
+    m_positions = vector<float>(servo_names.size(), 0);
+    m_targets = vector<float>(servo_names.size(), 0);
+    m_stiffnesses = vector<float>(servo_names.size(), 0);
+    init();
+
+    m_sensors = new BenchmarkSensors(this);
+    m_actionators = new BenchmarkActionators(this);
+
+    Blackboard = new NUBlackboard();
+    Blackboard->add(getNUSensorsData());
+    Blackboard->add(getNUActionatorsData());
+}
+
+BenchmarkPlatform::~BenchmarkPlatform()
+{
+    delete Blackboard;
+    Blackboard = 0;
+}
+
+/*! @brief Returns the simulated time in ms */
+double BenchmarkPlatform::getTime()
+{
+    return m_time;
+}
+
+/*! @brief Advances the simulated time by one period, moves the servos and updates the sensors */
+void BenchmarkPlatform::tick()
+{
+    m_time += Period;
+    m_tick_count++;
+    moveServos(Period/1000);
+    updateSensors();
+}
+
+/*! @brief Replays the recording instead of simulating the sensors
+    @param recording the recording to replay, or NULL to go back to simulating the sensors
+ */
+void BenchmarkPlatform::replay(const SensorRecording* recording)
+{
+    m_replay = recording;
+    m_tick_count = 0;
+}
+
+/*! @brief Returns the names of the servos, in the order they are stored in the sensors and actionators */
+const vector<string>& BenchmarkPlatform::getServoNames()
+{
+    return servo_names;
+}
+
+/*! @brief Sets the targets and stiffnesses of the servos. A NaN leaves the previous value unchanged */
+void BenchmarkPlatform::setServoTargets(const vector<float>& targets, const vector<float>& stiffnesses)
+{
+    for (size_t i=0; i<m_targets.size() and i<targets.size(); i++)
+    {
+        if (not isnan(targets[i]))
+            m_targets[i] = targets[i];
+    }
+    for (size_t i=0; i<m_stiffnesses.size() and i<stiffnesses.size(); i++)
+    {
+        if (not isnan(stiffnesses[i]))
+            m_stiffnesses[i] = stiffnesses[i];
+    }
+}
+
+/*! @brief Moves each servo towards its target. A servo without stiffness does not move.
+    @param dt the time step in seconds
+ */
+void BenchmarkPlatform::moveServos(float dt)
+{
+    const float maxvelocity = 7.0;              // rad/s about the fastest a NAO servo can move
+    for (size_t i=0; i<m_positions.size(); i++)
+    {
+        if (m_stiffnesses[i] <= 0)
+            continue;
+        float timeconstant = 0.02 + 0.0008*(100 - min(m_stiffnesses[i], 100.0f));
+        float step = (m_targets[i] - m_positions[i])*min(dt/timeconstant, 1.0f);
+        step = max(-maxvelocity*dt, min(maxvelocity*dt, step));
+        m_positions[i] += step;
+    }
+}
+
+void BenchmarkPlatform::initName()
+{
+    m_name = "benchmark";
+}
+
+void BenchmarkPlatform::initNumber()
+{
+    m_robot_number = 1;
+}
+
+void BenchmarkPlatform::initTeam()
+{
+    m_team_number = 0;
+}
+
+void BenchmarkPlatform::initMAC()
+{
+    m_mac_address = "00-00-00-00-00-00";
+}
+
@@ -0,0 +1,84 @@
+/*! @file BenchmarkPlatform.h
+    @brief Declaration of the BenchmarkPlatform class
+
+    @class BenchmarkPlatform
+    @brief A simulated NAO for the benchmarks that need a platform, sensors and actionators.
+
+    The platform has a simulated clock, which is advanced by one sense-move period by each call to tick(),
+    so the modules being benchmarked see the same time steps no matter how long the benchmark takes.
+    The servos are simulated as a first order lag towards their targets, with a time constant that
+    shrinks with the stiffness, and the inertial and foot sensors are derived from the servo positions.
+    This is not a physics simulation; it only produces sensor data that is plausible enough for the
+    motion and the soft sensors to follow their usual paths.
+
+    When a SensorRecording is being replayed, the sensors are taken from the recording instead, and the
+    actions are sent to the simulated servos but have no effect on the sensors.
+
+    The platform creates the Blackboard, and adds its sensors and actionators to it.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BENCHMARKPLATFORM_H
+#define BENCHMARKPLATFORM_H
+
+#include "NUPlatform/NUPlatform.h"
+class SensorRecording;
+
+#include <vector>
+#include <string>
+
+class BenchmarkPlatform : public NUPlatform
+{
+public:
+    BenchmarkPlatform();
+    ~BenchmarkPlatform();
+
+    double getTime();
+    void tick();
+
+    void replay(const SensorRecording* recording);
+    const SensorRecording* getReplay() const {return m_replay;}
+    unsigned int getTickCount() const {return m_tick_count;}
+
+    static const std::vector<std::string>& getServoNames();
+    const std::vector<float>& getServoPositions() const {return m_positions;}
+    const std::vector<float>& getServoTargets() const {return m_targets;}
+    const std::vector<float>& getServoStiffnesses() const {return m_stiffnesses;}
+    void setServoTargets(const std::vector<float>& targets, const std::vector<float>& stiffnesses);
+protected:
+    void initName();
+    void initNumber();
+    void initTeam();
+    void initMAC();
+private:
+    void moveServos(float dt);
+public:
+    static const double Period;                 //!< the simulated time between ticks in ms
+private:
+    double m_time;                              //!< the simulated time in ms
+    unsigned int m_tick_count;                  //!< the number of ticks since the platform was created
+    const SensorRecording* m_replay;            //!< the recording being replayed, or NULL if the sensors are simulated
+
+    std::vector<float> m_positions;             //!< the simulated position of each servo in radians
+    std::vector<float> m_targets;               //!< the target of each servo in radians
+    std::vector<float> m_stiffnesses;           //!< the stiffness of each servo in percent
+};
+
+#endif
+
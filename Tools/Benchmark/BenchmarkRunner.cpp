@@ -0,0 +1,324 @@
+/*! @file BenchmarkRunner.cpp
+    @brief Implementation of the BenchmarkRunner class
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "BenchmarkRunner.h"
+#include "AllocationCounter.h"
+
+#include <time.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <map>
+
+using namespace std;
+
+/*! @brief Formats a time in ns with a unit that keeps it readable */
+static string formatTime(double ns)
+{
+    char buffer[32];
+    if (ns < 1e3)
+        sprintf(buffer, "%.1f ns", ns);
+    else if (ns < 1e6)
+        sprintf(buffer, "%.2f us", ns/1e3);
+    else if (ns < 1e9)
+        sprintf(buffer, "%.2f ms", ns/1e6);
+    else
+        sprintf(buffer, "%.2f s", ns/1e9);
+    return string(buffer);
+}
+
+BenchmarkRunner::BenchmarkRunner()
+{
+    m_num_samples = 1000;
+    m_max_time = 2.0;
+    m_min_sample_time = 10e3;
+    m_warm_up_time = 50e6;
+}
+
+/*! @brief Sets the filter; only benchmarks whose full name (group/name) contains the filter are run */
+void BenchmarkRunner::setFilter(const string& filter)
+{
+    m_filter = filter;
+}
+
+/*! @brief Sets the number of samples to take of each benchmark */
+void BenchmarkRunner::setNumSamples(unsigned int numsamples)
+{
+    m_num_samples = max(numsamples, 1u);
+}
+
+/*! @brief Sets the longest time to spend timing each benchmark in seconds. Fewer samples are taken of benchmarks
+           that would take longer, but never less than 10.
+ */
+void BenchmarkRunner::setMaxTime(double seconds)
+{
+    m_max_time = seconds;
+}
+
+/*! @brief Lists the benchmarks that match the filter */
+void BenchmarkRunner::list(ostream& output) const
+{
+    const vector<Benchmark*>& benchmarks = Benchmark::getBenchmarks();
+    for (size_t i=0; i<benchmarks.size(); i++)
+    {
+        if (matches(*benchmarks[i]))
+            output << benchmarks[i]->getFullName() << endl;
+    }
+}
+
+/*! @brief Runs each benchmark that matches the filter, and prints a summary of each as it finishes */
+void BenchmarkRunner::run(ostream& output)
+{
+    output << left << setw(48) << "benchmark" << right << setw(12) << "median" << setw(12) << "p99" << setw(12) << "allocs" << setw(12) << "bytes" << setw(10) << "samples" << endl;
+    const vector<Benchmark*>& benchmarks = Benchmark::getBenchmarks();
+    for (size_t i=0; i<benchmarks.size(); i++)
+    {
+        if (not matches(*benchmarks[i]))
+            continue;
+        BenchmarkResult result = run(*benchmarks[i]);
+        m_results.push_back(result);
+        summaryTo(output, result);
+    }
+}
+
+/*! @brief Times a single benchmark
+    @param benchmark the benchmark to time
+    @return the results
+ */
+BenchmarkResult BenchmarkRunner::run(Benchmark& benchmark)
+{
+    BenchmarkResult result;
+    result.Name = benchmark.getFullName();
+
+    benchmark.clearMetrics();
+    benchmark.setUp();
+
+    // warm up, and estimate the time per call to choose the size of the batches
+    unsigned int numwarmup = 0;
+    double warmupstart = now();
+    double elapsed = 0;
+    while (numwarmup < 3 or elapsed < m_warm_up_time)
+    {
+        benchmark.run();
+        numwarmup++;
+        elapsed = now() - warmupstart;
+    }
+    double estimate = max(elapsed/numwarmup, 1.0);
+    unsigned int batch = static_cast<unsigned int>(ceil(m_min_sample_time/estimate));
+    unsigned int numsamples = static_cast<unsigned int>(min<double>(m_num_samples, 1e9*m_max_time/(estimate*batch)));
+    numsamples = max(numsamples, 10u);
+
+    vector<double> samples;
+    samples.reserve(numsamples);
+    unsigned long long allocations = AllocationCounter::getNumAllocations();
+    unsigned long long bytes = AllocationCounter::getNumBytes();
+    for (unsigned int i=0; i<numsamples; i++)
+    {
+        double start = now();
+        for (unsigned int j=0; j<batch; j++)
+            benchmark.run();
+        samples.push_back((now() - start)/batch);
+    }
+    allocations = AllocationCounter::getNumAllocations() - allocations;                    // the samples were reserved, so only the benchmark allocates
+    bytes = AllocationCounter::getNumBytes() - bytes;
+    double numcalls = static_cast<double>(numsamples)*batch;
+
+    benchmark.tearDown();
+
+    sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (size_t i=0; i<samples.size(); i++)
+        sum += samples[i];
+
+    result.NumSamples = numsamples;
+    result.CallsPerSample = batch;
+    result.Median = percentile(samples, 0.5);
+    result.P99 = percentile(samples, 0.99);
+    result.Mean = sum/samples.size();
+    result.Min = samples.front();
+    result.AllocationsPerCall = allocations/numcalls;
+    result.BytesPerCall = bytes/numcalls;
+    result.Metrics = benchmark.getMetrics();
+    result.Failures = benchmark.getFailures();
+    return result;
+}
+
+/*! @brief Returns the number of benchmarks that have been run that failed one or more of their checks */
+unsigned int BenchmarkRunner::getNumFailed() const
+{
+    unsigned int numfailed = 0;
+    for (size_t i=0; i<m_results.size(); i++)
+    {
+        if (not m_results[i].Failures.empty())
+            numfailed++;
+    }
+    return numfailed;
+}
+
+/*! @brief Writes the results to a file
+    @param filename the name of the file
+    @return true if the file was written
+ */
+bool BenchmarkRunner::write(const string& filename) const
+{
+    ofstream file(filename.c_str());
+    if (not file.is_open())
+        return false;
+    file << setprecision(10);
+    file << "benchmark,statistic,value,unit" << endl;
+    for (size_t i=0; i<m_results.size(); i++)
+    {
+        const BenchmarkResult& result = m_results[i];
+        file << result.Name << ",median," << result.Median << ",ns" << endl;
+        file << result.Name << ",p99," << result.P99 << ",ns" << endl;
+        file << result.Name << ",mean," << result.Mean << ",ns" << endl;
+        file << result.Name << ",min," << result.Min << ",ns" << endl;
+        file << result.Name << ",allocations," << result.AllocationsPerCall << ",per call" << endl;
+        file << result.Name << ",bytes," << result.BytesPerCall << ",per call" << endl;
+        file << result.Name << ",samples," << result.NumSamples << "," << endl;
+        file << result.Name << ",calls," << result.CallsPerSample << ",per sample" << endl;
+        file << result.Name << ",failures," << result.Failures.size() << "," << endl;
+        for (size_t j=0; j<result.Metrics.size(); j++)
+            file << result.Name << "," << result.Metrics[j].Name << "," << result.Metrics[j].Value << "," << result.Metrics[j].Unit << endl;
+    }
+    return not file.fail();
+}
+
+/*! @brief Compares the results with those in a file written by an earlier run, and prints the differences.
+
+    A benchmark has regressed if its median time is more than tolerance slower than the baseline, or if it makes more
+    allocations per call. Benchmarks that are not in the baseline are listed, but are not regressions. The metrics
+    are printed when they differ from the baseline by more than the tolerance.
+
+    @param filename the baseline results
+    @param tolerance the fractional increase in the median time that is allowed
+    @param output the stream to print the comparison to
+    @return the number of regressions, or -1 if the baseline could not be read
+ */
+int BenchmarkRunner::compare(const string& filename, double tolerance, ostream& output) const
+{
+    ifstream file(filename.c_str());
+    if (not file.is_open())
+        return -1;
+
+    map<string, double> baseline;
+    string line;
+    while (getline(file, line))
+    {
+        if (line.empty() or line[0] == '#' or line.compare(0, 10, "benchmark,") == 0)
+            continue;
+        size_t first = line.find(',');
+        size_t second = line.find(',', first + 1);
+        size_t third = line.find(',', second + 1);
+        if (first == string::npos or second == string::npos)
+            continue;
+        string key = line.substr(0, second);
+        baseline[key] = atof(line.substr(second + 1, third - second - 1).c_str());
+    }
+
+    output << "Comparison with " << filename << " (tolerance " << 100*tolerance << "%)" << endl;
+    output << left << setw(48) << "benchmark" << right << setw(12) << "baseline" << setw(12) << "current" << setw(10) << "change" << setw(16) << "allocs" << endl;
+    int numregressions = 0;
+    for (size_t i=0; i<m_results.size(); i++)
+    {
+        const BenchmarkResult& result = m_results[i];
+        map<string, double>::const_iterator median = baseline.find(result.Name + ",median");
+        if (median == baseline.end())
+        {
+            output << left << setw(48) << result.Name << right << setw(12) << "-" << setw(12) << formatTime(result.Median) << "   not in the baseline" << endl;
+            continue;
+        }
+        double change = median->second > 0 ? result.Median/median->second - 1 : 0;
+        double allocations = result.AllocationsPerCall;
+        map<string, double>::const_iterator it = baseline.find(result.Name + ",allocations");
+        if (it != baseline.end())
+            allocations = it->second;
+
+        bool slower = change > tolerance;
+        bool allocates = result.AllocationsPerCall > allocations + max(0.05, tolerance*allocations);
+        ostringstream allocs;
+        allocs << setprecision(3) << allocations << " -> " << result.AllocationsPerCall;
+        char changetext[16];
+        sprintf(changetext, "%+.1f%%", 100*change);
+        output << left << setw(48) << result.Name << right << setw(12) << formatTime(median->second) << setw(12) << formatTime(result.Median) << setw(10) << changetext << setw(16) << allocs.str();
+        if (slower or allocates)
+        {
+            output << "   REGRESSION";
+            numregressions++;
+        }
+        else if (change < -tolerance)
+            output << "   faster";
+        output << endl;
+
+        for (size_t j=0; j<result.Metrics.size(); j++)
+        {
+            const Benchmark::Metric& metric = result.Metrics[j];
+            map<string, double>::const_iterator base = baseline.find(result.Name + "," + metric.Name);
+            if (base != baseline.end() and fabs(metric.Value - base->second) > tolerance*fabs(base->second))
+                output << "    " << metric.Name << ": " << base->second << " -> " << metric.Value << " " << metric.Unit << endl;
+        }
+    }
+    output << numregressions << " regression(s)" << endl;
+    return numregressions;
+}
+
+/*! @brief Returns true if the benchmark's full name contains the filter */
+bool BenchmarkRunner::matches(const Benchmark& benchmark) const
+{
+    return m_filter.empty() or benchmark.getFullName().find(m_filter) != string::npos;
+}
+
+/*! @brief Returns the time from the monotonic clock in ns */
+double BenchmarkRunner::now()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return 1e9*t.tv_sec + t.tv_nsec;
+}
+
+/*! @brief Returns the value at the given fraction of the sorted samples, using the nearest rank */
+double BenchmarkRunner::percentile(vector<double>& sorted, double fraction)
+{
+    if (sorted.empty())
+        return 0;
+    size_t rank = static_cast<size_t>(ceil(fraction*sorted.size()));
+    if (rank > 0)
+        rank--;
+    return sorted[min(rank, sorted.size() - 1)];
+}
+
+/*! @brief Prints a one line summary of the result, and its metrics */
+void BenchmarkRunner::summaryTo(ostream& output, const BenchmarkResult& result)
+{
+    ostringstream allocs, bytes;
+    allocs << setprecision(3) << result.AllocationsPerCall;
+    bytes << static_cast<long long>(result.BytesPerCall + 0.5);
+    output << left << setw(48) << result.Name << right << setw(12) << formatTime(result.Median) << setw(12) << formatTime(result.P99) << setw(12) << allocs.str() << setw(12) << bytes.str() << setw(10) << result.NumSamples << endl;
+    for (size_t i=0; i<result.Metrics.size(); i++)
+        output << "    " << result.Metrics[i].Name << ": " << result.Metrics[i].Value << " " << result.Metrics[i].Unit << endl;
+    for (size_t i=0; i<result.Failures.size(); i++)
+        output << "    FAILED: " << result.Failures[i] << endl;
+}
+
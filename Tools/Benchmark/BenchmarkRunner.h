@@ -0,0 +1,97 @@
+/*! @file BenchmarkRunner.h
+    @brief Declaration of the BenchmarkRunner class
+
+    @class BenchmarkRunner
+    @brief Times the registered benchmarks, and writes and compares their results.
+
+    Each benchmark is warmed up, and then timed in a number of samples. A sample is a batch of calls to run(),
+    and the batch is made long enough that the resolution of the clock does not matter. The median, 99th
+    percentile, mean and minimum time per call are calculated over the samples, along with the average number
+    of allocations and bytes allocated per call.
+
+    The results are written as comma separated values, one statistic per line:
+    @verbatim
+    benchmark,statistic,value,unit
+    Math/MatrixMultiply4x4,median,212.5,ns
+    Math/MatrixMultiply4x4,allocations,1,per call
+    @endverbatim
+    so that a results file can be stored as a baseline, and compared with a later run. A benchmark has regressed
+    when its median time has increased by more than the tolerance, or when it allocates more than it did.
+    The number of checks a benchmark failed is written as its failures statistic.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BENCHMARKRUNNER_H
+#define BENCHMARKRUNNER_H
+
+#include "Benchmark.h"
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+/*! @brief The results of a single benchmark */
+struct BenchmarkResult
+{
+    std::string Name;                       //!< the full name of the benchmark
+    unsigned int NumSamples;                //!< the number of samples timed
+    unsigned int CallsPerSample;            //!< the number of calls to run() in each sample
+    double Median;                          //!< the median time per call in ns
+    double P99;                             //!< the 99th percentile time per call in ns
+    double Mean;                            //!< the mean time per call in ns
+    double Min;                             //!< the shortest time per call in ns
+    double AllocationsPerCall;              //!< the average number of allocations per call
+    double BytesPerCall;                    //!< the average number of bytes allocated per call
+    std::vector<Benchmark::Metric> Metrics; //!< the benchmark's other results
+    std::vector<std::string> Failures;      //!< the benchmark's checks that failed
+};
+
+class BenchmarkRunner
+{
+public:
+    BenchmarkRunner();
+
+    void setFilter(const std::string& filter);
+    void setNumSamples(unsigned int numsamples);
+    void setMaxTime(double seconds);
+
+    void list(std::ostream& output) const;
+    void run(std::ostream& output);
+    BenchmarkResult run(Benchmark& benchmark);
+    const std::vector<BenchmarkResult>& getResults() const {return m_results;}
+    unsigned int getNumFailed() const;
+
+    bool write(const std::string& filename) const;
+    int compare(const std::string& filename, double tolerance, std::ostream& output) const;
+private:
+    bool matches(const Benchmark& benchmark) const;
+    static double now();
+    static double percentile(std::vector<double>& sorted, double fraction);
+    static void summaryTo(std::ostream& output, const BenchmarkResult& result);
+private:
+    std::string m_filter;                   //!< only benchmarks whose full name contains the filter are run
+    unsigned int m_num_samples;             //!< the number of samples to take of each benchmark
+    double m_max_time;                      //!< the longest time to spend timing each benchmark in s; fewer samples are taken of slow benchmarks
+    double m_min_sample_time;               //!< the shortest time a sample can take in ns, calls are batched to make the samples at least this long
+    double m_warm_up_time;                  //!< the time to run each benchmark before it is timed in ns
+    std::vector<BenchmarkResult> m_results; //!< the results of each benchmark that has been run
+};
+
+#endif
+
@@ -0,0 +1,138 @@
+/*! @file BenchmarkSensors.cpp
+    @brief Implementation of the BenchmarkSensors class
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "BenchmarkSensors.h"
+#include "BenchmarkPlatform.h"
+#include "SensorRecording.h"
+#include "Infrastructure/NUSensorsData/NUSensorsData.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+using namespace std;
+
+BenchmarkSensors::BenchmarkSensors(BenchmarkPlatform* platform)
+{
+    m_platform = platform;
+    const vector<string>& names = BenchmarkPlatform::getServoNames();
+    m_data->addSensors(names);
+    m_joint_ids = m_data->mapIdToIds(NUSensorsData::All);
+    m_previous_positions = vector<float>(names.size(), 0);
+    m_previous_velocities = vector<float>(names.size(), 0);
+    m_previous_roll = 0;
+    m_previous_pitch = 0;
+}
+
+BenchmarkSensors::~BenchmarkSensors()
+{
+}
+
+/*! @brief Copies the simulated sensors, or the next frame of the recording being replayed, into the NUSensorsData */
+void BenchmarkSensors::copyFromHardwareCommunications()
+{
+    if (m_platform->getReplay())
+        copyFromReplay();
+    else
+    {
+        copyFromJoints(m_platform->getServoPositions(), m_platform->getServoTargets(), m_platform->getServoStiffnesses());
+        simulateInertialAndFootSole();
+    }
+}
+
+/*! @brief Copies the joint readings into the NUSensorsData, calculating the velocities and accelerations in the same way as NAOWebotsSensors */
+void BenchmarkSensors::copyFromJoints(const vector<float>& positions, const vector<float>& targets, const vector<float>& stiffnesses)
+{
+    static float NaN = numeric_limits<float>::quiet_NaN();
+
+    vector<float> joint(NUSensorsData::NumJointSensorIndices, NaN);
+    float delta_t = (m_current_time - m_previous_time)/1000;
+    for (size_t i=0; i<m_joint_ids.size() and i<positions.size(); i++)
+    {
+        joint[NUSensorsData::PositionId] = positions[i];
+        joint[NUSensorsData::VelocityId] = (joint[NUSensorsData::PositionId] - m_previous_positions[i])/delta_t;
+        joint[NUSensorsData::AccelerationId] = (joint[NUSensorsData::VelocityId] - m_previous_velocities[i])/delta_t;
+        joint[NUSensorsData::TargetId] = i < targets.size() ? targets[i] : NaN;
+        joint[NUSensorsData::StiffnessId] = i < stiffnesses.size() ? stiffnesses[i] : NaN;
+        m_data->set(*m_joint_ids[i], m_current_time, joint);
+
+        m_previous_positions[i] = joint[NUSensorsData::PositionId];
+        m_previous_velocities[i] = joint[NUSensorsData::VelocityId];
+    }
+}
+
+/*! @brief Generates the accelerometer, gyro and foot sole readings from the simulated servo positions.
+
+    The leg with the straighter knee is taken to be carrying the weight, and the torso orientation is the
+    orientation of that leg's hip relative to a flat foot.
+ */
+void BenchmarkSensors::simulateInertialAndFootSole()
+{
+    const vector<float>& p = m_platform->getServoPositions();
+    // indices of the leg joints in the platform's servo order
+    const size_t lhiproll = 10, lhippitch = 11, lkneepitch = 13, lankleroll = 14, lanklepitch = 15;
+    const size_t rhiproll = 16, rhippitch = 17, rkneepitch = 19, rankleroll = 20, ranklepitch = 21;
+    const float g = 981;                        // cm/s/s
+    const float weight = 50;                    // N
+
+    float lload = max(0.0f, min(1.0f, 0.5f + 5*(p[rkneepitch] - p[lkneepitch])));
+    float lroll = -(p[lhiproll] + p[lankleroll]);
+    float lpitch = -(p[lhippitch] + p[lkneepitch] + p[lanklepitch]);
+    float rroll = -(p[rhiproll] + p[rankleroll]);
+    float rpitch = -(p[rhippitch] + p[rkneepitch] + p[ranklepitch]);
+    float roll = lload*lroll + (1 - lload)*rroll;
+    float pitch = lload*lpitch + (1 - lload)*rpitch;
+
+    // the same model of the accelerometer as the OrientationUKF's measurement update
+    vector<float> acc(3, 0);
+    acc[2] = -g/sqrt(1 + pow(tan(pitch), 2) + pow(tan(roll), 2));
+    acc[0] = -acc[2]*tan(pitch);
+    acc[1] = acc[2]*tan(roll);
+    m_data->set(NUSensorsData::Accelerometer, m_current_time, acc);
+
+    vector<float> gyro(3, 0);
+    float delta_t = (m_current_time - m_previous_time)/1000;
+    if (delta_t > 0)
+    {
+        gyro[0] = (roll - m_previous_roll)/delta_t;
+        gyro[1] = (pitch - m_previous_pitch)/delta_t;
+    }
+    m_data->set(NUSensorsData::Gyro, m_current_time, gyro);
+    m_previous_roll = roll;
+    m_previous_pitch = pitch;
+
+    m_data->set(NUSensorsData::LFootTouch, m_current_time, vector<float>(4, lload*weight/4));
+    m_data->set(NUSensorsData::RFootTouch, m_current_time, vector<float>(4, (1 - lload)*weight/4));
+}
+
+/*! @brief Copies the next frame of the recording into the NUSensorsData. The recording is repeated when it runs out. */
+void BenchmarkSensors::copyFromReplay()
+{
+    const SensorRecording& recording = *m_platform->getReplay();
+    if (recording.empty())
+        return;
+    const SensorRecording::Frame& frame = recording[m_platform->getTickCount() % recording.size()];
+    copyFromJoints(frame.Positions, frame.Targets, frame.Stiffnesses);
+    m_data->set(NUSensorsData::Accelerometer, m_current_time, frame.Accelerometer);
+    m_data->set(NUSensorsData::Gyro, m_current_time, frame.Gyro);
+    m_data->set(NUSensorsData::LFootTouch, m_current_time, frame.LFootTouch);
+    m_data->set(NUSensorsData::RFootTouch, m_current_time, frame.RFootTouch);
+}
+
@@ -0,0 +1,60 @@
+/*! @file BenchmarkSensors.h
+    @brief Declaration of the BenchmarkSensors class
+
+    @class BenchmarkSensors
+    @brief The sensors of the BenchmarkPlatform, simulated or replayed from a SensorRecording.
+
+    The joints are copied in the same way as NAOWebotsSensors, so the soft sensors see the same data layout
+    as on the robot. The torso orientation is estimated from the support leg, and the accelerometer, gyro and
+    foot sole readings are generated from it using the same model as the OrientationUKF.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BENCHMARKSENSORS_H
+#define BENCHMARKSENSORS_H
+
+#include "NUPlatform/NUSensors.h"
+#include "Infrastructure/NUData.h"
+class BenchmarkPlatform;
+
+#include <vector>
+using namespace std;
+
+class BenchmarkSensors : public NUSensors
+{
+public:
+    BenchmarkSensors(BenchmarkPlatform* platform);
+    ~BenchmarkSensors();
+protected:
+    void copyFromHardwareCommunications();
+private:
+    void copyFromJoints(const vector<float>& positions, const vector<float>& targets, const vector<float>& stiffnesses);
+    void simulateInertialAndFootSole();
+    void copyFromReplay();
+private:
+    BenchmarkPlatform* m_platform;              //!< the platform the sensors belong to
+    vector<NUData::id_t*> m_joint_ids;          //!< the ids of the joints, in the platform's servo order
+    vector<float> m_previous_positions;         //!< the joint positions in the previous update
+    vector<float> m_previous_velocities;        //!< the joint velocities in the previous update
+    float m_previous_roll;                      //!< the simulated torso roll in the previous update
+    float m_previous_pitch;                     //!< the simulated torso pitch in the previous update
+};
+
+#endif
+
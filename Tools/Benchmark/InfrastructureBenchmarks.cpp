@@ -0,0 +1,455 @@
+/*! @file InfrastructureBenchmarks.cpp
+    @brief Benchmarks of the blackboard's sensor data, the per-frame arena and the team packet codec
+
+    The sensor data benchmarks use the frames of the default recording: the reads are the ones the motion
+    thread makes each tick, the writes are the ones the platform's sensors make each tick, and the stream
+    round trip is how a frame is logged and read back by NUview. The sensor storage benchmarks compare the
+    two layouts of the data underneath NUSensorsData: a Sensor object for each sensor, and the SensorBlock.
+
+    The arena benchmark's set up checks that a line point made on another thread, while the arena is active,
+    comes from the heap.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.h"
+#include "BenchmarkPlatform.h"
+#include "SensorRecording.h"
+
+#include "Infrastructure/NUBlackboard.h"
+#include "Infrastructure/NUSensorsData/NUSensorsData.h"
+#include "Infrastructure/NUSensorsData/Sensor.h"
+#include "Infrastructure/NUSensorsData/SensorBlock.h"
+#include "Infrastructure/TeamInformation/TeamInformation.h"
+#include "Infrastructure/TeamInformation/TeamPacketCodec.h"
+#include "Tools/Math/LSFittedLine.h"
+#include "Tools/Memory/FrameArena.h"
+
+#include <pthread.h>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <vector>
+using namespace std;
+
+/*! @brief Replays the default recording on the platform for a few ticks, so that the blackboard's sensor data is complete */
+static void fillSensors()
+{
+    BenchmarkPlatform* platform = dynamic_cast<BenchmarkPlatform*>(Platform);
+    platform->replay(&SensorRecording::getDefault());
+    for (int i=0; i<10; i++)
+        platform->tick();
+    platform->replay(NULL);
+}
+
+/*! @brief The sensor reads the motion thread makes each tick: every joint position, one at a time and all together, and the inertial sensors */
+class SensorsGetBenchmark : public Benchmark
+{
+public:
+    SensorsGetBenchmark(const string& group, const string& name) : Benchmark(group, name) {}
+    void setUp()
+    {
+        fillSensors();
+        m_joint_ids = Blackboard->Sensors->mapIdToIds(NUSensorsData::All);
+    }
+    void run()
+    {
+        NUSensorsData* data = Blackboard->Sensors;
+        float sum = 0;
+        float position;
+        for (size_t i=0; i<m_joint_ids.size(); i++)
+        {
+            if (data->getPosition(*m_joint_ids[i], position))
+                sum += position;
+        }
+        data->getPosition(NUSensorsData::All, m_positions);
+        data->getAccelerometer(m_accelerometer);
+        data->getGyro(m_gyro);
+        benchmarkUse(sum);
+    }
+private:
+    vector<NUData::id_t*> m_joint_ids;
+    vector<float> m_positions, m_accelerometer, m_gyro;
+};
+static SensorsGetBenchmark sensorsget("Infrastructure", "SensorsGet");
+
+/*! @brief The sensor writes the platform makes each tick: every joint, the inertial sensors and the foot soles */
+class SensorsSetBenchmark : public Benchmark
+{
+public:
+    SensorsSetBenchmark(const string& group, const string& name) : Benchmark(group, name) {}
+    void setUp()
+    {
+        m_data = new NUSensorsData();
+        m_data->addSensors(BenchmarkPlatform::getServoNames());
+        m_joint_ids = m_data->mapIdToIds(NUSensorsData::All);
+        m_joint = vector<float>(NUSensorsData::NumJointSensorIndices, 0);
+        m_frame = 0;
+        m_time = 0;
+    }
+    void run()
+    {
+        const SensorRecording& recording = SensorRecording::getDefault();
+        const SensorRecording::Frame& frame = recording[m_frame];
+        m_time += BenchmarkPlatform::Period;
+        for (size_t i=0; i<m_joint_ids.size(); i++)
+        {
+            m_joint[NUSensorsData::PositionId] = frame.Positions[i];
+            m_joint[NUSensorsData::TargetId] = frame.Targets[i];
+            m_joint[NUSensorsData::StiffnessId] = frame.Stiffnesses[i];
+            m_data->set(*m_joint_ids[i], m_time, m_joint);
+        }
+        m_data->set(NUSensorsData::Accelerometer, m_time, frame.Accelerometer);
+        m_data->set(NUSensorsData::Gyro, m_time, frame.Gyro);
+        m_data->set(NUSensorsData::LFootTouch, m_time, frame.LFootTouch);
+        m_data->set(NUSensorsData::RFootTouch, m_time, frame.RFootTouch);
+        m_frame = (m_frame + 1) % recording.size();
+    }
+    void tearDown()
+    {
+        delete m_data;
+        m_data = 0;
+    }
+private:
+    NUSensorsData* m_data;
+    vector<NUData::id_t*> m_joint_ids;
+    vector<float> m_joint;
+    size_t m_frame;
+    double m_time;
+};
+static SensorsSetBenchmark sensorsset("Infrastructure", "SensorsSet");
+
+/*! @brief Writing the sensor data to a stream and reading it back, as the sensor logs and NUview do */
+class SensorsStreamBenchmark : public Benchmark
+{
+public:
+    SensorsStreamBenchmark(const string& group, const string& name) : Benchmark(group, name) {}
+    void setUp()
+    {
+        fillSensors();
+        m_copy = new NUSensorsData();
+    }
+    void run()
+    {
+        m_stream.str("");
+        m_stream.clear();
+        m_stream << *Blackboard->Sensors;
+        m_stream >> *m_copy;
+        benchmarkUse(m_copy);
+    }
+    void tearDown()
+    {
+        addMetric("size", m_stream.str().size(), "bytes");
+        delete m_copy;
+        m_copy = 0;
+    }
+private:
+    stringstream m_stream;
+    NUSensorsData* m_copy;
+};
+static SensorsStreamBenchmark sensorsstream("Infrastructure", "SensorsStreamRoundTrip");
+
+/*! @brief A frame's worth of get, set or copy of the joint and inertial sensor data, stored either in a Sensor per
+           sensor or in a SensorBlock
+
+    Each joint has a slot for its vector of NumJointSensorIndices, and the accelerometer, gyro and foot soles have a
+    slot each. A get reads the position of every joint and the inertial vectors, a set writes a frame of the default
+    recording, and a copy copies the whole store, as copying a NUSensorsData does. The set up fills both layouts with
+    the whole recording, and checks that they hold the same data, and that a copy of each holds the same data.
+ */
+class SensorStorageBenchmark : public Benchmark
+{
+public:
+    enum Operation {Get, Set, Copy};
+    SensorStorageBenchmark(const string& group, const string& name, Operation operation, bool block) : Benchmark(group, name), m_operation(operation), m_use_block(block) {}
+    void setUp()
+    {
+        m_num_joints = BenchmarkPlatform::getServoNames().size();
+        vector<unsigned int> capacities(m_num_joints, NUSensorsData::NumJointSensorIndices);
+        capacities.insert(capacities.end(), 4, 16);
+        m_block.setCapacities(capacities);
+        m_sensors.assign(capacities.size(), Sensor("sensor"));
+        m_joint = vector<float>(NUSensorsData::NumJointSensorIndices, 0);
+        m_frame = 0;
+
+        const SensorRecording& recording = SensorRecording::getDefault();
+        for (size_t i=0; i<recording.size(); i++)
+        {
+            write(false);
+            write(true);
+            m_frame = (m_frame + 1) % recording.size();
+        }
+        check(sameData(m_sensors, m_block), "the Sensors and the SensorBlock hold the same data");
+        vector<Sensor> sensorscopy = m_sensors;
+        SensorBlock blockcopy;
+        blockcopy = m_block;
+        check(sameData(sensorscopy, blockcopy), "copies of the Sensors and the SensorBlock hold the same data");
+        addMetric("block size", m_block.bytes(), "bytes");
+    }
+    void run()
+    {
+        if (m_operation == Get)
+            read();
+        else if (m_operation == Set)
+        {
+            write(m_use_block);
+            m_frame = (m_frame + 1) % SensorRecording::getDefault().size();
+        }
+        else if (m_use_block)
+            m_block_copy = m_block;
+        else
+            m_sensors_copy = m_sensors;
+    }
+private:
+    /*! @brief Writes the current frame of the default recording into one of the layouts */
+    void write(bool block)
+    {
+        const SensorRecording::Frame& frame = SensorRecording::getDefault()[m_frame];
+        for (size_t i=0; i<m_num_joints; i++)
+        {
+            m_joint[NUSensorsData::PositionId] = frame.Positions[i];
+            m_joint[NUSensorsData::TargetId] = frame.Targets[i];
+            m_joint[NUSensorsData::StiffnessId] = frame.Stiffnesses[i];
+            store(block, i, frame.Time, m_joint);
+        }
+        store(block, m_num_joints, frame.Time, frame.Accelerometer);
+        store(block, m_num_joints + 1, frame.Time, frame.Gyro);
+        store(block, m_num_joints + 2, frame.Time, frame.LFootTouch);
+        store(block, m_num_joints + 3, frame.Time, frame.RFootTouch);
+    }
+    void store(bool block, size_t index, double time, const vector<float>& data)
+    {
+        if (block)
+            m_block.set(index, time, data);
+        else
+            m_sensors[index].set(time, data);
+    }
+    /*! @brief Reads every joint position, as getPosition does, and the inertial vectors */
+    void read()
+    {
+        float sum = 0;
+        float position;
+        for (size_t i=0; i<m_num_joints; i++)
+        {
+            if (m_use_block)
+            {
+                if (m_block.get(i, NUSensorsData::PositionId, position))
+                    sum += position;
+            }
+            else if (m_sensors[i].get(m_buffer))
+                sum += m_buffer[NUSensorsData::PositionId];
+        }
+        for (size_t i=m_num_joints; i<m_num_joints + 4; i++)
+        {
+            if (m_use_block)
+                m_block.get(i, m_buffer);
+            else
+                m_sensors[i].get(m_buffer);
+        }
+        benchmarkUse(sum);
+    }
+    /*! @brief Returns true if every slot of the block holds the same vector and time as the corresponding sensor */
+    static bool sameData(const vector<Sensor>& sensors, const SensorBlock& block)
+    {
+        vector<float> a, b;
+        if (sensors.size() != block.size())
+            return false;
+        for (size_t i=0; i<sensors.size(); i++)
+        {
+            if (not sensors[i].get(a) or not block.get(i, b) or a != b or sensors[i].Time != block.getTime(i))
+                return false;
+        }
+        return true;
+    }
+private:
+    Operation m_operation;
+    bool m_use_block;
+    size_t m_num_joints;
+    vector<Sensor> m_sensors;
+    vector<Sensor> m_sensors_copy;
+    SensorBlock m_block;
+    SensorBlock m_block_copy;
+    vector<float> m_joint;
+    vector<float> m_buffer;
+    size_t m_frame;
+};
+static SensorStorageBenchmark sensorsgetsensors("Infrastructure", "SensorStorageGetSensors", SensorStorageBenchmark::Get, false);
+static SensorStorageBenchmark sensorsgetblock("Infrastructure", "SensorStorageGetBlock", SensorStorageBenchmark::Get, true);
+static SensorStorageBenchmark sensorssetsensors("Infrastructure", "SensorStorageSetSensors", SensorStorageBenchmark::Set, false);
+static SensorStorageBenchmark sensorssetblock("Infrastructure", "SensorStorageSetBlock", SensorStorageBenchmark::Set, true);
+static SensorStorageBenchmark sensorscopysensors("Infrastructure", "SensorStorageCopySensors", SensorStorageBenchmark::Copy, false);
+static SensorStorageBenchmark sensorscopyblock("Infrastructure", "SensorStorageCopyBlock", SensorStorageBenchmark::Copy, true);
+
+/*! @brief The allocation and release of a frame's worth of line points, from the heap or from a FrameArena */
+class LinePointsBenchmark : public Benchmark
+{
+public:
+    LinePointsBenchmark(const string& group, const string& name, bool arena) : Benchmark(group, name), m_use_arena(arena), m_points(NumPoints) {}
+    void setUp()
+    {
+        if (m_use_arena)
+        {   // a line point made on another thread while the arena is active on this one must come from the heap
+            FrameArena::Scope scope(m_arena);
+            LinePoint* point = 0;
+            pthread_t thread;
+            pthread_create(&thread, NULL, allocateOnThread, &point);
+            pthread_join(thread, NULL);
+            check(point != 0 and not m_arena.owns(point), "the arena is only active on the thread that activated it");
+            delete point;
+        }
+    }
+    void run()
+    {
+        if (m_use_arena)
+        {
+            FrameArena::Scope scope(m_arena);
+            allocate();
+        }
+        else
+            allocate();
+    }
+    void tearDown()
+    {
+        if (m_use_arena)
+            addMetric("arena peak", m_arena.getMaxPeak(), "bytes");
+    }
+private:
+    static void* allocateOnThread(void* arg)
+    {
+        *static_cast<LinePoint**>(arg) = new LinePoint();
+        return NULL;
+    }
+    void allocate()
+    {
+        for (int i=0; i<NumPoints; i++)
+        {
+            m_points[i] = new LinePoint();
+            m_points[i]->x = i;
+        }
+        benchmarkUse(m_points[NumPoints - 1]->x);
+        for (int i=0; i<NumPoints; i++)
+            delete m_points[i];
+    }
+private:
+    static const int NumPoints = 300;               //!< about the number of line points vision finds in a frame
+    bool m_use_arena;
+    FrameArena m_arena;
+    vector<LinePoint*> m_points;
+};
+static LinePointsBenchmark heaplinepoints("Infrastructure", "LinePointsHeap", false);
+static LinePointsBenchmark arenalinepoints("Infrastructure", "LinePointsFrameArena", true);
+
+/*! @brief Returns a sequence of packets from a robot with smoothly moving estimates of the ball and itself, sent every 100 ms */
+static vector<TeamPacket> teamPackets()
+{
+    vector<TeamPacket> packets(1000);
+    for (size_t i=0; i<packets.size(); i++)
+    {
+        TeamPacket& packet = packets[i];
+        memset(&packet, 0, sizeof(packet));
+        double t = 0.1*i;
+        packet.ID = i + 1;
+        packet.SentTime = 1000*t;
+        packet.PlayerNumber = 2;
+        packet.TeamNumber = 1;
+        packet.Ball.TimeSinceLastSeen = sin(0.2*t) > -0.5 ? 0 : 100*(i % 20);
+        packet.Ball.X = 200*sin(0.3*t);
+        packet.Ball.Y = 150*sin(0.5*t);
+        packet.Ball.SRXX = 10 + 5*sin(0.1*t);
+        packet.Ball.SRXY = 2*sin(0.13*t);
+        packet.Ball.SRYY = 10 + 5*cos(0.1*t);
+        packet.Self.X = 100*cos(0.1*t);
+        packet.Self.Y = 100*sin(0.1*t);
+        packet.Self.Heading = fmod(0.1*t, 2*M_PI) - M_PI;
+        packet.Self.SDX = 15;
+        packet.Self.SDY = 15;
+        packet.Self.SDHeading = 0.1;
+        packet.TimeToBall = sqrt(pow(packet.Ball.X - packet.Self.X, 2) + pow(packet.Ball.Y - packet.Self.Y, 2))/10;
+    }
+    return packets;
+}
+
+/*! @brief Encoding a team packet with the default key frame interval */
+class TeamPacketEncodeBenchmark : public Benchmark
+{
+public:
+    TeamPacketEncodeBenchmark(const string& group, const string& name) : Benchmark(group, name), m_codec(1) {}
+    void setUp()
+    {
+        m_packets = teamPackets();
+        m_index = 0;
+        m_bytes = 0;
+        m_num_encoded = 0;
+    }
+    void run()
+    {
+        m_bytes += m_codec.encode(m_packets[m_index], m_buffer);
+        m_num_encoded++;
+        m_index = (m_index + 1) % m_packets.size();
+    }
+    void tearDown()
+    {
+        addMetric("mean size", static_cast<double>(m_bytes)/m_num_encoded, "bytes");
+    }
+private:
+    TeamPacketCodec m_codec;
+    vector<TeamPacket> m_packets;
+    unsigned char m_buffer[TeamPacketCodec::MaxPacketSize];
+    size_t m_index;
+    unsigned long long m_bytes;
+    unsigned long long m_num_encoded;
+};
+static TeamPacketEncodeBenchmark teampacketencode("Infrastructure", "TeamPacketEncode");
+
+/*! @brief Decoding a team packet with the default key frame interval, in the order they were sent */
+class TeamPacketDecodeBenchmark : public Benchmark
+{
+public:
+    TeamPacketDecodeBenchmark(const string& group, const string& name) : Benchmark(group, name), m_decoder(1) {}
+    void setUp()
+    {
+        vector<TeamPacket> packets = teamPackets();
+        TeamPacketCodec encoder(1);
+        unsigned char buffer[TeamPacketCodec::MaxPacketSize];
+        m_encoded.clear();
+        for (size_t i=0; i<packets.size(); i++)
+        {
+            int length = encoder.encode(packets[i], buffer);
+            m_encoded.push_back(vector<unsigned char>(buffer, buffer + length));
+        }
+        m_index = 0;
+    }
+    void run()
+    {
+        const vector<unsigned char>& data = m_encoded[m_index];
+        m_decoder.decode(&data[0], data.size(), m_packet);
+        benchmarkUse(m_packet.Ball.X);
+        m_index = (m_index + 1) % m_encoded.size();
+    }
+    void tearDown()
+    {
+        addMetric("failed", m_decoder.getNumInvalid() + m_decoder.getNumMissingKeyFrame(), "packets");
+    }
+private:
+    TeamPacketCodec m_decoder;
+    vector<vector<unsigned char> > m_encoded;
+    TeamPacket m_packet;
+    size_t m_index;
+};
+static TeamPacketDecodeBenchmark teampacketdecode("Infrastructure", "TeamPacketDecode");
+
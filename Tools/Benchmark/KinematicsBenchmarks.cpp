@@ -0,0 +1,170 @@
+/*! @file KinematicsBenchmarks.cpp
+    @brief Benchmarks of the kinematics, the orientation filter and the soft sensors, using the recorded sensor data
+
+    Each call uses the next frame of the SensorRecording, so the work done is what the robot would do
+    on each tick of the sense-move thread.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.h"
+#include "BenchmarkPlatform.h"
+#include "SensorRecording.h"
+
+#include "Kinematics/Kinematics.h"
+#include "Kinematics/OrientationUKF.h"
+#include "Tools/Math/Matrix.h"
+
+#include <vector>
+using namespace std;
+
+/*! @brief The leg and head joints of each frame of the default recording, in the order used by the Kinematics */
+class RecordedJoints
+{
+public:
+    void load()
+    {
+        const SensorRecording& recording = SensorRecording::getDefault();
+        LeftLegs.clear();
+        RightLegs.clear();
+        Heads.clear();
+        for (unsigned int i=0; i<recording.size(); i++)
+        {
+            const vector<float>& p = recording[i].Positions;
+            Heads.push_back(vector<float>(p.begin(), p.begin() + 2));
+            LeftLegs.push_back(vector<float>(p.begin() + 10, p.begin() + 16));
+            RightLegs.push_back(vector<float>(p.begin() + 16, p.begin() + 22));
+            RightLegs.back()[2] = LeftLegs.back()[2];               // the hip yaw pitch is shared, as in NUSensors::calculateKinematics
+        }
+    }
+    vector<vector<float> > LeftLegs;
+    vector<vector<float> > RightLegs;
+    vector<vector<float> > Heads;
+};
+
+/*! @brief The transforms to both feet */
+class LegTransformsBenchmark : public Benchmark
+{
+public:
+    LegTransformsBenchmark(const string& group, const string& name) : Benchmark(group, name) {}
+    void setUp()
+    {
+        m_joints.load();
+        m_kinematics.LoadModel();
+        m_frame = 0;
+    }
+    void run()
+    {
+        m_left = m_kinematics.CalculateTransform(Kinematics::leftFoot, m_joints.LeftLegs[m_frame]);
+        m_right = m_kinematics.CalculateTransform(Kinematics::rightFoot, m_joints.RightLegs[m_frame]);
+        benchmarkUse(m_left[2][3] + m_right[2][3]);
+        m_frame = (m_frame + 1) % m_joints.LeftLegs.size();
+    }
+private:
+    RecordedJoints m_joints;
+    Kinematics m_kinematics;
+    Matrix m_left, m_right;
+    size_t m_frame;
+};
+static LegTransformsBenchmark legtransforms("Kinematics", "LegTransforms");
+
+/*! @brief The transform to the bottom camera, and from there to the ground */
+class CameraTransformBenchmark : public Benchmark
+{
+public:
+    CameraTransformBenchmark(const string& group, const string& name) : Benchmark(group, name) {}
+    void setUp()
+    {
+        m_joints.load();
+        m_kinematics.LoadModel();
+        m_frame = 0;
+    }
+    void run()
+    {
+        Matrix support = m_kinematics.CalculateTransform(Kinematics::leftFoot, m_joints.LeftLegs[m_frame]);
+        Matrix camera = m_kinematics.CalculateTransform(Kinematics::bottomCamera, m_joints.Heads[m_frame]);
+        m_ground = Kinematics::CalculateCamera2GroundTransform(support, camera);
+        benchmarkUse(m_ground[2][3]);
+        m_frame = (m_frame + 1) % m_joints.Heads.size();
+    }
+private:
+    RecordedJoints m_joints;
+    Kinematics m_kinematics;
+    Matrix m_ground;
+    size_t m_frame;
+};
+static CameraTransformBenchmark cameratransform("Kinematics", "CameraToGroundTransform");
+
+/*! @brief A time and measurement update of the orientation filter, with the kinematic orientation of the left leg */
+class OrientationFilterBenchmark : public Benchmark
+{
+public:
+    OrientationFilterBenchmark(const string& group, const string& name) : Benchmark(group, name) {}
+    void setUp()
+    {
+        m_joints.load();
+        m_kinematics.LoadModel();
+        m_filter = OrientationUKF();
+        m_frame = 0;
+        m_time = 0;
+        const SensorRecording::Frame& frame = SensorRecording::getDefault()[0];
+        vector<float> orientation = Kinematics::OrientationFromTransform(m_kinematics.CalculateTransform(Kinematics::leftFoot, m_joints.LeftLegs[0]));
+        m_filter.initialise(m_time, frame.Gyro, frame.Accelerometer, true, orientation);
+    }
+    void run()
+    {
+        const SensorRecording::Frame& frame = SensorRecording::getDefault()[m_frame];
+        m_time += BenchmarkPlatform::Period;
+        vector<float> orientation = Kinematics::OrientationFromTransform(m_kinematics.CalculateTransform(Kinematics::leftFoot, m_joints.LeftLegs[m_frame]));
+        m_filter.TimeUpdate(frame.Gyro, m_time);
+        m_filter.MeasurementUpdate(frame.Accelerometer, true, orientation);
+        benchmarkUse(m_filter.getMean(OrientationUKF::pitchAngle));
+        m_frame = (m_frame + 1) % m_joints.LeftLegs.size();
+    }
+private:
+    RecordedJoints m_joints;
+    Kinematics m_kinematics;
+    OrientationUKF m_filter;
+    size_t m_frame;
+    double m_time;
+};
+static OrientationFilterBenchmark orientationfilter("Kinematics", "OrientationUKF");
+
+/*! @brief A complete update of the sensors: copying the recorded frame and calculating every soft sensor */
+class SensorsUpdateBenchmark : public Benchmark
+{
+public:
+    SensorsUpdateBenchmark(const string& group, const string& name) : Benchmark(group, name) {}
+    void setUp()
+    {
+        m_platform = dynamic_cast<BenchmarkPlatform*>(Platform);
+        m_platform->replay(&SensorRecording::getDefault());
+    }
+    void run()
+    {
+        m_platform->tick();
+    }
+    void tearDown()
+    {
+        m_platform->replay(NULL);
+    }
+private:
+    BenchmarkPlatform* m_platform;
+};
+static SensorsUpdateBenchmark sensorsupdate("Kinematics", "SensorsUpdate");
+
@@ -0,0 +1,195 @@
+/*! @file LocalisationBenchmarks.cpp
+    @brief Benchmarks of the localisation time update, and of logging localisation as a stream or as LocalisationFrames
+
+    The Localisation stream is the old locwm.strm format, and the LocalisationFrame is the binary record the
+    SeeThinkThread logs to locfrm.strm. Both are written and read back through a reused stream, with three
+    visible landmarks. The logger benchmark is the cost to the SeeThinkThread of handing a frame to the
+    LocalisationLoggerThread, which writes it to disk.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.h"
+
+#include "Localisation/Localisation.h"
+#include "Localisation/LocalisationFrame.h"
+#include "Localisation/Threads/LocalisationLoggerThread.h"
+#include "Infrastructure/FieldObjects/FieldObjects.h"
+
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <unistd.h>
+using namespace std;
+
+/*! @brief A localisation time update with the odometry of a forward walk */
+class TimeUpdateBenchmark : public Benchmark
+{
+public:
+    TimeUpdateBenchmark(const string& group, const string& name) : Benchmark(group, name) {}
+    void setUp()
+    {
+        m_localisation = new Localisation();
+    }
+    void run()
+    {
+        m_localisation->doTimeUpdate(0.5, 0, 0.005);
+        benchmarkUse(m_localisation->getBestModel().getState(0));
+    }
+    void tearDown()
+    {
+        delete m_localisation;
+    }
+private:
+    Localisation* m_localisation;
+};
+static TimeUpdateBenchmark timeupdate("Localisation", "TimeUpdate");
+
+/*! @brief Writing a frame of localisation to a log, and reading it back, in either the Localisation stream or the LocalisationFrame format */
+class LocalisationLogBenchmark : public Benchmark
+{
+public:
+    LocalisationLogBenchmark(const string& group, const string& name, bool frame, bool read) : Benchmark(group, name), m_use_frame(frame), m_read(read) {}
+    void setUp()
+    {
+        m_localisation = new Localisation();
+        m_objects = new FieldObjects();
+        m_objects->stationaryFieldObjects[FieldObjects::FO_BLUE_LEFT_GOALPOST].setIsVisible(true);
+        m_objects->stationaryFieldObjects[FieldObjects::FO_BLUE_RIGHT_GOALPOST].setIsVisible(true);
+        m_objects->stationaryFieldObjects[FieldObjects::FO_CORNER_CENTRE_CIRCLE].setIsVisible(true);
+        m_frame.set(*m_localisation, *m_objects);
+        write();
+        m_log = m_stream.str();
+    }
+    void run()
+    {
+        if (m_read)
+        {
+            m_stream.str(m_log);
+            m_stream.clear();
+            if (m_use_frame)
+                m_stream >> m_frame;
+            else
+                m_stream >> *m_localisation;
+        }
+        else
+        {
+            m_stream.str("");
+            m_stream.clear();
+            write();
+        }
+        benchmarkUse(m_stream);
+    }
+    void tearDown()
+    {
+        addMetric("size", m_log.size(), "bytes");
+        delete m_objects;
+        delete m_localisation;
+    }
+private:
+    void write()
+    {
+        if (m_use_frame)
+        {
+            m_frame.set(*m_localisation, *m_objects);
+            m_stream << m_frame;
+        }
+        else
+            m_stream << *m_localisation;
+    }
+private:
+    bool m_use_frame;
+    bool m_read;
+    Localisation* m_localisation;
+    FieldObjects* m_objects;
+    LocalisationFrame m_frame;
+    stringstream m_stream;
+    string m_log;
+};
+static LocalisationLogBenchmark streamwrite("Localisation", "LogWriteStream", false, false);
+static LocalisationLogBenchmark framewrite("Localisation", "LogWriteFrame", true, false);
+static LocalisationLogBenchmark streamread("Localisation", "LogReadStream", false, true);
+static LocalisationLogBenchmark frameread("Localisation", "LogReadFrame", true, true);
+
+
+/*! @brief Setting a localisation frame and queueing it to be logged, which is all the SeeThinkThread does to log localisation */
+class LocalisationLoggerBenchmark : public Benchmark
+{
+public:
+    LocalisationLoggerBenchmark(const string& group, const string& name) : Benchmark(group, name), m_logger(0) {}
+    void setUp()
+    {
+        char filename[64];
+        sprintf(filename, "/tmp/benchmark%dlocfrm.strm", getpid());
+        m_filename = filename;
+        m_localisation = new Localisation();
+        m_objects = new FieldObjects();
+        m_objects->stationaryFieldObjects[FieldObjects::FO_BLUE_LEFT_GOALPOST].setIsVisible(true);
+        m_objects->stationaryFieldObjects[FieldObjects::FO_CORNER_CENTRE_CIRCLE].setIsVisible(true);
+        checkLogged();
+        m_logger = new LocalisationLoggerThread(m_filename);
+    }
+    void run()
+    {
+        m_frame.set(*m_localisation, *m_objects);
+        m_logger->log(m_frame);
+    }
+    void tearDown()
+    {
+        addMetric("frames logged", m_logger->getFramesLogged(), "");
+        addMetric("frames dropped", m_logger->getFramesDropped(), "");
+        delete m_logger;
+        m_logger = 0;
+        delete m_objects;
+        delete m_localisation;
+        unlink(m_filename.c_str());
+    }
+private:
+    /*! @brief Logs a few frames, destroys the logger, and checks that every frame was written in order */
+    void checkLogged()
+    {
+        LocalisationLoggerThread* logger = new LocalisationLoggerThread(m_filename, NumTestFrames);
+        vector<unsigned int> numbers;
+        for (int i=0; i<NumTestFrames; i++)
+        {
+            m_frame.set(*m_localisation, *m_objects);
+            logger->log(m_frame);
+            numbers.push_back(m_frame.getFrameNumber());
+        }
+        delete logger;
+
+        ifstream file(m_filename.c_str(), ios_base::in | ios_base::binary);
+        LocalisationFrame frame;
+        bool inorder = true;
+        for (int i=0; i<NumTestFrames and file.good(); i++)
+        {
+            file >> frame;
+            inorder = inorder and frame.getFrameNumber() == numbers[i] and frame.getNumMeasurements() == m_frame.getNumMeasurements();
+        }
+        file.peek();
+        check(inorder and file.eof(), "every frame is written, in order, when the logger is destroyed");
+    }
+private:
+    static const int NumTestFrames = 6;         //!< the number of frames logged and read back by the set up
+    string m_filename;
+    Localisation* m_localisation;
+    FieldObjects* m_objects;
+    LocalisationFrame m_frame;
+    LocalisationLoggerThread* m_logger;
+};
+static LocalisationLoggerBenchmark localisationlogger("Localisation", "LoggerLog");
@@ -0,0 +1,478 @@
+/*! @file MathBenchmarks.cpp
+    @brief Benchmarks of the Matrix class and the unscented Kalman filters that are built on it
+
+    The filters are given the same problem: a three state (x, y, heading) estimate with a two dimensional
+    position measurement, like a single update of a localisation model. The filter is reset before each
+    update so that every call does the same amount of work.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.h"
+
+#include "Tools/Math/Matrix.h"
+#include "Tools/Math/UKF.h"
+#include "Tools/Math/SRUKF.h"
+#include "Tools/Math/LSFittedLine.h"
+#include "Tools/Math/LineFitter.h"
+
+#include <cmath>
+#include <cstdlib>
+using namespace std;
+
+/*! @brief Returns a homogeneous transform that rotates by angle about z and translates by (x, y, z) */
+static Matrix transform(double angle, double x, double y, double z)
+{
+    Matrix t(4, 4, true);
+    t[0][0] = cos(angle);
+    t[0][1] = -sin(angle);
+    t[1][0] = sin(angle);
+    t[1][1] = cos(angle);
+    t[0][3] = x;
+    t[1][3] = y;
+    t[2][3] = z;
+    return t;
+}
+
+/*! @brief Returns a symmetric positive definite n by n matrix */
+static Matrix covariance(int n)
+{
+    Matrix a(n, n, false);
+    for (int i=0; i<n; i++)
+        for (int j=0; j<n; j++)
+            a[i][j] = 1.0/(1 + i + j);
+    return a*a.transp() + Matrix(n, n, true);
+}
+
+/*! @brief The product of two 4x4 homogeneous transforms, the basic operation of the kinematics */
+class MatrixMultiplyBenchmark : public Benchmark
+{
+public:
+    MatrixMultiplyBenchmark(const string& group, const string& name) : Benchmark(group, name) {}
+    void setUp()
+    {
+        m_a = transform(0.3, 1, 2, 3);
+        m_b = transform(-0.7, 4, 5, 6);
+    }
+    void run()
+    {
+        m_c = m_a*m_b;
+        benchmarkUse(m_c[0][0]);
+    }
+private:
+    Matrix m_a, m_b, m_c;
+};
+static MatrixMultiplyBenchmark matrixmultiply("Math", "MatrixMultiply4x4");
+
+/*! @brief The general inverse of a matrix, as used in the filters' measurement updates */
+class MatrixInverseBenchmark : public Benchmark
+{
+public:
+    MatrixInverseBenchmark(const string& group, const string& name, int size) : Benchmark(group, name), m_size(size) {}
+    void setUp()
+    {
+        m_a = covariance(m_size);
+    }
+    void run()
+    {
+        m_inverse = m_size == 2 ? Invert22(m_a) : InverseMatrix(m_a);
+        benchmarkUse(m_inverse[0][0]);
+    }
+private:
+    int m_size;
+    Matrix m_a, m_inverse;
+};
+static MatrixInverseBenchmark invert22("Math", "Invert2x2", 2);
+static MatrixInverseBenchmark inverse3("Math", "InverseMatrix3x3", 3);
+static MatrixInverseBenchmark inverse6("Math", "InverseMatrix6x6", 6);
+
+/*! @brief The Cholesky decomposition, which the SRUKF does for each update */
+class CholeskyBenchmark : public Benchmark
+{
+public:
+    CholeskyBenchmark(const string& group, const string& name, int size) : Benchmark(group, name), m_size(size) {}
+    void setUp()
+    {
+        m_a = covariance(m_size);
+    }
+    void run()
+    {
+        m_l = cholesky(m_a);
+        benchmarkUse(m_l[0][0]);
+    }
+private:
+    int m_size;
+    Matrix m_a, m_l;
+};
+static CholeskyBenchmark cholesky3("Math", "Cholesky3x3", 3);
+static CholeskyBenchmark cholesky6("Math", "Cholesky6x6", 6);
+
+/*! @brief Returns the uncertainty in the form the UKF expects it; the covariance */
+static Matrix filterUncertainty(const UKF&, const Matrix& covariance)
+{
+    return covariance;
+}
+
+/*! @brief Returns the uncertainty in the form the SRUKF expects it; the square root of the covariance */
+static Matrix filterUncertainty(const SRUKF&, const Matrix& covariance)
+{
+    return cholesky(covariance);
+}
+
+/*! @brief A measurement update of a two state position filter with a position measurement. The SRUKF's measurement
+           update assumes the measurement has as many dimensions as the state, so both filters have two states.
+    @param FilterType either UKF or SRUKF, which have the same interface
+ */
+template <typename FilterType> class FilterUpdateBenchmark : public Benchmark
+{
+public:
+    FilterUpdateBenchmark(const string& group, const string& name) : Benchmark(group, name), m_filter(2) {}
+    void setUp()
+    {
+        m_mean = Matrix(2, 1, false);
+        m_mean[0][0] = 100;
+        m_mean[1][0] = -50;
+        Matrix covariance(2, 2, false);
+        covariance[0][0] = 150*150;
+        covariance[1][1] = 100*100;
+        m_covariance = filterUncertainty(m_filter, covariance);
+        Matrix noise(2, 2, false);
+        noise[0][0] = 25;
+        noise[1][1] = 25;
+        m_noise = filterUncertainty(m_filter, noise);
+        m_measurement = Matrix(2, 1, false);
+        m_measurement[0][0] = 110;
+        m_measurement[1][0] = -40;
+        m_filter.CalculateSigmaWeights();
+    }
+    void run()
+    {
+        m_filter.setState(m_mean, m_covariance);
+        Matrix sigmas = m_filter.GenerateSigmaPoints();
+        m_filter.measurementUpdate(m_measurement, m_noise, sigmas, sigmas);
+        benchmarkUse(m_filter.getMean(0));
+    }
+    void tearDown()
+    {
+        addMetric("x", m_filter.getMean(0), "cm");
+        addMetric("sd(x)", m_filter.calculateSd(0), "cm");
+    }
+private:
+    FilterType m_filter;
+    Matrix m_mean, m_covariance, m_noise, m_measurement;
+};
+static FilterUpdateBenchmark<UKF> ukfupdate("Math", "UKFMeasurementUpdate");
+static FilterUpdateBenchmark<SRUKF> srukfupdate("Math", "SRUKFMeasurementUpdate");
+
+
+/*! @brief The least squares fit of a field line seen by vision, one point at a time as the line detection adds them */
+class LineFitBenchmark : public Benchmark
+{
+public:
+    LineFitBenchmark(const string& group, const string& name, int numpoints) : Benchmark(group, name), m_num_points(numpoints) {}
+    void setUp()
+    {
+        m_points = vector<LinePoint>(m_num_points);
+        for (int i=0; i<m_num_points; i++)
+        {   // points every 4 pixels along a line across the image, with a pixel of deterministic noise
+            m_points[i].x = 20 + 4*i;
+            m_points[i].y = 180 - 0.6*m_points[i].x + sin(1.7*i);
+            m_points[i].width = 3;
+        }
+    }
+    void run()
+    {
+        m_line.clearPoints();
+        for (int i=0; i<m_num_points; i++)
+            m_line.addPoint(m_points[i]);
+        benchmarkUse(m_line.getMSD());
+    }
+    void tearDown()
+    {
+        addMetric("gradient", m_line.getGradient(), "");
+        addMetric("r2tls", m_line.getr2tls(), "");
+        m_line.clearPoints();
+    }
+private:
+    int m_num_points;
+    vector<LinePoint> m_points;
+    LSFittedLine m_line;
+};
+static LineFitBenchmark linefit("Math", "LSFittedLine60Points", 60);
+
+/*! @brief The points of a corner seen by vision: the first half along a line across the image, and the second half turning a corner
+    @param numpoints the number of points
+    @param phase changes the noise on the points
+    @param pixels true to round the points to whole pixels, as vision's points are, so that many are the same distance from a line
+ */
+static vector<LinePoint> cornerPoints(int numpoints, double phase, bool pixels)
+{
+    vector<LinePoint> points(numpoints);
+    for (int i=0; i<numpoints; i++)
+    {
+        int j = i - numpoints/2;
+        if (j < 0)
+        {
+            points[i].x = 160 + 2*j;
+            points[i].y = 120 - 1.2*j + sin(1.7*i + phase);
+        }
+        else
+        {
+            points[i].x = 160 + 2*j + sin(1.7*i + phase);
+            points[i].y = 120 + j;
+        }
+        if (pixels)
+        {
+            points[i].x = floor(points[i].x + 0.5);
+            points[i].y = floor(points[i].y + 0.5);
+        }
+        points[i].width = 3;
+    }
+    return points;
+}
+
+/*! @brief The points, in whole pixels, of a roof that is symmetric about its peak, followed by a wall. Many of the roof's
+    points are exactly the same distance from the lines fitted to it, so which of them is the furthest is decided by
+    their order.
+ */
+static vector<LinePoint> roofPoints(int numpoints, int phase)
+{
+    int numroof = 2*(numpoints/3) + 1;
+    vector<LinePoint> points(numpoints);
+    for (int i=0; i<numpoints; i++)
+    {
+        int j = i - numroof/2;
+        int k = abs(j);
+        if (i < numroof)
+        {
+            points[i].x = 160 + 2*j;
+            points[i].y = 120 + k/2 + ((k + phase) % 3) - 1;
+        }
+        else
+        {
+            points[i].x = 160 + 2*(numroof/2);
+            points[i].y = 120 + 3*(i - numroof);
+        }
+        points[i].width = 3;
+    }
+    return points;
+}
+
+/*! @brief The outcome of splitting a corner's points until there are not enough far from the line to split */
+struct LineSplitResult
+{
+    int Splits;                 //!< the number of times the points were separated
+    int Removed;                //!< the number of points removed because they could not be separated
+    vector<LinePoint*> Points;  //!< the points left, in order. These are only kept by the check.
+    Line Fitted;                //!< the last line fitted
+};
+
+/*! @brief Splits the points as SAM::splitLSIterative did before the LineFitter: each step copies the points into a new
+    LSFittedLine, and separating copies them into a left and a right list, each starting with the split point.
+ */
+static LineSplitResult splitByCopying(const vector<LinePoint*>& allpoints, double threshold)
+{
+    LineSplitResult result;
+    result.Splits = result.Removed = 0;
+    vector<LinePoint*> points = allpoints;
+    LSFittedLine line;
+    do
+    {
+        line.clearPoints();
+        line.addPoints(points);
+        result.Fitted.setLine(line.getA(), line.getB(), line.getC());
+        // the furthest point, as SAM::findFurthestPoint found it
+        const double A = line.getA();
+        const double B = line.getB();
+        const double C = line.getC();
+        const double denom = sqrt(A*A + B*B);
+        int numover = 0;
+        int furthest = -1;
+        double greatest = 0;
+        for (size_t i=0; i<points.size(); i++)
+        {
+            double distance = fabs(A*points[i]->x + B*points[i]->y - C)/denom;
+            if (distance > threshold)
+            {
+                numover++;
+                if (distance > greatest)
+                {
+                    greatest = distance;
+                    furthest = i;
+                }
+            }
+        }
+        if (numover < 2)
+            break;
+
+        // the separation, as SAM::separateLS did it
+        LinePoint* split = points[furthest];
+        vector<LinePoint*> left(1, split), right(1, split);
+        double alpha = atan(-A/B);
+        double KB = B*split->x - A*split->y;
+        double div = (-A)*A - B*B;
+        double X0 = (-A)/div*C + (-B)*KB;
+        double X1 = (-B)*C + A/div*KB;
+        for (size_t i=0; i<points.size(); i++)
+        {
+            if (points[i] == split)
+                continue;
+            double position;
+            if (A == 0.0)
+                position = points[i]->x - split->x;
+            else if (B == 0.0)
+                position = points[i]->y - split->y;
+            else
+                position = (points[i]->x - X0)*cos(alpha) + (points[i]->y - X1)*sin(alpha);
+            if (position < 0)
+                left.push_back(points[i]);
+            else
+                right.push_back(points[i]);
+        }
+        if (left.size() != points.size() and right.size() != points.size())
+        {   // keep splitting the larger half
+            result.Splits++;
+            points = left.size() >= right.size() ? left : right;
+        }
+        else
+        {
+            result.Removed++;
+            points[furthest] = points.back();
+            points.pop_back();
+        }
+    } while (points.size() >= 3);
+    result.Points = points;
+    return result;
+}
+
+/*! @brief Returns the distance between two lines, as the largest of the differences between their unit normals and
+    between their distances from the origin in pixels
+ */
+static double lineDifference(const Line& a, const Line& b)
+{
+    double na = sqrt(a.getA()*a.getA() + a.getB()*a.getB());
+    double nb = sqrt(b.getA()*b.getA() + b.getB()*b.getB());
+    // the same line with its coefficients negated is the same line
+    double sign = (a.getA()*b.getA() + a.getB()*b.getB()) < 0 ? -1 : 1;
+    double difference = fabs(a.getA()/na - sign*b.getA()/nb);
+    difference = max(difference, fabs(a.getB()/na - sign*b.getB()/nb));
+    return max(difference, fabs(a.getC()/na - sign*b.getC()/nb));
+}
+
+/*! @brief The splitting of split and merge (SAM::splitLSIterative) on the points of a corner seen by vision.
+    A line is fitted to the range, and the furthest point from it is found. When the range cannot be separated at that
+    point, the point is removed and the line is refitted, until there are not enough points far from the line to split.
+    The fits are from the fitter's sums, so only the distances and the separation visit the points.
+
+    The set up checks that the fitter splits the corner, and corners with other noise, to the same line as copying
+    the points did, with the points as they are and rounded to whole pixels.
+ */
+class LineSplitBenchmark : public Benchmark
+{
+public:
+    LineSplitBenchmark(const string& group, const string& name, int numpoints) : Benchmark(group, name), m_num_points(numpoints) {}
+    void setUp()
+    {
+        checkSameLines();
+        m_points = cornerPoints(m_num_points, 0, false);
+        setPointers(m_points, m_point_pointers);
+    }
+    void run()
+    {
+        m_result = splitWithFitter(m_point_pointers);
+        benchmarkUse(m_result.Fitted.getA());
+    }
+    void tearDown()
+    {
+        double msd, r2tls;
+        m_fitter.getMoments(m_range).getFitQuality(msd, r2tls);
+        addMetric("splits", m_result.Splits, "");
+        addMetric("removed", m_result.Removed, "points");
+        addMetric("line", m_range.size(), "points");
+        addMetric("r2tls", r2tls, "");
+    }
+private:
+    /*! @brief Sets pointers to point at each of the points */
+    static void setPointers(vector<LinePoint>& points, vector<LinePoint*>& pointers)
+    {
+        pointers = vector<LinePoint*>(points.size());
+        for (size_t i=0; i<points.size(); i++)
+            pointers[i] = &points[i];
+    }
+    /*! @brief Splits the points with the fitter, leaving the range that is left in m_range, whose points are not copied into the result */
+    LineSplitResult splitWithFitter(const vector<LinePoint*>& points)
+    {
+        LineSplitResult result;
+        result.Splits = result.Removed = 0;
+        m_fitter.setPoints(points);
+        m_range = m_fitter.getAll();
+        LineFitter::Range left, right;
+        int numover = 0;
+        do
+        {
+            m_fitter.fit(m_range, result.Fitted);
+            int furthest = m_fitter.findFurthestPoint(m_range, result.Fitted, SplitDistance, numover);
+            if (numover < 2)
+                break;
+            if (m_fitter.separate(m_range, furthest, result.Fitted, left, right))
+            {   // keep splitting the larger half
+                result.Splits++;
+                m_range = left.size() >= right.size() ? left : right;
+            }
+            else
+            {
+                result.Removed++;
+                m_fitter.removePoint(m_range, furthest);
+            }
+        } while (m_range.size() >= 3);
+        return result;
+    }
+    /*! @brief Checks that the fitter and copying the points split a few corners the same way, to the same line */
+    void checkSameLines()
+    {
+        bool same = true;
+        double maxdifference = 0;
+        for (int k=0; k<3*NumCheckCorners; k++)
+        {
+            vector<LinePoint> points = cornerPoints(m_num_points, k/2, k % 2 == 1);
+            if (k >= 2*NumCheckCorners)
+                points = roofPoints(m_num_points + 1, k);
+            vector<LinePoint*> pointers;
+            setPointers(points, pointers);
+            LineSplitResult copied = splitByCopying(pointers, SplitDistance);
+            LineSplitResult fitted = splitWithFitter(pointers);
+            m_fitter.getPoints(m_range, fitted.Points);
+            same = same and copied.Splits == fitted.Splits and copied.Removed == fitted.Removed and copied.Points == fitted.Points;
+            maxdifference = max(maxdifference, lineDifference(copied.Fitted, fitted.Fitted));
+        }
+        addMetric("max line difference", maxdifference, "");
+        check(same, "the fitter splits and removes the same points, leaving them in the same order, as copying them did");
+        check(maxdifference < 1e-6, "the fitter splits to the same line as copying the points did");
+    }
+private:
+    static const int NumCheckCorners = 20;          //!< the number of differently noisy corners that are checked
+    static const double SplitDistance;              //!< the distance from the line beyond which a point can be split at
+    int m_num_points;
+    vector<LinePoint> m_points;
+    vector<LinePoint*> m_point_pointers;
+    LineFitter m_fitter;
+    LineFitter::Range m_range;          //!< the range of the points that is left at the end of the last run
+    LineSplitResult m_result;           //!< the outcome of the last run
+};
+const double LineSplitBenchmark::SplitDistance = 2.0;
+static LineSplitBenchmark linesplit("Math", "LineFitterSplit120Points", 120);
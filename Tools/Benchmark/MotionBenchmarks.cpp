@@ -0,0 +1,365 @@
+/*! @file MotionBenchmarks.cpp
+    @brief Benchmarks of a tick of each walk engine, of NBWalk's zmp controller, of the motion curves used by the scripts and
+           the head, and of loading a script
+
+    A walk tick is one cycle of the sense-move thread on the BenchmarkPlatform: the sensors are updated
+    from the simulated servos, the walk engine is given a speed and run, and the actions are interpolated and
+    sent to the servos. The walk runs closed loop, so it sees the results of its own actions. Each walk is
+    started and brought up to speed before it is timed. Kinematics/SensorsUpdate times the sensor update on
+    its own.
+
+    The zmp controller benchmarks replay the same zmp reference and accelerometer readings through the ublas Observer and
+    ZmpEKF and through the FixedObserver and FixedZmpEKF that replace them, and check that both give the same CoM
+    trajectory and sensor zmp.
+
+    The binary script benchmark checks that the precompiled script does not load when it has been cut short.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.h"
+#include "BenchmarkPlatform.h"
+#include "SensorRecording.h"
+
+#include "Infrastructure/NUBlackboard.h"
+#include "Infrastructure/NUSensorsData/NUSensorsData.h"
+#include "Infrastructure/NUActionatorsData/NUActionatorsData.h"
+#include "Infrastructure/Jobs/MotionJobs/WalkJob.h"
+#include "Motion/Walks/NBWalk/NBWalk.h"
+#include "Motion/Walks/NBWalk/Observer.h"
+#include "Motion/Walks/NBWalk/FixedObserver.h"
+#include "Motion/Walks/NBWalk/ZmpEKF.h"
+#include "Motion/Walks/NBWalk/FixedZmpEKF.h"
+#include "Motion/Walks/NBWalk/MotionConstants.h"
+#include "Motion/Walks/JWalk/JWalk.h"
+#include "Motion/Walks/JuppWalk/JuppWalk.h"
+#include "Motion/Tools/MotionCurves.h"
+#include "Motion/Tools/MotionScriptFile.h"
+
+#include "nubotdataconfig.h"
+
+#include <unistd.h>
+#include <cstdio>
+#include <vector>
+#include <list>
+#include <cmath>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+using namespace std;
+
+static NUWalk* createNBWalk() {return new NBWalk(Blackboard->Sensors, Blackboard->Actions);}
+static NUWalk* createJWalk() {return new JWalk();}
+static NUWalk* createJuppWalk() {return new JuppWalk(Blackboard->Sensors, Blackboard->Actions);}
+
+/*! @brief One sense-move cycle with a walk engine walking forwards and turning */
+class WalkTickBenchmark : public Benchmark
+{
+public:
+    WalkTickBenchmark(const string& group, const string& name, NUWalk* (*create)()) : Benchmark(group, name), m_create(create), m_walk(0), m_job(10, 0, 0.2) {}
+    void setUp()
+    {
+        m_platform = dynamic_cast<BenchmarkPlatform*>(Platform);
+        m_platform->replay(NULL);
+        m_walk = m_create();
+
+        // start the walk, and give it time to get up to speed
+        const int numwarmupticks = 500;
+        for (int i=0; i<numwarmupticks; i++)
+            run();
+
+        vector<float> speed;
+        m_walk->getCurrentSpeed(speed);
+        addMetric("speed after warm up", speed[0], "cm/s");
+    }
+    void run()
+    {
+        m_platform->tick();
+        m_walk->process(&m_job, true);
+        m_walk->process(Blackboard->Sensors, Blackboard->Actions);
+        m_platform->processActions();
+    }
+    void tearDown()
+    {
+        delete m_walk;
+        m_walk = 0;
+    }
+private:
+    NUWalk* (*m_create)();
+    BenchmarkPlatform* m_platform;
+    NUWalk* m_walk;
+    WalkJob m_job;
+};
+static WalkTickBenchmark nbwalktick("Motion", "NBWalkTick", createNBWalk);
+static WalkTickBenchmark jwalktick("Motion", "JWalkTick", createJWalk);
+static WalkTickBenchmark juppwalktick("Motion", "JuppWalkTick", createJuppWalk);
+
+/*! @brief Generates the zmp reference for a walk of a fixed sequence of steps, as the StepGenerator gives it to the controllers
+
+    Each step has a double support phase, in which the zmp moves linearly from one foot to the other, followed by a single
+    support phase, in which it stays over the stance foot. The walk starts and stops standing with the zmp between the feet,
+    and the reference is padded so that there is a full preview at every tick.
+    @param x the zmp reference in the x direction in mm
+    @param y the zmp reference in the y direction in mm
+ */
+static void generateZmpReference(vector<float>& x, vector<float>& y)
+{
+    const unsigned int numsteps = 20;
+    const float steplength = 50;
+    const float footoffset = 50;
+    const unsigned int numstanding = 1.0/MotionConstants::MOTION_FRAME_LENGTH_S;
+    const unsigned int numdouble = max(1, static_cast<int>(0.1/MotionConstants::MOTION_FRAME_LENGTH_S));
+    const unsigned int numsingle = max(1, static_cast<int>(0.3/MotionConstants::MOTION_FRAME_LENGTH_S));
+
+    x.assign(numstanding, 0);
+    y.assign(numstanding, 0);
+    float previousx = 0;
+    float previousy = 0;
+    for (unsigned int s=0; s<=numsteps; s++)
+    {
+        const float nextx = s*steplength;
+        const float nexty = s == numsteps ? 0 : (s%2 ? -footoffset : footoffset);
+        for (unsigned int i=1; i<=numdouble; i++)
+        {
+            const float t = static_cast<float>(i)/numdouble;
+            x.push_back(previousx + t*(nextx - previousx));
+            y.push_back(previousy + t*(nexty - previousy));
+        }
+        for (unsigned int i=0; i<numsingle; i++)
+        {
+            x.push_back(nextx);
+            y.push_back(nexty);
+        }
+        previousx = nextx;
+        previousy = nexty;
+    }
+    x.insert(x.end(), numstanding + Observer::NUM_PREVIEW_FRAMES + 1, previousx);
+    y.insert(y.end(), numstanding + Observer::NUM_PREVIEW_FRAMES + 1, previousy);
+}
+
+/*! @brief The controllers and sensor zmp filter of a StepGenerator, replaying a zmp reference and accelerometer readings
+
+    The sensor zmp is not fed back to the controllers, because the StepGenerator gives it no weight, so the filter only
+    sees the controllers' output, as it does in the StepGenerator.
+ */
+template <typename Controller, typename Filter> class ZmpReplay
+{
+public:
+    ZmpReplay(const vector<float>& refx, const vector<float>& refy, const SensorRecording& recording) : m_ref_x(refx), m_ref_y(refy), m_recording(recording)
+    {
+        reset();
+    }
+    /*! @brief Restarts the replay from the beginning of the reference */
+    void reset()
+    {
+        m_index = 0;
+        m_controller_x.initState(m_ref_x[0], 0, m_ref_x[0]);
+        m_controller_y.initState(m_ref_y[0], 0, m_ref_y[0]);
+        m_filter = Filter();
+        m_preview_x.assign(m_ref_x.begin() + 1, m_ref_x.begin() + 1 + Observer::NUM_PREVIEW_FRAMES);
+        m_preview_y.assign(m_ref_y.begin() + 1, m_ref_y.begin() + 1 + Observer::NUM_PREVIEW_FRAMES);
+    }
+    /*! @brief Returns the number of ticks in the replay */
+    unsigned int size() const {return m_ref_x.size() - Observer::NUM_PREVIEW_FRAMES - 1;}
+    /*! @brief Runs one motion tick of the filter and the controllers, restarting the replay when it reaches the end */
+    void tick()
+    {
+        if (m_index >= size())
+            reset();
+        const SensorRecording::Frame& frame = m_recording[m_index % m_recording.size()];
+        ZmpTimeUpdate tUp = {m_controller_x.getZMP(), m_controller_y.getZMP()};
+        // the recording's accelerometer is in cm/s/s, the filter expects m/s/s
+        ZmpMeasurement pMeasure = {m_controller_x.getPosition(), m_controller_y.getPosition(), 0.01f*frame.Accelerometer[0], 0.01f*frame.Accelerometer[1]};
+        m_filter.update(tUp, pMeasure);
+
+        const float cur_zmp_ref_x = m_ref_x[m_index];
+        const float cur_zmp_ref_y = m_ref_y[m_index];
+        m_controller_x.tick(&m_preview_x, cur_zmp_ref_x, cur_zmp_ref_x);
+        m_controller_y.tick(&m_preview_y, cur_zmp_ref_y, cur_zmp_ref_y);
+
+        m_index++;
+        m_preview_x.pop_front();
+        m_preview_y.pop_front();
+        m_preview_x.push_back(m_ref_x[m_index + Observer::NUM_PREVIEW_FRAMES]);
+        m_preview_y.push_back(m_ref_y[m_index + Observer::NUM_PREVIEW_FRAMES]);
+    }
+    float getCoMX() const {return m_controller_x.getPosition();}
+    float getCoMY() const {return m_controller_y.getPosition();}
+    float getSensorZMPX() const {return m_filter.get_zmp_x();}
+    float getSensorZMPY() const {return m_filter.get_zmp_y();}
+private:
+    const vector<float>& m_ref_x;
+    const vector<float>& m_ref_y;
+    const SensorRecording& m_recording;
+    unsigned int m_index;
+    Controller m_controller_x;
+    Controller m_controller_y;
+    Filter m_filter;
+    list<float> m_preview_x;
+    list<float> m_preview_y;
+};
+
+/*! @brief One tick of NBWalk's zmp controllers and sensor zmp filter, with either the ublas or the fixed size implementation
+
+    The set up replays the whole walk through both implementations side by side, and checks that they give the same CoM
+    trajectory and sensor zmp to within floating point rounding.
+ */
+template <typename Controller, typename Filter> class ZmpControllerBenchmark : public Benchmark
+{
+public:
+    ZmpControllerBenchmark(const string& group, const string& name) : Benchmark(group, name), m_replay(0) {}
+    void setUp()
+    {
+        generateZmpReference(m_ref_x, m_ref_y);
+        const SensorRecording& recording = SensorRecording::getDefault();
+        ZmpReplay<Observer, ZmpEKF> ublas(m_ref_x, m_ref_y, recording);
+        ZmpReplay<FixedObserver, FixedZmpEKF> fixed(m_ref_x, m_ref_y, recording);
+        float maxcom = 0;
+        float maxcomdifference = 0;
+        float maxzmpdifference = 0;
+        for (unsigned int i=0; i<ublas.size(); i++)
+        {
+            ublas.tick();
+            fixed.tick();
+            maxcom = max(maxcom, max(fabs(ublas.getCoMX()), fabs(ublas.getCoMY())));
+            maxcomdifference = max(maxcomdifference, max(fabs(ublas.getCoMX() - fixed.getCoMX()), fabs(ublas.getCoMY() - fixed.getCoMY())));
+            maxzmpdifference = max(maxzmpdifference, max(fabs(ublas.getSensorZMPX() - fixed.getSensorZMPX()), fabs(ublas.getSensorZMPY() - fixed.getSensorZMPY())));
+        }
+        addMetric("ticks compared", ublas.size(), "");
+        addMetric("max CoM difference", maxcomdifference, "mm");
+        addMetric("max sensor zmp difference", maxzmpdifference, "mm");
+        check(maxcom > 0, "the walk moves the CoM");
+        check(maxcomdifference < 1e-3*maxcom, "the fixed size controller gives the same CoM trajectory as the Observer");
+        check(maxzmpdifference < 1e-3*maxcom, "the fixed size filter gives the same sensor zmp as the ZmpEKF");
+
+        m_replay = new ZmpReplay<Controller, Filter>(m_ref_x, m_ref_y, recording);
+    }
+    void run()
+    {
+        m_replay->tick();
+        benchmarkUse(m_replay->getCoMX());
+    }
+    void tearDown()
+    {
+        delete m_replay;
+        m_replay = 0;
+    }
+private:
+    vector<float> m_ref_x;
+    vector<float> m_ref_y;
+    ZmpReplay<Controller, Filter>* m_replay;
+};
+static ZmpControllerBenchmark<Observer, ZmpEKF> zmpcontrollerublas("Motion", "ZmpControllerUblas");
+static ZmpControllerBenchmark<FixedObserver, FixedZmpEKF> zmpcontrollerfixed("Motion", "ZmpControllerFixed");
+
+/*! @brief The curves for a one second move of every joint through three points, as calculated for a motion script */
+class MotionCurvesBenchmark : public Benchmark
+{
+public:
+    MotionCurvesBenchmark(const string& group, const string& name) : Benchmark(group, name) {}
+    void setUp()
+    {
+        const size_t numjoints = BenchmarkPlatform::getServoNames().size();
+        m_times = vector<vector<double> >(numjoints);
+        m_positions = vector<vector<float> >(numjoints);
+        m_startpositions = vector<float>(numjoints, 0);
+        for (size_t i=0; i<numjoints; i++)
+        {
+            m_times[i].push_back(300);
+            m_times[i].push_back(700);
+            m_times[i].push_back(1000);
+            m_positions[i].push_back(0.5 + 0.01*i);
+            m_positions[i].push_back(-0.3);
+            m_positions[i].push_back(0.1*i);
+        }
+    }
+    void run()
+    {
+        MotionCurves::calculate(0, m_times, m_startpositions, m_positions, 0.5, 10, m_curvetimes, m_curvepositions, m_curvevelocities);
+        benchmarkUse(m_curvepositions[0][0]);
+    }
+private:
+    vector<vector<double> > m_times;
+    vector<vector<float> > m_positions;
+    vector<float> m_startpositions;
+    vector<vector<double> > m_curvetimes;
+    vector<vector<float> > m_curvepositions;
+    vector<vector<float> > m_curvevelocities;
+};
+static MotionCurvesBenchmark motioncurves("Motion", "MotionCurves");
+
+/*! @brief Loading the StandUpBack getup, either by parsing the text .num file or from the precompiled .nums file */
+class LoadScriptBenchmark : public Benchmark
+{
+public:
+    LoadScriptBenchmark(const string& group, const string& name, bool binary) : Benchmark(group, name), m_use_binary(binary) {}
+    void setUp()
+    {
+        char filename[64];
+        sprintf(filename, "/tmp/benchmark%d.nums", getpid());
+        m_text_filename = CONFIG_DIR + "Motion/Scripts/StandUpBack.num";
+        m_binary_filename = filename;
+        m_file.compile(m_text_filename, m_binary_filename);
+        if (m_use_binary)
+            checkTruncated();
+    }
+    void run()
+    {
+        if (m_use_binary)
+            m_file.load(m_binary_filename);
+        else
+            m_file.loadText(m_text_filename) and m_file.validate();
+        benchmarkUse(m_file.Times.size());
+    }
+    void tearDown()
+    {
+        size_t numpoints = 0;
+        for (size_t i=0; i<m_file.Times.size(); i++)
+            numpoints += m_file.Times[i].size();
+        addMetric("points", numpoints, "");
+        unlink(m_binary_filename.c_str());
+    }
+private:
+    /*! @brief Checks that the .nums file loads, and that it does not load when it is cut short anywhere */
+    void checkTruncated()
+    {
+        check(m_file.load(m_binary_filename), "the compiled script loads");
+        ifstream file(m_binary_filename.c_str(), ios::in | ios::binary);
+        string contents((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+        file.close();
+
+        string truncatedfilename = m_binary_filename + ".truncated";
+        bool rejected = true;
+        for (size_t length=0; length<contents.size() and rejected; length++)
+        {
+            ofstream truncated(truncatedfilename.c_str(), ios::out | ios::binary);
+            truncated.write(contents.data(), length);
+            truncated.close();
+            rejected = not m_file.load(truncatedfilename);
+        }
+        unlink(truncatedfilename.c_str());
+        check(rejected, "a script cut short anywhere does not load");
+    }
+private:
+    bool m_use_binary;
+    string m_text_filename;
+    string m_binary_filename;
+    MotionScriptFile m_file;
+};
+static LoadScriptBenchmark loadscripttext("Motion", "LoadScriptText", false);
+static LoadScriptBenchmark loadscriptbinary("Motion", "LoadScriptBinary", true);
@@ -0,0 +1,189 @@
+/*! @file NUviewBenchmarks.cpp
+    @brief Benchmarks of the parts of NUview that do not need Qt
+
+    Stream log playback is timed over a file of raw images, each filled with its frame number, stepping forwards
+    and backwards through the PlaybackCache used for the image stream, and stepping forwards by decoding each frame
+    from the file, as SplitStreamFileFormatReader did before the cache. Scrubbing steps back and forth over the first
+    few frames through the cache. The cache has the image stream's two decoders, and a budget of about half of the
+    file, so that frames are evicted when playing through it. Each frame is checked as it is shown. The time per frame
+    is the wall clock time from the start of playback divided by the frames shown, so it includes the decoder threads'
+    time, and is the throughput to compare between the cache and decoding each frame.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.h"
+
+#include "Infrastructure/NUImage/NUImage.h"
+#include "NUview/FileAccess/IndexedFileReader.h"
+#include "NUview/FileAccess/StreamPlaybackCache.h"
+
+#include <unistd.h>
+#include <time.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+using namespace std;
+
+/*! @brief Indexes a stream file of NUImages by reading the header of each frame and skipping its pixels */
+class ImageStreamIndexer : public IndexedFileReader
+{
+public:
+    void IndexFile()
+    {
+        FrameEntry entry;
+        entry.frameSequenceNumber = 0;
+        m_file.seekg(0, std::ios_base::beg);
+        while (true)
+        {
+            entry.position = m_file.tellg();
+            int width, height;
+            double timestamp;
+            m_file.read(reinterpret_cast<char*>(&width), sizeof(width));
+            m_file.read(reinterpret_cast<char*>(&height), sizeof(height));
+            m_file.read(reinterpret_cast<char*>(&timestamp), sizeof(timestamp));
+            if (not m_file.good())
+                break;
+            m_file.seekg(static_cast<long long>(width)*height*sizeof(Pixel), std::ios_base::cur);
+            entry.frameSequenceNumber++;
+            m_index.insert(IndexEntry(timestamp, entry));
+            m_timeIndex.push_back(timestamp);
+        }
+        m_file.clear();
+    }
+};
+
+/*! @brief Showing each frame of an image stream log in turn, as NUview does when a log is played */
+class PlaybackBenchmark : public Benchmark
+{
+public:
+    enum Mode
+    {
+        Uncached,                   //!< each frame is decoded from the file when it is shown
+        CachedForwards,             //!< the frames are shown in order through the cache
+        CachedBackwards,            //!< the frames are shown in reverse order through the cache
+        CachedScrubbing             //!< the first few frames are shown forwards and then backwards, over and over, through the cache
+    };
+    PlaybackBenchmark(const string& group, const string& name, Mode mode) : Benchmark(group, name), m_mode(mode), m_cache(0) {}
+    void setUp()
+    {
+        char filename[64];
+        sprintf(filename, "/tmp/benchmark%d.strm", getpid());
+        m_filename = filename;
+        vector<Pixel> row(FrameWidth);
+        ofstream file(m_filename.c_str(), ios_base::out | ios_base::binary);
+        for (int i=1; i<=NumFrames; i++)
+        {
+            int width = FrameWidth, height = FrameHeight;
+            double timestamp = 33*i;
+            file.write(reinterpret_cast<char*>(&width), sizeof(width));
+            file.write(reinterpret_cast<char*>(&height), sizeof(height));
+            file.write(reinterpret_cast<char*>(&timestamp), sizeof(timestamp));
+            for (int x=0; x<FrameWidth; x++)
+                row[x].color = 0x01010101*i;
+            for (int y=0; y<FrameHeight; y++)
+                file.write(reinterpret_cast<char*>(&row[0]), row.size()*sizeof(Pixel));
+        }
+        file.close();
+
+        m_reader.OpenFile(m_filename);
+        check(m_reader.IsValid() and m_reader.TotalFrames() == NumFrames, "every frame in the file is indexed");
+        m_file.open(m_filename.c_str(), ios_base::in | ios_base::binary);
+        if (m_mode != Uncached)
+        {
+            m_cache = new StreamPlaybackCache<NUImage>(CacheBytes, 2, 8, 4);
+            m_cache->Open(m_reader);
+        }
+        m_frame = m_mode == CachedBackwards ? NumFrames : 1;
+        m_step = 1;
+        m_num_shown = 0;
+        m_num_wrong = 0;
+        clock_gettime(CLOCK_MONOTONIC, &m_start);
+    }
+    void run()
+    {
+        NUImage* image = 0;
+        if (m_mode == Uncached)
+        {
+            m_file.clear();
+            m_file.seekg(m_reader.OffsetAtSequenceNumber(m_frame), ios_base::beg);
+            m_file >> m_image;
+            image = &m_image;
+        }
+        else
+            image = m_cache->ReadFrameNumber(m_frame);
+
+        if (image == 0 or image->getWidth() != FrameWidth or image->m_image[0][0].y != m_frame or image->m_image[FrameHeight-1][FrameWidth-1].y != m_frame)
+            m_num_wrong++;
+        m_num_shown++;
+        if (m_mode == CachedBackwards)
+            m_frame = m_frame == 1 ? NumFrames : m_frame - 1;
+        else if (m_mode == CachedScrubbing)
+        {
+            if (m_frame + m_step < 1 or m_frame + m_step > ScrubFrames)
+                m_step = -m_step;
+            m_frame += m_step;
+        }
+        else
+            m_frame = m_frame % NumFrames + 1;
+    }
+    void tearDown()
+    {
+        timespec end;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double elapsed = 1e6*(end.tv_sec - m_start.tv_sec) + 1e-3*(end.tv_nsec - m_start.tv_nsec);
+        check(m_num_wrong == 0, "every frame shown is the frame that was asked for");
+        addMetric("frame size", 1e-6*FrameWidth*FrameHeight*sizeof(Pixel), "MB");
+        addMetric("time per frame", elapsed/max(m_num_shown, 1.0), "us");
+        if (m_cache)
+        {
+            addMetric("hits", m_cache->NumHits()/max(m_num_shown, 1.0), "per frame");
+            addMetric("waits", m_cache->NumWaits()/max(m_num_shown, 1.0), "per frame");
+            addMetric("misses", m_cache->NumMisses()/max(m_num_shown, 1.0), "per frame");
+            addMetric("evicted", m_cache->NumEvicted(), "frames");
+            check(static_cast<size_t>(m_cache->NumBytes()) <= static_cast<size_t>(CacheBytes) + FrameWidth*FrameHeight*sizeof(Pixel) + 16, "the cache stays within its budget");
+            delete m_cache;
+            m_cache = 0;
+        }
+        m_file.close();
+        m_reader.CloseFile();
+        unlink(m_filename.c_str());
+    }
+private:
+    static const int FrameWidth = 320;              //!< the width of the frames
+    static const int FrameHeight = 240;             //!< the height of the frames
+    static const int NumFrames = 48;                //!< the number of frames in the file
+    static const long long CacheBytes = 8000000;    //!< the cache budget, about half of the file
+    static const int ScrubFrames = 16;              //!< the number of frames scrubbed over, which fit in the cache
+    Mode m_mode;
+    string m_filename;
+    ImageStreamIndexer m_reader;
+    ifstream m_file;
+    NUImage m_image;
+    StreamPlaybackCache<NUImage>* m_cache;
+    int m_frame;
+    int m_step;
+    double m_num_shown;
+    unsigned int m_num_wrong;
+    timespec m_start;                               //!< when playback started, so the time per frame includes the decoders' time
+};
+static PlaybackBenchmark playbackuncached("NUview", "PlaybackUncached", PlaybackBenchmark::Uncached);
+static PlaybackBenchmark playbackforwards("NUview", "PlaybackCachedForwards", PlaybackBenchmark::CachedForwards);
+static PlaybackBenchmark playbackbackwards("NUview", "PlaybackCachedBackwards", PlaybackBenchmark::CachedBackwards);
+static PlaybackBenchmark playbackscrubbing("NUview", "PlaybackCachedScrubbing", PlaybackBenchmark::CachedScrubbing);
@@ -0,0 +1,379 @@
+/*! @file PlatformBenchmarks.cpp
+    @brief Benchmarks of the parts of the platforms that can run on a desktop
+
+    The camera buffer ring is run with a FileBufferRing over a file of a few raw frames, each filled with its
+    frame number, so that the set up can check that the frames come out in order, and that a buffer is only
+    refilled once every CameraFrame referencing it has been released.
+
+    The Robotis motor controls are written to a DXEmulator through a DXBusThread, as Motors::write does, once as
+    sync writes and once as the per-motor WRITE packets they replaced. Each tick waits for the bus thread to finish
+    the write. The emulated bus time, the bytes written and the bytes of the status replies are reported per tick.
+    The set up submits more writes than the bus thread can queue without waiting, to check that they are all done.
+
+    The feedback parser replays a recording of the replies of both channels to many feedback requests, fuzzed with
+    corrupted packets and bytes of noise between packets, and pushed in pieces of random length. The set up checks
+    that exactly the intact packets are decoded, and that a channel's parser has no feedback from the motors on
+    the other channel, which is why Motors only copies feedback of the channel's own motors.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.h"
+
+#include "Infrastructure/NUImage/NUImage.h"
+#include "NUPlatform/NUCamera/FileBufferRing.h"
+#include "NUPlatform/Platforms/Robotis/DXBusThread.h"
+#include "NUPlatform/Platforms/Robotis/DXEmulator.h"
+#include "NUPlatform/Platforms/Robotis/DXFeedbackParser.h"
+#include "NUPlatform/Platforms/Robotis/DXPacketBuilder.h"
+#include "NUPlatform/Platforms/Robotis/dx117.h"
+
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+using namespace std;
+
+/*! @brief Taking the next frame from a camera buffer ring, and releasing the previous one, as NAOCamera::grabNewImage does */
+class CameraBufferRingBenchmark : public Benchmark
+{
+public:
+    CameraBufferRingBenchmark(const string& group, const string& name) : Benchmark(group, name), m_ring(0) {}
+    void setUp()
+    {
+        char filename[64];
+        sprintf(filename, "/tmp/benchmark%d.yuv", getpid());
+        m_filename = filename;
+        vector<char> frame(FrameWidth*FrameHeight*2);
+        ofstream file(m_filename.c_str(), ios_base::out | ios_base::binary);
+        for (int i=0; i<NumFrames; i++)
+        {
+            frame.assign(frame.size(), static_cast<char>(i + 1));
+            file.write(&frame[0], frame.size());
+        }
+        file.close();
+
+        m_ring = new FileBufferRing(m_filename, FrameWidth, FrameHeight, NumBuffers);
+        check(m_ring->isOpen() and m_ring->size() == NumBuffers and m_ring->available() == NumBuffers, "the ring has a free buffer for each frame");
+        checkOrder();
+        checkReferences();
+        check(m_ring->available() == NumBuffers, "every buffer is free once every frame has been released");
+    }
+    void run()
+    {
+        m_frame = m_ring->acquire();
+        benchmarkUse(m_frame.image()->m_image[0][0].y);
+    }
+    void tearDown()
+    {
+        m_frame.release();
+        delete m_ring;
+        m_ring = 0;
+        unlink(m_filename.c_str());
+    }
+private:
+    /*! @brief Returns the frame number the frame was filled with, or -1 if the handle is empty */
+    static int frameNumber(const CameraFrame& frame)
+    {
+        if (not frame.isValid())
+            return -1;
+        return frame.image()->m_image[0][0].y - 1;
+    }
+    /*! @brief Checks that the frames come out in the order they are in the file, going back to the start at the end of the file */
+    void checkOrder()
+    {
+        bool inorder = true;
+        CameraFrame frame;
+        for (int i=0; i<2*NumFrames + 1; i++)
+        {
+            frame = m_ring->acquire();
+            inorder = inorder and frameNumber(frame) == i%NumFrames;
+        }
+        check(inorder, "the frames come out in order, and repeat from the start of the file");
+    }
+    /*! @brief Checks that a buffer is not refilled while any CameraFrame references it, and is once none do */
+    void checkReferences()
+    {
+        vector<CameraFrame> frames;
+        for (int i=0; i<NumBuffers; i++)
+            frames.push_back(m_ring->acquire());
+        check(m_ring->available() == 0, "each acquired frame takes a buffer");
+        check(not m_ring->acquire().isValid(), "no frame is given out while every buffer is held");
+
+        const int held = frameNumber(frames[0]);
+        CameraFrame hold = CameraBufferRing::hold(frames[0].image());
+        check(hold.isValid() and hold.index() == frames[0].index(), "hold gives another handle to the frame of an image");
+        frames[0].release();
+        check(m_ring->available() == 0 and frameNumber(hold) == held, "a held buffer is not refilled when the other handle is released");
+        hold.release();
+        check(m_ring->available() == 1, "a buffer is freed when its last handle is released");
+        frames[0] = m_ring->acquire();
+        check(frames[0].isValid(), "a freed buffer is refilled");
+        frames.clear();
+    }
+private:
+    static const int FrameWidth = 640;          //!< the width of the NAO's camera frames
+    static const int FrameHeight = 480;         //!< the height of the NAO's camera frames
+    static const int NumFrames = 5;             //!< the number of frames in the file
+    static const int NumBuffers = 4;            //!< the number of buffers in the ring, fewer than frames so that buffers are refilled with different frames
+    string m_filename;
+    FileBufferRing* m_ring;
+    CameraFrame m_frame;
+};
+static CameraBufferRingBenchmark camerabufferring("NUPlatform", "CameraFileBufferRing");
+
+/*! @brief Writing the position, speed and punch of the lower body motors of a Robotis robot, and waiting for the bus thread to finish */
+class DXControlWriteBenchmark : public Benchmark
+{
+public:
+    DXControlWriteBenchmark(const string& group, const string& name, bool syncwrite) : Benchmark(group, name), m_sync_write(syncwrite) {}
+    void setUp()
+    {
+        m_emulator = new DXEmulator();
+        for (int i=0; i<NumMotors; i++)
+            m_emulator->addMotor(MotorIDs[i]);
+        m_bus = new DXBusThread("DXBenchmarkBusThread", m_emulator, 0);
+        m_tick = 0;
+
+        buildControls();
+        unsigned int ticket = 0;
+        for (int i=0; i<NumQueuedWrites; i++)
+            ticket = m_bus->submit(m_controls.data(), m_controls.size());
+        m_bus->waitForIdle();
+        check(m_bus->isComplete(ticket) and m_bus->getNumWrites() == NumQueuedWrites and m_emulator->getNumWrites() == NumQueuedWrites, "every write submitted while the queue was full is done");
+        drainReplies();
+        m_emulator->resetStatistics();
+    }
+    void run()
+    {
+        m_tick++;
+        buildControls();
+        m_bus->wait(m_bus->submit(m_controls.data(), m_controls.size()));
+        drainReplies();
+    }
+    void tearDown()
+    {
+        bool atgoal = true;
+        for (int i=0; i<NumMotors; i++)
+            atgoal = atgoal and m_emulator->getWord(MotorIDs[i], P_GOAL_POSITION_L) == position(i) and m_emulator->getWord(MotorIDs[i], P_PUNCH_L) == 32;
+        check(atgoal, "every motor has the position and punch of the last tick");
+        check(m_emulator->getNumChecksumErrors() == 0 and m_bus->getNumFailures() == 0, "every packet arrives intact");
+
+        double ticks = max(m_tick, 1U);
+        addMetric("packets", m_emulator->getNumPackets()/ticks, "per tick");
+        addMetric("bytes written", m_emulator->getNumBytesWritten()/ticks, "per tick");
+        addMetric("bytes replied", m_emulator->getNumBytesReplied()/ticks, "per tick");
+        addMetric("bus time", m_emulator->getBusTime()/ticks, "ms per tick");
+        delete m_bus;
+        delete m_emulator;
+    }
+private:
+    /*! @brief Returns the goal position of the motor with the given index for the current tick */
+    unsigned short position(int index) const
+    {
+        return 512 + 8*index + m_tick%64;
+    }
+    /*! @brief Fills m_controls with the packets for the current tick */
+    void buildControls()
+    {
+        m_controls.clear();
+        unsigned char controls[NumMotors][4];
+        unsigned char punches[NumMotors][2];
+        for (int i=0; i<NumMotors; i++)
+        {
+            controls[i][0] = position(i) & 0xFF;
+            controls[i][1] = position(i) >> 8;
+            controls[i][2] = 100;
+            controls[i][3] = 0;
+            punches[i][0] = 32;
+            punches[i][1] = 0;
+        }
+        if (m_sync_write)
+        {
+            m_controls.beginSyncWrite(P_GOAL_POSITION_L, 4);
+            for (int i=0; i<NumMotors; i++)
+                m_controls.addSyncWrite(MotorIDs[i], controls[i]);
+            m_controls.beginSyncWrite(P_PUNCH_L, 2);
+            for (int i=0; i<NumMotors; i++)
+                m_controls.addSyncWrite(MotorIDs[i], punches[i]);
+            m_controls.endSyncWrite();
+        }
+        else
+        {
+            for (int i=0; i<NumMotors; i++)
+            {
+                unsigned char control[5] = {P_GOAL_POSITION_L, controls[i][0], controls[i][1], controls[i][2], controls[i][3]};
+                m_controls.addPacket(MotorIDs[i], DX117_WRITE, control, 5);
+                unsigned char punch[3] = {P_PUNCH_L, punches[i][0], punches[i][1]};
+                m_controls.addPacket(MotorIDs[i], DX117_WRITE, punch, 3);
+            }
+        }
+    }
+    /*! @brief Reads and discards the status packets, as nothing reads them on the robot until the next request */
+    void drainReplies()
+    {
+        unsigned char replies[256];
+        while (m_emulator->read(replies, sizeof(replies)) > 0);
+    }
+private:
+    static const int NumMotors = 12;                //!< the number of motors on the lower body channel
+    static const unsigned char MotorIDs[NumMotors]; //!< the ids of the lower body motors
+    static const int NumQueuedWrites = 40;          //!< the number of writes submitted at once by the set up, more than the bus thread's queue holds
+    bool m_sync_write;
+    DXEmulator* m_emulator;
+    DXBusThread* m_bus;
+    DXPacketBuilder m_controls;
+    unsigned int m_tick;
+};
+const unsigned char DXControlWriteBenchmark::MotorIDs[DXControlWriteBenchmark::NumMotors] = {10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21};
+static DXControlWriteBenchmark dxsyncwrite("NUPlatform", "DXSyncWriteControls", true);
+static DXControlWriteBenchmark dxwrite("NUPlatform", "DXPerMotorWriteControls", false);
+
+/*! @brief Parsing a fuzzed recording of the feedback replies of both channels of a Cycloid */
+class DXFeedbackReplayBenchmark : public Benchmark
+{
+public:
+    DXFeedbackReplayBenchmark(const string& group, const string& name) : Benchmark(group, name) {}
+    void setUp()
+    {
+        m_lower.Ids.assign(LowerIDs, LowerIDs + NumLowerMotors);
+        m_upper.Ids.assign(UpperIDs, UpperIDs + NumUpperMotors);
+        unsigned int noise = 2468;
+        record(m_lower, noise);
+        record(m_upper, noise);
+        m_chunks.clear();
+        for (int i=0; i<NumChunks; i++)
+        {
+            noise = 1103515245*noise + 12345;
+            m_chunks.push_back(1 + (noise >> 16) % MaxChunk);
+        }
+
+        run();
+        checkReplay(m_lower, m_upper, "lower");
+        checkReplay(m_upper, m_lower, "upper");
+    }
+    void run()
+    {
+        replay(m_lower);
+        replay(m_upper);
+    }
+    void tearDown()
+    {
+        addMetric("bytes", m_lower.Stream.size() + m_upper.Stream.size(), "per replay");
+        addMetric("packets", m_lower.NumIntact + m_lower.NumCorrupted + m_upper.NumIntact + m_upper.NumCorrupted, "per replay");
+        addMetric("corrupted", m_lower.NumCorrupted + m_upper.NumCorrupted, "per replay");
+    }
+private:
+    struct Channel
+    {
+        vector<unsigned char> Ids;          //!< the ids of the motors on the channel
+        vector<unsigned char> Stream;       //!< the fuzzed replies, in the order they were read
+        unsigned short Positions[256];      //!< the position of each motor in its last reply
+        unsigned int NumIntact;             //!< the number of replies left intact
+        unsigned int NumCorrupted;          //!< the number of replies with a corrupted parameter
+        DXFeedbackParser Parser;
+    };
+    /*! @brief Requests feedback from each motor on the channel's emulated bus NumRounds times, and records the fuzzed replies */
+    void record(Channel& channel, unsigned int& noise)
+    {
+        DXEmulator emulator;
+        for (size_t i=0; i<channel.Ids.size(); i++)
+            emulator.addMotor(channel.Ids[i]);
+        channel.Stream.clear();
+        channel.NumIntact = 0;
+        channel.NumCorrupted = 0;
+        for (int round=0; round<NumRounds; round++)
+        {
+            for (size_t i=0; i<channel.Ids.size(); i++)
+            {
+                unsigned char id = channel.Ids[i];
+                unsigned short position = (37*id + 11*round) % 1024;
+                if ((position & 0xFF) >= 0xF0)          // no parameter byte is a start byte, or becomes one when it is corrupted
+                    position -= 0x10;
+                emulator.setWord(id, P_PRESENT_POSITION_L, position);
+
+                DXPacketBuilder request;
+                unsigned char parameters[2] = {P_PRESENT_POSITION_L, NUM_FEEDBACK_MOTOR};
+                request.addPacket(id, DX117_READ, parameters, 2);
+                emulator.write(request.data(), request.size());
+                unsigned char reply[64];
+                int length = emulator.read(reply, sizeof(reply));
+
+                noise = 1103515245*noise + 12345;
+                int fuzz = round == NumRounds - 1 ? -1 : (noise >> 16) % 10;
+                if (fuzz == 0)
+                {   // a corrupted parameter, so the checksum is wrong
+                    reply[5 + (noise >> 8) % NUM_FEEDBACK_MOTOR] ^= 0x01;
+                    channel.NumCorrupted++;
+                }
+                else
+                {
+                    if (fuzz == 1)
+                    {   // noise before the reply
+                        for (unsigned int j=0; j<1 + (noise >> 4) % 8; j++)
+                            channel.Stream.push_back((noise >> j) & 0x7F);
+                    }
+                    channel.Positions[id] = position;
+                    channel.NumIntact++;
+                }
+                channel.Stream.insert(channel.Stream.end(), reply, reply + length);
+            }
+        }
+    }
+    /*! @brief Pushes the channel's recording through its parser in pieces of random length */
+    void replay(Channel& channel)
+    {
+        channel.Parser.reset();
+        size_t index = 0;
+        for (size_t i=0; index < channel.Stream.size(); i = (i + 1) % m_chunks.size())
+        {
+            int length = min(m_chunks[i], static_cast<int>(channel.Stream.size() - index));
+            channel.Parser.push(&channel.Stream[index], length, 0);
+            index += length;
+        }
+    }
+    /*! @brief Checks that the channel's parser decoded exactly its intact replies, and has no feedback from the other channel's motors */
+    void checkReplay(const Channel& channel, const Channel& other, const string& name)
+    {
+        const DXFeedbackParser& parser = channel.Parser;
+        check(parser.getNumFeedbackPackets() == channel.NumIntact and parser.getNumChecksumErrors() == channel.NumCorrupted and parser.getNumPendingBytes() == 0, "every intact " + name + " reply is decoded, and every corrupted one is rejected");
+        bool latest = true;
+        for (size_t i=0; i<channel.Ids.size(); i++)
+            latest = latest and parser.getFeedback(channel.Ids[i]).Position == channel.Positions[channel.Ids[i]];
+        check(latest, "each " + name + " motor's feedback is from its last reply");
+        bool separate = true;
+        for (size_t i=0; i<other.Ids.size(); i++)
+            separate = separate and parser.getFeedback(other.Ids[i]).Sequence == 0;
+        check(separate, "the " + name + " parser has no feedback from the motors on the other channel");
+    }
+private:
+    static const int NumLowerMotors = 12;                   //!< the number of motors on the lower body channel
+    static const int NumUpperMotors = 11;                   //!< the number of motors on the upper body channel
+    static const unsigned char LowerIDs[NumLowerMotors];    //!< the ids of the lower body motors
+    static const unsigned char UpperIDs[NumUpperMotors];    //!< the ids of the upper body motors
+    static const int NumRounds = 100;                       //!< the number of times feedback is requested from every motor
+    static const int NumChunks = 97;                        //!< the number of piece lengths, which repeat
+    static const int MaxChunk = 64;                         //!< the longest piece pushed to the parser at once
+    Channel m_lower;
+    Channel m_upper;
+    vector<int> m_chunks;
+};
+const unsigned char DXFeedbackReplayBenchmark::LowerIDs[DXFeedbackReplayBenchmark::NumLowerMotors] = {10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21};
+const unsigned char DXFeedbackReplayBenchmark::UpperIDs[DXFeedbackReplayBenchmark::NumUpperMotors] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 22};
+static DXFeedbackReplayBenchmark dxfeedbackreplay("NUPlatform", "DXFeedbackReplay");
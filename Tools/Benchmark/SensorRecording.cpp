@@ -0,0 +1,181 @@
+/*! @file SensorRecording.cpp
+    @brief Implementation of the SensorRecording class
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SensorRecording.h"
+#include "BenchmarkPlatform.h"
+
+#include "Infrastructure/NUBlackboard.h"
+#include "Infrastructure/NUSensorsData/NUSensorsData.h"
+#include "Infrastructure/NUActionatorsData/NUActionatorsData.h"
+#include "Infrastructure/Jobs/MotionJobs/WalkJob.h"
+#include "Motion/Walks/NBWalk/NBWalk.h"
+
+#include <fstream>
+#include <limits>
+#include <cmath>
+using namespace std;
+
+/*! @brief A segment of the speed profile walked to generate the default recording */
+struct SpeedSegment
+{
+    double Duration;                            //!< the duration of the segment in ms
+    float TranslationSpeed;                     //!< the translation speed in cm/s
+    float Direction;                            //!< the direction of the translation in radians
+    float RotationSpeed;                        //!< the rotation speed in rad/s
+};
+
+static const SpeedSegment speed_profile[] = {{3000, 10, 0, 0},
+                                             {2000, 15, 0, 0.3},
+                                             {2000, 6, 1.5708, 0},
+                                             {2000, 8, 0, -0.4},
+                                             {1000, 0, 0, 0}};
+
+SensorRecording::SensorRecording()
+{
+}
+
+SensorRecording::~SensorRecording()
+{
+}
+
+/*! @brief Loads the frames in a NUSensorsData stream, replacing the current frames
+    @param filename the name of the stream
+    @return true if at least one frame was loaded
+ */
+bool SensorRecording::load(const string& filename)
+{
+    ifstream file(filename.c_str(), ios_base::binary);
+    if (not file.is_open())
+        return false;
+
+    clear();
+    NUSensorsData data;
+    while (file.good() and file.peek() != EOF)
+    {
+        file >> data;
+        if (file.fail())
+            break;
+        add(data);
+    }
+    m_source = filename;
+    return not m_frames.empty();
+}
+
+/*! @brief Appends a frame with the raw readings in the data. The joints are stored in the BenchmarkPlatform's servo order.
+    @param data the sensor data to add
+ */
+void SensorRecording::add(NUSensorsData& data)
+{
+    static float NaN = numeric_limits<float>::quiet_NaN();
+    const vector<string>& names = BenchmarkPlatform::getServoNames();
+
+    Frame frame;
+    frame.Time = data.CurrentTime;
+    frame.Positions = vector<float>(names.size(), NaN);
+    frame.Targets = vector<float>(names.size(), NaN);
+    frame.Stiffnesses = vector<float>(names.size(), NaN);
+    for (size_t i=0; i<names.size(); i++)
+    {
+        NUData::id_t* id = data.getId(names[i]);
+        if (id == NULL)
+            continue;
+        data.getPosition(*id, frame.Positions[i]);
+        data.getTarget(*id, frame.Targets[i]);
+        data.getStiffness(*id, frame.Stiffnesses[i]);
+    }
+    data.get(NUSensorsData::Accelerometer, frame.Accelerometer);
+    data.get(NUSensorsData::Gyro, frame.Gyro);
+    data.get(NUSensorsData::LFootTouch, frame.LFootTouch);
+    data.get(NUSensorsData::RFootTouch, frame.RFootTouch);
+    m_frames.push_back(frame);
+}
+
+/*! @brief Removes all of the frames */
+void SensorRecording::clear()
+{
+    m_frames.clear();
+    m_source.clear();
+}
+
+/*! @brief Returns the recording used by the benchmarks, generating it if a recording has not been loaded */
+SensorRecording& SensorRecording::getDefault()
+{
+    SensorRecording& recording = defaultRecording();
+    if (recording.empty())
+        recording.generate(10000);
+    return recording;
+}
+
+/*! @brief Loads the recording used by the benchmarks from a file
+    @param filename the name of the NUSensorsData stream
+    @return true if the recording was loaded
+ */
+bool SensorRecording::loadDefault(const string& filename)
+{
+    return defaultRecording().load(filename);
+}
+
+/*! @brief Returns the recording used by the benchmarks, whether or not it has any frames */
+SensorRecording& SensorRecording::defaultRecording()
+{
+    static SensorRecording recording;
+    return recording;
+}
+
+/*! @brief Generates a recording by walking the BenchmarkPlatform with the NBWalk through the speed profile.
+
+    The platform must already have been created, and is left in the pose at the end of the walk.
+
+    @param duration the length of the recording in ms
+ */
+void SensorRecording::generate(double duration)
+{
+    BenchmarkPlatform* platform = dynamic_cast<BenchmarkPlatform*>(Platform);
+    if (platform == NULL)
+        return;
+
+    clear();
+    platform->replay(NULL);
+    NBWalk walk(Blackboard->Sensors, Blackboard->Actions);
+
+    double start = platform->getTime();
+    size_t segment = 0;
+    double segmentend = start + speed_profile[0].Duration;
+    const size_t numsegments = sizeof(speed_profile)/sizeof(*speed_profile);
+    while (platform->getTime() - start < duration)
+    {
+        platform->tick();
+        add(*Blackboard->Sensors);
+
+        if (platform->getTime() >= segmentend)
+        {
+            segment = (segment + 1) % numsegments;
+            segmentend += speed_profile[segment].Duration;
+        }
+        const SpeedSegment& s = speed_profile[segment];
+        WalkJob job(s.TranslationSpeed, s.Direction, s.RotationSpeed);
+        walk.process(&job, true);
+        walk.process(Blackboard->Sensors, Blackboard->Actions);
+        platform->processActions();
+    }
+    m_source = "generated";
+}
+
@@ -0,0 +1,80 @@
+/*! @file SensorRecording.h
+    @brief Declaration of the SensorRecording class
+
+    @class SensorRecording
+    @brief The raw sensor readings of a run of the robot, used as realistic input by the benchmarks.
+
+    A recording is either loaded from a NUSensorsData stream (the sensor.strm written by the ImageLoggerThread,
+    or saved by NUview), or generated by walking the BenchmarkPlatform with the NBWalk through a fixed sequence
+    of speeds. The generated recording is deterministic, so it gives the same inputs on every machine, but a
+    recording from the robot is a better test of the filters, and should be used when one is available.
+
+    The benchmarks use the default recording, which is generated the first time it is needed unless a file was
+    loaded with loadDefault().
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SENSORRECORDING_H
+#define SENSORRECORDING_H
+
+class NUSensorsData;
+
+#include <vector>
+#include <string>
+
+class SensorRecording
+{
+public:
+    /*! @brief The raw readings of the sensors at one time */
+    struct Frame
+    {
+        double Time;                            //!< the time of the readings in ms
+        std::vector<float> Positions;           //!< the position of each joint in radians
+        std::vector<float> Targets;             //!< the target of each joint in radians
+        std::vector<float> Stiffnesses;         //!< the stiffness of each joint in percent
+        std::vector<float> Accelerometer;       //!< the accelerometer [x, y, z] in cm/s/s
+        std::vector<float> Gyro;                //!< the gyro [x, y, z] in rad/s
+        std::vector<float> LFootTouch;          //!< the left foot sole forces in N
+        std::vector<float> RFootTouch;          //!< the right foot sole forces in N
+    };
+public:
+    SensorRecording();
+    ~SensorRecording();
+
+    bool load(const std::string& filename);
+    void add(NUSensorsData& data);
+    void clear();
+
+    unsigned int size() const {return m_frames.size();}
+    bool empty() const {return m_frames.empty();}
+    const Frame& operator[](unsigned int i) const {return m_frames[i];}
+    const std::string& getSource() const {return m_source;}
+
+    static SensorRecording& getDefault();
+    static bool loadDefault(const std::string& filename);
+private:
+    void generate(double duration);
+    static SensorRecording& defaultRecording();
+private:
+    std::vector<Frame> m_frames;                //!< the frames in the order they were recorded
+    std::string m_source;                       //!< where the frames came from; the file name or "generated"
+};
+
+#endif
+
@@ -0,0 +1,129 @@
+/*! @file StartupBenchmarks.cpp
+    @brief Benchmarks of creating the subsystems at startup, one after another and with the StartupScheduler
+
+    The benchmark creates the subsystems that build without a robot in the same order, and with the same dependencies,
+    as NUbot::createSubsystems: the LUT is loaded (and compacted, as Vision does when there is no compact table),
+    the walk engine and localisation are created, and the motion scripts are loaded once the walk exists.
+    How long the last run took, and the time it spent in all of the phases, are reported as metrics.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.h"
+
+#include "Infrastructure/NUBlackboard.h"
+#include "Localisation/Localisation.h"
+#include "Motion/NUWalk.h"
+#include "Motion/Tools/MotionScript.h"
+#include "Tools/FileFormats/CompactLUT.h"
+#include "Tools/FileFormats/LUTTools.h"
+#include "Tools/Profiling/StartupProfiler.h"
+#include "Tools/Threading/StartupScheduler.h"
+
+#include <unistd.h>
+#include <cstdio>
+#include <vector>
+using namespace std;
+
+/*! @brief The subsystems of the nubot that the benchmark creates at startup */
+class BenchmarkSubsystems
+{
+public:
+    BenchmarkSubsystems(const string& lutfilename) : m_lut_filename(lutfilename), m_lut(LUTTools::LUT_SIZE), m_localisation(0), m_walk(0) {}
+    ~BenchmarkSubsystems()
+    {
+        delete m_localisation;
+        delete m_walk;
+        for (size_t i=0; i<m_scripts.size(); i++)
+            delete m_scripts[i];
+    }
+    void createVision()
+    {
+        LUTTools::LoadLUT(&m_lut[0], m_lut.size(), m_lut_filename.c_str());
+        m_compact_lut.build(&m_lut[0]);
+    }
+    void createLocalisation()
+    {
+        m_localisation = new Localisation();
+    }
+    void createMotion()
+    {
+        m_walk = NUWalk::getWalkEngine(Blackboard->Sensors, Blackboard->Actions);
+    }
+    void preloadMotionScripts()
+    {
+        const char* names[] = {"StandUpBack", "StandUpFront", "OnLeftRoll", "OnRightRoll", "BlockLeft", "BlockRight"};
+        for (size_t i=0; i<sizeof(names)/sizeof(*names); i++)
+        {
+            m_scripts.push_back(new MotionScript(names[i]));
+            m_scripts.back()->preload();
+        }
+    }
+private:
+    string m_lut_filename;
+    vector<unsigned char> m_lut;
+    CompactLUT m_compact_lut;
+    Localisation* m_localisation;
+    NUWalk* m_walk;
+    vector<MotionScript*> m_scripts;
+};
+
+/*! @brief Creating the subsystems on a number of threads; one thread creates them one after another */
+class StartupBenchmark : public Benchmark
+{
+public:
+    StartupBenchmark(const string& group, const string& name, unsigned int numthreads) : Benchmark(group, name), m_num_threads(numthreads) {}
+    void setUp()
+    {
+        char filename[64];
+        sprintf(filename, "/tmp/benchmark%d.lut", getpid());
+        m_lut_filename = filename;
+        vector<unsigned char> lut(LUTTools::LUT_SIZE, 0);
+        LUTTools::SaveLUT(&lut[0], lut.size(), m_lut_filename.c_str());
+    }
+    void run()
+    {
+        StartupProfiler profiler;
+        StartupScheduler scheduler(&profiler);
+        BenchmarkSubsystems subsystems(m_lut_filename);
+        scheduler.add("Vision", &subsystems, &BenchmarkSubsystems::createVision);
+        scheduler.add("Motion", &subsystems, &BenchmarkSubsystems::createMotion);
+        scheduler.add("Localisation", &subsystems, &BenchmarkSubsystems::createLocalisation);
+        scheduler.add("MotionScripts", &subsystems, &BenchmarkSubsystems::preloadMotionScripts, "Motion");
+        scheduler.run(m_num_threads);
+
+        m_total_time = profiler.getTotalTime();
+        m_phase_time = 0;
+        vector<StartupProfiler::Phase> phases = profiler.getPhases();
+        for (size_t i=0; i<phases.size(); i++)
+            m_phase_time += phases[i].End - phases[i].Start;
+    }
+    void tearDown()
+    {
+        addMetric("startup", m_total_time, "ms");
+        addMetric("phases", m_phase_time, "ms");
+        unlink(m_lut_filename.c_str());
+    }
+private:
+    unsigned int m_num_threads;
+    string m_lut_filename;
+    double m_total_time;            //!< the time the last run took to create every subsystem
+    double m_phase_time;            //!< the sum of the times of each phase in the last run
+};
+static StartupBenchmark startupserial("Startup", "Serial", 1);
+static StartupBenchmark startupparallel("Startup", "Parallel3", 3);
@@ -0,0 +1,409 @@
+/*! @file ThreadingBenchmarks.cpp
+    @brief Benchmarks of the data structures shared between threads: the lock free queue and the FieldObjects snapshots
+
+    The lock free queue is compared with the mutex protected std::deque it replaced, first with one thread pushing
+    and popping, and then with 1, 2 and 4 producer threads pushing as fast as they can while the benchmark pops.
+    The producers time each of their pushes, and the median, p99 and worst push are reported. The snapshots are timed
+    with no other threads, and with a writer thread publishing as fast as it can while the benchmark reads.
+
+    The motion tick jitter benchmarks wait for each tick of the sense-move period, placed as the NAO's Threads.cfg
+    places a real-time thread, with nothing else running and with a busy thread on every cpu. The time each wait
+    takes is the period; the lateness of each tick is reported separately. The number of ticks more than half a
+    period late is only checked when the real-time policy was granted, because without root the ticks are scheduled
+    like the load. It is checked over at least two seconds of ticks, however few samples the run takes.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.h"
+
+#include "Infrastructure/FieldObjects/FieldObjects.h"
+#include "Infrastructure/FieldObjects/FieldObjectsSnapshots.h"
+#include "Tools/Threading/LockFreeQueue.h"
+#include "Tools/Threading/ThreadPlacement.h"
+#include "nubotconfig.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <sstream>
+#include <utility>
+#include <vector>
+using namespace std;
+
+/*! @brief A push and a pop of the lock free queue, with no other threads */
+class LockFreeQueueBenchmark : public Benchmark
+{
+public:
+    LockFreeQueueBenchmark(const string& group, const string& name) : Benchmark(group, name), m_queue(64) {}
+    void run()
+    {
+        int value = 0;
+        m_queue.push(1);
+        m_queue.pop(value);
+        benchmarkUse(value);
+    }
+private:
+    LockFreeQueue<int> m_queue;
+};
+static LockFreeQueueBenchmark lockfreequeue("Threading", "LockFreeQueuePushPop");
+
+/*! @brief A push and a pop of a mutex protected std::deque, which is what the QueueThread uses */
+class MutexQueueBenchmark : public Benchmark
+{
+public:
+    MutexQueueBenchmark(const string& group, const string& name) : Benchmark(group, name)
+    {
+        pthread_mutex_init(&m_mutex, NULL);
+    }
+    ~MutexQueueBenchmark()
+    {
+        pthread_mutex_destroy(&m_mutex);
+    }
+    void run()
+    {
+        pthread_mutex_lock(&m_mutex);
+        m_queue.push_back(1);
+        pthread_mutex_unlock(&m_mutex);
+
+        pthread_mutex_lock(&m_mutex);
+        int value = m_queue.front();
+        m_queue.pop_front();
+        pthread_mutex_unlock(&m_mutex);
+        benchmarkUse(value);
+    }
+private:
+    pthread_mutex_t m_mutex;
+    deque<int> m_queue;
+};
+static MutexQueueBenchmark mutexqueue("Threading", "MutexQueuePushPop");
+
+/*! @brief Returns the value below which the fraction of the sorted values lie, or 0 if there are none */
+static double percentile(const vector<double>& sorted, double fraction)
+{
+    if (sorted.empty())
+        return 0;
+    return sorted[min(sorted.size() - 1, static_cast<size_t>(fraction*sorted.size()))];
+}
+
+/*! @brief The lock free queue shared by several producers, dropping the newest entry when it is full */
+class LockFreeSharedQueue
+{
+public:
+    LockFreeSharedQueue(unsigned int capacity) : m_queue(capacity) {}
+    void push(int value) {m_queue.push(value);}
+    bool pop(int& value) {return m_queue.pop(value);}
+private:
+    LockFreeQueue<int> m_queue;
+};
+
+/*! @brief The mutex protected std::deque of a QueueThread shared by several producers, bounded like the lock free queue */
+class MutexSharedQueue
+{
+public:
+    MutexSharedQueue(unsigned int capacity) : m_capacity(capacity) {pthread_mutex_init(&m_mutex, NULL);}
+    ~MutexSharedQueue() {pthread_mutex_destroy(&m_mutex);}
+    void push(int value)
+    {
+        pthread_mutex_lock(&m_mutex);
+        if (m_queue.size() < m_capacity)
+            m_queue.push_back(value);
+        pthread_mutex_unlock(&m_mutex);
+    }
+    bool pop(int& value)
+    {
+        pthread_mutex_lock(&m_mutex);
+        bool popped = not m_queue.empty();
+        if (popped)
+        {
+            value = m_queue.front();
+            m_queue.pop_front();
+        }
+        pthread_mutex_unlock(&m_mutex);
+        return popped;
+    }
+private:
+    unsigned int m_capacity;
+    pthread_mutex_t m_mutex;
+    deque<int> m_queue;
+};
+
+/*! @brief Popping from a queue that several producer threads push to as fast as they can.
+
+    Each producer times every push it makes, so the tail of the push latency can be compared between the queues;
+    a producer that pushes while another holds the mutex has to wait for it, even if that thread has been preempted.
+ */
+template <typename Queue>
+class SharedQueueBenchmark : public Benchmark
+{
+public:
+    SharedQueueBenchmark(const string& group, const string& name, unsigned int numproducers) : Benchmark(group, name), m_num_producers(numproducers) {}
+    void setUp()
+    {
+        m_queue = new Queue(64);
+        m_stop = false;
+        m_num_popped = 0;
+        m_push_times.assign(m_num_producers, vector<double>());
+        for (size_t i=0; i<m_push_times.size(); i++)
+            m_push_times[i].reserve(MaxPushTimes);
+        m_producers.resize(m_num_producers);
+        m_producer_indices.resize(m_num_producers);
+        for (size_t i=0; i<m_producers.size(); i++)
+        {
+            m_producer_indices[i] = make_pair(this, i);
+            pthread_create(&m_producers[i], NULL, runProducer, &m_producer_indices[i]);
+        }
+    }
+    void run()
+    {
+        int value = 0;
+        while (not m_queue->pop(value))
+            sched_yield();
+        m_num_popped++;
+        benchmarkUse(value);
+    }
+    void tearDown()
+    {
+        m_stop = true;
+        for (size_t i=0; i<m_producers.size(); i++)
+            pthread_join(m_producers[i], NULL);
+        delete m_queue;
+
+        vector<double> pushtimes;
+        for (size_t i=0; i<m_push_times.size(); i++)
+            pushtimes.insert(pushtimes.end(), m_push_times[i].begin(), m_push_times[i].end());
+        sort(pushtimes.begin(), pushtimes.end());
+        addMetric("producers", m_num_producers, "");
+        addMetric("pushes", pushtimes.size(), "");
+        addMetric("popped", m_num_popped, "");
+        addMetric("median push", percentile(pushtimes, 0.5), "ns");
+        addMetric("p99 push", percentile(pushtimes, 0.99), "ns");
+        addMetric("worst push", percentile(pushtimes, 1), "ns");
+    }
+private:
+    static void* runProducer(void* arg)
+    {
+        pair<SharedQueueBenchmark*, size_t>* index = static_cast<pair<SharedQueueBenchmark*, size_t>*>(arg);
+        SharedQueueBenchmark* benchmark = index->first;
+        vector<double>& pushtimes = benchmark->m_push_times[index->second];
+        int value = 0;
+        while (not benchmark->m_stop)
+        {
+            timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            benchmark->m_queue->push(value++);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            if (pushtimes.size() < MaxPushTimes)
+                pushtimes.push_back(1e9*(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec));
+        }
+        return NULL;
+    }
+private:
+    static const size_t MaxPushTimes = 1 << 18;     //!< the number of pushes timed by each producer, so that timing them never allocates
+    unsigned int m_num_producers;
+    Queue* m_queue;
+    volatile bool m_stop;
+    unsigned int m_num_popped;
+    vector<pthread_t> m_producers;
+    vector<pair<SharedQueueBenchmark*, size_t> > m_producer_indices;
+    vector<vector<double> > m_push_times;           //!< the time each push took in ns, for each producer
+};
+static SharedQueueBenchmark<LockFreeSharedQueue> lockfreequeue1("Threading", "LockFreeQueue1Producer", 1);
+static SharedQueueBenchmark<LockFreeSharedQueue> lockfreequeue2("Threading", "LockFreeQueue2Producers", 2);
+static SharedQueueBenchmark<LockFreeSharedQueue> lockfreequeue4("Threading", "LockFreeQueue4Producers", 4);
+static SharedQueueBenchmark<MutexSharedQueue> mutexqueue1("Threading", "MutexQueue1Producer", 1);
+static SharedQueueBenchmark<MutexSharedQueue> mutexqueue2("Threading", "MutexQueue2Producers", 2);
+static SharedQueueBenchmark<MutexSharedQueue> mutexqueue4("Threading", "MutexQueue4Producers", 4);
+
+/*! @brief Moves the ball and the robot a little, so that each publish has something new in it */
+static void moveObjects(FieldObjects& objects, unsigned int frame)
+{
+    float t = 0.01*frame;
+    objects.self.updateLocationOfSelf(100*cos(t), 100*sin(t), t, 15, 15, 0.1, false);
+    objects.mobileFieldObjects[FieldObjects::FO_BALL].updateObjectLocation(200*sin(3*t), 150*sin(5*t), 10, 10);
+}
+
+/*! @brief Publishing the FieldObjects as the SeeThinkThread does at the end of each frame, with no readers */
+class SnapshotPublishBenchmark : public Benchmark
+{
+public:
+    SnapshotPublishBenchmark(const string& group, const string& name) : Benchmark(group, name) {}
+    void setUp()
+    {
+        m_objects = new FieldObjects();
+        m_snapshots = new FieldObjectsSnapshots();
+        m_frame = 0;
+    }
+    void run()
+    {
+        moveObjects(*m_objects, m_frame++);
+        benchmarkUse(m_snapshots->publish(*m_objects));
+    }
+    void tearDown()
+    {
+        delete m_snapshots;
+        delete m_objects;
+    }
+private:
+    FieldObjects* m_objects;
+    FieldObjectsSnapshots* m_snapshots;
+    unsigned int m_frame;
+};
+static SnapshotPublishBenchmark snapshotpublish("Threading", "FieldObjectsPublish");
+
+/*! @brief Pinning and reading the latest FieldObjects snapshot, as the TeamTransmissionThread does, while another thread publishes continuously */
+class SnapshotPinBenchmark : public Benchmark
+{
+public:
+    SnapshotPinBenchmark(const string& group, const string& name) : Benchmark(group, name) {}
+    void setUp()
+    {
+        m_snapshots = new FieldObjectsSnapshots();
+        m_snapshots->publish(FieldObjects());
+        m_stop = false;
+        m_num_published = 0;
+        pthread_create(&m_writer, NULL, runWriter, this);
+    }
+    void run()
+    {
+        FieldObjectsSnapshots::Snapshot snapshot = m_snapshots->pin();
+        benchmarkUse(snapshot->mobileFieldObjects[FieldObjects::FO_BALL].X());
+    }
+    void tearDown()
+    {
+        m_stop = true;
+        pthread_join(m_writer, NULL);
+        addMetric("published", m_num_published, "snapshots");
+        addMetric("reader retries", m_snapshots->getNumReaderRetries(), "");
+        addMetric("writer waits", m_snapshots->getNumWriterWaits(), "");
+        delete m_snapshots;
+    }
+private:
+    static void* runWriter(void* arg)
+    {
+        SnapshotPinBenchmark* benchmark = static_cast<SnapshotPinBenchmark*>(arg);
+        FieldObjects objects;
+        while (not benchmark->m_stop)
+        {
+            moveObjects(objects, benchmark->m_num_published);
+            benchmark->m_snapshots->publish(objects);
+            benchmark->m_num_published++;
+        }
+        return NULL;
+    }
+private:
+    FieldObjectsSnapshots* m_snapshots;
+    pthread_t m_writer;
+    volatile bool m_stop;
+    volatile unsigned int m_num_published;
+};
+static SnapshotPinBenchmark snapshotpin("Threading", "FieldObjectsPinWhilePublishing");
+
+/*! @brief Waiting for the next tick of the sense-move period with a real-time placement, with or without a busy thread on every cpu */
+class MotionTickJitterBenchmark : public Benchmark
+{
+public:
+    MotionTickJitterBenchmark(const string& group, const string& name, bool load) : Benchmark(group, name), m_load(load) {}
+    void setUp()
+    {
+        m_stop = false;
+        m_load_threads.clear();
+        if (m_load)
+        {
+            long numcpus = max(sysconf(_SC_NPROCESSORS_ONLN), 1L);
+            m_load_threads.resize(numcpus);
+            for (size_t i=0; i<m_load_threads.size(); i++)
+                pthread_create(&m_load_threads[i], NULL, runLoad, this);
+        }
+
+        istringstream placement("MotionTick: FIFO 40 []");      // as a sense-move thread at the NAO's priority
+        ThreadPlacement::load(placement);
+        ThreadPlacement::apply(pthread_self(), "MotionTick", 0);
+        int policy;
+        sched_param param;
+        pthread_getschedparam(pthread_self(), &policy, &param);
+        m_realtime = policy == SCHED_FIFO;
+
+        m_lateness.clear();
+        clock_gettime(CLOCK_MONOTONIC, &m_deadline);
+    }
+    void run()
+    {
+        m_deadline.tv_nsec += THREAD_SENSEMOVE_PERIOD*1000000L;
+        if (m_deadline.tv_nsec >= 1000000000L)
+        {
+            m_deadline.tv_sec++;
+            m_deadline.tv_nsec -= 1000000000L;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &m_deadline, NULL) != 0);
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        m_lateness.push_back(1e-3*(now.tv_sec - m_deadline.tv_sec)*1e9 + 1e-3*(now.tv_nsec - m_deadline.tv_nsec));
+    }
+    void tearDown()
+    {
+        // a short run, like ctest's, takes too few ticks for 1% of them to mean anything, so more are taken for the check
+        while (m_lateness.size() < MinCheckedTicks)
+            run();
+
+        sched_param param;
+        param.sched_priority = 0;
+        pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+        ThreadPlacement::clear();
+        m_stop = true;
+        for (size_t i=0; i<m_load_threads.size(); i++)
+            pthread_join(m_load_threads[i], NULL);
+
+        sort(m_lateness.begin(), m_lateness.end());
+        size_t numlate = m_lateness.end() - upper_bound(m_lateness.begin(), m_lateness.end(), 500.0*THREAD_SENSEMOVE_PERIOD);
+        addMetric("real-time", m_realtime, "");
+        addMetric("load threads", m_load_threads.size(), "");
+        addMetric("median lateness", percentile(m_lateness, 0.5), "us");
+        addMetric("p99 lateness", percentile(m_lateness, 0.99), "us");
+        addMetric("worst lateness", percentile(m_lateness, 1), "us");
+        addMetric("ticks", m_lateness.size(), "");
+        addMetric("late ticks", numlate, "");
+        // one tick in a hundred may be late, because a virtual machine's host can hold up even a real-time thread
+        if (m_realtime)
+            check(100*numlate <= m_lateness.size(), "no more than 1% of real-time ticks are more than half a period late");
+    }
+private:
+    static void* runLoad(void* arg)
+    {
+        MotionTickJitterBenchmark* benchmark = static_cast<MotionTickJitterBenchmark*>(arg);
+        double x = 1;
+        while (not benchmark->m_stop)
+            x = sqrt(x + 1);
+        benchmarkUse(x);
+        return NULL;
+    }
+private:
+    static const size_t MinCheckedTicks = 200;   //!< the fewest ticks the number of late ticks is checked over, so that 1% of them is two ticks
+    bool m_load;
+    bool m_realtime;
+    volatile bool m_stop;
+    vector<pthread_t> m_load_threads;
+    timespec m_deadline;
+    vector<double> m_lateness;              //!< the lateness of each tick in us
+};
+static MotionTickJitterBenchmark tickjitteridle("Threading", "MotionTickJitterIdle", false);
+static MotionTickJitterBenchmark tickjitterload("Threading", "MotionTickJitterUnderLoad", true);
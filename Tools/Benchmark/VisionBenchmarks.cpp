@@ -0,0 +1,898 @@
+/*! @file VisionBenchmarks.cpp
+    @brief Benchmarks of the colour lookup tables and of the projection of image points onto the ground
+
+    The lookup tables classify a synthetic 320x240 image of a field: mostly green, with white lines, an orange
+    ball, a yellow goal and a blue robot, and a little noise. The table classifies the same regions of colour
+    space. The ground projection uses the camera to ground transforms of the joints of the default recording, and projects
+    the points a frame of field objects and line points would give.
+
+    The image logger is given frames from a FileBufferRing, as it is given the camera's frames on the robot, with
+    the sensor data of the default recording. Its set up logs a few frames, destroys the logger, and reads the
+    streams back to check that every frame was written, in order, with its sensor data.
+
+    Vision processes a synthetic sequence in which the ball rolls in front of a yellow goal, either scanning every
+    frame or tracking the ball and goals between full scans. Its set up runs the sequence both ways, twice, the second
+    time seeking back to the start, and checks that tracking finds the same ball and goal posts.
+
+    The green border is found in the synthetic frames, and in frames of grass that gets patchier towards the top,
+    under horizons in, above, below and across the image. The set up checks that scanning the columns together finds
+    the same points as walking down each column did, at every green border density, and that the scan lines stay on
+    the scan line spacing however densely the border is searched.
+
+    The circle and ellipse fits are given noisy arcs of random circles and ellipses, of the sizes the ball and the
+    centre circle have in an image. The set up checks that the direct fits are as good as the fits they replaced, and
+    that points close to a line, for which there is no ellipse, do not give one.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.h"
+#include "BenchmarkPlatform.h"
+#include "SensorRecording.h"
+
+#include "Infrastructure/NUBlackboard.h"
+#include "Infrastructure/FieldObjects/FieldObjects.h"
+#include "Infrastructure/NUActionatorsData/NUActionatorsData.h"
+#include "Infrastructure/NUImage/NUImage.h"
+#include "Infrastructure/NUSensorsData/NUSensorsData.h"
+#include "NUPlatform/NUCamera/FileBufferRing.h"
+#include "Vision/Threads/ImageLoggerThread.h"
+#include "Vision/Vision.h"
+
+#include "Infrastructure/NUImage/Pixel.h"
+#include "Kinematics/Kinematics.h"
+#include "Tools/FileFormats/CompactLUT.h"
+#include "Tools/FileFormats/LUTTools.h"
+#include "Tools/Math/General.h"
+#include "Tools/Math/LSFittedLine.h"
+#include "Tools/Math/Matrix.h"
+#include "Vision/CameraRayTable.h"
+#include "Vision/CircleFitting.h"
+#include "Vision/ClassificationColours.h"
+#include "Vision/DirectFitting.h"
+#include "Vision/EllipseFit.h"
+
+#include <unistd.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+using namespace std;
+
+static const int ImageWidth = 320;
+static const int ImageHeight = 240;
+
+/*! @brief Returns a pixel with the given channels */
+static Pixel pixel(int y, int cb, int cr)
+{
+    Pixel p;
+    p.yCbCrPadding = 0;
+    p.y = max(0, min(255, y));
+    p.cb = max(0, min(255, cb));
+    p.cr = max(0, min(255, cr));
+    return p;
+}
+
+/*! @brief Returns the class of a colour, for the regions of colour space the synthetic image is made of */
+static unsigned char classifyColour(int y, int cb, int cr)
+{
+    if (y >= 40 and y < 140 and cb >= 80 and cb < 130 and cr >= 70 and cr < 120)
+        return ClassIndex::green;
+    else if (y >= 180 and cb >= 110 and cb < 150 and cr >= 110 and cr < 150)
+        return ClassIndex::white;
+    else if (cr >= 170 and cb < 110)
+        return ClassIndex::orange;
+    else if (y >= 120 and cb < 80 and cr >= 130 and cr < 170)
+        return ClassIndex::yellow;
+    else if (cb >= 160 and cr < 110)
+        return ClassIndex::blue;
+    else
+        return ClassIndex::unclassified;
+}
+
+/*! @brief The dense lookup table for the synthetic image's regions of colour space */
+static vector<unsigned char> denseTable()
+{
+    vector<unsigned char> table(LUTTools::LUT_SIZE);
+    for (int y=0; y<256; y+=2)
+        for (int cb=0; cb<256; cb+=2)
+            for (int cr=0; cr<256; cr+=2)
+                table[LUTTools::getLUTIndex(pixel(y, cb, cr))] = classifyColour(y, cb, cr);
+    return table;
+}
+
+/*! @brief A synthetic image of the field */
+static vector<Pixel> fieldImage()
+{
+    vector<Pixel> image(ImageWidth*ImageHeight);
+    unsigned int noise = 12345;
+    for (int row=0; row<ImageHeight; row++)
+    {
+        for (int col=0; col<ImageWidth; col++)
+        {
+            noise = 1103515245*noise + 12345;                       // a small linear congruential generator, so the image is the same every run
+            int n = static_cast<int>((noise >> 16) % 9) - 4;
+            int y = 90 + n, cb = 105 - n, cr = 95 + n;              // field green
+            if (row < 60)
+            {
+                if (col > 100 and col < 220)
+                    y = 160 + n, cb = 60, cr = 150;                 // the yellow goal
+                else
+                    y = 120 + 3*n, cb = 128 + 3*n, cr = 128 - 3*n;  // the background, which is not classified
+            }
+            else if (abs(row - 2*col/3 - 20) < 3 or abs(row - 150) < 2)
+                y = 200 + n, cb = 128, cr = 128;                    // the lines
+            else if ((col - 200)*(col - 200) + (row - 170)*(row - 170) < 100)
+                y = 110 + n, cb = 90, cr = 200 + n;                 // the ball
+            else if (col > 20 and col < 50 and row > 70 and row < 140)
+                y = 70 + n, cb = 180, cr = 90;                      // a blue robot
+            image[row*ImageWidth + col] = pixel(y, cb, cr);
+        }
+    }
+    return image;
+}
+
+/*! @brief The classification of every pixel of an image, with either the dense or the compact lookup table */
+class ClassifyImageBenchmark : public Benchmark
+{
+public:
+    ClassifyImageBenchmark(const string& group, const string& name, bool compact) : Benchmark(group, name), m_use_compact(compact) {}
+    void setUp()
+    {
+        m_dense = denseTable();
+        m_compact.build(&m_dense[0]);
+        m_image = fieldImage();
+        m_classified = vector<unsigned char>(m_image.size());
+    }
+    void run()
+    {
+        if (m_use_compact)
+        {
+            for (size_t i=0; i<m_image.size(); i++)
+                m_classified[i] = m_compact.classify(m_image[i]);
+        }
+        else
+        {
+            const unsigned char* table = &m_dense[0];
+            for (size_t i=0; i<m_image.size(); i++)
+                m_classified[i] = table[LUTTools::getLUTIndex(m_image[i])];
+        }
+        benchmarkUse(m_classified[m_image.size()/2]);
+    }
+    void tearDown()
+    {
+        int numgreen = 0;
+        for (size_t i=0; i<m_classified.size(); i++)
+        {
+            if (m_classified[i] == ClassIndex::green)
+                numgreen++;
+        }
+        addMetric("green", 100.0*numgreen/m_classified.size(), "%");
+        addMetric("table size", m_use_compact ? m_compact.getSize() : m_dense.size(), "bytes");
+        m_compact.clear();
+    }
+private:
+    bool m_use_compact;
+    vector<unsigned char> m_dense;
+    CompactLUT m_compact;
+    vector<Pixel> m_image;
+    vector<unsigned char> m_classified;
+};
+static ClassifyImageBenchmark classifydense("Vision", "ClassifyImageDenseLUT", false);
+static ClassifyImageBenchmark classifycompact("Vision", "ClassifyImageCompactLUT", true);
+
+/*! @brief Loading a lookup table from a file: the dense table is read, the compact table is memory mapped */
+class LoadLUTBenchmark : public Benchmark
+{
+public:
+    LoadLUTBenchmark(const string& group, const string& name, bool compact) : Benchmark(group, name), m_use_compact(compact) {}
+    void setUp()
+    {
+        char filename[64];
+        sprintf(filename, "/tmp/benchmark%d%s", getpid(), m_use_compact ? ".clut" : ".lut");
+        m_filename = filename;
+        m_dense = denseTable();
+        if (m_use_compact)
+        {
+            CompactLUT compact;
+            compact.build(&m_dense[0]);
+            compact.save(m_filename.c_str());
+            // Vision fills its dense table from the loaded compact table, because NUview and saving the table read it
+            CompactLUT loaded;
+            vector<unsigned char> dense(LUTTools::LUT_SIZE, 0);
+            check(loaded.load(m_filename.c_str()), "the compact table loads");
+            loaded.toDense(&dense[0]);
+            check(dense == m_dense, "the dense table filled from the loaded compact table is the original table");
+        }
+        else
+            LUTTools::SaveLUT(&m_dense[0], m_dense.size(), m_filename.c_str());
+    }
+    void run()
+    {
+        if (m_use_compact)
+        {
+            CompactLUT compact;
+            compact.load(m_filename.c_str());
+            benchmarkUse(compact.classify(pixel(90, 105, 95)));
+        }
+        else
+        {
+            LUTTools::LoadLUT(&m_dense[0], m_dense.size(), m_filename.c_str());
+            benchmarkUse(m_dense[LUTTools::getLUTIndex(pixel(90, 105, 95))]);
+        }
+    }
+    void tearDown()
+    {
+        unlink(m_filename.c_str());
+    }
+private:
+    bool m_use_compact;
+    string m_filename;
+    vector<unsigned char> m_dense;
+};
+static LoadLUTBenchmark loaddense("Vision", "LoadDenseLUT", false);
+static LoadLUTBenchmark loadcompact("Vision", "LoadCompactLUT", true);
+
+/*! @brief The projection of a frame's image points onto the ground, either with the kinematics as Vision used to, or with the CameraRayTable */
+class GroundProjectionBenchmark : public Benchmark
+{
+public:
+    GroundProjectionBenchmark(const string& group, const string& name, bool table) : Benchmark(group, name), m_use_table(table) {}
+    void setUp()
+    {
+        // the transforms are calculated as NUSensors::calculateKinematics does, with the left foot as the support
+        const SensorRecording& recording = SensorRecording::getDefault();
+        Kinematics kinematics;
+        kinematics.LoadModel();
+        m_transforms.clear();
+        for (unsigned int i=0; i<recording.size(); i++)
+        {
+            const vector<float>& p = recording[i].Positions;
+            Matrix support = kinematics.CalculateTransform(Kinematics::leftFoot, vector<float>(p.begin() + 10, p.begin() + 16));
+            Matrix camera = kinematics.CalculateTransform(Kinematics::bottomCamera, vector<float>(p.begin(), p.begin() + 2));
+            m_transforms.push_back(Kinematics::CalculateCamera2GroundTransform(support, camera).asVector());
+        }
+
+        m_x.clear();
+        m_y.clear();
+        for (int row=ImageHeight/4; row<ImageHeight; row+=ImageHeight/8)
+        {
+            for (int col=ImageWidth/16; col<ImageWidth; col+=ImageWidth/8)
+            {
+                m_x.push_back(col);
+                m_y.push_back(row);
+            }
+        }
+        m_results = vector<Vector3<float> >(m_x.size());
+        m_table.setCalibration(ImageWidth, ImageHeight, mathGeneral::deg2rad(45.0f), mathGeneral::deg2rad(34.80f));
+        m_frame = 0;
+    }
+    void run()
+    {
+        const vector<float>& transform = m_transforms[m_frame];
+        if (m_use_table)
+        {
+            m_table.setCameraToGroundTransform(transform);
+            m_table.projectToGround(&m_x[0], &m_y[0], m_x.size(), &m_results[0]);
+        }
+        else
+        {   // as Vision::CalculateBearing, Vision::CalculateElevation and Kinematics::DistanceToPoint did for each point
+            double fovx = mathGeneral::deg2rad(45.0f);
+            double fovy = mathGeneral::deg2rad(34.80f);
+            for (size_t i=0; i<m_x.size(); i++)
+            {
+                Matrix camera2ground = Matrix4x4fromVector(transform);
+                double bearing = atan((ImageWidth/2 - m_x[i])/((ImageWidth/2)/tan(fovx/2.0)));
+                double elevation = atan((ImageHeight/2 - m_y[i])/((ImageHeight/2)/tan(fovy/2.0)));
+                m_results[i] = Kinematics::DistanceToPoint(camera2ground, bearing, elevation);
+            }
+        }
+        benchmarkUse(m_results[0].x);
+        m_frame = (m_frame + 1) % m_transforms.size();
+    }
+    void tearDown()
+    {
+        addMetric("points", m_x.size(), "per frame");
+        m_frame = 0;                        // the first frame is projected again so that both methods report the same point
+        run();
+        addMetric("distance to first point", m_results[0].x, "cm");
+    }
+private:
+    bool m_use_table;
+    vector<vector<float> > m_transforms;
+    vector<double> m_x, m_y;
+    vector<Vector3<float> > m_results;
+    CameraRayTable m_table;
+    size_t m_frame;
+};
+static GroundProjectionBenchmark projectkinematics("Vision", "GroundProjectionKinematics", false);
+static GroundProjectionBenchmark projecttable("Vision", "GroundProjectionRayTable", true);
+
+
+/*! @brief Queueing a camera frame and the sensor data to be logged, which is all the vision thread does to save an image.
+           The same frame is logged every time, so the disk is not read while the logger is writing. */
+class ImageLoggerBenchmark : public Benchmark
+{
+public:
+    ImageLoggerBenchmark(const string& group, const string& name) : Benchmark(group, name), m_ring(0), m_logger(0) {}
+    void setUp()
+    {
+        char prefix[64];
+        sprintf(prefix, "/tmp/benchmark%d", getpid());
+        m_frames_filename = string(prefix) + "frames.yuv";
+        m_image_filename = string(prefix) + "image.strm";
+        m_sensor_filename = string(prefix) + "sensor.strm";
+        vector<char> frame(FrameWidth*FrameHeight*2);
+        ofstream file(m_frames_filename.c_str(), ios_base::out | ios_base::binary);
+        for (int i=0; i<NumTestFrames; i++)
+        {
+            frame.assign(frame.size(), static_cast<char>(i + 1));
+            file.write(&frame[0], frame.size());
+        }
+        file.close();
+        m_ring = new FileBufferRing(m_frames_filename, FrameWidth, FrameHeight, NumBuffers);
+
+        m_platform = dynamic_cast<BenchmarkPlatform*>(Platform);
+        m_platform->replay(&SensorRecording::getDefault());
+        checkLogged();
+
+        m_logger = new ImageLoggerThread(m_image_filename, m_sensor_filename, QueueSize, ImageLoggerThread::DropOldest);
+        m_frame = m_ring->acquire();
+    }
+    void run()
+    {
+        m_logger->log(m_frame.image(), Blackboard->Sensors);
+    }
+    void tearDown()
+    {
+        addMetric("frames logged", m_logger->getFramesLogged(), "");
+        addMetric("frames dropped", m_logger->getFramesDropped(), "");
+        m_frame.release();
+        delete m_logger;
+        m_logger = 0;
+        delete m_ring;
+        m_ring = 0;
+        m_platform->replay(NULL);
+        unlink(m_frames_filename.c_str());
+        unlink(m_image_filename.c_str());
+        unlink(m_sensor_filename.c_str());
+    }
+private:
+    /*! @brief Logs a few frames, destroys the logger, and checks that every frame and its sensor data were written in order */
+    void checkLogged()
+    {
+        vector<double> times;
+        ImageLoggerThread* logger = new ImageLoggerThread(m_image_filename, m_sensor_filename, NumTestFrames, ImageLoggerThread::DropNewest);
+        for (int i=0; i<NumTestFrames; i++)
+        {
+            m_platform->tick();
+            CameraFrame frame = m_ring->acquire();
+            logger->log(frame.image(), Blackboard->Sensors);
+            times.push_back(Blackboard->Sensors->GetTimestamp());
+        }
+        delete logger;
+        check(m_ring->available() == NumBuffers, "the logger releases every camera frame");
+
+        ifstream images(m_image_filename.c_str(), ios_base::in | ios_base::binary);
+        ifstream sensors(m_sensor_filename.c_str(), ios_base::in | ios_base::binary);
+        NUImage image;
+        NUSensorsData data;
+        bool inorder = true;
+        for (int i=0; i<NumTestFrames and images.good() and sensors.good(); i++)
+        {
+            images >> image;
+            sensors >> data;
+            inorder = inorder and image.getWidth() == FrameWidth/2 and image.m_image[0][0].y == i + 1 and data.GetTimestamp() == times[i];
+        }
+        images.peek();
+        check(inorder and images.eof(), "every frame is written, in order, with its sensor data, when the logger is destroyed");
+    }
+private:
+    static const int FrameWidth = 640;          //!< the width of the NAO's camera frames
+    static const int FrameHeight = 480;         //!< the height of the NAO's camera frames
+    static const int NumTestFrames = 6;         //!< the number of frames logged and read back by the set up
+    static const unsigned int QueueSize = 8;    //!< the size of the logger's queue, as in Vision
+    static const int NumBuffers = 12;           //!< the number of buffers in the ring, more than the logger can hold
+    string m_frames_filename;
+    string m_image_filename;
+    string m_sensor_filename;
+    BenchmarkPlatform* m_platform;
+    FileBufferRing* m_ring;
+    CameraFrame m_frame;
+    ImageLoggerThread* m_logger;
+};
+static ImageLoggerBenchmark imagelogger("Vision", "ImageLoggerLog");
+
+
+/*! @brief A synthetic frame of a sequence in which the ball rolls across the field in front of a yellow goal */
+static vector<Pixel> trackingImage(int frame)
+{
+    vector<Pixel> image(ImageWidth*ImageHeight);
+    unsigned int noise = 12345 + frame;
+    int ballx = 60 + 6*frame;
+    int bally = 170 - frame;
+    for (int row=0; row<ImageHeight; row++)
+    {
+        for (int col=0; col<ImageWidth; col++)
+        {
+            noise = 1103515245*noise + 12345;
+            int n = static_cast<int>((noise >> 16) % 9) - 4;
+            int y = 90 + n, cb = 105 - n, cr = 95 + n;              // field green
+            if ((col > 70 and col < 82 and row < 110) or (col > 240 and col < 252 and row < 110))
+                y = 160 + n, cb = 60, cr = 150;                     // the yellow goal posts
+            else if (row < 100)
+                y = 120 + 3*n, cb = 128 + 3*n, cr = 128 - 3*n;      // the background, which is not classified
+            else if (abs(row - 130) < 2)
+                y = 200 + n, cb = 128, cr = 128;                    // the goal line
+            else if ((col - ballx)*(col - ballx) + (row - bally)*(row - bally) < 100)
+                y = 110 + n, cb = 90, cr = 200 + n;                 // the ball
+            image[row*ImageWidth + col] = pixel(y, cb, cr);
+        }
+    }
+    return image;
+}
+
+/*! @brief Processing a frame of a sequence in which the ball rolls in front of a goal, with and without tracking the ball and goals.
+           The set up checks that tracking finds the same ball and goal posts as scanning every frame. */
+class ProcessFrameBenchmark : public Benchmark
+{
+public:
+    ProcessFrameBenchmark(const string& group, const string& name, int fullscanperiod) : Benchmark(group, name), m_full_scan_period(fullscanperiod), m_vision(0) {}
+    void setUp()
+    {
+        m_platform = dynamic_cast<BenchmarkPlatform*>(Platform);
+        m_platform->replay(&SensorRecording::getDefault());
+        m_platform->tick();
+        m_platform->replay(NULL);
+        m_dense = denseTable();
+        m_frames.clear();
+        for (int i=0; i<NumFrames; i++)
+            m_frames.push_back(trackingImage(i));
+
+        // the horizon is put where the field meets the background. There is no camera to ground transform, so the
+        // ball's distance is not compared with the distance to the point it is on, which the synthetic frames do not fit
+        m_sensors = *Blackboard->Sensors;
+        const vector<float>& p = SensorRecording::getDefault()[0].Positions;
+        Kinematics kinematics;
+        kinematics.LoadModel();
+        m_sensors.set(NUSensorsData::CameraTransform, 0, kinematics.CalculateTransform(Kinematics::bottomCamera, vector<float>(p.begin(), p.begin() + 2)).asVector());
+        m_sensors.setAsInvalid(NUSensorsData::CameraToGroundTransform);
+        vector<float> horizon(3);
+        horizon[0] = 0;
+        horizon[1] = 1;
+        horizon[2] = HorizonRow;
+        m_sensors.set(NUSensorsData::Horizon, 0, horizon);
+
+        if (m_full_scan_period > 1)
+            checkAgreement();
+
+        m_vision = new Vision();
+        m_vision->setLUT(&m_dense[0]);
+        m_vision->setROITracking(m_full_scan_period);
+        m_frame = 0;
+    }
+    void run()
+    {
+        m_image.MapBufferToImage(&m_frames[m_frame % NumFrames][0], ImageWidth, ImageHeight);
+        m_image.m_timestamp = FramePeriod*m_frame;
+        m_vision->ProcessFrame(&m_image, &m_sensors, &m_actions, &m_objects);
+        benchmarkUse(m_objects.mobileFieldObjects[FieldObjects::FO_BALL].ScreenX());
+        m_frame++;
+    }
+    void tearDown()
+    {
+        int numtracked = m_vision->getNumTrackedFrames();
+        int numfull = m_vision->getNumFullFrames();
+        addMetric("tracked frames", 100.0*numtracked/max(numtracked + numfull, 1), "%");
+        delete m_vision;
+        m_vision = 0;
+    }
+private:
+    /*! @brief Processes the sequence twice, with and without tracking, and checks that the same ball and goal posts are found.
+               The second time through starts at the first frame's timestamp again, as when NUview seeks back in a log. */
+    void checkAgreement()
+    {
+        Vision full, tracked;
+        full.setLUT(&m_dense[0]);
+        tracked.setLUT(&m_dense[0]);
+        tracked.setROITracking(m_full_scan_period);
+        FieldObjects fullobjects, trackedobjects;
+        NUImage image;
+        bool ballagrees = true;
+        bool postsagree = true;
+        for (int i=0; i<2*NumFrames; i++)
+        {
+            image.MapBufferToImage(&m_frames[i % NumFrames][0], ImageWidth, ImageHeight);
+            image.m_timestamp = FramePeriod*(i % NumFrames);
+            full.ProcessFrame(&image, &m_sensors, &m_actions, &fullobjects);
+            tracked.ProcessFrame(&image, &m_sensors, &m_actions, &trackedobjects);
+
+            const Object& fullball = fullobjects.mobileFieldObjects[FieldObjects::FO_BALL];
+            const Object& trackedball = trackedobjects.mobileFieldObjects[FieldObjects::FO_BALL];
+            ballagrees = ballagrees and fullball.isObjectVisible() and trackedball.isObjectVisible();
+            ballagrees = ballagrees and abs(fullball.ScreenX() - trackedball.ScreenX()) <= 2 and abs(fullball.ScreenY() - trackedball.ScreenY()) <= 2;
+            for (int j=FieldObjects::FO_BLUE_LEFT_GOALPOST; j<=FieldObjects::FO_YELLOW_RIGHT_GOALPOST; j++)
+                postsagree = postsagree and fullobjects.stationaryFieldObjects[j].isObjectVisible() == trackedobjects.stationaryFieldObjects[j].isObjectVisible();
+            postsagree = postsagree and fullobjects.ambiguousFieldObjects.size() == trackedobjects.ambiguousFieldObjects.size();
+        }
+        check(ballagrees, "tracking finds the ball within two pixels of where scanning every frame does");
+        check(postsagree, "tracking finds the same goal posts as scanning every frame");
+        check(tracked.getNumTrackedFrames() > 0, "the ball and goals are tracked when tracking is turned on");
+        check(full.getNumTrackedFrames() == 0, "nothing is tracked when tracking is off");
+    }
+private:
+    static const int NumFrames = 20;            //!< the number of frames in the sequence
+    static const int HorizonRow = 100;          //!< the row of the image the horizon is on
+    static const double FramePeriod;            //!< the time between frames in ms
+    int m_full_scan_period;
+    BenchmarkPlatform* m_platform;
+    vector<unsigned char> m_dense;
+    vector<vector<Pixel> > m_frames;
+    NUSensorsData m_sensors;
+    NUActionatorsData m_actions;
+    FieldObjects m_objects;
+    NUImage m_image;
+    Vision* m_vision;
+    int m_frame;
+};
+const double ProcessFrameBenchmark::FramePeriod = 33;
+static ProcessFrameBenchmark processfull("Vision", "ProcessFrameFull", 0);
+static ProcessFrameBenchmark processtracked("Vision", "ProcessFrameTracked", 5);
+
+
+/*! @brief A synthetic frame of grass that gets patchier towards the top, so the green border is at a different row in every column */
+static vector<Pixel> patchyImage(unsigned int seed)
+{
+    vector<Pixel> image(ImageWidth*ImageHeight);
+    unsigned int noise = seed;
+    for (int row=0; row<ImageHeight; row++)
+    {
+        for (int col=0; col<ImageWidth; col++)
+        {
+            noise = 1103515245*noise + 12345;
+            int n = static_cast<int>((noise >> 16) % 9) - 4;
+            if (static_cast<int>((noise >> 8) % 100) < 20 + 85*row/ImageHeight)
+                image[row*ImageWidth + col] = pixel(90 + n, 105 - n, 95 + n);
+            else
+                image[row*ImageWidth + col] = pixel(200 + n, 128, 128);
+        }
+    }
+    return image;
+}
+
+/*! @brief Finds the green border in each column by walking down it, as Vision did before it scanned all of the columns together */
+static vector<Vector2<int> > findGreenBorderPointsByColumn(Vision& vision, int width, int height, int scanSpacing, const Horizon& horizon)
+{
+    vector<Vector2<int> > results;
+    for (int x = 0; x < width; x += scanSpacing)
+    {
+        int ystart = static_cast<int>(horizon.findYFromX(x));
+        if (ystart >= height)
+            continue;
+        ystart = max(ystart, 0);
+        int consecutive = 0;
+        for (int y = ystart; y < height; y++)
+        {
+            if (vision.classifyPixel(x, y) == ClassIndex::green)
+                consecutive++;
+            else
+                consecutive = 0;
+            if (consecutive >= 10)
+            {
+                results.push_back(Vector2<int>(x, y - consecutive + 1));
+                break;
+            }
+        }
+    }
+    return results;
+}
+
+/*! @brief Finding the top of the field in each scan line column, either by scanning the columns together one row at a time,
+           as Vision does, or by walking down each column in turn. The set up checks that both find the same points. */
+class GreenBorderBenchmark : public Benchmark
+{
+public:
+    GreenBorderBenchmark(const string& group, const string& name, bool bycolumn) : Benchmark(group, name), m_by_column(bycolumn), m_vision(0) {}
+    void setUp()
+    {
+        m_dense = denseTable();
+        m_vision = new Vision();
+        m_vision->setLUT(&m_dense[0]);
+        m_frames.clear();
+        m_frames.push_back(fieldImage());
+        for (int i=0; i<NumFrames; i++)
+            m_frames.push_back(trackingImage(i));
+        for (int i=0; i<NumFrames; i++)
+            m_frames.push_back(patchyImage(i + 1));
+
+        // flat horizons above, in and below the image, and sloped ones that cross the top and bottom of the image
+        m_horizons.clear();
+        const double horizons[][3] = {{0, 1, -10}, {0, 1, 0}, {0, 1, 60}, {0, 1, 100}, {0, 1, 239}, {0, 1, 300}, {0.3, 1, 80}, {-0.5, 1, 150}, {1.5, 1, 200}};
+        for (size_t i=0; i<sizeof(horizons)/sizeof(horizons[0]); i++)
+        {
+            Horizon horizon;
+            horizon.setLine(horizons[i][0], horizons[i][1], horizons[i][2]);
+            m_horizons.push_back(horizon);
+        }
+        if (not m_by_column)
+            checkSamePoints();
+        m_frame = 0;
+    }
+    void run()
+    {
+        m_image.MapBufferToImage(&m_frames[m_frame % m_frames.size()][0], ImageWidth, ImageHeight);
+        m_vision->setImage(&m_image);
+        Horizon& horizon = m_horizons[3];
+        FrameArena::Scope scope(m_arena);       // as in Vision::ProcessFrame
+        if (m_by_column)
+            m_points = findGreenBorderPointsByColumn(*m_vision, ImageWidth, ImageHeight, ScanSpacing, horizon);
+        else
+            m_points = m_vision->findGreenBorderPoints(ScanSpacing, &horizon);
+        benchmarkUse(m_points.size());
+        m_frame++;
+    }
+    void tearDown()
+    {
+        addMetric("border points", m_points.size(), "in the last frame");
+        delete m_vision;
+        m_vision = 0;
+    }
+private:
+    /*! @brief Checks that both ways of scanning find the same points, in every frame, under every horizon, at each green border density.
+        Also checks that the interpolated border, which places the scan lines, is at every multiple of ScanSpacing whatever the density.
+     */
+    void checkSamePoints()
+    {
+        bool same = true;
+        bool ongrid = true;
+        for (size_t i=0; i<m_frames.size(); i++)
+        {
+            m_image.MapBufferToImage(&m_frames[i][0], ImageWidth, ImageHeight);
+            m_vision->setImage(&m_image);
+            for (size_t j=0; j<m_horizons.size(); j++)
+            {
+                for (int density=1; density<=ScanSpacing; density*=2)
+                {
+                    m_vision->setGreenBorderDensity(density);
+                    int spacing = m_vision->getGreenBorderSpacing(ScanSpacing);
+                    vector<Vector2<int> > points = m_vision->findGreenBorderPoints(spacing, &m_horizons[j]);
+                    same = same and points == findGreenBorderPointsByColumn(*m_vision, ImageWidth, ImageHeight, spacing, m_horizons[j]);
+
+                    // the border is also interpolated without its first point, as when there is no green at the left edge of the image
+                    for (size_t first=0; first<2 and first<points.size(); first++)
+                    {
+                        vector<Vector2<int> > border(points.begin() + first, points.end());
+                        vector<Vector2<int> > scanpoints = m_vision->interpolateBorders(m_vision->getConvexFieldBorders(border), ScanSpacing);
+                        for (size_t k=0; k<scanpoints.size(); k++)
+                            ongrid = ongrid and scanpoints[k].x % ScanSpacing == 0 and (k == 0 or scanpoints[k].x - scanpoints[k-1].x == ScanSpacing);
+                    }
+                }
+            }
+        }
+        m_vision->setGreenBorderDensity(1);
+        check(same, "scanning the columns together finds the same border points as walking down each column");
+        check(ongrid, "the scan lines are ScanSpacing apart at every green border density");
+    }
+private:
+    static const int NumFrames = 20;            //!< the number of frames of each synthetic sequence
+    static const int ScanSpacing = 16;          //!< the distance between the columns in pixels, which is spacings for a 320 pixel wide image
+    bool m_by_column;
+    Vision* m_vision;
+    vector<unsigned char> m_dense;
+    vector<vector<Pixel> > m_frames;
+    vector<Horizon> m_horizons;
+    NUImage m_image;
+    FrameArena m_arena;
+    vector<Vector2<int> > m_points;
+    size_t m_frame;
+};
+static GreenBorderBenchmark greenborderrows("Vision", "GreenBorderRows", false);
+static GreenBorderBenchmark greenbordercolumns("Vision", "GreenBorderColumns", true);
+
+
+static const int NumArcPoints = 20;             //!< the number of points on each arc
+
+/*! @brief A noisy arc of a circle or ellipse, as the ball's edge points or the centre circle's line points are */
+struct Arc
+{
+    vector<Vector2<int> > pixels;           //!< the points rounded to pixels, as the ball's edge points are
+    vector<double> x, y;                    //!< the points
+    double cx, cy;                          //!< the centre of the ellipse the points are on
+};
+
+/*! @brief Returns arcs of random circles (r1 == r2) or ellipses, each covering between a quarter and all of the way around */
+static vector<Arc> randomArcs(int numarcs, bool circles)
+{
+    vector<Arc> arcs(numarcs);
+    unsigned int noise = 4321;
+    for (int i=0; i<numarcs; i++)
+    {
+        Arc& arc = arcs[i];
+        noise = 1103515245*noise + 12345;
+        arc.cx = 50 + (noise >> 16) % 220;
+        noise = 1103515245*noise + 12345;
+        arc.cy = 50 + (noise >> 16) % 140;
+        noise = 1103515245*noise + 12345;
+        double r1 = circles ? 10 + (noise >> 16) % 30 : 30 + (noise >> 16) % 50;
+        noise = 1103515245*noise + 12345;
+        double r2 = circles ? r1 : 0.4*r1 + 0.6*r1*((noise >> 16) % 100)/100.0;
+        noise = 1103515245*noise + 12345;
+        double theta = circles ? 0 : M_PI*((noise >> 16) % 180)/180.0;
+        noise = 1103515245*noise + 12345;
+        double span = circles ? 0.5*M_PI + 1.5*M_PI*((noise >> 16) % 100)/100.0 : M_PI + M_PI*((noise >> 16) % 100)/100.0;
+        for (int j=0; j<NumArcPoints; j++)
+        {
+            noise = 1103515245*noise + 12345;
+            double e = static_cast<double>((noise >> 16) % 101)/100.0 - 0.5;     // half a pixel of noise either way
+            double t = span*j/NumArcPoints;
+            double ex = (r1 + e)*cos(t);
+            double ey = (r2 + e)*sin(t);
+            arc.x.push_back(arc.cx + ex*cos(theta) - ey*sin(theta));
+            arc.y.push_back(arc.cy + ex*sin(theta) + ey*cos(theta));
+            arc.pixels.push_back(Vector2<int>(static_cast<int>(floor(arc.x.back() + 0.5)), static_cast<int>(floor(arc.y.back() + 0.5))));
+        }
+    }
+    return arcs;
+}
+
+/*! @brief Returns the rms distance of the points from a circle */
+static double circleResidual(const vector<Vector2<int> >& points, const Circle& circle)
+{
+    double sum = 0;
+    for (size_t i=0; i<points.size(); i++)
+    {
+        double d = sqrt((points[i].x - circle.centreX)*(points[i].x - circle.centreX) + (points[i].y - circle.centreY)*(points[i].y - circle.centreY)) - circle.radius;
+        sum += d*d;
+    }
+    return sqrt(sum/points.size());
+}
+
+/*! @brief Fitting a circle to the ball's edge points, or an ellipse to the centre circle's line points, with the direct
+           fits or with the fits they replaced (CircleFitting's FitCircleLMF, and EllipseFit's JAMA eigen solver) */
+class FittingBenchmark : public Benchmark
+{
+public:
+    enum Method
+    {
+        CircleLMF,
+        CircleDirect,
+        EllipseJama,
+        EllipseDirect
+    };
+    FittingBenchmark(const string& group, const string& name, Method method) : Benchmark(group, name), m_method(method) {}
+    void setUp()
+    {
+        bool circles = m_method == CircleLMF or m_method == CircleDirect;
+        m_arcs = randomArcs(NumArcs, circles);
+        m_points.resize(NumArcs);
+        for (int i=0; i<NumArcs; i++)
+            m_points[i] = linePoints(m_arcs[i].x, m_arcs[i].y);
+        if (m_method == CircleDirect)
+            checkCircles();
+        else if (m_method == EllipseDirect)
+            checkEllipses();
+        m_arc = 0;
+    }
+    void run()
+    {
+        const Arc& arc = m_arcs[m_arc];
+        if (m_method == CircleLMF)
+            benchmarkUse(m_circle_fitter.FitCircleLMF(arc.pixels).centreX);
+        else if (m_method == CircleDirect)
+            benchmarkUse(DirectCircleFit(0.5).fit(arc.pixels).centreX);     // as Ball::isCorrectFit
+        else if (m_method == EllipseJama)
+        {
+            EllipseFit fitter;
+            fitter.Fit_Ellipse(m_points[m_arc]);
+            benchmarkUse(fitter.GetX());
+        }
+        else
+            benchmarkUse(DirectEllipseFit().fit(m_points[m_arc]).centreX);  // as LineDetection::DecodeCorners
+        m_arc = (m_arc + 1) % NumArcs;
+    }
+    void tearDown()
+    {
+        addMetric("points", NumArcPoints, "per fit");
+        for (size_t i=0; i<m_points.size(); i++)
+            freeLinePoints(m_points[i]);
+        m_points.clear();
+    }
+private:
+    /*! @brief Checks that the direct circle fit is never further from the points than FitCircleLMF */
+    void checkCircles()
+    {
+        bool asgood = true;
+        double worst = 0;
+        for (int i=0; i<NumArcs; i++)
+        {
+            Circle lmf = m_circle_fitter.FitCircleLMF(m_arcs[i].pixels);
+            Circle direct = DirectCircleFit(0.5).fit(m_arcs[i].pixels);
+            asgood = asgood and direct.isDefined;
+            if (lmf.isDefined and direct.isDefined)
+            {
+                double difference = circleResidual(m_arcs[i].pixels, direct) - circleResidual(m_arcs[i].pixels, lmf);
+                asgood = asgood and difference <= 0.5;      // the direct fit stops refining at half a pixel
+                worst = max(worst, difference);
+            }
+        }
+        check(asgood, "the direct circle fit is within its half pixel threshold of FitCircleLMF on every arc");
+        addMetric("worst residual over FitCircleLMF", worst, "pixels");
+    }
+
+    /*! @brief Checks that the direct ellipse fit finds the same centre as EllipseFit, and that points not on an ellipse give none */
+    void checkEllipses()
+    {
+        bool same = true;
+        double worst = 0;
+        for (int i=0; i<NumArcs; i++)
+        {
+            EllipseFit jama;
+            jama.Fit_Ellipse(m_points[i]);
+            Ellipse direct = DirectEllipseFit().fit(m_points[i]);
+            double distance = sqrt((direct.centreX - jama.GetX())*(direct.centreX - jama.GetX()) + (direct.centreY - jama.GetY())*(direct.centreY - jama.GetY()));
+            same = same and direct.isDefined and distance < 0.2;
+            worst = max(worst, distance);
+        }
+        check(same, "the direct ellipse fit finds the centre EllipseFit does, to within 0.2 pixels");
+        addMetric("worst centre difference", worst, "pixels");
+
+        // for points close to a line no eigenvector meets the ellipse constraint, and the fit must say so rather than use an unset conic
+        const double nearlyline[][5][2] = {{{0, 1}, {1, 2}, {2, 4}, {3, 7}, {4, 8}}, {{0, 0}, {1, 3}, {2, 4}, {3, 6}, {4, 8}}};
+        bool none = true;
+        for (int i=0; i<2; i++)
+        {
+            double x[5], y[5];
+            for (int j=0; j<5; j++)
+            {
+                x[j] = nearlyline[i][j][0];
+                y[j] = nearlyline[i][j][1];
+            }
+            none = none and not DirectEllipseFit().fit(x, y, 5).isDefined;
+        }
+        check(none, "points close to a line do not give an ellipse");
+    }
+
+    static vector<LinePoint*> linePoints(const vector<double>& x, const vector<double>& y)
+    {
+        vector<LinePoint*> points;
+        for (size_t i=0; i<x.size(); i++)
+        {
+            points.push_back(new LinePoint());
+            points.back()->x = x[i];
+            points.back()->y = y[i];
+        }
+        return points;
+    }
+    static void freeLinePoints(vector<LinePoint*>& points)
+    {
+        for (size_t i=0; i<points.size(); i++)
+            delete points[i];
+        points.clear();
+    }
+private:
+    static const int NumArcs = 200;             //!< the number of arcs fitted
+    Method m_method;
+    vector<Arc> m_arcs;
+    vector<vector<LinePoint*> > m_points;
+    CircleFitting m_circle_fitter;
+    int m_arc;
+};
+static FittingBenchmark fitcirclelmf("Vision", "FitCircleLMF", FittingBenchmark::CircleLMF);
+static FittingBenchmark fitcircledirect("Vision", "FitCircleDirect", FittingBenchmark::CircleDirect);
+static FittingBenchmark fitellipsejama("Vision", "FitEllipseJama", FittingBenchmark::EllipseJama);
+static FittingBenchmark fitellipsedirect("Vision", "FitEllipseDirect", FittingBenchmark::EllipseDirect);
@@ -0,0 +1,202 @@
+#include "CompactLUT.h"
+
+#include <cstring>
+#include <fstream>
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+using namespace std;
+
+static const char COMPACT_LUT_MAGIC[8] = {'N','U','C','L','U','T','0','1'};     //!< the first eight bytes of a compact lut file
+static const unsigned int COMPACT_LUT_HEADER_SIZE = 16;                          //!< magic, number of stored blocks and padding
+
+CompactLUT::CompactLUT() : m_index(0), m_blocks(0), m_num_stored_blocks(0), m_memory(0), m_mapping(0), m_mapping_length(0)
+{
+}
+
+CompactLUT::~CompactLUT()
+{
+    clear();
+}
+
+/*! @brief Releases the current table */
+void CompactLUT::clear()
+{
+    delete [] m_memory;
+    m_memory = 0;
+    #ifndef _WIN32
+        if (m_mapping)
+            munmap(m_mapping, m_mapping_length);
+    #endif
+    m_mapping = 0;
+    m_mapping_length = 0;
+    m_index = 0;
+    m_blocks = 0;
+    m_num_stored_blocks = 0;
+}
+
+/*! @brief Returns the index into the dense table of the given entry of the given block */
+unsigned int CompactLUT::getDenseIndex(int block, int offset)
+{
+    int y = ((block >> 8) << BLOCK_BITS) + (offset >> 6);
+    int cb = (((block >> 4) & 15) << BLOCK_BITS) + ((offset >> 3) & 7);
+    int cr = ((block & 15) << BLOCK_BITS) + (offset & 7);
+    return (y << 14) + (cb << 7) + cr;
+}
+
+/*!
+  @brief Builds the compact table from a dense table.
+  @param dense the dense table, LUTTools::LUT_SIZE bytes
+  @return true if the table was built
+  */
+bool CompactLUT::build(const unsigned char* dense)
+{
+    clear();
+    if (dense == 0)
+        return false;
+
+    // find the uniform blocks first, so that the memory can be allocated in one go
+    unsigned short* index = new unsigned short[NUM_BLOCKS];
+    int numstored = 0;
+    for (int b = 0; b < NUM_BLOCKS; b++)
+    {
+        unsigned char first = dense[getDenseIndex(b, 0)];
+        bool uniform = true;
+        for (int o = 1; o < BLOCK_SIZE and uniform; o++)
+            uniform = dense[getDenseIndex(b, o)] == first;
+        if (uniform)
+            index[b] = UNIFORM_BLOCK | first;
+        else
+            index[b] = numstored++;
+    }
+
+    m_memory = new unsigned char[NUM_BLOCKS*sizeof(unsigned short) + numstored*BLOCK_SIZE];
+    memcpy(m_memory, index, NUM_BLOCKS*sizeof(unsigned short));
+    delete [] index;
+    m_index = reinterpret_cast<unsigned short*>(m_memory);
+    unsigned char* blocks = m_memory + NUM_BLOCKS*sizeof(unsigned short);
+    m_blocks = blocks;
+    m_num_stored_blocks = numstored;
+
+    for (int b = 0; b < NUM_BLOCKS; b++)
+    {
+        if (not (m_index[b] & UNIFORM_BLOCK))
+        {
+            unsigned char* block = blocks + m_index[b]*BLOCK_SIZE;
+            for (int o = 0; o < BLOCK_SIZE; o++)
+                block[o] = dense[getDenseIndex(b, o)];
+        }
+    }
+    return true;
+}
+
+/*!
+  @brief Loads a compact table from a file. Where possible the file is memory mapped rather than read.
+  @param filename the name of the file
+  @return true if the file was a valid compact table
+  */
+bool CompactLUT::load(const char* filename)
+{
+    clear();
+    #ifndef _WIN32
+        int fd = open(filename, O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 or info.st_size < static_cast<off_t>(COMPACT_LUT_HEADER_SIZE + NUM_BLOCKS*sizeof(unsigned short)))
+        {
+            close(fd);
+            return false;
+        }
+        void* mapping = mmap(0, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED)
+            return false;
+        m_mapping = mapping;
+        m_mapping_length = info.st_size;
+        const unsigned char* data = static_cast<const unsigned char*>(mapping);
+    #else
+        ifstream file(filename, ios::in | ios::binary);
+        if (not file.is_open())
+            return false;
+        file.seekg(0, ios::end);
+        unsigned int length = file.tellg();
+        file.seekg(0, ios::beg);
+        if (length < COMPACT_LUT_HEADER_SIZE + NUM_BLOCKS*sizeof(unsigned short))
+            return false;
+        m_memory = new unsigned char[length];
+        file.read(reinterpret_cast<char*>(m_memory), length);
+        m_mapping_length = length;
+        const unsigned char* data = m_memory;
+    #endif
+
+    int numstored;
+    memcpy(&numstored, data + sizeof(COMPACT_LUT_MAGIC), sizeof(numstored));
+    if (memcmp(data, COMPACT_LUT_MAGIC, sizeof(COMPACT_LUT_MAGIC)) != 0 or numstored < 0 or numstored > NUM_BLOCKS
+        or m_mapping_length != COMPACT_LUT_HEADER_SIZE + NUM_BLOCKS*sizeof(unsigned short) + numstored*BLOCK_SIZE)
+    {
+        clear();
+        return false;
+    }
+
+    const unsigned short* index = reinterpret_cast<const unsigned short*>(data + COMPACT_LUT_HEADER_SIZE);
+    for (int b = 0; b < NUM_BLOCKS; b++)
+    {
+        if (not (index[b] & UNIFORM_BLOCK) and index[b] >= numstored)
+        {
+            clear();
+            return false;
+        }
+    }
+    m_index = index;
+    m_blocks = data + COMPACT_LUT_HEADER_SIZE + NUM_BLOCKS*sizeof(unsigned short);
+    m_num_stored_blocks = numstored;
+    return true;
+}
+
+/*!
+  @brief Saves the table to a file
+  @param filename the name of the file
+  @return true if the file was written
+  */
+bool CompactLUT::save(const char* filename) const
+{
+    if (not isValid())
+        return false;
+    ofstream file(filename, ios::out | ios::binary);
+    if (not file.is_open())
+        return false;
+
+    char header[COMPACT_LUT_HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    memcpy(header, COMPACT_LUT_MAGIC, sizeof(COMPACT_LUT_MAGIC));
+    memcpy(header + sizeof(COMPACT_LUT_MAGIC), &m_num_stored_blocks, sizeof(m_num_stored_blocks));
+    file.write(header, sizeof(header));
+    file.write(reinterpret_cast<const char*>(m_index), NUM_BLOCKS*sizeof(unsigned short));
+    file.write(reinterpret_cast<const char*>(m_blocks), m_num_stored_blocks*BLOCK_SIZE);
+    return file.good();
+}
+
+/*!
+  @brief Expands the table into a dense table
+  @param dense the dense table to fill, LUTTools::LUT_SIZE bytes
+  */
+void CompactLUT::toDense(unsigned char* dense) const
+{
+    if (not isValid())
+        return;
+    for (int b = 0; b < NUM_BLOCKS; b++)
+    {
+        for (int o = 0; o < BLOCK_SIZE; o++)
+        {
+            if (m_index[b] & UNIFORM_BLOCK)
+                dense[getDenseIndex(b, o)] = static_cast<unsigned char>(m_index[b]);
+            else
+                dense[getDenseIndex(b, o)] = m_blocks[m_index[b]*BLOCK_SIZE + o];
+        }
+    }
+}
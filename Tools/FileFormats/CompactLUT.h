@@ -0,0 +1,68 @@
+/*!
+  @file CompactLUT.h
+  @author Jason Kulk
+  @brief Declaration of a compact, block-sparse colour lookup table that can be memory mapped from disk.
+*/
+#ifndef COMPACTLUT_H_DEFINED
+#define COMPACTLUT_H_DEFINED
+#include "Infrastructure/NUImage/Pixel.h"
+
+/*!
+  @brief A two-level block-sparse colour lookup table.
+
+  The dense table is 128x128x128 bytes, which is much larger than the cache on the robots. Most of it is
+  unclassified, so the table is split into 16x16x16 blocks of 8x8x8 entries. A block whose entries all have
+  the same class is stored as just that class in the 8KB block index, every other block is stored once in
+  full. Classification results are identical to the dense table.
+
+  The file format is the header, the block index and then the blocks, so a file can be memory mapped and
+  used directly without being read or copied.
+  */
+class CompactLUT
+{
+public:
+    static const int BLOCK_BITS = 3;                                //!< the number of bits of each channel used to index within a block
+    static const int BLOCK_SIZE = 1 << (3*BLOCK_BITS);              //!< the number of entries in each block
+    static const int NUM_BLOCKS = 1 << (3*(7 - BLOCK_BITS));        //!< the number of blocks in the table
+    static const unsigned short UNIFORM_BLOCK = 0x8000;             //!< flag in the block index marking a block whose entries all have the same class
+
+    CompactLUT();
+    ~CompactLUT();
+
+    bool build(const unsigned char* dense);
+    bool load(const char* filename);
+    bool save(const char* filename) const;
+    void toDense(unsigned char* dense) const;
+    void clear();
+
+    /*! @brief Returns true if the table contains a lookup table */
+    bool isValid() const {return m_index != 0;}
+    /*! @brief Returns the number of blocks stored in full */
+    int getNumStoredBlocks() const {return m_num_stored_blocks;}
+    /*! @brief Returns the number of bytes used by the block index and the stored blocks */
+    int getSize() const {return NUM_BLOCKS*sizeof(unsigned short) + m_num_stored_blocks*BLOCK_SIZE;}
+
+    /*!
+      @brief Classify a colour. This gives exactly the same result as the dense table.
+      @param colour the colour to classify
+      @return the classified colour index
+      */
+    inline unsigned char classify(const Pixel& colour) const
+    {
+        unsigned short block = m_index[((colour.y >> 4) << 8) + ((colour.cb >> 4) << 4) + (colour.cr >> 4)];
+        if (block & UNIFORM_BLOCK)
+            return static_cast<unsigned char>(block);
+        else
+            return m_blocks[(block << 9) + (((colour.y >> 1) & 7) << 6) + (((colour.cb >> 1) & 7) << 3) + ((colour.cr >> 1) & 7)];
+    }
+private:
+    static unsigned int getDenseIndex(int block, int offset);
+private:
+    const unsigned short* m_index;          //!< the block index, either the stored block number or UNIFORM_BLOCK | class
+    const unsigned char* m_blocks;          //!< the stored blocks
+    int m_num_stored_blocks;                //!< the number of stored blocks
+    unsigned char* m_memory;                //!< memory owned by this table, when it was built rather than mapped
+    void* m_mapping;                        //!< the mapped file, when it was loaded
+    unsigned int m_mapping_length;          //!< the length of the mapped file
+};
+#endif
@@ -1,4 +1,5 @@
 #include "LUTTools.h"
+#include "CompactLUT.h"
 #include <iostream>
 #include <fstream>
 
@@ -41,3 +42,35 @@ bool LUTTools::SaveLUT(unsigned char* sourceBuffer, int length, const char* file
         return false;
     }
 }
+
+bool LUTTools::LoadCompactLUT(unsigned char* targetBuffer, int length, const char* filename){
+    if(length != LUT_SIZE)
+        return false;
+    CompactLUT lut;
+    if(lut.load(filename)){
+        lut.toDense(targetBuffer);
+        return true;
+    } else {
+        return false;
+    }
+}
+
+bool LUTTools::SaveCompactLUT(unsigned char* sourceBuffer, int length, const char* filename){
+    if(length != LUT_SIZE)
+        return false;
+    CompactLUT lut;
+    return lut.build(sourceBuffer) and lut.save(filename);
+}
+
+bool LUTTools::ConvertLUT(const char* sourceFilename, const char* targetFilename){
+    unsigned char* buffer = new unsigned char[LUT_SIZE];
+    bool success;
+    if(LoadCompactLUT(buffer, LUT_SIZE, sourceFilename))
+        success = SaveLUT(buffer, LUT_SIZE, targetFilename);
+    else if(LoadLUT(buffer, LUT_SIZE, sourceFilename))
+        success = SaveCompactLUT(buffer, LUT_SIZE, targetFilename);
+    else
+        success = false;
+    delete [] buffer;
+    return success;
+}
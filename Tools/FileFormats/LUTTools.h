@@ -55,5 +55,29 @@ public:
       @return True if the colour lookup table was saved successfully. False if it was not.
       */
     static bool SaveLUT(unsigned char* sourceBuffer, int length, const char* filename);
+    /*!
+      @brief Load a compact lookup table (see CompactLUT) from a specified file, and expand it into a supplied buffer.
+      @param targetBuffer The buffer to which the colour lookup table will be written.
+      @param length The length of the colour lookuptable in bytes. This must be LUT_SIZE.
+      @param fileName The name of the compact lookup table file.
+      @return True if the file was loaded into the buffer sucessfully. False if it was not.
+      */
+    static bool LoadCompactLUT(unsigned char* targetBuffer, int length, const char* filename);
+    /*!
+      @brief Save a lookup table from a supplied buffer into a compact lookup table file (see CompactLUT).
+      @param sourceBuffer The buffer in which the colour lookup table is stored.
+      @param length The length of the colour lookuptable in bytes. This must be LUT_SIZE.
+      @param fileName The name of the file to save the compact lookup table.
+      @return True if the colour lookup table was saved successfully. False if it was not.
+      */
+    static bool SaveCompactLUT(unsigned char* sourceBuffer, int length, const char* filename);
+    /*!
+      @brief Converts a lookup table file between the dense and compact formats.
+      If the source file is a compact lookup table the target will be dense, otherwise the target will be compact.
+      @param sourceFilename The name of the file to convert.
+      @param targetFilename The name of the file to save the converted table.
+      @return True if the table was converted successfully. False if it was not.
+      */
+    static bool ConvertLUT(const char* sourceFilename, const char* targetFilename);
 };
 #endif
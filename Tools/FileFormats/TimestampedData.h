@@ -4,6 +4,7 @@
 class TimestampedData
 {
 public:
+    virtual ~TimestampedData() {};
     virtual double GetTimestamp() const = 0;
 };
 
@@ -22,6 +22,7 @@ ENDIF()
 ########## List your source files here! ############################################
 SET (YOUR_SRCS
 LUTTools.cpp
+CompactLUT.cpp
 NUbotImage.cpp
 Parse.cpp
 )
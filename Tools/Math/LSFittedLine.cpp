@@ -10,11 +10,7 @@ LSFittedLine::LSFittedLine(){
 
 void LSFittedLine::clearPoints(){
 	valid = false;
-	sumX = 0;
-	sumY = 0;
-	sumX2 = 0;
-	sumY2 = 0;
-	sumXY = 0;
+	moments = LineMoments();
         numPoints = 0;
 	leftPoint.x = 0;
 	leftPoint.y = 0;
@@ -39,11 +35,7 @@ std::vector<LinePoint*> LSFittedLine::getPoints()
 }
 
 void LSFittedLine::addPoint(LinePoint &point){
-	sumX += point.x;
-	sumY += point.y;
-	sumX2 += point.x * point.x;
-	sumY2 += point.y * point.y;
-	sumXY += point.x * point.y;
+	moments.add(point.x, point.y);
 	numPoints ++;
 	points.push_back(&point);
 	point.inUse = true;
@@ -82,11 +74,7 @@ void LSFittedLine::addPoints(vector<LinePoint*>& pointlist){
             rightPoint = *pointlist[0];
         }
         for(unsigned int i=0; i<pointlist.size(); i++) {
-            sumX += pointlist[i]->x;
-            sumY += pointlist[i]->y;
-            sumX2 += pointlist[i]->x * pointlist[i]->x;
-            sumY2 += pointlist[i]->y * pointlist[i]->y;
-            sumXY += pointlist[i]->x * pointlist[i]->y;
+            moments.add(pointlist[i]->x, pointlist[i]->y);
             numPoints++;
             points.push_back(pointlist[i]);
             pointlist[i]->inUse = true;
@@ -123,11 +111,7 @@ void LSFittedLine::addPoints(vector<LinePoint*>& pointlist){
 
 void LSFittedLine::joinLine(LSFittedLine &sourceLine)
 {
-	sumX += sourceLine.sumX;
-	sumY += sourceLine.sumY;
-	sumX2 += sourceLine.sumX2;
-	sumY2 += sourceLine.sumY2;
-	sumXY += sourceLine.sumXY;
+	moments += sourceLine.moments;
 	numPoints += sourceLine.numPoints;
 	for(unsigned int p = 0; p < sourceLine.points.size(); p++)
 	{
@@ -162,22 +146,8 @@ void LSFittedLine::joinLine(LSFittedLine &sourceLine)
 }
 
 Vector2<double> LSFittedLine::combinedR2TLSandMSD(const LSFittedLine &sourceLine) const{
-    double sxx, syy, sxy, Sigma;
-    double TsumX, TsumY, TsumX2, TsumY2, TsumXY, TnumPoints;
-    TsumX = sumX + sourceLine.sumX;
-    TsumY = sumY + sourceLine.sumY;
-    TsumX2 = sumX2 + sourceLine.sumX2;
-    TsumY2 = sumY2 + sourceLine.sumY2;
-    TsumXY = sumXY + sourceLine.sumXY;
-    TnumPoints = numPoints + sourceLine.numPoints;
     Vector2<double> results;
-
-    sxx = TsumX2 - TsumX*TsumX/TnumPoints;
-    syy = TsumY2 - TsumY*TsumY/TnumPoints;
-    sxy = TsumXY - TsumX*TsumY/TnumPoints;
-    Sigma = (sxx+syy-sqrt((sxx-syy)*(sxx-syy)+4*sxy*sxy))/2;
-    results.x = 1.0-(4.0*Sigma*Sigma/((sxx+syy)*(sxx+syy)+(sxx-syy)*(sxx-syy)+4.0*sxy*sxy));
-    results.y = Sigma/TnumPoints;
+    (moments + sourceLine.moments).getFitQuality(results.y, results.x);
     return results;
 }
 
@@ -191,28 +161,8 @@ double LSFittedLine::getr2tls () const
 }
 
 void LSFittedLine::calcLine(){
-	double sxx, syy, sxy, Sigma;
 	double A = 0, B = 0, C = 0;
-
-        sxx = sumX2 - sumX*sumX/numPoints;
-        syy = sumY2 - sumY*sumY/numPoints;
-        sxy = sumXY - sumX*sumY/numPoints;
-        Sigma = (sxx+syy-sqrt((sxx-syy)*(sxx-syy)+4*sxy*sxy))/2;
-        //cout << "Sigma: "<< Sigma << endl;
-        MSD = Sigma/numPoints;
-        r2tls = 1.0-(4.0*Sigma*Sigma/((sxx+syy)*(sxx+syy)+(sxx-syy)*(sxx-syy)+4.0*sxy*sxy));
-
-
-	if (sxx > syy){
-		A = -sxy;
-		B = (sxx-Sigma);
-		C = -(sumX*sxy-(sxx-Sigma)*sumY)/numPoints;
-	}
-	else {
-		A = (syy-Sigma);
-		B = -sxy;
-		C = -(sumY*sxy-(syy-Sigma)*sumX)/numPoints;
-	}
+	moments.fit(A, B, C, MSD, r2tls);
 	setLine(A, B, C);
 }
 
@@ -1,8 +1,10 @@
 #ifndef LSFITTEDLINE_H_DEFINED
 #define LSFITTEDLINE_H_DEFINED
 #include "Line.h"
+#include "LineMoments.h"
 #include <vector>
 #include "Vector2.h"
+#include "Tools/Memory/FrameArena.h"
 
 using std::vector;
 
@@ -13,6 +15,8 @@ class LinePoint: public Point{
 		int width;
 		LinePoint();
 		void clear();
+		static void* operator new(size_t size) {return FrameArena::allocateMemory(size);}       //!< LinePoints are allocated from the active FrameArena
+		static void operator delete(void* p) {FrameArena::freeMemory(p);}
 };
 
 class LSFittedLine : public Line
@@ -20,6 +24,8 @@ class LSFittedLine : public Line
   public:
     LSFittedLine();
     bool valid;
+    static void* operator new(size_t size) {return FrameArena::allocateMemory(size);}       //!< LSFittedLines are allocated from the active FrameArena
+    static void operator delete(void* p) {FrameArena::freeMemory(p);}
     
     void addPoint(LinePoint &point);
     void addPoints(vector<LinePoint*>& pointlist);
@@ -34,7 +40,7 @@ class LSFittedLine : public Line
     int numPoints;
 private:
     void calcLine();
-    double sumX, sumY, sumX2, sumY2, sumXY;
+    LineMoments moments;
     double MSD, r2tls;
     std::vector<LinePoint*> points;
     
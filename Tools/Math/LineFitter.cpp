@@ -0,0 +1,264 @@
+/*! @file LineFitter.cpp
+    @brief Implementation of a least squares line fitter over ranges of a set of points
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "LineFitter.h"
+
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+LineFitter::LineFitter()
+{
+    m_sums.push_back(LineMoments());
+}
+
+/*! @brief Sets the points to be fitted. Any ranges of the previous points are no longer valid.
+    @param points the points, which must outlive the fitter's use of them
+ */
+void LineFitter::setPoints(const vector<LinePoint*>& points)
+{
+    m_x.clear();
+    m_y.clear();
+    m_points.clear();
+    m_sums.resize(1);
+    // each split appends its right half, so there is room for the points to be split a few times without reallocating
+    size_t capacity = 4*points.size();
+    m_x.reserve(capacity);
+    m_y.reserve(capacity);
+    m_points.reserve(capacity);
+    m_sums.reserve(capacity + 1);
+    for (size_t i=0; i<points.size(); i++)
+        append(points[i]->x, points[i]->y, points[i]);
+}
+
+/*! @brief Returns the range of all of the points given to setPoints */
+LineFitter::Range LineFitter::getAll() const
+{
+    Range range;
+    range.Begin = 0;
+    range.End = m_points.size();
+    return range;
+}
+
+/*! @brief Replaces the contents of points with the LinePoints in the range */
+void LineFitter::getPoints(const Range& range, vector<LinePoint*>& points) const
+{
+    points.assign(m_points.begin() + range.Begin, m_points.begin() + range.End);
+}
+
+/*! @brief Returns the moments of the points in the range, in constant time */
+LineMoments LineFitter::getMoments(const Range& range) const
+{
+    return m_sums[range.End] - m_sums[range.Begin];
+}
+
+/*! @brief Fits a line to the points in the range, in constant time
+    @return true if the line is valid; there must be at least two points
+ */
+bool LineFitter::fit(const Range& range, Line& line) const
+{
+    LineMoments moments = getMoments(range);
+    if (moments.NumPoints < 2)
+        return false;
+    double A, B, C, msd, r2tls;
+    moments.fit(A, B, C, msd, r2tls);
+    return line.setLine(A, B, C);
+}
+
+/*! @brief Finds the point in the range furthest from the line
+    @param range the points to search
+    @param line the line
+    @param threshold the perpendicular distance beyond which a point is counted
+    @param numover the number of points further than the threshold from the line
+    @return the index of the furthest point further than the threshold, or -1 if there is no such point
+ */
+int LineFitter::findFurthestPoint(const Range& range, const Line& line, double threshold, int& numover)
+{
+    const unsigned int n = range.size();
+    const double A = line.getA();
+    const double B = line.getB();
+    const double C = line.getC();
+    const double denom = sqrt(A*A + B*B);
+    numover = 0;
+    if (n == 0)
+        return -1;
+
+    if (m_scratch.size() < n)
+        m_scratch.resize(n);
+    const double* x = &m_x[range.Begin];
+    const double* y = &m_y[range.Begin];
+    double* distances = &m_scratch[0];
+    for (unsigned int i=0; i<n; i++)
+        distances[i] = fabs(A*x[i] + B*y[i] - C)/denom;
+
+    int furthest = -1;
+    double greatest = 0;
+    for (unsigned int i=0; i<n; i++)
+    {
+        if (distances[i] > threshold)
+        {
+            numover++;
+            if (distances[i] > greatest)
+            {
+                greatest = distances[i];
+                furthest = range.Begin + i;
+            }
+        }
+    }
+    return furthest;
+}
+
+/*! @brief Splits a range of points in two at a point, by which side of the perpendicular to the line through the point they are on
+
+    The split point is in both halves, and is the first point of each, as it was when the halves were copied into new
+    lists. So the halves are in the same order as the copies were, and a tie for the furthest point from a half's line
+    is won by the same point. The split point and the points on the left stay where the range was, and the split point
+    followed by the points on the right is appended to the end. Nothing is moved if there are no points on one side,
+    because then the split does not separate anything.
+
+    @param range the points to split, which are no longer a valid range if the split succeeds
+    @param split the index of the point at which to split
+    @param line the line fitted to the range
+    @param left the split point, and the points before it
+    @param right the split point, and the points after it
+    @return true if the range was split, false if every point other than the split point is on one side
+ */
+bool LineFitter::separate(const Range& range, unsigned int split, const Line& line, Range& left, Range& right)
+{
+    const unsigned int n = range.size();
+    const double A = line.getA();
+    const double B = line.getB();
+    const double C = line.getC();
+    const double x1 = m_x[split];
+    const double y1 = m_y[split];
+
+    // the position of each point along the line, relative to the split point. Negative is to the left.
+    if (m_scratch.size() < n)
+        m_scratch.resize(n);
+    const double* x = &m_x[range.Begin];
+    const double* y = &m_y[range.Begin];
+    double* positions = &m_scratch[0];
+    if (A == 0.0)
+    {   // horizontal line, so the position is x
+        for (unsigned int i=0; i<n; i++)
+            positions[i] = x[i] - x1;
+    }
+    else if (B == 0.0)
+    {   // vertical line, so the position is y
+        for (unsigned int i=0; i<n; i++)
+            positions[i] = y[i] - y1;
+    }
+    else
+    {   // sloped line, so the point is moved to the foot of the perpendicular from the split point, and rotated onto the line
+        // the foot (X0, X1) is meant to be the solution of [A B; B -A][x; y] = [C; Bx1 - Ay1]. This is the arithmetic
+        // SplitAndMerge has always used, in which the B terms of the inverse are not divided by the determinant.
+        const double alpha = atan(-A/B);
+        const double cosalpha = cos(alpha);
+        const double sinalpha = sin(alpha);
+        const double KB = (B*x1) - (A*y1);
+        const double div = (-A)*A - (B*B);
+        const double IA = (-A)/div;
+        const double ID = -IA;
+        const double X0 = IA*C + (-B)*KB;
+        const double X1 = (-B)*C + ID*KB;
+        for (unsigned int i=0; i<n; i++)
+            positions[i] = (x[i] - X0)*cosalpha + (y[i] - X1)*sinalpha;
+    }
+
+    unsigned int numleft = 0;
+    for (unsigned int i=0; i<n; i++)
+        numleft += positions[i] < 0;
+    if (positions[split - range.Begin] < 0)
+        numleft--;
+    if (numleft == 0 or numleft == n - 1)
+        return false;
+
+    LinePoint* splitpoint = m_points[split];
+    right.Begin = m_points.size();
+    append(x1, y1, splitpoint);
+    unsigned int w = range.Begin;
+    for (unsigned int i=range.Begin; i<range.End; i++)
+    {
+        if (i == split)
+            continue;
+        if (m_scratch[i - range.Begin] < 0)
+        {
+            m_x[w] = m_x[i];
+            m_y[w] = m_y[i];
+            m_points[w] = m_points[i];
+            w++;
+        }
+        else
+            append(m_x[i], m_y[i], m_points[i]);
+    }
+    right.End = m_points.size();
+
+    // the left points are moved up one to put the split point first. There is room, because the split point was in the range.
+    copy_backward(m_x.begin() + range.Begin, m_x.begin() + w, m_x.begin() + w + 1);
+    copy_backward(m_y.begin() + range.Begin, m_y.begin() + w, m_y.begin() + w + 1);
+    copy_backward(m_points.begin() + range.Begin, m_points.begin() + w, m_points.begin() + w + 1);
+    m_x[range.Begin] = x1;
+    m_y[range.Begin] = y1;
+    m_points[range.Begin] = splitpoint;
+    left.Begin = range.Begin;
+    left.End = w + 1;
+    updateSums(left.Begin, left.End);
+    return true;
+}
+
+/*! @brief Removes a point from a range, by moving the last point of the range into its place
+    @param range the range, which is one point shorter afterwards
+    @param index the index of the point to remove
+ */
+void LineFitter::removePoint(Range& range, unsigned int index)
+{
+    range.End--;
+    swap(m_x[index], m_x[range.End]);
+    swap(m_y[index], m_y[range.End]);
+    swap(m_points[index], m_points[range.End]);
+    updateSums(index, range.End);
+}
+
+/*! @brief Adds a point to the end of the arrays */
+void LineFitter::append(double x, double y, LinePoint* point)
+{
+    m_x.push_back(x);
+    m_y.push_back(y);
+    m_points.push_back(point);
+    LineMoments sum = m_sums.back();
+    sum.add(x, y);
+    m_sums.push_back(sum);
+}
+
+/*! @brief Recalculates the running sums of the points [begin, end) after they have been moved.
+
+    The range must have ended after end before the points were moved, so the sums after end are for the
+    same points as before, and the ranges that follow this one are not affected.
+ */
+void LineFitter::updateSums(unsigned int begin, unsigned int end)
+{
+    for (unsigned int i=begin; i<end; i++)
+    {
+        m_sums[i+1] = m_sums[i];
+        m_sums[i+1].add(m_x[i], m_y[i]);
+    }
+}
+
@@ -0,0 +1,80 @@
+/*! @file LineFitter.h
+    @brief Declaration of a least squares line fitter over ranges of a set of points
+
+    @class LineFitter
+    @brief Fits lines to ranges of a set of points, and splits the ranges, without copying the points into new lists.
+
+    The coordinates are kept in contiguous arrays of x and of y (rather than in the LinePoints), so the loops over
+    the points (the distances to a line, and the positions along it) are simple enough for the compiler to vectorise.
+    The running sums of the moments are kept alongside, so the moments of any range, and so its fit, are found in
+    constant time.
+
+    SplitAndMerge works on Ranges of the fitter. A range is split in place: the split point and the points left of it
+    stay where the range was, and the split point and the points to the right are appended to the end of the arrays. So the ranges never overlap,
+    even though the split point is in both of them, and the points of a range that is waiting to be split are never
+    moved by the splitting of another.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LINEFITTER_H
+#define LINEFITTER_H
+
+#include "LSFittedLine.h"
+#include "LineMoments.h"
+
+#include <vector>
+
+class LineFitter
+{
+public:
+    /*! @brief The points [Begin, End) of the fitter */
+    struct Range
+    {
+        unsigned int Begin;         //!< the index of the first point in the range
+        unsigned int End;           //!< the index one past the last point in the range
+        unsigned int size() const {return End - Begin;}
+    };
+public:
+    LineFitter();
+
+    void setPoints(const std::vector<LinePoint*>& points);
+    Range getAll() const;
+    /*! @brief Returns the LinePoint at the index */
+    LinePoint* getPoint(unsigned int index) const {return m_points[index];}
+    void getPoints(const Range& range, std::vector<LinePoint*>& points) const;
+
+    LineMoments getMoments(const Range& range) const;
+    bool fit(const Range& range, Line& line) const;
+
+    int findFurthestPoint(const Range& range, const Line& line, double threshold, int& numover);
+    bool separate(const Range& range, unsigned int split, const Line& line, Range& left, Range& right);
+    void removePoint(Range& range, unsigned int index);
+private:
+    void append(double x, double y, LinePoint* point);
+    void updateSums(unsigned int begin, unsigned int end);
+private:
+    std::vector<double> m_x;                    //!< the x coordinate of each point
+    std::vector<double> m_y;                    //!< the y coordinate of each point
+    std::vector<LinePoint*> m_points;           //!< the LinePoint of each point
+    std::vector<LineMoments> m_sums;            //!< the moments of the points before each index; m_sums[i] is of the points [0, i)
+    std::vector<double> m_scratch;              //!< the distance, or the position along the line, of each point in a range
+};
+
+#endif
+
@@ -0,0 +1,77 @@
+/*! @file LineMoments.cpp
+    @brief Implementation of the total least squares fit of a line to the moments of a set of points
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "LineMoments.h"
+#include <cmath>
+
+/*! @brief Fits the line Ax + By = C to the points, minimising the sum of the squared perpendicular distances
+    @param A the x coefficient of the line
+    @param B the y coefficient of the line
+    @param C the constant of the line
+    @param msd the mean squared perpendicular distance of the points to the line
+    @param r2tls the r² of the total least squares fit; 1 is a perfect fit
+ */
+void LineMoments::fit(double& A, double& B, double& C, double& msd, double& r2tls) const
+{
+    double sxx, syy, sxy;
+    double Sigma = getSigma(sxx, syy, sxy);
+    msd = Sigma/NumPoints;
+    r2tls = 1.0-(4.0*Sigma*Sigma/((sxx+syy)*(sxx+syy)+(sxx-syy)*(sxx-syy)+4.0*sxy*sxy));
+
+    if (sxx > syy)
+    {
+        A = -sxy;
+        B = (sxx-Sigma);
+        C = -(SumX*sxy-(sxx-Sigma)*SumY)/NumPoints;
+    }
+    else
+    {
+        A = (syy-Sigma);
+        B = -sxy;
+        C = -(SumY*sxy-(syy-Sigma)*SumX)/NumPoints;
+    }
+}
+
+/*! @brief Calculates how well a line fits the points, without calculating the line
+    @param msd the mean squared perpendicular distance of the points to the line
+    @param r2tls the r² of the total least squares fit; 1 is a perfect fit
+ */
+void LineMoments::getFitQuality(double& msd, double& r2tls) const
+{
+    double sxx, syy, sxy;
+    double Sigma = getSigma(sxx, syy, sxy);
+    msd = Sigma/NumPoints;
+    r2tls = 1.0-(4.0*Sigma*Sigma/((sxx+syy)*(sxx+syy)+(sxx-syy)*(sxx-syy)+4.0*sxy*sxy));
+}
+
+/*! @brief Returns the sum of the squared perpendicular distances of the points to the best line through them
+    @param sxx the sum of the squared deviations of the x coordinates from their mean
+    @param syy the sum of the squared deviations of the y coordinates from their mean
+    @param sxy the sum of the products of the deviations
+ */
+double LineMoments::getSigma(double& sxx, double& syy, double& sxy) const
+{
+    sxx = SumX2 - SumX*SumX/NumPoints;
+    syy = SumY2 - SumY*SumY/NumPoints;
+    sxy = SumXY - SumX*SumY/NumPoints;
+    return (sxx+syy-sqrt((sxx-syy)*(sxx-syy)+4*sxy*sxy))/2;
+}
+
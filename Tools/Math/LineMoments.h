@@ -0,0 +1,86 @@
+/*! @file LineMoments.h
+    @brief Declaration of the sums of a set of points to which a line is fitted
+
+    @class LineMoments
+    @brief The sums of x, y, x², y² and xy of a set of points, from which the total least squares line through the
+    points, and how well it fits, can be calculated without the points.
+
+    The moments of two sets of points are the sum of the moments of each, so the fit of the union of two sets
+    (LSFittedLine::joinLine) or of a range of points (LineFitter::getMoments) is found without visiting any points.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LINEMOMENTS_H
+#define LINEMOMENTS_H
+
+class LineMoments
+{
+public:
+    LineMoments() : SumX(0), SumY(0), SumX2(0), SumY2(0), SumXY(0), NumPoints(0) {};
+
+    /*! @brief Adds the point (x, y) */
+    void add(double x, double y)
+    {
+        SumX += x;
+        SumY += y;
+        SumX2 += x*x;
+        SumY2 += y*y;
+        SumXY += x*y;
+        NumPoints++;
+    }
+    /*! @brief Adds the moments of another set of points */
+    LineMoments& operator+=(const LineMoments& other)
+    {
+        SumX += other.SumX;
+        SumY += other.SumY;
+        SumX2 += other.SumX2;
+        SumY2 += other.SumY2;
+        SumXY += other.SumXY;
+        NumPoints += other.NumPoints;
+        return *this;
+    }
+    /*! @brief Removes the moments of a subset of the points */
+    LineMoments& operator-=(const LineMoments& other)
+    {
+        SumX -= other.SumX;
+        SumY -= other.SumY;
+        SumX2 -= other.SumX2;
+        SumY2 -= other.SumY2;
+        SumXY -= other.SumXY;
+        NumPoints -= other.NumPoints;
+        return *this;
+    }
+    LineMoments operator+(const LineMoments& other) const {LineMoments sum(*this); return sum += other;}
+    LineMoments operator-(const LineMoments& other) const {LineMoments difference(*this); return difference -= other;}
+
+    void fit(double& A, double& B, double& C, double& msd, double& r2tls) const;
+    void getFitQuality(double& msd, double& r2tls) const;
+private:
+    double getSigma(double& sxx, double& syy, double& sxy) const;
+public:
+    double SumX;            //!< the sum of the x coordinates
+    double SumY;            //!< the sum of the y coordinates
+    double SumX2;           //!< the sum of the squares of the x coordinates
+    double SumY2;           //!< the sum of the squares of the y coordinates
+    double SumXY;           //!< the sum of the products of the coordinates
+    int NumPoints;          //!< the number of points
+};
+
+#endif
+
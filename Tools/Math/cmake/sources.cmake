@@ -23,6 +23,8 @@ ENDIF()
 SET (YOUR_SRCS
 Line.cpp
 LSFittedLine.cpp
+LineMoments.cpp
+LineFitter.cpp
 Matrix.cpp  
 TransformMatrices.cpp
 UKF.cpp
@@ -0,0 +1,81 @@
+/*! @file ArenaAllocator.h
+    @brief Declaration and implementation of an STL allocator that uses the active FrameArena
+
+    @class ArenaAllocator
+    @brief An STL allocator that allocates from the active FrameArena, or from the heap when no arena is active.
+
+    The allocator is stateless, so containers using it can be copied, swapped and assigned between frames like
+    any other container. Use ArenaVector<T>::type for a std::vector of per frame working data.
+    A container created outside a frame must not grow inside one, otherwise its storage will be released with the frame.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ARENAALLOCATOR_H
+#define ARENAALLOCATOR_H
+
+#include "FrameArena.h"
+
+#include <vector>
+#include <new>
+#include <cstddef>
+
+template <class T> class ArenaAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    template <class U> struct rebind {typedef ArenaAllocator<U> other;};
+
+    ArenaAllocator() {}
+    ArenaAllocator(const ArenaAllocator&) {}
+    template <class U> ArenaAllocator(const ArenaAllocator<U>&) {}
+    ~ArenaAllocator() {}
+
+    pointer address(reference x) const {return &x;}
+    const_pointer address(const_reference x) const {return &x;}
+    size_type max_size() const {return size_t(-1)/sizeof(T);}
+
+    pointer allocate(size_type n, const void* = 0)
+    {
+        return static_cast<pointer>(FrameArena::allocateMemory(n*sizeof(T)));
+    }
+    void deallocate(pointer p, size_type)
+    {
+        FrameArena::freeMemory(p);
+    }
+    void construct(pointer p, const T& value) {new(p) T(value);}
+    void destroy(pointer p) {p->~T();}
+};
+
+template <class T, class U> inline bool operator==(const ArenaAllocator<T>&, const ArenaAllocator<U>&) {return true;}
+template <class T, class U> inline bool operator!=(const ArenaAllocator<T>&, const ArenaAllocator<U>&) {return false;}
+
+/*! @brief A std::vector whose storage comes from the active FrameArena */
+template <class T> struct ArenaVector
+{
+    typedef std::vector<T, ArenaAllocator<T> > type;
+};
+
+#endif
+
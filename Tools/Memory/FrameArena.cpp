@@ -0,0 +1,168 @@
+/*! @file FrameArena.cpp
+    @brief Implementation of a resettable arena for working data that only lives for a single frame
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "FrameArena.h"
+
+#include <new>
+using namespace std;
+
+static const size_t ARENA_ALIGNMENT = 16;      //!< the alignment of every allocation in bytes
+
+static __thread FrameArena* CurrentArena = 0;      //!< the arena most recently activated on this thread, used to recognise arena memory when it is freed
+
+/*! @brief Creates an inactive arena
+    @param size the initial size of the arena in bytes
+ */
+FrameArena::FrameArena(size_t size)
+{
+    m_offset = 0;
+    m_used = 0;
+    m_num_allocations = 0;
+    m_last_peak = 0;
+    m_max_peak = 0;
+    m_last_num_allocations = 0;
+    m_active = false;
+    addBlock(size);
+}
+
+/*! @brief Destroys the arena. Nothing allocated from it may be used afterwards */
+FrameArena::~FrameArena()
+{
+    if (CurrentArena == this)
+        CurrentArena = 0;
+    freeBlocks();
+}
+
+/*! @brief Makes allocations on the calling thread come from this arena until deactivate() is called */
+void FrameArena::activate()
+{
+    CurrentArena = this;
+    m_active = true;
+}
+
+/*! @brief Makes allocations come from the heap again. The memory already allocated from the arena remains valid until reset() */
+void FrameArena::deactivate()
+{
+    m_active = false;
+}
+
+/*! @brief Releases everything allocated from the arena, and records the peak usage of the frame.
+
+    If extra blocks were needed during the frame they are replaced by a single block large enough for the peak.
+ */
+void FrameArena::reset()
+{
+    m_last_peak = m_used;
+    m_last_num_allocations = m_num_allocations;
+    if (m_used > m_max_peak)
+        m_max_peak = m_used;
+
+    if (m_blocks.size() > 1)
+    {
+        size_t capacity = getCapacity();
+        freeBlocks();
+        addBlock(capacity);
+    }
+    m_offset = 0;
+    m_used = 0;
+    m_num_allocations = 0;
+}
+
+/*! @brief Allocates memory from the arena. A new block is added if the current one is full
+    @param bytes the number of bytes to allocate
+    @return a pointer to the memory, aligned to ARENA_ALIGNMENT
+ */
+void* FrameArena::allocate(size_t bytes)
+{
+    size_t size = (bytes + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+    if (m_offset + size > m_block_sizes.back())
+    {
+        size_t blocksize = 2*m_block_sizes.back();
+        if (blocksize < size)
+            blocksize = size;
+        addBlock(blocksize);
+    }
+    void* p = m_blocks.back() + m_offset;
+    m_offset += size;
+    m_used += size;
+    m_num_allocations++;
+    return p;
+}
+
+/*! @brief Returns true if p points into the memory of this arena */
+bool FrameArena::owns(const void* p) const
+{
+    const char* c = static_cast<const char*>(p);
+    for (size_t i = 0; i < m_blocks.size(); i++)
+    {
+        if (c >= m_blocks[i] and c < m_blocks[i] + m_block_sizes[i])
+            return true;
+    }
+    return false;
+}
+
+/*! @brief Returns the total size of the arena's blocks in bytes */
+size_t FrameArena::getCapacity() const
+{
+    size_t capacity = 0;
+    for (size_t i = 0; i < m_block_sizes.size(); i++)
+        capacity += m_block_sizes[i];
+    return capacity;
+}
+
+/*! @brief Allocates memory from the active arena, or from the heap if there is no active arena
+    @param bytes the number of bytes to allocate
+ */
+void* FrameArena::allocateMemory(size_t bytes)
+{
+    if (CurrentArena and CurrentArena->m_active)
+        return CurrentArena->allocate(bytes);
+    else
+        return ::operator new(bytes);
+}
+
+/*! @brief Frees memory allocated by allocateMemory(). Arena memory is left until the arena is reset, heap memory is freed immediately */
+void FrameArena::freeMemory(void* p)
+{
+    if (p == 0 or (CurrentArena and CurrentArena->owns(p)))
+        return;
+    ::operator delete(p);
+}
+
+/*! @brief Adds a block of the given size to the arena, and makes it the block allocations are made from */
+void FrameArena::addBlock(size_t size)
+{
+    if (size < ARENA_ALIGNMENT)
+        size = ARENA_ALIGNMENT;
+    m_blocks.push_back(static_cast<char*>(::operator new(size)));
+    m_block_sizes.push_back(size);
+    m_offset = 0;
+}
+
+/*! @brief Returns all of the blocks to the heap */
+void FrameArena::freeBlocks()
+{
+    for (size_t i = 0; i < m_blocks.size(); i++)
+        ::operator delete(m_blocks[i]);
+    m_blocks.clear();
+    m_block_sizes.clear();
+}
+
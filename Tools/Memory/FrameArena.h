@@ -0,0 +1,94 @@
+/*! @file FrameArena.h
+    @brief Declaration of a resettable arena for working data that only lives for a single frame
+
+    @class FrameArena
+    @brief A bump allocator whose memory is all released in a single step at the end of each frame.
+
+    While an arena is active (between activate() and deactivate(), or for the lifetime of a FrameArena::Scope)
+    ArenaAllocator containers, LinePoints and LSFittedLines are allocated from it rather than from the heap.
+    Freeing arena memory does nothing; everything allocated in a frame is released together by reset().
+    When the arena is not active the same types fall back to the heap, so code outside the frame is unaffected.
+
+    Anything allocated from the arena must not outlive the frame. An arena is only active on the thread that
+    activated it, so other threads keep allocating from the heap while vision runs. The arena itself is not thread
+    safe, and anything allocated from it must be freed on the same thread.
+
+    If a frame needs more memory than the arena has, extra blocks are allocated. They are replaced by a single
+    block of the peak size when the arena is reset, so after a few frames no more blocks are allocated.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <vector>
+#include <cstddef>
+
+class FrameArena
+{
+public:
+    /*! @brief Activates an arena for the lifetime of the Scope, and resets it when the Scope is destroyed */
+    class Scope
+    {
+    public:
+        Scope(FrameArena& arena) : m_arena(arena) {m_arena.activate();}
+        ~Scope() {m_arena.deactivate(); m_arena.reset();}
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+        FrameArena& m_arena;
+    };
+
+    FrameArena(size_t size = 256*1024);
+    ~FrameArena();
+
+    void activate();
+    void deactivate();
+    void reset();
+
+    void* allocate(size_t bytes);
+    bool owns(const void* p) const;
+
+    size_t getCapacity() const;
+    size_t getUsed() const {return m_used;}
+    size_t getLastPeak() const {return m_last_peak;}
+    size_t getMaxPeak() const {return m_max_peak;}
+    unsigned int getLastNumAllocations() const {return m_last_num_allocations;}
+
+    static void* allocateMemory(size_t bytes);
+    static void freeMemory(void* p);
+private:
+    FrameArena(const FrameArena&);
+    FrameArena& operator=(const FrameArena&);
+    void addBlock(size_t size);
+    void freeBlocks();
+private:
+    std::vector<char*> m_blocks;            //!< the blocks of memory; allocations are made from the last one
+    std::vector<size_t> m_block_sizes;      //!< the size of each block in bytes
+    size_t m_offset;                        //!< the offset of the next free byte in the last block
+    size_t m_used;                          //!< the number of bytes allocated since the last reset
+    unsigned int m_num_allocations;         //!< the number of allocations since the last reset
+    size_t m_last_peak;                     //!< the number of bytes used in the last frame
+    size_t m_max_peak;                      //!< the largest number of bytes used in any frame
+    unsigned int m_last_num_allocations;    //!< the number of allocations in the last frame
+    bool m_active;                          //!< true if allocations are currently made from this arena
+};
+
+#endif
+
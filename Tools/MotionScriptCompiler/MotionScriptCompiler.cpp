@@ -0,0 +1,120 @@
+/*! @file MotionScriptCompiler.cpp
+    @brief The motion script compiler; compiles text motion scripts into precompiled binary scripts
+
+    Usage:
+    @verbatim
+    motionscriptcompiler <script.num | directory> ...
+    @endverbatim
+    Each .num file, and every .num file in each directory, is compiled into a .nums file next to it.
+    The .nums file is read back and compared with the text script, so a script that compiles is one
+    that the robot will load. The program exits with 1 if any script fails to compile.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Motion/Tools/MotionScriptFile.h"
+
+#include <dirent.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <iostream>
+using namespace std;
+
+/*! @brief Returns true if the name ends with the extension */
+static bool hasExtension(const string& name, const string& extension)
+{
+    return name.size() > extension.size() and name.compare(name.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+/*! @brief Adds the .num files given on the command line to scripts. Directories are searched, but not recursively.
+    @return false if a path is neither a .num file nor a directory that can be read
+ */
+static bool findScripts(const string& path, vector<string>& scripts)
+{
+    if (hasExtension(path, ".num"))
+    {
+        scripts.push_back(path);
+        return true;
+    }
+    DIR* directory = opendir(path.c_str());
+    if (directory == NULL)
+    {
+        cerr << path << " is not a .num file or a directory" << endl;
+        return false;
+    }
+    string prefix = path[path.size() - 1] == '/' ? path : path + "/";
+    vector<string> found;
+    for (struct dirent* entry = readdir(directory); entry != NULL; entry = readdir(directory))
+    {
+        if (hasExtension(entry->d_name, ".num"))
+            found.push_back(prefix + entry->d_name);
+    }
+    closedir(directory);
+    sort(found.begin(), found.end());
+    scripts.insert(scripts.end(), found.begin(), found.end());
+    return true;
+}
+
+/*! @brief Compiles a .num file into a .nums file, and checks that the .nums file loads back as the same script
+    @return true if the script was compiled
+ */
+static bool compileScript(const string& textfilename)
+{
+    string binaryfilename = textfilename + "s";
+    MotionScriptFile text, binary;
+    if (not text.compile(textfilename, binaryfilename))
+    {
+        cerr << "Unable to compile " << textfilename << ": " << text.getError() << endl;
+        return false;
+    }
+    if (not binary.load(binaryfilename))
+    {
+        cerr << "Unable to load the compiled " << binaryfilename << ": " << binary.getError() << endl;
+        return false;
+    }
+    if (binary.Smoothness != text.Smoothness or binary.ReturnToStart != text.ReturnToStart or binary.Labels != text.Labels
+        or binary.Times != text.Times or binary.Positions != text.Positions or binary.Gains != text.Gains)
+    {
+        cerr << "The compiled " << binaryfilename << " is not the same as " << textfilename << endl;
+        return false;
+    }
+
+    size_t numpoints = 0;
+    for (size_t i=0; i<text.Times.size(); i++)
+        numpoints += text.Times[i].size();
+    cout << textfilename << " -> " << binaryfilename << " (" << text.Times.size() << " joints, " << numpoints << " points)" << endl;
+    return true;
+}
+
+int main(int argc, const char* argv[])
+{
+    if (argc < 2)
+    {
+        cerr << "Usage: " << argv[0] << " <script.num | directory> ..." << endl;
+        return 2;
+    }
+
+    bool ok = true;
+    vector<string> scripts;
+    for (int i=1; i<argc; i++)
+        ok &= findScripts(argv[i], scripts);
+    for (size_t i=0; i<scripts.size(); i++)
+        ok &= compileScript(scripts[i]);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,239 @@
+/*! @file LatencyMonitor.cpp
+    @brief Implementation of a lock free monitor of the cycle times of a thread
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "LatencyMonitor.h"
+#include "Infrastructure/NUBlackboard.h"
+#include "NUPlatform/NUPlatform.h"
+
+#include <algorithm>
+#include <cmath>
+using namespace std;
+
+/*! @brief A full memory barrier, so that the slot contents and the sequence numbers are seen in the order they were written */
+static inline void memoryBarrier()
+{
+    __sync_synchronize();
+}
+
+/*! @brief Returns the value at the given fraction through the values. The values are partially reordered. */
+static double percentile(vector<double>& values, double fraction)
+{
+    if (values.empty())
+        return 0;
+    size_t n = static_cast<size_t>(fraction*(values.size() - 1) + 0.5);
+    nth_element(values.begin(), values.begin() + n, values.end());
+    return values[n];
+}
+
+LatencyReport::LatencyReport()
+{
+    Period = 0;
+    NumCycles = 0;
+    NumDropped = 0;
+    NumMisses = 0;
+    MissRatio = 0;
+    MeanExecution = 0;
+    MaxExecution = 0;
+    MeanWait = 0;
+    JitterMedian = 0;
+    Jitter95 = 0;
+    Jitter99 = 0;
+    LongestStall = 0;
+    CurrentStall = 0;
+    MeanInputAge = 0;
+    MaxInputAge = 0;
+}
+
+/*! @brief Creates a latency monitor
+    @param name the name of the monitored thread
+    @param period the period at which the thread is expected to run in ms. A cycle that takes longer than this has missed its deadline
+    @param capacity the number of cycles that can be recorded between collections before the oldest are dropped
+ */
+LatencyMonitor::LatencyMonitor(const string& name, double period, unsigned int capacity)
+{
+    m_name = name;
+    m_period = period;
+    m_capacity = max(capacity, 2u);
+    m_slots = new Slot[m_capacity];
+    for (unsigned int i = 0; i < m_capacity; i++)
+        m_slots[i].Sequence = 0;
+    m_head = 0;
+    m_current.WaitStart = -1;
+    m_current.Start = -1;
+    m_current.End = -1;
+    m_current.InputAge = 0;
+
+    m_tail = 0;
+    m_last_start = -1;
+    m_last_end = -1;
+    m_jitter.reserve(m_capacity);
+}
+
+LatencyMonitor::~LatencyMonitor()
+{
+    delete [] m_slots;
+}
+
+/*! @brief Marks the time the monitored thread starts waiting for its next cycle. Only call this from the monitored thread. */
+void LatencyMonitor::markWait()
+{
+    m_current.WaitStart = Platform->getRealTime();
+}
+
+/*! @brief Marks the time the monitored thread starts its cycle. Only call this from the monitored thread.
+    @param inputage the age in ms of the data the cycle is processing, for example how long ago the image was taken
+ */
+void LatencyMonitor::markStart(double inputage)
+{
+    m_current.Start = Platform->getRealTime();
+    m_current.InputAge = inputage;
+    if (m_current.WaitStart < 0)
+        m_current.WaitStart = m_current.Start;
+}
+
+/*! @brief Marks the end of the monitored thread's cycle, and records the cycle. Only call this from the monitored thread. */
+void LatencyMonitor::markEnd()
+{
+    if (m_current.Start < 0)
+        return;
+    addCycle(m_current.WaitStart, m_current.Start, Platform->getRealTime(), m_current.InputAge);
+    m_current.WaitStart = -1;
+    m_current.Start = -1;
+}
+
+/*! @brief Records a complete cycle. Only call this from the monitored thread.
+    @param waitstart the time the thread started waiting for the cycle in ms
+    @param start the time the cycle started in ms
+    @param end the time the cycle finished in ms
+    @param inputage the age of the data the cycle processed when it started in ms
+ */
+void LatencyMonitor::addCycle(double waitstart, double start, double end, double inputage)
+{
+    unsigned int index = m_head;
+    Slot& slot = m_slots[index % m_capacity];
+    slot.Sequence = 2*index + 1;
+    memoryBarrier();
+    slot.Data.WaitStart = waitstart;
+    slot.Data.Start = start;
+    slot.Data.End = end;
+    slot.Data.InputAge = inputage;
+    memoryBarrier();
+    slot.Sequence = 2*index + 2;
+    memoryBarrier();
+    m_head = index + 1;
+}
+
+/*! @brief Summarises the cycles recorded since the last collection. Only call this from one thread. */
+LatencyReport LatencyMonitor::collect()
+{
+    return collect(Platform->getRealTime());
+}
+
+/*! @brief Summarises the cycles recorded since the last collection. Only call this from one thread.
+    @param now the current time in ms, used to work out how long the monitored thread has currently been stalled for
+ */
+LatencyReport LatencyMonitor::collect(double now)
+{
+    LatencyReport report;
+    report.Name = m_name;
+    report.Period = m_period;
+
+    unsigned int head = m_head;
+    memoryBarrier();
+    bool consecutive = true;                // false when cycles have been lost since the last one we read, so the interval between them is meaningless
+    if (head - m_tail > m_capacity)
+    {   // the writer has lapped us, skip to the oldest cycle that can still be in the ring
+        report.NumDropped += head - m_tail - m_capacity;
+        m_tail = head - m_capacity;
+        consecutive = false;
+    }
+
+    m_jitter.clear();
+    double totalexecution = 0, totalwait = 0, totalage = 0;
+    for (; m_tail != head; m_tail++)
+    {
+        const Slot& slot = m_slots[m_tail % m_capacity];
+        unsigned int before = slot.Sequence;
+        memoryBarrier();
+        Cycle cycle = slot.Data;
+        memoryBarrier();
+        unsigned int after = slot.Sequence;
+        if (before != 2*m_tail + 2 or after != before)
+        {   // the slot was overwritten while we were reading it
+            report.NumDropped++;
+            consecutive = false;
+            continue;
+        }
+
+        double execution = cycle.End - cycle.Start;
+        totalexecution += execution;
+        totalwait += cycle.Start - cycle.WaitStart;
+        totalage += cycle.InputAge;
+        report.NumCycles++;
+        report.MaxExecution = max(report.MaxExecution, execution);
+        report.MaxInputAge = max(report.MaxInputAge, cycle.InputAge);
+        if (execution > m_period)
+            report.NumMisses++;
+        if (consecutive and m_last_start >= 0)
+        {
+            double interval = cycle.Start - m_last_start;
+            m_jitter.push_back(fabs(interval - m_period));
+            report.LongestStall = max(report.LongestStall, interval);
+        }
+        consecutive = true;
+        m_last_start = cycle.Start;
+        m_last_end = cycle.End;
+    }
+
+    if (report.NumCycles > 0)
+    {
+        report.MissRatio = static_cast<double>(report.NumMisses)/report.NumCycles;
+        report.MeanExecution = totalexecution/report.NumCycles;
+        report.MeanWait = totalwait/report.NumCycles;
+        report.MeanInputAge = totalage/report.NumCycles;
+    }
+    report.JitterMedian = percentile(m_jitter, 0.5);
+    report.Jitter95 = percentile(m_jitter, 0.95);
+    report.Jitter99 = percentile(m_jitter, 0.99);
+    if (m_last_end >= 0)
+    {
+        report.CurrentStall = max(now - m_last_end, 0.0);
+        report.LongestStall = max(report.LongestStall, report.CurrentStall);
+    }
+    return report;
+}
+
+/*! @brief Prints a one line summary of the report
+    @relates LatencyReport
+ */
+ostream& operator<<(ostream& output, const LatencyReport& report)
+{
+    output << report.Name << " cycles: " << report.NumCycles << " dropped: " << report.NumDropped;
+    output << " misses: " << report.NumMisses << " (" << 100*report.MissRatio << "% of " << report.Period << "ms)";
+    output << " execution: [mean:" << report.MeanExecution << " max:" << report.MaxExecution << "]";
+    output << " wait: " << report.MeanWait;
+    output << " jitter: [50%:" << report.JitterMedian << " 95%:" << report.Jitter95 << " 99%:" << report.Jitter99 << "]";
+    output << " stall: [longest:" << report.LongestStall << " current:" << report.CurrentStall << "]";
+    if (report.MaxInputAge > 0)
+        output << " input age: [mean:" << report.MeanInputAge << " max:" << report.MaxInputAge << "]";
+    return output;
+}
+
@@ -0,0 +1,116 @@
+/*! @file LatencyMonitor.h
+    @brief Declaration of a lock free monitor of the cycle times of a thread
+
+    @class LatencyMonitor
+    @brief Records the wait, start and end time of every cycle of a thread, so that another thread can check its deadlines.
+
+    The monitored thread calls markWait() before it blocks, markStart() when it wakes and markEnd() when it has
+    finished its work. Each finished cycle is written into a ring owned by the monitor. Only the monitored thread
+    writes to the ring, and only one other thread (the watchdog) reads from it, so neither thread ever takes a lock.
+    If the reader falls so far behind that the writer laps it the overwritten cycles are counted as dropped.
+
+    collect() drains the cycles recorded since the last call and summarises them into a LatencyReport; the number
+    of cycles that overran the period, the jitter of the period, the longest gap between cycles and how long the
+    thread has currently been stalled for.
+
+    @class LatencyReport
+    @brief A summary of the cycles of a thread over a period of time
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LATENCYMONITOR_H
+#define LATENCYMONITOR_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+class LatencyReport
+{
+public:
+    LatencyReport();
+
+    std::string Name;                   //!< the name of the monitored thread
+    double Period;                      //!< the period the thread is expected to run at in ms
+    int NumCycles;                      //!< the number of cycles in the report
+    int NumDropped;                     //!< the number of cycles that were overwritten before they could be collected
+    int NumMisses;                      //!< the number of cycles whose execution took longer than the period
+    double MissRatio;                   //!< the fraction of the cycles that missed their deadline
+    double MeanExecution;               //!< the mean time between the start and the end of a cycle in ms
+    double MaxExecution;                //!< the longest time between the start and the end of a cycle in ms
+    double MeanWait;                    //!< the mean time the thread was blocked waiting to start a cycle in ms
+    double JitterMedian;                //!< the median difference between the time between cycles and the period in ms
+    double Jitter95;                    //!< the 95th percentile of the difference between the time between cycles and the period in ms
+    double Jitter99;                    //!< the 99th percentile of the difference between the time between cycles and the period in ms
+    double LongestStall;                //!< the longest time between the start of two consecutive cycles in ms
+    double CurrentStall;                //!< the time since the last cycle finished in ms
+    double MeanInputAge;                //!< the mean age of the input to each cycle when it started in ms, or 0 if the thread does not provide it
+    double MaxInputAge;                 //!< the largest age of the input to a cycle when it started in ms
+};
+
+class LatencyMonitor
+{
+public:
+    LatencyMonitor(const std::string& name, double period, unsigned int capacity = 512);
+    ~LatencyMonitor();
+
+    void markWait();
+    void markStart(double inputage = 0);
+    void markEnd();
+    void addCycle(double waitstart, double start, double end, double inputage = 0);
+
+    LatencyReport collect();
+    LatencyReport collect(double now);
+
+    const std::string& getName() const {return m_name;}
+    double getPeriod() const {return m_period;}
+private:
+    struct Cycle
+    {
+        double WaitStart;               //!< the time the thread started waiting for this cycle
+        double Start;                   //!< the time the cycle started
+        double End;                     //!< the time the cycle finished
+        double InputAge;                //!< the age of the input to the cycle when it started
+    };
+    struct Slot
+    {
+        volatile unsigned int Sequence; //!< odd while the writer is filling the slot, 2*(index + 1) once cycle index is complete
+        Cycle Data;                     //!< the cycle
+    };
+private:
+    std::string m_name;                 //!< the name of the monitored thread
+    double m_period;                    //!< the period the thread is expected to run at in ms
+
+    // the writer's state, only touched by the monitored thread (except for m_head which is read by the reader)
+    Slot* m_slots;                      //!< the ring of recorded cycles
+    unsigned int m_capacity;            //!< the number of slots in the ring
+    volatile unsigned int m_head;       //!< the number of cycles ever written
+    Cycle m_current;                    //!< the cycle currently in progress
+
+    // the reader's state, only touched by the collecting thread
+    unsigned int m_tail;                //!< the number of cycles ever read (or dropped)
+    double m_last_start;                //!< the start of the last collected cycle, or a negative number if there has not been one
+    double m_last_end;                  //!< the end of the last collected cycle, or a negative number if there has not been one
+    std::vector<double> m_jitter;       //!< the jitter of each collected cycle
+};
+
+std::ostream& operator<<(std::ostream& output, const LatencyReport& report);
+
+#endif
+
@@ -0,0 +1,198 @@
+/*! @file StartupProfiler.cpp
+    @brief Implementation of a profiler of the phases of the NUbot's startup
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "StartupProfiler.h"
+
+#include <ctime>
+#include <iomanip>
+#include <algorithm>
+#ifndef __USE_POSIX199309               // the platform does not have clock_gettime, so boost is used (as in NUPlatform)
+    #include <boost/date_time/posix_time/posix_time.hpp>
+#endif
+using namespace std;
+
+/*! @brief Creates a profiler. The times of the phases are measured from when the profiler is created. */
+StartupProfiler::StartupProfiler()
+{
+    pthread_mutex_init(&m_mutex, NULL);
+    m_start_time = 0;
+    m_start_time = getTime();
+}
+
+StartupProfiler::~StartupProfiler()
+{
+    pthread_mutex_destroy(&m_mutex);
+}
+
+/*! @brief Marks the start of a phase
+    @param name the name of the phase
+    @param dependencies the names of the phases that had to finish before this one could start
+    @param thread the number of the thread the phase runs on
+ */
+void StartupProfiler::start(const string& name, const vector<string>& dependencies, int thread)
+{
+    Phase phase;
+    phase.Name = name;
+    phase.Dependencies = dependencies;
+    phase.Thread = thread;
+    phase.Start = getTime();
+    phase.End = -1;
+    pthread_mutex_lock(&m_mutex);
+    m_phases.push_back(phase);
+    pthread_mutex_unlock(&m_mutex);
+}
+
+/*! @brief Marks the end of a phase
+    @param name the name of the phase, which must have been started
+ */
+void StartupProfiler::finish(const string& name)
+{
+    double now = getTime();
+    pthread_mutex_lock(&m_mutex);
+    int index = find(name);
+    if (index >= 0)
+        m_phases[index].End = now;
+    pthread_mutex_unlock(&m_mutex);
+}
+
+/*! @brief Returns a copy of every phase, in the order they started */
+vector<StartupProfiler::Phase> StartupProfiler::getPhases() const
+{
+    pthread_mutex_lock(&m_mutex);
+    vector<Phase> phases = m_phases;
+    pthread_mutex_unlock(&m_mutex);
+    return phases;
+}
+
+/*! @brief Returns the critical path through the phases, in the order they ran.
+
+    The path ends with the phase that finished last. The phase before each phase on the path is the dependency
+    that finished last, because that is the one it was waiting for.
+ */
+vector<StartupProfiler::Phase> StartupProfiler::getCriticalPath() const
+{
+    vector<Phase> phases = getPhases();
+    vector<Phase> path;
+    int current = -1;
+    for (size_t i=0; i<phases.size(); i++)
+    {
+        if (phases[i].End >= 0 and (current < 0 or phases[i].End > phases[current].End))
+            current = i;
+    }
+    while (current >= 0)
+    {
+        path.push_back(phases[current]);
+        int next = -1;
+        const vector<string>& dependencies = phases[current].Dependencies;
+        for (size_t i=0; i<phases.size(); i++)
+        {
+            if (std::find(dependencies.begin(), dependencies.end(), phases[i].Name) != dependencies.end() and phases[i].End >= 0)
+            {
+                if (next < 0 or phases[i].End > phases[next].End)
+                    next = i;
+            }
+        }
+        current = next;
+    }
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+/*! @brief Returns the time from the creation of the profiler to the end of the last phase in ms */
+double StartupProfiler::getTotalTime() const
+{
+    vector<Phase> phases = getPhases();
+    double total = 0;
+    for (size_t i=0; i<phases.size(); i++)
+        total = max(total, phases[i].End);
+    return total;
+}
+
+/*! @brief Returns the current time in ms since the profiler was created */
+double StartupProfiler::getTime() const
+{
+    #ifdef __USE_POSIX199309
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return now.tv_sec*1e3 + now.tv_nsec/1e6 - m_start_time;
+    #else
+        static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+        return (boost::posix_time::microsec_clock::universal_time() - epoch).total_microseconds()/1e3 - m_start_time;
+    #endif
+}
+
+/*! @brief Returns the index of the phase with the given name, or -1 if there is no such phase. The mutex must be held. */
+int StartupProfiler::find(const string& name) const
+{
+    for (size_t i=0; i<m_phases.size(); i++)
+    {
+        if (m_phases[i].Name == name)
+            return i;
+    }
+    return -1;
+}
+
+/*! @brief Writes the startup report; every phase and then the critical path */
+ostream& operator<<(ostream& output, const StartupProfiler& profiler)
+{
+    vector<StartupProfiler::Phase> phases = profiler.getPhases();
+    vector<StartupProfiler::Phase> path = profiler.getCriticalPath();
+    int numthreads = 0;
+    double work = 0;
+    for (size_t i=0; i<phases.size(); i++)
+    {
+        numthreads = max(numthreads, phases[i].Thread + 1);
+        if (phases[i].End >= 0)
+            work += phases[i].End - phases[i].Start;
+    }
+
+    ios_base::fmtflags flags = output.flags();
+    streamsize precision = output.precision();
+    output << fixed << setprecision(1);
+    output << "Startup took " << profiler.getTotalTime() << " ms on " << numthreads << " threads. The phases took " << work << " ms altogether." << endl;
+    output << left << setw(24) << "Phase" << right << setw(8) << "Thread" << setw(10) << "Start" << setw(10) << "End" << setw(10) << "Duration" << "  Depends on" << endl;
+    for (size_t i=0; i<phases.size(); i++)
+    {
+        const StartupProfiler::Phase& phase = phases[i];
+        output << left << setw(24) << phase.Name << right << setw(8) << phase.Thread << setw(10) << phase.Start;
+        if (phase.End >= 0)
+            output << setw(10) << phase.End << setw(10) << phase.End - phase.Start;
+        else
+            output << setw(20) << "unfinished";
+        output << " ";
+        for (size_t j=0; j<phase.Dependencies.size(); j++)
+            output << " " << phase.Dependencies[j];
+        output << endl;
+    }
+
+    double waiting = 0;
+    output << "Critical path:";
+    for (size_t i=0; i<path.size(); i++)
+    {
+        waiting += path[i].Start - (i > 0 ? path[i-1].End : 0);
+        output << (i > 0 ? " ->" : "") << " " << path[i].Name << " (" << path[i].End - path[i].Start << " ms)";
+    }
+    output << ". " << waiting << " ms of the path was spent waiting for a thread." << endl;
+    output.flags(flags);
+    output.precision(precision);
+    return output;
+}
+
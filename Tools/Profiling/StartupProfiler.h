@@ -0,0 +1,71 @@
+/*! @file StartupProfiler.h
+    @brief Declaration of a profiler of the phases of the NUbot's startup
+
+    @class StartupProfiler
+    @brief Records when each phase of the startup started and finished, on which thread, and which phases it depended on.
+
+    The phases may run concurrently (see StartupScheduler), so start() and finish() can be called from any thread.
+    The report lists every phase, and the critical path: the chain of phases, each waiting on the one before it,
+    that decided how long the startup took. Only the phases on the critical path make the startup faster when
+    they are made faster.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include <pthread.h>
+#include <string>
+#include <vector>
+#include <iostream>
+
+class StartupProfiler
+{
+public:
+    struct Phase
+    {
+        std::string Name;                           //!< the name of the phase
+        std::vector<std::string> Dependencies;      //!< the names of the phases that had to finish before this one started
+        int Thread;                                 //!< the thread the phase ran on, 0 is the thread that created the profiler
+        double Start;                               //!< the time the phase started in ms since the profiler was created
+        double End;                                 //!< the time the phase finished in ms, or a negative number if it has not finished
+    };
+
+    StartupProfiler();
+    ~StartupProfiler();
+
+    void start(const std::string& name, const std::vector<std::string>& dependencies = std::vector<std::string>(), int thread = 0);
+    void finish(const std::string& name);
+
+    std::vector<Phase> getPhases() const;
+    std::vector<Phase> getCriticalPath() const;
+    double getTotalTime() const;
+
+    friend std::ostream& operator<<(std::ostream& output, const StartupProfiler& profiler);
+private:
+    double getTime() const;
+    int find(const std::string& name) const;
+private:
+    mutable pthread_mutex_t m_mutex;                //!< protects m_phases, which is written by every startup thread
+    std::vector<Phase> m_phases;                    //!< the phases in the order they started
+    double m_start_time;                            //!< the time the profiler was created in ms
+};
+
+#endif
+
@@ -21,6 +21,8 @@ ENDIF()
 
 ########## List your source files here! ############################################
 SET (YOUR_SRCS  Profiler.cpp Profiler.h
+		LatencyMonitor.cpp LatencyMonitor.h
+		StartupProfiler.cpp StartupProfiler.h
 )
 ####################################################################################
 ########## List your subdirectories here! ##########################################
@@ -0,0 +1,128 @@
+/*!  @file BoundedQueueThread.cpp
+     @brief Implementation of (abstract) BoundedQueueThread class.
+     
+     @author Jason Kulk
+ 
+ Copyright (c) 2011 Jason Kulk
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BoundedQueueThread.h"
+#include "debug.h"
+#include "debugverbositythreading.h"
+
+#include <sched.h>
+#include <sys/time.h>
+
+/*! @brief Creates a thread
+    @param name the name of the thread (used entirely for debug purposes)
+    @param priority the priority of the thread. If non-zero the thread will be a bona fide real-time thread.
+    @param capacity the maximum number of entries in the queue, rounded up to a power of two
+    @param policy what to do when data is pushed onto a full queue
+    @param mode how the thread waits for data
+    @param timeout the longest the thread waits for data in ms when the mode is TimedWait
+ */
+template <typename T>
+BoundedQueueThread<T>::BoundedQueueThread(std::string name, unsigned char priority, unsigned int capacity, OverflowPolicy policy, WaitMode mode, unsigned int timeout) : Thread(name, priority), m_queue(capacity, policy)
+{
+    #if DEBUG_THREADING_VERBOSITY > 1
+        debug << "BoundedQueueThread::BoundedQueueThread(" << m_name << ", " << static_cast<int>(m_priority) << ", " << m_queue.capacity() << ")" << std::endl;
+    #endif
+    m_wait_mode = mode;
+    m_timeout = timeout;
+    m_waiting = 0;
+
+    int err;
+    err = pthread_mutex_init(&m_condition_mutex, NULL);
+    if (err != 0)
+        errorlog << "BoundedQueueThread::BoundedQueueThread(" << m_name << ") Failed to create m_condition_mutex." << std::endl;
+    
+    err = pthread_cond_init(&m_condition, NULL);
+    if (err != 0)
+        errorlog << "BoundedQueueThread::BoundedQueueThread(" << m_name << ") Failed to create m_condition." << std::endl;
+}
+
+/*! @brief Stops the thread
+ */
+template <typename T>
+BoundedQueueThread<T>::~BoundedQueueThread()
+{
+    #if DEBUG_THREADING_VERBOSITY > 1
+        debug << "BoundedQueueThread::~BoundedQueueThread() " << m_name << " pushed: " << m_queue.getNumPushed() << " dropped: " << m_queue.getNumDropped() << " blocked: " << m_queue.getNumBlocked() << " high water mark: " << m_queue.getHighWaterMark() << std::endl;
+    #endif
+    stop();
+    pthread_cond_destroy(&m_condition);
+    pthread_mutex_destroy(&m_condition_mutex);
+}
+
+/*! @brief Adds new data to the thread's queue. This can be called from any number of threads at once.
+    @param newdata the data to add to the queue
+    @return true if the data was added, false if it was discarded because the queue was full
+ */
+template <typename T>
+bool BoundedQueueThread<T>::pushBack(const T& newdata)
+{
+    bool added = m_queue.push(newdata);
+    __sync_synchronize();
+    if (m_waiting)
+    {   // only take the lock when the consumer is actually asleep
+        pthread_mutex_lock(&m_condition_mutex);
+        pthread_cond_signal(&m_condition);
+        pthread_mutex_unlock(&m_condition_mutex);
+    }
+    return added;
+}
+
+/*! @brief Blocks this thread until there is data in the queue
+    @return true if there is data in the queue, false if the timeout expired first
+ */
+template <typename T>
+bool BoundedQueueThread<T>::waitForCondition()
+{
+    if (not m_queue.empty())
+        return true;
+
+    if (m_wait_mode == Spinning)
+    {
+        while (m_queue.empty())
+            sched_yield();
+        return true;
+    }
+
+    timespec deadline;
+    if (m_wait_mode == TimedWait)
+    {
+        timeval now;
+        gettimeofday(&now, NULL);
+        long nanoseconds = now.tv_usec*1000L + (m_timeout%1000)*1000000L;
+        deadline.tv_sec = now.tv_sec + m_timeout/1000 + nanoseconds/1000000000L;
+        deadline.tv_nsec = nanoseconds%1000000000L;
+    }
+
+    pthread_mutex_lock(&m_condition_mutex);
+    m_waiting = 1;
+    __sync_synchronize();                   // a producer either sees m_waiting, or we see its data
+    int err = 0;
+    while (m_queue.empty() and err == 0)
+    {
+        if (m_wait_mode == TimedWait)
+            err = pthread_cond_timedwait(&m_condition, &m_condition_mutex, &deadline);
+        else
+            pthread_cond_wait(&m_condition, &m_condition_mutex);
+    }
+    m_waiting = 0;
+    pthread_mutex_unlock(&m_condition_mutex);
+    return not m_queue.empty();
+}
@@ -0,0 +1,78 @@
+/*! @file BoundedQueueThread.h
+    @brief Declaration of (abstract) BoundedQueueThread class.
+
+    @class BoundedQueueThread 
+    @brief A QueueThread whose queue is a fixed size lock free ring.
+
+    This thread runs its main loop once for each piece of data pushed to it, exactly like a QueueThread.
+    However, the data is stored in a LockFreeQueue, so any number of threads can pushBack() at the same time
+    without taking a lock or allocating, and the consumer never contends with them. The consumer uses
+    waitForCondition(), m_queue.front() and m_queue.pop_front() just as it would with a QueueThread, so an
+    existing QueueThread can be switched over by changing its base class.
+
+    When the queue is full the data is discarded, the oldest data is discarded, or the producer yields until
+    there is room, depending on the OverflowPolicy. The consumer can block on a condition, spin, or block with
+    a timeout depending on the WaitMode.
+
+    @author Jason Kulk
+ 
+ Copyright (c) 2011 Jason Kulk
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BOUNDED_QUEUE_THREAD_H_DEFINED
+#define BOUNDED_QUEUE_THREAD_H_DEFINED
+
+#include "Thread.h"
+#include "LockFreeQueue.h"
+
+#include <string>
+#include <pthread.h>
+
+template <typename T>
+class BoundedQueueThread : public Thread
+{
+    public:
+        typedef typename LockFreeQueue<T>::OverflowPolicy OverflowPolicy;
+        enum WaitMode
+        {
+            Blocking,                           //!< the consumer sleeps on a condition until there is data
+            Spinning,                           //!< the consumer yields in a loop until there is data
+            TimedWait                           //!< the consumer sleeps on a condition until there is data, or the timeout expires
+        };
+    public:
+        BoundedQueueThread(std::string name, unsigned char priority, unsigned int capacity = 64, OverflowPolicy policy = LockFreeQueue<T>::DropNewest, WaitMode mode = Blocking, unsigned int timeout = 10);
+        virtual ~BoundedQueueThread();
+    
+        bool pushBack(const T& newdata);
+        const LockFreeQueue<T>& getQueue() const {return m_queue;}
+    
+    protected:
+        virtual void run() = 0;                // To be overridden by code to run.
+        bool waitForCondition();
+
+    protected:
+        WaitMode m_wait_mode;                  //!< how the consumer waits for data
+        unsigned int m_timeout;                //!< the longest the consumer waits in ms when m_wait_mode is TimedWait
+        pthread_mutex_t m_condition_mutex;     //!< lock for new data signal
+        pthread_cond_t m_condition;            //!< signal for new data
+        volatile int m_waiting;                //!< non-zero while the consumer is (about to be) asleep on m_condition
+    
+        LockFreeQueue<T> m_queue;              //!< the queue of the data for the thread
+};
+
+#include "BoundedQueueThread.cpp"               // this is the standard way to do template classes if when you separate declaration and implementation.
+                                                // just make sure that you don't compile BoundedQueueThread.cpp separately
+#endif
@@ -0,0 +1,215 @@
+/*! @file LockFreeQueue.cpp
+    @brief Implementation of a bounded lock free multi-producer single-consumer queue
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "LockFreeQueue.h"
+
+#include <sched.h>
+
+/*! @brief Creates an empty queue
+    @param capacity the maximum number of entries, this is rounded up to a power of two
+    @param policy what to do when something is pushed onto a full queue
+ */
+template <typename T>
+LockFreeQueue<T>::LockFreeQueue(unsigned int capacity, OverflowPolicy policy)
+{
+    unsigned int size = 2;
+    while (size < capacity)
+        size <<= 1;
+    m_cells = new Cell[size];
+    for (unsigned int i = 0; i < size; i++)
+        m_cells[i].Sequence = i;
+    m_mask = size - 1;
+    m_policy = policy;
+    m_write = 0;
+    m_read = 0;
+    m_has_front = false;
+
+    m_num_pushed = 0;
+    m_num_popped = 0;
+    m_num_dropped = 0;
+    m_num_blocked = 0;
+    m_high_water_mark = 0;
+}
+
+template <typename T>
+LockFreeQueue<T>::~LockFreeQueue()
+{
+    delete [] m_cells;
+}
+
+/*! @brief Adds data to the back of the queue. This can be called from any number of threads.
+    @param data the data
+    @return true if the data was added, false if it was discarded because the queue was full
+ */
+template <typename T>
+bool LockFreeQueue<T>::push(const T& data)
+{
+    bool blocked = false;
+    while (not tryPush(data))
+    {
+        if (m_policy == DropNewest)
+        {
+            __sync_fetch_and_add(&m_num_dropped, 1);
+            return false;
+        }
+        else if (m_policy == DropOldest)
+        {
+            T oldest;
+            if (tryPop(oldest))
+                __sync_fetch_and_add(&m_num_dropped, 1);
+        }
+        else
+        {
+            if (not blocked)
+                __sync_fetch_and_add(&m_num_blocked, 1);
+            blocked = true;
+            sched_yield();
+        }
+    }
+
+    __sync_fetch_and_add(&m_num_pushed, 1);
+    unsigned int occupancy = size();
+    unsigned int mark = m_high_water_mark;
+    while (occupancy > mark and not __sync_bool_compare_and_swap(&m_high_water_mark, mark, occupancy))
+        mark = m_high_water_mark;
+    return true;
+}
+
+/*! @brief Removes the entry at the front of the queue. Only call this from the consumer.
+    @param data will be set to the entry
+    @return true if there was an entry, false if the queue was empty
+ */
+template <typename T>
+bool LockFreeQueue<T>::pop(T& data)
+{
+    if (m_has_front)
+    {
+        data = m_front;
+        m_front = T();
+        m_has_front = false;
+    }
+    else if (not tryPop(data))
+        return false;
+    __sync_fetch_and_add(&m_num_popped, 1);
+    return true;
+}
+
+/*! @brief Returns true if the queue is empty. Only call this from the consumer. */
+template <typename T>
+bool LockFreeQueue<T>::empty()
+{
+    if (not m_has_front)
+        m_has_front = tryPop(m_front);
+    return not m_has_front;
+}
+
+/*! @brief Returns the entry at the front of the queue. Only call this from the consumer, and only when the queue is not empty.
+
+    The entry is moved out of the ring, so the reference remains valid (and the entry can not be discarded by
+    a producer) until pop_front() is called.
+ */
+template <typename T>
+T& LockFreeQueue<T>::front()
+{
+    empty();
+    return m_front;
+}
+
+/*! @brief Removes the entry at the front of the queue. Only call this from the consumer. */
+template <typename T>
+void LockFreeQueue<T>::pop_front()
+{
+    T discarded;
+    pop(discarded);
+}
+
+/*! @brief Returns the number of entries in the queue. If producers are pushing at the same time this is only approximate. */
+template <typename T>
+unsigned int LockFreeQueue<T>::size() const
+{
+    int count = static_cast<int>(m_write - m_read);
+    if (m_has_front)
+        count++;
+    if (count < 0)
+        return 0;
+    else
+        return static_cast<unsigned int>(count);
+}
+
+/*! @brief Tries to claim a free cell and fill it with data
+    @return false if the queue is full
+ */
+template <typename T>
+bool LockFreeQueue<T>::tryPush(const T& data)
+{
+    unsigned int position = m_write;
+    Cell* cell;
+    while (true)
+    {
+        cell = &m_cells[position & m_mask];
+        memoryBarrier();
+        int difference = static_cast<int>(cell->Sequence - position);
+        if (difference == 0)
+        {   // the cell is free, try to claim it
+            if (__sync_bool_compare_and_swap(&m_write, position, position + 1))
+                break;
+        }
+        else if (difference < 0)
+            return false;               // the cell still holds an entry from the previous lap, so we are full
+        position = m_write;
+    }
+
+    cell->Data = data;
+    memoryBarrier();
+    cell->Sequence = position + 1;
+    return true;
+}
+
+/*! @brief Tries to claim the oldest full cell and empty it
+    @return false if the queue is empty
+ */
+template <typename T>
+bool LockFreeQueue<T>::tryPop(T& data)
+{
+    unsigned int position = m_read;
+    Cell* cell;
+    while (true)
+    {
+        cell = &m_cells[position & m_mask];
+        memoryBarrier();
+        int difference = static_cast<int>(cell->Sequence - (position + 1));
+        if (difference == 0)
+        {   // the cell is full, try to claim it. Producers dropping the oldest entry compete with the consumer here
+            if (__sync_bool_compare_and_swap(&m_read, position, position + 1))
+                break;
+        }
+        else if (difference < 0)
+            return false;               // the cell has not been filled yet
+        position = m_read;
+    }
+
+    data = cell->Data;
+    cell->Data = T();
+    memoryBarrier();
+    cell->Sequence = position + m_mask + 1;
+    return true;
+}
+
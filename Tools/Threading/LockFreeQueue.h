@@ -0,0 +1,97 @@
+/*! @file LockFreeQueue.h
+    @brief Declaration of a bounded lock free multi-producer single-consumer queue
+
+    @class LockFreeQueue
+    @brief A fixed size queue that any number of threads can push to, and one thread can pop from, without locking.
+
+    The queue is a ring of preallocated cells, so pushing and popping never allocate. Each cell carries a
+    sequence number that says whether it is free for the producer that claimed it, or full and ready for the
+    consumer. Producers claim a cell by atomically incrementing the write position; the consumer does the same
+    with the read position, so a producer can also safely discard the oldest entry when the queue is full.
+
+    The consumer side also provides empty(), front(), pop_front() and size() so that it can be used in place
+    of the std::deque in a QueueThread.
+
+    The capacity is rounded up to a power of two.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOCKFREEQUEUE_H
+#define LOCKFREEQUEUE_H
+
+template <typename T>
+class LockFreeQueue
+{
+public:
+    enum OverflowPolicy
+    {
+        DropNewest,             //!< when the queue is full the new data is discarded
+        DropOldest,             //!< when the queue is full the oldest data is discarded to make room
+        Block                   //!< when the queue is full the producer yields until there is room
+    };
+public:
+    LockFreeQueue(unsigned int capacity, OverflowPolicy policy = DropNewest);
+    ~LockFreeQueue();
+
+    bool push(const T& data);
+    bool pop(T& data);
+
+    bool empty();
+    T& front();
+    void pop_front();
+    unsigned int size() const;
+
+    unsigned int capacity() const {return m_mask + 1;}
+    OverflowPolicy getOverflowPolicy() const {return m_policy;}
+    unsigned int getNumPushed() const {return m_num_pushed;}
+    unsigned int getNumPopped() const {return m_num_popped;}
+    unsigned int getNumDropped() const {return m_num_dropped;}
+    unsigned int getNumBlocked() const {return m_num_blocked;}
+    unsigned int getHighWaterMark() const {return m_high_water_mark;}
+private:
+    bool tryPush(const T& data);
+    bool tryPop(T& data);
+    static void memoryBarrier() {__sync_synchronize();}
+private:
+    struct Cell
+    {
+        volatile unsigned int Sequence; //!< equals the write position when the cell is free, and the write position + 1 once it is full
+        T Data;                         //!< the data in the cell
+    };
+
+    Cell* m_cells;                      //!< the ring of cells
+    unsigned int m_mask;                //!< the capacity - 1, used to turn a position into an index
+    OverflowPolicy m_policy;            //!< what to do when the queue is full
+    volatile unsigned int m_write;      //!< the number of cells ever claimed by producers
+    volatile unsigned int m_read;       //!< the number of cells ever claimed by the consumer (or discarded)
+
+    T m_front;                          //!< the entry taken out of the ring by front(), until it is removed by pop_front()
+    bool m_has_front;                   //!< true if m_front holds the front of the queue
+
+    volatile unsigned int m_num_pushed;         //!< the number of entries pushed
+    volatile unsigned int m_num_popped;         //!< the number of entries popped by the consumer
+    volatile unsigned int m_num_dropped;        //!< the number of entries discarded because the queue was full
+    volatile unsigned int m_num_blocked;        //!< the number of pushes that had to wait for room
+    volatile unsigned int m_high_water_mark;    //!< the largest number of entries that have been in the queue at once
+};
+
+#include "LockFreeQueue.cpp"                    // this is the standard way to do template classes if when you separate declaration and implementation.
+                                                // just make sure that you don't compile LockFreeQueue.cpp separately
+#endif
+
@@ -0,0 +1,187 @@
+/*! @file SnapshotBuffer.cpp
+    @brief Implementation of a versioned, multi-buffered snapshot of data shared between threads
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SnapshotBuffer.h"
+
+#include <sched.h>
+
+/*! @brief Creates a buffer whose current copy is a default constructed T with version 0
+    @param numbuffers the number of copies in the pool. At least two are needed, and each reader that holds on to
+                      an old Snapshot while a newer one is published ties up another one.
+ */
+template <typename T>
+SnapshotBuffer<T>::SnapshotBuffer(unsigned int numbuffers)
+{
+    m_num_slots = numbuffers < 2 ? 2 : numbuffers;
+    m_slots = new Slot[m_num_slots];
+    for (unsigned int i = 0; i < m_num_slots; i++)
+    {
+        m_slots[i].Pins = 0;
+        m_slots[i].Version = 0;
+    }
+    m_current = &m_slots[0];
+    m_back = 0;
+    m_write_lock = 0;
+    m_version = 0;
+
+    m_num_writer_waits = 0;
+    m_num_reader_retries = 0;
+}
+
+/*! @brief Destroys the buffer. There must not be any Snapshots left */
+template <typename T>
+SnapshotBuffer<T>::~SnapshotBuffer()
+{
+    delete [] m_slots;
+}
+
+/*! @brief Starts a write, and returns the back buffer to be filled. The back buffer holds an older version of the data, which
+           the writer is expected to overwrite. Other writers are blocked until publish() is called.
+ */
+template <typename T>
+T& SnapshotBuffer<T>::beginWrite()
+{
+    while (__sync_lock_test_and_set(&m_write_lock, 1))
+        sched_yield();
+
+    bool waited = false;
+    while (true)
+    {
+        for (unsigned int i = 0; i < m_num_slots; i++)
+        {
+            Slot* slot = &m_slots[i];
+            if (slot != m_current and slot->Pins == 0)
+            {
+                m_back = slot;
+                if (waited)
+                    __sync_fetch_and_add(&m_num_writer_waits, 1);
+                return slot->Data;
+            }
+        }
+        waited = true;                          // every spare copy is pinned by a reader, so wait for one to be released
+        sched_yield();
+    }
+}
+
+/*! @brief Publishes the back buffer filled since beginWrite(), so that it becomes the copy that readers pin
+    @return the version of the published data
+ */
+template <typename T>
+unsigned int SnapshotBuffer<T>::publish()
+{
+    unsigned int version = m_version + 1;
+    m_back->Version = version;
+    __sync_synchronize();                       // the data has to be complete before the copy can be seen by readers
+    m_current = m_back;
+    m_version = version;
+    m_back = 0;
+    __sync_lock_release(&m_write_lock);
+    return version;
+}
+
+/*! @brief Copies data into the back buffer and publishes it
+    @return the version of the published data
+ */
+template <typename T>
+unsigned int SnapshotBuffer<T>::publish(const T& data)
+{
+    beginWrite() = data;
+    return publish();
+}
+
+/*! @brief Pins the current copy. This can be called from any number of threads, and never waits for a writer.
+    @return a Snapshot of the most recently published data
+ */
+template <typename T>
+typename SnapshotBuffer<T>::Snapshot SnapshotBuffer<T>::pin()
+{
+    while (true)
+    {
+        Slot* slot = m_current;
+        __sync_fetch_and_add(&slot->Pins, 1);
+        if (slot == m_current)                  // a writer will not pick a copy that is current, or one that is pinned
+            return Snapshot(slot);
+        __sync_fetch_and_sub(&slot->Pins, 1);   // a writer published while the copy was being pinned, so it may be rewritten
+        __sync_fetch_and_add(&m_num_reader_retries, 1);
+    }
+}
+
+/*! @brief Returns the version of the most recently published data */
+template <typename T>
+unsigned int SnapshotBuffer<T>::getVersion() const
+{
+    return m_version;
+}
+
+/*! @brief Returns true if data newer than the given version has been published */
+template <typename T>
+bool SnapshotBuffer<T>::changedSince(unsigned int version) const
+{
+    return static_cast<int>(m_version - version) > 0;
+}
+
+/*! @brief Creates an empty Snapshot */
+template <typename T>
+SnapshotBuffer<T>::Snapshot::Snapshot() : m_slot(0)
+{
+}
+
+/*! @brief Creates a Snapshot of a copy that has already been pinned by SnapshotBuffer::pin() */
+template <typename T>
+SnapshotBuffer<T>::Snapshot::Snapshot(Slot* slot) : m_slot(slot)
+{
+}
+
+/*! @brief Creates another Snapshot of the same copy. The copy stays pinned until both have been released */
+template <typename T>
+SnapshotBuffer<T>::Snapshot::Snapshot(const Snapshot& other) : m_slot(other.m_slot)
+{
+    if (m_slot != 0)
+        __sync_fetch_and_add(&m_slot->Pins, 1);
+}
+
+template <typename T>
+typename SnapshotBuffer<T>::Snapshot& SnapshotBuffer<T>::Snapshot::operator=(const Snapshot& other)
+{
+    if (other.m_slot != 0)
+        __sync_fetch_and_add(&other.m_slot->Pins, 1);
+    release();
+    m_slot = other.m_slot;
+    return *this;
+}
+
+template <typename T>
+SnapshotBuffer<T>::Snapshot::~Snapshot()
+{
+    release();
+}
+
+/*! @brief Releases the copy, so that writers can reuse it. The Snapshot is empty afterwards */
+template <typename T>
+void SnapshotBuffer<T>::Snapshot::release()
+{
+    if (m_slot != 0)
+    {
+        __sync_fetch_and_sub(&m_slot->Pins, 1);
+        m_slot = 0;
+    }
+}
+
@@ -0,0 +1,104 @@
+/*! @file SnapshotBuffer.h
+    @brief Declaration of a versioned, multi-buffered snapshot of data shared between threads
+
+    @class SnapshotBuffer
+    @brief Publishes complete copies of data from writer threads to any number of reader threads without locking.
+
+    The buffer holds a small pool of copies of the data. A writer fills a copy that no reader is using (the back
+    buffer), and then publishes it by atomically making it the current copy, along with a new version number.
+    A reader pins the current copy with pin(), and gets a Snapshot that can not be changed by the writers until
+    the last Snapshot of it has been released. Pinning does not lock; it increments the copy's pin count and then
+    checks that the copy is still the current one, backing off and trying again if a writer published in between.
+
+    So readers always see a complete, consistent copy, and neither side ever waits for the other, provided there
+    are fewer readers holding old snapshots than there are spare copies. If every spare copy is pinned the writer
+    yields until one is released. Writers are serialised with a spin lock.
+
+    The data is copied into the back buffer with its assignment operator, so types like std::vector reuse their
+    memory once the pool has warmed up.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SNAPSHOTBUFFER_H
+#define SNAPSHOTBUFFER_H
+
+template <typename T>
+class SnapshotBuffer
+{
+private:
+    struct Slot
+    {
+        T Data;                             //!< the copy of the data
+        volatile int Pins;                  //!< the number of Snapshots of this copy that have not been released
+        volatile unsigned int Version;      //!< the version of the data in this copy
+    };
+public:
+    /*! @brief A pinned, read only copy of the data. The copy stays valid and unchanged until the Snapshot is released or destroyed */
+    class Snapshot
+    {
+    public:
+        Snapshot();
+        Snapshot(const Snapshot& other);
+        Snapshot& operator=(const Snapshot& other);
+        ~Snapshot();
+
+        void release();
+        bool valid() const {return m_slot != 0;}
+        const T& operator*() const {return m_slot->Data;}
+        const T* operator->() const {return &m_slot->Data;}
+        unsigned int getVersion() const {return m_slot->Version;}
+    private:
+        friend class SnapshotBuffer<T>;
+        explicit Snapshot(Slot* slot);
+        Slot* m_slot;                       //!< the pinned copy, or 0 if the Snapshot is empty
+    };
+public:
+    SnapshotBuffer(unsigned int numbuffers = 4);
+    ~SnapshotBuffer();
+
+    T& beginWrite();
+    unsigned int publish();
+    unsigned int publish(const T& data);
+
+    Snapshot pin();
+    unsigned int getVersion() const;
+    bool changedSince(unsigned int version) const;
+
+    unsigned int getNumBuffers() const {return m_num_slots;}
+    unsigned int getNumWriterWaits() const {return m_num_writer_waits;}
+    unsigned int getNumReaderRetries() const {return m_num_reader_retries;}
+private:
+    SnapshotBuffer(const SnapshotBuffer& other);
+    SnapshotBuffer& operator=(const SnapshotBuffer& other);
+private:
+    Slot* m_slots;                                  //!< the pool of copies
+    unsigned int m_num_slots;                       //!< the number of copies in the pool
+    Slot* volatile m_current;                       //!< the copy readers pin
+    Slot* m_back;                                   //!< the copy being written, or 0 if there is no write in progress
+    volatile int m_write_lock;                      //!< spin lock held from beginWrite() to publish()
+    volatile unsigned int m_version;                //!< the version of the current copy
+
+    volatile unsigned int m_num_writer_waits;       //!< the number of times a writer had to wait for a copy to be released
+    volatile unsigned int m_num_reader_retries;     //!< the number of times a reader had to try again because a writer published while it was pinning
+};
+
+#include "SnapshotBuffer.cpp"                       // this is the standard way to do template classes if when you separate declaration and implementation.
+                                                    // just make sure that you don't compile SnapshotBuffer.cpp separately
+#endif
+
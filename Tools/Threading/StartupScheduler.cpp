@@ -0,0 +1,213 @@
+/*! @file StartupScheduler.cpp
+    @brief Implementation of a scheduler that creates the NUbot's subsystems concurrently
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "StartupScheduler.h"
+#include "ThreadPlacement.h"
+#include "Tools/Profiling/StartupProfiler.h"
+
+#include "debug.h"
+#include "debugverbositythreading.h"
+
+#include <algorithm>
+using namespace std;
+
+/*! @brief Creates a scheduler with no tasks
+    @param profiler the profiler in which each task is recorded
+ */
+StartupScheduler::StartupScheduler(StartupProfiler* profiler)
+{
+    m_profiler = profiler;
+    m_num_finished = 0;
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_cond_init(&m_task_finished, NULL);
+}
+
+StartupScheduler::~StartupScheduler()
+{
+    for (size_t i=0; i<m_tasks.size(); i++)
+        delete m_tasks[i];
+    pthread_cond_destroy(&m_task_finished);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+/*! @brief Runs every task, and returns when they have all finished
+    @param numthreads the number of threads to run the tasks on, including the calling thread
+    @return false if the tasks could not be run because a dependency does not exist or the dependencies have a cycle
+ */
+bool StartupScheduler::run(unsigned int numthreads)
+{
+    if (not resolveDependencies())
+        return false;
+
+    numthreads = max(min(numthreads, static_cast<unsigned int>(m_tasks.size())), 1u);
+    #if DEBUG_THREADING_VERBOSITY > 0
+        debug << "StartupScheduler::run(). Running " << m_tasks.size() << " tasks on " << numthreads << " threads." << endl;
+    #endif
+
+    vector<Worker> workers(numthreads);
+    vector<pthread_t> threads;
+    for (unsigned int i=1; i<numthreads; i++)
+    {
+        workers[i].Scheduler = this;
+        workers[i].Number = i;
+        pthread_t thread;
+        int err = pthread_create(&thread, NULL, runWorker, &workers[i]);
+        if (err != 0)
+        {   // the remaining threads are not needed for the tasks to finish, just for them to finish sooner
+            errorlog << "StartupScheduler::run(). Failed to create a StartupThread. The error code was: " << err << endl;
+            break;
+        }
+        ThreadPlacement::apply(thread, "StartupThread", 0);
+        threads.push_back(thread);
+    }
+
+    work(0);
+    for (size_t i=0; i<threads.size(); i++)
+        pthread_join(threads[i], NULL);
+    return true;
+}
+
+/*! @brief Adds a task, and takes ownership of it */
+void StartupScheduler::add(Task* task)
+{
+    m_tasks.push_back(task);
+}
+
+/*! @brief Returns the names in a list separated by spaces or commas */
+vector<string> StartupScheduler::parseDependencies(const string& dependencies)
+{
+    vector<string> names;
+    size_t start = dependencies.find_first_not_of(" ,");
+    while (start != string::npos)
+    {
+        size_t end = dependencies.find_first_of(" ,", start);
+        names.push_back(dependencies.substr(start, end - start));
+        start = dependencies.find_first_not_of(" ,", end);
+    }
+    return names;
+}
+
+/*! @brief Finds the tasks that depend on each task, and checks every task can be run
+    @return false if a task depends on a task that was not added, or if the dependencies have a cycle
+ */
+bool StartupScheduler::resolveDependencies()
+{
+    size_t numtasks = m_tasks.size();
+    m_dependents.assign(numtasks, vector<int>());
+    m_num_waiting_on.assign(numtasks, 0);
+    m_started.assign(numtasks, false);
+    m_num_finished = 0;
+
+    for (size_t i=0; i<numtasks; i++)
+    {
+        const vector<string>& dependencies = m_tasks[i]->Dependencies;
+        for (size_t j=0; j<dependencies.size(); j++)
+        {
+            size_t k = 0;
+            while (k < numtasks and m_tasks[k]->Name != dependencies[j])
+                k++;
+            if (k == numtasks)
+            {
+                errorlog << "StartupScheduler::resolveDependencies(). " << m_tasks[i]->Name << " depends on " << dependencies[j] << ", which is not a task." << endl;
+                return false;
+            }
+            m_dependents[k].push_back(i);
+            m_num_waiting_on[i]++;
+        }
+    }
+
+    // the tasks can all be run only if removing the tasks with nothing to wait on, one at a time, removes them all
+    vector<int> waiting = m_num_waiting_on;
+    vector<int> ready;
+    for (size_t i=0; i<numtasks; i++)
+    {
+        if (waiting[i] == 0)
+            ready.push_back(i);
+    }
+    for (size_t i=0; i<ready.size(); i++)
+    {
+        const vector<int>& dependents = m_dependents[ready[i]];
+        for (size_t j=0; j<dependents.size(); j++)
+        {
+            if (--waiting[dependents[j]] == 0)
+                ready.push_back(dependents[j]);
+        }
+    }
+    if (ready.size() < numtasks)
+    {
+        errorlog << "StartupScheduler::resolveDependencies(). The dependencies of";
+        for (size_t i=0; i<numtasks; i++)
+        {
+            if (waiting[i] > 0)
+                errorlog << " " << m_tasks[i]->Name;
+        }
+        errorlog << " have a cycle." << endl;
+        return false;
+    }
+    return true;
+}
+
+/*! @brief Runs the first task that is ready, until there are no tasks left
+    @param thread the number of the calling thread in the profile
+ */
+void StartupScheduler::work(int thread)
+{
+    pthread_mutex_lock(&m_mutex);
+    while (m_num_finished < m_tasks.size())
+    {
+        size_t next = 0;
+        while (next < m_tasks.size() and (m_started[next] or m_num_waiting_on[next] > 0))
+            next++;
+        if (next == m_tasks.size())
+        {   // every task that has not been started is waiting on a task that is running on another thread
+            pthread_cond_wait(&m_task_finished, &m_mutex);
+            continue;
+        }
+        m_started[next] = true;
+        pthread_mutex_unlock(&m_mutex);
+
+        Task* task = m_tasks[next];
+        #if DEBUG_THREADING_VERBOSITY > 1
+            debug << "StartupScheduler::work(" << thread << "). Starting " << task->Name << endl;
+        #endif
+        m_profiler->start(task->Name, task->Dependencies, thread);
+        task->run();
+        m_profiler->finish(task->Name);
+
+        pthread_mutex_lock(&m_mutex);
+        m_num_finished++;
+        const vector<int>& dependents = m_dependents[next];
+        for (size_t i=0; i<dependents.size(); i++)
+            m_num_waiting_on[dependents[i]]--;
+        pthread_cond_broadcast(&m_task_finished);
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
+
+/*! @brief The entry point of each StartupThread */
+void* StartupScheduler::runWorker(void* worker)
+{
+    ThreadPlacement::prefaultStack();
+    Worker* w = reinterpret_cast<Worker*>(worker);
+    w->Scheduler->work(w->Number);
+    return NULL;
+}
+
@@ -0,0 +1,110 @@
+/*! @file StartupScheduler.h
+    @brief Declaration of a scheduler that creates the NUbot's subsystems concurrently
+
+    @class StartupScheduler
+    @brief Runs a set of startup tasks, each after the tasks it depends on, on a small pool of threads.
+
+    Each task is a method of an object with no arguments, for example NUbot::createVision. The tasks are started
+    in the order they were added, as soon as all of their dependencies have finished, so tasks that do not depend
+    on each other (e.g. loading the LUT and creating the platform) run at the same time. The calling thread is one
+    of the threads, so with one thread the tasks run one after another in the order they were added, exactly as
+    they did before there was a scheduler. Each task is recorded in the StartupProfiler.
+
+    The scheduler does not protect anything the tasks share. Only tasks that are independent may be left without
+    a dependency between them.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef STARTUPSCHEDULER_H
+#define STARTUPSCHEDULER_H
+
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+class StartupProfiler;
+
+class StartupScheduler
+{
+public:
+    StartupScheduler(StartupProfiler* profiler);
+    ~StartupScheduler();
+
+    /*! @brief Adds a task to the scheduler
+        @param name the name of the task, which is used in the profile and in the dependencies of other tasks
+        @param object the object whose method is the task
+        @param method the method to call
+        @param dependencies the names of the tasks that must finish before this one starts, separated by spaces or commas
+     */
+    template<typename T> void add(const std::string& name, T* object, void (T::*method)(), const std::string& dependencies = "")
+    {
+        add(new MethodTask<T>(name, parseDependencies(dependencies), object, method));
+    }
+
+    bool run(unsigned int numthreads);
+private:
+    /*! @brief A task; the base of MethodTask so that tasks of every type can be kept in one list */
+    class Task
+    {
+    public:
+        Task(const std::string& name, const std::vector<std::string>& dependencies) : Name(name), Dependencies(dependencies) {};
+        virtual ~Task() {};
+        virtual void run() = 0;
+    public:
+        std::string Name;                           //!< the name of the task
+        std::vector<std::string> Dependencies;      //!< the names of the tasks that must finish before this one starts
+    };
+
+    /*! @brief A task that calls a method of an object */
+    template<typename T> class MethodTask : public Task
+    {
+    public:
+        MethodTask(const std::string& name, const std::vector<std::string>& dependencies, T* object, void (T::*method)()) : Task(name, dependencies), m_object(object), m_method(method) {};
+        void run() {(m_object->*m_method)();}
+    private:
+        T* m_object;                                //!< the object
+        void (T::*m_method)();                      //!< the method of the object to call
+    };
+
+    /*! @brief The argument of each StartupThread */
+    struct Worker
+    {
+        StartupScheduler* Scheduler;                //!< the scheduler the worker takes its tasks from
+        int Number;                                 //!< the number of the worker's thread in the profile
+    };
+
+    void add(Task* task);
+    static std::vector<std::string> parseDependencies(const std::string& dependencies);
+    bool resolveDependencies();
+    void work(int thread);
+    static void* runWorker(void* worker);
+private:
+    StartupProfiler* m_profiler;                    //!< the profiler in which each task is recorded
+    std::vector<Task*> m_tasks;                     //!< the tasks in the order they were added
+    std::vector<std::vector<int> > m_dependents;    //!< the indices of the tasks that depend on each task
+    std::vector<int> m_num_waiting_on;              //!< the number of unfinished dependencies of each task
+    std::vector<bool> m_started;                    //!< true for each task that has been started
+    unsigned int m_num_finished;                    //!< the number of tasks that have finished
+
+    pthread_mutex_t m_mutex;                        //!< protects the state of the tasks
+    pthread_cond_t m_task_finished;                 //!< signalled when a task finishes, and so other tasks may be ready
+};
+
+#endif
+
@@ -20,6 +20,7 @@
  */
 
 #include "Thread.h"
+#include "ThreadPlacement.h"
 #include "debug.h"
 #include "debugverbositythreading.h"
 
@@ -66,25 +67,8 @@ int Thread::start()
         return -1;
     }
     
-    if (m_priority > 0)
-    {   // if the priority is non-zero then we create the thread as a bona fide real-time thread with the given priority
-        sched_param param;
-        param.sched_priority = m_priority;
-        pthread_setschedparam(m_pthread, SCHED_FIFO, &param);            // Note. This will fail (quietly) if the underlying OS doesn't allow real-time
-        
-        // double check
-        int actualpolicy;
-        sched_param actualparam;
-        pthread_getschedparam(m_pthread, &actualpolicy, &actualparam);
-        #if DEBUG_THREADING_VERBOSITY > 0
-            debug << "Thread::start(). " << m_name << " Policy: " << actualpolicy << " Priority: " << actualparam.sched_priority << endl;
-        #endif
-        if (actualpolicy != SCHED_FIFO)
-            debug << "Thread::start(). " << m_name << ". Warning your thread does not have the correct policy." << endl;
-        
-        if (actualparam.sched_priority != m_priority)
-            debug << "Thread::start(). " << m_name << ". Warning your thread does not have the correct priority." << endl;
-    }
+    // the policy, priority and cpus come from the thread placement configuration, otherwise a non-zero priority makes this a bona fide real-time thread
+    ThreadPlacement::apply(m_pthread, m_name, m_priority);
 
 	return 0;
 }
@@ -111,6 +95,7 @@ void Thread::stop()
  */
 void* Thread::runThread(void* thread)
 {
+    ThreadPlacement::prefaultStack();
 	reinterpret_cast<Thread*>(thread)->run();
     pthread_exit(NULL);
     return thread;
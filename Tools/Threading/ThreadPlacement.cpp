@@ -0,0 +1,263 @@
+/*! @file ThreadPlacement.cpp
+    @brief Implementation of the thread placement configuration
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ThreadPlacement.h"
+#include "targetconfig.h"
+#include "debug.h"
+#include "debugverbositythreading.h"
+
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <errno.h>
+#ifndef TARGET_OS_IS_WINDOWS
+    #include <sched.h>
+    #include <alloca.h>
+    #include <sys/mman.h>
+#endif
+using namespace std;
+
+vector<ThreadPlacement::Placement> ThreadPlacement::m_placements;
+bool ThreadPlacement::m_lock_memory = false;
+unsigned int ThreadPlacement::m_prefault_stack = 0;
+unsigned int ThreadPlacement::m_startup_threads = 1;
+
+/*! @brief Loads the thread placement from a file. Any previously loaded placement is discarded.
+    @param filename the name of the file
+    @return true if the file was loaded, false if it could not be opened, in which case every thread keeps its default placement
+ */
+bool ThreadPlacement::load(const string& filename)
+{
+    ifstream file(filename.c_str());
+    if (not file.is_open())
+    {
+        #if DEBUG_THREADING_VERBOSITY > 0
+            debug << "ThreadPlacement::load(). Unable to open " << filename << ". All threads will use their default placement." << endl;
+        #endif
+        clear();
+        return false;
+    }
+    return load(file);
+}
+
+/*! @brief Loads the thread placement from a stream. Any previously loaded placement is discarded. Lines that can not be parsed are ignored.
+    @param input the stream
+    @return true
+ */
+bool ThreadPlacement::load(istream& input)
+{
+    clear();
+    string line;
+    while (getline(input, line))
+    {
+        size_t colon = line.find(':');
+        if (line.empty() or line[0] == '#' or colon == string::npos)
+            continue;
+        string name = line.substr(0, colon);
+        string value = line.substr(colon + 1);
+        name.erase(name.find_last_not_of(" \t\r") + 1);
+
+        if (name == "LockMemory")
+            m_lock_memory = atoi(value.c_str()) != 0;
+        else if (name == "PrefaultStack")
+            m_prefault_stack = max(atoi(value.c_str()), 0);
+        else if (name == "StartupThreads")
+            m_startup_threads = max(atoi(value.c_str()), 1);
+        else
+        {
+            Placement placement;
+            if (parsePlacement(name, value, placement))
+                m_placements.push_back(placement);
+            else
+                errorlog << "ThreadPlacement::load(). Unable to parse the placement of " << name << ": " << value << endl;
+        }
+    }
+    #if DEBUG_THREADING_VERBOSITY > 0
+        debug << "ThreadPlacement::load(). Loaded " << m_placements.size() << " thread placements. LockMemory: " << m_lock_memory << " PrefaultStack: " << m_prefault_stack << " StartupThreads: " << m_startup_threads << endl;
+    #endif
+    return true;
+}
+
+/*! @brief Discards the loaded placement, so every thread uses its default placement */
+void ThreadPlacement::clear()
+{
+    m_placements.clear();
+    m_lock_memory = false;
+    m_prefault_stack = 0;
+    m_startup_threads = 1;
+}
+
+/*! @brief Parses a placement of the form 'POLICY priority [cpu, cpu]' */
+bool ThreadPlacement::parsePlacement(const string& name, const string& value, Placement& placement)
+{
+    placement.Name = name;
+    istringstream stream(value);
+    string policy;
+    stream >> policy >> placement.Priority;
+    if (stream.fail())
+        return false;
+
+    if (policy == "FIFO")
+        placement.SchedulingPolicy = FIFO;
+    else if (policy == "RR")
+        placement.SchedulingPolicy = RoundRobin;
+    else if (policy == "OTHER")
+        placement.SchedulingPolicy = Other;
+    else
+        return false;
+
+    string cpus;
+    getline(stream, cpus);
+    for (size_t i = 0; i < cpus.size(); i++)
+    {
+        if (cpus[i] == '[' or cpus[i] == ']' or cpus[i] == ',')
+            cpus[i] = ' ';
+    }
+    istringstream cpustream(cpus);
+    int cpu;
+    while (cpustream >> cpu)
+        placement.Cpus.push_back(cpu);
+    return true;
+}
+
+/*! @brief Returns true if the thread name matches the pattern */
+bool ThreadPlacement::matches(const string& pattern, const string& name)
+{
+    if (not pattern.empty() and pattern[0] == '*')
+    {
+        size_t length = pattern.size() - 1;
+        return name.size() >= length and name.compare(name.size() - length, length, pattern, 1, length) == 0;
+    }
+    else
+        return pattern == name;
+}
+
+/*! @brief Returns the placement for a thread
+    @param name the name of the thread
+    @param defaultpriority the priority given to the thread in code, used when the thread is not configured
+ */
+ThreadPlacement::Placement ThreadPlacement::find(const string& name, unsigned char defaultpriority)
+{
+    for (size_t i = 0; i < m_placements.size(); i++)
+    {
+        if (matches(m_placements[i].Name, name))
+            return m_placements[i];
+    }
+
+    Placement placement;
+    placement.Name = name;
+    placement.SchedulingPolicy = defaultpriority > 0 ? FIFO : Other;
+    placement.Priority = defaultpriority;
+    return placement;
+}
+
+/*! @brief Sets the scheduling policy, priority and cpu affinity of a thread from its placement.
+
+    If the real-time policy can not be set (usually because we are not root) the thread is left with the normal
+    policy, and a warning is written to the errorlog.
+
+    @param thread the thread
+    @param name the name of the thread
+    @param defaultpriority the priority given to the thread in code
+ */
+void ThreadPlacement::apply(pthread_t thread, const string& name, unsigned char defaultpriority)
+{
+    Placement placement = find(name, defaultpriority);
+    if (placement.Priority != defaultpriority)
+        debug << "ThreadPlacement::apply(). The placement of " << name << " overrides its priority of " << static_cast<int>(defaultpriority) << " in code with " << placement.Priority << "." << endl;
+
+    #ifndef TARGET_OS_IS_WINDOWS
+        if (placement.SchedulingPolicy != Other or placement.Priority != 0)
+        {
+            int policy = SCHED_OTHER;
+            if (placement.SchedulingPolicy == FIFO)
+                policy = SCHED_FIFO;
+            else if (placement.SchedulingPolicy == RoundRobin)
+                policy = SCHED_RR;
+            sched_param param;
+            param.sched_priority = placement.Priority;
+            int err = pthread_setschedparam(thread, policy, &param);
+            if (err != 0)
+                errorlog << "ThreadPlacement::apply(). Unable to set " << name << " to policy " << policy << " priority " << placement.Priority << ": " << strerror(err) << ". It will run with the normal policy." << endl;
+
+            // double check
+            int actualpolicy;
+            sched_param actualparam;
+            pthread_getschedparam(thread, &actualpolicy, &actualparam);
+            #if DEBUG_THREADING_VERBOSITY > 0
+                debug << "ThreadPlacement::apply(). " << name << " Policy: " << actualpolicy << " Priority: " << actualparam.sched_priority << endl;
+            #endif
+            if (actualpolicy != policy)
+                debug << "ThreadPlacement::apply(). " << name << ". Warning your thread does not have the correct policy." << endl;
+            if (actualparam.sched_priority != placement.Priority)
+                debug << "ThreadPlacement::apply(). " << name << ". Warning your thread does not have the correct priority." << endl;
+        }
+    #endif
+
+    #ifdef TARGET_OS_IS_LINUX
+        if (not placement.Cpus.empty())
+        {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            for (size_t i = 0; i < placement.Cpus.size(); i++)
+                CPU_SET(placement.Cpus[i], &cpus);
+            int err = pthread_setaffinity_np(thread, sizeof(cpus), &cpus);
+            if (err != 0)
+                errorlog << "ThreadPlacement::apply(). Unable to set the cpu affinity of " << name << ": " << strerror(err) << endl;
+        }
+    #endif
+}
+
+/*! @brief Touches the configured amount of the calling thread's stack, so that those pages are mapped before the thread does any real work */
+void ThreadPlacement::prefaultStack()
+{
+    #ifndef TARGET_OS_IS_WINDOWS
+        if (m_prefault_stack > 0)
+        {
+            volatile char* stack = static_cast<volatile char*>(alloca(m_prefault_stack));
+            for (unsigned int i = 0; i < m_prefault_stack; i += 1024)
+                stack[i] = 0;
+        }
+    #endif
+}
+
+/*! @brief Locks all of the current and future memory of the process into RAM, if the placement asked for it
+    @return true if the memory was locked, false if it was not asked for, or could not be done
+ */
+bool ThreadPlacement::lockMemory()
+{
+    if (not m_lock_memory)
+        return false;
+    #ifndef TARGET_OS_IS_WINDOWS
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0)
+        {
+            #if DEBUG_THREADING_VERBOSITY > 0
+                debug << "ThreadPlacement::lockMemory(). Locked all memory." << endl;
+            #endif
+            return true;
+        }
+        errorlog << "ThreadPlacement::lockMemory(). Unable to lock memory: " << strerror(errno) << ". Continuing without it." << endl;
+    #endif
+    return false;
+}
+
@@ -0,0 +1,94 @@
+/*! @file ThreadPlacement.h
+    @brief Declaration of the thread placement configuration
+
+    @class ThreadPlacement
+    @brief Decides the scheduling policy, priority and cpus of each thread, and whether the process's memory is locked.
+
+    The placement is loaded once at startup from a file with one line per thread:
+    @verbatim
+    WatchDogThread: FIFO 10 []
+    ImageLoggerThread: OTHER 0 [1]
+    *Port: OTHER 0 []
+    @endverbatim
+    The policy is one of FIFO, RR or OTHER. An empty cpu list lets the thread run on any cpu. A name starting
+    with a * matches any thread whose name ends with the rest of the name. The first matching line is used.
+
+    The file can also contain the lines
+    @verbatim
+    LockMemory: 1
+    PrefaultStack: 65536
+    @endverbatim
+    to lock all of the process's memory into RAM, and to touch the given number of bytes of each thread's stack
+    when it starts, so that neither ever page faults in the middle of a cycle.
+
+    Threads without a line keep the behaviour given to them in code; a non-zero priority is SCHED_FIFO. The
+    SenseMoveThread and SeeThinkThread priorities are set in CMake (NUBOT_THREAD_*_PRIORITY), so they are left out
+    of the file; a line that gives a thread a different priority from its code is reported when the thread starts.
+    Nothing here requires root, without it the real-time policies and memory locking fail with a warning and
+    the thread runs with the normal policy.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef THREADPLACEMENT_H
+#define THREADPLACEMENT_H
+
+#include <pthread.h>
+#include <string>
+#include <vector>
+#include <iostream>
+
+class ThreadPlacement
+{
+public:
+    enum Policy
+    {
+        Other,
+        FIFO,
+        RoundRobin
+    };
+    struct Placement
+    {
+        std::string Name;                   //!< the name of the thread, or a pattern starting with *
+        Policy SchedulingPolicy;            //!< the scheduling policy of the thread
+        int Priority;                       //!< the priority of the thread; must be 0 for Other
+        std::vector<int> Cpus;              //!< the cpus the thread may run on, or empty for any cpu
+    };
+
+    static bool load(const std::string& filename);
+    static bool load(std::istream& input);
+    static void clear();
+
+    static Placement find(const std::string& name, unsigned char defaultpriority);
+    static void apply(pthread_t thread, const std::string& name, unsigned char defaultpriority);
+    static void prefaultStack();
+    static bool lockMemory();
+    /*! @brief Returns the number of threads the NUbot may use to create its subsystems at startup */
+    static unsigned int getStartupThreads() {return m_startup_threads;}
+private:
+    static bool parsePlacement(const std::string& name, const std::string& value, Placement& placement);
+    static bool matches(const std::string& pattern, const std::string& name);
+private:
+    static std::vector<Placement> m_placements;     //!< the placement of each configured thread
+    static bool m_lock_memory;                      //!< true if all of the memory should be locked into RAM
+    static unsigned int m_prefault_stack;           //!< the number of bytes of each thread's stack to touch when it starts
+    static unsigned int m_startup_threads;          //!< the number of threads used to create the subsystems at startup
+};
+
+#endif
+
@@ -24,7 +24,12 @@ SET (YOUR_SRCS
 Thread.cpp 
 ConditionalThread.cpp
 PeriodicThread.cpp
+ThreadPlacement.cpp
+StartupScheduler.cpp
 QueueThread.h
+LockFreeQueue.h
+BoundedQueueThread.h
+SnapshotBuffer.h
 )
 ####################################################################################
 ########## List your subdirectories here! ##########################################
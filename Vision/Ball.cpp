@@ -4,6 +4,7 @@
 #include "TransitionSegment.h"
 #include "ScanLine.h"
 #include "ClassifiedSection.h"
+#include "DirectFitting.h"
 #include "debug.h"
 #include "debugverbosityvision.h"
 #include "Infrastructure/NUSensorsData/NUSensorsData.h"
@@ -456,7 +457,7 @@ Circle Ball::isCorrectFit(const std::vector < Vector2<int> > &ballPoints, const
     Circle circ;
     circ.radius = 0.0;
     circ.isDefined = false;
-    CircleFitting CircleFit;
+    DirectCircleFit CircleFit(0.5);     // a fit within half a pixel does not need refining
 
     //debug << "Points:";
     #if TARGET_OS_IS_WINDOWS
@@ -469,7 +470,7 @@ Circle Ball::isCorrectFit(const std::vector < Vector2<int> > &ballPoints, const
     if(ballPoints.size() >= 5)
     {
 
-            circ = CircleFit.FitCircleLMF(ballPoints);
+            circ = CircleFit.fit(ballPoints);
             if(circ.sd > 3.5 ||  circ.radius*2 > getMaxPixelsOfBall(vision) )
             {
                 circ.isDefined = false;
@@ -0,0 +1,219 @@
+/*! @file CameraRayTable.cpp
+    @brief Implementation of precomputed camera ray tables for projecting image points onto the ground
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CameraRayTable.h"
+
+#include <cmath>
+using namespace std;
+
+CameraRayTable::CameraRayTable()
+{
+    m_width = 0;
+    m_height = 0;
+    m_fovx = 0;
+    m_fovy = 0;
+    m_focal_x = 1;
+    m_focal_y = 1;
+    m_has_transform = false;
+}
+
+/*! @brief Rebuilds the ray tables if the calibration has changed
+    @param width the width of the image in pixels
+    @param height the height of the image in pixels
+    @param fovx the horizontal field of view in radians
+    @param fovy the vertical field of view in radians
+ */
+void CameraRayTable::setCalibration(int width, int height, double fovx, double fovy)
+{
+    if (width == m_width and height == m_height and fovx == m_fovx and fovy == m_fovy)
+        return;
+    m_width = width;
+    m_height = height;
+    m_fovx = fovx;
+    m_fovy = fovy;
+    m_focal_x = (width/2)/tan(fovx/2.0);
+    m_focal_y = (height/2)/tan(fovy/2.0);
+
+    m_cos_bearing.resize(width);
+    m_sin_bearing.resize(width);
+    for (int x = 0; x < width; x++)
+    {
+        double b = bearing(x);
+        m_cos_bearing[x] = cos(b);
+        m_sin_bearing[x] = sin(b);
+    }
+    m_cos_elevation.resize(height);
+    m_sin_elevation.resize(height);
+    for (int y = 0; y < height; y++)
+    {
+        double e = elevation(y);
+        m_cos_elevation[y] = cos(e);
+        m_sin_elevation[y] = sin(e);
+    }
+}
+
+/*! @brief Updates the camera to ground transform. Nothing is recomputed if the transform has not changed
+    @param transform the 4x4 camera to ground transform in row major order, as stored in NUSensorsData
+    @return true if the transform is valid
+ */
+bool CameraRayTable::setCameraToGroundTransform(const vector<float>& transform)
+{
+    if (transform.size() != 16)
+    {
+        m_has_transform = false;
+        return false;
+    }
+    if (m_has_transform and transform == m_transform_source)
+        return true;
+
+    m_transform_source = transform;
+    for (int row = 0; row < 3; row++)
+        for (int col = 0; col < 4; col++)
+            m_transform[row][col] = transform[4*row + col];
+    m_has_transform = true;
+    return true;
+}
+
+/*! @brief Forgets the camera to ground transform; projections fail until a new one is set */
+void CameraRayTable::clearCameraToGroundTransform()
+{
+    m_has_transform = false;
+}
+
+/*! @brief Returns the bearing of the image column x in radians, positive to the left */
+double CameraRayTable::bearing(double x) const
+{
+    return atan((m_width/2 - x)/m_focal_x);
+}
+
+/*! @brief Returns the elevation of the image row y in radians, positive up */
+double CameraRayTable::elevation(double y) const
+{
+    return atan((m_height/2 - y)/m_focal_y);
+}
+
+/*! @brief Projects an image point onto the ground
+    @param x the x coordinate of the point in the image
+    @param y the y coordinate of the point in the image
+    @param result the (distance, bearing, elevation) of the point on the ground relative to the robot
+    @return false if there is no camera to ground transform
+ */
+bool CameraRayTable::projectToGround(double x, double y, Vector3<float>& result) const
+{
+    if (not m_has_transform)
+        return false;
+    double r[3];
+    ray(x, y, r);
+    result = intersect(r);
+    return true;
+}
+
+/*! @brief Projects an array of image points onto the ground
+    @param x the x coordinates of the points
+    @param y the y coordinates of the points
+    @param n the number of points
+    @param results the (distance, bearing, elevation) of each point; there must be space for n results
+    @return the number of points projected, which is 0 if there is no camera to ground transform
+ */
+int CameraRayTable::projectToGround(const double* x, const double* y, int n, Vector3<float>* results) const
+{
+    if (not m_has_transform)
+        return 0;
+    double r[3];
+    for (int i = 0; i < n; i++)
+    {
+        ray(x[i], y[i], r);
+        results[i] = intersect(r);
+    }
+    return n;
+}
+
+/*! @brief Projects a vector of image points onto the ground
+    @param points the points in the image
+    @param results the (distance, bearing, elevation) of each point
+    @return the number of points projected, which is 0 if there is no camera to ground transform
+ */
+int CameraRayTable::projectToGround(const vector<Vector2<int> >& points, vector<Vector3<float> >& results) const
+{
+    results.resize(points.size());
+    if (not m_has_transform)
+        return 0;
+    double r[3];
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        ray(points[i].x, points[i].y, r);
+        results[i] = intersect(r);
+    }
+    return points.size();
+}
+
+/*! @brief Calculates the direction of the ray through an image point in the camera frame.
+    Whole pixel coordinates inside the image use the tables, anything else is calculated directly.
+ */
+void CameraRayTable::ray(double x, double y, double r[3]) const
+{
+    int ix = static_cast<int>(x);
+    int iy = static_cast<int>(y);
+    double cb, sb, ce, se;
+    if (ix == x and ix >= 0 and ix < m_width)
+    {
+        cb = m_cos_bearing[ix];
+        sb = m_sin_bearing[ix];
+    }
+    else
+    {
+        double b = bearing(x);
+        cb = cos(b);
+        sb = sin(b);
+    }
+    if (iy == y and iy >= 0 and iy < m_height)
+    {
+        ce = m_cos_elevation[iy];
+        se = m_sin_elevation[iy];
+    }
+    else
+    {
+        double e = elevation(y);
+        ce = cos(e);
+        se = sin(e);
+    }
+    r[0] = cb*ce;
+    r[1] = sb*ce;
+    r[2] = se;
+}
+
+/*! @brief Intersects a camera ray with the ground plane
+    @param r the direction of the ray in the camera frame
+    @return the (distance, bearing, elevation) of the intersection
+ */
+Vector3<float> CameraRayTable::intersect(const double r[3]) const
+{
+    const double (&T)[3][4] = m_transform;
+    double dx = T[0][0]*r[0] + T[0][1]*r[1] + T[0][2]*r[2];
+    double dy = T[1][0]*r[0] + T[1][1]*r[1] + T[1][2]*r[2];
+    double dz = T[2][0]*r[0] + T[2][1]*r[1] + T[2][2]*r[2];
+    double s = -T[2][3]/dz;
+    float x = T[0][3] + s*dx;
+    float y = T[1][3] + s*dy;
+    float distance = sqrt(x*x + y*y);
+    return Vector3<float>(distance, atan2(y, x), 0.0f);
+}
+
@@ -0,0 +1,75 @@
+/*! @file CameraRayTable.h
+    @brief Declaration of precomputed camera ray tables for projecting image points onto the ground
+
+    @class CameraRayTable
+    @brief Caches the ray through every pixel, and projects image points onto the ground with a table lookup and a small matrix multiply.
+
+    The bearing and elevation of a pixel only depend on its column and row respectively, so the ray through any
+    pixel is built from one entry of a per column table and one entry of a per row table. These tables are only
+    rebuilt when the camera calibration (image size or field of view) changes.
+
+    The camera to ground transform is copied from the kinematics whenever it changes, after which projecting a
+    point is a rotation of its ray and an intersection with the ground plane. The results are the same as
+    Kinematics::DistanceToPoint with the bearing and elevation from Vision::CalculateBearing and
+    Vision::CalculateElevation.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CAMERARAYTABLE_H
+#define CAMERARAYTABLE_H
+
+#include "Tools/Math/Vector2.h"
+#include "Tools/Math/Vector3.h"
+#include <vector>
+
+class CameraRayTable
+{
+public:
+    CameraRayTable();
+
+    void setCalibration(int width, int height, double fovx, double fovy);
+    bool setCameraToGroundTransform(const std::vector<float>& transform);
+    void clearCameraToGroundTransform();
+    bool hasCameraToGroundTransform() const {return m_has_transform;}
+
+    double bearing(double x) const;
+    double elevation(double y) const;
+
+    bool projectToGround(double x, double y, Vector3<float>& result) const;
+    int projectToGround(const double* x, const double* y, int n, Vector3<float>* results) const;
+    int projectToGround(const std::vector<Vector2<int> >& points, std::vector<Vector3<float> >& results) const;
+private:
+    void ray(double x, double y, double r[3]) const;
+    Vector3<float> intersect(const double r[3]) const;
+private:
+    int m_width, m_height;                      //!< the image size the tables were built for
+    double m_fovx, m_fovy;                      //!< the field of view the tables were built for
+    double m_focal_x, m_focal_y;                //!< the distance to the image plane in pixels, horizontally and vertically
+    std::vector<double> m_cos_bearing;          //!< the cosine of the bearing of each column
+    std::vector<double> m_sin_bearing;          //!< the sine of the bearing of each column
+    std::vector<double> m_cos_elevation;        //!< the cosine of the elevation of each row
+    std::vector<double> m_sin_elevation;        //!< the sine of the elevation of each row
+
+    bool m_has_transform;                       //!< true if m_transform is valid
+    std::vector<float> m_transform_source;      //!< the transform m_transform was built from, used to detect changes
+    double m_transform[3][4];                   //!< the top three rows of the camera to ground transform
+};
+
+#endif
+
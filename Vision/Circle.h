@@ -1,3 +1,6 @@
+#ifndef CIRCLE_H
+#define CIRCLE_H
+
 class Circle {
 
 	public:
@@ -10,3 +13,5 @@ class Circle {
         bool isDefined;
 
 };
+
+#endif
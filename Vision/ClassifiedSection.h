@@ -3,6 +3,7 @@
 
 #include <vector>
 #include "ScanLine.h"
+#include "Tools/Memory/ArenaAllocator.h"
 
 
 
@@ -25,7 +26,7 @@ public:
 
 private:
     int direction;
-    std::vector< ScanLine > scanLines;
+    ArenaVector<ScanLine>::type scanLines;
 
 };
 
@@ -0,0 +1,617 @@
+/*! @file DirectFitting.cpp
+    @brief Implementation of allocation free circle and ellipse fitting
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DirectFitting.h"
+#include "Tools/Math/LSFittedLine.h"
+
+#include <cmath>
+#include <cfloat>
+using namespace std;
+
+static const double LM_FACTOR_UP = 10;             //!< the factor lambda is increased by after a step that does not improve the fit
+static const double LM_FACTOR_DOWN = 0.04;         //!< the factor lambda is decreased by after a step that improves the fit
+static const double LM_MIN_CHANGE = 1e-3;          //!< the geometric fit stops when the relative change in the circle is below this
+
+/*! @brief Gives DirectEllipseFit::fitPoints access to a vector of LinePoints */
+class LinePointAccessor
+{
+public:
+    LinePointAccessor(const vector<LinePoint*>& points) : m_points(points) {};
+    double x(int i) const {return m_points[i]->x;}
+    double y(int i) const {return m_points[i]->y;}
+private:
+    const vector<LinePoint*>& m_points;
+};
+
+/*! @brief Gives DirectEllipseFit::fitPoints access to a pair of coordinate arrays */
+class ArrayAccessor
+{
+public:
+    ArrayAccessor(const double* x, const double* y) : m_x(x), m_y(y) {};
+    double x(int i) const {return m_x[i];}
+    double y(int i) const {return m_y[i];}
+private:
+    const double* m_x;
+    const double* m_y;
+};
+
+/*! @brief Creates a circle fitter
+    @param residualthreshold a fit with an rms residual at or below this is accepted without further iteration
+    @param maxiterations the largest number of geometric iterations
+ */
+DirectCircleFit::DirectCircleFit(double residualthreshold, int maxiterations)
+{
+    m_residual_threshold = residualthreshold;
+    m_max_iterations = maxiterations;
+    m_num_points = 0;
+    m_mean_x = 0;
+    m_mean_y = 0;
+}
+
+/*! @brief Fits a circle to the points. The circle is not defined if there are fewer than 3 points, or the points are collinear */
+Circle DirectCircleFit::fit(const vector<Vector2<int> >& points)
+{
+    int n = points.size();
+    m_num_points = min(n, static_cast<int>(MAX_POINTS));
+    m_mean_x = 0;
+    m_mean_y = 0;
+    for (int i = 0; i < m_num_points; i++)
+    {
+        const Vector2<int>& p = points[static_cast<long>(i)*n/m_num_points];
+        m_x[i] = p.x;
+        m_y[i] = p.y;
+        m_mean_x += p.x;
+        m_mean_y += p.y;
+    }
+    return fitStored();
+}
+
+/*! @brief Fits a circle to the points. The circle is not defined if there are fewer than 3 points, or the points are collinear */
+Circle DirectCircleFit::fit(const vector<LinePoint*>& points)
+{
+    int n = points.size();
+    m_num_points = min(n, static_cast<int>(MAX_POINTS));
+    m_mean_x = 0;
+    m_mean_y = 0;
+    for (int i = 0; i < m_num_points; i++)
+    {
+        const LinePoint* p = points[static_cast<long>(i)*n/m_num_points];
+        m_x[i] = p->x;
+        m_y[i] = p->y;
+        m_mean_x += p->x;
+        m_mean_y += p->y;
+    }
+    return fitStored();
+}
+
+/*! @brief Fits a circle to the n points (x[i], y[i]) */
+Circle DirectCircleFit::fit(const double* x, const double* y, int n)
+{
+    m_num_points = min(n, static_cast<int>(MAX_POINTS));
+    m_mean_x = 0;
+    m_mean_y = 0;
+    for (int i = 0; i < m_num_points; i++)
+    {
+        long j = static_cast<long>(i)*n/m_num_points;
+        m_x[i] = x[j];
+        m_y[i] = y[j];
+        m_mean_x += x[j];
+        m_mean_y += y[j];
+    }
+    return fitStored();
+}
+
+/*! @brief Fits a circle to each of the point sets
+    @param pointsets the point sets
+    @param numsets the number of point sets
+    @param results the fitted circles; there must be space for numsets circles
+    @return the number of circles that are defined
+ */
+int DirectCircleFit::fit(const vector<Vector2<int> >* pointsets, int numsets, Circle* results)
+{
+    int numdefined = 0;
+    for (int i = 0; i < numsets; i++)
+    {
+        results[i] = fit(pointsets[i]);
+        if (results[i].isDefined)
+            numdefined++;
+    }
+    return numdefined;
+}
+
+/*! @brief Fits a circle to the stored points. m_mean_x and m_mean_y must hold the sum of the points on entry */
+Circle DirectCircleFit::fitStored()
+{
+    if (m_num_points < 3)
+        return Circle();
+
+    m_mean_x /= m_num_points;
+    m_mean_y /= m_num_points;
+    for (int i = 0; i < m_num_points; i++)
+    {
+        m_x[i] -= m_mean_x;
+        m_y[i] -= m_mean_y;
+    }
+
+    Circle best = algebraicFit();
+    if (not best.isDefined)
+        return best;
+
+    double lambda = 1.0;
+    int iteration = 0;
+    bool converged = best.sd <= m_residual_threshold;
+    while (not converged and iteration < m_max_iterations)
+    {
+        double sumu = 0, sumv = 0, sumuu = 0, sumvv = 0, sumuv = 0, sumr = 0;
+        for (int i = 0; i < m_num_points; i++)
+        {
+            double dx = m_x[i] - best.centreX;
+            double dy = m_y[i] - best.centreY;
+            double r = sqrt(dx*dx + dy*dy);
+            if (r <= 0)
+            {
+                converged = true;
+                break;
+            }
+            double u = dx/r;
+            double v = dy/r;
+            sumu += u;
+            sumv += v;
+            sumuu += u*u;
+            sumvv += v*v;
+            sumuv += u*v;
+            sumr += r;
+        }
+        if (converged)
+            break;
+        double meanu = sumu/m_num_points;
+        double meanv = sumv/m_num_points;
+        double meanuu = sumuu/m_num_points;
+        double meanvv = sumvv/m_num_points;
+        double meanuv = sumuv/m_num_points;
+        double meanr = sumr/m_num_points;
+
+        double F1 = best.centreX + best.radius*meanu;
+        double F2 = best.centreY + best.radius*meanv;
+        double F3 = best.radius - meanr;
+
+        // increase lambda until a step improves the fit, or we run out of iterations
+        while (iteration < m_max_iterations)
+        {
+            iteration++;
+            // solve the 3x3 normal equations with a Cholesky decomposition
+            double G11 = sqrt(meanuu + lambda);
+            double G12 = meanuv/G11;
+            double G13 = meanu/G11;
+            double G22sq = meanvv + lambda - G12*G12;
+            if (G22sq <= 0)
+            {
+                converged = true;
+                break;
+            }
+            double G22 = sqrt(G22sq);
+            double G23 = (meanv - G12*G13)/G22;
+            double G33sq = 1.0 + lambda - G13*G13 - G23*G23;
+            if (G33sq <= 0)
+            {
+                converged = true;
+                break;
+            }
+            double G33 = sqrt(G33sq);
+
+            double D1 = F1/G11;
+            double D2 = (F2 - G12*D1)/G22;
+            double D3 = (F3 - G13*D1 - G23*D2)/G33;
+            double dR = D3/G33;
+            double dY = (D2 - G23*dR)/G22;
+            double dX = (D1 - G12*dY - G13*dR)/G11;
+
+            Circle next;
+            next.centreX = best.centreX - dX;
+            next.centreY = best.centreY - dY;
+            next.radius = best.radius - dR;
+            next.sd = residual(next.centreX, next.centreY, next.radius);
+            next.isDefined = true;
+            if (next.sd <= best.sd)
+            {
+                double change = (fabs(dX) + fabs(dY) + fabs(dR))/(best.radius + next.radius);
+                best = next;
+                lambda *= LM_FACTOR_DOWN;
+                converged = best.sd <= m_residual_threshold or change < LM_MIN_CHANGE;
+                break;
+            }
+            else
+                lambda *= LM_FACTOR_UP;
+        }
+    }
+
+    best.centreX += m_mean_x;
+    best.centreY += m_mean_y;
+    return best;
+}
+
+/*! @brief Returns the algebraic (Kasa) fit to the stored points, which are relative to their mean */
+Circle DirectCircleFit::algebraicFit() const
+{
+    double sumxy = 0, sumxx = 0, sumyy = 0, sumxz = 0, sumyz = 0;
+    for (int i = 0; i < m_num_points; i++)
+    {
+        double x = m_x[i];
+        double y = m_y[i];
+        double z = x*x + y*y;
+        sumxy += x*y;
+        sumxx += x*x;
+        sumyy += y*y;
+        sumxz += x*z;
+        sumyz += y*z;
+    }
+    double meanxx = sumxx/m_num_points;
+    double meanyy = sumyy/m_num_points;
+    double meanxy = sumxy/m_num_points;
+    double meanxz = sumxz/m_num_points;
+    double meanyz = sumyz/m_num_points;
+
+    Circle circle;
+    double G11 = sqrt(meanxx);
+    if (G11 < DBL_MIN or G11 > DBL_MAX)
+        return circle;
+    double G12 = meanxy/G11;
+    if (meanyy - G12*G12 < 0)
+        return circle;
+    double G22 = sqrt(meanyy - G12*G12);
+    if (G22 < DBL_MIN or G22 > DBL_MAX)
+        return circle;
+
+    double D1 = meanxz/G11;
+    double D2 = (meanyz - D1*G12)/G22;
+    double C = D2/G22;
+    double B = (D1 - G12*C)/G11;
+
+    circle.centreX = B/2;
+    circle.centreY = C/2;
+    circle.radius = sqrt(circle.centreX*circle.centreX + circle.centreY*circle.centreY + meanxx + meanyy);
+    circle.sd = residual(circle.centreX, circle.centreY, circle.radius);
+    circle.isDefined = true;
+    return circle;
+}
+
+/*! @brief Returns the rms distance of the stored points from the circle */
+double DirectCircleFit::residual(double cx, double cy, double r) const
+{
+    double sum = 0;
+    for (int i = 0; i < m_num_points; i++)
+    {
+        double dx = m_x[i] - cx;
+        double dy = m_y[i] - cy;
+        double d = sqrt(dx*dx + dy*dy) - r;
+        sum += d*d;
+    }
+    return sqrt(sum/m_num_points);
+}
+
+/*! @brief Creates an ellipse fitter
+    @param residualthreshold if positive, a circle is fitted first and returned when its rms residual is at or below this
+ */
+DirectEllipseFit::DirectEllipseFit(double residualthreshold)
+{
+    m_residual_threshold = residualthreshold;
+}
+
+/*! @brief Fits an ellipse to the points. The ellipse is not defined if there are fewer than 5 points, or they do not lie on an ellipse */
+Ellipse DirectEllipseFit::fit(const vector<LinePoint*>& points)
+{
+    if (m_residual_threshold > 0)
+    {
+        DirectCircleFit circlefitter(m_residual_threshold);
+        Circle circle = circlefitter.fit(points);
+        if (circle.isDefined and circle.sd <= m_residual_threshold)
+        {
+            Ellipse ellipse;
+            ellipse.centreX = circle.centreX;
+            ellipse.centreY = circle.centreY;
+            ellipse.r1 = circle.radius;
+            ellipse.r2 = circle.radius;
+            ellipse.sd = circle.sd;
+            ellipse.isDefined = true;
+            return ellipse;
+        }
+    }
+    return fitPoints(LinePointAccessor(points), points.size());
+}
+
+/*! @brief Fits an ellipse to the n points (x[i], y[i]) */
+Ellipse DirectEllipseFit::fit(const double* x, const double* y, int n)
+{
+    if (m_residual_threshold > 0)
+    {
+        DirectCircleFit circlefitter(m_residual_threshold);
+        Circle circle = circlefitter.fit(x, y, n);
+        if (circle.isDefined and circle.sd <= m_residual_threshold)
+        {
+            Ellipse ellipse;
+            ellipse.centreX = circle.centreX;
+            ellipse.centreY = circle.centreY;
+            ellipse.r1 = circle.radius;
+            ellipse.r2 = circle.radius;
+            ellipse.sd = circle.sd;
+            ellipse.isDefined = true;
+            return ellipse;
+        }
+    }
+    return fitPoints(ArrayAccessor(x, y), n);
+}
+
+/*! @brief Fits an ellipse to each of the point sets
+    @param pointsets the point sets
+    @param numsets the number of point sets
+    @param results the fitted ellipses; there must be space for numsets ellipses
+    @return the number of ellipses that are defined
+ */
+int DirectEllipseFit::fit(const vector<LinePoint*>* pointsets, int numsets, Ellipse* results)
+{
+    int numdefined = 0;
+    for (int i = 0; i < numsets; i++)
+    {
+        results[i] = fit(pointsets[i]);
+        if (results[i].isDefined)
+            numdefined++;
+    }
+    return numdefined;
+}
+
+/*! @brief Fits an ellipse with the direct least squares method (Halir and Flusser, 1998).
+
+    The points are centred and scaled before the scatter matrix is formed to keep the problem well conditioned,
+    and the result is transformed back afterwards.
+ */
+template <class Accessor> Ellipse DirectEllipseFit::fitPoints(const Accessor& points, int n)
+{
+    Ellipse ellipse;
+    if (n < 5)
+        return ellipse;
+
+    // centre and scale the points so that their rms distance from the origin is sqrt(2)
+    double sumx = 0, sumy = 0, sumsq = 0;
+    for (int i = 0; i < n; i++)
+    {
+        double x = points.x(i);
+        double y = points.y(i);
+        sumx += x;
+        sumy += y;
+        sumsq += x*x + y*y;
+    }
+    double mx = sumx/n;
+    double my = sumy/n;
+    double variance = sumsq/n - mx*mx - my*my;
+    if (variance <= 0)
+        return ellipse;
+    double scale = sqrt(variance/2);
+
+    // accumulate the moments needed for the scatter matrix
+    double x4 = 0, x3y = 0, x2y2 = 0, xy3 = 0, y4 = 0;
+    double x3 = 0, x2y = 0, xy2 = 0, y3 = 0;
+    double x2 = 0, xy = 0, y2 = 0, x1 = 0, y1 = 0;
+    for (int i = 0; i < n; i++)
+    {
+        double x = (points.x(i) - mx)/scale;
+        double y = (points.y(i) - my)/scale;
+        double xx = x*x, yy = y*y, xxy = xx*y, xyy = x*yy;
+        x4 += xx*xx;
+        x3y += xx*x*y;
+        x2y2 += xx*yy;
+        xy3 += xyy*y;
+        y4 += yy*yy;
+        x3 += xx*x;
+        x2y += xxy;
+        xy2 += xyy;
+        y3 += yy*y;
+        x2 += xx;
+        xy += x*y;
+        y2 += yy;
+        x1 += x;
+        y1 += y;
+    }
+
+    // S1 = D1'D1, S2 = D1'D2 and S3 = D2'D2 where D1 = [x^2 xy y^2] and D2 = [x y 1]
+    double S1[3][3] = {{x4, x3y, x2y2}, {x3y, x2y2, xy3}, {x2y2, xy3, y4}};
+    double S2[3][3] = {{x3, x2y, x2}, {x2y, xy2, xy}, {xy2, y3, y2}};
+    double S3[3][3] = {{x2, xy, x1}, {xy, y2, y1}, {x1, y1, static_cast<double>(n)}};
+
+    // invert S3 using its cofactors
+    double C3[3][3];
+    C3[0][0] = S3[1][1]*S3[2][2] - S3[1][2]*S3[2][1];
+    C3[0][1] = S3[0][2]*S3[2][1] - S3[0][1]*S3[2][2];
+    C3[0][2] = S3[0][1]*S3[1][2] - S3[0][2]*S3[1][1];
+    C3[1][0] = S3[1][2]*S3[2][0] - S3[1][0]*S3[2][2];
+    C3[1][1] = S3[0][0]*S3[2][2] - S3[0][2]*S3[2][0];
+    C3[1][2] = S3[0][2]*S3[1][0] - S3[0][0]*S3[1][2];
+    C3[2][0] = S3[1][0]*S3[2][1] - S3[1][1]*S3[2][0];
+    C3[2][1] = S3[0][1]*S3[2][0] - S3[0][0]*S3[2][1];
+    C3[2][2] = S3[0][0]*S3[1][1] - S3[0][1]*S3[1][0];
+    double det = S3[0][0]*C3[0][0] + S3[0][1]*C3[1][0] + S3[0][2]*C3[2][0];
+    if (fabs(det) < DBL_MIN)
+        return ellipse;
+
+    // T = -inv(S3) S2', M = S1 + S2 T
+    double T[3][3];
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            T[i][j] = -(C3[i][0]*S2[j][0] + C3[i][1]*S2[j][1] + C3[i][2]*S2[j][2])/det;
+    double M[3][3];
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            M[i][j] = S1[i][j] + S2[i][0]*T[0][j] + S2[i][1]*T[1][j] + S2[i][2]*T[2][j];
+
+    // premultiply by the inverse of the constraint matrix
+    double A[3][3];
+    for (int j = 0; j < 3; j++)
+    {
+        A[0][j] = M[2][j]/2;
+        A[1][j] = -M[1][j];
+        A[2][j] = M[0][j]/2;
+    }
+
+    // the eigenvalues of A are the roots of its characteristic polynomial
+    double trace = A[0][0] + A[1][1] + A[2][2];
+    double minors = A[0][0]*A[1][1] - A[0][1]*A[1][0] + A[0][0]*A[2][2] - A[0][2]*A[2][0] + A[1][1]*A[2][2] - A[1][2]*A[2][1];
+    double determinant = A[0][0]*(A[1][1]*A[2][2] - A[1][2]*A[2][1]) - A[0][1]*(A[1][0]*A[2][2] - A[1][2]*A[2][0]) + A[0][2]*(A[1][0]*A[2][1] - A[1][1]*A[2][0]);
+    double roots[3];
+    int numroots = solveCubic(-trace, minors, -determinant, roots);
+
+    // the eigenvector that satisfies the ellipse constraint 4ac - b^2 > 0 gives the conic
+    double a[6];
+    double bestcondition = 0;
+    for (int r = 0; r < numroots; r++)
+    {
+        double B[3][3];
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++)
+                B[i][j] = A[i][j] - (i == j ? roots[r] : 0);
+        // the eigenvector is orthogonal to the rows of B, so take the largest cross product of a pair of rows
+        double v[3] = {0, 0, 0};
+        double vnorm = 0;
+        for (int p = 0; p < 3; p++)
+        {
+            const double* r1 = B[p];
+            const double* r2 = B[(p + 1) % 3];
+            double c[3] = {r1[1]*r2[2] - r1[2]*r2[1], r1[2]*r2[0] - r1[0]*r2[2], r1[0]*r2[1] - r1[1]*r2[0]};
+            double cnorm = c[0]*c[0] + c[1]*c[1] + c[2]*c[2];
+            if (cnorm > vnorm)
+            {
+                v[0] = c[0];
+                v[1] = c[1];
+                v[2] = c[2];
+                vnorm = cnorm;
+            }
+        }
+        if (vnorm <= 0)
+            continue;
+        vnorm = sqrt(vnorm);
+        v[0] /= vnorm;
+        v[1] /= vnorm;
+        v[2] /= vnorm;
+        double condition = 4*v[0]*v[2] - v[1]*v[1];
+        if (condition > bestcondition)
+        {
+            bestcondition = condition;
+            a[0] = v[0];
+            a[1] = v[1];
+            a[2] = v[2];
+            for (int i = 0; i < 3; i++)
+                a[3 + i] = T[i][0]*v[0] + T[i][1]*v[1] + T[i][2]*v[2];
+        }
+    }
+    if (bestcondition <= 0)
+        return ellipse;                 // no eigenvector is an ellipse, so a was never set
+    if (a[0] + a[2] < 0)
+    {   // the sign of an eigenvector is arbitrary, so choose the one that makes the angle consistent
+        for (int i = 0; i < 6; i++)
+            a[i] = -a[i];
+    }
+    if (not solveConic(a, ellipse))
+        return ellipse;
+
+    // the rms Sampson distance of the points from the conic
+    double sum = 0;
+    for (int i = 0; i < n; i++)
+    {
+        double x = (points.x(i) - mx)/scale;
+        double y = (points.y(i) - my)/scale;
+        double f = a[0]*x*x + a[1]*x*y + a[2]*y*y + a[3]*x + a[4]*y + a[5];
+        double fx = 2*a[0]*x + a[1]*y + a[3];
+        double fy = a[1]*x + 2*a[2]*y + a[4];
+        double g = fx*fx + fy*fy;
+        if (g > 0)
+            sum += f*f/g;
+    }
+
+    ellipse.centreX = ellipse.centreX*scale + mx;
+    ellipse.centreY = ellipse.centreY*scale + my;
+    ellipse.r1 *= scale;
+    ellipse.r2 *= scale;
+    ellipse.sd = sqrt(sum/n)*scale;
+    return ellipse;
+}
+
+/*! @brief Finds the real roots of x^3 + ax^2 + bx + c = 0
+    @param roots the real roots
+    @return the number of real roots
+ */
+int DirectEllipseFit::solveCubic(double a, double b, double c, double roots[3])
+{
+    double q = (a*a - 3*b)/9;
+    double r = (2*a*a*a - 9*a*b + 27*c)/54;
+    double q3 = q*q*q;
+    if (r*r < q3)
+    {   // three real roots
+        double t = acos(r/sqrt(q3));
+        double s = -2*sqrt(q);
+        roots[0] = s*cos(t/3) - a/3;
+        roots[1] = s*cos((t + 2*M_PI)/3) - a/3;
+        roots[2] = s*cos((t - 2*M_PI)/3) - a/3;
+        return 3;
+    }
+    else
+    {   // one real root
+        double u = -pow(fabs(r) + sqrt(r*r - q3), 1.0/3);
+        if (r < 0)
+            u = -u;
+        double v = (u == 0) ? 0 : q/u;
+        roots[0] = u + v - a/3;
+        return 1;
+    }
+}
+
+/*! @brief Converts the conic a[0]x^2 + a[1]xy + a[2]y^2 + a[3]x + a[4]y + a[5] = 0 into an ellipse's centre, radii and angle
+    @return false if the conic is not a real ellipse
+ */
+bool DirectEllipseFit::solveConic(const double a[6], Ellipse& ellipse)
+{
+    double theta = atan2(a[1], a[0] - a[2])/2;
+    double ct = cos(theta);
+    double st = sin(theta);
+    double ap = a[0]*ct*ct + a[1]*ct*st + a[2]*st*st;
+    double cp = a[0]*st*st - a[1]*ct*st + a[2]*ct*ct;
+
+    // the centre is where the gradient is zero
+    double det = 4*a[0]*a[2] - a[1]*a[1];
+    if (fabs(det) < DBL_MIN)
+        return false;
+    double cx = (a[1]*a[4] - 2*a[2]*a[3])/det;
+    double cy = (a[1]*a[3] - 2*a[0]*a[4])/det;
+
+    double val = a[0]*cx*cx + a[1]*cx*cy + a[2]*cy*cy;
+    double denominator = val - a[5];
+    if (denominator == 0)
+        return false;
+    double scale = 1/denominator;
+    if (scale*ap <= 0 or scale*cp <= 0)
+        return false;
+
+    ellipse.centreX = cx;
+    ellipse.centreY = cy;
+    ellipse.r1 = 1/sqrt(scale*ap);
+    ellipse.r2 = 1/sqrt(scale*cp);
+    ellipse.theta = theta;
+    ellipse.isDefined = true;
+    return true;
+}
+
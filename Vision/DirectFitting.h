@@ -0,0 +1,102 @@
+/*! @file DirectFitting.h
+    @brief Declaration of allocation free circle and ellipse fitting
+
+    @class DirectCircleFit
+    @brief Fits a circle to a set of points with an algebraic fit followed by a fixed number of geometric iterations.
+
+    The points are copied into fixed size storage inside the fitter (if there are more than MAX_POINTS they are
+    evenly subsampled), so a fitter on the stack makes no heap allocations. The algebraic fit is returned as soon
+    as its residual is below the residual threshold. Otherwise at most m_max_iterations Levenberg-Marquardt steps
+    are taken, stopping early when the residual drops below the threshold or the circle stops changing.
+
+    @class DirectEllipseFit
+    @brief Fits an ellipse to a set of points with the direct least squares method of Halir and Flusser.
+
+    The scatter matrix is accumulated in a single pass over the points, and the 3x3 eigen problem is solved in
+    closed form, so there is no heap allocation and no iterative solver. If a residual threshold is set, a circle
+    is fitted first and returned as the ellipse when its residual is below the threshold.
+
+    Both fitters also have a batch version of fit() that fits several candidate point sets in one call.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DIRECTFITTING_H
+#define DIRECTFITTING_H
+
+#include "Circle.h"
+#include "Tools/Math/Vector2.h"
+#include <vector>
+
+class LinePoint;
+
+/*! @brief The result of an ellipse fit */
+class Ellipse
+{
+public:
+    Ellipse() : centreX(0.0), centreY(0.0), r1(0.0), r2(0.0), theta(0.0), sd(0.0), isDefined(false) {};
+    double centreX;
+    double centreY;
+    double r1, r2;          //!< the radii along the ellipse's own x and y axes
+    double theta;           //!< the angle of the ellipse's x axis
+    double sd;              //!< the rms distance of the points from the ellipse
+    bool isDefined;
+};
+
+class DirectCircleFit
+{
+public:
+    static const int MAX_POINTS = 256;          //!< the largest number of points used in a fit
+
+    DirectCircleFit(double residualthreshold = 0, int maxiterations = 5);
+
+    Circle fit(const std::vector<Vector2<int> >& points);
+    Circle fit(const std::vector<LinePoint*>& points);
+    Circle fit(const double* x, const double* y, int n);
+    int fit(const std::vector<Vector2<int> >* pointsets, int numsets, Circle* results);
+private:
+    Circle fitStored();
+    Circle algebraicFit() const;
+    double residual(double cx, double cy, double r) const;
+private:
+    double m_residual_threshold;                //!< a fit with an rms residual at or below this is accepted without further iteration
+    int m_max_iterations;                       //!< the largest number of geometric iterations
+    int m_num_points;                           //!< the number of points in m_x and m_y
+    double m_mean_x, m_mean_y;                  //!< the mean of the points, which is subtracted from the stored points
+    double m_x[MAX_POINTS];                     //!< the x coordinates of the points relative to the mean
+    double m_y[MAX_POINTS];                     //!< the y coordinates of the points relative to the mean
+};
+
+class DirectEllipseFit
+{
+public:
+    DirectEllipseFit(double residualthreshold = 0);
+
+    Ellipse fit(const std::vector<LinePoint*>& points);
+    Ellipse fit(const double* x, const double* y, int n);
+    int fit(const std::vector<LinePoint*>* pointsets, int numsets, Ellipse* results);
+private:
+    template <class Accessor> Ellipse fitPoints(const Accessor& points, int n);
+    static int solveCubic(double a, double b, double c, double roots[3]);
+    static bool solveConic(const double a[6], Ellipse& ellipse);
+private:
+    double m_residual_threshold;                //!< a circle fit with an rms residual at or below this is returned without fitting an ellipse
+};
+
+#endif
+
@@ -12,7 +12,7 @@
 //using namespace std;
 #include <vector>
 #include "Vision.h"
-#include "EllipseFit.h"
+#include "DirectFitting.h"
 #include "fitellipsethroughcircle.h"
 #include "Tools/Math/StlVector.h"
 //For distance to Point:
@@ -1779,18 +1779,12 @@ void LineDetection::DecodeCorners(FieldObjects* AllObjects, double timestamp, Vi
             {
                 
                 
-                double cx =0;
-                double cy =0;
-                double r1 =0;
-                double r2 =0;
-                EllipseFit* e = new EllipseFit;
-
-                e->Fit_Ellipse(points);
-                //e->PrintFinal();
-                cx = e->GetX();
-                cy = e->GetY();
-                r1 = e->GetR1();
-                r2 = e->GetR2();
+                DirectEllipseFit ellipsefitter;
+                Ellipse ellipse = ellipsefitter.fit(points);
+                double cx = ellipse.centreX;
+                double cy = ellipse.centreY;
+                double r1 = ellipse.r1;
+                double r2 = ellipse.r2;
 
                 TempDist = 0.0;
                 Vector2<float> screenPositionAngle((float)vision->CalculateBearing(cx), (float)vision->CalculateElevation(cy));
@@ -1799,7 +1793,7 @@ void LineDetection::DecodeCorners(FieldObjects* AllObjects, double timestamp, Vi
                     qDebug() << TempDist << closeGoalDistance <<  fabs( TempDist - closeGoalDistance);
                 #endif
 
-                if (TempDist > 100.0  && TempDist != 0.0  && fabs( TempDist - closeGoalDistance) > 200) {
+                if (ellipse.isDefined && TempDist > 100.0  && TempDist != 0.0  && fabs( TempDist - closeGoalDistance) > 200) {
 
                     Vector3<float> measured((float)TempDist,(float)TempBearing,(float)TempElev);
                     Vector3<float> measuredError(0.0,0.0,0.0);
@@ -2521,16 +2515,13 @@ void LineDetection::DecodePenaltySpot(FieldObjects* AllObjects, double timestamp
 
 void LineDetection::GetDistanceToPoint(double cx, double cy, double* distance, double* bearing, double* elevation, Vision* vision)
 {
-    *bearing = vision->CalculateBearing(cx);
-    *elevation = vision->CalculateElevation(cy);
+    const CameraRayTable& raytable = vision->getRayTable();
+    *bearing = raytable.bearing(cx);
+    *elevation = raytable.elevation(cy);
 
-    vector<float> ctgvector;
-    bool isOK = vision->getSensorsData()->get(NUSensorsData::CameraToGroundTransform, ctgvector); 
-    if(isOK == true)
+    Vector3<float> result;
+    if(raytable.projectToGround(cx, cy, result))
     {
-        Matrix camera2groundTransform = Matrix4x4fromVector(ctgvector);
-        Vector3<float> result;
-        result = Kinematics::DistanceToPoint(camera2groundTransform, *bearing, *elevation);
         *distance = result[0];
         *bearing = result[1];
         *elevation = result[2];
@@ -2544,42 +2535,12 @@ void LineDetection::GetDistanceToPoint(double cx, double cy, double* distance, d
 
 bool LineDetection::GetDistanceToPoint(LinePoint point, Vector3<float> &relativePoint, Vision* vision)
 {
-    float bearing = vision->CalculateBearing(point.x);
-    float elevation = vision->CalculateElevation(point.y);
-
-    vector<float> ctgvector;
-    bool isOK = vision->getSensorsData()->get(NUSensorsData::CameraToGroundTransform, ctgvector);
-    if(isOK == true)
-    {
-        Matrix camera2groundTransform = Matrix4x4fromVector(ctgvector);
-
-        relativePoint = Kinematics::DistanceToPoint(camera2groundTransform, bearing, elevation);
-
-        //#if DEBUG_VISION_VERBOSITY > 6
-        //    debug << "\t\tCalculated Distance to Point: " << *distance<<endl;
-        //#endif
-    }
-    return isOK;
+    return vision->getRayTable().projectToGround(point.x, point.y, relativePoint);
 }
 
 bool LineDetection::GetDistanceToPoint(Point point, Vector3<float> &relativePoint, Vision* vision)
 {
-    float bearing = vision->CalculateBearing(point.x);
-    float elevation = vision->CalculateElevation(point.y);
-
-    vector<float> ctgvector;
-    bool isOK = vision->getSensorsData()->get(NUSensorsData::CameraToGroundTransform, ctgvector);
-    if(isOK == true)
-    {
-        Matrix camera2groundTransform = Matrix4x4fromVector(ctgvector);
-
-        relativePoint = Kinematics::DistanceToPoint(camera2groundTransform, bearing, elevation);
-
-        //#if DEBUG_VISION_VERBOSITY > 6
-        //    debug << "\t\tCalculated Distance to Point: " << *distance<<endl;
-        //#endif
-    }
-    return isOK;
+    return vision->getRayTable().projectToGround(point.x, point.y, relativePoint);
 }
 
 /*
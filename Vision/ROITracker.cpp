@@ -0,0 +1,278 @@
+/*! @file ROITracker.cpp
+    @brief Implementation of a temporal region of interest tracker for vision
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ROITracker.h"
+#include "Kinematics/Horizon.h"
+#include "Infrastructure/FieldObjects/FieldObjects.h"
+
+#include "debug.h"
+#include "debugverbosityvision.h"
+
+#include <cmath>
+using namespace std;
+
+static const float ROI_GROWTH = 1.5;           //!< the factor by which the size of an object is grown to get its window
+static const int ROI_MARGIN = 10;              //!< the number of pixels added to each side of a window
+
+/*! @brief Creates a tracker
+    @param fullscanperiod a full frame scan is done at least once every fullscanperiod frames. Every frame is fully scanned if this is less than two
+ */
+ROITracker::ROITracker(int fullscanperiod)
+{
+    m_full_scan_period = fullscanperiod;
+    m_frames_since_full_scan = fullscanperiod;
+    m_tracking = false;
+    m_has_previous = false;
+    m_previous_a = 0;
+    m_previous_b = 1;
+    m_previous_c = 0;
+    m_previous_yaw = 0;
+    m_a = 0;
+    m_b = 1;
+    m_c = 0;
+    m_yaw_shift = 0;
+    m_num_tracked_frames = 0;
+    m_num_full_frames = 0;
+}
+
+ROITracker::~ROITracker()
+{
+}
+
+/*! @brief Sets how often a full frame scan is done, and forgets everything being tracked
+    @param fullscanperiod a full frame scan is done at least once every fullscanperiod frames. Every frame is fully scanned if this is less than two
+ */
+void ROITracker::setFullScanPeriod(int fullscanperiod)
+{
+    m_full_scan_period = fullscanperiod;
+    reset();
+}
+
+/*! @brief Forgets everything being tracked, so that the next frame is fully scanned.
+
+    This needs to be called whenever the next frame does not follow the last one, for example when frames have been
+    dropped, or a log is played back out of order, because the windows are predicted from the last frame.
+ */
+void ROITracker::reset()
+{
+    m_frames_since_full_scan = m_full_scan_period;
+    m_tracking = false;
+    m_has_previous = false;
+    m_objects.clear();
+    m_field_border.clear();
+    m_regions.clear();
+}
+
+/*! @brief Predicts the windows for the current frame, and decides whether the frame can be searched in those windows only
+    @param horizon the horizon for the current frame
+    @param headyaw the head yaw for the current frame in radians
+    @param focallength the effective distance to the image plane in pixels
+    @param width the width of the image
+    @param height the height of the image
+ */
+void ROITracker::predict(const Horizon& horizon, float headyaw, double focallength, int width, int height)
+{
+    m_regions.clear();
+    m_a = horizon.getA();
+    m_b = horizon.getB();
+    m_c = horizon.getC();
+    m_yaw_shift = m_has_previous ? (headyaw - m_previous_yaw)*focallength : 0;
+
+    m_tracking = m_has_previous and not m_objects.empty() and m_frames_since_full_scan + 1 < m_full_scan_period;
+    if (not m_tracking)
+        return;
+
+    for (size_t i = 0; i < m_objects.size(); i++)
+    {
+        const TrackedObject& object = m_objects[i];
+        Vector2<float> centre = move(object.x, object.y);
+        float motion = fabs(centre.x - object.x) + fabs(centre.y - object.y);
+        int halfwidth = static_cast<int>(0.5*ROI_GROWTH*object.width + ROI_MARGIN + motion);
+        int halfheight = static_cast<int>(0.5*ROI_GROWTH*object.height + ROI_MARGIN + motion);
+
+        int left = max(static_cast<int>(centre.x) - halfwidth, 0);
+        int right = min(static_cast<int>(centre.x) + halfwidth, width - 1);
+        int top = max(static_cast<int>(centre.y) - halfheight, 0);
+        int bottom = min(static_cast<int>(centre.y) + halfheight, height - 1);
+        if (left > right or top > bottom)
+        {   // the object has moved out of the image, so we need to look for it properly
+            m_regions.clear();
+            m_tracking = false;
+            return;
+        }
+        m_regions.push_back(RegionOfInterest(object.type, left, top, right, bottom));
+    }
+
+    for (size_t i = 0; i < m_field_border.size(); i++)
+    {
+        Vector2<float> point = move(m_field_border[i].x, m_field_border[i].y);
+        m_field_border[i].y = min(max(static_cast<int>(point.y), 0), height - 1);
+    }
+}
+
+/*! @brief Returns true if the current frame should only be searched in the regions of interest */
+bool ROITracker::isTracking() const
+{
+    return m_tracking;
+}
+
+/*! @brief Returns the predicted windows for the current frame */
+const vector<RegionOfInterest>& ROITracker::getRegions() const
+{
+    return m_regions;
+}
+
+/*! @brief Returns the field border from the last full frame scan, moved to the current frame */
+vector<Vector2<int> > ROITracker::getFieldBorder() const
+{
+    return m_field_border;
+}
+
+/*! @brief Returns true if every object tracked into the current frame was found again
+    @param objects the field objects after this frame's detection
+    @param timestamp the timestamp of the current frame
+ */
+bool ROITracker::foundAll(FieldObjects* objects, float timestamp) const
+{
+    bool yellowseen = false;
+    bool blueseen = false;
+    for (int i = FieldObjects::FO_BLUE_LEFT_GOALPOST; i <= FieldObjects::FO_YELLOW_RIGHT_GOALPOST; i++)
+    {
+        if (objects->stationaryFieldObjects[i].TimeLastSeen() == timestamp)
+        {
+            if (i == FieldObjects::FO_YELLOW_LEFT_GOALPOST or i == FieldObjects::FO_YELLOW_RIGHT_GOALPOST)
+                yellowseen = true;
+            else
+                blueseen = true;
+        }
+    }
+    for (size_t i = 0; i < objects->ambiguousFieldObjects.size(); i++)
+    {
+        if (objects->ambiguousFieldObjects[i].getID() == FieldObjects::FO_YELLOW_GOALPOST_UNKNOWN)
+            yellowseen = true;
+        else if (objects->ambiguousFieldObjects[i].getID() == FieldObjects::FO_BLUE_GOALPOST_UNKNOWN)
+            blueseen = true;
+    }
+    bool ballseen = objects->mobileFieldObjects[FieldObjects::FO_BALL].TimeLastSeen() == timestamp;
+
+    for (size_t i = 0; i < m_regions.size(); i++)
+    {
+        if (m_regions[i].type == RegionOfInterest::BALL and not ballseen)
+            return false;
+        else if (m_regions[i].type == RegionOfInterest::YELLOW_GOAL and not yellowseen)
+            return false;
+        else if (m_regions[i].type == RegionOfInterest::BLUE_GOAL and not blueseen)
+            return false;
+    }
+    return true;
+}
+
+/*! @brief Records the objects seen in the current frame, so that they can be tracked into the next one
+    @param objects the field objects after this frame's detection
+    @param fieldborder the field border used for this frame
+    @param horizon the horizon for this frame
+    @param headyaw the head yaw for this frame in radians
+    @param timestamp the timestamp of this frame
+    @param fullscan true if this frame was fully scanned, false if only the regions of interest were searched
+ */
+void ROITracker::update(FieldObjects* objects, const vector<Vector2<int> >& fieldborder, const Horizon& horizon, float headyaw, float timestamp, bool fullscan)
+{
+    bool lost = not fullscan and not foundAll(objects, timestamp);
+    if (fullscan)
+    {
+        m_frames_since_full_scan = 0;
+        m_num_full_frames++;
+    }
+    else
+    {
+        m_frames_since_full_scan++;
+        m_num_tracked_frames++;
+    }
+    if (lost)
+    {   // force a full scan on the next frame
+        m_frames_since_full_scan = m_full_scan_period;
+        #if DEBUG_VISION_VERBOSITY > 3
+            debug << "ROITracker::update(). Lost a tracked object; the next frame will be fully scanned" << endl;
+        #endif
+    }
+
+    m_objects.clear();
+    const Object& ball = objects->mobileFieldObjects[FieldObjects::FO_BALL];
+    if (ball.TimeLastSeen() == timestamp)
+        addObject(RegionOfInterest::BALL, ball.ScreenX(), ball.ScreenY(), ball.getObjectWidth(), ball.getObjectHeight());
+    for (int i = FieldObjects::FO_BLUE_LEFT_GOALPOST; i <= FieldObjects::FO_YELLOW_RIGHT_GOALPOST; i++)
+    {
+        const Object& post = objects->stationaryFieldObjects[i];
+        if (post.TimeLastSeen() == timestamp)
+        {
+            RegionOfInterest::Type type = (i == FieldObjects::FO_YELLOW_LEFT_GOALPOST or i == FieldObjects::FO_YELLOW_RIGHT_GOALPOST) ? RegionOfInterest::YELLOW_GOAL : RegionOfInterest::BLUE_GOAL;
+            addObject(type, post.ScreenX(), post.ScreenY(), post.getObjectWidth(), post.getObjectHeight());
+        }
+    }
+    for (size_t i = 0; i < objects->ambiguousFieldObjects.size(); i++)
+    {
+        const Object& post = objects->ambiguousFieldObjects[i];
+        if (post.getID() == FieldObjects::FO_YELLOW_GOALPOST_UNKNOWN)
+            addObject(RegionOfInterest::YELLOW_GOAL, post.ScreenX(), post.ScreenY(), post.getObjectWidth(), post.getObjectHeight());
+        else if (post.getID() == FieldObjects::FO_BLUE_GOALPOST_UNKNOWN)
+            addObject(RegionOfInterest::BLUE_GOAL, post.ScreenX(), post.ScreenY(), post.getObjectWidth(), post.getObjectHeight());
+    }
+
+    if (fullscan)
+        m_field_border = fieldborder;
+    m_previous_a = horizon.getA();
+    m_previous_b = horizon.getB();
+    m_previous_c = horizon.getC();
+    m_previous_yaw = headyaw;
+    m_has_previous = true;
+}
+
+/*! @brief Adds an object to be tracked into the next frame */
+void ROITracker::addObject(RegionOfInterest::Type type, int x, int y, int width, int height)
+{
+    TrackedObject object;
+    object.type = type;
+    object.x = x;
+    object.y = y;
+    object.width = width;
+    object.height = height;
+    m_objects.push_back(object);
+}
+
+/*! @brief Moves a point in the last frame to where it is expected to be in the current frame.
+
+    Changes in head pitch and body roll move the horizon, and everything in the image moves with it, so the point
+    is moved along the current horizon's normal until it is the same distance from the current horizon as it was
+    from the last one. Changes in head yaw are then applied as a horizontal shift.
+ */
+Vector2<float> ROITracker::move(float x, float y) const
+{
+    double previousnorm = sqrt(m_previous_a*m_previous_a + m_previous_b*m_previous_b);
+    double norm = sqrt(m_a*m_a + m_b*m_b);
+    if (previousnorm <= 0 or norm <= 0)
+        return Vector2<float>(x + m_yaw_shift, y);
+
+    double previousdistance = (m_previous_a*x + m_previous_b*y + m_previous_c)/previousnorm;
+    double distance = (m_a*x + m_b*y + m_c)/norm;
+    double shift = previousdistance - distance;
+    return Vector2<float>(x + shift*m_a/norm + m_yaw_shift, y + shift*m_b/norm);
+}
+
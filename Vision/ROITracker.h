@@ -0,0 +1,111 @@
+/*! @file ROITracker.h
+    @brief Declaration of a temporal region of interest tracker for vision
+
+    @class ROITracker
+    @brief Predicts where the objects found in the last frame will be in this frame, so that only those
+           parts of the image need to be searched.
+
+    After each frame update() records the ball and goal posts that were seen, and the horizon and head yaw
+    when they were seen. At the start of the next frame predict() moves each of them by the change in the
+    horizon (head pitch and body roll) and the change in head yaw, and grows a window around each one.
+
+    A full frame scan is requested every m_full_scan_period frames, whenever nothing is being tracked, and
+    after any frame where a tracked object was not found again in its window.
+
+    @author Jason Kulk
+
+  Copyright (c) 2011 Jason Kulk
+
+    This file is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This file is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NUbot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ROITRACKER_H
+#define ROITRACKER_H
+
+#include "Tools/Math/Vector2.h"
+#include <vector>
+
+class Horizon;
+class FieldObjects;
+
+/*! @brief A window in the image where a tracked object is expected to be */
+class RegionOfInterest
+{
+public:
+    enum Type
+    {
+        BALL,
+        YELLOW_GOAL,
+        BLUE_GOAL
+    };
+    RegionOfInterest(Type newtype, int newleft, int newtop, int newright, int newbottom) : type(newtype), left(newleft), top(newtop), right(newright), bottom(newbottom) {};
+    Type type;
+    int left, top, right, bottom;       //!< the bounds of the window in pixels, inclusive
+};
+
+/*! @brief Tracks the ball and goal posts between frames, so that a frame can be searched only in the windows around them.
+
+    Only the ball and goal posts are tracked; field lines, corners, the centre circle and robots are only found in full
+    frame scans. Tracking is off unless a full scan period greater than one is given.
+ */
+class ROITracker
+{
+public:
+    ROITracker(int fullscanperiod = 0);
+    ~ROITracker();
+
+    void setFullScanPeriod(int fullscanperiod);
+    int getFullScanPeriod() const {return m_full_scan_period;}
+    void reset();
+
+    void predict(const Horizon& horizon, float headyaw, double focallength, int width, int height);
+    bool isTracking() const;
+    const std::vector<RegionOfInterest>& getRegions() const;
+    std::vector<Vector2<int> > getFieldBorder() const;
+    bool foundAll(FieldObjects* objects, float timestamp) const;
+    void update(FieldObjects* objects, const std::vector<Vector2<int> >& fieldborder, const Horizon& horizon, float headyaw, float timestamp, bool fullscan);
+
+    int getNumTrackedFrames() const {return m_num_tracked_frames;}
+    int getNumFullFrames() const {return m_num_full_frames;}
+private:
+    /*! @brief An object seen in the last frame */
+    struct TrackedObject
+    {
+        RegionOfInterest::Type type;
+        float x, y;                     //!< the position of the centre of the object in the image
+        float width, height;            //!< the size of the object in the image
+    };
+    void addObject(RegionOfInterest::Type type, int x, int y, int width, int height);
+    Vector2<float> move(float x, float y) const;
+private:
+    int m_full_scan_period;             //!< a full frame scan is done at least every m_full_scan_period frames. Nothing is tracked if this is less than two
+    int m_frames_since_full_scan;       //!< the number of frames since the last full frame scan
+    bool m_tracking;                    //!< true if the current frame should only be searched in the regions of interest
+
+    std::vector<TrackedObject> m_objects;           //!< the objects seen in the last frame
+    std::vector<Vector2<int> > m_field_border;      //!< the field border found in the last full frame scan, moved to the current frame
+    std::vector<RegionOfInterest> m_regions;        //!< the predicted windows for the current frame
+
+    bool m_has_previous;                //!< true if m_previous_* are valid
+    double m_previous_a, m_previous_b, m_previous_c;    //!< the horizon line in the last frame
+    float m_previous_yaw;               //!< the head yaw in the last frame
+    double m_a, m_b, m_c;               //!< the horizon line in the current frame
+    float m_yaw_shift;                  //!< the horizontal shift due to the change in head yaw in pixels
+
+    int m_num_tracked_frames;           //!< the number of frames only searched in the regions of interest
+    int m_num_full_frames;              //!< the number of frames fully scanned
+};
+
+#endif
+
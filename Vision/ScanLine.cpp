@@ -127,7 +127,7 @@ float ScanLine::getFill(float start, float end)
     int ebound = (int)(  end*length);
     if ((int)segments.size() <= 0 && length <= 0) return 0;
 
-    std::vector<TransitionSegment>::iterator it;
+    ArenaVector<TransitionSegment>::type::iterator it;
     for (it = segments.begin(); it != segments.end(); it++)
     {
         if ( (*it).getColour() == ClassIndex::unclassified )
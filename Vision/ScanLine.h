@@ -3,6 +3,7 @@
 
 #include <vector>
 #include "TransitionSegment.h"
+#include "Tools/Memory/ArenaAllocator.h"
 
 class ScanLine
 {
@@ -30,7 +31,7 @@ class ScanLine
         float getFill(float start, float end);
         Vector2<int> getStart();
     private:
-        std::vector<TransitionSegment> segments;
+        ArenaVector<TransitionSegment>::type segments;
         Vector2<int> start;
         int length;
         int direction;
@@ -11,6 +11,8 @@ vector<LinePoint*> SAM::noisePoints;
 unsigned int SAM::noFieldLines;
 unsigned int SAM::MAX_LINES, SAM::MAX_POINTS, SAM::MIN_POINTS_OVER, SAM::MIN_POINTS_TO_LINE, SAM::MIN_POINTS_TO_LINE_FINAL, SAM::SPLIT_NOISE_ITERATIONS;
 double SAM::MAX_END_POINT_DIFF, SAM::MIN_LINE_R2_FIT, SAM::SPLIT_DISTANCE, SAM::MAX_LINE_MSD;
+LineFitter SAM::fitter;
+vector<LinePoint*> SAM::rangePoints;
 //ofstream* SAM::debug_out;
 /*
 std::vector<LinePoint*> SAM::linePoints;
@@ -203,108 +205,85 @@ void SAM::splitLS(vector<LSFittedLine*>& lines, vector<LinePoint*>& points) {
         return;
     }
 
-    //temp variables
-    int points_over = 0; //how many points are further from the line than SAM_THRESHOLD
-    int greatest_point = 0; //which point in vector is the furthest
+    fitter.setPoints(points);
+    splitLSRange(lines, fitter.getAll());
+}
 
-    //LinePoint* temppoint;
+void SAM::splitLSRange(vector<LSFittedLine*>& lines, LineFitter::Range range) {
+    // Recursive split of a range of the fitter's points - not used
 
+    //Boundary Conds
+    if(noFieldLines >= MAX_LINES) {
+        return;
+    }
+    if(range.size() < MIN_POINTS_TO_LINE) {
+        //add points to noise
+        addToNoise(range);
+        return;
+    }
 
-    //generate new LSFittedLine
-    LSFittedLine* line = new LSFittedLine();
+    //temp variables
+    int points_over = 0; //how many points are further from the line than SAM_THRESHOLD
+    int greatest_point = 0; //which point in the fitter is the furthest
 
-    generateLSLine(*line, points);
+    //fit a line to the range, without making an LSFittedLine unless it is kept
+    Line line;
+    fitter.fit(range, line);
 
-    /*
-    //check points for perp distance over threshold
-    for(current_point = 0; current_point < points.size(); current_point++) {
-        distance = line->getLinePointDistance(*(points[current_point]));
-        if(distance > SPLIT_DISTANCE) {
-            //potential splitting point
-            points_over++; //increment points_over counter
-            //check if greatest point
-            if(distance > greatest_distance) {
-                    //new furthest point found
-                    greatest_distance = distance;
-                    greatest_point = current_point;
-            }
-        }
-    }
-    */
     //check for points over threshold
-    findFurthestPoint(*line, points_over, greatest_point);
+    findFurthestPoint(range, line, points_over, greatest_point);
 
     //if num points over threshold > limit -> split at greatest distance point.
     if((unsigned int)points_over >= MIN_POINTS_OVER) {
         //there are enough points distant to justify a split
-        vector<LinePoint*> left;
-        vector<LinePoint*> right;
-        if(separateLS(left, right, points[greatest_point], *line)) {
+        LineFitter::Range left, right;
+        if(separateLS(left, right, greatest_point, range, line)) {
             if(left.size() >= MIN_POINTS_TO_LINE) {
-                splitLS(lines, left);
+                splitLSRange(lines, left);
             }
             else {
                 //add left to noise Points
-                for(unsigned int i=0; i<left.size(); i++)
-                    addToNoise(left[i]);
+                addToNoise(left);
             }
             if(right.size() >= MIN_POINTS_TO_LINE) {
-                splitLS(lines, right);
+                splitLSRange(lines, right);
             }
             else {
                 //add right to noise Points
-                for(unsigned int i=0; i<right.size(); i++)
-                    addToNoise(right[i]);
+                addToNoise(right);
             }
         }
         else {
             //remove furthest point and retry
-            vector<LinePoint*> newlist = points;
-            addToNoise(newlist[greatest_point]);
-            for(unsigned int i=greatest_point; i<newlist.size()-1; i++) {
-                newlist[i] = newlist[i+1];
-            }
-            newlist[newlist.size()-1] = 0;
-            newlist.pop_back();
-            splitLS(lines, newlist);
+            addToNoise(fitter.getPoint(greatest_point));
+            fitter.removePoint(range, greatest_point);
+            splitLSRange(lines, range);
         }
     }
     else if(points_over > 0) {
         //not enough points over to split so remove point as noisy, and regen line
-        if(points.size() > MIN_POINTS_TO_LINE_FINAL) {
+        if(range.size() > MIN_POINTS_TO_LINE_FINAL) {
             //i.e. removal of a point will still leave enough to form a reasonable line
-            vector<LinePoint*> newlist = points;
-            addToNoise(newlist[greatest_point]);
-            for(unsigned int i=greatest_point; i<newlist.size()-1; i++) {
-                newlist[i] = newlist[i+1];
-            }
-            newlist[newlist.size()-1] = 0;
-            newlist.pop_back();
-            delete line; //clear memory of old line
-            line = new LSFittedLine();
-            generateLSLine(*line, newlist);
-            lines.push_back(line);
+            addToNoise(fitter.getPoint(greatest_point));
+            fitter.removePoint(range, greatest_point);
+            lines.push_back(generateLSLine(range));
         }
         else {
             //NOT SURE ??
-            //Add points to noise and delete line
-            //lines.push_back(line);
-            for(unsigned int i=0; i<points.size(); i++)
-                addToNoise(points[i]);
-            line->getPoints().clear();
-            delete line;
-
+            //Add points to noise
+            addToNoise(range);
         }
     }
     else {
         //no points over, just push line
-        lines.push_back(line);
+        lines.push_back(generateLSLine(range));
     }
 }
 
 void SAM::splitLSIterative(vector<LSFittedLine*>& lines, vector<LinePoint*>& points) {
-    //Iterative split algorithm, uses a stack of lines and iterates over it, splitting
-    //each line or adding it to a final list.
+    //Iterative split algorithm, uses a stack of ranges of the points and iterates over it, splitting
+    //each range or adding a line through it to a final list.
+    //The ranges are split in place by the fitter, and a line is only made for a range once it is final
 
     //Boundary Conds
     if(noFieldLines >= MAX_LINES) {
@@ -318,168 +297,97 @@ void SAM::splitLSIterative(vector<LSFittedLine*>& lines, vector<LinePoint*>& poi
     }
 
     //Locals
-    vector<LSFittedLine*> stack;
-    stack.clear();
+    vector<LineFitter::Range> stack;
     int furthest_point;
     int points_over;
-    vector<LinePoint*> left, right;
+    LineFitter::Range range, left, right;
 
-    LSFittedLine* tempLine = new LSFittedLine();
-    //generate first line
-    generateLSLine(*tempLine, points);
-    //push line onto stack
-    stack.push_back(tempLine);
+    //the first range is all of the points
+    fitter.setPoints(points);
+    stack.push_back(fitter.getAll());
 
     //Begin iteration
     while(!stack.empty() && noFieldLines + stack.size() < MAX_LINES) {
-        //Pop the top line off and split it if warranted
-        //if not, slap it on the end of lines and go again
+        //Pop the top range off and split it if warranted
+        //if not, slap a line through it on the end of lines and go again
         //until stack is empty or maximum lines reached
-//qDebug() << stack.size();
-        //Clear left and right
-        left.clear();
-        right.clear();
 
-        //pop top line
-        tempLine = stack.back();
+        //pop top range, and fit a line to it
+        range = stack.back();
         stack.pop_back();
+        Line line;
+        fitter.fit(range, line);
 
         //check for points over threshold
-        findFurthestPoint(*tempLine, points_over, furthest_point);
+        findFurthestPoint(range, line, points_over, furthest_point);
 
         //Options
         if((unsigned int)points_over >= MIN_POINTS_OVER) {
             //See if separation is an option
-            if(separateLS(left, right, tempLine->getPoints()[furthest_point], *tempLine)) {
-                //qDebug() << "separating worked";
-                //clear old line
-                tempLine->getPoints().clear();
-                delete tempLine;
+            if(separateLS(left, right, furthest_point, range, line)) {
                 //check if left is big enough
                 if(left.size() >= MIN_POINTS_TO_LINE) {
-                    //generate line and push it to stack
-                    tempLine = new LSFittedLine();
-                    generateLSLine(*tempLine, left);
-                    stack.push_back(tempLine);
+                    //push it to stack
+                    stack.push_back(left);
                 }
                 else {
                     //throw left points to noise
-                    for(unsigned int i=0; i<left.size(); i++)
-                        addToNoise(left[i]);
-                    left.clear();
+                    addToNoise(left);
                 }
                 //check if right is big enough
                 if(right.size() >= MIN_POINTS_TO_LINE) {
-                    //generate line and push it to stack
-                    tempLine = new LSFittedLine();
-                    generateLSLine(*tempLine, right);
-                    stack.push_back(tempLine);
+                    //push it to stack
+                    stack.push_back(right);
                 }
                 else {
                     //throw right points to noise
-                    for(unsigned int i=0; i<right.size(); i++)
-                        addToNoise(right[i]);
-                    right.clear();
+                    addToNoise(right);
                 }
             } //if(separate())
             else {
                 //Separation didn't work
-                //remove furthest point and push new line
-                vector<LinePoint*> newlist = tempLine->getPoints();
-                //remove noisy point and update points list
-                addToNoise(newlist[furthest_point]);
-                newlist[furthest_point] = newlist[newlist.size() - 1];
-                newlist[newlist.size()-1] = 0;
-                newlist.pop_back();
-                //clear old line
-                tempLine->getPoints().clear();
-                delete tempLine;
-                tempLine = new LSFittedLine();
-                generateLSLine(*tempLine, newlist); //make new line
-                stack.push_back(tempLine); //push it back
+                //remove noisy point and push the rest back
+                addToNoise(fitter.getPoint(furthest_point));
+                fitter.removePoint(range, furthest_point);
+                stack.push_back(range);
             }
         } //if(points_over >= MIN_POINTS_OVER)
         else if(points_over > 0){
             //not enough points over to split - but there are points over
-            if(tempLine->getPoints().size() > MIN_POINTS_TO_LINE_FINAL) {
+            if(range.size() > MIN_POINTS_TO_LINE_FINAL) {
                 //i.e. removal of a point will still leave enough to form a reasonable line
-                //remove noisy point and regen line
-                vector<LinePoint*> newlist = tempLine->getPoints();
-                //remove noisy point and update points list
-                addToNoise(newlist[furthest_point]);
-                newlist[furthest_point] = newlist[newlist.size() - 1];
-                newlist[newlist.size()-1] = 0;
-                newlist.pop_back();
-                tempLine->getPoints().clear();
-                delete tempLine; //clear memory of old line
-                tempLine = new LSFittedLine();
-                generateLSLine(*tempLine, newlist); //make new line
-                //qDebug() << "pushing line";
-                lines.push_back(tempLine); //push it back to finals
+                //remove noisy point and make the line
+                addToNoise(fitter.getPoint(furthest_point));
+                fitter.removePoint(range, furthest_point);
+                lines.push_back(generateLSLine(range)); //push it to finals
                 noFieldLines++;
             }
             else {
-                //Add points to noise and delete line
-                for(unsigned int i=0; i<tempLine->getPoints().size(); i++)
-                    addToNoise(tempLine->getPoints()[i]);
-                tempLine->getPoints().clear();
-                delete tempLine;
+                //Add points to noise
+                addToNoise(range);
             }
         } //elseif(points_over > 0)
         else {
             //no points over, just push line to finals
-            //qDebug() << "pushing line";
-            lines.push_back(tempLine);
+            lines.push_back(generateLSLine(range));
             noFieldLines++;
         }
     } // While(!stack.empty() && noFieldLines + stack.size() <= MAX_LINES)
 
 
-//qDebug() << stack.size();
     //If MAX_LINES reached, but stack is not empty push stack lines to finals
-    if(noFieldLines + stack.size() == MAX_LINES) {
-        //qDebug() << "Maximum Lines reached in split";
-    }
     while(!stack.empty()) {
-        lines.push_back(stack.back());
+        lines.push_back(generateLSLine(stack.back()));
         stack.pop_back();
     }
 }
 
-void SAM::findFurthestPoint(LSFittedLine& line, int& points_over, int& furthest_point) {
-    //this method finds the furthest point from a line and returns (via parameters)
-    //the number of points over the SPLIT_DISTANCE threshold and the index of
+void SAM::findFurthestPoint(const LineFitter::Range& range, const Line& line, int& points_over, int& furthest_point) {
+    //this method finds the furthest point in the range from a line and returns (via parameters)
+    //the number of points over the SPLIT_DISTANCE threshold and the index in the fitter of
     //the furthest point
 
-    //temp variables
-    double distance = 0.0; 	//holder for calculated LinePointDistance
-    double greatest_distance = 0.0; //saves recalculation of greatest point distance
-    unsigned int current_point = 0;
-    points_over = 0;
-    furthest_point = -1;
-    vector<LinePoint*> points = line.getPoints();
-    double A, B, C;
-    A = line.getA();
-    B = line.getB();
-    C = line.getC();
-    double denom = sqrt(A*A + B*B);
-    LinePoint* temp;
-
-    //check points for perp distance over threshold
-    for(current_point = 0; current_point < points.size(); current_point++) {
-        temp = points[current_point];
-        distance = fabs(A * temp->x + B * temp->y - C) / denom;
-        if(distance > SPLIT_DISTANCE) {
-            //potential splitting point
-            points_over++; //increment points_over counter
-            //check if greatest point
-            if(distance > greatest_distance) {
-                    //new furthest point found
-                    greatest_distance = distance;
-                    furthest_point = current_point;
-            }
-        }
-    }
+    furthest_point = fitter.findFurthestPoint(range, line, SPLIT_DISTANCE, points_over);
 }
 
 void SAM::splitNoiseLS(vector<LSFittedLine*>& lines) {
@@ -497,123 +405,18 @@ void SAM::splitNoiseLS(vector<LSFittedLine*>& lines) {
 }
 
 
-bool SAM::separateLS(vector<LinePoint*>& left, vector<LinePoint*>& right, LinePoint* split_point, LSFittedLine& line) {
-        /*splits a section of points around a splitting point by rotating and translating onto the line about the splitting point
-         *Pre: left and right should be empty vectors
-         *		points contains all the points to be split
-         *		split_point is a valid point in points
-         *		line is the LSFittedLine
+bool SAM::separateLS(LineFitter::Range& left, LineFitter::Range& right, unsigned int split_point, const LineFitter::Range& range, const Line& line) {
+        /*splits a range of points around a splitting point by rotating and translating onto the line about the splitting point
+         *Pre: range contains all the points to be split
+         *		split_point is the index of a valid point in range
+         *		line is the line fitted to range
          *Post: left contains all points with negative transformed x-vals
-         *		right contains all points with non-negative transformed x-vals (note split_point will be in right)
-         *      if left or right is empty, returns false indicating no actual split occurred
+         *		right contains all points with non-negative transformed x-vals
+         *      split_point is in both left and right
+         *      if left or right would contain the entire point set, returns false indicating no actual split occurred
+         *      (otherwise there will be an infinite loop), and range is unchanged
         */
-
-        //temp holder vars
-        double A = line.getA();
-        double B = line.getB();
-        double C = line.getC();
-        double x1 = split_point->x;
-        double y1 = split_point->y;
-        vector<LinePoint*> points = line.getPoints();
-        //vector<LinePoint*> points = *points;
-
-        left.push_back(split_point);
-        right.push_back(split_point);
-/*****DEBUGGING OUTPUT******/
-        //printf("\nSplitting on: (%.2f,%.2f)\n",x1,y1);
-/*****DEBUGGING OUTPUT******/
-        if(A==0.0) {
-            //horizontal line - no rotation
-            //x' = x - x0
-            for(unsigned int pointcounter = 0; pointcounter < points.size(); pointcounter++) {
-                //check all points, calculate translated x coord
-                //and place in appropriate vector
-                if(!(points[pointcounter] == split_point)) {
-                    if(points[pointcounter]->x < x1) {
-                        //point is to the left
-                        left.push_back(points[pointcounter]);
-                    }
-                    else {
-                        right.push_back(points[pointcounter]);
-                    }
-                }
-            }
-        }
-        else if(B==0.0) {
-            //vertical line - 90 degree rotation
-            //x' = y - y0
-            for(unsigned int pointcounter = 0; pointcounter < points.size(); pointcounter++) {
-                //check all points, calculate translated x coord
-                //and place in appropriate vector
-                if(!(points[pointcounter] == split_point)) {
-                    if(points[pointcounter]->y < y1) {
-                        //point is to the left
-                        left.push_back(points[pointcounter]);
-                    }
-                    else {
-                        right.push_back(points[pointcounter]);
-                    }
-                }
-            }
-        }
-        else {
-         // STILL TO DO: FIX MATRIX CALCS
-
-            //sloped line
-            //x' = (x - x0)cosa + (y - y0)sina
-            //a = atan(-A/B)
-            //(x0,y0) from [ a, b; b, -a][x; y] = [c; bx1 - ay1]
-            double alpha = atan(-A/B);
-            double cosalpha = cos(alpha);
-            double sinalpha = sin(alpha);
-            double xtrans;
-            // Mx = k  ->  x = M^-1k
-            //M = |A   B|
-            //    |B  -A|
-
-            // k = |    c    |
-            //     | bx1-ay1 |
-            double KB;
-            KB = (B*x1) - (A*y1);
-
-            //invert M
-            // InvM = |-A/div  -B  |
-            //        |  -B   A/div|
-            // div = A*-A - B*B
-            double IA, ID;
-            double div = (-A)*A - (B*B);
-            IA = (-A)/div;
-            ID = -IA;
-
-            //X = A*K
-            //  = |-A/div  -B  |  |    c    |
-            //    |  -B   A/div|  | bx1-ay1 |
-
-            double X0 = IA*C + (-B)*KB;
-            double X1 = (-B)*C + ID*KB;
-
-            for(unsigned int pointcounter = 0; pointcounter <points.size(); pointcounter++) {
-                //check all points, calculate translated x coord
-                //and place in appropriate vector
-                if(!(points[pointcounter] == split_point)) {
-                    xtrans = (points[pointcounter]->x - X0)*cosalpha + (points[pointcounter]->y - X1)*sinalpha;
-                    if(xtrans < 0) {
-                        //point is to the left
-                        left.push_back(points[pointcounter]);
-                    }
-                    else {
-                        right.push_back(points[pointcounter]);
-                    }
-                }
-            }
-        }
-        //if either left or right contains entire point set then there will be an
-        //infinite loop
-        //qDebug() << "Old line size: " << line.getPoints().size() << " Left size: " << left.size() << " Right size: " << right.size();
-        if(left.size() == points.size() || right.size() == points.size())
-            return false;
-        return true;
-
+        return fitter.separate(range, split_point, line, left, right);
 }
 
 
@@ -658,11 +461,13 @@ void SAM::mergeLS(vector<LSFittedLine*>& lines) {
 }
 
 
-void SAM::generateLSLine(LSFittedLine& line, vector<LinePoint*>& points) {
-    //creates a Least Squared Fitted line
+LSFittedLine* SAM::generateLSLine(const LineFitter::Range& range) {
+    //creates a Least Squared Fitted line from a range of the fitter's points
 
-    line.clearPoints();
-    line.addPoints(points);
+    LSFittedLine* line = new LSFittedLine();
+    fitter.getPoints(range, rangePoints);
+    line->addPoints(rangePoints);
+    return line;
 }
 
 
@@ -683,6 +488,11 @@ void SAM::addToNoise(LinePoint* point) {
     }
 }
 
+void SAM::addToNoise(const LineFitter::Range& range) {
+    for(unsigned int i=range.Begin; i<range.End; i++)
+        addToNoise(fitter.getPoint(i));
+}
+
 
 void SAM::clearSmallLines(vector<LSFittedLine*>& lines) {
     //removes any lines from the vector whose vector of
@@ -766,12 +576,15 @@ bool SAM::shouldMergeLines(const LSFittedLine& line1, const LSFittedLine& line2)
     endPointsGood = (fabs(leftY1-leftY2) <= MAX_END_POINT_DIFF) && (fabs(rightY1-rightY2) <= MAX_END_POINT_DIFF);
 
 
-    //R2TLS and MSD
+    if(!endPointsGood)
+        return false;
+
+    //R2TLS and MSD - from the lines' sums, so this does not visit the points
     Vector2<double> results = line1.combinedR2TLSandMSD(line2);
     bool R2TLS_is_OK = (results.x >= MIN_LINE_R2_FIT);
     bool MSD_is_OK = (results.y <= MAX_LINE_MSD);
 
-    return endPointsGood && R2TLS_is_OK && MSD_is_OK;
+    return R2TLS_is_OK && MSD_is_OK;
 
 
     //double angle = fabs(line1.getAngle() - line2.getAngle());
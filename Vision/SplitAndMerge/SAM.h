@@ -19,6 +19,8 @@
          + separateLS() - divides point set into two subsets based on the line equation and the furthest point
                 uses a transform to axis defined by the line itself, and the normal from the furthest point
                 to the line.
+                (the geometry of both is in LineFitter, which splits ranges of the points in place, and fits
+                a line to a range without visiting the points)
          + shouldMergeLines() - decisions on whether two lines should be merged
 
          - All other methods are trivial or only make simple decisions based on the parameters set
@@ -35,6 +37,7 @@
 //#include <iostream>
 //#include <fstream>
 #include "Tools/Math/LSFittedLine.h"
+#include "Tools/Math/LineFitter.h"
 #include "Tools/Math/Matrix.h"
 #include "Tools/Math/Vector3.h"
 
@@ -98,18 +101,23 @@ private:
     */
 
     //LEAST-SQUARES FITTING
+    static LineFitter fitter;               //!< the points being split, which the ranges below are of
+    static vector<LinePoint*> rangePoints;  //!< the points of a range as they are copied into a line
+
     static void splitLS(vector<LSFittedLine*>& lines, vector<LinePoint*>& points);
+    static void splitLSRange(vector<LSFittedLine*>& lines, LineFitter::Range range);
     static void splitLSIterative(vector<LSFittedLine*>& lines, vector<LinePoint*>& points);
     static void splitNoiseLS(vector<LSFittedLine*>& lines);
     static void mergeLS(vector<LSFittedLine*>& lines);
-    static void generateLSLine(LSFittedLine& line, vector<LinePoint*>& points);
-    static bool separateLS(vector<LinePoint*>& left, vector<LinePoint*>& right, LinePoint* split_point, LSFittedLine& line);
+    static LSFittedLine* generateLSLine(const LineFitter::Range& range);
+    static bool separateLS(LineFitter::Range& left, LineFitter::Range& right, unsigned int split_point, const LineFitter::Range& range, const Line& line);
     //static void sortLinesLS(vector<LSFittedLine*>& lines);
 
 
     //GENERIC
-    static void findFurthestPoint(LSFittedLine& line, int& points_over, int& furthest_point);
+    static void findFurthestPoint(const LineFitter::Range& range, const Line& line, int& points_over, int& furthest_point);
     static void addToNoise(LinePoint* point);
+    static void addToNoise(const LineFitter::Range& range);
     static void clearSmallLines(vector<LSFittedLine*>& lines);
     static void clearDirtyLines(vector<LSFittedLine*>& lines);
     static bool shouldMergeLines(const LSFittedLine& line1, const LSFittedLine& line2);
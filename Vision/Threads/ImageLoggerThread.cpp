@@ -0,0 +1,254 @@
+/*! @file ImageLoggerThread.cpp
+    @brief Implementation of a low priority thread for logging images and sensor data to disk.
+ 
+    @author Jason Kulk
+ 
+  Copyright (c) 2011 Jason Kulk
+ 
+     This program is free software: you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation, either version 3 of the License, or
+     (at your option) any later version.
+     
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+     
+     You should have received a copy of the GNU General Public License
+     along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ImageLoggerThread.h"
+#include "Infrastructure/NUImage/NUImage.h"
+#include "Infrastructure/NUSensorsData/NUSensorsData.h"
+
+#include "debug.h"
+#include "debugverbosityvision.h"
+
+#include <sstream>
+
+using namespace std;
+
+/*! @brief Constructs and starts the image logger thread. The files are not opened until the first frame is written
+    @param imagefilename the path to the image stream
+    @param sensorfilename the path to the sensor stream
+    @param maxqueuesize the maximum number of frames waiting to be written
+    @param policy what to do with a frame when the queue is full
+ */
+ImageLoggerThread::ImageLoggerThread(const string& imagefilename, const string& sensorfilename, unsigned int maxqueuesize, DropPolicy policy) : Thread(string("ImageLoggerThread"), 0)
+{
+    #if DEBUG_VISION_VERBOSITY > 0
+        debug << "ImageLoggerThread::ImageLoggerThread(" << imagefilename << ", " << sensorfilename << ", " << maxqueuesize << ", " << policy << ") with priority " << static_cast<int>(m_priority) << endl;
+    #endif
+    m_image_filename = imagefilename;
+    m_sensor_filename = sensorfilename;
+    m_image_file_buffer = new char[m_file_buffer_size];
+    m_sensor_file_buffer = new char[m_file_buffer_size];
+    
+    m_max_queue_size = maxqueuesize > 0 ? maxqueuesize : 1;
+    m_policy = policy;
+    m_flush_requested = false;
+    m_stopping = false;
+    m_frames_logged = 0;
+    m_frames_dropped = 0;
+    m_bytes_written = 0;
+    pthread_mutex_init(&m_queue_mutex, NULL);
+    pthread_cond_init(&m_queue_condition, NULL);
+    start();
+}
+
+ImageLoggerThread::~ImageLoggerThread()
+{
+    #if DEBUG_VISION_VERBOSITY > 0
+        debug << "ImageLoggerThread::~ImageLoggerThread(). Logged: " << m_frames_logged << " Dropped: " << m_frames_dropped << " Bytes: " << m_bytes_written << endl;
+    #endif
+    // the thread writes everything that is still queued before it exits, so the queue is empty once it has been joined
+    pthread_mutex_lock(&m_queue_mutex);
+    m_stopping = true;
+    pthread_cond_signal(&m_queue_condition);
+    pthread_mutex_unlock(&m_queue_mutex);
+    join();
+    for (size_t i = 0; i < m_queue.size(); i++)
+        discard(m_queue[i]);
+    m_image_file.close();
+    m_sensor_file.close();
+    delete [] m_image_file_buffer;
+    delete [] m_sensor_file_buffer;
+    pthread_cond_destroy(&m_queue_condition);
+    pthread_mutex_destroy(&m_queue_mutex);
+}
+
+/*! @brief Queues a frame and its sensor data to be written. The disk is not touched by this function.
+    @param image the image to log. If it came from a CameraBufferRing its buffer is held until it has been written, otherwise it is copied
+    @param data the sensor data to log with the image, which is copied and serialised by the logger thread
+    @return true if the frame was queued, false if it was dropped
+ */
+bool ImageLoggerThread::log(const NUImage* image, const NUSensorsData* data)
+{
+    if (image == NULL)
+        return false;
+    
+    LogEntry entry;
+    entry.frame = CameraBufferRing::hold(image);
+    entry.copy = entry.frame.isValid() ? NULL : new NUImage(*image);
+    entry.sensors = data ? new NUSensorsData(*data) : NULL;
+    
+    bool queued = true;
+    pthread_mutex_lock(&m_queue_mutex);
+    if (m_queue.size() >= m_max_queue_size)
+    {
+        m_frames_dropped++;
+        if (m_policy == DropOldest)
+        {
+            discard(m_queue.front());
+            m_queue.pop_front();
+        }
+        else
+            queued = false;
+    }
+    if (queued)
+    {
+        m_queue.push_back(entry);
+        pthread_cond_signal(&m_queue_condition);
+    }
+    pthread_mutex_unlock(&m_queue_mutex);
+    
+    if (not queued)
+        discard(entry);
+    return queued;
+}
+
+/*! @brief Requests that the files are flushed once every queued frame has been written */
+void ImageLoggerThread::flush()
+{
+    pthread_mutex_lock(&m_queue_mutex);
+    m_flush_requested = true;
+    pthread_cond_signal(&m_queue_condition);
+    pthread_mutex_unlock(&m_queue_mutex);
+}
+
+/*! @brief Returns the number of frames that have been written */
+unsigned int ImageLoggerThread::getFramesLogged()
+{
+    pthread_mutex_lock(&m_queue_mutex);
+    unsigned int value = m_frames_logged;
+    pthread_mutex_unlock(&m_queue_mutex);
+    return value;
+}
+
+/*! @brief Returns the number of frames that were discarded because the queue was full */
+unsigned int ImageLoggerThread::getFramesDropped()
+{
+    pthread_mutex_lock(&m_queue_mutex);
+    unsigned int value = m_frames_dropped;
+    pthread_mutex_unlock(&m_queue_mutex);
+    return value;
+}
+
+/*! @brief Returns the number of bytes written to the image and sensor streams */
+unsigned long long ImageLoggerThread::getBytesWritten()
+{
+    pthread_mutex_lock(&m_queue_mutex);
+    unsigned long long value = m_bytes_written;
+    pthread_mutex_unlock(&m_queue_mutex);
+    return value;
+}
+
+/*! @brief Returns the number of frames waiting to be written */
+unsigned int ImageLoggerThread::getQueueSize()
+{
+    pthread_mutex_lock(&m_queue_mutex);
+    unsigned int value = m_queue.size();
+    pthread_mutex_unlock(&m_queue_mutex);
+    return value;
+}
+
+/*! @brief The image logger's main loop. Writes queued frames until the logger is destroyed, and then writes what is left in the queue
+ */
+void ImageLoggerThread::run()
+{
+    #if DEBUG_VISION_VERBOSITY > 0
+        debug << "ImageLoggerThread::run()" << endl;
+    #endif
+    
+    while (true)
+    {
+        pthread_mutex_lock(&m_queue_mutex);
+        while (m_queue.empty() and not m_flush_requested and not m_stopping)
+            pthread_cond_wait(&m_queue_condition, &m_queue_mutex);
+        
+        if (m_queue.empty())
+        {   // there is nothing left to write, so do the requested flush, and exit if we have been asked to
+            bool stopping = m_stopping;
+            m_flush_requested = false;
+            pthread_mutex_unlock(&m_queue_mutex);
+            m_image_file.flush();
+            m_sensor_file.flush();
+            if (stopping)
+                break;
+            else
+                continue;
+        }
+        
+        LogEntry entry = m_queue.front();
+        m_queue.pop_front();
+        pthread_mutex_unlock(&m_queue_mutex);
+        // -----------------------------------------------------------------------------------------------------------------------------------------------------------------
+        unsigned long long bytes = write(entry);
+        discard(entry);
+        // -----------------------------------------------------------------------------------------------------------------------------------------------------------------
+        pthread_mutex_lock(&m_queue_mutex);
+        m_frames_logged++;
+        m_bytes_written += bytes;
+        pthread_mutex_unlock(&m_queue_mutex);
+    }
+}
+
+/*! @brief Releases the image and sensor data held by an entry */
+void ImageLoggerThread::discard(LogEntry& entry)
+{
+    entry.frame.release();
+    delete entry.copy;
+    entry.copy = NULL;
+    delete entry.sensors;
+    entry.sensors = NULL;
+}
+
+/*! @brief Writes an entry to the image and sensor streams
+    @return the number of bytes written
+ */
+unsigned long long ImageLoggerThread::write(LogEntry& entry)
+{
+    openFiles();
+    
+    const NUImage* image = entry.frame.isValid() ? entry.frame.image() : entry.copy;
+    m_image_file << (*image);
+    m_sensor_buffer.str("");
+    if (entry.sensors)
+        m_sensor_buffer << (*entry.sensors);
+    const string sensors = m_sensor_buffer.str();
+    m_sensor_file.write(sensors.c_str(), sensors.size());
+    
+    if (m_image_file.fail() or m_sensor_file.fail())
+        errorlog << "ImageLoggerThread::write(). Failed to write frame " << m_frames_logged << endl;
+    
+    unsigned long long imagebytes = 2*sizeof(int) + sizeof(double) + image->getTotalPixels()*sizeof(Pixel);
+    return imagebytes + sensors.size();
+}
+
+/*! @brief Opens the image and sensor streams if they are not already open */
+void ImageLoggerThread::openFiles()
+{
+    if (not m_image_file.is_open())
+    {
+        m_image_file.rdbuf()->pubsetbuf(m_image_file_buffer, m_file_buffer_size);
+        m_image_file.open(m_image_filename.c_str(), ios_base::out | ios_base::binary);
+    }
+    if (not m_sensor_file.is_open())
+    {
+        m_sensor_file.rdbuf()->pubsetbuf(m_sensor_file_buffer, m_file_buffer_size);
+        m_sensor_file.open(m_sensor_filename.c_str(), ios_base::out | ios_base::binary);
+    }
+}
+
@@ -0,0 +1,109 @@
+/*! @file ImageLoggerThread.h
+    @brief Declaration of a low priority thread for logging images and sensor data to disk.
+
+    @class ImageLoggerThread
+    @brief A background thread that writes queued frames and their sensor data to the image and sensor streams.
+ 
+    Frames are added to a bounded queue with log(), which never touches the disk. Frames that came from a
+    CameraBufferRing are queued as CameraFrames, so the camera buffer is held until it has been written
+    and no pixels are copied. Other images are copied into the queue. The sensor data is copied into the
+    queue too, and is serialised by the logger thread rather than the thread calling log().
+ 
+    When the queue is full a frame is dropped according to the DropPolicy, so a slow disk costs frames
+    rather than vision latency. The files are written through large buffers so that the disk sees large
+    sequential writes, and counters for frames logged, frames dropped and bytes written are kept so that
+    it is obvious when the storage can not keep up.
+ 
+    Destroying the logger writes the frames that are still queued, and waits for the thread to finish.
+ 
+    @author Jason Kulk
+ 
+  Copyright (c) 2011 Jason Kulk
+ 
+     This program is free software: you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation, either version 3 of the License, or
+     (at your option) any later version.
+     
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+     
+     You should have received a copy of the GNU General Public License
+     along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef IMAGELOGGER_THREAD_H
+#define IMAGELOGGER_THREAD_H
+
+#include "Tools/Threading/Thread.h"
+#include "NUPlatform/NUCamera/CameraBufferRing.h"
+
+#include <string>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <pthread.h>
+
+class NUImage;
+class NUSensorsData;
+
+class ImageLoggerThread : public Thread
+{
+public:
+    enum DropPolicy
+    {
+        DropOldest,             //!< when the queue is full the oldest queued frame is discarded to make room
+        DropNewest              //!< when the queue is full the new frame is discarded
+    };
+public:
+    ImageLoggerThread(const std::string& imagefilename, const std::string& sensorfilename, unsigned int maxqueuesize = 8, DropPolicy policy = DropOldest);
+    ~ImageLoggerThread();
+    
+    bool log(const NUImage* image, const NUSensorsData* data);
+    void flush();
+    
+    unsigned int getFramesLogged();
+    unsigned int getFramesDropped();
+    unsigned long long getBytesWritten();
+    unsigned int getQueueSize();
+protected:
+    void run();
+private:
+    /*! @brief A single frame waiting to be written */
+    struct LogEntry
+    {
+        CameraFrame frame;              //!< a handle to the camera buffer, if the image came from a CameraBufferRing
+        NUImage* copy;                  //!< a copy of the image, if it did not
+        NUSensorsData* sensors;         //!< a copy of the sensor data, or NULL if there is none
+    };
+    void discard(LogEntry& entry);
+    unsigned long long write(LogEntry& entry);
+    void openFiles();
+private:
+    static const unsigned int m_file_buffer_size = 1 << 20;  //!< the size of the buffer for each file, so that the disk sees large sequential writes
+    
+    std::string m_image_filename;       //!< the path to the image stream
+    std::string m_sensor_filename;      //!< the path to the sensor stream
+    std::ofstream m_image_file;         //!< the image stream
+    std::ofstream m_sensor_file;        //!< the sensor stream
+    char* m_image_file_buffer;          //!< the buffer for the image stream
+    char* m_sensor_file_buffer;         //!< the buffer for the sensor stream
+    std::stringstream m_sensor_buffer;  //!< the sensor data of the frame being written, serialised here so that its size is known
+    
+    unsigned int m_max_queue_size;      //!< the maximum number of frames waiting to be written
+    DropPolicy m_policy;                //!< what to do with a frame when the queue is full
+    std::deque<LogEntry> m_queue;       //!< the frames waiting to be written
+    bool m_flush_requested;             //!< true if the files should be flushed once the queue is empty
+    bool m_stopping;                    //!< true when the thread has been asked to write what is queued and exit
+    pthread_mutex_t m_queue_mutex;      //!< lock for the queue, flag and counters
+    pthread_cond_t m_queue_condition;   //!< signalled when a frame is added or a flush is requested
+    
+    unsigned int m_frames_logged;       //!< the number of frames that have been written
+    unsigned int m_frames_dropped;      //!< the number of frames that were discarded because the queue was full
+    unsigned long long m_bytes_written; //!< the number of bytes written to both streams
+};
+
+#endif
+
@@ -21,7 +21,7 @@ ENDIF()
 
 ########## List your source files here! ############################################
 SET (YOUR_SRCS
-SaveImagesThread
+ImageLoggerThread.cpp ImageLoggerThread.h
 )
 ####################################################################################
 ########## List your subdirectories here! ##########################################
@@ -29,25 +29,40 @@
 #include "NUPlatform/NUActionators/NUSounds.h"
 #include "NUPlatform/NUIO.h"
 
-#include "Vision/Threads/SaveImagesThread.h"
+#include "Vision/Threads/ImageLoggerThread.h"
 #include <iostream>
+#include <fstream>
 
 //#include <QDebug>
 
 using namespace mathGeneral;
+
+static const double ROI_MAX_FRAME_GAP = 100;    //!< the largest time in ms between frames for the objects in one to be tracked into the next
+
 Vision::Vision()
 {
     classifiedCounter = 0;
-    LUTBuffer = new unsigned char[LUTTools::LUT_SIZE];
+    currentImage = NULL;
+    m_timestamp = 0;
+    m_sensor_data = NULL;
+    m_actions = NULL;
+    LUTBuffer = new unsigned char[LUTTools::LUT_SIZE]();
     currentLookupTable = LUTBuffer;
-    loadLUTFromFile(string(DATA_DIR) + string("default.lut"));
-    m_saveimages_thread = new SaveImagesThread(this);
+    // use the memory mapped compact table if there is one, otherwise the dense table is loaded and compacted
+    m_use_compact_lut = m_compact_lut.load((string(DATA_DIR) + string("default.clut")).c_str());
+    if (m_use_compact_lut)
+        m_compact_lut.toDense(LUTBuffer);
+    else
+        loadLUTFromFile(string(DATA_DIR) + string("default.lut"));
+    m_image_logger = new ImageLoggerThread(string(DATA_DIR) + string("image.strm"), string(DATA_DIR) + string("sensor.strm"));
     isSavingImages = false;
     isSavingImagesWithVaryingSettings = false;
     numSavedImages = 0;
     ImageFrameNumber = 0;
     numFramesDropped = 0;
     numFramesProcessed = 0;
+    m_green_border_density = 1;
+    loadROITracking();
 
     return;
 }
@@ -55,9 +70,11 @@ Vision::Vision()
 Vision::~Vision()
 {
     // delete AllFieldObjects;
+    #if DEBUG_VISION_VERBOSITY > 0
+        debug << "Vision::~Vision(). The largest frame used " << m_frame_arena.getMaxPeak() << " bytes of the frame arena." << endl;
+    #endif
     delete [] LUTBuffer;
-    imagefile.close();
-    sensorfile.close();
+    delete m_image_logger;
     return;
 }
 
@@ -82,16 +99,14 @@ void Vision::process(JobList* jobs)
                 if(job->saving() == true)
                 {
                     currentSettings = currentImage->getCameraSettings();
-                    if (!imagefile.is_open())
-                        imagefile.open((string(DATA_DIR) + string("image.strm")).c_str());
-                    if (!sensorfile.is_open())
-                        sensorfile.open((string(DATA_DIR) + string("sensor.strm")).c_str());
                     m_actions->add(NUActionatorsData::Sound, m_sensor_data->CurrentTime, NUSounds::START_SAVING_IMAGES);
                 }
                 else
                 {
-                    imagefile.flush();
-                    sensorfile.flush();
+                    m_image_logger->flush();
+                    #if DEBUG_VISION_VERBOSITY > 0
+                        debug << "Vision::process(). Stopped saving images. Logged: " << m_image_logger->getFramesLogged() << " Dropped: " << m_image_logger->getFramesDropped() << " Bytes: " << m_image_logger->getBytesWritten() << endl;
+                    #endif
 
                     ChangeCameraSettingsJob* newJob  = new ChangeCameraSettingsJob(currentSettings);
                     jobs->addCameraJob(newJob);
@@ -118,6 +133,10 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
 
     if (image == NULL || data == NULL || actions == NULL || fieldobjects == NULL)
         return;
+    #if DEBUG_VISION_VERBOSITY > 4
+        debug << "Vision::ProcessFrame(). Last frame used " << m_frame_arena.getLastPeak() << " bytes of the frame arena in " << m_frame_arena.getLastNumAllocations() << " allocations. The largest frame used " << m_frame_arena.getMaxPeak() << " bytes." << endl;
+    #endif
+    FrameArena::Scope arenascope(m_frame_arena);     // everything allocated from the arena in this frame is released when we return
     m_sensor_data = data;
     m_actions = actions;
 
@@ -126,6 +145,9 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
     if (currentImage != NULL and image->m_timestamp - m_timestamp > 40)
         numFramesDropped++;
     numFramesProcessed++;
+    // the windows are predicted from the last frame, so nothing can be tracked across a gap, or when a log is played back out of order
+    if (currentImage == NULL or image->m_timestamp <= m_timestamp or image->m_timestamp - m_timestamp > ROI_MAX_FRAME_GAP)
+        m_roi_tracker.reset();
         
     setImage(image);
     //debug << "Camera Settings: " << image->getCameraSettings();
@@ -147,9 +169,9 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
     if(isSavingImages)
     {
         #if DEBUG_VISION_VERBOSITY > 1
-            debug << "Vision::starting the save images loop." << endl;
+            debug << "Vision::queueing an image to be saved." << endl;
         #endif
-        m_saveimages_thread->signal();
+        SaveAnImage();
     }
     #if DEBUG_VISION_VERBOSITY > 5
         debug << "Generating Horizon Line: " <<endl;
@@ -168,6 +190,19 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
         return;
     }
 
+    //! Only search the windows around the ball and goals seen in the last frame when they can be tracked. Lines and robots are only found in full scans
+    float headyaw = 0;
+    m_sensor_data->getPosition(NUSensorsData::HeadYaw, headyaw);
+    m_roi_tracker.predict(m_horizonLine, headyaw, EFFECTIVE_CAMERA_DISTANCE_IN_PIXELS(), currentImage->getWidth(), currentImage->getHeight());
+    if (m_roi_tracker.isTracking())
+    {
+        points = m_roi_tracker.getFieldBorder();
+        processRegionsOfInterest(points);
+        AllFieldObjects->postProcess(image->m_timestamp);
+        m_roi_tracker.update(AllFieldObjects, points, m_horizonLine, headyaw, image->m_timestamp, false);
+        return;
+    }
+
     #if DEBUG_VISION_VERBOSITY > 7
         debug << "Generating Horizon Line: Finnished" <<endl;
         debug << "Image(0,0) is below: " << horizonLine.IsBelowHorizon(0, 0)<< endl;
@@ -194,7 +229,7 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
     debug << "Begin Scanning: " << endl;
     #endif
 
-    points = findGreenBorderPoints(spacings,&m_horizonLine);
+    points = findGreenBorderPoints(getGreenBorderSpacing(spacings), &m_horizonLine);
 
     #if DEBUG_VISION_VERBOSITY > 5
         debug << "\tFind Edges: finnished" << endl;
@@ -475,6 +510,7 @@ void Vision::ProcessFrame(NUImage* image, NUSensorsData* data, NUActionatorsData
         debug << "Finished Object Recognition: " <<endl;
     #endif
     AllFieldObjects->postProcess(image->m_timestamp);
+    m_roi_tracker.update(AllFieldObjects, points, m_horizonLine, headyaw, image->m_timestamp, true);
 
     if(AllFieldObjects->stationaryFieldObjects[FieldObjects::FO_CORNER_CENTRE_CIRCLE].isObjectVisible())
     {
@@ -578,20 +614,9 @@ void Vision::SaveAnImage()
         debug << "Vision::SaveAnImage(). Starting..." << endl;
     #endif
 
-    if (!imagefile.is_open())
-        imagefile.open((string(DATA_DIR) + string("image.strm")).c_str());
-    if (!sensorfile.is_open())
-        sensorfile.open((string(DATA_DIR) + string("sensor.strm")).c_str());
-
-    if (imagefile.is_open() and numSavedImages < 2500)
+    // the image is only queued here, the image logger thread does the writing
+    if (numSavedImages < 2500 and m_image_logger->log(currentImage, m_sensor_data))
     {
-        if(sensorfile.is_open())
-        {
-            sensorfile << (*m_sensor_data) << flush;
-        }
-        NUImage buffer;
-        buffer.cloneExisting(*currentImage);
-        imagefile << buffer;
         numSavedImages++;
         
         if (isSavingImagesWithVaryingSettings)
@@ -665,19 +690,39 @@ void Vision::setFieldObjects(FieldObjects* fieldObjects)
     return;
 }
 
+/*! @brief Sets the dense lookup table used to classify pixels. The table is used directly, so changes to it take effect immediately */
 void Vision::setLUT(unsigned char* newLUT)
 {
     currentLookupTable = newLUT;
+    m_use_compact_lut = false;
     return;
 }
 
+/*! @brief Loads the lookup table used to classify pixels from a file. 
+ 
+    A compact lookup table is memory mapped and used directly. A dense lookup table is loaded and then compacted,
+    so that it fits in the cache. Either way the dense table (LUTBuffer) is filled, because NUview and saving the
+    table still read it.
+ */
 void Vision::loadLUTFromFile(const std::string& fileName)
 {
     LUTTools lutLoader;
-    if (lutLoader.LoadLUT(LUTBuffer, LUTTools::LUT_SIZE,fileName.c_str()) == true)
+    if (m_compact_lut.load(fileName.c_str()))
+    {
+        m_compact_lut.toDense(LUTBuffer);
+        currentLookupTable = LUTBuffer;
+        m_use_compact_lut = true;
+    }
+    else if (lutLoader.LoadLUT(LUTBuffer, LUTTools::LUT_SIZE,fileName.c_str()) == true)
+    {
         setLUT(LUTBuffer);
+        m_use_compact_lut = m_compact_lut.build(LUTBuffer);
+    }
     else
+    {
+        m_use_compact_lut = false;
         errorlog << "Vision::loadLUTFromFile(" << fileName << "). Failed to load lut." << endl;
+    }
 }
 
 void Vision::setImage(const NUImage* newImage)
@@ -687,6 +732,14 @@ void Vision::setImage(const NUImage* newImage)
     m_timestamp = currentImage->m_timestamp;
     spacings = (int)(currentImage->getWidth()/20); //16 for Robot, 8 for simulator = width/20
     ImageFrameNumber++;
+
+    // the ray tables are only rebuilt when the image size changes, and the transform is only copied when it has moved
+    m_ray_table.setCalibration(currentImage->getWidth(), currentImage->getHeight(), deg2rad(45.0f), deg2rad(34.80f));
+    vector<float> ctgvector;
+    if (m_sensor_data and m_sensor_data->get(NUSensorsData::CameraToGroundTransform, ctgvector))
+        m_ray_table.setCameraToGroundTransform(ctgvector);
+    else
+        m_ray_table.clearCameraToGroundTransform();
 }
 
 
@@ -703,7 +756,9 @@ void Vision::classifyPreviewImage(ClassifiedImage &target,unsigned char* tempLut
     //qDebug() << "Set Dimensions:";
     //currentImage = sourceImage;
     const unsigned char * beforeLUT = currentLookupTable;
+    bool beforeUseCompact = m_use_compact_lut;
     currentLookupTable = tempLut;
+    m_use_compact_lut = false;
     //qDebug() << "Begin Loop:";
     for (int y = 0; y < height; y++)
     {
@@ -714,6 +769,7 @@ void Vision::classifyPreviewImage(ClassifiedImage &target,unsigned char* tempLut
     }
     classifiedCounter = tempClassCounter;
     currentLookupTable = beforeLUT;
+    m_use_compact_lut = beforeUseCompact;
     return;
 }
 void Vision::classifyImage(ClassifiedImage &target)
@@ -740,40 +796,78 @@ void Vision::classifyImage(ClassifiedImage &target)
     return;
 }
 
+/*! @brief Finds the top of the field in each sampled column, that is, the first run of 10 green pixels below the horizon.
+
+    The columns are scanned together one row at a time, rather than one column at a time, so that each image
+    row is only walked once and the scan stops as soon as the last column has found its border. Each column joins
+    the scan at the row where it crosses the horizon, and keeps a branch free count of consecutive green pixels.
+
+    @param scanSpacing the distance between sampled columns in pixels
+    @param horizonLine the horizon; only pixels below it are searched
+    @return the border point of each column that has one, ordered by x
+ */
 std::vector< Vector2<int> > Vision::findGreenBorderPoints(int scanSpacing, Horizon* horizonLine)
 {
+    const int MIN_CONSECUTIVE_GREEN = 10;
     classifiedCounter = 0;
     std::vector< Vector2<int> > results;
     //debug << "Finding Green Boarders: "  << scanSpacing << "  Under Horizon: " << horizonLine->getA() << "x + " << horizonLine->getB() << "y + " << horizonLine->getC() << " = 0" << endl;
 
     int width = currentImage->getWidth();
     int height = currentImage->getHeight();
-    //debug << width << " , "<< height << endl;
-    int yStart;
-    int consecutiveGreenPixels = 0;
-    for (int x = 0; x < width; x+=scanSpacing)
+    if (scanSpacing < 1)
+        scanSpacing = 1;
+    int numcolumns = (width + scanSpacing - 1)/scanSpacing;
+
+    ArenaVector<int>::type ystart(numcolumns);
+    ArenaVector<int>::type consecutive(numcolumns, 0);
+    ArenaVector<int>::type border(numcolumns, -1);
+    ArenaVector<int>::type waiting;             // the columns that have not started, sorted so that the last one starts first
+    ArenaVector<int>::type active;              // the columns currently being scanned
+    waiting.reserve(numcolumns);
+    active.reserve(numcolumns);
+    for (int c = numcolumns - 1; c >= 0; c--)
+    {
+        int y = (int)horizonLine->findYFromX(c*scanSpacing);
+        if (y >= height)
+            continue;
+        ystart[c] = std::max(y, 0);
+        unsigned int i = waiting.size();
+        waiting.push_back(c);
+        for (; i > 0 and ystart[waiting[i-1]] < ystart[c]; i--)
+            waiting[i] = waiting[i-1];
+        waiting[i] = c;
+    }
+
+    int y = waiting.empty() ? height : ystart[waiting.back()];
+    for (; y < height and (not waiting.empty() or not active.empty()); y++)
     {
-        yStart = (int)horizonLine->findYFromX(x);
-        if(yStart >= height) continue;
-        if(yStart < 0) yStart = 0;
-        consecutiveGreenPixels = 0;
-        for (int y = yStart; y < height; y++)
+        while (not waiting.empty() and ystart[waiting.back()] <= y)
         {
-            if(classifyPixel(x,y) == ClassIndex::green)
+            active.push_back(waiting.back());
+            waiting.pop_back();
+        }
+        for (unsigned int i = 0; i < active.size();)
+        {
+            int c = active[i];
+            int green = classifyPixel(c*scanSpacing, y) == ClassIndex::green;
+            consecutive[c] = (consecutive[c] + 1) & -green;
+            if (consecutive[c] >= MIN_CONSECUTIVE_GREEN)
             {
-                consecutiveGreenPixels++;
+                border[c] = y - MIN_CONSECUTIVE_GREEN + 1;
+                active[i] = active.back();
+                active.pop_back();
             }
             else
-            {
-                consecutiveGreenPixels = 0;
-            }
-            if(consecutiveGreenPixels >= 10)
-            {
-                results.push_back(Vector2<int>(x,y-consecutiveGreenPixels+1));
-                break;
-            }
+                i++;
         }
     }
+
+    for (int c = 0; c < numcolumns; c++)
+    {
+        if (border[c] >= 0)
+            results.push_back(Vector2<int>(c*scanSpacing, border[c]));
+    }
     return results;
 }
 
@@ -805,6 +899,12 @@ std::vector<Vector2<int> > Vision::getConvexFieldBorders(const std::vector<Vecto
   return hull;
 }
 
+/*! @brief Interpolates the field border at each scan line
+    @param fieldBorders the convex field border points, in order of increasing x
+    @param scanSpacing the spacing of the scan lines
+    @return the field border at every multiple of scanSpacing between the first and last border point. The scan lines
+            stay on this grid however densely the green border was searched.
+ */
 std::vector<Vector2<int> > Vision::interpolateBorders(const std::vector<Vector2<int> >& fieldBorders, int scanSpacing)
 {
     std::vector<Vector2<int> > interpolatedBorders;
@@ -814,7 +914,7 @@ std::vector<Vector2<int> > Vision::interpolateBorders(const std::vector<Vector2<
 
     int height = currentImage->getHeight();
 
-    int x = prevPoint->x;
+    int x = ((prevPoint->x + scanSpacing - 1)/scanSpacing)*scanSpacing;
     Vector2<int> deltaPoint, temp;
     for (; nextPoint != fieldBorders.end(); nextPoint++)
     {
@@ -993,6 +1093,121 @@ ClassifiedSection Vision::horizontalScan(const std::vector<Vector2<int> >&fieldB
     return scanArea;
 }
 
+/*! @brief Sets how often the whole frame is scanned when the ball and goals are being tracked
+    @param fullscanperiod the whole frame is scanned at least once every fullscanperiod frames, and the other frames are only
+                          searched for the ball and goals in the windows around them. Tracking is off if this is less than two.
+ */
+void Vision::setROITracking(int fullscanperiod)
+{
+    m_roi_tracker.setFullScanPeriod(fullscanperiod);
+}
+
+/*! @brief Loads the full scan period for tracking from ROITracking.cfg. Tracking is off when there is no such file.
+
+    Tracked frames are not searched for field lines, corners, the centre circle or robots, so tracking is only turned
+    on where the frame rate matters more than those.
+ */
+void Vision::loadROITracking()
+{
+    int fullscanperiod = 0;
+    ifstream file((CONFIG_DIR + string("ROITracking.cfg")).c_str());
+    if (file.is_open())
+    {
+        string label;
+        getline(file, label, ':');
+        file >> fullscanperiod;
+    }
+    #if DEBUG_VISION_VERBOSITY > 0
+        debug << "Vision::loadROITracking(). Full scan period: " << fullscanperiod << endl;
+    #endif
+    setROITracking(fullscanperiod);
+}
+
+/*! @brief Searches only the regions of interest predicted by m_roi_tracker for the ball and goal posts.
+
+    Each window is covered with scan lines at the spacing of the full frame's half scan lines (vertical for every window,
+    and horizontal for goal windows), which is enough to find a candidate in it. The candidates are passed to DetectBall
+    and DetectGoals as in a full frame scan, where classifyBallClosely and classifyGoalClosely find the edges of the
+    object itself. Robots and field lines are not searched for.
+
+    @param fieldBorders the field border predicted for this frame
+ */
+void Vision::processRegionsOfInterest(const std::vector<Vector2<int> >& fieldBorders)
+{
+    const std::vector<RegionOfInterest>& regions = m_roi_tracker.getRegions();
+    int step = std::max(spacings/2, 1);
+    ClassifiedSection vertScanArea(ScanLine::DOWN);
+    ClassifiedSection horiScanArea(ScanLine::RIGHT);
+    for (unsigned int i = 0; i < regions.size(); i++)
+    {
+        const RegionOfInterest& region = regions[i];
+        for (int x = region.left; x <= region.right; x += step)
+            vertScanArea.addScanLine(ScanLine(Vector2<int>(x, region.top), region.bottom - region.top + 1));
+        if (region.type != RegionOfInterest::BALL)
+        {
+            for (int y = region.top; y <= region.bottom; y += step)
+                horiScanArea.addScanLine(ScanLine(Vector2<int>(region.left, y), region.right - region.left + 1));
+        }
+    }
+    ClassifyScanArea(&vertScanArea);
+    ClassifyScanArea(&horiScanArea);
+
+    std::vector< TransitionSegment > GoalBlueSegments;
+    std::vector< TransitionSegment > GoalYellowSegments;
+    std::vector< TransitionSegment > BallSegments;
+    std::vector< TransitionSegment > horizontalsegments;
+    for (int i = 0; i < vertScanArea.getNumberOfScanLines(); i++)
+    {
+        ScanLine* tempScanLine = vertScanArea.getScanLine(i);
+        for (int seg = 0; seg < tempScanLine->getNumberOfSegments(); seg++)
+        {
+            unsigned char colour = tempScanLine->getSegment(seg)->getColour();
+            if (colour == ClassIndex::blue || colour == ClassIndex::shadow_blue)
+                GoalBlueSegments.push_back(*tempScanLine->getSegment(seg));
+            if (colour == ClassIndex::yellow || colour == ClassIndex::yellow_orange)
+                GoalYellowSegments.push_back(*tempScanLine->getSegment(seg));
+            if (colour == ClassIndex::orange || colour == ClassIndex::yellow_orange || colour == ClassIndex::pink_orange)
+                BallSegments.push_back(*tempScanLine->getSegment(seg));
+        }
+    }
+    for (int i = 0; i < horiScanArea.getNumberOfScanLines(); i++)
+    {
+        ScanLine* tempScanLine = horiScanArea.getScanLine(i);
+        for (int seg = 0; seg < tempScanLine->getNumberOfSegments(); seg++)
+            horizontalsegments.push_back(*tempScanLine->getSegment(seg));
+    }
+
+    std::vector<unsigned char> validColours;
+    if (BallSegments.size() > 0)
+    {
+        validColours.clear();
+        validColours.push_back(ClassIndex::orange);
+        validColours.push_back(ClassIndex::pink_orange);
+        validColours.push_back(ClassIndex::yellow_orange);
+        std::vector< ObjectCandidate > BallCandidates = classifyCandidates(BallSegments, fieldBorders, validColours, spacings, 0, 3.0, 1, Vision::PRIMS);
+        if (BallCandidates.size() > 0)
+            DetectBall(BallCandidates);
+    }
+
+    validColours.clear();
+    validColours.push_back(ClassIndex::yellow);
+    std::vector< ObjectCandidate > YellowGoalAboveHorizonCandidates = ClassifyCandidatesAboveTheHorizon(horizontalsegments, validColours, spacings*1.5, 3);
+    std::vector< ObjectCandidate > YellowGoalCandidates = classifyCandidates(GoalYellowSegments, fieldBorders, validColours, spacings, 0.1, 4.0, 2, Vision::PRIMS);
+
+    validColours.clear();
+    validColours.push_back(ClassIndex::blue);
+    std::vector< ObjectCandidate > BlueGoalAboveHorizonCandidates = ClassifyCandidatesAboveTheHorizon(horizontalsegments, validColours, spacings*1.5, 3);
+    std::vector< ObjectCandidate > BlueGoalCandidates = classifyCandidates(GoalBlueSegments, fieldBorders, validColours, spacings, 0.1, 4.0, 2, Vision::PRIMS);
+
+    DetectGoals(YellowGoalCandidates, YellowGoalAboveHorizonCandidates, horizontalsegments);
+    DetectGoals(BlueGoalCandidates, BlueGoalAboveHorizonCandidates, horizontalsegments);
+    PostProcessGoals();
+
+    #if DEBUG_VISION_VERBOSITY > 5
+        debug << "Vision::processRegionsOfInterest(). " << regions.size() << " regions, " << vertScanArea.getNumberOfScanLines() + horiScanArea.getNumberOfScanLines() << " scan lines." << endl;
+    #endif
+}
+
 void Vision::ClassifyScanArea(ClassifiedSection* scanArea)
 {
     int direction = scanArea->getDirection();
@@ -2689,15 +2904,10 @@ void Vision::DetectRobots(std::vector < ObjectCandidate > &RobotCandidates)
             float elevation = CalculateElevation(cy);
             float distance = 0;
             //qDebug() << i <<": Blue Robot: get transform";
-            vector<float> ctgvector;
             Vector3<float> measured(distance,bearing,elevation);
             Vector2<float> screenPositionAngle(bearing,elevation);
-            bool isOK = getSensorsData()->get(NUSensorsData::CameraToGroundTransform, ctgvector); 
-            if(isOK == true)
+            if(m_ray_table.projectToGround(cx, cy, measured))
             {
-                Matrix camera2groundTransform = Matrix4x4fromVector(ctgvector);
-                measured = Kinematics::DistanceToPoint(camera2groundTransform, bearing, elevation);
-
                 #if DEBUG_VISION_VERBOSITY > 6
                     debug << "\t\tCalculated Distance to Point: " << distance<<endl;
                 #endif
@@ -2724,15 +2934,10 @@ void Vision::DetectRobots(std::vector < ObjectCandidate > &RobotCandidates)
             float elevation = CalculateElevation(cy);
             float distance = 0;
             //qDebug() << i <<": pink Robot: get transform";
-            vector<float> ctgvector;
             Vector3<float> measured(distance,bearing,elevation);
             Vector2<float> screenPositionAngle(bearing,elevation);
-            bool isOK = getSensorsData()->get(NUSensorsData::CameraToGroundTransform, ctgvector); 
-            if(isOK == true)
+            if(m_ray_table.projectToGround(cx, cy, measured))
             {
-                Matrix camera2groundTransform = Matrix4x4fromVector(ctgvector);
-                measured = Kinematics::DistanceToPoint(camera2groundTransform, bearing, elevation);
-
                 #if DEBUG_VISION_VERBOSITY > 6
                     debug << "\t\tCalculated Distance to Point: " << distance<<endl;
                 #endif
@@ -19,6 +19,10 @@
 #include "NUPlatform/NUCamera.h"
 #include "Tools/Math/Vector2.h"
 #include "Tools/FileFormats/LUTTools.h"
+#include "Tools/FileFormats/CompactLUT.h"
+#include "ROITracker.h"
+#include "CameraRayTable.h"
+#include "Tools/Memory/FrameArena.h"
 
 #include <vector>
 #include <boost/circular_buffer.hpp>
@@ -28,7 +32,7 @@
 
 class NUSensorsData;
 class NUActionatorsData;
-class SaveImagesThread;
+class ImageLoggerThread;
 class NUPlatform;
 
 #define ORANGE_BALL_DIAMETER 6.5 //IN CM for NEW BALL
@@ -46,12 +50,17 @@ class Vision
     const unsigned char* currentLookupTable;    //!< Storage of the current colour lookup table.
     unsigned char* LUTBuffer;                   //!< Storage of the current colour lookup table.
     unsigned char* testLUTBuffer;
+    CompactLUT m_compact_lut;                   //!< The compact version of the current colour lookup table.
+    bool m_use_compact_lut;                     //!< True if pixels are classified with m_compact_lut, false if they are classified with currentLookupTable.
     int spacings;
+    int m_green_border_density;                 //!< the number of columns searched for the green border in each scan line spacing
     
     NUSensorsData* m_sensor_data;               //!< pointer to shared sensor data object
     NUActionatorsData* m_actions;               //!< pointer to shared actionators data object
-    friend class SaveImagesThread;
-    SaveImagesThread* m_saveimages_thread;      //!< an external thread to do saving images in parallel with vision processing
+    ImageLoggerThread* m_image_logger;          //!< an external thread to write saved images to disk in parallel with vision processing
+    FrameArena m_frame_arena;                   //!< the working memory for scan lines, segments and line points, released at the end of each frame
+    ROITracker m_roi_tracker;                   //!< predicts where the objects seen in the last frame are, so that only those windows need to be searched
+    CameraRayTable m_ray_table;                 //!< the ray through each pixel and the current camera to ground transform, used to project image points onto the field
     
     int findYFromX(const std::vector<Vector2<int> >&points, int x);
     bool checkIfBufferSame(boost::circular_buffer<unsigned char> cb);
@@ -60,8 +69,6 @@ class Vision
     bool isSavingImages;
     bool isSavingImagesWithVaryingSettings;
     int numSavedImages;
-    ofstream imagefile;
-    ofstream sensorfile;
     int ImageFrameNumber;
     int numFramesDropped;               //!< the number of frames dropped since the last call to getNumFramesDropped()
     int numFramesProcessed;             //!< the number of frames processed since the last call to getNumFramesProcessed()
@@ -98,7 +105,16 @@ class Vision
     void setActionatorsData(NUActionatorsData* actions);
 
     void setLUT(unsigned char* newLUT);
+    /*! @brief Sets the number of columns searched for the green border in each scan line spacing. 1 searches one column per scan line */
+    void setGreenBorderDensity(int density) {m_green_border_density = std::max(density, 1);}
+    /*! @brief Returns the spacing of the columns searched for the green border, when the scan lines are scanSpacing apart */
+    int getGreenBorderSpacing(int scanSpacing) const {return std::max(scanSpacing/m_green_border_density, 1);}
     void loadLUTFromFile(const std::string& fileName);
+    void setROITracking(int fullscanperiod);
+    /*! @brief Returns the number of frames only searched in the windows around the tracked ball and goals */
+    int getNumTrackedFrames() const {return m_roi_tracker.getNumTrackedFrames();}
+    /*! @brief Returns the number of frames fully scanned */
+    int getNumFullFrames() const {return m_roi_tracker.getNumFullFrames();}
 
     void setImage(const NUImage* sourceImage);
     int getNumFramesDropped();
@@ -143,7 +159,10 @@ class Vision
         classifiedCounter++;
         Pixel* temp = &currentImage->m_image[y][x];
         //return  currentLookupTable[(temp->y<<16) + (temp->cb<<8) + temp->cr]; //8 bit LUT
-        return  currentLookupTable[LUTTools::getLUTIndex(*temp)]; // 7bit LUT
+        if (m_use_compact_lut)
+            return m_compact_lut.classify(*temp);
+        else
+            return  currentLookupTable[LUTTools::getLUTIndex(*temp)]; // 7bit LUT
     }
 
     enum tCLASSIFY_METHOD
@@ -237,6 +256,9 @@ class Vision
 
     void DetectRobots(std::vector<ObjectCandidate> &RobotCandidates);
 
+    void loadROITracking();
+    void processRegionsOfInterest(const std::vector<Vector2<int> >& fieldBorders);
+
     bool isPixelOnScreen(int x, int y);
     int getImageHeight(){ return currentImage->getHeight();}
     int getImageWidth(){return currentImage->getWidth();}
@@ -244,6 +266,7 @@ class Vision
     int getScanSpacings(){return spacings;}
 
     NUSensorsData* getSensorsData() {return m_sensor_data;}
+    const CameraRayTable& getRayTable() const {return m_ray_table;}
     bool checkIfBufferContains(boost::circular_buffer<unsigned char> cb, const std::vector<unsigned char> &colourList);
 
     int CalculateSkipSpacing(int currentPosition, int lineLength, bool greenSeen);
@@ -32,7 +32,10 @@ Vision.cpp
 Ball.cpp
 CircleFitting.cpp
 EllipseFit.cpp
+DirectFitting.cpp
 fitellipsethroughcircle.cpp
+ROITracker.cpp
+CameraRayTable.cpp
 )
 ####################################################################################
 ########## List your subdirectories here! ##########################################
@@ -4,7 +4,7 @@
 class Vision;
 #include "../Tools/Math/Vector3.h"
 #include "../Tools/Math/Vector2.h"
-#include "CircleFitting.h"
+#include "DirectFitting.h"
 #include "Tools/Math/General.h"
 #include "Infrastructure/NUSensorsData/NUSensorsData.h"
 #include "Kinematics/Kinematics.h"
@@ -33,7 +33,7 @@ bool FitEllipseThroughCircle::Fit_Ellipse_Through_Circle(std::vector<LinePoint*>
     
     //This function assumes points are points that belong on the centre circle:
     
-    CircleFitting circleFitter;
+    DirectCircleFit circleFitter(1.0);  // a fit within a centimetre does not need refining
     std::vector < Vector2<int> > points;
     points.reserve(centreCirclePoints.size());
 
@@ -56,7 +56,7 @@ bool FitEllipseThroughCircle::Fit_Ellipse_Through_Circle(std::vector<LinePoint*>
     }
     
     //Perform Circle Fit on Transformed Points:
-    Circle circ = circleFitter.FitCircleLMA(points);
+    Circle circ = circleFitter.fit(points);
     LinePoint relativeCentrePoint;
     relativeCentrePoint.x = circ.centreX;
     relativeCentrePoint.y = circ.centreY;